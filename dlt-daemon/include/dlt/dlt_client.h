@@ -75,6 +75,7 @@
 
 #   include "dlt_types.h"
 #   include "dlt_common.h"
+#   include "dlt_compression.h"
 #include <stdbool.h>
 
 // DLTV2 - Definitions for DLT Version 2
@@ -107,6 +108,7 @@ typedef struct
     DltClientMode mode;        /**< mode DltClientMode */
     int send_serial_header;    /**< (Boolean) Send DLT messages with serial header */
     int resync_serial_header;  /**< (Boolean) Resync to serial header on all connection */
+    struct DltClientCompression *compression; /**< Decompression of the received stream, NULL if uncompressed */
 } DltClient;
 
 #   ifdef __cplusplus
@@ -117,6 +119,15 @@ void dlt_client_register_message_callback(int (*registerd_callback)(DltMessage *
 
 void dlt_client_register_message_callback_v2(int (*registerd_callback)(DltMessageV2 *message, void *data));
 
+/**
+ * Register a callback which receives messages as zero-copy views into the
+ * receive buffer of the client. The view is only valid during the callback.
+ * If no DltMessage callback is registered, dlt_client_main_loop() skips
+ * dlt_message_read() completely and only hands out views.
+ * @param registerd_callback callback function, NULL to unregister
+ */
+void dlt_client_register_message_view_callback(int (*registerd_callback)(DltMessageView *view, void *data));
+
 void dlt_client_register_fetch_next_message_callback(bool (*registerd_callback)(void *data));
 
 /**
@@ -144,6 +155,29 @@ DltReturnValue dlt_client_init(DltClient *client, int verbose);
  */
 DltReturnValue dlt_client_connect(DltClient *client, int verbose);
 
+/**
+ * Start a non-blocking connection to a dlt daemon (TCP or UNIX mode only).
+ * The receiver is initialized on the new socket, so it can already be
+ * registered in an event loop. If the connection cannot be completed
+ * immediately, the caller has to wait for the socket to become writable and
+ * then call dlt_client_connect_finish().
+ * @param client pointer to dlt client structure
+ * @param verbose if set to true verbose information is printed out.
+ * @return DLT_RETURN_OK if connected, DLT_RETURN_TRUE if the connection is
+ *         in progress, negative value if there was an error
+ */
+DltReturnValue dlt_client_connect_start(DltClient *client, int verbose);
+
+/**
+ * Complete a connection started with dlt_client_connect_start().
+ * On error the socket is not closed, so that the caller can remove it from
+ * its event loop first.
+ * @param client pointer to dlt client structure
+ * @param verbose if set to true verbose information is printed out.
+ * @return Value from DltReturnValue enum
+ */
+DltReturnValue dlt_client_connect_finish(DltClient *client, int verbose);
+
 /**
  * Cleanup dlt client structure
  * @param client pointer to dlt client structure
@@ -400,6 +434,28 @@ DltReturnValue dlt_client_send_all_trace_status(DltClient *client, uint8_t trace
  */
 DltReturnValue dlt_client_send_all_trace_status_v2(DltClient *client, uint8_t traceStatus);
 
+/**
+ * Send a filter to the dlt daemon, which then only sends the matching
+ * messages to this client. Daemons without support respond with
+ * DLT_SERVICE_RESPONSE_NOT_SUPPORTED and keep sending all messages.
+ * @param client pointer to dlt client structure
+ * @param filter filters to be set, no filter removes it
+ * @return Value from DltReturnValue enum
+ */
+DltReturnValue dlt_client_send_filter(DltClient *client, DltFilter *filter);
+
+/**
+ * Request a compressed stream from the dlt daemon and wait for the response.
+ * Messages received before the response stay in the receive buffer, all data
+ * after it is decompressed by the main loop. Only for TCP connections.
+ * @param client pointer to dlt client structure
+ * @param method DLT_COMPRESSION_* method
+ * @return DLT_RETURN_OK if the stream is compressed from now on,
+ *         DLT_RETURN_ERROR otherwise; the stream stays uncompressed if the
+ *         daemon rejected the request
+ */
+DltReturnValue dlt_client_set_compression(DltClient *client, uint8_t method);
+
 /**
  * Send the timing pakets status to the dlt daemon
  * @param client pointer to dlt client structure
@@ -321,7 +321,8 @@
 #   define DLT_OUTPUT_MIXED_FOR_HTML   4
 #   define DLT_OUTPUT_ASCII_LIMITED    5
 
-#   define DLT_FILTER_MAX 30 /**< Maximum number of filters */
+#   define DLT_FILTER_MAX 256 /**< Maximum number of filters */
+#   define DLT_FILTER_INDEX_BUCKETS (2 * DLT_FILTER_MAX) /**< Hash buckets of a compiled filter list */
 
 #   define DLT_MSG_READ_VALUE(dst, src, length, type) \
     do { \
@@ -671,6 +672,29 @@ typedef struct DltMessageV2
     DltExtendedHeaderV2 extendedheaderv2;      /**< pointer to extended of current loaded header */
 } DLT_PACKED DltMessageV2;
 
+/**
+ * Read-only view of a DLT message located in a receive buffer.
+ * Nothing is copied: the pointers refer directly into the buffer that was
+ * given to dlt_message_view_read() and are only valid as long as this buffer
+ * is not modified. Standard header extra parameters, the extended header and
+ * the payload are resolved on demand by the dlt_message_view_get_* functions.
+ */
+typedef struct
+{
+    /* flags */
+    int8_t found_serialheader;
+
+    /* offsets */
+    int32_t resync_offset;
+
+    /* size parameters */
+    int32_t headersize;    /**< size of complete header without storage header */
+    int32_t datasize;      /**< size of complete payload */
+
+    const uint8_t *buffer;                     /**< start of the message (standard header) in the receive buffer */
+    const DltStandardHeader *standardheader;   /**< pointer to standard header inside the receive buffer */
+} DltMessageView;
+
 /**
  * The structure of the DLT Service Get Log Info.
  */
@@ -928,6 +952,64 @@ typedef struct
     char node_id[DLT_ENTRY_MAX];               /**< list of passive node IDs */
 } DLT_PACKED DltServicePassiveNodeConnectionInfo;
 
+/**
+ * One filter of the DLT Service Set Client Filter
+ */
+typedef struct
+{
+    char apid[DLT_ID_SIZE];         /**< application id, empty for any */
+    char ctid[DLT_ID_SIZE];         /**< context id, empty for any */
+    uint8_t log_level;              /**< log level, 0 for any */
+    int32_t payload_min;            /**< lower border for payload */
+    int32_t payload_max;            /**< upper border for payload, 0 for none */
+} DLT_PACKED DltServiceClientFilterEntry;
+
+/**
+ * The structure of the DLT Service Set Client Filter. It is followed by
+ * count entries of DltServiceClientFilterEntry; no entry removes the filter.
+ */
+typedef struct
+{
+    uint32_t service_id;            /**< service ID */
+    uint16_t count;                 /**< number of filters */
+} DLT_PACKED DltServiceSetClientFilter;
+
+/**
+ * The structure of the DLT Service Set Client Compression. After the
+ * positive response, everything the daemon sends on this connection is
+ * compressed with the requested method.
+ */
+typedef struct
+{
+    uint32_t service_id;            /**< service ID */
+    uint8_t method;                 /**< DLT_COMPRESSION_* method */
+} DLT_PACKED DltServiceSetClientCompression;
+
+/**
+ * Entry of a compiled filter list, see dlt_filter_compile().
+ */
+typedef struct
+{
+    uint32_t apid;          /**< packed application id, 0 for any */
+    uint32_t ctid;          /**< packed context id, 0 for any */
+    uint16_t level_mask;    /**< bit n set if message type info n matches */
+    int16_t next;           /**< next entry in the same bucket, -1 for none */
+    int32_t payload_min;    /**< lower border for payload */
+    int32_t payload_max;    /**< upper border for payload */
+} DltFilterIndexEntry;
+
+/**
+ * Hash index compiled from a filter list, see dlt_filter_compile().
+ */
+typedef struct
+{
+    int num_entries;                                /**< number of entries, 0 if not compiled */
+    uint32_t bucket_mask;                           /**< number of buckets used - 1 */
+    uint8_t key_types;                              /**< kinds of id pairs present in the index */
+    int16_t buckets[DLT_FILTER_INDEX_BUCKETS];      /**< first entry of each bucket, -1 if empty */
+    DltFilterIndexEntry entries[DLT_FILTER_MAX];    /**< filters merged by id pair and payload borders */
+} DltFilterIndex;
+
 /**
  * Structure to store filter parameters.
  * ID are maximal four characters. Unused values are filled with zeros.
@@ -945,6 +1027,7 @@ typedef struct
     int32_t payload_max[DLT_FILTER_MAX];    /**< upper border for payload */
     int32_t payload_min[DLT_FILTER_MAX];    /**< lower border for payload */
     int counter;                            /**< number of filters */
+    DltFilterIndex index;                   /**< compiled filters, reset whenever the list is modified */
 } DltFilter;
 
 /**
@@ -1272,6 +1355,22 @@ DltReturnValue dlt_filter_init(DltFilter *filter, int verbose);
  */
 DltReturnValue dlt_filter_free(DltFilter *filter, int verbose);
 
+/**
+ * Compile the filter list into a lookup index.
+ * Filters are hashed by their packed application and context id, with empty
+ * ids acting as wildcards, and the log levels of all filters sharing the same
+ * ids and payload borders are merged into one bit mask. Afterwards
+ * dlt_message_filter_check() needs at most four hash probes per message,
+ * independent of the number of filters. The index is dropped again whenever
+ * the filter list is modified and rebuilt by the next call of this function.
+ * Short filter lists are left uncompiled, as checking them one by one is faster.
+ * dlt_filter_load() and dlt_file_set_filter() compile the filter list implicitly.
+ * @param filter pointer to structure of organising DLT filter
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error
+ */
+DltReturnValue dlt_filter_compile(DltFilter *filter, int verbose);
+
 /**
  * Load filter list from file.
  * @param filter pointer to structure of organising DLT filter
@@ -1534,6 +1633,70 @@ int dlt_message_read(DltMessage *msg, uint8_t *buffer, unsigned int length, int
  */
 int dlt_message_read_v2(DltMessageV2 *msg, uint8_t *buffer, unsigned int length, int resync, int verbose);
 
+/**
+ * Map a message view onto a memory buffer without copying header or payload.
+ * Only the standard header is parsed, everything else is resolved lazily.
+ * Message in buffer has no storage header.
+ * @param view pointer to message view to be filled
+ * @param buffer pointer to memory buffer
+ * @param length length of message in buffer
+ * @param resync if set to true resync to serial header is enforced
+ * @param verbose if set to true verbose information is printed out.
+ * @return DLT_MESSAGE_ERROR_OK if a complete message was found, otherwise a DltMessageErrorCode
+ */
+int dlt_message_view_read(DltMessageView *view, const uint8_t *buffer, unsigned int length, int resync, int verbose);
+
+/**
+ * Get the number of bytes a message view occupies in the receive buffer,
+ * including a skipped resync area and the serial header.
+ * @param view pointer to message view
+ * @return number of bytes to be removed from the receive buffer, 0 on error
+ */
+uint32_t dlt_message_view_get_consumed_size(const DltMessageView *view);
+
+/**
+ * Get pointer to the extended header of a message view.
+ * @param view pointer to message view
+ * @return pointer into the receive buffer or NULL if the message has no extended header
+ */
+const DltExtendedHeader *dlt_message_view_get_extendedheader(const DltMessageView *view);
+
+/**
+ * Get pointer to the application id of a message view (not zero terminated).
+ * @param view pointer to message view
+ * @return pointer to DLT_ID_SIZE bytes inside the receive buffer or NULL if the message has no extended header
+ */
+const char *dlt_message_view_get_apid(const DltMessageView *view);
+
+/**
+ * Get pointer to the context id of a message view (not zero terminated).
+ * @param view pointer to message view
+ * @return pointer to DLT_ID_SIZE bytes inside the receive buffer or NULL if the message has no extended header
+ */
+const char *dlt_message_view_get_ctid(const DltMessageView *view);
+
+/**
+ * Get pointer to the ECU id of a message view (not zero terminated).
+ * @param view pointer to message view
+ * @return pointer to DLT_ID_SIZE bytes inside the receive buffer or NULL if the message carries no ECU id
+ */
+const char *dlt_message_view_get_ecuid(const DltMessageView *view);
+
+/**
+ * Decode the standard header extra parameters of a message view.
+ * @param view pointer to message view
+ * @param extra pointer to structure which is filled with the decoded values
+ * @return negative value if there was an error
+ */
+DltReturnValue dlt_message_view_get_extraparameters(const DltMessageView *view, DltStandardHeaderExtra *extra);
+
+/**
+ * Get pointer to the payload of a message view.
+ * @param view pointer to message view
+ * @return pointer into the receive buffer, NULL on error
+ */
+const uint8_t *dlt_message_view_get_payload(const DltMessageView *view);
+
 /**
  * DLTv2 Get storage header parameters for version 2
  * @param msg pointer to structure of organising access to DLT messages
@@ -0,0 +1,79 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_compression.h
+ * Stream compression of client connections, negotiated with
+ * DLT_SERVICE_ID_SET_CLIENT_COMPRESSION. The daemon compresses the data sent
+ * to the client, the client decompresses it before parsing messages.
+ */
+
+#ifndef DLT_COMPRESSION_H
+#define DLT_COMPRESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dlt_types.h"
+
+/* Compression methods */
+#define DLT_COMPRESSION_NONE    0x00
+/* raw deflate with the preset dictionary of DLT headers */
+#define DLT_COMPRESSION_DEFLATE 0x01
+
+/* Default maximum time in ms compressed data is held back by the daemon */
+#define DLT_COMPRESSION_FLUSH_INTERVAL 100
+
+typedef struct DltCompression DltCompression;
+
+/**
+ * Create a compression or decompression stream.
+ * @param method DLT_COMPRESSION_* method
+ * @param compress true to compress, false to decompress
+ * @return the stream, NULL if the method is not supported (also if DLT is
+ *         built without WITH_DLT_STREAM_COMPRESSION) or on error
+ */
+DltCompression *dlt_compression_create(uint8_t method, bool compress);
+
+/**
+ * Free a stream created by dlt_compression_create().
+ * @param stream the stream, may be NULL
+ */
+void dlt_compression_free(DltCompression *stream);
+
+/**
+ * Compress or decompress data. Call it again with the remaining input, or
+ * with the same flush request, as long as the output buffer was filled up
+ * completely.
+ * @param stream the stream
+ * @param in input data, may be NULL if in_size is 0
+ * @param in_size size of the input data
+ * @param out output buffer
+ * @param out_size size of the output buffer
+ * @param consumed number of input bytes processed
+ * @param produced number of output bytes written
+ * @param flush compressing: emit all data passed so far, so that the peer can
+ *        decompress it completely
+ * @return DLT_RETURN_OK on success, DLT_RETURN_ERROR if the data is corrupted
+ */
+DltReturnValue dlt_compression_process(DltCompression *stream,
+                                       const void *in,
+                                       size_t in_size,
+                                       void *out,
+                                       size_t out_size,
+                                       size_t *consumed,
+                                       size_t *produced,
+                                       bool flush);
+
+#endif /* DLT_COMPRESSION_H */
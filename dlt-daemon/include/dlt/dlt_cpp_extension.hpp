@@ -30,6 +30,16 @@
 #include <list>
 #include <map>
 
+#if __cplusplus >= 201703L
+#   include <cstring>
+#   include <string_view>
+#   include <type_traits>
+#   if __has_include(<span>) && (__cplusplus > 201703L)
+#       include <span>
+#       define DLT_CPP_EXTENSION_HAS_SPAN
+#   endif
+#endif
+
 #include "dlt.h"
 
 template<typename T>
@@ -167,6 +177,31 @@ static inline int32_t logToDlt(DltContextData &log, std::map<_Key, _Tp, _Compare
     return result;
 }
 
+#if __cplusplus >= 201703L
+static inline int32_t logToDlt(DltContextData &log, std::string_view const &value)
+{
+    uint16_t length = static_cast<uint16_t>((value.size() < UINT16_MAX) ? value.size() : UINT16_MAX);
+
+    return dlt_user_log_write_sized_utf8_string(&log, value.data(), length);
+}
+
+#ifdef DLT_CPP_EXTENSION_HAS_SPAN
+template<typename _Tp, std::size_t _Extent>
+static inline int32_t logToDlt(DltContextData &log, std::span<_Tp, _Extent> const & value)
+{
+    int result = 0;
+
+    for (auto elem : value)
+        result += logToDlt(log, elem);
+
+    if (result != 0)
+        result = -1;
+
+    return result;
+}
+#endif
+#endif
+
 //variadic functions using C11 standard
 template<typename First>
 static inline int32_t logToDltVariadic(DltContextData &log, First const &valueA)
@@ -185,6 +220,289 @@ static inline int32_t logToDltVariadic(DltContextData &log, First const &valueA,
     return result;
 }
 
+#if __cplusplus >= 201703L
+namespace dlt_encoder
+{
+/*
+ * Encoding traits of the argument types. Encodable types provide the verbose
+ * type info word, whether their encoded size is fixed (and the size then),
+ * whether a value can be encoded, the encoded size and argument count of a
+ * value, and a function serializing a value into the message buffer.
+ */
+template<typename T, typename = void>
+struct Traits
+{
+    static constexpr bool encodable = false;
+};
+
+template<typename T, uint32_t TypeInfo, typename Encoded = T>
+struct FixedTraits
+{
+    static constexpr bool encodable = true;
+    static constexpr bool fixed = true;
+    static constexpr uint32_t type_info = TypeInfo;
+    static constexpr std::size_t fixed_size = sizeof(uint32_t) + sizeof(Encoded);
+
+    static constexpr bool valid(T const &) { return true; }
+    static constexpr std::size_t size(T const &) { return fixed_size; }
+    static constexpr std::size_t args(T const &) { return 1; }
+
+    static unsigned char *write(unsigned char *buffer, T const &value)
+    {
+        Encoded encoded = static_cast<Encoded>(value);
+        std::memcpy(buffer, &type_info, sizeof(uint32_t));
+        std::memcpy(buffer + sizeof(uint32_t), &encoded, sizeof(Encoded));
+        return buffer + fixed_size;
+    }
+};
+
+template<> struct Traits<int8_t> : FixedTraits<int8_t, DLT_TYPE_INFO_SINT | DLT_TYLE_8BIT> {};
+template<> struct Traits<int16_t> : FixedTraits<int16_t, DLT_TYPE_INFO_SINT | DLT_TYLE_16BIT> {};
+template<> struct Traits<int32_t> : FixedTraits<int32_t, DLT_TYPE_INFO_SINT | DLT_TYLE_32BIT> {};
+template<> struct Traits<int64_t> : FixedTraits<int64_t, DLT_TYPE_INFO_SINT | DLT_TYLE_64BIT> {};
+template<> struct Traits<uint8_t> : FixedTraits<uint8_t, DLT_TYPE_INFO_UINT | DLT_TYLE_8BIT> {};
+template<> struct Traits<uint16_t> : FixedTraits<uint16_t, DLT_TYPE_INFO_UINT | DLT_TYLE_16BIT> {};
+template<> struct Traits<uint32_t> : FixedTraits<uint32_t, DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT> {};
+template<> struct Traits<uint64_t> : FixedTraits<uint64_t, DLT_TYPE_INFO_UINT | DLT_TYLE_64BIT> {};
+template<> struct Traits<float32_t> : FixedTraits<float32_t, DLT_TYPE_INFO_FLOA | DLT_TYLE_32BIT> {};
+template<> struct Traits<double> : FixedTraits<double, DLT_TYPE_INFO_FLOA | DLT_TYLE_64BIT> {};
+template<> struct Traits<bool> : FixedTraits<bool, DLT_TYPE_INFO_BOOL | DLT_TYLE_8BIT, uint8_t> {};
+
+/* UTF-8 strings: type info, length including the terminating zero, characters, zero */
+struct StringTraits
+{
+    static constexpr bool encodable = true;
+    static constexpr bool fixed = false;
+    static constexpr uint32_t type_info = DLT_TYPE_INFO_STRG | DLT_SCOD_UTF8;
+
+    /* the length including the terminating zero must fit into 16 bit */
+    static bool valid(std::string_view value) { return value.size() < UINT16_MAX; }
+    static bool valid(char const *value) { return (value != nullptr) && valid(std::string_view(value)); }
+
+    static std::size_t size(std::string_view value)
+    {
+        return sizeof(uint32_t) + sizeof(uint16_t) + value.size() + 1;
+    }
+
+    static std::size_t size(char const *value)
+    {
+        return (value != nullptr) ? size(std::string_view(value)) : 0;
+    }
+
+    static constexpr std::size_t args(std::string_view) { return 1; }
+
+    static unsigned char *write(unsigned char *buffer, std::string_view value)
+    {
+        uint16_t length = static_cast<uint16_t>(value.size() + 1);
+        std::memcpy(buffer, &type_info, sizeof(uint32_t));
+        std::memcpy(buffer + sizeof(uint32_t), &length, sizeof(uint16_t));
+        buffer += sizeof(uint32_t) + sizeof(uint16_t);
+        std::memcpy(buffer, value.data(), value.size());
+        buffer[value.size()] = '\0';
+        return buffer + length;
+    }
+
+    /* valid() already rejected NULL, the check keeps std::string_view from seeing it */
+    static unsigned char *write(unsigned char *buffer, char const *value)
+    {
+        return write(buffer, std::string_view((value != nullptr) ? value : ""));
+    }
+};
+
+template<> struct Traits<char const *> : StringTraits {};
+template<> struct Traits<char *> : StringTraits {};
+template<std::size_t N> struct Traits<char[N]> : StringTraits {};
+template<> struct Traits<std::string_view> : StringTraits {};
+
+/* std::string is logged up to the first zero, like by dlt_user_log_write_utf8_string */
+template<>
+struct Traits<std::string> : StringTraits
+{
+    static bool valid(std::string const &value) { return StringTraits::valid(value.c_str()); }
+    static std::size_t size(std::string const &value) { return StringTraits::size(value.c_str()); }
+    static unsigned char *write(unsigned char *buffer, std::string const &value)
+    {
+        return StringTraits::write(buffer, value.c_str());
+    }
+};
+
+/* Containers are logged as one argument per element */
+template<typename Container, typename Element>
+struct RangeTraits
+{
+    static constexpr bool encodable = Traits<Element>::encodable;
+    static constexpr bool fixed = false;
+
+    static bool valid(Container const &value)
+    {
+        if constexpr (!Traits<Element>::fixed) {
+            for (auto const &elem : value)
+                if (!Traits<Element>::valid(elem))
+                    return false;
+        }
+
+        return true;
+    }
+
+    static std::size_t size(Container const &value)
+    {
+        if constexpr (Traits<Element>::fixed) {
+            return value.size() * Traits<Element>::fixed_size;
+        }
+        else {
+            std::size_t result = 0;
+
+            for (auto const &elem : value)
+                result += Traits<Element>::size(elem);
+
+            return result;
+        }
+    }
+
+    static std::size_t args(Container const &value)
+    {
+        if constexpr (Traits<Element>::fixed) {
+            return value.size();
+        }
+        else {
+            std::size_t result = 0;
+
+            for (auto const &elem : value)
+                result += Traits<Element>::args(elem);
+
+            return result;
+        }
+    }
+
+    static unsigned char *write(unsigned char *buffer, Container const &value)
+    {
+        for (auto const &elem : value)
+            buffer = Traits<Element>::write(buffer, elem);
+
+        return buffer;
+    }
+};
+
+template<typename _Tp, typename _Alloc>
+struct Traits<std::vector<_Tp, _Alloc>> : RangeTraits<std::vector<_Tp, _Alloc>, _Tp> {};
+
+template<typename _Tp, typename _Alloc>
+struct Traits<std::list<_Tp, _Alloc>> : RangeTraits<std::list<_Tp, _Alloc>, _Tp> {};
+
+#ifdef DLT_CPP_EXTENSION_HAS_SPAN
+template<typename _Tp, std::size_t _Extent>
+struct Traits<std::span<_Tp, _Extent>> : RangeTraits<std::span<_Tp, _Extent>, std::remove_cv_t<_Tp>> {};
+#endif
+
+/* Map entries are logged as key followed by value */
+template<typename _Key, typename _Tp>
+struct Traits<std::pair<const _Key, _Tp>>
+{
+    using Key = Traits<_Key>;
+    using Value = Traits<_Tp>;
+
+    static constexpr bool encodable = Key::encodable && Value::encodable;
+    static constexpr bool fixed = encodable && Key::fixed && Value::fixed;
+    static constexpr std::size_t fixed_size = fixed ? Key::fixed_size + Value::fixed_size : 0;
+
+    static bool valid(std::pair<const _Key, _Tp> const &value)
+    {
+        return Key::valid(value.first) && Value::valid(value.second);
+    }
+
+    static std::size_t size(std::pair<const _Key, _Tp> const &value)
+    {
+        return Key::size(value.first) + Value::size(value.second);
+    }
+
+    static std::size_t args(std::pair<const _Key, _Tp> const &value)
+    {
+        return Key::args(value.first) + Value::args(value.second);
+    }
+
+    static unsigned char *write(unsigned char *buffer, std::pair<const _Key, _Tp> const &value)
+    {
+        return Value::write(Key::write(buffer, value.first), value.second);
+    }
+};
+
+template<typename _Key, typename _Tp, typename _Compare, typename _Alloc>
+struct Traits<std::map<_Key, _Tp, _Compare, _Alloc>>
+    : RangeTraits<std::map<_Key, _Tp, _Compare, _Alloc>, std::pair<const _Key, _Tp>> {};
+
+/* Size of the fixed-size arguments, known at compile time */
+template<typename T>
+constexpr std::size_t fixed_size()
+{
+    if constexpr (Traits<T>::fixed)
+        return Traits<T>::fixed_size;
+    else
+        return 0;
+}
+
+/* Whether the encoder can handle the value, fixed-size arguments always qualify */
+template<typename T>
+bool valid(T const &value)
+{
+    if constexpr (Traits<T>::fixed)
+        return true;
+    else
+        return Traits<T>::valid(value);
+}
+
+/* Size of the variable-size arguments, computed at runtime */
+template<typename T>
+std::size_t dynamic_size(T const &value)
+{
+    if constexpr (Traits<T>::fixed)
+        return 0;
+    else
+        return Traits<T>::size(value);
+}
+} /* namespace dlt_encoder */
+
+/**
+ * @brief encode all arguments into the log message with a single bounds check
+ *
+ * The type info words and the size of all fixed-size arguments are computed
+ * at compile time. If one of the types has no encoder (e.g. user types with
+ * their own logToDlt), one of the values can not be encoded (e.g. a NULL
+ * string) or the arguments do not fit into the message, the arguments are
+ * written one by one with logToDltVariadic instead.
+ */
+template<typename ... Args>
+static inline int32_t logToDltEncoded(DltContextData &log, const Args&... values)
+{
+    if constexpr (sizeof...(Args) == 0) {
+        return 0;
+    }
+    else {
+        if constexpr ((dlt_encoder::Traits<Args>::encodable && ...)) {
+            if ((dlt_encoder::valid(values) && ...)) {
+                constexpr std::size_t fixed_size = (dlt_encoder::fixed_size<Args>() + ...);
+                std::size_t size = fixed_size + (dlt_encoder::dynamic_size(values) + ...);
+                std::size_t args_num = (dlt_encoder::Traits<Args>::args(values) + ...);
+                unsigned char *buffer = nullptr;
+
+                if (args_num <= UINT16_MAX)
+                    buffer = dlt_user_log_write_reserve(&log, size, static_cast<uint16_t>(args_num));
+
+                if (buffer != nullptr) {
+                    ((buffer = dlt_encoder::Traits<Args>::write(buffer, values)), ...);
+                    return 0;
+                }
+            }
+        }
+
+        return logToDltVariadic(log, values...);
+    }
+}
+
+#define DLT_CXX_LOG_ARGUMENTS logToDltEncoded
+#else
+#define DLT_CXX_LOG_ARGUMENTS logToDltVariadic
+#endif
+
 /**
  * @brief macro to write a log message with variable number of arguments and without the need to specify the type of log data
  *
@@ -199,7 +517,7 @@ static inline int32_t logToDltVariadic(DltContextData &log, First const &valueA,
         DltContextData log;\
         if (dlt_user_log_write_start(&CONTEXT,&log,LOGLEVEL)>0)\
         {\
-            logToDltVariadic(log, ##__VA_ARGS__);\
+            DLT_CXX_LOG_ARGUMENTS(log, ##__VA_ARGS__);\
             dlt_user_log_write_finish(&log);\
         }\
     }\
@@ -223,7 +541,7 @@ static inline int32_t logToDltVariadic(DltContextData &log, First const &valueA,
         if (dlt_user_log_write_start(&CONTEXT, &log, LOGLEVEL) > 0)\
         {\
             dlt_user_log_write_string(&log, __PRETTY_FUNCTION__);\
-            logToDltVariadic(log, ##__VA_ARGS__);\
+            DLT_CXX_LOG_ARGUMENTS(log, ##__VA_ARGS__);\
             dlt_user_log_write_finish(&log);\
         }\
   }\
@@ -57,6 +57,22 @@
 /* ! Error code for failed get serial number */
 #define DLT_FILETRANSFER_FILE_SERIAL_NUMBER -900
 
+/* !Resume cursor of a file transfer */
+typedef struct
+{
+    uint32_t serial;    /**< serial number of the file the cursor belongs to */
+    int package;        /**< last package which was logged, 0 if none */
+} DltFileTransferCursor;
+
+/* !Callback invoked once an asynchronous file transfer finished */
+/**
+ * @param fileContext Context the file was logged to
+ * @param filename Absolute file path
+ * @param result 0 if the file was transferred completely, a value < 0 otherwise
+ * @param userData Pointer given when starting the transfer
+ */
+typedef void (*DltFileTransferCallback)(DltContext *fileContext, const char *filename, int result, void *userData);
+
 
 /* !Transfer the complete file as several dlt logs. */
 /**This method transfer the complete file as several dlt logs. At first it will be checked that the file exist.
@@ -141,6 +157,41 @@ extern int dlt_user_log_file_data(DltContext *fileContext, const char *filename,
 
 
 
+/* !Transfer the content data of a file from a memory mapping. */
+/**The file is mapped once and every package is logged directly from the mapping. Before each package
+ * the function sleeps until at least half of the user buffer is free, instead of polling. The transfer is
+ * given up if a package cannot be buffered within 10 seconds or if the file is truncated meanwhile.
+ * @param fileContext Specific context to log the file to dlt
+ * @param filename Absolute file path
+ * @param cursor Resume cursor, may be NULL. Packages already logged for the same file are skipped, the cursor is updated after every package.
+ * @param timeout Timeout in ms to wait between dlt logs, 0 to rely on the buffer space only.
+ * @param fileCancelTransferFlag is a bool pointer to cancel the filetransfer on demand, may be NULL. It is read atomically,
+ *        so another thread may set it with __atomic_store_n().
+ * @return Returns 0 if everything was okey. If there was a failure value < 0 will be returned.
+ */
+extern int dlt_user_log_file_data_mmap(DltContext *fileContext, const char *filename, DltFileTransferCursor *cursor,
+                                       int timeout, bool *const fileCancelTransferFlag);
+
+
+/* !Transfer the complete file in a thread of its own. */
+/**Logs header, data (see dlt_user_log_file_data_mmap) and end of the file from a detached thread and
+ * invokes the callback with the result. The header is skipped when resuming with a cursor which
+ * already logged packages of the same file.
+ * @param fileContext Specific context to log the file to dlt, must stay registered until the callback
+ * @param filename Absolute file path
+ * @param deleteFlag Flag if the file will be deleted after transfer. 1->delete, 0->notDelete
+ * @param timeout Timeout in ms to wait between dlt logs, 0 to rely on the buffer space only.
+ * @param cursor Resume cursor, may be NULL. Must stay valid until the callback.
+ * @param fileCancelTransferFlag is a bool pointer to cancel the filetransfer on demand, may be NULL.
+ * @param callback Called from the transfer thread once the transfer finished, may be NULL.
+ * @param userData Passed to the callback
+ * @return Returns 0 if the transfer was started. If there was a failure value < 0 will be returned.
+ */
+extern int dlt_user_log_file_complete_async(DltContext *fileContext, const char *filename, int deleteFlag, int timeout,
+                                            DltFileTransferCursor *cursor, bool *const fileCancelTransferFlag,
+                                            DltFileTransferCallback callback, void *userData);
+
+
 /* !Transfer the end of the file as a dlt logs. */
 /**The end of the file must be logged to dlt because the end contains inforamtion about the file serial number.
  * This informations is needed from the plugin of the dlt viewer.
@@ -29,6 +29,8 @@
 #define DLT_MULTIPLE_FILES_H
 
 #include <limits.h>
+#include <time.h>
+#include <sys/types.h>
 
 #include "dlt_common.h"
 #include "dlt_types.h"
@@ -36,6 +38,24 @@
 #define MULTIPLE_FILES_FILENAME_INDEX_DELIM "."
 #define MULTIPLE_FILES_FILENAME_TIMESTAMP_DELIM "_"
 
+/* The manifest "<base>.manifest" lists the files of the buffer, oldest first.
+ * The next file is prepared as "<base>.prealloc" before it is needed. */
+#define MULTIPLE_FILES_MANIFEST_EXT ".manifest"
+#define MULTIPLE_FILES_PREALLOC_EXT ".prealloc"
+
+/**
+ * One file of a multiple files buffer as recorded in the manifest.
+ */
+typedef struct
+{
+    char name[NAME_MAX + 1];     /**< (String) File name within the buffer directory */
+    unsigned int idx;            /**< (unsigned int) Index of the file name, 0 if timestamp based */
+    time_t created;              /**< (time_t) Creation time of the file */
+    ssize_t size;                /**< (ssize_t) Current size of the file in bytes */
+} MultipleFilesSegment;
+
+struct MultipleFilesWorker;
+
 /**
  * Represents a ring buffer of multiple files of identical file size.
  * File names differ in timestamp or index (depending on chosen mode).
@@ -51,11 +71,19 @@ typedef struct
     char filenameBase[NAME_MAX + 1];/**< (String) Prefix of file name */
     char filenameExt[NAME_MAX + 1];/**< (String) Extension of file name */
     int ohandle;                 /**< (int) file handle to current output file */
+    MultipleFilesSegment *segments; /**< In-memory manifest, ring of segmentsCapacity entries */
+    unsigned int segmentsFirst;  /**< (unsigned int) Ring position of the oldest file */
+    unsigned int segmentsCount;  /**< (unsigned int) Number of files, the newest one is the current file */
+    unsigned int segmentsCapacity; /**< (unsigned int) Allocated entries of segments */
+    ssize_t totalSize;           /**< (ssize_t) Size of all files in bytes */
+    struct MultipleFilesWorker *worker; /**< Background thread doing the directory I/O of rotations */
 } MultipleFilesRingBuffer;
 
 /**
  * Initialise the multiple files buffer.
  * This function call opens the currently used log file.
+ * The files of the buffer are taken from the directory, in the order recorded
+ * in the manifest. Files missing from the manifest are counted as well.
  * A check of the complete size of the files is done during startup.
  * Old files are deleted, if there is not enough space left to create new file.
  * This function must be called before using further multiple files functions.
@@ -80,12 +108,13 @@ extern DltReturnValue multiple_files_buffer_init(MultipleFilesRingBuffer *files_
 
 /**
  * Uninitialise the multiple files buffer.
- * This function call closes currently used log file.
+ * This function call closes currently used log file, waits for pending
+ * background work and writes the final manifest.
  * This function must be called after usage of multiple files.
  * @param files_buffer pointer to MultipleFilesRingBuffer struct.
  * @return negative value if there was an error.
 */
-extern DltReturnValue multiple_files_buffer_free(const MultipleFilesRingBuffer *files_buffer);
+extern DltReturnValue multiple_files_buffer_free(MultipleFilesRingBuffer *files_buffer);
 
 /**
  * Write data into multiple files.
@@ -103,6 +132,9 @@ extern DltReturnValue multiple_files_buffer_write(MultipleFilesRingBuffer *files
 
 /**
  * First the limits are verified. Then the oldest file is deleted and a new file is created on demand.
+ * The limits are checked against the manifest. The new file is normally the one
+ * preallocated in the background, deleting, renaming and the manifest update are
+ * left to the background thread as well.
  * @param files_buffer pointer to MultipleFilesRingBuffer struct.
  * @param size size in bytes of data that will be written.
  */
@@ -115,12 +147,12 @@ void multiple_files_buffer_rotate_file(MultipleFilesRingBuffer *files_buffer,
  * @param data pointer to data block to be written, null if not used.
  * @param size size in bytes of given data block to be written, 0 if not used.
  */
-DltReturnValue multiple_files_buffer_write_chunk(const MultipleFilesRingBuffer *files_buffer,
+DltReturnValue multiple_files_buffer_write_chunk(MultipleFilesRingBuffer *files_buffer,
                                                  const unsigned char *data,
                                                  int size);
 
 /**
- * Get size of currently used multiple files buffer.
+ * Get size of currently used multiple files buffer as recorded in the manifest.
  * @return size in bytes.
  */
 extern ssize_t multiple_files_buffer_get_total_size(const MultipleFilesRingBuffer *files_buffer);
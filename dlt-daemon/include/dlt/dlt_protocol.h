@@ -246,6 +246,8 @@ enum dlt_user_services {
     DLT_SERVICE_ID_RESERVED_C = 0xF0C,
     DLT_SERVICE_ID_RESERVED_D = 0xF0D,
     DLT_SERVICE_ID_RESERVED_E = 0xF0E,
+    DLT_SERVICE_ID_SET_CLIENT_FILTER = 0xF0F,
+    DLT_SERVICE_ID_SET_CLIENT_COMPRESSION = 0xF10,
     DLT_USER_SERVICE_ID_LAST_ENTRY
 };
 
@@ -0,0 +1,94 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_storage_writer.h
+ * Writer for logstorage and offline trace files. With io_uring the writes
+ * are queued and completed from the daemon event loop, otherwise they are
+ * done synchronously.
+ */
+
+#ifndef DLT_STORAGE_WRITER_H
+#define DLT_STORAGE_WRITER_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "dlt_types.h"
+
+/* Number of writes which can be in flight */
+#define DLT_STORAGE_WRITER_ENTRIES 64
+/* Size of one registered buffer; larger writes are done synchronously */
+#define DLT_STORAGE_WRITER_SLOT_SIZE 8192
+
+/**
+ * Set up the asynchronous writer. Until this is called, and if it fails,
+ * all functions below work synchronously.
+ * @param entries number of writes which can be in flight
+ * @param slot_size size of the buffer of each write
+ * @return DLT_RETURN_OK on success, DLT_RETURN_ERROR if io_uring is not
+ *         available (not built with it, or refused by the kernel)
+ */
+DltReturnValue dlt_storage_writer_init(unsigned int entries, size_t slot_size);
+
+/**
+ * Wait for all queued I/O and release the writer. Later calls are synchronous.
+ */
+void dlt_storage_writer_free(void);
+
+/**
+ * @return true if writes are queued to io_uring
+ */
+bool dlt_storage_writer_is_async(void);
+
+/**
+ * Get the eventfd signalled when queued I/O completes.
+ * @return file descriptor to be polled for POLLIN, -1 if synchronous
+ */
+int dlt_storage_writer_get_fd(void);
+
+/**
+ * Write data at the given offset of a file. The data is copied, the buffers
+ * can be reused on return. The file must not be opened with O_APPEND, writes
+ * may complete in any order.
+ * @param fd file descriptor, it may be closed while the write is in flight:
+ *           a queued write holds a duplicate of it until it is done
+ * @param offset file offset of the first byte
+ * @param iov data to be written
+ * @param iovcnt number of entries in iov
+ * @return DLT_RETURN_OK if the write was queued or done
+ */
+DltReturnValue dlt_storage_writer_write(int fd, off_t offset, const struct iovec *iov, int iovcnt);
+
+/**
+ * Close a file after all writes queued before, optionally synced to disk.
+ * The writer owns the file descriptor afterwards.
+ * @param fd file descriptor
+ * @param sync fsync the file before it is closed
+ * @return DLT_RETURN_OK if the close was queued or done
+ */
+DltReturnValue dlt_storage_writer_close(int fd, bool sync);
+
+/**
+ * Reap completed I/O and report errors. Called from the event loop when the
+ * fd returned by dlt_storage_writer_get_fd() is readable.
+ */
+void dlt_storage_writer_handle_completions(void);
+
+/**
+ * Block until all queued I/O is completed.
+ */
+void dlt_storage_writer_wait(void);
+
+#endif /* DLT_STORAGE_WRITER_H */
@@ -385,6 +385,26 @@
     } while(false)
 #endif
 
+/**
+ * Send log message whose message id is assigned by the catalog generator
+ * (util/dlt-catalog-gen.py). NAME is resolved to DLT_MSGID_<NAME> from the
+ * generated header; the DLT_CSTRING() arguments become the static text of
+ * the catalog entry and are only transmitted in verbose mode.
+ * @param CONTEXT object containing information about one special logging context
+ * @param LOGLEVEL the log level of the log message
+ * @param NAME catalog name of the log message, must be a C identifier
+ * @param ... variable list of arguments
+ * @note Example: DLT_LOG_CATALOG(hContext, DLT_LOG_INFO, SPEED_UPDATE,
+ *                                DLT_CSTRING("speed"), DLT_UINT16(speed));
+ */
+#ifdef _MSC_VER
+/* DLT_LOG_CATALOG is not supported by MS Visual C++ */
+/* use function interface instead                    */
+#else
+#   define DLT_LOG_CATALOG(CONTEXT, LOGLEVEL, NAME, ...) \
+    DLT_LOG_ID(CONTEXT, LOGLEVEL, DLT_MSGID_##NAME, __VA_ARGS__)
+#endif
+
 /**
  * Send log message with variable list of messages (intended for non-verbose mode)
  * @param CONTEXT object containing information about one special logging context
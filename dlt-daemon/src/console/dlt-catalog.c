@@ -0,0 +1,347 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt-catalog.c
+ * Non-verbose message catalog as generated by util/dlt-catalog-gen.py.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dlt_common.h"
+#include "dlt_protocol.h"
+
+#include "dlt-catalog.h"
+
+#define DLT_CATALOG_TEXT_PREFIX "text="
+
+typedef struct
+{
+    const char *name;
+    uint32_t type_info;
+} DltCatalogType;
+
+static const DltCatalogType dlt_catalog_types[] = {
+    { "int8", DLT_TYPE_INFO_SINT | DLT_TYLE_8BIT },
+    { "int16", DLT_TYPE_INFO_SINT | DLT_TYLE_16BIT },
+    { "int32", DLT_TYPE_INFO_SINT | DLT_TYLE_32BIT },
+    { "int64", DLT_TYPE_INFO_SINT | DLT_TYLE_64BIT },
+    { "uint8", DLT_TYPE_INFO_UINT | DLT_TYLE_8BIT },
+    { "uint16", DLT_TYPE_INFO_UINT | DLT_TYLE_16BIT },
+    { "uint32", DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT },
+    { "uint64", DLT_TYPE_INFO_UINT | DLT_TYLE_64BIT },
+    { "hex8", DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_8BIT },
+    { "hex16", DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_16BIT },
+    { "hex32", DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_32BIT },
+    { "hex64", DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_64BIT },
+    { "bin8", DLT_TYPE_INFO_UINT | DLT_SCOD_BIN | DLT_TYLE_8BIT },
+    { "bin16", DLT_TYPE_INFO_UINT | DLT_SCOD_BIN | DLT_TYLE_16BIT },
+    { "float32", DLT_TYPE_INFO_FLOA | DLT_TYLE_32BIT },
+    { "float64", DLT_TYPE_INFO_FLOA | DLT_TYLE_64BIT },
+    { "bool", DLT_TYPE_INFO_BOOL | DLT_TYLE_8BIT },
+    { "string", DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII },
+    { "utf8", DLT_TYPE_INFO_STRG | DLT_SCOD_UTF8 },
+    { "raw", DLT_TYPE_INFO_RAWD }
+};
+
+static int dlt_catalog_compare(const void *a, const void *b)
+{
+    uint32_t id_a = ((const DltCatalogEntry *)a)->id;
+    uint32_t id_b = ((const DltCatalogEntry *)b)->id;
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+static void dlt_catalog_entry_free(DltCatalogEntry *entry)
+{
+    int i;
+
+    for (i = 0; i < entry->num_args; i++)
+        free(entry->args[i].text);
+
+    free(entry->args);
+    free(entry->name);
+    entry->args = NULL;
+    entry->name = NULL;
+    entry->num_args = 0;
+}
+
+/* Undo the escaping of tab, newline and backslash in place */
+static void dlt_catalog_unescape(char *text)
+{
+    char *out = text;
+
+    for (; *text != '\0'; text++) {
+        if ((*text == '\\') && (text[1] != '\0')) {
+            text++;
+
+            if (*text == 't')
+                *out++ = '\t';
+            else if (*text == 'n')
+                *out++ = '\n';
+            else
+                *out++ = *text;
+        }
+        else {
+            *out++ = *text;
+        }
+    }
+
+    *out = '\0';
+}
+
+static DltReturnValue dlt_catalog_parse_arg(DltCatalogArg *arg, const char *field)
+{
+    size_t i;
+
+    if (strncmp(field, DLT_CATALOG_TEXT_PREFIX, strlen(DLT_CATALOG_TEXT_PREFIX)) == 0) {
+        arg->type_info = 0;
+        arg->text = strdup(field + strlen(DLT_CATALOG_TEXT_PREFIX));
+
+        if (arg->text == NULL)
+            return DLT_RETURN_ERROR;
+
+        dlt_catalog_unescape(arg->text);
+        return DLT_RETURN_OK;
+    }
+
+    for (i = 0; i < sizeof(dlt_catalog_types) / sizeof(dlt_catalog_types[0]); i++) {
+        if (strcmp(field, dlt_catalog_types[i].name) == 0) {
+            arg->type_info = dlt_catalog_types[i].type_info;
+            arg->text = NULL;
+            return DLT_RETURN_OK;
+        }
+    }
+
+    return DLT_RETURN_ERROR;
+}
+
+/* Parse one "<id>\t<name>\t<source>\t<argument>..." line into entry */
+static DltReturnValue dlt_catalog_parse_line(DltCatalogEntry *entry, char *line)
+{
+    char *save = NULL;
+    char *field;
+    char *end = NULL;
+    int capacity = 0;
+
+    memset(entry, 0, sizeof(*entry));
+
+    field = strtok_r(line, "\t", &save);
+
+    if (field == NULL)
+        return DLT_RETURN_ERROR;
+
+    entry->id = (uint32_t)strtoul(field, &end, 16);
+
+    if ((end == field) || (*end != '\0'))
+        return DLT_RETURN_ERROR;
+
+    field = strtok_r(NULL, "\t", &save);
+
+    if (field == NULL)
+        return DLT_RETURN_ERROR;
+
+    entry->name = strdup(field);
+
+    /* source location, only informative */
+    if ((entry->name == NULL) || (strtok_r(NULL, "\t", &save) == NULL))
+        return DLT_RETURN_ERROR;
+
+    while ((field = strtok_r(NULL, "\t", &save)) != NULL) {
+        if (entry->num_args == capacity) {
+            int new_capacity = (capacity == 0) ? 4 : capacity * 2;
+            DltCatalogArg *args = realloc(entry->args, (size_t)new_capacity * sizeof(DltCatalogArg));
+
+            if (args == NULL)
+                return DLT_RETURN_ERROR;
+
+            entry->args = args;
+            capacity = new_capacity;
+        }
+
+        if (dlt_catalog_parse_arg(&entry->args[entry->num_args], field) != DLT_RETURN_OK)
+            return DLT_RETURN_ERROR;
+
+        entry->num_args++;
+    }
+
+    return DLT_RETURN_OK;
+}
+
+DltReturnValue dlt_catalog_load(DltCatalog *catalog, const char *filename, int verbose)
+{
+    FILE *handle;
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t len;
+    int line_number = 0;
+    int capacity = 0;
+    int i;
+    DltReturnValue ret = DLT_RETURN_OK;
+
+    if ((catalog == NULL) || (filename == NULL))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    catalog->entries = NULL;
+    catalog->num_entries = 0;
+
+    handle = fopen(filename, "r");
+
+    if (handle == NULL) {
+        fprintf(stderr, "Catalog file %s cannot be opened!\n", filename);
+        return DLT_RETURN_ERROR;
+    }
+
+    while ((len = getline(&line, &line_size, handle)) != -1) {
+        line_number++;
+
+        while ((len > 0) && ((line[len - 1] == '\n') || (line[len - 1] == '\r')))
+            line[--len] = '\0';
+
+        if ((len == 0) || (line[0] == '#'))
+            continue;
+
+        if (catalog->num_entries == capacity) {
+            int new_capacity = (capacity == 0) ? 64 : capacity * 2;
+            DltCatalogEntry *entries = realloc(catalog->entries,
+                                               (size_t)new_capacity * sizeof(DltCatalogEntry));
+
+            if (entries == NULL) {
+                ret = DLT_RETURN_ERROR;
+                break;
+            }
+
+            catalog->entries = entries;
+            capacity = new_capacity;
+        }
+
+        if (dlt_catalog_parse_line(&catalog->entries[catalog->num_entries], line) != DLT_RETURN_OK) {
+            fprintf(stderr, "Catalog file %s: invalid entry in line %d\n", filename, line_number);
+            dlt_catalog_entry_free(&catalog->entries[catalog->num_entries]);
+            ret = DLT_RETURN_ERROR;
+            break;
+        }
+
+        catalog->num_entries++;
+    }
+
+    free(line);
+    fclose(handle);
+
+    if (ret == DLT_RETURN_OK) {
+        qsort(catalog->entries, (size_t)catalog->num_entries, sizeof(DltCatalogEntry),
+              dlt_catalog_compare);
+
+        for (i = 1; i < catalog->num_entries; i++) {
+            if (catalog->entries[i].id == catalog->entries[i - 1].id) {
+                fprintf(stderr, "Catalog file %s: message id 0x%08x used by %s and %s\n",
+                        filename, catalog->entries[i].id,
+                        catalog->entries[i - 1].name, catalog->entries[i].name);
+                ret = DLT_RETURN_ERROR;
+                break;
+            }
+        }
+    }
+
+    if (ret != DLT_RETURN_OK) {
+        dlt_catalog_free(catalog);
+        return ret;
+    }
+
+    if (verbose)
+        printf("Loaded %d catalog entries from %s\n", catalog->num_entries, filename);
+
+    return DLT_RETURN_OK;
+}
+
+void dlt_catalog_free(DltCatalog *catalog)
+{
+    int i;
+
+    if (catalog == NULL)
+        return;
+
+    for (i = 0; i < catalog->num_entries; i++)
+        dlt_catalog_entry_free(&catalog->entries[i]);
+
+    free(catalog->entries);
+    catalog->entries = NULL;
+    catalog->num_entries = 0;
+}
+
+const DltCatalogEntry *dlt_catalog_find(const DltCatalog *catalog, uint32_t id)
+{
+    DltCatalogEntry key;
+
+    if ((catalog == NULL) || (catalog->num_entries == 0))
+        return NULL;
+
+    key.id = id;
+
+    return bsearch(&key, catalog->entries, (size_t)catalog->num_entries,
+                   sizeof(DltCatalogEntry), dlt_catalog_compare);
+}
+
+DltReturnValue dlt_catalog_message_payload(const DltCatalog *catalog, DltMessage *msg,
+                                           char *text, size_t textlength, int verbose)
+{
+    const DltCatalogEntry *entry;
+    uint32_t id_tmp = 0;
+    uint8_t *ptr;
+    int32_t datalength;
+    size_t offset = 0;
+    int num;
+
+    if ((catalog == NULL) || (msg == NULL) || (msg->databuffer == NULL) || (text == NULL) ||
+        (textlength == 0))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    if (!DLT_MSG_IS_NONVERBOSE(msg) || DLT_MSG_IS_CONTROL(msg) ||
+        (msg->datasize < (int32_t)sizeof(uint32_t)))
+        return DLT_RETURN_OK;
+
+    memcpy(&id_tmp, msg->databuffer, sizeof(uint32_t));
+    entry = dlt_catalog_find(catalog, DLT_ENDIAN_GET_32(msg->standardheader->htyp, id_tmp));
+
+    if (entry == NULL)
+        return DLT_RETURN_OK;
+
+    ptr = msg->databuffer + sizeof(uint32_t);
+    datalength = msg->datasize - (int32_t)sizeof(uint32_t);
+    text[0] = '\0';
+
+    for (num = 0; num < entry->num_args; num++) {
+        if (num != 0)
+            offset += (size_t)snprintf(text + offset, textlength - offset, " ");
+
+        if (offset >= textlength)
+            return DLT_RETURN_ERROR;
+
+        if (entry->args[num].text != NULL)
+            snprintf(text + offset, textlength - offset, "%s", entry->args[num].text);
+        else if (dlt_message_argument_print(msg, entry->args[num].type_info, &ptr, &datalength,
+                                            text + offset, textlength - offset, -1,
+                                            verbose) != DLT_RETURN_OK)
+            return DLT_RETURN_ERROR;
+
+        offset += strlen(text + offset);
+    }
+
+    /* the payload does not belong to this entry, e.g. an outdated catalog */
+    if (datalength != 0)
+        return DLT_RETURN_ERROR;
+
+    return DLT_RETURN_TRUE;
+}
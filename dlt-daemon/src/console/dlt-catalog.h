@@ -0,0 +1,84 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt-catalog.h
+ * Non-verbose message catalog as generated by util/dlt-catalog-gen.py.
+ */
+
+#ifndef _DLT_CATALOG_H_
+#define _DLT_CATALOG_H_
+
+#include <stdint.h>
+
+#include "dlt_common.h"
+
+/* One argument of a catalog entry: either static text or a typed value */
+typedef struct
+{
+    uint32_t type_info; /**< verbose type info the value is printed as, 0 for static text */
+    char *text;         /**< static text, NULL for typed values */
+} DltCatalogArg;
+
+typedef struct
+{
+    uint32_t id;        /**< non-verbose message id */
+    char *name;         /**< catalog name of the log statement */
+    int num_args;
+    DltCatalogArg *args;
+} DltCatalogEntry;
+
+typedef struct
+{
+    DltCatalogEntry *entries; /**< sorted by id */
+    int num_entries;
+} DltCatalog;
+
+/**
+ * Load a catalog file.
+ * @param catalog pointer to catalog, must be freed with dlt_catalog_free()
+ * @param filename catalog file written by dlt-catalog-gen.py --catalog
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error
+ */
+DltReturnValue dlt_catalog_load(DltCatalog *catalog, const char *filename, int verbose);
+
+/**
+ * Free all entries of a catalog.
+ * @param catalog pointer to catalog
+ */
+void dlt_catalog_free(DltCatalog *catalog);
+
+/**
+ * Look up a message id.
+ * @param catalog pointer to catalog
+ * @param id non-verbose message id
+ * @return the entry or NULL if the id is unknown
+ */
+const DltCatalogEntry *dlt_catalog_find(const DltCatalog *catalog, uint32_t id);
+
+/**
+ * Print the payload of a non-verbose message like the verbose message of the
+ * same log statement would be printed by dlt_message_payload().
+ * @param catalog pointer to catalog
+ * @param msg pointer to structure of organising access to DLT messages
+ * @param text pointer to a ASCII string, in which the output is written
+ * @param textlength maximal size of text buffer
+ * @param verbose if set to true verbose information is printed out.
+ * @return DLT_RETURN_TRUE if the payload was printed, DLT_RETURN_OK if the
+ *         message is not described by the catalog, negative value on error
+ */
+DltReturnValue dlt_catalog_message_payload(const DltCatalog *catalog, DltMessage *msg,
+                                           char *text, size_t textlength, int verbose);
+
+#endif /* _DLT_CATALOG_H_ */
@@ -89,6 +89,8 @@
 #include <sys/uio.h> /* writev() */
 
 #include "dlt_common.h"
+#include "dlt-catalog.h"
+#include "dlt-parquet.h"
 
 #define COMMAND_SIZE        1024    /* Size of command */
 #define FILENAME_SIZE       1024    /* Size of filename */
@@ -117,10 +119,12 @@ void usage(void)
     printf("  -m            Print DLT file; payload as hex and ASCII\n");
     printf("  -s            Print DLT file; only headers\n");
     printf("  -o filename   Output messages in new DLT file\n");
+    printf("  -p filename   Export messages to a Parquet file; payload as ASCII\n");
     printf("Options:\n");
     printf("  -v            Verbose mode\n");
     printf("  -c            Count number of messages\n");
     printf("  -f filename   Enable filtering of messages\n");
+    printf("  -n filename   Print non-verbose messages using the catalog file\n");
     printf("  -b number     First <number> messages to be handled\n");
     printf("  -e number     Last <number> messages to be handled\n");
     printf("  -w            Follow dlt file while file is increasing\n");
@@ -210,12 +214,16 @@ int main(int argc, char *argv[])
     char *bvalue = 0;
     char *evalue = 0;
     char *ovalue = 0;
+    char *nvalue = 0;
+    char *pvalue = 0;
 
     int index;
     int c;
 
     DltFile file;
     DltFilter filter;
+    DltCatalog catalog = { NULL, 0 };
+    DltParquet *parquet = NULL;
 
     int ohandle = -1;
 
@@ -236,7 +244,7 @@ int main(int argc, char *argv[])
 
     opterr = 0;
 
-    while ((c = getopt (argc, argv, "vcashxmwtf:b:e:o:")) != -1) {
+    while ((c = getopt (argc, argv, "vcashxmwtf:b:e:o:n:p:")) != -1) {
         switch (c)
         {
         case 'v':
@@ -304,9 +312,20 @@ int main(int argc, char *argv[])
             ovalue = optarg;
             break;
         }
+        case 'n':
+        {
+            nvalue = optarg;
+            break;
+        }
+        case 'p':
+        {
+            pvalue = optarg;
+            break;
+        }
         case '?':
         {
-            if ((optopt == 'f') || (optopt == 'b') || (optopt == 'e') || (optopt == 'o'))
+            if ((optopt == 'f') || (optopt == 'b') || (optopt == 'e') || (optopt == 'o') ||
+                (optopt == 'n') || (optopt == 'p'))
                 fprintf (stderr, "Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
                 fprintf (stderr, "Unknown option `-%c'.\n", optopt);
@@ -328,6 +347,8 @@ int main(int argc, char *argv[])
     dlt_file_init(&file, vflag);
 
     /* first parse filter file if filter parameter is used */
+    dlt_filter_init(&filter, vflag);
+
     if (fvalue) {
         if (dlt_filter_load(&filter, fvalue, vflag) < DLT_RETURN_OK) {
             dlt_file_free(&file, vflag);
@@ -337,6 +358,13 @@ int main(int argc, char *argv[])
         dlt_file_set_filter(&file, &filter, vflag);
     }
 
+    if (nvalue) {
+        if (dlt_catalog_load(&catalog, nvalue, vflag) < DLT_RETURN_OK) {
+            dlt_file_free(&file, vflag);
+            return -1;
+        }
+    }
+
     if (ovalue) {
         ohandle = open(ovalue, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH); /* mode: wb */
 
@@ -400,6 +428,19 @@ int main(int argc, char *argv[])
         argc = optind + (n - 2);
     }
 
+    if (pvalue) {
+        parquet = dlt_parquet_open(pvalue, vflag);
+
+        if (parquet == NULL) {
+            if (ovalue) {
+                close(ohandle);
+                ohandle = -1;
+            }
+            dlt_file_free(&file, vflag);
+            return -1;
+        }
+    }
+
     for (index = optind; index < argc; index++) {
         if (tflag) {
             memset(tmp_filename, 0, FILENAME_SIZE);
@@ -415,7 +456,7 @@ int main(int argc, char *argv[])
             }
         }
 
-        if (aflag || sflag || xflag || mflag || ovalue) {
+        if (aflag || sflag || xflag || mflag || ovalue || pvalue) {
             if (bvalue)
                 begin = atoi(bvalue);
             else
@@ -432,6 +473,8 @@ int main(int argc, char *argv[])
                     close(ohandle);
                     ohandle = -1;
                 }
+                if (parquet)
+                    dlt_parquet_close(parquet);
                 dlt_file_free(&file, vflag);
                 return -1;
             }
@@ -442,6 +485,8 @@ int main(int argc, char *argv[])
                     close(ohandle);
                     ohandle = -1;
                 }
+                if (parquet)
+                    dlt_parquet_close(parquet);
                 dlt_file_free(&file, vflag);
                 return -1;
             }
@@ -463,8 +508,12 @@ int main(int argc, char *argv[])
 
                     printf("%s ", text);
 
-                    if (dlt_message_payload(&file.msg, text, DLT_CONVERT_TEXTBUFSIZE, DLT_OUTPUT_ASCII, vflag) < DLT_RETURN_OK)
-                        continue;
+                    if ((nvalue == NULL) ||
+                        (dlt_catalog_message_payload(&catalog, &file.msg, text, DLT_CONVERT_TEXTBUFSIZE,
+                                                     vflag) != DLT_RETURN_TRUE)) {
+                        if (dlt_message_payload(&file.msg, text, DLT_CONVERT_TEXTBUFSIZE, DLT_OUTPUT_ASCII, vflag) < DLT_RETURN_OK)
+                            continue;
+                    }
 
                     printf("[%s]\n", text);
                 }
@@ -495,6 +544,28 @@ int main(int argc, char *argv[])
                         printf("in main: writev(ohandle, iov, 2); returned an error!");
                         close(ohandle);
                         ohandle = -1;
+                        if (parquet)
+                            dlt_parquet_close(parquet);
+                        dlt_file_free(&file, vflag);
+                        return -1;
+                    }
+                }
+
+                /* if Parquet export enabled add the message as row */
+                if (parquet) {
+                    if ((nvalue == NULL) ||
+                        (dlt_catalog_message_payload(&catalog, &file.msg, text, DLT_CONVERT_TEXTBUFSIZE,
+                                                     vflag) != DLT_RETURN_TRUE)) {
+                        if (dlt_message_payload(&file.msg, text, DLT_CONVERT_TEXTBUFSIZE, DLT_OUTPUT_ASCII, vflag) < DLT_RETURN_OK)
+                            text[0] = 0;
+                    }
+
+                    if (dlt_parquet_write_message(parquet, &file.msg, text) < DLT_RETURN_OK) {
+                        if (ovalue) {
+                            close(ohandle);
+                            ohandle = -1;
+                        }
+                        dlt_parquet_close(parquet);
                         dlt_file_free(&file, vflag);
                         return -1;
                     }
@@ -536,6 +607,11 @@ int main(int argc, char *argv[])
         ohandle = -1;
     }
 
+    if (parquet && (dlt_parquet_close(parquet) < DLT_RETURN_OK)) {
+        dlt_file_free(&file, vflag);
+        return -1;
+    }
+
     if (tflag) {
         empty_dir(DLT_CONVERT_WS);
         if (files) {
@@ -554,6 +630,8 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    dlt_catalog_free(&catalog);
+    dlt_filter_free(&filter, vflag);
     dlt_file_free(&file, vflag);
 
     return 0;
@@ -0,0 +1,1004 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt-grep.c
+ * Search DLT files for messages by ECU, application, context, log level,
+ * time and text of the string arguments.
+ *
+ * The files are mapped into memory and the records are matched on their raw
+ * headers and payload; a DltMessage is only built for messages printed as
+ * text. The main thread splits a file into chunks of whole records, worker
+ * threads match the chunks and the main thread writes their results in file
+ * order.
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <regex.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dlt_common.h"
+
+#define DLT_GREP_MAX_IDS        16
+/* Records per chunk are added until the chunk has this size */
+#define DLT_GREP_CHUNK_SIZE     (1024 * 1024)
+/* Chunks in flight per worker thread */
+#define DLT_GREP_CHUNKS_PER_THREAD 4
+#define DLT_GREP_MAX_THREADS    64
+#define DLT_GREP_STRING_SIZE    (UINT16_MAX + 1)
+#define DLT_GREP_EXTENSION      ".dlt"
+/* Pattern at the start of each storage header */
+#define DLT_GREP_PATTERN        "DLT\x01"
+#define DLT_GREP_PATTERN_SIZE   4
+
+typedef struct
+{
+    uint32_t ecu[DLT_GREP_MAX_IDS];
+    int num_ecu;
+    uint32_t apid[DLT_GREP_MAX_IDS];
+    int num_apid;
+    uint32_t ctid[DLT_GREP_MAX_IDS];
+    int num_ctid;
+    int level;
+    int64_t begin;
+    int64_t end;
+    const char *substring;
+    size_t substring_length;
+    const char *regex;
+    bool count;
+    bool dlt_output;
+    bool print_filename;
+    int threads;
+    int verbose;
+    FILE *output;
+} DltGrepOptions;
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+} DltGrepBuffer;
+
+typedef enum
+{
+    DLT_GREP_CHUNK_FREE = 0,
+    DLT_GREP_CHUNK_QUEUED,
+    DLT_GREP_CHUNK_DONE
+} DltGrepChunkState;
+
+typedef struct
+{
+    const uint8_t *start;
+    const uint8_t *end;
+    int first;
+    int matches;
+    DltGrepChunkState state;
+    DltGrepBuffer output;
+} DltGrepChunk;
+
+typedef struct
+{
+    const DltGrepOptions *options;
+    const char *filename;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    DltGrepChunk *chunks;
+    int num_chunks;
+    uint64_t next_fill;
+    uint64_t next_work;
+    uint64_t next_write;
+    bool finished;
+    bool failed;
+    long matches;
+} DltGrepQueue;
+
+typedef struct
+{
+    DltGrepQueue *queue;
+    pthread_t thread;
+    regex_t regex;
+    bool regex_compiled;
+    DltMessage msg;
+    char text[DLT_CONVERT_TEXTBUFSIZE];
+    char string[DLT_GREP_STRING_SIZE];
+    uint8_t record[sizeof(DltStorageHeader) + UINT16_MAX];
+} DltGrepWorker;
+
+static const char *dlt_grep_levels[] = { "fatal", "error", "warn", "info", "debug", "verbose" };
+
+/**
+ * Print usage information of tool.
+ */
+static void usage(void)
+{
+    char version[DLT_CONVERT_TEXTBUFSIZE];
+
+    dlt_get_version(version, 255);
+
+    printf("Usage: dlt-grep [options] file|directory ...\n");
+    printf("Search DLT files for messages, print them as ASCII or store them in a DLT file.\n");
+    printf("Directories are searched for %s files in alphabetical order.\n", DLT_GREP_EXTENSION);
+    printf("%s \n", version);
+    printf("Options:\n");
+    printf("  -h            Usage\n");
+    printf("  -E ecu        Match ECU id (can be given more than once)\n");
+    printf("  -A apid       Match application id (can be given more than once)\n");
+    printf("  -C ctid       Match context id (can be given more than once)\n");
+    printf("  -l level      Match log messages up to level (fatal, error, warn, info, debug, verbose or 1-6)\n");
+    printf("  -b time       Match messages stored at or after time\n");
+    printf("  -e time       Match messages stored at or before time\n");
+    printf("                (seconds since epoch or \"YYYY-MM-DD HH:MM:SS\" local time)\n");
+    printf("  -s text       Match messages with a string argument containing text\n");
+    printf("  -r regex      Match messages with a string argument matching the extended regex\n");
+    printf("  -o filename   Store matching messages in a DLT file instead of printing them\n");
+    printf("  -c            Only print the number of matching messages\n");
+    printf("  -j threads    Number of worker threads (default: number of CPUs)\n");
+    printf("  -v            Verbose mode\n");
+}
+
+static bool dlt_grep_add_id(uint32_t *ids, int *num_ids, const char *id)
+{
+    char text[DLT_ID_SIZE];
+
+    if ((*num_ids >= DLT_GREP_MAX_IDS) || (strlen(id) > DLT_ID_SIZE)) {
+        fprintf(stderr, "ERROR: Invalid id %s or more than %d ids given!\n", id, DLT_GREP_MAX_IDS);
+        return false;
+    }
+
+    dlt_set_id(text, id);
+    memcpy(&ids[(*num_ids)++], text, DLT_ID_SIZE);
+
+    return true;
+}
+
+static int dlt_grep_parse_level(const char *text)
+{
+    int i;
+
+    for (i = 0; i < (int)(sizeof(dlt_grep_levels) / sizeof(dlt_grep_levels[0])); i++)
+        if (strcmp(text, dlt_grep_levels[i]) == 0)
+            return i + DLT_LOG_FATAL;
+
+    i = atoi(text);
+
+    return ((i >= DLT_LOG_FATAL) && (i <= DLT_LOG_VERBOSE)) ? i : -1;
+}
+
+static int64_t dlt_grep_parse_time(const char *text)
+{
+    struct tm tm;
+    char *end = NULL;
+    long long seconds;
+
+    seconds = strtoll(text, &end, 10);
+
+    if ((end != text) && (*end == '\0'))
+        return (seconds >= 0) ? seconds : -1;
+
+    memset(&tm, 0, sizeof(tm));
+    end = strptime(text, "%Y-%m-%d %H:%M:%S", &tm);
+
+    if ((end == NULL) || (*end != '\0'))
+        return -1;
+
+    tm.tm_isdst = -1;
+
+    return (int64_t)mktime(&tm);
+}
+
+static bool dlt_grep_buffer_append(DltGrepBuffer *buffer, const void *data, size_t size)
+{
+    size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
+    char *new_data;
+
+    if (buffer->size + size > buffer->capacity) {
+        while (capacity < buffer->size + size)
+            capacity *= 2;
+
+        new_data = realloc(buffer->data, capacity);
+
+        if (new_data == NULL)
+            return false;
+
+        buffer->data = new_data;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+
+    return true;
+}
+
+static bool dlt_grep_id_match(const uint32_t *ids, int num_ids, const void *id)
+{
+    uint32_t value;
+    int i;
+
+    if (num_ids == 0)
+        return true;
+
+    memcpy(&value, id, sizeof(value));
+
+    for (i = 0; i < num_ids; i++)
+        if (ids[i] == value)
+            return true;
+
+    return false;
+}
+
+static bool dlt_grep_string_match(DltGrepWorker *worker, const uint8_t *string, size_t length)
+{
+    const DltGrepOptions *options = worker->queue->options;
+
+    /* the string ends at the first NUL */
+    length = strnlen((const char *)string, length);
+
+    if ((options->substring != NULL) &&
+        (memmem(string, length, options->substring, options->substring_length) == NULL))
+        return false;
+
+    if (options->regex != NULL) {
+        memcpy(worker->string, string, length);
+        worker->string[length] = '\0';
+
+        if (regexec(&worker->regex, worker->string, 0, NULL, 0) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+static bool dlt_grep_read_16(uint8_t htyp, const uint8_t **ptr, size_t *length, uint16_t *value)
+{
+    if (*length < sizeof(uint16_t))
+        return false;
+
+    memcpy(value, *ptr, sizeof(uint16_t));
+    *value = DLT_ENDIAN_GET_16(htyp, *value);
+    *ptr += sizeof(uint16_t);
+    *length -= sizeof(uint16_t);
+
+    return true;
+}
+
+static bool dlt_grep_skip(const uint8_t **ptr, size_t *length, size_t size)
+{
+    if (*length < size)
+        return false;
+
+    *ptr += size;
+    *length -= size;
+
+    return true;
+}
+
+/**
+ * Walk the arguments of a verbose payload and match its strings.
+ * @return 1 if a string matches, 0 if not, -1 if the payload contains types
+ *         that are not walked (arrays, structs) or is corrupted
+ */
+static int dlt_grep_match_arguments(DltGrepWorker *worker, uint8_t htyp, const uint8_t *ptr, size_t length)
+{
+    static const size_t tyle_size[] = { 0, 1, 2, 4, 8, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint32_t type_info;
+    uint16_t size;
+    uint16_t name;
+    uint16_t unit;
+    size_t value;
+
+    while (length > 0) {
+        if (length < sizeof(uint32_t))
+            return -1;
+
+        memcpy(&type_info, ptr, sizeof(uint32_t));
+        type_info = DLT_ENDIAN_GET_32(htyp, type_info);
+        ptr += sizeof(uint32_t);
+        length -= sizeof(uint32_t);
+        value = tyle_size[type_info & DLT_TYPE_INFO_TYLE];
+        name = 0;
+        unit = 0;
+
+        if (type_info & (DLT_TYPE_INFO_ARAY | DLT_TYPE_INFO_STRU)) {
+            return -1;
+        }
+        else if (type_info & (DLT_TYPE_INFO_STRG | DLT_TYPE_INFO_RAWD)) {
+            if (!dlt_grep_read_16(htyp, &ptr, &length, &size) ||
+                ((type_info & DLT_TYPE_INFO_VARI) && !dlt_grep_read_16(htyp, &ptr, &length, &name)) ||
+                !dlt_grep_skip(&ptr, &length, name) || (length < size))
+                return -1;
+
+            if ((type_info & DLT_TYPE_INFO_STRG) && dlt_grep_string_match(worker, ptr, size))
+                return 1;
+
+            dlt_grep_skip(&ptr, &length, size);
+        }
+        else if (type_info & DLT_TYPE_INFO_BOOL) {
+            if (((type_info & DLT_TYPE_INFO_VARI) && !dlt_grep_read_16(htyp, &ptr, &length, &name)) ||
+                !dlt_grep_skip(&ptr, &length, name) || !dlt_grep_skip(&ptr, &length, value ? value : 1))
+                return -1;
+        }
+        else if (type_info & (DLT_TYPE_INFO_SINT | DLT_TYPE_INFO_UINT | DLT_TYPE_INFO_FLOA)) {
+            if ((value == 0) ||
+                ((type_info & DLT_TYPE_INFO_VARI) &&
+                 (!dlt_grep_read_16(htyp, &ptr, &length, &name) || !dlt_grep_read_16(htyp, &ptr, &length, &unit))) ||
+                !dlt_grep_skip(&ptr, &length, (size_t)name + unit))
+                return -1;
+
+            /* quantization and offset */
+            if ((type_info & DLT_TYPE_INFO_FIXP) &&
+                ((value > 8) || !dlt_grep_skip(&ptr, &length, sizeof(float) + ((value == 8) ? 8 : 4))))
+                return -1;
+
+            if (!dlt_grep_skip(&ptr, &length, value))
+                return -1;
+        }
+        else {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* Fill worker->msg from a record for printing, 0 on success */
+static int dlt_grep_message(DltGrepWorker *worker, const uint8_t *record, size_t size)
+{
+    /* the mapping is read-only, dlt_message_read() wants a writable buffer */
+    memcpy(worker->record, record, size);
+
+    if (dlt_message_read(&worker->msg, worker->record + sizeof(DltStorageHeader),
+                         (unsigned int)(size - sizeof(DltStorageHeader)), 0, 0) != DLT_MESSAGE_ERROR_OK)
+        return -1;
+
+    memcpy(worker->msg.headerbuffer, worker->record, sizeof(DltStorageHeader));
+
+    return 0;
+}
+
+/* Match one record: storage header, standard header, extras, payload */
+static bool dlt_grep_match(DltGrepWorker *worker, const uint8_t *record, size_t size)
+{
+    const DltGrepOptions *options = worker->queue->options;
+    const DltStorageHeader *storage = (const DltStorageHeader *)record;
+    const uint8_t *ptr = record + sizeof(DltStorageHeader);
+    const uint8_t *payload;
+    const DltExtendedHeader *extended = NULL;
+    const void *ecu = storage->ecu;
+    uint8_t htyp = ptr[0];
+    size_t header = sizeof(DltStorageHeader) + sizeof(DltStandardHeader) +
+        DLT_STANDARD_HEADER_EXTRA_SIZE(htyp);
+    int ret;
+
+    if (((options->begin >= 0) && ((int64_t)storage->seconds < options->begin)) ||
+        ((options->end >= 0) && ((int64_t)storage->seconds > options->end)))
+        return false;
+
+    if (DLT_IS_HTYP_UEH(htyp)) {
+        if (header + sizeof(DltExtendedHeader) > size)
+            return false;
+
+        extended = (const DltExtendedHeader *)(record + header);
+        header += sizeof(DltExtendedHeader);
+    }
+    else if (header > size) {
+        return false;
+    }
+
+    if (DLT_IS_HTYP_WEID(htyp))
+        ecu = ptr + sizeof(DltStandardHeader);
+
+    if (!dlt_grep_id_match(options->ecu, options->num_ecu, ecu))
+        return false;
+
+    if ((options->num_apid > 0) || (options->num_ctid > 0) || (options->level > 0)) {
+        if (extended == NULL)
+            return false;
+
+        if (!dlt_grep_id_match(options->apid, options->num_apid, extended->apid) ||
+            !dlt_grep_id_match(options->ctid, options->num_ctid, extended->ctid))
+            return false;
+
+        if ((options->level > 0) &&
+            ((DLT_GET_MSIN_MSTP(extended->msin) != DLT_TYPE_LOG) ||
+             (DLT_GET_MSIN_MTIN(extended->msin) < DLT_LOG_FATAL) ||
+             (DLT_GET_MSIN_MTIN(extended->msin) > options->level)))
+            return false;
+    }
+
+    if ((options->substring == NULL) && (options->regex == NULL))
+        return true;
+
+    payload = record + header;
+
+    if ((extended != NULL) && DLT_IS_MSIN_VERB(extended->msin)) {
+        /* strings are stored as printed, this rejects most messages without
+         * walking the arguments */
+        if ((options->substring != NULL) &&
+            (memmem(payload, size - header, options->substring, options->substring_length) == NULL))
+            return false;
+
+        ret = dlt_grep_match_arguments(worker, htyp, payload, size - header);
+
+        if (ret >= 0)
+            return ret == 1;
+    }
+
+    /* non-verbose payload or arguments not walked: match the printed payload */
+    if ((dlt_grep_message(worker, record, size) != 0) ||
+        (dlt_message_payload(&worker->msg, worker->text, DLT_CONVERT_TEXTBUFSIZE, DLT_OUTPUT_ASCII,
+                             0) < DLT_RETURN_OK))
+        return false;
+
+    return dlt_grep_string_match(worker, (const uint8_t *)worker->text, strlen(worker->text));
+}
+
+static bool dlt_grep_print(DltGrepWorker *worker, DltGrepChunk *chunk, const uint8_t *record, size_t size,
+                           int num)
+{
+    const DltGrepOptions *options = worker->queue->options;
+    char prefix[FILENAME_MAX + 32];
+    int length;
+
+    if (options->count)
+        return true;
+
+    if (options->dlt_output)
+        return dlt_grep_buffer_append(&chunk->output, record, size);
+
+    if ((dlt_grep_message(worker, record, size) != 0) ||
+        (dlt_message_header(&worker->msg, worker->text, DLT_CONVERT_TEXTBUFSIZE, 0) < DLT_RETURN_OK))
+        return true;
+
+    if (options->print_filename)
+        length = snprintf(prefix, sizeof(prefix), "%s:%d ", worker->queue->filename, num);
+    else
+        length = snprintf(prefix, sizeof(prefix), "%d ", num);
+
+    if (!dlt_grep_buffer_append(&chunk->output, prefix, (size_t)length) ||
+        !dlt_grep_buffer_append(&chunk->output, worker->text, strlen(worker->text)) ||
+        !dlt_grep_buffer_append(&chunk->output, " [", 2))
+        return false;
+
+    if (dlt_message_payload(&worker->msg, worker->text, DLT_CONVERT_TEXTBUFSIZE, DLT_OUTPUT_ASCII,
+                            0) < DLT_RETURN_OK)
+        worker->text[0] = '\0';
+
+    return dlt_grep_buffer_append(&chunk->output, worker->text, strlen(worker->text)) &&
+           dlt_grep_buffer_append(&chunk->output, "]\n", 2);
+}
+
+/* Size of the record at ptr, 0 if there is no valid record */
+static size_t dlt_grep_record_size(const uint8_t *ptr, const uint8_t *end)
+{
+    const DltStandardHeader *standard = (const DltStandardHeader *)(ptr + sizeof(DltStorageHeader));
+    size_t size;
+
+    if ((size_t)(end - ptr) < sizeof(DltStorageHeader) + sizeof(DltStandardHeader))
+        return 0;
+
+    if (memcmp(ptr, DLT_GREP_PATTERN, DLT_GREP_PATTERN_SIZE) != 0)
+        return 0;
+
+    size = sizeof(DltStorageHeader) + DLT_BETOH_16(standard->len);
+
+    if ((size < sizeof(DltStorageHeader) + sizeof(DltStandardHeader)) || (size > (size_t)(end - ptr)))
+        return 0;
+
+    return size;
+}
+
+/* Start of the next record after corrupted data, end if there is none */
+static const uint8_t *dlt_grep_resync(const uint8_t *ptr, const uint8_t *end)
+{
+    const uint8_t *next;
+
+    for (ptr++; ptr < end; ptr = next + 1) {
+        next = memmem(ptr, (size_t)(end - ptr), DLT_GREP_PATTERN, DLT_GREP_PATTERN_SIZE);
+
+        if (next == NULL)
+            return end;
+
+        if (dlt_grep_record_size(next, end) > 0)
+            return next;
+    }
+
+    return end;
+}
+
+static bool dlt_grep_chunk(DltGrepWorker *worker, DltGrepChunk *chunk)
+{
+    const uint8_t *ptr = chunk->start;
+    int num = chunk->first;
+    size_t size;
+
+    chunk->matches = 0;
+
+    while (ptr < chunk->end) {
+        size = dlt_grep_record_size(ptr, chunk->end);
+
+        if (size == 0) {
+            ptr = dlt_grep_resync(ptr, chunk->end);
+            continue;
+        }
+
+        if (dlt_grep_match(worker, ptr, size)) {
+            chunk->matches++;
+
+            if (!dlt_grep_print(worker, chunk, ptr, size, num))
+                return false;
+        }
+
+        ptr += size;
+        num++;
+    }
+
+    return true;
+}
+
+static void *dlt_grep_worker(void *arg)
+{
+    DltGrepWorker *worker = (DltGrepWorker *)arg;
+    DltGrepQueue *queue = worker->queue;
+    DltGrepChunk *chunk;
+    bool ok;
+
+    pthread_mutex_lock(&queue->mutex);
+
+    while (true) {
+        while ((queue->next_work == queue->next_fill) && !queue->finished)
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+
+        if (queue->next_work == queue->next_fill)
+            break;
+
+        chunk = &queue->chunks[queue->next_work++ % (uint64_t)queue->num_chunks];
+        pthread_mutex_unlock(&queue->mutex);
+
+        ok = dlt_grep_chunk(worker, chunk);
+
+        pthread_mutex_lock(&queue->mutex);
+
+        if (!ok)
+            queue->failed = true;
+
+        chunk->state = DLT_GREP_CHUNK_DONE;
+        pthread_cond_broadcast(&queue->cond);
+    }
+
+    pthread_mutex_unlock(&queue->mutex);
+
+    return NULL;
+}
+
+/* Write the chunks done in file order, waiting for those before chunk until.
+ * Called by the main thread with the mutex locked. */
+static void dlt_grep_write(DltGrepQueue *queue, uint64_t until)
+{
+    DltGrepChunk *chunk;
+    size_t written;
+
+    while (queue->next_write < queue->next_fill) {
+        chunk = &queue->chunks[queue->next_write % (uint64_t)queue->num_chunks];
+
+        if (chunk->state != DLT_GREP_CHUNK_DONE) {
+            if (queue->next_write >= until)
+                return;
+
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+            continue;
+        }
+
+        pthread_mutex_unlock(&queue->mutex);
+
+        written = fwrite(chunk->output.data, 1, chunk->output.size, queue->options->output);
+
+        pthread_mutex_lock(&queue->mutex);
+
+        if (written != chunk->output.size)
+            queue->failed = true;
+
+        queue->matches += chunk->matches;
+        chunk->output.size = 0;
+        chunk->state = DLT_GREP_CHUNK_FREE;
+        queue->next_write++;
+    }
+}
+
+/* Hand the records from start to end to the workers */
+static void dlt_grep_queue(DltGrepQueue *queue, const uint8_t *start, const uint8_t *end, int first)
+{
+    DltGrepChunk *chunk;
+
+    pthread_mutex_lock(&queue->mutex);
+
+    /* all slots in flight: wait until the oldest chunk is written */
+    if (queue->next_fill - queue->next_write == (uint64_t)queue->num_chunks)
+        dlt_grep_write(queue, queue->next_write + 1);
+
+    chunk = &queue->chunks[queue->next_fill % (uint64_t)queue->num_chunks];
+    chunk->start = start;
+    chunk->end = end;
+    chunk->first = first;
+    chunk->state = DLT_GREP_CHUNK_QUEUED;
+    queue->next_fill++;
+    pthread_cond_broadcast(&queue->cond);
+
+    dlt_grep_write(queue, 0);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+static int dlt_grep_file(DltGrepOptions *options, DltGrepWorker *workers, DltGrepChunk *chunks,
+                         const char *filename, long *matches)
+{
+    DltGrepQueue queue;
+    void *map;
+    const uint8_t *data;
+    const uint8_t *end;
+    const uint8_t *start;
+    const uint8_t *ptr;
+    struct stat st;
+    size_t size;
+    int first = 0;
+    int num = 0;
+    int started;
+    int fd;
+    int ret = 0;
+
+    fd = open(filename, O_RDONLY);
+
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        fprintf(stderr, "ERROR: Cannot open %s: %s\n", filename, strerror(errno));
+
+        if (fd >= 0)
+            close(fd);
+
+        return -1;
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "ERROR: Cannot map %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    data = map;
+    end = data + st.st_size;
+
+    memset(&queue, 0, sizeof(queue));
+    queue.options = options;
+    queue.filename = filename;
+    queue.chunks = chunks;
+    queue.num_chunks = options->threads * DLT_GREP_CHUNKS_PER_THREAD;
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.cond, NULL);
+
+    for (started = 0; started < options->threads; started++) {
+        workers[started].queue = &queue;
+
+        if (pthread_create(&workers[started].thread, NULL, dlt_grep_worker, &workers[started]) != 0) {
+            fprintf(stderr, "ERROR: Cannot create worker thread\n");
+            queue.failed = true;
+            break;
+        }
+    }
+
+    /* only the record headers are read here, the workers match the records */
+    start = data;
+    ptr = data;
+
+    while ((ptr < end) && (started > 0)) {
+        size = dlt_grep_record_size(ptr, end);
+
+        if (size == 0) {
+            if (options->verbose)
+                fprintf(stderr, "%s: corrupted data at offset %ld\n", filename, (long)(ptr - data));
+
+            ptr = dlt_grep_resync(ptr, end);
+            continue;
+        }
+
+        ptr += size;
+        num++;
+
+        if (ptr - start >= DLT_GREP_CHUNK_SIZE) {
+            dlt_grep_queue(&queue, start, ptr, first);
+            start = ptr;
+            first = num;
+        }
+    }
+
+    if ((ptr > start) && (started > 0))
+        dlt_grep_queue(&queue, start, ptr, first);
+
+    pthread_mutex_lock(&queue.mutex);
+    queue.finished = true;
+    pthread_cond_broadcast(&queue.cond);
+    dlt_grep_write(&queue, queue.next_fill);
+    pthread_mutex_unlock(&queue.mutex);
+
+    while (started > 0)
+        pthread_join(workers[--started].thread, NULL);
+
+    if (queue.failed) {
+        fprintf(stderr, "ERROR: Cannot write the matching messages of %s\n", filename);
+        ret = -1;
+    }
+
+    if (options->verbose)
+        fprintf(stderr, "%s: %d messages, %ld matching\n", filename, num, queue.matches);
+
+    *matches += queue.matches;
+
+    pthread_cond_destroy(&queue.cond);
+    pthread_mutex_destroy(&queue.mutex);
+    munmap(map, (size_t)st.st_size);
+
+    return ret;
+}
+
+static int dlt_grep_filter_extension(const struct dirent *entry)
+{
+    size_t length = strlen(entry->d_name);
+
+    return (length > strlen(DLT_GREP_EXTENSION)) &&
+           (strcmp(entry->d_name + length - strlen(DLT_GREP_EXTENSION), DLT_GREP_EXTENSION) == 0);
+}
+
+static int dlt_grep_path(DltGrepOptions *options, DltGrepWorker *workers, DltGrepChunk *chunks,
+                         const char *path, long *matches)
+{
+    struct dirent **files = NULL;
+    char filename[FILENAME_MAX];
+    struct stat st;
+    int ret = 0;
+    int n;
+    int i;
+
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "ERROR: Cannot access %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if (!S_ISDIR(st.st_mode))
+        return dlt_grep_file(options, workers, chunks, path, matches);
+
+    n = scandir(path, &files, dlt_grep_filter_extension, alphasort);
+
+    if (n < 0) {
+        fprintf(stderr, "ERROR: Cannot scan %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        snprintf(filename, sizeof(filename), "%s/%s", path, files[i]->d_name);
+
+        if ((ret == 0) && (dlt_grep_file(options, workers, chunks, filename, matches) != 0))
+            ret = -1;
+
+        free(files[i]);
+    }
+
+    free(files);
+
+    return ret;
+}
+
+/**
+ * Main function of tool.
+ */
+int main(int argc, char *argv[])
+{
+    DltGrepOptions options;
+    DltGrepWorker *workers = NULL;
+    DltGrepChunk *chunks = NULL;
+    char *ovalue = NULL;
+    long matches = 0;
+    long cpus;
+    int64_t time;
+    int ret = 0;
+    int c;
+    int i;
+
+    memset(&options, 0, sizeof(options));
+    options.begin = -1;
+    options.end = -1;
+    options.output = stdout;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    options.threads = (cpus > 0) ? (int)((cpus > DLT_GREP_MAX_THREADS) ? DLT_GREP_MAX_THREADS : cpus) : 1;
+
+    opterr = 0;
+
+    while ((c = getopt(argc, argv, "hvcE:A:C:l:b:e:s:r:o:j:")) != -1) {
+        switch (c) {
+        case 'v':
+            options.verbose = 1;
+            break;
+        case 'c':
+            options.count = true;
+            break;
+        case 'E':
+            if (!dlt_grep_add_id(options.ecu, &options.num_ecu, optarg))
+                return -1;
+            break;
+        case 'A':
+            if (!dlt_grep_add_id(options.apid, &options.num_apid, optarg))
+                return -1;
+            break;
+        case 'C':
+            if (!dlt_grep_add_id(options.ctid, &options.num_ctid, optarg))
+                return -1;
+            break;
+        case 'l':
+            options.level = dlt_grep_parse_level(optarg);
+
+            if (options.level < 0) {
+                fprintf(stderr, "ERROR: Invalid log level %s\n", optarg);
+                return -1;
+            }
+            break;
+        case 'b':
+        case 'e':
+            time = dlt_grep_parse_time(optarg);
+
+            if (time < 0) {
+                fprintf(stderr, "ERROR: Invalid time %s\n", optarg);
+                return -1;
+            }
+
+            if (c == 'b')
+                options.begin = time;
+            else
+                options.end = time;
+            break;
+        case 's':
+            options.substring = optarg;
+            options.substring_length = strlen(optarg);
+            break;
+        case 'r':
+            options.regex = optarg;
+            break;
+        case 'o':
+            ovalue = optarg;
+            break;
+        case 'j':
+            options.threads = atoi(optarg);
+
+            if ((options.threads < 1) || (options.threads > DLT_GREP_MAX_THREADS)) {
+                fprintf(stderr, "ERROR: Number of threads must be 1 to %d\n", DLT_GREP_MAX_THREADS);
+                return -1;
+            }
+            break;
+        case 'h':
+            usage();
+            return -1;
+        case '?':
+            if (strchr("EAClbesroj", optopt) != NULL)
+                fprintf(stderr, "Option -%c requires an argument.\n", optopt);
+            else if (isprint(optopt))
+                fprintf(stderr, "Unknown option `-%c'.\n", optopt);
+            else
+                fprintf(stderr, "Unknown option character `\\x%x'.\n", optopt);
+
+            /* unknown or wrong option used, show usage information and terminate */
+            usage();
+            return -1;
+        default:
+            return -1;
+        }
+    }
+
+    if (optind >= argc) {
+        /* no file selected, show usage and terminate */
+        fprintf(stderr, "ERROR: No file selected\n");
+        usage();
+        return -1;
+    }
+
+    options.print_filename = (argc - optind > 1);
+
+    if (!options.print_filename) {
+        struct stat st;
+
+        options.print_filename = (stat(argv[optind], &st) == 0) && S_ISDIR(st.st_mode);
+    }
+
+    workers = calloc((size_t)options.threads, sizeof(DltGrepWorker));
+    chunks = calloc((size_t)(options.threads * DLT_GREP_CHUNKS_PER_THREAD), sizeof(DltGrepChunk));
+
+    if ((workers == NULL) || (chunks == NULL)) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        free(workers);
+        free(chunks);
+        return -1;
+    }
+
+    for (i = 0; i < options.threads; i++) {
+        dlt_message_init(&workers[i].msg, 0);
+
+        /* regexec() of glibc locks the pattern, every worker compiles its own */
+        if (options.regex != NULL) {
+            if (regcomp(&workers[i].regex, options.regex, REG_EXTENDED | REG_NOSUB) != 0) {
+                fprintf(stderr, "ERROR: Invalid regular expression %s\n", options.regex);
+                ret = -1;
+                break;
+            }
+
+            workers[i].regex_compiled = true;
+        }
+    }
+
+    if ((ret == 0) && (ovalue != NULL)) {
+        options.output = fopen(ovalue, "wb");
+        options.dlt_output = true;
+
+        if (options.output == NULL) {
+            fprintf(stderr, "ERROR: Output file %s cannot be opened!\n", ovalue);
+            ret = -1;
+        }
+    }
+
+    for (i = optind; (ret == 0) && (i < argc); i++)
+        if (dlt_grep_path(&options, workers, chunks, argv[i], &matches) != 0)
+            ret = -1;
+
+    if (options.count && (ret == 0))
+        printf("Number of matching messages: %ld\n", matches);
+
+    if ((ovalue != NULL) && (options.output != NULL) && (fclose(options.output) != 0)) {
+        fprintf(stderr, "ERROR: Output file %s cannot be written!\n", ovalue);
+        ret = -1;
+    }
+
+    for (i = 0; i < options.threads; i++) {
+        if (workers[i].regex_compiled)
+            regfree(&workers[i].regex);
+
+        dlt_message_free(&workers[i].msg, 0);
+    }
+
+    for (i = 0; i < options.threads * DLT_GREP_CHUNKS_PER_THREAD; i++)
+        free(chunks[i].output.data);
+
+    free(workers);
+    free(chunks);
+
+    /* like grep: 1 if nothing matched */
+    if (ret != 0)
+        return -1;
+
+    return (matches > 0) ? 0 : 1;
+}
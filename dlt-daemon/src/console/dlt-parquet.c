@@ -0,0 +1,1004 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt-parquet.c
+ * Export of DLT messages to an Apache Parquet file, one row per message.
+ *
+ * The file is written without an Arrow or Parquet library: all columns are
+ * required (no definition levels), every row group has one dictionary page
+ * per id column and one data page per column, and the metadata is encoded
+ * with the Thrift compact protocol as described in parquet.thrift.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef DLT_PARQUET_USE_GZIP
+#define ZLIB_CONST
+#include <zlib.h>
+#endif
+
+#include "dlt_common.h"
+#include "dlt_version.h"
+
+#include "dlt-parquet.h"
+
+#define DLT_PARQUET_MAGIC "PAR1"
+#define DLT_PARQUET_MAGIC_SIZE 4
+
+/* parquet.thrift: Type */
+#define DLT_PARQUET_TYPE_INT32 1
+#define DLT_PARQUET_TYPE_INT64 2
+#define DLT_PARQUET_TYPE_BYTE_ARRAY 6
+
+/* parquet.thrift: ConvertedType */
+#define DLT_PARQUET_CONVERTED_UTF8 0
+#define DLT_PARQUET_CONVERTED_TIMESTAMP_MICROS 10
+
+/* parquet.thrift: FieldRepetitionType */
+#define DLT_PARQUET_REQUIRED 0
+
+/* parquet.thrift: Encoding */
+#define DLT_PARQUET_ENCODING_PLAIN 0
+#define DLT_PARQUET_ENCODING_RLE 3
+#define DLT_PARQUET_ENCODING_RLE_DICTIONARY 8
+
+/* parquet.thrift: CompressionCodec */
+#define DLT_PARQUET_CODEC_UNCOMPRESSED 0
+#define DLT_PARQUET_CODEC_GZIP 2
+
+/* parquet.thrift: PageType */
+#define DLT_PARQUET_PAGE_DATA 0
+#define DLT_PARQUET_PAGE_DICTIONARY 2
+
+/* Thrift compact protocol field types */
+#define DLT_THRIFT_TRUE 1
+#define DLT_THRIFT_FALSE 2
+#define DLT_THRIFT_I32 5
+#define DLT_THRIFT_I64 6
+#define DLT_THRIFT_BINARY 8
+#define DLT_THRIFT_LIST 9
+#define DLT_THRIFT_STRUCT 12
+
+#define DLT_THRIFT_MAX_DEPTH 8
+
+#define DLT_PARQUET_HASH_INITIAL 64
+
+typedef enum
+{
+    DLT_PARQUET_TIME = 0,
+    DLT_PARQUET_TIMESTAMP,
+    DLT_PARQUET_COUNTER,
+    DLT_PARQUET_ECU,
+    DLT_PARQUET_APID,
+    DLT_PARQUET_CTID,
+    DLT_PARQUET_MSGTYPE,
+    DLT_PARQUET_MSGSUBTYPE,
+    DLT_PARQUET_PAYLOAD,
+    DLT_PARQUET_COLUMNS
+} DltParquetColumnId;
+
+typedef struct
+{
+    const char *name;
+    int32_t type;
+    bool dictionary;
+    bool statistics;
+} DltParquetSchema;
+
+static const DltParquetSchema dlt_parquet_schema[DLT_PARQUET_COLUMNS] = {
+    { "time", DLT_PARQUET_TYPE_INT64, false, true },
+    { "timestamp", DLT_PARQUET_TYPE_INT64, false, true },
+    { "counter", DLT_PARQUET_TYPE_INT32, false, true },
+    { "ecu", DLT_PARQUET_TYPE_BYTE_ARRAY, true, true },
+    { "apid", DLT_PARQUET_TYPE_BYTE_ARRAY, true, true },
+    { "ctid", DLT_PARQUET_TYPE_BYTE_ARRAY, true, true },
+    { "type", DLT_PARQUET_TYPE_BYTE_ARRAY, true, true },
+    { "subtype", DLT_PARQUET_TYPE_BYTE_ARRAY, true, true },
+    { "payload", DLT_PARQUET_TYPE_BYTE_ARRAY, false, false }
+};
+
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} DltParquetBuffer;
+
+typedef struct
+{
+    DltParquetBuffer *buffer;
+    int16_t last_id[DLT_THRIFT_MAX_DEPTH];
+    int depth;
+} DltThrift;
+
+typedef struct
+{
+    /* plain encoded values, the dictionary for dictionary columns */
+    DltParquetBuffer values;
+    /* dictionary columns: offset of each entry, index of each row */
+    uint32_t *entries;
+    uint32_t num_entries;
+    uint32_t *indices;
+    uint32_t *hash;
+    uint32_t hash_size;
+    /* integer columns */
+    int64_t min;
+    int64_t max;
+} DltParquetColumn;
+
+struct DltParquet
+{
+    FILE *file;
+    int verbose;
+    uint64_t offset;
+    uint32_t rows;
+    int64_t total_rows;
+    int32_t num_row_groups;
+    DltParquetColumn columns[DLT_PARQUET_COLUMNS];
+    /* serialized RowGroup structs of the footer */
+    DltParquetBuffer row_groups;
+    DltParquetBuffer page;
+    DltParquetBuffer header;
+#ifdef DLT_PARQUET_USE_GZIP
+    DltParquetBuffer compressed;
+#endif
+};
+
+static void dlt_parquet_buffer_reserve(DltParquetBuffer *buffer, size_t size)
+{
+    size_t capacity;
+    uint8_t *data;
+
+    if (buffer->failed || (buffer->size + size <= buffer->capacity))
+        return;
+
+    capacity = (buffer->capacity == 0) ? 256 : buffer->capacity;
+
+    while (capacity < buffer->size + size)
+        capacity *= 2;
+
+    data = realloc(buffer->data, capacity);
+
+    if (data == NULL) {
+        buffer->failed = true;
+        return;
+    }
+
+    buffer->data = data;
+    buffer->capacity = capacity;
+}
+
+static void dlt_parquet_buffer_append(DltParquetBuffer *buffer, const void *data, size_t size)
+{
+    dlt_parquet_buffer_reserve(buffer, size);
+
+    if (buffer->failed || (size == 0))
+        return;
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void dlt_parquet_buffer_byte(DltParquetBuffer *buffer, uint8_t value)
+{
+    dlt_parquet_buffer_append(buffer, &value, 1);
+}
+
+static void dlt_parquet_buffer_le(DltParquetBuffer *buffer, uint64_t value, int size)
+{
+    uint8_t bytes[8];
+    int i;
+
+    for (i = 0; i < size; i++)
+        bytes[i] = (uint8_t)(value >> (8 * i));
+
+    dlt_parquet_buffer_append(buffer, bytes, (size_t)size);
+}
+
+static void dlt_parquet_buffer_varint(DltParquetBuffer *buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        dlt_parquet_buffer_byte(buffer, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    dlt_parquet_buffer_byte(buffer, (uint8_t)value);
+}
+
+static void dlt_parquet_buffer_free(DltParquetBuffer *buffer)
+{
+    free(buffer->data);
+    memset(buffer, 0, sizeof(DltParquetBuffer));
+}
+
+static uint64_t dlt_thrift_zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static void dlt_thrift_init(DltThrift *thrift, DltParquetBuffer *buffer)
+{
+    memset(thrift, 0, sizeof(DltThrift));
+    thrift->buffer = buffer;
+}
+
+static void dlt_thrift_field(DltThrift *thrift, int16_t id, uint8_t type)
+{
+    int delta = id - thrift->last_id[thrift->depth];
+
+    if ((delta > 0) && (delta <= 15)) {
+        dlt_parquet_buffer_byte(thrift->buffer, (uint8_t)((delta << 4) | type));
+    }
+    else {
+        dlt_parquet_buffer_byte(thrift->buffer, type);
+        dlt_parquet_buffer_varint(thrift->buffer, dlt_thrift_zigzag(id));
+    }
+
+    thrift->last_id[thrift->depth] = id;
+}
+
+/* Start a struct, either a field announced with DLT_THRIFT_STRUCT or a list element */
+static void dlt_thrift_struct_begin(DltThrift *thrift)
+{
+    if (thrift->depth + 1 >= DLT_THRIFT_MAX_DEPTH) {
+        thrift->buffer->failed = true;
+        return;
+    }
+
+    thrift->depth++;
+    thrift->last_id[thrift->depth] = 0;
+}
+
+static void dlt_thrift_struct_end(DltThrift *thrift)
+{
+    dlt_parquet_buffer_byte(thrift->buffer, 0);
+
+    if (thrift->depth > 0)
+        thrift->depth--;
+}
+
+static void dlt_thrift_struct_field(DltThrift *thrift, int16_t id)
+{
+    dlt_thrift_field(thrift, id, DLT_THRIFT_STRUCT);
+    dlt_thrift_struct_begin(thrift);
+}
+
+static void dlt_thrift_bool(DltThrift *thrift, int16_t id, bool value)
+{
+    dlt_thrift_field(thrift, id, value ? DLT_THRIFT_TRUE : DLT_THRIFT_FALSE);
+}
+
+static void dlt_thrift_i32(DltThrift *thrift, int16_t id, int32_t value)
+{
+    dlt_thrift_field(thrift, id, DLT_THRIFT_I32);
+    dlt_parquet_buffer_varint(thrift->buffer, dlt_thrift_zigzag(value));
+}
+
+static void dlt_thrift_i64(DltThrift *thrift, int16_t id, int64_t value)
+{
+    dlt_thrift_field(thrift, id, DLT_THRIFT_I64);
+    dlt_parquet_buffer_varint(thrift->buffer, dlt_thrift_zigzag(value));
+}
+
+static void dlt_thrift_binary_value(DltThrift *thrift, const void *data, size_t size)
+{
+    dlt_parquet_buffer_varint(thrift->buffer, size);
+    dlt_parquet_buffer_append(thrift->buffer, data, size);
+}
+
+static void dlt_thrift_binary(DltThrift *thrift, int16_t id, const void *data, size_t size)
+{
+    dlt_thrift_field(thrift, id, DLT_THRIFT_BINARY);
+    dlt_thrift_binary_value(thrift, data, size);
+}
+
+static void dlt_thrift_string(DltThrift *thrift, int16_t id, const char *value)
+{
+    dlt_thrift_binary(thrift, id, value, strlen(value));
+}
+
+static void dlt_thrift_list(DltThrift *thrift, int16_t id, uint8_t type, int32_t size)
+{
+    dlt_thrift_field(thrift, id, DLT_THRIFT_LIST);
+
+    if (size < 15) {
+        dlt_parquet_buffer_byte(thrift->buffer, (uint8_t)((size << 4) | type));
+    }
+    else {
+        dlt_parquet_buffer_byte(thrift->buffer, (uint8_t)(0xF0 | type));
+        dlt_parquet_buffer_varint(thrift->buffer, (uint64_t)size);
+    }
+}
+
+static uint32_t dlt_parquet_hash(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* Entries of the dictionary are stored plain encoded: 4 byte length, bytes */
+static const uint8_t *dlt_parquet_entry(DltParquetColumn *column, uint32_t entry, uint32_t *size)
+{
+    const uint8_t *data = column->values.data + column->entries[entry];
+
+    *size = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+        ((uint32_t)data[3] << 24);
+
+    return data + 4;
+}
+
+static bool dlt_parquet_hash_grow(DltParquetColumn *column)
+{
+    uint32_t size = (column->hash_size == 0) ? DLT_PARQUET_HASH_INITIAL : column->hash_size * 2;
+    uint32_t *hash = calloc(size, sizeof(uint32_t));
+    const uint8_t *data;
+    uint32_t length;
+    uint32_t entry;
+    uint32_t slot;
+
+    if (hash == NULL)
+        return false;
+
+    for (entry = 0; entry < column->num_entries; entry++) {
+        data = dlt_parquet_entry(column, entry, &length);
+        slot = dlt_parquet_hash(data, length) & (size - 1);
+
+        while (hash[slot] != 0)
+            slot = (slot + 1) & (size - 1);
+
+        hash[slot] = entry + 1;
+    }
+
+    free(column->hash);
+    column->hash = hash;
+    column->hash_size = size;
+
+    return true;
+}
+
+/* Return the dictionary index of a value, add it if it is new */
+static DltReturnValue dlt_parquet_dictionary_add(DltParquetColumn *column,
+                                                 const char *value,
+                                                 uint32_t *index)
+{
+    size_t size = strlen(value);
+    const uint8_t *data;
+    uint32_t length;
+    uint32_t slot;
+    uint32_t *entries;
+
+    if (((column->num_entries + 1) * 2 > column->hash_size) && !dlt_parquet_hash_grow(column))
+        return DLT_RETURN_ERROR;
+
+    slot = dlt_parquet_hash((const uint8_t *)value, size) & (column->hash_size - 1);
+
+    while (column->hash[slot] != 0) {
+        data = dlt_parquet_entry(column, column->hash[slot] - 1, &length);
+
+        if ((length == size) && (memcmp(data, value, size) == 0)) {
+            *index = column->hash[slot] - 1;
+            return DLT_RETURN_OK;
+        }
+
+        slot = (slot + 1) & (column->hash_size - 1);
+    }
+
+    entries = realloc(column->entries, (column->num_entries + 1) * sizeof(uint32_t));
+
+    if (entries == NULL)
+        return DLT_RETURN_ERROR;
+
+    column->entries = entries;
+    column->entries[column->num_entries] = (uint32_t)column->values.size;
+    dlt_parquet_buffer_le(&column->values, size, 4);
+    dlt_parquet_buffer_append(&column->values, value, size);
+
+    if (column->values.failed)
+        return DLT_RETURN_ERROR;
+
+    column->hash[slot] = column->num_entries + 1;
+    *index = column->num_entries++;
+
+    return DLT_RETURN_OK;
+}
+
+static DltReturnValue dlt_parquet_add_string(DltParquet *parquet, DltParquetColumnId id, const char *value)
+{
+    DltParquetColumn *column = &parquet->columns[id];
+
+    if (dlt_parquet_schema[id].dictionary)
+        return dlt_parquet_dictionary_add(column, value, &column->indices[parquet->rows]);
+
+    dlt_parquet_buffer_le(&column->values, strlen(value), 4);
+    dlt_parquet_buffer_append(&column->values, value, strlen(value));
+
+    return column->values.failed ? DLT_RETURN_ERROR : DLT_RETURN_OK;
+}
+
+static DltReturnValue dlt_parquet_add_int(DltParquet *parquet, DltParquetColumnId id, int64_t value)
+{
+    DltParquetColumn *column = &parquet->columns[id];
+
+    if ((parquet->rows == 0) || (value < column->min))
+        column->min = value;
+
+    if ((parquet->rows == 0) || (value > column->max))
+        column->max = value;
+
+    dlt_parquet_buffer_le(&column->values, (uint64_t)value,
+                          (dlt_parquet_schema[id].type == DLT_PARQUET_TYPE_INT32) ? 4 : 8);
+
+    return column->values.failed ? DLT_RETURN_ERROR : DLT_RETURN_OK;
+}
+
+/* Write a page header and the page, add their sizes to the column chunk totals */
+static DltReturnValue dlt_parquet_write_page(DltParquet *parquet,
+                                             int32_t type,
+                                             int32_t num_values,
+                                             int32_t encoding,
+                                             int64_t *uncompressed,
+                                             int64_t *compressed)
+{
+    const DltParquetBuffer *body = &parquet->page;
+    DltThrift thrift;
+
+#ifdef DLT_PARQUET_USE_GZIP
+    z_stream zstream;
+    int ret;
+
+    memset(&zstream, 0, sizeof(zstream));
+
+    /* windowBits 15 + 16: gzip framing, as required for the GZIP codec */
+    if (deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+        return DLT_RETURN_ERROR;
+
+    parquet->compressed.size = 0;
+    dlt_parquet_buffer_reserve(&parquet->compressed, deflateBound(&zstream, (uLong)body->size));
+
+    if (parquet->compressed.failed) {
+        deflateEnd(&zstream);
+        return DLT_RETURN_ERROR;
+    }
+
+    zstream.next_in = body->data;
+    zstream.avail_in = (uInt)body->size;
+    zstream.next_out = parquet->compressed.data;
+    zstream.avail_out = (uInt)parquet->compressed.capacity;
+    ret = deflate(&zstream, Z_FINISH);
+    parquet->compressed.size = zstream.total_out;
+    deflateEnd(&zstream);
+
+    if (ret != Z_STREAM_END)
+        return DLT_RETURN_ERROR;
+
+    body = &parquet->compressed;
+#endif
+
+    parquet->header.size = 0;
+    dlt_thrift_init(&thrift, &parquet->header);
+    dlt_thrift_i32(&thrift, 1, type);
+    dlt_thrift_i32(&thrift, 2, (int32_t)parquet->page.size);
+    dlt_thrift_i32(&thrift, 3, (int32_t)body->size);
+
+    if (type == DLT_PARQUET_PAGE_DATA) {
+        dlt_thrift_struct_field(&thrift, 5);
+        dlt_thrift_i32(&thrift, 1, num_values);
+        dlt_thrift_i32(&thrift, 2, encoding);
+        dlt_thrift_i32(&thrift, 3, DLT_PARQUET_ENCODING_RLE);
+        dlt_thrift_i32(&thrift, 4, DLT_PARQUET_ENCODING_RLE);
+        dlt_thrift_struct_end(&thrift);
+    }
+    else {
+        dlt_thrift_struct_field(&thrift, 7);
+        dlt_thrift_i32(&thrift, 1, num_values);
+        dlt_thrift_i32(&thrift, 2, encoding);
+        dlt_thrift_struct_end(&thrift);
+    }
+
+    dlt_thrift_struct_end(&thrift);
+
+    if (parquet->header.failed || parquet->page.failed)
+        return DLT_RETURN_ERROR;
+
+    if ((fwrite(parquet->header.data, 1, parquet->header.size, parquet->file) != parquet->header.size) ||
+        (fwrite(body->data, 1, body->size, parquet->file) != body->size))
+        return DLT_RETURN_ERROR;
+
+    parquet->offset += parquet->header.size + body->size;
+    *uncompressed += (int64_t)(parquet->header.size + parquet->page.size);
+    *compressed += (int64_t)(parquet->header.size + body->size);
+
+    return DLT_RETURN_OK;
+}
+
+/* RLE/bit-packed hybrid encoding of the indices as a single bit-packed run */
+static void dlt_parquet_encode_indices(DltParquet *parquet, DltParquetColumn *column)
+{
+    DltParquetBuffer *page = &parquet->page;
+    uint32_t groups = (parquet->rows + 7) / 8;
+    uint8_t bit_width = 1;
+    uint64_t bits = 0;
+    int num_bits = 0;
+    uint32_t i;
+
+    while ((column->num_entries - 1) >> bit_width)
+        bit_width++;
+
+    dlt_parquet_buffer_byte(page, bit_width);
+    dlt_parquet_buffer_varint(page, ((uint64_t)groups << 1) | 1);
+
+    for (i = 0; i < groups * 8; i++) {
+        bits |= (uint64_t)((i < parquet->rows) ? column->indices[i] : 0) << num_bits;
+        num_bits += bit_width;
+
+        while (num_bits >= 8) {
+            dlt_parquet_buffer_byte(page, (uint8_t)bits);
+            bits >>= 8;
+            num_bits -= 8;
+        }
+    }
+}
+
+/* Unsigned lexicographic order, as defined for UTF8 strings */
+static int dlt_parquet_compare(const uint8_t *a, uint32_t a_size, const uint8_t *b, uint32_t b_size)
+{
+    int ret = memcmp(a, b, (a_size < b_size) ? a_size : b_size);
+
+    if (ret != 0)
+        return ret;
+
+    return (a_size > b_size) - (a_size < b_size);
+}
+
+static void dlt_parquet_write_statistics(DltThrift *thrift, DltParquetColumnId id, DltParquetColumn *column)
+{
+    DltParquetBuffer value = { NULL, 0, 0, false };
+    const uint8_t *min = NULL;
+    const uint8_t *max = NULL;
+    const uint8_t *data;
+    uint32_t min_size = 0;
+    uint32_t max_size = 0;
+    uint32_t size;
+    uint32_t entry;
+    int size_int;
+
+    dlt_thrift_struct_field(thrift, 12);
+    dlt_thrift_i64(thrift, 3, 0);
+
+    if (dlt_parquet_schema[id].dictionary) {
+        for (entry = 0; entry < column->num_entries; entry++) {
+            data = dlt_parquet_entry(column, entry, &size);
+
+            if ((min == NULL) || (dlt_parquet_compare(data, size, min, min_size) < 0)) {
+                min = data;
+                min_size = size;
+            }
+
+            if ((max == NULL) || (dlt_parquet_compare(data, size, max, max_size) > 0)) {
+                max = data;
+                max_size = size;
+            }
+        }
+
+        dlt_thrift_binary(thrift, 5, max, max_size);
+        dlt_thrift_binary(thrift, 6, min, min_size);
+    }
+    else {
+        size_int = (dlt_parquet_schema[id].type == DLT_PARQUET_TYPE_INT32) ? 4 : 8;
+        dlt_parquet_buffer_le(&value, (uint64_t)column->max, size_int);
+        dlt_parquet_buffer_le(&value, (uint64_t)column->min, size_int);
+
+        if (value.failed)
+            thrift->buffer->failed = true;
+        else {
+            dlt_thrift_binary(thrift, 5, value.data, (size_t)size_int);
+            dlt_thrift_binary(thrift, 6, value.data + size_int, (size_t)size_int);
+        }
+
+        dlt_parquet_buffer_free(&value);
+    }
+
+    dlt_thrift_struct_end(thrift);
+}
+
+/* Write the pages of all columns and add the RowGroup to the footer */
+static DltReturnValue dlt_parquet_flush(DltParquet *parquet)
+{
+    DltParquetColumn *column;
+    DltThrift thrift;
+    int64_t uncompressed;
+    int64_t compressed;
+    int64_t dictionary_offset;
+    int64_t data_offset;
+    int64_t total_size = 0;
+    int id;
+
+    if (parquet->rows == 0)
+        return DLT_RETURN_OK;
+
+    dlt_thrift_init(&thrift, &parquet->row_groups);
+    dlt_thrift_struct_begin(&thrift);
+    dlt_thrift_list(&thrift, 1, DLT_THRIFT_STRUCT, DLT_PARQUET_COLUMNS);
+
+    for (id = 0; id < DLT_PARQUET_COLUMNS; id++) {
+        column = &parquet->columns[id];
+        uncompressed = 0;
+        compressed = 0;
+        dictionary_offset = (int64_t)parquet->offset;
+
+        if (dlt_parquet_schema[id].dictionary) {
+            parquet->page.size = 0;
+            dlt_parquet_buffer_append(&parquet->page, column->values.data, column->values.size);
+
+            if (dlt_parquet_write_page(parquet, DLT_PARQUET_PAGE_DICTIONARY, (int32_t)column->num_entries,
+                                       DLT_PARQUET_ENCODING_PLAIN, &uncompressed, &compressed) < DLT_RETURN_OK)
+                return DLT_RETURN_ERROR;
+
+            data_offset = (int64_t)parquet->offset;
+            parquet->page.size = 0;
+            dlt_parquet_encode_indices(parquet, column);
+
+            if (dlt_parquet_write_page(parquet, DLT_PARQUET_PAGE_DATA, (int32_t)parquet->rows,
+                                       DLT_PARQUET_ENCODING_RLE_DICTIONARY, &uncompressed,
+                                       &compressed) < DLT_RETURN_OK)
+                return DLT_RETURN_ERROR;
+        }
+        else {
+            data_offset = (int64_t)parquet->offset;
+            parquet->page.size = 0;
+            dlt_parquet_buffer_append(&parquet->page, column->values.data, column->values.size);
+
+            if (dlt_parquet_write_page(parquet, DLT_PARQUET_PAGE_DATA, (int32_t)parquet->rows,
+                                       DLT_PARQUET_ENCODING_PLAIN, &uncompressed, &compressed) < DLT_RETURN_OK)
+                return DLT_RETURN_ERROR;
+        }
+
+        /* ColumnChunk */
+        dlt_thrift_struct_begin(&thrift);
+        dlt_thrift_i64(&thrift, 2, dictionary_offset);
+        dlt_thrift_struct_field(&thrift, 3);
+        dlt_thrift_i32(&thrift, 1, dlt_parquet_schema[id].type);
+
+        if (dlt_parquet_schema[id].dictionary) {
+            dlt_thrift_list(&thrift, 2, DLT_THRIFT_I32, 3);
+            dlt_parquet_buffer_varint(&parquet->row_groups, dlt_thrift_zigzag(DLT_PARQUET_ENCODING_PLAIN));
+            dlt_parquet_buffer_varint(&parquet->row_groups, dlt_thrift_zigzag(DLT_PARQUET_ENCODING_RLE));
+            dlt_parquet_buffer_varint(&parquet->row_groups,
+                                      dlt_thrift_zigzag(DLT_PARQUET_ENCODING_RLE_DICTIONARY));
+        }
+        else {
+            dlt_thrift_list(&thrift, 2, DLT_THRIFT_I32, 2);
+            dlt_parquet_buffer_varint(&parquet->row_groups, dlt_thrift_zigzag(DLT_PARQUET_ENCODING_PLAIN));
+            dlt_parquet_buffer_varint(&parquet->row_groups, dlt_thrift_zigzag(DLT_PARQUET_ENCODING_RLE));
+        }
+
+        dlt_thrift_list(&thrift, 3, DLT_THRIFT_BINARY, 1);
+        dlt_thrift_binary_value(&thrift, dlt_parquet_schema[id].name, strlen(dlt_parquet_schema[id].name));
+#ifdef DLT_PARQUET_USE_GZIP
+        dlt_thrift_i32(&thrift, 4, DLT_PARQUET_CODEC_GZIP);
+#else
+        dlt_thrift_i32(&thrift, 4, DLT_PARQUET_CODEC_UNCOMPRESSED);
+#endif
+        dlt_thrift_i64(&thrift, 5, parquet->rows);
+        dlt_thrift_i64(&thrift, 6, uncompressed);
+        dlt_thrift_i64(&thrift, 7, compressed);
+        dlt_thrift_i64(&thrift, 9, data_offset);
+
+        if (dlt_parquet_schema[id].dictionary)
+            dlt_thrift_i64(&thrift, 11, dictionary_offset);
+
+        if (dlt_parquet_schema[id].statistics)
+            dlt_parquet_write_statistics(&thrift, (DltParquetColumnId)id, column);
+
+        dlt_thrift_struct_end(&thrift);
+        dlt_thrift_struct_end(&thrift);
+
+        total_size += uncompressed;
+
+        /* the dictionary starts over with every row group */
+        column->values.size = 0;
+        column->num_entries = 0;
+
+        if (column->hash != NULL)
+            memset(column->hash, 0, column->hash_size * sizeof(uint32_t));
+    }
+
+    dlt_thrift_i64(&thrift, 2, total_size);
+    dlt_thrift_i64(&thrift, 3, parquet->rows);
+    dlt_thrift_struct_end(&thrift);
+
+    if (parquet->row_groups.failed)
+        return DLT_RETURN_ERROR;
+
+    if (parquet->verbose)
+        printf("Parquet row group %d: %u rows\n", parquet->num_row_groups, parquet->rows);
+
+    parquet->total_rows += parquet->rows;
+    parquet->num_row_groups++;
+    parquet->rows = 0;
+
+    return DLT_RETURN_OK;
+}
+
+static DltReturnValue dlt_parquet_write_footer(DltParquet *parquet)
+{
+    DltParquetBuffer footer = { NULL, 0, 0, false };
+    DltThrift thrift;
+    DltReturnValue ret = DLT_RETURN_OK;
+    int id;
+
+    dlt_thrift_init(&thrift, &footer);
+    dlt_thrift_struct_begin(&thrift);
+    dlt_thrift_i32(&thrift, 1, 1);
+
+    /* schema: the root, then one leaf per column */
+    dlt_thrift_list(&thrift, 2, DLT_THRIFT_STRUCT, DLT_PARQUET_COLUMNS + 1);
+    dlt_thrift_struct_begin(&thrift);
+    dlt_thrift_string(&thrift, 4, "schema");
+    dlt_thrift_i32(&thrift, 5, DLT_PARQUET_COLUMNS);
+    dlt_thrift_struct_end(&thrift);
+
+    for (id = 0; id < DLT_PARQUET_COLUMNS; id++) {
+        dlt_thrift_struct_begin(&thrift);
+        dlt_thrift_i32(&thrift, 1, dlt_parquet_schema[id].type);
+        dlt_thrift_i32(&thrift, 3, DLT_PARQUET_REQUIRED);
+        dlt_thrift_string(&thrift, 4, dlt_parquet_schema[id].name);
+
+        if (id == DLT_PARQUET_TIME) {
+            dlt_thrift_i32(&thrift, 6, DLT_PARQUET_CONVERTED_TIMESTAMP_MICROS);
+            /* LogicalType TIMESTAMP { isAdjustedToUTC, unit MICROS } */
+            dlt_thrift_struct_field(&thrift, 10);
+            dlt_thrift_struct_field(&thrift, 8);
+            dlt_thrift_bool(&thrift, 1, true);
+            dlt_thrift_struct_field(&thrift, 2);
+            dlt_thrift_struct_field(&thrift, 2);
+            dlt_thrift_struct_end(&thrift);
+            dlt_thrift_struct_end(&thrift);
+            dlt_thrift_struct_end(&thrift);
+            dlt_thrift_struct_end(&thrift);
+        }
+        else if (dlt_parquet_schema[id].type == DLT_PARQUET_TYPE_BYTE_ARRAY) {
+            dlt_thrift_i32(&thrift, 6, DLT_PARQUET_CONVERTED_UTF8);
+            /* LogicalType STRING */
+            dlt_thrift_struct_field(&thrift, 10);
+            dlt_thrift_struct_field(&thrift, 1);
+            dlt_thrift_struct_end(&thrift);
+            dlt_thrift_struct_end(&thrift);
+        }
+
+        dlt_thrift_struct_end(&thrift);
+    }
+
+    dlt_thrift_i64(&thrift, 3, parquet->total_rows);
+    dlt_thrift_list(&thrift, 4, DLT_THRIFT_STRUCT, parquet->num_row_groups);
+    dlt_parquet_buffer_append(&footer, parquet->row_groups.data, parquet->row_groups.size);
+    dlt_thrift_string(&thrift, 6, "dlt-convert version " _DLT_PACKAGE_VERSION);
+
+    /* ColumnOrder TYPE_ORDER: min/max statistics use the order of the type */
+    dlt_thrift_list(&thrift, 7, DLT_THRIFT_STRUCT, DLT_PARQUET_COLUMNS);
+
+    for (id = 0; id < DLT_PARQUET_COLUMNS; id++) {
+        dlt_thrift_struct_begin(&thrift);
+        dlt_thrift_struct_field(&thrift, 1);
+        dlt_thrift_struct_end(&thrift);
+        dlt_thrift_struct_end(&thrift);
+    }
+
+    dlt_thrift_struct_end(&thrift);
+
+    dlt_parquet_buffer_le(&footer, footer.size, 4);
+    dlt_parquet_buffer_append(&footer, DLT_PARQUET_MAGIC, DLT_PARQUET_MAGIC_SIZE);
+
+    if (footer.failed || parquet->row_groups.failed ||
+        (fwrite(footer.data, 1, footer.size, parquet->file) != footer.size))
+        ret = DLT_RETURN_ERROR;
+
+    dlt_parquet_buffer_free(&footer);
+
+    return ret;
+}
+
+static void dlt_parquet_free(DltParquet *parquet)
+{
+    int id;
+
+    for (id = 0; id < DLT_PARQUET_COLUMNS; id++) {
+        dlt_parquet_buffer_free(&parquet->columns[id].values);
+        free(parquet->columns[id].entries);
+        free(parquet->columns[id].indices);
+        free(parquet->columns[id].hash);
+    }
+
+    dlt_parquet_buffer_free(&parquet->row_groups);
+    dlt_parquet_buffer_free(&parquet->page);
+    dlt_parquet_buffer_free(&parquet->header);
+#ifdef DLT_PARQUET_USE_GZIP
+    dlt_parquet_buffer_free(&parquet->compressed);
+#endif
+    free(parquet);
+}
+
+DltParquet *dlt_parquet_open(const char *filename, int verbose)
+{
+    DltParquet *parquet;
+    int id;
+
+    if (filename == NULL)
+        return NULL;
+
+    parquet = calloc(1, sizeof(DltParquet));
+
+    if (parquet == NULL)
+        return NULL;
+
+    parquet->verbose = verbose;
+
+    for (id = 0; id < DLT_PARQUET_COLUMNS; id++) {
+        if (!dlt_parquet_schema[id].dictionary)
+            continue;
+
+        parquet->columns[id].indices = malloc(DLT_PARQUET_ROW_GROUP_SIZE * sizeof(uint32_t));
+
+        if (parquet->columns[id].indices == NULL) {
+            dlt_parquet_free(parquet);
+            return NULL;
+        }
+    }
+
+    parquet->file = fopen(filename, "wb");
+
+    if (parquet->file == NULL) {
+        fprintf(stderr, "ERROR: Parquet file %s cannot be opened!\n", filename);
+        dlt_parquet_free(parquet);
+        return NULL;
+    }
+
+    if (fwrite(DLT_PARQUET_MAGIC, 1, DLT_PARQUET_MAGIC_SIZE, parquet->file) != DLT_PARQUET_MAGIC_SIZE) {
+        fprintf(stderr, "ERROR: Parquet file %s cannot be written!\n", filename);
+        fclose(parquet->file);
+        dlt_parquet_free(parquet);
+        return NULL;
+    }
+
+    parquet->offset = DLT_PARQUET_MAGIC_SIZE;
+
+    return parquet;
+}
+
+/* Id of up to four characters, without the padding of dlt_print_id() */
+static void dlt_parquet_id(char *text, const char *id)
+{
+    memcpy(text, id, DLT_ID_SIZE);
+    text[DLT_ID_SIZE] = 0;
+}
+
+/* Message type or subtype as printed in the header, without the separator */
+static void dlt_parquet_header_flag(DltMessage *msg, char *text, size_t textlength, int flag)
+{
+    size_t length;
+
+    text[0] = 0;
+    dlt_message_header_flags(msg, text, textlength, flag, 0);
+    length = strlen(text);
+
+    if ((length > 0) && (text[length - 1] == ' '))
+        text[length - 1] = 0;
+}
+
+DltReturnValue dlt_parquet_write_message(DltParquet *parquet, DltMessage *msg, const char *payload)
+{
+    char text[DLT_ID_SIZE + 1];
+    char flag[DLT_CONVERT_TEXTBUFSIZE];
+    DltReturnValue ret = DLT_RETURN_OK;
+    uint8_t htyp;
+
+    if ((parquet == NULL) || (msg == NULL) || (msg->storageheader == NULL) ||
+        (msg->standardheader == NULL) || (payload == NULL))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    htyp = msg->standardheader->htyp;
+
+    if (dlt_parquet_add_int(parquet, DLT_PARQUET_TIME,
+                            (int64_t)msg->storageheader->seconds * 1000000 +
+                            msg->storageheader->microseconds) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    if (dlt_parquet_add_int(parquet, DLT_PARQUET_TIMESTAMP,
+                            DLT_IS_HTYP_WTMS(htyp) ? msg->headerextra.tmsp : 0) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    if (dlt_parquet_add_int(parquet, DLT_PARQUET_COUNTER, msg->standardheader->mcnt) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    dlt_parquet_id(text, DLT_IS_HTYP_WEID(htyp) ? msg->headerextra.ecu : msg->storageheader->ecu);
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_ECU, text) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    if (DLT_IS_HTYP_UEH(htyp) && (msg->extendedheader != NULL))
+        dlt_parquet_id(text, msg->extendedheader->apid);
+    else
+        text[0] = 0;
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_APID, text) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    if (DLT_IS_HTYP_UEH(htyp) && (msg->extendedheader != NULL))
+        dlt_parquet_id(text, msg->extendedheader->ctid);
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_CTID, text) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    dlt_parquet_header_flag(msg, flag, sizeof(flag), DLT_HEADER_SHOW_MSGTYPE);
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_MSGTYPE, flag) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    dlt_parquet_header_flag(msg, flag, sizeof(flag), DLT_HEADER_SHOW_MSGSUBTYPE);
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_MSGSUBTYPE, flag) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    if (dlt_parquet_add_string(parquet, DLT_PARQUET_PAYLOAD, payload) < DLT_RETURN_OK)
+        ret = DLT_RETURN_ERROR;
+
+    /* a failed column leaves the row group inconsistent, the file is lost */
+    if (ret < DLT_RETURN_OK) {
+        fprintf(stderr, "ERROR: Out of memory while writing Parquet rows\n");
+        return ret;
+    }
+
+    parquet->rows++;
+
+    if (parquet->rows == DLT_PARQUET_ROW_GROUP_SIZE)
+        return dlt_parquet_flush(parquet);
+
+    return DLT_RETURN_OK;
+}
+
+DltReturnValue dlt_parquet_close(DltParquet *parquet)
+{
+    DltReturnValue ret;
+
+    if (parquet == NULL)
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    ret = dlt_parquet_flush(parquet);
+
+    if (ret == DLT_RETURN_OK)
+        ret = dlt_parquet_write_footer(parquet);
+
+    if (fclose(parquet->file) != 0)
+        ret = DLT_RETURN_ERROR;
+
+    if (ret < DLT_RETURN_OK)
+        fprintf(stderr, "ERROR: Parquet file cannot be written!\n");
+
+    dlt_parquet_free(parquet);
+
+    return ret;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt-parquet.h
+ * Export of DLT messages to an Apache Parquet file, one row per message.
+ *
+ * Columns: time (storage header time, UTC microseconds), timestamp (message
+ * timestamp in 0.1 ms), counter, ecu, apid, ctid, type, subtype and payload
+ * (the arguments as printed by dlt_message_payload()). The id and type
+ * columns are dictionary encoded. Every row group carries min/max statistics,
+ * so that readers can skip row groups by time, id or level.
+ */
+
+#ifndef _DLT_PARQUET_H_
+#define _DLT_PARQUET_H_
+
+#include <stdio.h>
+
+#include "dlt_common.h"
+
+/* Rows written per row group, the granularity of statistics */
+#define DLT_PARQUET_ROW_GROUP_SIZE 32768
+
+typedef struct DltParquet DltParquet;
+
+/**
+ * Create a Parquet file.
+ * @param filename name of the file, an existing file is replaced
+ * @param verbose if set to true verbose information is printed out.
+ * @return the writer, NULL on error
+ */
+DltParquet *dlt_parquet_open(const char *filename, int verbose);
+
+/**
+ * Add a message as row.
+ * @param parquet the writer
+ * @param msg the message
+ * @param payload the payload as text
+ * @return negative value if there was an error
+ */
+DltReturnValue dlt_parquet_write_message(DltParquet *parquet, DltMessage *msg, const char *payload);
+
+/**
+ * Write the remaining rows and the file footer, close the file and free the
+ * writer.
+ * @param parquet the writer
+ * @return negative value if there was an error, the file is incomplete then
+ */
+DltReturnValue dlt_parquet_close(DltParquet *parquet);
+
+#endif /* _DLT_PARQUET_H_ */
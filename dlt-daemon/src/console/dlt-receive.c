@@ -86,6 +86,7 @@
 #include "dlt_log.h"
 #include "dlt_client.h"
 #include "dlt-control-common.h"
+#include "dlt-catalog.h"
 
 #define DLT_RECEIVE_ECU_ID "RECV"
 
@@ -122,10 +123,12 @@ typedef struct {
     int yflag;
     int uflag;
     int rflag;
+    int zflag;
     char *ovalue;
     char *ovaluebase; /* ovalue without ".dlt" */
     char *fvalue;       /* filename for space separated filter file (<AppID> <ContextID>) */
     char *jvalue;       /* filename for json filter file */
+    char *nvalue;       /* filename for non-verbose message catalog */
     char *evalue;
     int bvalue;
     int rvalue;
@@ -138,6 +141,7 @@ typedef struct {
     int part_num;    /* number of current output file if limit was exceeded */
     DltFile file;
     DltFilter filter;
+    DltCatalog catalog;
     int port;
     char *ifaddr;
 } DltReceiveData;
@@ -176,8 +180,11 @@ void usage(void)
     printf("                suffix to specify kilo-, mega-, giga-bytes respectively\n");
     printf("  -f filename   Enable filtering of messages with space separated list (<AppID> <ContextID>)\n");
     printf("  -j filename   Enable filtering of messages with filter defined in json file\n");
+    printf("                Filters are also sent to the daemon to only receive matching messages\n");
+    printf("  -n filename   Print non-verbose messages using the catalog file\n");
     printf("  -p port       Use the given port instead the default port\n");
     printf("                Cannot be used with serial devices\n");
+    printf("  -z            Request a compressed stream from the daemon (TCP only)\n");
 }
 
 
@@ -349,7 +356,7 @@ int main(int argc, char *argv[])
     /* Fetch command line arguments */
     opterr = 0;
 
-    while ((c = getopt(argc, argv, "vashSRyuxmf:j:o:e:b:c:p:i:r:")) != -1)
+    while ((c = getopt(argc, argv, "vashSRyuxmzf:j:n:o:e:b:c:p:i:r:")) != -1)
         switch (c) {
         case 'v':
         {
@@ -376,6 +383,11 @@ int main(int argc, char *argv[])
             dltdata.mflag = 1;
             break;
         }
+        case 'z':
+        {
+            dltdata.zflag = 1;
+            break;
+        }
         case 'h':
         {
             usage();
@@ -422,6 +434,11 @@ int main(int argc, char *argv[])
             return -1;
             #endif
         }
+        case 'n':
+        {
+            dltdata.nvalue = optarg;
+            break;
+        }
         case 'r': {
             dltdata.rflag = 1;
             dltdata.rvalue = atoi(optarg);
@@ -477,7 +494,7 @@ int main(int argc, char *argv[])
         }
         case '?':
         {
-            if ((optopt == 'o') || (optopt == 'f') || (optopt == 'c'))
+            if ((optopt == 'o') || (optopt == 'f') || (optopt == 'c') || (optopt == 'n'))
                 fprintf (stderr, "Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
                 fprintf (stderr, "Unknown option `-%c'.\n", optopt);
@@ -601,6 +618,13 @@ int main(int argc, char *argv[])
 
     #endif
 
+    if (dltdata.nvalue) {
+        if (dlt_catalog_load(&(dltdata.catalog), dltdata.nvalue, dltdata.vflag) < DLT_RETURN_OK) {
+            dlt_file_free(&(dltdata.file), dltdata.vflag);
+            return -1;
+        }
+    }
+
     /* open DLT output file */
     if (dltdata.ovalue) {
         if (dltdata.climit > -1) {
@@ -627,6 +651,16 @@ int main(int argc, char *argv[])
     while (true) {
         /* Attempt to connect to TCP socket or open serial device */
         if (dlt_client_connect(&dltclient, dltdata.vflag) != DLT_RETURN_ERROR) {
+            /* Let the daemon drop the messages the filter rejects anyway.
+             * They are still filtered here, as older daemons send all. */
+            if ((dltdata.fvalue || dltdata.jvalue) &&
+                (dltclient.mode != DLT_CLIENT_MODE_UDP_MULTICAST) &&
+                (dlt_client_send_filter(&dltclient, &(dltdata.filter)) != DLT_RETURN_OK))
+                dlt_log(LOG_WARNING, "Filter cannot be sent to the daemon\n");
+
+            if (dltdata.zflag && (dltclient.mode == DLT_CLIENT_MODE_TCP) &&
+                (dlt_client_set_compression(&dltclient, DLT_COMPRESSION_DEFLATE) != DLT_RETURN_OK))
+                dlt_log(LOG_WARNING, "Compression not available, receiving uncompressed\n");
 
             /* Dlt Client Main Loop */
             dlt_client_main_loop(&dltclient, &dltdata, dltdata.vflag);
@@ -654,6 +688,8 @@ int main(int argc, char *argv[])
 
     dlt_filter_free(&(dltdata.filter), dltdata.vflag);
 
+    dlt_catalog_free(&(dltdata.catalog));
+
     return 0;
 }
 
@@ -689,7 +725,10 @@ int dlt_receive_message_callback(DltMessage *message, void *data)
 
             printf("%s ", text);
 
-            dlt_message_payload(message, text, DLT_RECEIVE_BUFSIZE, DLT_OUTPUT_ASCII, dltdata->vflag);
+            if ((dltdata->nvalue == NULL) ||
+                (dlt_catalog_message_payload(&(dltdata->catalog), message, text, DLT_RECEIVE_BUFSIZE,
+                                             dltdata->vflag) != DLT_RETURN_TRUE))
+                dlt_message_payload(message, text, DLT_RECEIVE_BUFSIZE, DLT_OUTPUT_ASCII, dltdata->vflag);
 
             printf("[%s]\n", text);
         }
@@ -312,6 +312,8 @@ int main(int argc, char *argv[]) {
     dlt_file_init(&file, vflag);
 
     /* first parse filter file if filter parameter is used */
+    dlt_filter_init(&filter, vflag);
+
     if (fvalue) {
         if (bvalue || evalue) {
             fprintf(stderr, "ERROR: can't specify a range *and* filtering!\n");
@@ -472,6 +474,7 @@ int main(int argc, char *argv[]) {
     verbose(1, "Tidying up.\n");
     free(timestamp_index);
     timestamp_index = NULL;
+    dlt_filter_free(&filter, vflag);
     dlt_file_free(&file, vflag);
     return 0;
 }
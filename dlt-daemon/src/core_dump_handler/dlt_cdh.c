@@ -69,6 +69,8 @@ void init_proc_info(proc_info_t *p_proc)
     p_proc->signal = 0;
 
     p_proc->can_create_coredump = 1;
+    p_proc->core_limit = 0;
+    p_proc->minidump_threshold = 0;
     memset(&p_proc->streamer, 0, sizeof(p_proc->streamer));
 
     memset(&p_proc->m_Ehdr, 0, sizeof(p_proc->m_Ehdr));
@@ -128,6 +130,54 @@ cdh_status_t read_args(int argc, char **argv, proc_info_t *proc)
     return CDH_OK;
 }
 
+/* ===================================================================
+** Method      : read_core_limits(...)
+**
+** Description : reads the coredump size limits of the crashed process.
+**               Each line of the file holds an executable name (or * for
+**               all others), the core size limit and the mini dump
+**               threshold in MB; 0 disables a limit.
+**
+** Parameters  : INPUT/OUTPUT p_proc
+**               INPUT p_filename
+**
+** Returns     : 0 if success, else -1
+** ===================================================================*/
+cdh_status_t read_core_limits(proc_info_t *p_proc, const char *p_filename)
+{
+    FILE *l_file = NULL;
+    char l_line[256];
+    int l_exact_match = 0;
+
+    if ((l_file = fopen(p_filename, "r")) == NULL)
+        return CDH_NOK;
+
+    while (fgets(l_line, sizeof(l_line), l_file) != NULL) {
+        char l_name[MAX_PROC_NAME_LENGTH] = { 0 };
+        unsigned long l_limit_mb = 0;
+        unsigned long l_minidump_mb = 0;
+
+        if ((l_line[0] == '#') ||
+            (sscanf(l_line, "%31s %lu %lu", l_name, &l_limit_mb, &l_minidump_mb) != 3))
+            continue;
+
+        if (strcmp(l_name, p_proc->name) == 0)
+            l_exact_match = 1;
+        else if ((strcmp(l_name, "*") != 0) || l_exact_match)
+            continue;
+
+        p_proc->core_limit = (uint64_t)l_limit_mb << 20;
+        p_proc->minidump_threshold = (uint64_t)l_minidump_mb << 20;
+
+        if (l_exact_match)
+            break;
+    }
+
+    fclose(l_file);
+
+    return CDH_OK;
+}
+
 /* ===================================================================
 ** Method      : remove_unusual_chars(...)
 **
@@ -341,6 +391,7 @@ cdh_status_t move_to_core_directory(proc_info_t *p_proc)
 int main(int argc, char *argv[])
 {
     proc_info_t l_proc_info;
+    cdh_status_t l_coredump_status = CDH_OK;
 /*    char l_exec_name[CORE_MAX_FILENAME_LENGTH] = {0}; */
 
     openlog("CoredumpHandler", 0, LOG_DAEMON);
@@ -371,17 +422,22 @@ int main(int argc, char *argv[])
 
     remove_unusual_chars(l_proc_info.name);
 
+    read_core_limits(&l_proc_info, CORE_LIMITS_FILE);
+
     core_locks(&l_proc_info, 1);
 
     write_proc_context(&l_proc_info);
 
-    treat_coredump(&l_proc_info);
+    l_coredump_status = treat_coredump(&l_proc_info);
 
     move_to_core_directory(&l_proc_info);
 
     core_locks(&l_proc_info, 0);
 
-    treat_crash_data(&l_proc_info);
+    /* the crash id is created while streaming once the notes are read,
+     * without them it is tried with what could be read */
+    if (l_coredump_status != CDH_OK)
+        treat_crash_data(&l_proc_info);
 
     closelog();
 
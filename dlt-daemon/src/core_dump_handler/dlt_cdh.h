@@ -41,6 +41,7 @@
 #define MAX_PROC_NAME_LENGTH        32
 #define CRASH_ID_LEN                8
 #define CRASHID_FILE                "/tmp/.crashid" /* the file where the white screen app will read the crashid */
+#define CORE_LIMITS_FILE            CONFIGURATION_FILES_DIR "/dlt-cdh.conf"
 
 #define CORE_FILE_PATTERN           "%s/core.%d.%s.%d.gz"
 #define CONTEXT_FILE_PATTERN        "%s/context.%d.%s.%d.txt"
@@ -76,6 +77,8 @@ typedef struct
     int signal;
 
     int can_create_coredump;
+    uint64_t core_limit;            /* bytes of the coredump that are kept, 0 means no limit */
+    uint64_t minidump_threshold;    /* above this size of memory segments only the notes are kept, 0 means never */
     file_streamer_t streamer;
 
     /* coredump content, for crash id generation */
@@ -93,6 +96,7 @@ typedef struct
 
 } proc_info_t;
 
+cdh_status_t read_core_limits(proc_info_t *p_proc, const char *p_filename);
 cdh_status_t get_exec_name(unsigned int p_pid_str, char *p_exec_name, int p_exec_name_maxsize);
 cdh_status_t write_proc_context(const proc_info_t *);
 cdh_status_t treat_coredump(proc_info_t *p_proc);
@@ -30,6 +30,7 @@
 #include <fcntl.h>
 #include <syslog.h>
 #include <errno.h>
+#include <inttypes.h>
 
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -42,10 +43,12 @@ cdh_status_t read_elf_headers(proc_info_t *p_proc)
     int phnum = 0;
 
     /* Read ELF header */
-    stream_read(&p_proc->streamer, &p_proc->m_Ehdr, sizeof(p_proc->m_Ehdr));
+    if (stream_read(&p_proc->streamer, &p_proc->m_Ehdr, sizeof(p_proc->m_Ehdr)) != CDH_OK)
+        return CDH_NOK;
 
     /* Read until PROG position */
-    stream_move_to_offest(&p_proc->streamer, p_proc->m_Ehdr.e_phoff);
+    if (stream_move_to_offest(&p_proc->streamer, p_proc->m_Ehdr.e_phoff) != CDH_OK)
+        return CDH_NOK;
 
     /* Read and store all program headers */
     p_proc->m_pPhdr = (ELF_Phdr *)malloc(sizeof(ELF_Phdr) * p_proc->m_Ehdr.e_phnum);
@@ -57,7 +60,8 @@ cdh_status_t read_elf_headers(proc_info_t *p_proc)
 
     for (phnum = 0; phnum < p_proc->m_Ehdr.e_phnum; phnum++)
         /* Read Programm header */
-        stream_read(&p_proc->streamer, &p_proc->m_pPhdr[phnum], sizeof(ELF_Phdr));
+        if (stream_read(&p_proc->streamer, &p_proc->m_pPhdr[phnum], sizeof(ELF_Phdr)) != CDH_OK)
+            return CDH_NOK;
 
     return CDH_OK;
 }
@@ -115,6 +119,27 @@ cdh_status_t read_notes(proc_info_t *p_proc)
     return CDH_OK;
 }
 
+/* Cut the coredump after the notes for huge processes, else at the configured size limit */
+static void apply_core_limits(proc_info_t *p_proc)
+{
+    uint64_t notes_end = stream_get_offset(&p_proc->streamer);
+    uint64_t load_size = 0;
+    int i = 0;
+
+    for (i = 0; i < p_proc->m_Ehdr.e_phnum; i++)
+        if (p_proc->m_pPhdr[i].p_type == PT_LOAD)
+            load_size += p_proc->m_pPhdr[i].p_filesz;
+
+    if ((p_proc->minidump_threshold > 0) && (load_size > p_proc->minidump_threshold)) {
+        syslog(LOG_NOTICE, "Memory of %" PRIu64 " bytes exceeds mini dump threshold, writing notes only", load_size);
+        stream_set_limit(&p_proc->streamer, notes_end);
+    }
+    else if (p_proc->core_limit > 0) {
+        /* the notes are always kept, they hold the registers of all threads */
+        stream_set_limit(&p_proc->streamer, p_proc->core_limit > notes_end ? p_proc->core_limit : notes_end);
+    }
+}
+
 cdh_status_t init_coredump(proc_info_t *p_proc)
 {
     if (p_proc == NULL)
@@ -156,20 +181,25 @@ cdh_status_t treat_coredump(proc_info_t *p_proc)
         goto finished;
     }
 
-    if (read_elf_headers(p_proc) == CDH_OK) {
-        /* TODO: No NOTES here leads to crash elsewhere!!! dlt_cdh_crashid.c: around line 76 */
-        if (read_notes(p_proc) != CDH_OK) {
-            syslog(LOG_ERR, "cannot read NOTES");
-            ret = CDH_NOK;
-            goto finished;
-        }
-    }
-    else if (read_elf_headers(p_proc) != CDH_OK) {
+    if (read_elf_headers(p_proc) != CDH_OK) {
         syslog(LOG_ERR, "cannot read ELF header");
         ret = CDH_NOK;
         goto finished;
     }
 
+    /* TODO: No NOTES here leads to crash elsewhere!!! dlt_cdh_crashid.c: around line 76 */
+    if (read_notes(p_proc) != CDH_OK) {
+        syslog(LOG_ERR, "cannot read NOTES");
+        ret = CDH_NOK;
+        goto finished;
+    }
+
+    /* The crash id only needs the notes: create it in the same pass, before the
+     * memory segments are streamed */
+    treat_crash_data(p_proc);
+
+    apply_core_limits(p_proc);
+
 finished:
 
     /* In all cases, we try to finish to read/compress the coredump until the end */
@@ -27,11 +27,281 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <syslog.h>
+#include <unistd.h>
+#include <zlib.h>
 #include "dlt_cdh_streamer.h"
 
-#define Z_CHUNK_SZ      1024 * 128
-#define Z_MODE_STR      "wb1"
+#define Z_CHUNK_SZ      (1024 * 1024)
+/* worst case size of a compressed block including the gzip wrapper */
+#define Z_OUT_SZ        (Z_CHUNK_SZ + Z_CHUNK_SZ / 8 + 1024)
+#define Z_LEVEL         1
+
+/* size requested for the kernel pipe, fewer wake ups while the crashed process is held */
+#define CDH_PIPE_SZ     (1024 * 1024)
+#define CDH_MAX_COMPRESS_THREADS 4
+
+enum
+{
+    BLOCK_FREE = 0,
+    BLOCK_FILLED,
+    BLOCK_COMPRESSING,
+    BLOCK_DONE
+};
+
+/* Deflate one block into a complete gzip member. Returns the size of the member, 0 on error. */
+static unsigned int stream_deflate_block(cdh_block_t *p_block, int p_level)
+{
+    unsigned int out_len = 0;
+    z_stream strm;
+
+    memset(&strm, 0, sizeof(strm));
+
+    /* 15 window bits + 16 selects the gzip wrapper */
+    if (deflateInit2(&strm, p_level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return 0;
+
+    strm.next_in = p_block->in;
+    strm.avail_in = p_block->in_len;
+    strm.next_out = p_block->out;
+    strm.avail_out = Z_OUT_SZ;
+
+    if (deflate(&strm, Z_FINISH) == Z_STREAM_END)
+        out_len = Z_OUT_SZ - strm.avail_out;
+
+    deflateEnd(&strm);
+
+    return out_len;
+}
+
+/* Compress one block, a block which cannot be compressed is stored uncompressed */
+static void stream_compress_block(cdh_block_t *p_block)
+{
+    p_block->out_len = stream_deflate_block(p_block, Z_LEVEL);
+
+    if (p_block->out_len > 0)
+        return;
+
+    syslog(LOG_WARNING, "Cannot compress coredump block, storing it");
+    p_block->out_len = stream_deflate_block(p_block, Z_NO_COMPRESSION);
+
+    if (p_block->out_len == 0)
+        syslog(LOG_ERR, "Cannot store coredump block");
+}
+
+static void *stream_worker(void *p_arg)
+{
+    file_streamer_t *p_fs = (file_streamer_t *)p_arg;
+
+    pthread_mutex_lock(&p_fs->mutex);
+
+    while (1) {
+        cdh_block_t *block = NULL;
+        unsigned int i = 0;
+
+        for (i = 0; i < p_fs->num_blocks && block == NULL; i++)
+            if (p_fs->blocks[i].state == BLOCK_FILLED)
+                block = &p_fs->blocks[i];
+
+        if (block == NULL) {
+            if (p_fs->closing)
+                break;
+
+            pthread_cond_wait(&p_fs->cond, &p_fs->mutex);
+            continue;
+        }
+
+        block->state = BLOCK_COMPRESSING;
+        pthread_mutex_unlock(&p_fs->mutex);
+
+        stream_compress_block(block);
+
+        pthread_mutex_lock(&p_fs->mutex);
+        block->state = BLOCK_DONE;
+        pthread_cond_broadcast(&p_fs->cond);
+    }
+
+    pthread_mutex_unlock(&p_fs->mutex);
+
+    return NULL;
+}
+
+/* Write the compressed blocks in order. After an error, also a block which could not be
+ * compressed, nothing more is written but the blocks are still released so that the reader
+ * never stalls: the coredump ends before the missing data instead of silently skipping it. */
+static void *stream_writer(void *p_arg)
+{
+    file_streamer_t *p_fs = (file_streamer_t *)p_arg;
+
+    pthread_mutex_lock(&p_fs->mutex);
+
+    while (1) {
+        cdh_block_t *block = &p_fs->blocks[p_fs->write_seq % p_fs->num_blocks];
+        unsigned int written = 0;
+
+        if (block->state != BLOCK_DONE) {
+            if (p_fs->closing && (p_fs->write_seq == p_fs->fill_seq))
+                break;
+
+            pthread_cond_wait(&p_fs->cond, &p_fs->mutex);
+            continue;
+        }
+
+        pthread_mutex_unlock(&p_fs->mutex);
+
+        if (!p_fs->write_error && (block->out_len == 0)) {
+            syslog(LOG_ERR, "Coredump is incomplete, a block is missing");
+            p_fs->write_error = 1;
+        }
+
+        while (!p_fs->write_error && written < block->out_len) {
+            ssize_t ret = write(p_fs->dst_fd, block->out + written, block->out_len - written);
+
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                syslog(LOG_ERR, "Cannot write coredump: %s", strerror(errno));
+                p_fs->write_error = 1;
+                break;
+            }
+
+            written += (unsigned int)ret;
+        }
+
+        pthread_mutex_lock(&p_fs->mutex);
+        block->in_len = 0;
+        block->state = BLOCK_FREE;
+        p_fs->write_seq++;
+        pthread_cond_broadcast(&p_fs->cond);
+    }
+
+    pthread_mutex_unlock(&p_fs->mutex);
+
+    return NULL;
+}
+
+static void stream_stop_threads(file_streamer_t *p_fs)
+{
+    unsigned int i = 0;
+
+    pthread_mutex_lock(&p_fs->mutex);
+    p_fs->closing = 1;
+    pthread_cond_broadcast(&p_fs->cond);
+    pthread_mutex_unlock(&p_fs->mutex);
+
+    for (i = 0; i < p_fs->num_workers; i++)
+        pthread_join(p_fs->workers[i], NULL);
+
+    if (p_fs->num_workers > 0)
+        pthread_join(p_fs->writer, NULL);
+
+    p_fs->num_workers = 0;
+}
+
+static cdh_status_t stream_start_threads(file_streamer_t *p_fs)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int workers = (cpus < 1) ? 1 : (cpus > CDH_MAX_COMPRESS_THREADS ? CDH_MAX_COMPRESS_THREADS : (unsigned int)cpus);
+    unsigned int i = 0;
+
+    p_fs->num_blocks = 2 * workers + 2;
+    p_fs->blocks = (cdh_block_t *)calloc(p_fs->num_blocks, sizeof(cdh_block_t));
+    p_fs->workers = (pthread_t *)calloc(workers, sizeof(pthread_t));
+
+    if ((p_fs->blocks == NULL) || (p_fs->workers == NULL))
+        return CDH_NOK;
+
+    for (i = 0; i < p_fs->num_blocks; i++) {
+        p_fs->blocks[i].in = (unsigned char *)malloc(Z_CHUNK_SZ);
+        p_fs->blocks[i].out = (unsigned char *)malloc(Z_OUT_SZ);
+
+        if ((p_fs->blocks[i].in == NULL) || (p_fs->blocks[i].out == NULL))
+            return CDH_NOK;
+    }
+
+    pthread_mutex_init(&p_fs->mutex, NULL);
+    pthread_cond_init(&p_fs->cond, NULL);
+
+    if (pthread_create(&p_fs->writer, NULL, stream_writer, p_fs) != 0)
+        return CDH_NOK;
+
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&p_fs->workers[i], NULL, stream_worker, p_fs) != 0)
+            break;
+
+        p_fs->num_workers++;
+    }
+
+    if (p_fs->num_workers == 0) {
+        pthread_mutex_lock(&p_fs->mutex);
+        p_fs->closing = 1;
+        pthread_cond_broadcast(&p_fs->cond);
+        pthread_mutex_unlock(&p_fs->mutex);
+        pthread_join(p_fs->writer, NULL);
+        return CDH_NOK;
+    }
+
+    return CDH_OK;
+}
+
+/* Hand the block being filled over to the compression workers */
+static void stream_submit_block(file_streamer_t *p_fs)
+{
+    pthread_mutex_lock(&p_fs->mutex);
+    p_fs->blocks[p_fs->fill_seq % p_fs->num_blocks].state = BLOCK_FILLED;
+    p_fs->fill_seq++;
+    pthread_cond_broadcast(&p_fs->cond);
+    pthread_mutex_unlock(&p_fs->mutex);
+}
+
+/* Read at most p_max bytes from the source straight into the block being filled.
+ * Returns the number of bytes read, 0 at the end of the source, -1 on error. */
+static ssize_t stream_read_some(file_streamer_t *p_fs, size_t p_max, unsigned char **p_data)
+{
+    unsigned char *dst = p_fs->read_buf;
+    size_t space = Z_CHUNK_SZ;
+    cdh_block_t *block = NULL;
+    ssize_t ret = 0;
+
+    if (p_fs->num_workers > 0) {
+        block = &p_fs->blocks[p_fs->fill_seq % p_fs->num_blocks];
+
+        pthread_mutex_lock(&p_fs->mutex);
+
+        while (block->state != BLOCK_FREE)
+            pthread_cond_wait(&p_fs->cond, &p_fs->mutex);
+
+        pthread_mutex_unlock(&p_fs->mutex);
+
+        dst = block->in + block->in_len;
+        space = Z_CHUNK_SZ - block->in_len;
+    }
+
+    if (space > p_max)
+        space = p_max;
+
+    do
+        ret = read(p_fs->src_fd, dst, space);
+    while ((ret < 0) && (errno == EINTR));
+
+    if (ret <= 0)
+        return ret;
+
+    p_fs->offset += (uint64_t)ret;
+    *p_data = dst;
+
+    if (block != NULL) {
+        block->in_len += (unsigned int)ret;
+
+        if (block->in_len == Z_CHUNK_SZ)
+            stream_submit_block(p_fs);
+    }
+
+    return ret;
+}
 
 cdh_status_t stream_init(file_streamer_t *p_fs, const char *p_src_fname, const char *p_dst_fname)
 {
@@ -41,31 +311,36 @@ cdh_status_t stream_init(file_streamer_t *p_fs, const char *p_src_fname, const c
     }
 
     memset(p_fs, 0, sizeof(file_streamer_t));
+    p_fs->src_fd = -1;
+    p_fs->dst_fd = -1;
 
     /* Allow to not save the coredump */
-    if (p_dst_fname == NULL) {
-        p_fs->gz_dst_file = 0;
-    }
-    else {
+    if (p_dst_fname != NULL) {
         /* Create output file */
-        p_fs->gz_dst_file = gzopen(p_dst_fname, Z_MODE_STR);
+        p_fs->dst_fd = open(p_dst_fname, O_WRONLY | O_CREAT | O_TRUNC, 0666);
 
-        if (p_fs->gz_dst_file == Z_NULL) {
-            /*return CDH_NOK; */
+        if (p_fs->dst_fd < 0)
             syslog(LOG_ERR, "Cannot open output filename <%s>. %s", p_dst_fname, strerror(errno));
-            p_fs->gz_dst_file = 0;
+    }
 
-        }
+    if ((p_fs->dst_fd >= 0) && (stream_start_threads(p_fs) != CDH_OK)) {
+        syslog(LOG_ERR, "Cannot start coredump compression. %s", strerror(errno));
+        close(p_fs->dst_fd);
+        p_fs->dst_fd = -1;
     }
 
-    if (p_fs->gz_dst_file == Z_NULL)
+    if (p_fs->dst_fd < 0)
         syslog(LOG_WARNING, "The coredump will be processed, but not written");
 
     /* Open input file */
     if (p_src_fname == NULL) {
-        p_fs->stream = stdin;
+        p_fs->src_fd = STDIN_FILENO;
+
+        /* not a pipe when the handler is run by hand, nothing to do then */
+        if (fcntl(p_fs->src_fd, F_SETPIPE_SZ, CDH_PIPE_SZ) < 0)
+            syslog(LOG_DEBUG, "Cannot resize input pipe. %s", strerror(errno));
     }
-    else if ((p_fs->stream = fopen(p_src_fname, "rb")) == NULL) {
+    else if ((p_fs->src_fd = open(p_src_fname, O_RDONLY)) < 0) {
         syslog(LOG_ERR, "Cannot open filename <%s>. %s", p_src_fname, strerror(errno));
         return CDH_NOK;
     }
@@ -81,20 +356,54 @@ cdh_status_t stream_init(file_streamer_t *p_fs, const char *p_src_fname, const c
 
 cdh_status_t stream_close(file_streamer_t *p_fs)
 {
+    unsigned int i = 0;
+
     if (p_fs == NULL) {
         syslog(LOG_ERR, "Internal pointer error in 'stream_close'");
         return CDH_NOK;
     }
 
-    if (p_fs->gz_dst_file != NULL) {
-        gzflush(p_fs->gz_dst_file, Z_FINISH);
-        gzclose(p_fs->gz_dst_file);
-        p_fs->gz_dst_file = NULL;
+    if (p_fs->num_workers > 0) {
+        cdh_block_t *block = &p_fs->blocks[p_fs->fill_seq % p_fs->num_blocks];
+
+        pthread_mutex_lock(&p_fs->mutex);
+
+        while (block->state != BLOCK_FREE)
+            pthread_cond_wait(&p_fs->cond, &p_fs->mutex);
+
+        pthread_mutex_unlock(&p_fs->mutex);
+
+        /* the last partial block; an empty coredump still gets one (empty) gzip member */
+        if ((block->in_len > 0) || (p_fs->fill_seq == 0))
+            stream_submit_block(p_fs);
+
+        stream_stop_threads(p_fs);
+        pthread_mutex_destroy(&p_fs->mutex);
+        pthread_cond_destroy(&p_fs->cond);
     }
 
-    if (p_fs->stream != NULL) {
-        fclose(p_fs->stream);
-        p_fs->stream = NULL;
+    if (p_fs->blocks != NULL) {
+        for (i = 0; i < p_fs->num_blocks; i++) {
+            free(p_fs->blocks[i].in);
+            free(p_fs->blocks[i].out);
+        }
+
+        free(p_fs->blocks);
+        p_fs->blocks = NULL;
+    }
+
+    free(p_fs->workers);
+    p_fs->workers = NULL;
+
+    if (p_fs->dst_fd >= 0) {
+        close(p_fs->dst_fd);
+        p_fs->dst_fd = -1;
+    }
+
+    /* closing the pipe early (size limit, mini dump) makes the kernel abort the dump */
+    if (p_fs->src_fd >= 0) {
+        close(p_fs->src_fd);
+        p_fs->src_fd = -1;
     }
 
     if (p_fs->read_buf != NULL) {
@@ -119,60 +428,71 @@ cdh_status_t stream_read(file_streamer_t *p_fs, void *p_buf, unsigned int p_size
         return CDH_NOK;
     }
 
-    if ((byte_read = fread(p_buf, 1, p_size, p_fs->stream)) != p_size) {
-        syslog(LOG_WARNING, "Cannot read %d bytes from src. %s", p_size, strerror(errno));
-        return CDH_NOK;
-    }
+    while (byte_read < p_size) {
+        unsigned char *data = NULL;
+        ssize_t ret = stream_read_some(p_fs, p_size - byte_read, &data);
 
-    p_fs->offset += byte_read;
+        if (ret <= 0) {
+            syslog(LOG_WARNING, "Cannot read %d bytes from src. %s", p_size, ret < 0 ? strerror(errno) : "End of file");
+            return CDH_NOK;
+        }
 
-    if (p_fs->gz_dst_file != NULL)
-        gzwrite(p_fs->gz_dst_file, p_buf, byte_read);
+        memcpy((unsigned char *)p_buf + byte_read, data, (size_t)ret);
+        byte_read += (unsigned int)ret;
+    }
 
     return CDH_OK;
 }
 
-int stream_finish(file_streamer_t *p_fs)
+cdh_status_t stream_finish(file_streamer_t *p_fs)
 {
-    if ((p_fs == NULL) || (p_fs->stream == NULL)) {
-        syslog(LOG_ERR, "Internal pointer error in 'stream_move_ahead'");
+    if ((p_fs == NULL) || (p_fs->src_fd < 0)) {
+        syslog(LOG_ERR, "Internal pointer error in 'stream_finish'");
         return CDH_NOK;
     }
 
-    while (!feof(p_fs->stream)) {
-        size_t read_bytes = fread(p_fs->read_buf, 1, Z_CHUNK_SZ, p_fs->stream);
+    while ((p_fs->limit == 0) || (p_fs->offset < p_fs->limit)) {
+        unsigned char *data = NULL;
+        size_t max = Z_CHUNK_SZ;
+        ssize_t ret = 0;
+
+        if ((p_fs->limit != 0) && (p_fs->limit - p_fs->offset < max))
+            max = (size_t)(p_fs->limit - p_fs->offset);
 
-        if (p_fs->gz_dst_file != NULL)
-            gzwrite(p_fs->gz_dst_file, p_fs->read_buf, read_bytes);
+        ret = stream_read_some(p_fs, max, &data);
 
-        p_fs->offset += read_bytes;
+        if (ret == 0)
+            return CDH_OK;
 
-        if (ferror(p_fs->stream)) {
+        if (ret < 0) {
             syslog(LOG_WARNING, "Error reading from the src stream: %s", strerror(errno));
             return CDH_NOK;
         }
     }
 
+    syslog(LOG_NOTICE, "Coredump cut at %" PRIu64 " bytes", p_fs->limit);
+
     return CDH_OK;
 }
 
-int stream_move_to_offest(file_streamer_t *p_fs, unsigned int p_offset)
+cdh_status_t stream_move_to_offest(file_streamer_t *p_fs, uint64_t p_offset)
 {
-    int bytes_to_read = 0;
-
     if (p_fs == NULL) {
         syslog(LOG_ERR, "Internal pointer error in 'stream_move_to_offest'");
         return CDH_NOK;
     }
 
-    bytes_to_read = p_offset - p_fs->offset;
+    if (p_offset < p_fs->offset) {
+        syslog(LOG_WARNING, "Cannot move back to offset %" PRIu64, p_offset);
+        return CDH_NOK;
+    }
 
-    return stream_move_ahead(p_fs, bytes_to_read);
+    return stream_move_ahead(p_fs, p_offset - p_fs->offset);
 }
 
-int stream_move_ahead(file_streamer_t *p_fs, unsigned int p_nbbytes)
+cdh_status_t stream_move_ahead(file_streamer_t *p_fs, uint64_t p_nbbytes)
 {
-    int bytes_to_read = p_nbbytes;
+    uint64_t bytes_to_read = p_nbbytes;
 
     if (p_fs == NULL) {
         syslog(LOG_ERR, "Internal pointer error in 'stream_move_ahead'");
@@ -180,30 +500,39 @@ int stream_move_ahead(file_streamer_t *p_fs, unsigned int p_nbbytes)
     }
 
     while (bytes_to_read > 0) {
-        size_t chunk_size = bytes_to_read > Z_CHUNK_SZ ? Z_CHUNK_SZ : bytes_to_read;
-        size_t read_bytes = fread(p_fs->read_buf, 1, chunk_size, p_fs->stream);
+        unsigned char *data = NULL;
+        size_t chunk_size = bytes_to_read > Z_CHUNK_SZ ? Z_CHUNK_SZ : (size_t)bytes_to_read;
+        ssize_t read_bytes = stream_read_some(p_fs, chunk_size, &data);
 
-        if (read_bytes != chunk_size) {
-            syslog(LOG_WARNING, "Cannot move ahead by %d bytes from src. Read %lu bytes", p_nbbytes, read_bytes);
+        if (read_bytes <= 0) {
+            syslog(LOG_WARNING, "Cannot move ahead by %" PRIu64 " bytes from src. Read %" PRIu64 " bytes",
+                   p_nbbytes, p_nbbytes - bytes_to_read);
             return CDH_NOK;
         }
 
-        if (p_fs->gz_dst_file != 0)
-            gzwrite(p_fs->gz_dst_file, p_fs->read_buf, chunk_size);
+        bytes_to_read -= (uint64_t)read_bytes;
+    }
+
+    return CDH_OK;
+}
 
-        bytes_to_read -= chunk_size;
+cdh_status_t stream_set_limit(file_streamer_t *p_fs, uint64_t p_limit)
+{
+    if (p_fs == NULL) {
+        syslog(LOG_ERR, "Internal pointer error in 'stream_set_limit'");
+        return CDH_NOK;
     }
 
-    p_fs->offset += p_nbbytes;
+    p_fs->limit = p_limit;
 
     return CDH_OK;
 }
 
-unsigned int stream_get_offset(file_streamer_t *p_fs)
+uint64_t stream_get_offset(file_streamer_t *p_fs)
 {
     if (p_fs == NULL) {
         syslog(LOG_ERR, "Internal pointer error in 'stream_get_offset'");
-        return CDH_NOK;
+        return 0;
     }
 
     return p_fs->offset;
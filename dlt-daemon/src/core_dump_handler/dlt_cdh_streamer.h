@@ -26,17 +26,41 @@
 #ifndef DLT_CDH_STREAMER_H
 #define DLT_CDH_STREAMER_H
 
-#include <stdio.h>
-#include <zlib.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include "dlt_cdh_definitions.h"
 
 typedef struct
 {
-    FILE *stream;
-    unsigned int offset;
-    gzFile gz_dst_file;
-    unsigned char *read_buf;
+    unsigned char *in;
+    unsigned int in_len;
+    unsigned char *out;
+    unsigned int out_len;
+    int state;
+
+} cdh_block_t;
+
+typedef struct
+{
+    int src_fd;
+    int dst_fd;
+    uint64_t offset;
+    uint64_t limit;             /* stop reading the source at this offset, 0 means no limit */
+    unsigned char *read_buf;    /* scratch buffer when the coredump is not written */
+
+    /* the source is cut into blocks which are compressed in parallel into gzip members */
+    cdh_block_t *blocks;
+    unsigned int num_blocks;
+    unsigned int fill_seq;      /* block filled by the reader */
+    unsigned int write_seq;     /* next block for the writer */
+    pthread_t *workers;
+    unsigned int num_workers;
+    pthread_t writer;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int closing;
+    int write_error;
 
 } file_streamer_t;
 
@@ -44,8 +68,9 @@ cdh_status_t stream_init(file_streamer_t *p_fs, const char *p_src_fname, const c
 cdh_status_t stream_close(file_streamer_t *p_fs);
 cdh_status_t stream_read(file_streamer_t *p_fs, void *p_buf, unsigned int p_size);
 cdh_status_t stream_finish(file_streamer_t *p_fs);
-cdh_status_t stream_move_to_offest(file_streamer_t *p_fs, unsigned int p_offset);
-cdh_status_t stream_move_ahead(file_streamer_t *p_fs, unsigned int p_nbbytes);
-unsigned int stream_get_offset(file_streamer_t *p_fs);
+cdh_status_t stream_move_to_offest(file_streamer_t *p_fs, uint64_t p_offset);
+cdh_status_t stream_move_ahead(file_streamer_t *p_fs, uint64_t p_nbbytes);
+cdh_status_t stream_set_limit(file_streamer_t *p_fs, uint64_t p_limit);
+uint64_t stream_get_offset(file_streamer_t *p_fs);
 
 #endif /* #ifndef DLT_CDH_STREAMER_H */
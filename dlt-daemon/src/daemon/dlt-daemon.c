@@ -91,6 +91,7 @@
 #include "dlt_daemon_event_handler.h"
 #include "dlt_daemon_offline_logstorage.h"
 #include "dlt_gateway.h"
+#include "dlt_storage_writer.h"
 
 #ifdef UDP_CONNECTION_SUPPORT
 #   include "dlt_daemon_udp_socket.h"
@@ -140,16 +141,18 @@ int g_signo = 0;
 /* used for value from conf file */
 static int value_length = 1024;
 
-static char dlt_timer_conn_types[DLT_TIMER_UNKNOWN + 1] = {
-    [DLT_TIMER_PACKET] = DLT_CONNECTION_ONE_S_TIMER,
-    [DLT_TIMER_ECU] = DLT_CONNECTION_SIXTY_S_TIMER,
+static DltDaemonTimerCallback dlt_timer_callbacks[DLT_TIMER_UNKNOWN + 1] = {
+    [DLT_TIMER_PACKET] = dlt_daemon_process_one_s_timer,
+    [DLT_TIMER_ECU] = dlt_daemon_process_sixty_s_timer,
 #ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    [DLT_TIMER_SYSTEMD] = DLT_CONNECTION_SYSTEMD_TIMER,
+    [DLT_TIMER_SYSTEMD] = dlt_daemon_process_systemd_timer,
 #endif
-    [DLT_TIMER_GATEWAY] = DLT_CONNECTION_GATEWAY_TIMER,
-    [DLT_TIMER_UNKNOWN] = DLT_CONNECTION_TYPE_MAX
+    [DLT_TIMER_GATEWAY] = dlt_gateway_process_gateway_timer,
+    [DLT_TIMER_UNKNOWN] = NULL
 };
 
+static DltDaemonTimer dlt_timers[DLT_TIMER_UNKNOWN];
+
 static char dlt_timer_names[DLT_TIMER_UNKNOWN + 1][32] = {
     [DLT_TIMER_PACKET] = "Timing packet",
     [DLT_TIMER_ECU] = "ECU version",
@@ -161,33 +164,10 @@ static char dlt_timer_names[DLT_TIMER_UNKNOWN + 1][32] = {
 };
 
 #ifdef __QNX__
-static int dlt_timer_pipes[DLT_TIMER_UNKNOWN][2] = {
-    /* [timer_id] = {read_pipe, write_pipe} */
-    [DLT_TIMER_PACKET] = {DLT_FD_INIT, DLT_FD_INIT},
-    [DLT_TIMER_ECU] = {DLT_FD_INIT, DLT_FD_INIT},
-#ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    [DLT_TIMER_SYSTEMD] = {DLT_FD_INIT, DLT_FD_INIT},
-#endif
-    [DLT_TIMER_GATEWAY] = {DLT_FD_INIT, DLT_FD_INIT}
-};
+/* {read_pipe, write_pipe} of the thread driving the timer wheel */
+static int dlt_timer_pipe[2] = { DLT_FD_INIT, DLT_FD_INIT };
 
-static pthread_t timer_threads[DLT_TIMER_UNKNOWN] = {
-    [DLT_TIMER_PACKET] = 0,
-    [DLT_TIMER_ECU] = 0,
-#ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    [DLT_TIMER_SYSTEMD] = 0,
-#endif
-    [DLT_TIMER_GATEWAY] = 0
-};
-
-static DltDaemonPeriodicData *timer_data[DLT_TIMER_UNKNOWN] = {
-    [DLT_TIMER_PACKET] = NULL,
-    [DLT_TIMER_ECU] = NULL,
-#ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    [DLT_TIMER_SYSTEMD] = NULL,
-#endif
-    [DLT_TIMER_GATEWAY] = NULL
-};
+static pthread_t timer_thread_id = 0;
 
 void close_pipes(int fds[2])
 {
@@ -510,6 +490,7 @@ int option_file_parser(DltDaemonLocal *daemon_local)
 #endif
     daemon_local->flags.ipNodes = NULL;
     daemon_local->flags.injectionMode = 1;
+    daemon_local->flags.clientCompressionFlushInterval = DLT_COMPRESSION_FLUSH_INTERVAL;
 
     /* open configuration file */
     if (daemon_local->flags.cvalue[0])
@@ -936,6 +917,9 @@ int option_file_parser(DltDaemonLocal *daemon_local)
                     else if (strcmp(token, "InjectionMode") == 0) {
                         daemon_local->flags.injectionMode = atoi(value);
                     }
+                    else if (strcmp(token, "ClientCompressionFlushInterval") == 0) {
+                        daemon_local->flags.clientCompressionFlushInterval = atoi(value);
+                    }
                     else {
                         fprintf(stderr, "Unknown option: %s=%s\n", token, value);
                     }
@@ -1599,7 +1583,13 @@ int main(int argc, char *argv[])
             dlt_log(LOG_INFO,
                     "Setting up internal offline log storage failed!\n");
 
-    /* create fd for watchdog */
+    /* create the timer wheel driving all daemon timers */
+    if (dlt_daemon_timer_init(&daemon_local) == -1) {
+        dlt_log(LOG_CRIT, "Could not create daemon timers\n");
+        return -1;
+    }
+
+    /* start watchdog timer */
 #ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
     {
         char *watchdogUSec = getenv("WATCHDOG_USEC");
@@ -1622,20 +1612,20 @@ int main(int argc, char *argv[])
 
         daemon.watchdog_trigger_interval = watchdogTimeoutSeconds;
         daemon.watchdog_last_trigger_time = 0U;
-        create_timer_fd(&daemon_local,
-                        watchdogTimeoutSeconds,
-                        watchdogTimeoutSeconds,
-                        DLT_TIMER_SYSTEMD);
+        dlt_daemon_start_timer(&daemon_local,
+                               watchdogTimeoutSeconds,
+                               watchdogTimeoutSeconds,
+                               DLT_TIMER_SYSTEMD);
     }
 #endif
 
-    /* create fd for timer timing packets */
-    create_timer_fd(&daemon_local, 1, 1, DLT_TIMER_PACKET);
+    /* start timer timing packets */
+    dlt_daemon_start_timer(&daemon_local, 1, 1, DLT_TIMER_PACKET);
 
-    /* create fd for timer ecu version */
+    /* start timer ecu version */
     if ((daemon_local.flags.sendECUSoftwareVersion > 0) ||
         (daemon_local.flags.sendTimezone > 0))
-        create_timer_fd(&daemon_local, 60, 60, DLT_TIMER_ECU);
+        dlt_daemon_start_timer(&daemon_local, 60, 60, DLT_TIMER_ECU);
 
     /* initiate gateway */
     if (daemon_local.flags.gatewayMode == 1) {
@@ -1644,11 +1634,11 @@ int main(int argc, char *argv[])
             return -1;
         }
 
-        /* create gateway timer */
-        create_timer_fd(&daemon_local,
-                        daemon_local.pGateway.interval,
-                        daemon_local.pGateway.interval,
-                        DLT_TIMER_GATEWAY);
+        /* start gateway timer */
+        dlt_daemon_start_timer(&daemon_local,
+                               daemon_local.pGateway.interval,
+                               daemon_local.pGateway.interval,
+                               DLT_TIMER_GATEWAY);
     }
 
     /* For offline tracing we still can use the same states */
@@ -1666,12 +1656,15 @@ int main(int argc, char *argv[])
 
     /*
      * Check for app and ctx runtime cfg.
-     * These cfg must be loaded after ecuId and num_user_lists are available
+     * These cfg must be loaded after ecuId and num_user_lists are available.
+     * The binary snapshot is used as long as it matches the text files.
      */
-    if ((dlt_daemon_applications_load(&daemon, daemon.runtime_application_cfg,
-                                      daemon_local.flags.vflag) == 0) &&
-        (dlt_daemon_contexts_load(&daemon, daemon.runtime_context_cfg,
-                                  daemon_local.flags.vflag) == 0))
+    if ((dlt_daemon_runtime_snapshot_load(&daemon, daemon.runtime_snapshot,
+                                          daemon_local.flags.vflag) == 0) ||
+        ((dlt_daemon_applications_load(&daemon, daemon.runtime_application_cfg,
+                                       daemon_local.flags.vflag) == 0) &&
+         (dlt_daemon_contexts_load(&daemon, daemon.runtime_context_cfg,
+                                   daemon_local.flags.vflag) == 0)))
         daemon.runtime_context_cfg_loaded = 1;
 
     dlt_daemon_log_internal(&daemon, &daemon_local,
@@ -1806,6 +1799,27 @@ int dlt_daemon_local_init_p2(DltDaemon *daemon, DltDaemonLocal *daemon_local, in
         return -1;
     }
 
+    /* Storage writes are queued and completed in the event loop if io_uring
+     * is available, otherwise they are done synchronously */
+    if (dlt_storage_writer_init(DLT_STORAGE_WRITER_ENTRIES, DLT_STORAGE_WRITER_SLOT_SIZE) == DLT_RETURN_OK) {
+        /* the connection closes its own copy of the eventfd */
+        int fd = dup(dlt_storage_writer_get_fd());
+
+        if ((fd == -1) ||
+            dlt_connection_create(daemon_local, &daemon_local->pEvent, fd, POLLIN,
+                                  DLT_CONNECTION_STORAGE_WRITER)) {
+            dlt_log(LOG_ERR, "Could not register storage writer, writing synchronously\n");
+
+            if (fd != -1)
+                close(fd);
+
+            dlt_storage_writer_free();
+        }
+    }
+    else {
+        dlt_log(LOG_INFO, "Storage files are written synchronously\n");
+    }
+
     /* init offline trace */
     if (((daemon->mode == DLT_USER_MODE_INTERNAL) || (daemon->mode == DLT_USER_MODE_BOTH)) &&
         daemon_local->flags.offlineTraceDirectory[0]) {
@@ -2477,6 +2491,9 @@ void dlt_daemon_local_cleanup(DltDaemon *daemon, DltDaemonLocal *daemon_local, i
         free(daemon->storage_handle);
     }
 
+    /* wait for the queued storage writes */
+    dlt_storage_writer_free();
+
     if (daemon->ECUVersionString != NULL)
         free(daemon->ECUVersionString);
 
@@ -2541,23 +2558,13 @@ void dlt_daemon_signal_handler(int sig)
 #ifdef __QNX__
 void dlt_daemon_cleanup_timers()
 {
-    int i = 0;
-    while (i < DLT_TIMER_UNKNOWN) {
-        /* Remove FIFO of every timer and kill timer thread */
-        if (0 != timer_threads[i]) {
-            pthread_kill(timer_threads[i], SIGUSR1);
-            pthread_join(timer_threads[i], NULL);
-            timer_threads[i] = 0;
-
-            close_pipes(dlt_timer_pipes[i]);
-
-            /* Free data of every timer */
-            if (NULL != timer_data[i]) {
-                free(timer_data[i]);
-                timer_data[i] = NULL;
-            }
-        }
-        i++;
+    /* Remove FIFO of the timer wheel and kill its thread */
+    if (0 != timer_thread_id) {
+        pthread_kill(timer_thread_id, SIGUSR1);
+        pthread_join(timer_thread_id, NULL);
+        timer_thread_id = 0;
+
+        close_pipes(dlt_timer_pipe);
     }
 }
 #endif
@@ -4091,8 +4098,9 @@ int dlt_daemon_process_user_message_register_application(DltDaemon *daemon,
     } else if(daemon->daemon_version == DLTProtocolV1) {
         DltUserControlMsgRegisterApplication userapp;
         uint32_t len = sizeof(DltUserControlMsgRegisterApplication);
+        uint32_t flags = 0;
+        char *payload;
         memset(&userapp, 0, sizeof(DltUserControlMsgRegisterApplication));
-        origin = rec->buf;
 
         /* Adding temp variable to check the return value */
         int temp = 0;
@@ -4110,31 +4118,38 @@ int dlt_daemon_process_user_message_register_application(DltDaemon *daemon,
             to_remove = (uint32_t) temp;
         }
 
-        len = 0;
+        len = userapp.description_length;
 
-        if (len > DLT_DAEMON_DESCSIZE) {
-            len = DLT_DAEMON_DESCSIZE;
-            dlt_log(LOG_WARNING, "Application description exceeds limit\n");
-        }
-
-        /* adjust buffer pointer */
-        rec->buf += to_remove + sizeof(DltUserHeader);
+        if ((sizeof(DltUserHeader) + to_remove + len <= (size_t) rec->buffersize) &&
+            (sizeof(DltUserHeader) + to_remove + len > (size_t) rec->bytesRcvd))
+            /* Not enough bytes received */
+            return -1;
 
-        if (dlt_receiver_check_and_get(rec, description, len, DLT_RCV_NONE) < 0) {
+        if (sizeof(DltUserHeader) + to_remove + len > (size_t) rec->bytesRcvd) {
             dlt_log(LOG_ERR, "Unable to get application description\n");
             /* in case description was not readable, set dummy description */
             memcpy(description, "Unknown", sizeof("Unknown"));
 
-            /* unknown len of original description, set to 0 to not remove in next
-            * step. Because message buffer is re-adjusted the corrupted description
-            * is ignored. */
+            /* the description does not fit into the receive buffer, set len to 0
+            * to not remove it in next step. It is skipped when searching the next
+            * user header. */
             len = 0;
         }
+        else {
+            payload = rec->buf + sizeof(DltUserHeader) + to_remove;
+
+            /* newer libraries terminate the description and append their flags */
+            if ((len >= 1 + sizeof(flags)) && (payload[len - sizeof(flags) - 1] == '\0'))
+                memcpy(&flags, payload + len - sizeof(flags), sizeof(flags));
+
+            if (len > DLT_DAEMON_DESCSIZE)
+                dlt_log(LOG_WARNING, "Application description exceeds limit\n");
+
+            memcpy(description, payload, (len > DLT_DAEMON_DESCSIZE) ? DLT_DAEMON_DESCSIZE : len);
+        }
 
         /* adjust to_remove */
         to_remove += (uint32_t) sizeof(DltUserHeader) + len;
-        /* point to begin of message */
-        rec->buf = origin;
 
         /* We can now remove data. */
         if (dlt_receiver_remove(rec, (int) to_remove) != DLT_RETURN_OK) {
@@ -4166,7 +4181,10 @@ int dlt_daemon_process_user_message_register_application(DltDaemon *daemon,
                     userapp.apid, userapp.pid);
             return -1;
         }
-        else if (old_pid != application->pid)
+
+        application->log_level_batch = (flags & DLT_USER_APP_FLAG_LOG_LEVEL_BATCH) != 0;
+
+        if (old_pid != application->pid)
         {
             char local_str[DLT_DAEMON_TEXTBUFSIZE] = { '\0' };
 
@@ -5588,56 +5606,160 @@ int dlt_daemon_send_ringbuffer_to_client_v2(DltDaemon *daemon, DltDaemonLocal *d
     return DLT_DAEMON_ERROR_OK;
 }
 
+/* Current time of the timer wheel in ms */
+static uint64_t dlt_daemon_timer_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/* Arm the timerfd for the next expiry of the timer wheel */
+static void dlt_daemon_timer_rearm(DltDaemonLocal *daemon_local)
+{
+#ifdef linux
+    DltConnection *con = NULL;
+    struct itimerspec spec;
+    uint64_t expires = 0;
+
+    con = dlt_connection_get_next(daemon_local->pEvent.connections, DLT_CON_MASK_TIMER);
+
+    if (con == NULL)
+        return;
+
+    /* disarmed without pending timers */
+    memset(&spec, 0, sizeof(spec));
+
+    if (dlt_daemon_timer_wheel_next(&daemon_local->timers, &expires) == 0) {
+        spec.it_value.tv_sec = (time_t)(expires / 1000);
+        spec.it_value.tv_nsec = (long)(expires % 1000) * 1000000L;
+
+        if ((spec.it_value.tv_sec == 0) && (spec.it_value.tv_nsec == 0))
+            spec.it_value.tv_nsec = 1;
+    }
+
+    if (timerfd_settime(con->receiver->fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0)
+        dlt_vlog(LOG_WARNING, "%s: timerfd_settime failed: %s\n", __func__, strerror(errno));
+#else
+    /* the timer thread wakes up the wheel every second */
+    (void)daemon_local;
+#endif
+}
+
 #ifdef __QNX__
 static void *timer_thread(void *data)
 {
-    int pexit = 0;
     unsigned int sleep_ret = 0;
 
-    DltDaemonPeriodicData* timer_thread_data = (DltDaemonPeriodicData*) data;
-
-    /* Timer will start in starts_in sec*/
-    if ((sleep_ret = sleep(timer_thread_data->starts_in))) {
-        dlt_vlog(LOG_NOTICE, "Sleep remains [%u] for starting!"
-                "Stop thread of timer [%d]\n",
-                sleep_ret, timer_thread_data->timer_id);
-         close_pipes(dlt_timer_pipes[timer_thread_data->timer_id]);
-         return NULL;
-    }
+    (void)data;
 
+    /*
+     * Since timerfd is not valid in QNX, this thread wakes up the event loop
+     * once per second to advance the timer wheel.
+     */
     while (1) {
-        if ((dlt_timer_pipes[timer_thread_data->timer_id][1] > 0) &&
-                (0 > write(dlt_timer_pipes[timer_thread_data->timer_id][1], "1", 1))) {
-            dlt_vlog(LOG_ERR, "Failed to send notification for timer [%s]!\n",
-                    dlt_timer_names[timer_thread_data->timer_id]);
-            pexit = 1;
-        }
-
-        if (pexit || g_exit) {
-            dlt_vlog(LOG_NOTICE, "Received signal!"
-                    "Stop thread of timer [%d]\n",
-                    timer_thread_data->timer_id);
-            close_pipes(dlt_timer_pipes[timer_thread_data->timer_id]);
+        if ((sleep_ret = sleep(1))) {
+            dlt_vlog(LOG_NOTICE, "Sleep remains [%u] for interval!"
+                     "Stop thread of timer wheel\n", sleep_ret);
+            close_pipes(dlt_timer_pipe);
             return NULL;
         }
 
-        if ((sleep_ret = sleep(timer_thread_data->period_sec))) {
-            dlt_vlog(LOG_NOTICE, "Sleep remains [%u] for interval!"
-                    "Stop thread of timer [%d]\n",
-                    sleep_ret, timer_thread_data->timer_id);
-             close_pipes(dlt_timer_pipes[timer_thread_data->timer_id]);
-             return NULL;
+        if ((dlt_timer_pipe[1] > 0) && (0 > write(dlt_timer_pipe[1], "1", 1))) {
+            dlt_log(LOG_ERR, "Failed to send notification for timer wheel!\n");
+            close_pipes(dlt_timer_pipe);
+            return NULL;
+        }
+
+        if (g_exit) {
+            dlt_log(LOG_NOTICE, "Received signal! Stop thread of timer wheel\n");
+            close_pipes(dlt_timer_pipe);
+            return NULL;
         }
     }
 }
 #endif
 
-int create_timer_fd(DltDaemonLocal *daemon_local,
-                    int period_sec,
-                    int starts_in,
-                    DltTimers timer_id)
+int dlt_daemon_timer_init(DltDaemonLocal *daemon_local)
 {
     int local_fd = DLT_FD_INIT;
+
+    if (daemon_local == NULL) {
+        dlt_log(LOG_ERR, "Daemon local structure is NULL\n");
+        return -1;
+    }
+
+    dlt_daemon_timer_wheel_init(&daemon_local->timers, dlt_daemon_timer_now());
+
+#ifdef linux
+    /* non-blocking, rearming clears an expiry which was not read yet */
+    local_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+    if (local_fd < 0) {
+        dlt_vlog(LOG_ERR, "timerfd_create failed: %s\n", strerror(errno));
+        return -1;
+    }
+#elif __QNX__
+    if (0 != pipe(dlt_timer_pipe)) {
+        dlt_log(LOG_ERR, "Failed to create pipe for timer wheel\n");
+        return -1;
+    }
+
+    if (0 != pthread_create(&timer_thread_id, NULL, &timer_thread, NULL)) {
+        dlt_log(LOG_ERR, "Failed to create thread for timer wheel!\n");
+        close_pipes(dlt_timer_pipe);
+        timer_thread_id = 0;
+        return -1;
+    }
+
+    local_fd = dlt_timer_pipe[0];
+#endif
+
+    return dlt_connection_create(daemon_local,
+                                 &daemon_local->pEvent,
+                                 local_fd,
+                                 POLLIN,
+                                 DLT_CONNECTION_TIMER);
+}
+
+int dlt_daemon_timer_schedule(DltDaemonLocal *daemon_local,
+                              DltDaemonTimer *timer,
+                              int timeout_ms,
+                              int period_ms,
+                              DltDaemonTimerCallback callback,
+                              void *data)
+{
+    uint64_t now = dlt_daemon_timer_now();
+
+    if ((daemon_local == NULL) || (timer == NULL) || (timeout_ms < 0) || (period_ms < 0)) {
+        dlt_vlog(LOG_ERR, "%s: invalid parameters\n", __func__);
+        return -1;
+    }
+
+    /* an idle wheel starts at the current time */
+    if ((daemon_local->timers.count == 0) && (daemon_local->timers.now < now))
+        daemon_local->timers.now = now;
+
+    if (dlt_daemon_timer_add(&daemon_local->timers,
+                             timer,
+                             now + (uint64_t)timeout_ms,
+                             (uint32_t)period_ms,
+                             callback,
+                             data) != 0)
+        return -1;
+
+    dlt_daemon_timer_rearm(daemon_local);
+
+    return 0;
+}
+
+int dlt_daemon_start_timer(DltDaemonLocal *daemon_local,
+                           int period_sec,
+                           int starts_in,
+                           DltTimers timer_id)
+{
     char *timer_name = NULL;
 
     if (timer_id >= DLT_TIMER_UNKNOWN) {
@@ -5655,72 +5777,49 @@ int create_timer_fd(DltDaemonLocal *daemon_local,
     if ((period_sec <= 0) || (starts_in <= 0)) {
         /* timer not activated via the service file */
         dlt_vlog(LOG_INFO, "<%s> not set: period=0\n", timer_name);
-        local_fd = DLT_FD_INIT;
+        return 0;
     }
-    else {
-#ifdef linux
-        struct itimerspec l_timer_spec;
-        local_fd = timerfd_create(CLOCK_MONOTONIC, 0);
-
-        if (local_fd < 0)
-            dlt_vlog(LOG_WARNING, "<%s> timerfd_create failed: %s\n",
-                     timer_name, strerror(errno));
 
-        l_timer_spec.it_interval.tv_sec = period_sec;
-        l_timer_spec.it_interval.tv_nsec = 0;
-        l_timer_spec.it_value.tv_sec = starts_in;
-        l_timer_spec.it_value.tv_nsec = 0;
+    if (dlt_daemon_timer_schedule(daemon_local,
+                                  &dlt_timers[timer_id],
+                                  starts_in * 1000,
+                                  period_sec * 1000,
+                                  dlt_timer_callbacks[timer_id],
+                                  NULL) != 0) {
+        dlt_vlog(LOG_WARNING, "<%s> could not be started\n", timer_name);
+        return -1;
+    }
 
-        if (timerfd_settime(local_fd, 0, &l_timer_spec, NULL) < 0) {
-            dlt_vlog(LOG_WARNING, "<%s> timerfd_settime failed: %s\n",
-                     timer_name, strerror(errno));
-            local_fd = DLT_FD_INIT;
-        }
-#elif __QNX__
-        /*
-         * Since timerfd is not valid in QNX, new threads are introduced
-         * to manage timers and communicate with main thread when timer expires.
-         */
-        if(0 != pipe(dlt_timer_pipes[timer_id])) {
-            dlt_vlog(LOG_ERR, "Failed to create pipe for timer [%s]",
-                    dlt_timer_names[timer_id]);
-            return -1;
-        }
-        if (NULL == timer_data[timer_id]) {
-            timer_data[timer_id] = calloc(1, sizeof(DltDaemonPeriodicData));
-            if (NULL == timer_data[timer_id]) {
-                dlt_vlog(LOG_ERR, "Failed to allocate memory for timer_data [%s]!\n",
-                         dlt_timer_names[timer_id]);
-                close_pipes(dlt_timer_pipes[timer_id]);
-                return -1;
-            }
-        }
+    return 0;
+}
 
-        timer_data[timer_id]->timer_id = timer_id;
-        timer_data[timer_id]->period_sec = period_sec;
-        timer_data[timer_id]->starts_in = starts_in;
-        timer_data[timer_id]->wakeups_missed = 0;
+int dlt_daemon_process_timers(DltDaemon *daemon,
+                              DltDaemonLocal *daemon_local,
+                              DltReceiver *receiver,
+                              int verbose)
+{
+    DltDaemonTimerContext context;
+    uint64_t expir = 0;
 
-        if (0 != pthread_create(&timer_threads[timer_id], NULL,
-                            &timer_thread, (void*)timer_data[timer_id])) {
-            dlt_vlog(LOG_ERR, "Failed to create new thread for timer [%s]!\n",
-                                     dlt_timer_names[timer_id]);
-            /* Clean up timer before returning */
-            close_pipes(dlt_timer_pipes[timer_id]);
-            free(timer_data[timer_id]);
-            timer_data[timer_id] = NULL;
+    PRINT_FUNCTION_VERBOSE(verbose);
 
-            return -1;
-        }
-        local_fd = dlt_timer_pipes[timer_id][0];
-#endif
+    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: invalid parameters\n", __func__);
+        return -1;
     }
 
-    return dlt_connection_create(daemon_local,
-                                 &daemon_local->pEvent,
-                                 local_fd,
-                                 POLLIN,
-                                 dlt_timer_conn_types[timer_id]);
+    /* the expiry count is not needed, the wheel compares against the clock */
+    if ((read(receiver->fd, &expir, sizeof(expir)) < 0) && (errno != EAGAIN))
+        dlt_vlog(LOG_WARNING, "%s: Fail to read timer (%s)\n", __func__, strerror(errno));
+
+    context.daemon = daemon;
+    context.daemon_local = daemon_local;
+    context.verbose = verbose;
+
+    dlt_daemon_timer_wheel_advance(&daemon_local->timers, dlt_daemon_timer_now(), &context);
+    dlt_daemon_timer_rearm(daemon_local);
+
+    return 0;
 }
 
 /* Close connection function */
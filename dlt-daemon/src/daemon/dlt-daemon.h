@@ -75,6 +75,7 @@
 #include "dlt_user_shared.h"
 #include "dlt_user_shared_cfg.h"
 #include "dlt_daemon_event_handler_types.h"
+#include "dlt_daemon_timer.h"
 #include "dlt_gateway_types.h"
 #include "dlt_offline_trace.h"
 
@@ -154,7 +155,17 @@ typedef struct
     DltBindAddress_t* ipNodes;                              /**< (String: BindAddress) The daemon accepts connections only on this list of IP addresses        */
     int  injectionMode;                                     /**< (Boolean) Injection mode                                                                      */
     int  protocolVersion;                                   /**< (int) Protocol version selected by user (1 or 2, 0=default)                                  */
+    int  clientCompressionFlushInterval;                    /**< (int) Maximum time in ms compressed client data is held back, 0 disables compression (Default: 100) */
 } DltDaemonFlags;
+/**
+ * Messages collected for all clients, see dlt_daemon_client_batch_begin().
+ */
+typedef struct
+{
+    uint8_t *buf;                   /**< buffer of the sender, NULL if not collecting */
+    int size;                       /**< size of the buffer                           */
+    int used;                       /**< bytes collected                              */
+} DltDaemonClientBatch;
 /**
  * The global parameters of a dlt daemon.
  */
@@ -163,11 +174,14 @@ typedef struct
     DltDaemonFlags flags;           /**< flags of the daemon                         */
     DltFile file;                   /**< struct for file access                      */
     DltEventHandler pEvent;         /**< struct for message producer event handling  */
+    DltDaemonTimerWheel timers;     /**< timers of the event loop                    */
     DltGateway pGateway;            /**< struct for passive node connection handling */
     DltMessage msg;                 /**< one dlt message                             */
     DltMessageV2 msgv2;             /**< one dlt v2 message                          */
     int client_connections;         /**< counter for nr. of client connections       */
+    int client_filters;             /**< counter for nr. of clients with a filter    */
     int client_connection_version;  /**< Connected client version                    */
+    DltDaemonClientBatch client_batch; /**< messages collected for all clients    */
     size_t baudrate;                /**< Baudrate of serial connection               */
 #ifdef DLT_SHM_ENABLE
     DltShm dlt_shm;                 /**< Shared memory handling              */
@@ -187,21 +201,15 @@ typedef struct
 #endif
 } DltDaemonLocal;
 
-typedef struct
-{
-    unsigned long long wakeups_missed;
-    int period_sec;
-    int starts_in;
-    int timer_id;
-} DltDaemonPeriodicData;
-
+/**
+ * Context passed to the callbacks of the daemon timers.
+ */
 typedef struct
 {
     DltDaemon *daemon;
     DltDaemonLocal *daemon_local;
-} DltDaemonTimingPacketThreadData;
-
-typedef DltDaemonTimingPacketThreadData DltDaemonECUVersionThreadData;
+    int verbose;
+} DltDaemonTimerContext;
 
 #define DLT_DAEMON_ERROR_OK               0
 #define DLT_DAEMON_ERROR_UNKNOWN         -1
@@ -230,9 +238,14 @@ int dlt_daemon_process_client_messages_serial(DltDaemon *daemon,
                                               DltReceiver *recv,
                                               int verbose);
 int dlt_daemon_process_user_messages(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
-int dlt_daemon_process_one_s_timer(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
-int dlt_daemon_process_sixty_s_timer(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
-int dlt_daemon_process_systemd_timer(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
+int dlt_daemon_process_timers(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
+int dlt_daemon_process_storage_writer(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
+
+/* Timer callbacks, ctx is a DltDaemonTimerContext */
+void dlt_daemon_process_one_s_timer(DltDaemonTimer *timer, void *ctx);
+void dlt_daemon_process_sixty_s_timer(DltDaemonTimer *timer, void *ctx);
+void dlt_daemon_process_systemd_timer(DltDaemonTimer *timer, void *ctx);
+void dlt_daemon_process_compression_timer(DltDaemonTimer *timer, void *ctx);
 
 int dlt_daemon_process_control_connect(DltDaemon *daemon, DltDaemonLocal *daemon_local, DltReceiver *recv, int verbose);
 #if defined DLT_DAEMON_USE_UNIX_SOCKET_IPC || defined DLT_DAEMON_VSOCK_IPC_ENABLE
@@ -294,13 +307,42 @@ int dlt_daemon_process_user_message_marker(DltDaemon *daemon,
 
 int dlt_daemon_send_ringbuffer_to_client(DltDaemon *daemon, DltDaemonLocal *daemon_local, int verbose);
 int dlt_daemon_send_ringbuffer_to_client_v2(DltDaemon *daemon, DltDaemonLocal *daemon_local, int verbose);
-void dlt_daemon_timingpacket_thread(void *ptr);
-void dlt_daemon_ecu_version_thread(void *ptr);
-#if defined(DLT_SYSTEMD_WATCHDOG_ENABLE)
-void dlt_daemon_systemd_watchdog_thread(void *ptr);
-#endif
 
-int create_timer_fd(DltDaemonLocal *daemon_local, int period_sec, int starts_in, DltTimers timer);
+/**
+ * Create the timer wheel of the event loop, driven by one timerfd.
+ * @param daemon_local pointer to daemon local structure
+ * @return negative value if there was an error
+ */
+int dlt_daemon_timer_init(DltDaemonLocal *daemon_local);
+
+/**
+ * Start one of the periodic daemon timers.
+ * @param daemon_local pointer to daemon local structure
+ * @param period_sec period in seconds, the timer is not started if 0
+ * @param starts_in first expiry in seconds
+ * @param timer_id the timer
+ * @return negative value if there was an error
+ */
+int dlt_daemon_start_timer(DltDaemonLocal *daemon_local, int period_sec, int starts_in, DltTimers timer_id);
+
+/**
+ * Schedule a timer in the event loop, e.g. a timeout of a client connection
+ * or of a passive node. The timer is embedded in the owning structure and has
+ * to be cancelled with dlt_daemon_timer_cancel() before that is freed.
+ * @param daemon_local pointer to daemon local structure
+ * @param timer the timer
+ * @param timeout_ms first expiry in ms
+ * @param period_ms period in ms, 0 for a one-shot timer
+ * @param callback called with a DltDaemonTimerContext on expiry
+ * @param data owner data stored in the timer
+ * @return negative value if there was an error
+ */
+int dlt_daemon_timer_schedule(DltDaemonLocal *daemon_local,
+                              DltDaemonTimer *timer,
+                              int timeout_ms,
+                              int period_ms,
+                              DltDaemonTimerCallback callback,
+                              void *data);
 
 int dlt_daemon_close_socket(int sock, DltDaemon *daemon, DltDaemonLocal *daemon_local, int verbose);
 
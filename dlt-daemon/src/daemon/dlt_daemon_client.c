@@ -66,6 +66,7 @@
 
 #include "dlt_daemon_offline_logstorage.h"
 #include "dlt_gateway.h"
+#include "dlt_storage_writer.h"
 #ifdef UDP_CONNECTION_SUPPORT
 #   include "dlt_daemon_udp_socket.h"
 #endif
@@ -84,43 +85,91 @@ static inline int8_t getStatus(uint8_t request_log, int context_log)
     return (int8_t)((request_log <= context_log) ? request_log : context_log);
 }
 
-/** @brief Sends up to 2 messages to all the clients.
+/* Clients served by dlt_daemon_client_send_all_raw() */
+#define DLT_DAEMON_CLIENT_SEND_ALL       0 /**< every client whose filter matches the message */
+#define DLT_DAEMON_CLIENT_SEND_NO_FILTER 1 /**< clients without filter, data may hold several messages */
+#define DLT_DAEMON_CLIENT_SEND_FILTER    2 /**< clients with a filter matching the message */
+
+/** @brief Prepares a message to check the client filters against.
  *
- * Runs through the client list and sends the messages to them. If the message
- * transfer fails and the connection is a socket connection, the socket is closed.
- * Takes and release dlt_daemon_mutex.
+ * Only the header pointers and the payload size are set, they point into data1.
+ *
+ * @param msg The message to be prepared.
+ * @param data1 The first buffer of the message, starting with the standard header.
+ * @param size1 The size of the first buffer.
+ * @param size2 The size of the second buffer.
+ *
+ * @return 0 if the filters can be checked, -1 if the message is sent to all clients.
+ */
+static int dlt_daemon_client_filter_prepare(DltMessage *msg,
+                                            uint8_t *data1,
+                                            int size1,
+                                            int size2)
+{
+    int headersize;
+
+    if ((data1 == NULL) || (size1 < (int)sizeof(DltStandardHeader)) ||
+        ((data1[0] & DLT_HTYP_VERS) != DLT_HTYP_PROTOCOL_VERSION1))
+        return -1;
+
+    msg->standardheader = (DltStandardHeader *)data1;
+    msg->extendedheader = NULL;
+    headersize = (int)(sizeof(DltStandardHeader) +
+                       DLT_STANDARD_HEADER_EXTRA_SIZE(msg->standardheader->htyp));
+
+    if (DLT_IS_HTYP_UEH(msg->standardheader->htyp)) {
+        msg->extendedheader = (DltExtendedHeader *)(data1 + headersize);
+        headersize += (int)sizeof(DltExtendedHeader);
+    }
+
+    if (size1 < headersize)
+        return -1;
+
+    msg->datasize = size1 - headersize + size2;
+
+    return 0;
+}
+
+/** @brief Sends a buffer to all the clients.
+ *
+ * Runs through the client list and sends the data to them. If the transfer
+ * fails and the connection is a socket connection, the socket is closed.
+ * Clients which have set a filter only get the message if it matches; a
+ * message skipped this way counts as delivered.
  *
  * @param daemon Daemon structure needed for socket closure.
  * @param daemon_local Daemon local structure
- * @param data1 The first message to be sent.
- * @param size1 The size of the first message.
- * @param data2 The second message to be send.
- * @param size2 The second message size.
+ * @param data1 The first buffer to be sent.
+ * @param size1 The size of the first buffer.
+ * @param data2 The second buffer to be send.
+ * @param size2 The second buffer size.
+ * @param sendserialheader Whether the serial header has to be sent first.
+ * @param clients DLT_DAEMON_CLIENT_SEND_* selecting the clients.
  * @param verbose Needed for socket closure.
  *
- * @return The amount of data transferred.
+ * @return 1 if sent to at least one client, 0 otherwise.
  */
-static int dlt_daemon_client_send_all_multiple(DltDaemon *daemon,
-                                               DltDaemonLocal *daemon_local,
-                                               void *data1,
-                                               int size1,
-                                               void *data2,
-                                               int size2,
-                                               int verbose)
+static int dlt_daemon_client_send_all_raw(DltDaemon *daemon,
+                                          DltDaemonLocal *daemon_local,
+                                          void *data1,
+                                          int size1,
+                                          void *data2,
+                                          int size2,
+                                          int sendserialheader,
+                                          int clients,
+                                          int verbose)
 {
     int sent = 0;
     nfds_t i = 0;
     int ret = 0;
     DltConnection *temp = NULL;
+    DltMessage msg;
+    int filter_checked = 0;
     int type_mask =
         (DLT_CON_MASK_CLIENT_MSG_TCP | DLT_CON_MASK_CLIENT_MSG_SERIAL);
 
-    PRINT_FUNCTION_VERBOSE(verbose);
-
-    if ((daemon == NULL) || (daemon_local == NULL)) {
-        dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
-        return 0;
-    }
+    if ((clients != DLT_DAEMON_CLIENT_SEND_NO_FILTER) && (daemon_local->client_filters > 0))
+        filter_checked = (dlt_daemon_client_filter_prepare(&msg, data1, size1, size2) == 0);
 
     for (i = 0; i < daemon_local->pEvent.nfds; i++)
     {
@@ -140,12 +189,26 @@ static int dlt_daemon_client_send_all_multiple(DltDaemon *daemon,
             continue;
         }
 
+        if (temp->filter == NULL) {
+            if (clients == DLT_DAEMON_CLIENT_SEND_FILTER)
+                continue;
+        }
+        else if (clients == DLT_DAEMON_CLIENT_SEND_NO_FILTER) {
+            continue;
+        }
+        else if (filter_checked &&
+                 (dlt_message_filter_check(&msg, temp->filter, 0) != DLT_RETURN_TRUE)) {
+            /* not requested by this client */
+            sent = 1;
+            continue;
+        }
+
         ret = dlt_connection_send_multiple(temp,
                                            data1,
                                            size1,
                                            data2,
                                            size2,
-                                           daemon->sendserialheader);
+                                           sendserialheader);
 
         if ((ret != DLT_DAEMON_ERROR_OK) &&
             (DLT_CONNECTION_CLIENT_MSG_TCP == temp->type)) {
@@ -164,6 +227,168 @@ static int dlt_daemon_client_send_all_multiple(DltDaemon *daemon,
             sent = 1;
     } /* for */
 
+    return sent;
+}
+
+void dlt_daemon_client_batch_begin(DltDaemonLocal *daemon_local,
+                                   uint8_t *buf,
+                                   int size)
+{
+    if (daemon_local == NULL)
+        return;
+
+    daemon_local->client_batch.buf = buf;
+    daemon_local->client_batch.size = size;
+    daemon_local->client_batch.used = 0;
+}
+
+int dlt_daemon_client_batch_flush(DltDaemon *daemon,
+                                  DltDaemonLocal *daemon_local,
+                                  int verbose)
+{
+    DltDaemonClientBatch *batch = NULL;
+    int sent = 0;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (daemon_local == NULL))
+        return 0;
+
+    batch = &daemon_local->client_batch;
+
+    if ((batch->buf != NULL) && (batch->used > 0))
+        sent = dlt_daemon_client_send_all_raw(daemon,
+                                              daemon_local,
+                                              batch->buf,
+                                              batch->used,
+                                              NULL,
+                                              0,
+                                              0,
+                                              DLT_DAEMON_CLIENT_SEND_NO_FILTER,
+                                              verbose);
+
+    batch->buf = NULL;
+    batch->size = 0;
+    batch->used = 0;
+
+    return sent;
+}
+
+/** @brief Appends a message to the client batch buffer.
+ *
+ * The buffer is flushed first if the message does not fit anymore.
+ *
+ * @return 1 if the message was added, 0 if it is too large to be batched.
+ */
+static int dlt_daemon_client_batch_add(DltDaemon *daemon,
+                                       DltDaemonLocal *daemon_local,
+                                       void *data1,
+                                       int size1,
+                                       void *data2,
+                                       int size2,
+                                       int verbose)
+{
+    DltDaemonClientBatch *batch = &daemon_local->client_batch;
+    int serial = daemon->sendserialheader ? (int)sizeof(dltSerialHeader) : 0;
+    int size = serial + ((data1 != NULL) ? size1 : 0) + ((data2 != NULL) ? size2 : 0);
+
+    if ((batch->used > 0) && (batch->used + size > batch->size)) {
+        dlt_daemon_client_send_all_raw(daemon,
+                                       daemon_local,
+                                       batch->buf,
+                                       batch->used,
+                                       NULL,
+                                       0,
+                                       0,
+                                       DLT_DAEMON_CLIENT_SEND_NO_FILTER,
+                                       verbose);
+        batch->used = 0;
+    }
+
+    /* keep the order: pending messages are flushed already */
+    if (size > batch->size)
+        return 0;
+
+    if (serial > 0) {
+        memcpy(batch->buf + batch->used, dltSerialHeader, (size_t)serial);
+        batch->used += serial;
+    }
+
+    if ((data1 != NULL) && (size1 > 0)) {
+        memcpy(batch->buf + batch->used, data1, (size_t)size1);
+        batch->used += size1;
+    }
+
+    if ((data2 != NULL) && (size2 > 0)) {
+        memcpy(batch->buf + batch->used, data2, (size_t)size2);
+        batch->used += size2;
+    }
+
+    return 1;
+}
+
+/** @brief Sends up to 2 messages to all the clients.
+ *
+ * Runs through the client list and sends the messages to them. If the message
+ * transfer fails and the connection is a socket connection, the socket is closed.
+ * Takes and release dlt_daemon_mutex.
+ *
+ * @param daemon Daemon structure needed for socket closure.
+ * @param daemon_local Daemon local structure
+ * @param data1 The first message to be sent.
+ * @param size1 The size of the first message.
+ * @param data2 The second message to be send.
+ * @param size2 The second message size.
+ * @param verbose Needed for socket closure.
+ *
+ * @return The amount of data transferred.
+ */
+static int dlt_daemon_client_send_all_multiple(DltDaemon *daemon,
+                                               DltDaemonLocal *daemon_local,
+                                               void *data1,
+                                               int size1,
+                                               void *data2,
+                                               int size2,
+                                               int verbose)
+{
+    int sent = 0;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (daemon_local == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
+        return 0;
+    }
+
+    if ((daemon_local->client_batch.buf != NULL) && (daemon_local->client_connections > 0) &&
+        dlt_daemon_client_batch_add(daemon, daemon_local, data1, size1,
+                                    data2, size2, verbose)) {
+        /* delivered with the next flush, except to clients with a filter */
+        sent = 1;
+
+        if (daemon_local->client_filters > 0)
+            dlt_daemon_client_send_all_raw(daemon,
+                                           daemon_local,
+                                           data1,
+                                           size1,
+                                           data2,
+                                           size2,
+                                           daemon->sendserialheader,
+                                           DLT_DAEMON_CLIENT_SEND_FILTER,
+                                           verbose);
+    }
+    else {
+        sent = dlt_daemon_client_send_all_raw(daemon,
+                                              daemon_local,
+                                              data1,
+                                              size1,
+                                              data2,
+                                              size2,
+                                              daemon->sendserialheader,
+                                              DLT_DAEMON_CLIENT_SEND_ALL,
+                                              verbose);
+    }
+
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
     if (sent)
     {
@@ -206,9 +431,16 @@ int dlt_daemon_client_send(int sock,
                 return ret;
             }
         } else {
-            if ((ret =
-                     dlt_daemon_socket_send(sock, data1, size1, data2, size2,
-                                            (char)daemon->sendserialheader))) {
+            DltConnection *con = dlt_event_handler_find_connection(&(daemon_local->pEvent), sock);
+
+            /* a compressed stream must not be interrupted by plain data */
+            if ((con != NULL) && (con->compression != NULL))
+                ret = dlt_connection_send_multiple(con, data1, size1, data2, size2, daemon->sendserialheader);
+            else
+                ret = dlt_daemon_socket_send(sock, data1, size1, data2, size2,
+                                             (char)daemon->sendserialheader);
+
+            if (ret) {
                 dlt_vlog(LOG_WARNING, "%s: socket send dlt message failed\n", __func__);
                 return ret;
             }
@@ -358,9 +590,16 @@ int dlt_daemon_client_send_v2(int sock,
                 return ret;
             }
         } else {
-            if ((ret =
-                     dlt_daemon_socket_send(sock, data1, size1, data2, size2,
-                                            (char)daemon->sendserialheader))) {
+            DltConnection *con = dlt_event_handler_find_connection(&(daemon_local->pEvent), sock);
+
+            /* a compressed stream must not be interrupted by plain data */
+            if ((con != NULL) && (con->compression != NULL))
+                ret = dlt_connection_send_multiple(con, data1, size1, data2, size2, daemon->sendserialheader);
+            else
+                ret = dlt_daemon_socket_send(sock, data1, size1, data2, size2,
+                                             (char)daemon->sendserialheader);
+
+            if (ret) {
                 dlt_vlog(LOG_WARNING, "%s: socket send dlt message failed\n", __func__);
                 return ret;
             }
@@ -1029,6 +1268,10 @@ int dlt_daemon_client_process_control(int sock,
         {
             if (dlt_daemon_applications_save(daemon, daemon->runtime_application_cfg, verbose) == 0) {
                 if (dlt_daemon_contexts_save(daemon, daemon->runtime_context_cfg, verbose) == 0) {
+                    /* the snapshot only speeds up the next start, the text files are complete */
+                    if (dlt_daemon_runtime_snapshot_save(daemon, daemon->runtime_snapshot, verbose) != 0)
+                        dlt_log(LOG_WARNING, "Cannot save runtime configuration snapshot\n");
+
                     dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_OK,
                                                         verbose);
                 }
@@ -1212,6 +1455,16 @@ int dlt_daemon_client_process_control(int sock,
             dlt_daemon_control_set_all_trace_status(sock, daemon, daemon_local, msg, verbose);
             break;
         }
+        case DLT_SERVICE_ID_SET_CLIENT_FILTER:
+        {
+            dlt_daemon_control_set_client_filter(sock, daemon, daemon_local, msg, verbose);
+            break;
+        }
+        case DLT_SERVICE_ID_SET_CLIENT_COMPRESSION:
+        {
+            dlt_daemon_control_set_client_compression(sock, daemon, daemon_local, msg, verbose);
+            break;
+        }
         default:
         {
             dlt_daemon_control_service_response(sock,
@@ -1727,14 +1980,23 @@ void dlt_daemon_control_get_default_log_level_v2(int sock, DltDaemon *daemon, Dl
     dlt_message_free_v2(&msg, 0);
 }
 
-void dlt_daemon_control_get_log_info(int sock,
-                                     DltDaemon *daemon,
-                                     DltDaemonLocal *daemon_local,
-                                     DltMessage *msg,
-                                     int verbose)
+/**
+ * Serialize the get_log_info response payload for a request.
+ * Besides the payload the start offset of every application record is
+ * stored, so that large responses can be split at application boundaries.
+ * @param daemon pointer to dlt daemon structure
+ * @param user_list registered users of the daemon ECU
+ * @param req validated get_log_info request
+ * @param entry cache entry to be filled
+ * @param verbose if set to true verbose information is printed out.
+ * @return 0 on success, -1 otherwise
+ */
+static int dlt_daemon_control_build_log_info(DltDaemon *daemon,
+                                             DltDaemonRegisteredUsers *user_list,
+                                             DltServiceGetLogInfoRequest *req,
+                                             DltDaemonLogInfoCache *entry,
+                                             int verbose)
 {
-    DltServiceGetLogInfoRequest *req;
-    DltMessage resp;
     DltDaemonContext *context = 0;
     DltDaemonApplication *application = 0;
 
@@ -1747,6 +2009,9 @@ void dlt_daemon_control_get_log_info(int sock,
 
     int32_t i, j;
     size_t offset = 0;
+    size_t datasize = 0;
+    uint8_t *databuffer = NULL;
+    size_t *app_offsets = NULL;
     char *apid = 0;
     int8_t ll, ts;
     uint16_t len;
@@ -1756,46 +2021,6 @@ void dlt_daemon_control_get_log_info(int sock,
 
     uint32_t sid;
 
-    DltDaemonRegisteredUsers *user_list = NULL;
-
-    PRINT_FUNCTION_VERBOSE(verbose);
-
-    if ((daemon == NULL) || (msg == NULL) || (msg->databuffer == NULL))
-        return;
-
-    if (dlt_check_rcv_data_size(msg->datasize, sizeof(DltServiceGetLogInfoRequest)) < 0)
-        return;
-
-    user_list = dlt_daemon_find_users_list(daemon, daemon->ecuid, verbose);
-
-    if (user_list == NULL)
-        return;
-
-    /* prepare pointer to message request */
-    req = (DltServiceGetLogInfoRequest *)(msg->databuffer);
-
-    /* initialise new message */
-    if (dlt_message_init(&resp, 0) == DLT_RETURN_ERROR) {
-        dlt_daemon_control_service_response(sock,
-                                            daemon,
-                                            daemon_local,
-                                            DLT_SERVICE_ID_GET_LOG_INFO,
-                                            DLT_SERVICE_RESPONSE_ERROR,
-                                            verbose);
-        return;
-    }
-
-    /* check request */
-    if ((req->options < 3) || (req->options > 7)) {
-        dlt_daemon_control_service_response(sock,
-                                            daemon,
-                                            daemon_local,
-                                            DLT_SERVICE_ID_GET_LOG_INFO,
-                                            DLT_SERVICE_RESPONSE_ERROR,
-                                            verbose);
-        return;
-    }
-
     if (req->apid[0] != '\0') {
         application = dlt_daemon_application_find(daemon,
                                                   req->apid,
@@ -1832,7 +2057,7 @@ void dlt_daemon_control_get_log_info(int sock,
     /* prepare payload of data */
 
     /* Calculate maximum size for a response */
-    resp.datasize = sizeof(uint32_t) /* SID */ + sizeof(int8_t) /* status*/ + sizeof(ID4) /* DLT_DAEMON_REMO_STRING */;
+    datasize = sizeof(uint32_t) /* SID */ + sizeof(int8_t) /* status*/ + sizeof(ID4) /* DLT_DAEMON_REMO_STRING */;
 
     sizecont = sizeof(uint32_t) /* context_id */;
 
@@ -1844,10 +2069,10 @@ void dlt_daemon_control_get_log_info(int sock,
     if ((req->options == 5) || (req->options == 6) || (req->options == 7))
         sizecont += sizeof(int8_t); /* trace status */
 
-    resp.datasize += (int32_t)(((size_t) num_applications * (sizeof(uint32_t) + sizeof(uint16_t))) +
-        ((size_t) num_contexts * sizecont));
+    datasize += ((size_t) num_applications * (sizeof(uint32_t) + sizeof(uint16_t))) +
+        ((size_t) num_contexts * sizecont);
 
-    resp.datasize += (int32_t)sizeof(uint16_t);
+    datasize += sizeof(uint16_t);
 
     /* Add additional size for response of Mode 7 */
     if (req->options == 7) {
@@ -1856,10 +2081,10 @@ void dlt_daemon_control_get_log_info(int sock,
                 /* One application, one context */
                 /* context = dlt_daemon_context_find(daemon, req->apid, req->ctid, verbose); */
                 if (context) {
-                    resp.datasize += (int32_t)sizeof(uint16_t);
+                    datasize += sizeof(uint16_t);
 
                     if (context->context_description != 0)
-                        resp.datasize += (int32_t)strlen(context->context_description);
+                        datasize += strlen(context->context_description);
                 }
             }
             else
@@ -1877,77 +2102,71 @@ void dlt_daemon_control_get_log_info(int sock,
                     context = &(user_list->contexts[offset_base + j]);
 
                     if (context) {
-                        resp.datasize += (int32_t)sizeof(uint16_t);
+                        datasize += sizeof(uint16_t);
 
                         if (context->context_description != 0)
-                            resp.datasize += (int32_t)strlen(context->context_description);
+                            datasize += strlen(context->context_description);
                     }
                 }
             }
 
             /* Space for application description */
             if (application) {
-                resp.datasize += (int32_t)sizeof(uint16_t);
+                datasize += sizeof(uint16_t);
 
                 if (application->application_description != 0)
-                    resp.datasize += (int32_t)strlen(application->application_description);
+                    datasize += strlen(application->application_description);
             }
         }
         else {
             /* All applications, all contexts */
             for (i = 0; i < user_list->num_contexts; i++) {
-                resp.datasize += (int32_t)sizeof(uint16_t);
+                datasize += sizeof(uint16_t);
 
                 if (user_list->contexts[i].context_description != 0)
-                    resp.datasize +=
-                        (int32_t)strlen(user_list->contexts[i].context_description);
+                    datasize += strlen(user_list->contexts[i].context_description);
             }
 
             for (i = 0; i < user_list->num_applications; i++) {
-                resp.datasize += (int32_t)sizeof(uint16_t);
+                datasize += sizeof(uint16_t);
 
                 if (user_list->applications[i].application_description != 0)
-                    resp.datasize += (int32_t)strlen(user_list->applications[i].application_description);
+                    datasize += strlen(user_list->applications[i].application_description);
             }
         }
     }
 
     if (verbose)
         dlt_vlog(LOG_DEBUG,
-                 "Allocate %u bytes for response msg databuffer\n",
-                 resp.datasize);
+                 "Allocate %zu bytes for response msg databuffer\n",
+                 datasize);
+
+    count_app_ids = (uint16_t) num_applications;
 
     /* Allocate buffer for response message */
-    resp.databuffer = (uint8_t *)malloc((size_t)resp.datasize);
-    resp.databuffersize = (size_t)resp.datasize;
+    databuffer = (uint8_t *)calloc(1, datasize);
+    app_offsets = (size_t *)calloc((size_t)count_app_ids + 1, sizeof(size_t));
 
-    if (resp.databuffer == 0) {
-        dlt_daemon_control_service_response(sock,
-                                            daemon,
-                                            daemon_local,
-                                            DLT_SERVICE_ID_GET_LOG_INFO,
-                                            DLT_SERVICE_RESPONSE_ERROR,
-                                            verbose);
-        return;
+    if ((databuffer == NULL) || (app_offsets == NULL)) {
+        free(databuffer);
+        free(app_offsets);
+        return -1;
     }
 
-    memset(resp.databuffer, 0, (size_t)resp.datasize);
     /* Preparation finished */
 
     /* Prepare response */
     sid = DLT_SERVICE_ID_GET_LOG_INFO;
-    memcpy(resp.databuffer, &sid, sizeof(uint32_t));
+    memcpy(databuffer, &sid, sizeof(uint32_t));
     offset += sizeof(uint32_t);
 
     value = (int8_t) (((num_applications != 0) && (num_contexts != 0)) ? req->options : 8); /* 8 = no matching context found */
 
-    memcpy(resp.databuffer + offset, &value, sizeof(int8_t));
+    memcpy(databuffer + offset, &value, sizeof(int8_t));
     offset += sizeof(int8_t);
 
-    count_app_ids = (uint16_t) num_applications;
-
     if (count_app_ids != 0) {
-        memcpy(resp.databuffer + offset, &count_app_ids, sizeof(uint16_t));
+        memcpy(databuffer + offset, &count_app_ids, sizeof(uint16_t));
         offset += sizeof(uint16_t);
 
 #if (DLT_DEBUG_GETLOGINFO == 1)
@@ -1955,6 +2174,8 @@ void dlt_daemon_control_get_log_info(int sock,
 #endif
 
         for (i = 0; i < count_app_ids; i++) {
+            app_offsets[i] = offset;
+
             if (req->apid[0] != '\0') {
                 apid = req->apid;
             }
@@ -1978,7 +2199,7 @@ void dlt_daemon_control_get_log_info(int sock,
                 for (j = 0; j < (application - (user_list->applications)); j++)
                     offset_base += user_list->applications[j].num_contexts;
 
-                dlt_set_id((char *)(resp.databuffer + offset), apid);
+                dlt_set_id((char *)(databuffer + offset), apid);
                 offset += sizeof(ID4);
 
 #if (DLT_DEBUG_GETLOGINFO == 1)
@@ -1991,7 +2212,7 @@ void dlt_daemon_control_get_log_info(int sock,
                 else
                     count_con_ids = (uint16_t) application->num_contexts;
 
-                memcpy(resp.databuffer + offset, &count_con_ids, sizeof(uint16_t));
+                memcpy(databuffer + offset, &count_con_ids, sizeof(uint16_t));
                 offset += sizeof(uint16_t);
 
 #if (DLT_DEBUG_GETLOGINFO == 1)
@@ -2014,7 +2235,7 @@ void dlt_daemon_control_get_log_info(int sock,
                         ((req->ctid[0] == '\0') || ((req->ctid[0] != '\0') &&
                                                     (memcmp(context->ctid, req->ctid, DLT_ID_SIZE) == 0)))
                         ) {
-                        dlt_set_id((char *)(resp.databuffer + offset), context->ctid);
+                        dlt_set_id((char *)(databuffer + offset), context->ctid);
                         offset += sizeof(ID4);
 
 #if (DLT_DEBUG_GETLOGINFO == 1)
@@ -2022,77 +2243,390 @@ void dlt_daemon_control_get_log_info(int sock,
                         dlt_vlog(LOG_DEBUG, "ctid: %s \n", buf);
 #endif
 
-                        /* Mode 4, 6, 7 */
-                        if ((req->options == 4) || (req->options == 6) || (req->options == 7)) {
-                            ll = context->log_level;
-                            memcpy(resp.databuffer + offset, &ll, sizeof(int8_t));
-                            offset += sizeof(int8_t);
-                        }
+                        /* Mode 4, 6, 7 */
+                        if ((req->options == 4) || (req->options == 6) || (req->options == 7)) {
+                            ll = context->log_level;
+                            memcpy(databuffer + offset, &ll, sizeof(int8_t));
+                            offset += sizeof(int8_t);
+                        }
+
+                        /* Mode 5, 6, 7 */
+                        if ((req->options == 5) || (req->options == 6) || (req->options == 7)) {
+                            ts = context->trace_status;
+                            memcpy(databuffer + offset, &ts, sizeof(int8_t));
+                            offset += sizeof(int8_t);
+                        }
+
+                        /* Mode 7 */
+                        if (req->options == 7) {
+                            if (context->context_description) {
+                                len = (uint16_t) strlen(context->context_description);
+                                memcpy(databuffer + offset, &len, sizeof(uint16_t));
+                                offset += sizeof(uint16_t);
+                                memcpy(databuffer + offset, context->context_description,
+                                       strlen(context->context_description));
+                                offset += strlen(context->context_description);
+                            }
+                            else {
+                                len = 0;
+                                memcpy(databuffer + offset, &len, sizeof(uint16_t));
+                                offset += sizeof(uint16_t);
+                            }
+                        }
+
+#if (DLT_DEBUG_GETLOGINFO == 1)
+                        dlt_vlog(LOG_DEBUG, "ll=%d ts=%d \n", (int32_t)ll,
+                                 (int32_t)ts);
+#endif
+                    }
+
+#if (DLT_DEBUG_GETLOGINFO == 1)
+                    dlt_log(LOG_DEBUG, "\n");
+#endif
+                }
+
+                /* Mode 7 */
+                if (req->options == 7) {
+                    if (application->application_description) {
+                        len = (uint16_t) strlen(application->application_description);
+                        memcpy(databuffer + offset, &len, sizeof(uint16_t));
+                        offset += sizeof(uint16_t);
+                        memcpy(databuffer + offset, application->application_description,
+                               strlen(application->application_description));
+                        offset += strlen(application->application_description);
+                    }
+                    else {
+                        len = 0;
+                        memcpy(databuffer + offset, &len, sizeof(uint16_t));
+                        offset += sizeof(uint16_t);
+                    }
+                }
+            } /* if (application) */
+
+        } /* for (i=0;i<count_app_ids;i++) */
+
+    } /* if (count_app_ids!=0) */
+
+    app_offsets[count_app_ids] = offset;
+
+    dlt_set_id((char *)(databuffer + offset), DLT_DAEMON_REMO_STRING);
+
+    entry->payload = databuffer;
+    entry->size = datasize;
+    entry->app_offsets = app_offsets;
+    entry->num_apps = count_app_ids;
+
+    return 0;
+}
+
+/**
+ * Look up the cached get_log_info response for a request and build it if
+ * there is no valid one. Entries built for an older daemon generation are
+ * replaced first, otherwise the entries are recycled round robin.
+ * @param daemon pointer to dlt daemon structure
+ * @param user_list registered users of the daemon ECU
+ * @param req validated get_log_info request
+ * @param verbose if set to true verbose information is printed out.
+ * @return pointer to cache entry or NULL on error
+ */
+static DltDaemonLogInfoCache *dlt_daemon_control_get_log_info_cached(DltDaemon *daemon,
+                                                                     DltDaemonRegisteredUsers *user_list,
+                                                                     DltServiceGetLogInfoRequest *req,
+                                                                     int verbose)
+{
+    DltDaemonLogInfoCache *entry = NULL;
+    int i;
+
+    for (i = 0; i < DLT_DAEMON_LOGINFO_CACHE_SIZE; i++) {
+        entry = &daemon->loginfo_cache[i];
+
+        if ((entry->payload != NULL) &&
+            (entry->generation == daemon->loginfo_generation) &&
+            (entry->options == req->options) &&
+            (memcmp(entry->apid, req->apid, DLT_ID_SIZE) == 0) &&
+            (memcmp(entry->ctid, req->ctid, DLT_ID_SIZE) == 0))
+            return entry;
+    }
+
+    entry = NULL;
+
+    for (i = 0; i < DLT_DAEMON_LOGINFO_CACHE_SIZE; i++) {
+        if ((daemon->loginfo_cache[i].payload == NULL) ||
+            (daemon->loginfo_cache[i].generation != daemon->loginfo_generation)) {
+            entry = &daemon->loginfo_cache[i];
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        entry = &daemon->loginfo_cache[daemon->loginfo_cache_next];
+        daemon->loginfo_cache_next = (daemon->loginfo_cache_next + 1) % DLT_DAEMON_LOGINFO_CACHE_SIZE;
+    }
+
+    free(entry->payload);
+    free(entry->app_offsets);
+    memset(entry, 0, sizeof(DltDaemonLogInfoCache));
+
+    if (dlt_daemon_control_build_log_info(daemon, user_list, req, entry, verbose) != 0)
+        return NULL;
+
+    entry->generation = daemon->loginfo_generation;
+    entry->options = req->options;
+    memcpy(entry->apid, req->apid, DLT_ID_SIZE);
+    memcpy(entry->ctid, req->ctid, DLT_ID_SIZE);
+
+    return entry;
+}
+
+/**
+ * Remaining part of a get_log_info response which is too large for one
+ * message. The applications are sent in chunks, one per event loop
+ * iteration, so other clients are served in between. The payload and the
+ * record offsets are copied from the cache, which may be rebuilt meanwhile,
+ * and share one allocation with this structure.
+ */
+struct DltDaemonLogInfoStream
+{
+    uint8_t *payload;      /**< serialized response payload */
+    size_t size;           /**< size of payload in bytes */
+    size_t *app_offsets;   /**< start of each application record, plus end of the last one */
+    uint16_t num_apps;     /**< number of application records in payload */
+    uint16_t next;         /**< first application record not sent yet */
+};
+
+/**
+ * Send the next chunk of a get_log_info response: a complete response
+ * carrying as many application records as fit into one message, starting
+ * with record stream->next.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param stream response being sent, next is advanced
+ * @param verbose if set to true verbose information is printed out.
+ * @return 0 on success, -1 otherwise
+ */
+static int dlt_daemon_control_send_log_info_chunk(int sock,
+                                                  DltDaemon *daemon,
+                                                  DltDaemonLocal *daemon_local,
+                                                  struct DltDaemonLogInfoStream *stream,
+                                                  int verbose)
+{
+    DltMessage resp;
+    uint8_t *chunk = NULL;
+    size_t max_payload = UINT16_MAX - sizeof(DltStandardHeader) -
+        DLT_STANDARD_HEADER_EXTRA_SIZE(DLT_HTYP_WEID | DLT_HTYP_WTMS) - sizeof(DltExtendedHeader);
+    size_t head = sizeof(uint32_t) + sizeof(int8_t);
+    size_t records = 0;
+    uint16_t first = stream->next;
+    uint16_t last = (uint16_t)(first + 1);
+    uint16_t count = 0;
+    int ret = 0;
+
+    while ((last < stream->num_apps) &&
+           (head + sizeof(uint16_t) + (stream->app_offsets[last + 1] - stream->app_offsets[first]) +
+            sizeof(ID4) <= max_payload))
+        last++;
+
+    count = (uint16_t)(last - first);
+    records = stream->app_offsets[last] - stream->app_offsets[first];
+    stream->next = last;
+
+    if (dlt_message_init(&resp, 0) == DLT_RETURN_ERROR)
+        return -1;
+
+    /* a single chunk never exceeds the complete response */
+    chunk = (uint8_t *)malloc(head + sizeof(uint16_t) + records + sizeof(ID4));
+
+    if (chunk == NULL)
+        return -1;
+
+    memcpy(chunk, stream->payload, head); /* SID and status */
+    memcpy(chunk + head, &count, sizeof(uint16_t));
+    memcpy(chunk + head + sizeof(uint16_t), stream->payload + stream->app_offsets[first], records);
+    dlt_set_id((char *)(chunk + head + sizeof(uint16_t) + records), DLT_DAEMON_REMO_STRING);
+
+    resp.databuffer = chunk;
+    resp.databuffersize = (int32_t)(head + sizeof(uint16_t) + records + sizeof(ID4));
+    resp.datasize = resp.databuffersize;
+
+    if (verbose)
+        dlt_vlog(LOG_DEBUG, "Send log info applications %u..%u of %u\n",
+                 first, last - 1, stream->num_apps);
+
+    ret = dlt_daemon_client_send_control_message(sock, daemon, daemon_local, &resp, "", "", verbose);
+
+    free(chunk);
+    resp.databuffer = NULL;
+
+    return (ret == DLT_DAEMON_ERROR_OK) ? 0 : -1;
+}
+
+/* Timer callback sending the next chunk of a streamed get_log_info response */
+static void dlt_daemon_process_log_info_timer(DltDaemonTimer *timer, void *ctx)
+{
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltConnection *con = NULL;
+
+    if ((timer == NULL) || (timer->data == NULL) || (context == NULL) ||
+        (context->daemon == NULL) || (context->daemon_local == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
+        return;
+    }
+
+    PRINT_FUNCTION_VERBOSE(context->verbose);
+
+    con = (DltConnection *)timer->data;
+
+    if (con->loginfo == NULL)
+        return;
+
+    if ((dlt_daemon_control_send_log_info_chunk(con->receiver->fd, context->daemon, context->daemon_local,
+                                                con->loginfo, context->verbose) == 0) &&
+        (con->loginfo->next < con->loginfo->num_apps) &&
+        (dlt_daemon_timer_schedule(context->daemon_local, &con->loginfo_timer, 0, 0,
+                                   dlt_daemon_process_log_info_timer, con) == 0))
+        return;
+
+    free(con->loginfo);
+    con->loginfo = NULL;
+}
+
+/**
+ * Send a cached get_log_info response.
+ * Responses exceeding the maximum control message size are streamed as a
+ * sequence of complete responses, each carrying as many application records
+ * as fit into one message, instead of being discarded. The first chunk is
+ * sent right away, the others are queued on the connection and sent one per
+ * event loop iteration. A new request of the same connection replaces the
+ * rest of a response still being sent. Without a connection to queue on,
+ * e.g. when sending to all clients, all chunks are sent at once.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param entry cached response
+ * @param verbose if set to true verbose information is printed out.
+ * @return 0 on success, -1 otherwise
+ */
+static int dlt_daemon_control_send_log_info(int sock,
+                                            DltDaemon *daemon,
+                                            DltDaemonLocal *daemon_local,
+                                            const DltDaemonLogInfoCache *entry,
+                                            int verbose)
+{
+    DltMessage resp;
+    DltConnection *con = NULL;
+    struct DltDaemonLogInfoStream *stream = NULL;
+    size_t max_payload = UINT16_MAX - sizeof(DltStandardHeader) -
+        DLT_STANDARD_HEADER_EXTRA_SIZE(DLT_HTYP_WEID | DLT_HTYP_WTMS) - sizeof(DltExtendedHeader);
+    size_t offsets_size = ((size_t)entry->num_apps + 1) * sizeof(size_t);
+    int ret = 0;
+
+    if ((entry->size <= max_payload) || (entry->num_apps <= 1)) {
+        if (dlt_message_init(&resp, 0) == DLT_RETURN_ERROR)
+            return -1;
+
+        resp.databuffer = entry->payload;
+        resp.databuffersize = (int32_t)entry->size;
+        resp.datasize = (int32_t)entry->size;
+
+        ret = dlt_daemon_client_send_control_message(sock, daemon, daemon_local, &resp, "", "", verbose);
+
+        /* payload is owned by the cache */
+        resp.databuffer = NULL;
+        return (ret == DLT_DAEMON_ERROR_OK) ? 0 : -1;
+    }
+
+    stream = (struct DltDaemonLogInfoStream *)malloc(sizeof(struct DltDaemonLogInfoStream) + offsets_size +
+                                                     entry->size);
+
+    if (stream == NULL)
+        return -1;
+
+    stream->app_offsets = (size_t *)(stream + 1);
+    stream->payload = (uint8_t *)stream->app_offsets + offsets_size;
+    stream->size = entry->size;
+    stream->num_apps = entry->num_apps;
+    stream->next = 0;
+    memcpy(stream->app_offsets, entry->app_offsets, offsets_size);
+    memcpy(stream->payload, entry->payload, entry->size);
+
+    if (sock != DLT_DAEMON_SEND_TO_ALL)
+        con = dlt_event_handler_find_connection(&daemon_local->pEvent, sock);
+
+    ret = dlt_daemon_control_send_log_info_chunk(sock, daemon, daemon_local, stream, verbose);
+
+    if ((ret == 0) && (con != NULL) &&
+        (dlt_connection_get_next(daemon_local->pEvent.connections, DLT_CON_MASK_TIMER) != NULL)) {
+        free(con->loginfo);
+        con->loginfo = stream;
+
+        if (dlt_daemon_timer_schedule(daemon_local, &con->loginfo_timer, 0, 0,
+                                      dlt_daemon_process_log_info_timer, con) == 0)
+            return 0;
+
+        con->loginfo = NULL;
+    }
+
+    while ((ret == 0) && (stream->next < stream->num_apps))
+        ret = dlt_daemon_control_send_log_info_chunk(sock, daemon, daemon_local, stream, verbose);
+
+    free(stream);
+
+    return ret;
+}
+
+void dlt_daemon_control_get_log_info(int sock,
+                                     DltDaemon *daemon,
+                                     DltDaemonLocal *daemon_local,
+                                     DltMessage *msg,
+                                     int verbose)
+{
+    DltServiceGetLogInfoRequest *req;
+    DltDaemonLogInfoCache *entry = NULL;
+    DltDaemonRegisteredUsers *user_list = NULL;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
 
-                        /* Mode 5, 6, 7 */
-                        if ((req->options == 5) || (req->options == 6) || (req->options == 7)) {
-                            ts = context->trace_status;
-                            memcpy(resp.databuffer + offset, &ts, sizeof(int8_t));
-                            offset += sizeof(int8_t);
-                        }
+    if ((daemon == NULL) || (msg == NULL) || (msg->databuffer == NULL))
+        return;
 
-                        /* Mode 7 */
-                        if (req->options == 7) {
-                            if (context->context_description) {
-                                len = (uint16_t) strlen(context->context_description);
-                                memcpy(resp.databuffer + offset, &len, sizeof(uint16_t));
-                                offset += sizeof(uint16_t);
-                                memcpy(resp.databuffer + offset, context->context_description,
-                                       strlen(context->context_description));
-                                offset += strlen(context->context_description);
-                            }
-                            else {
-                                len = 0;
-                                memcpy(resp.databuffer + offset, &len, sizeof(uint16_t));
-                                offset += sizeof(uint16_t);
-                            }
-                        }
+    if (dlt_check_rcv_data_size(msg->datasize, sizeof(DltServiceGetLogInfoRequest)) < 0)
+        return;
 
-#if (DLT_DEBUG_GETLOGINFO == 1)
-                        dlt_vlog(LOG_DEBUG, "ll=%d ts=%d \n", (int32_t)ll,
-                                 (int32_t)ts);
-#endif
-                    }
+    user_list = dlt_daemon_find_users_list(daemon, daemon->ecuid, verbose);
 
-#if (DLT_DEBUG_GETLOGINFO == 1)
-                    dlt_log(LOG_DEBUG, "\n");
-#endif
-                }
+    if (user_list == NULL)
+        return;
 
-                /* Mode 7 */
-                if (req->options == 7) {
-                    if (application->application_description) {
-                        len = (uint16_t) strlen(application->application_description);
-                        memcpy(resp.databuffer + offset, &len, sizeof(uint16_t));
-                        offset += sizeof(uint16_t);
-                        memcpy(resp.databuffer + offset, application->application_description,
-                               strlen(application->application_description));
-                        offset += strlen(application->application_description);
-                    }
-                    else {
-                        len = 0;
-                        memcpy(resp.databuffer + offset, &len, sizeof(uint16_t));
-                        offset += sizeof(uint16_t);
-                    }
-                }
-            } /* if (application) */
+    /* prepare pointer to message request */
+    req = (DltServiceGetLogInfoRequest *)(msg->databuffer);
 
-        } /* for (i=0;i<count_app_ids;i++) */
+    /* check request */
+    if ((req->options < 3) || (req->options > 7)) {
+        dlt_daemon_control_service_response(sock,
+                                            daemon,
+                                            daemon_local,
+                                            DLT_SERVICE_ID_GET_LOG_INFO,
+                                            DLT_SERVICE_RESPONSE_ERROR,
+                                            verbose);
+        return;
+    }
 
-    } /* if (count_app_ids!=0) */
+    entry = dlt_daemon_control_get_log_info_cached(daemon, user_list, req, verbose);
 
-    dlt_set_id((char *)(resp.databuffer + offset), DLT_DAEMON_REMO_STRING);
+    if (entry == NULL) {
+        dlt_daemon_control_service_response(sock,
+                                            daemon,
+                                            daemon_local,
+                                            DLT_SERVICE_ID_GET_LOG_INFO,
+                                            DLT_SERVICE_RESPONSE_ERROR,
+                                            verbose);
+        return;
+    }
 
     /* send message */
-    dlt_daemon_client_send_control_message(sock, daemon, daemon_local, &resp, "", "", verbose);
-
-    /* free message */
-    dlt_message_free(&resp, 0);
+    if (dlt_daemon_control_send_log_info(sock, daemon, daemon_local, entry, verbose) != 0)
+        dlt_log(LOG_DEBUG, "dlt_daemon_control_get_log_info: sending response failed\n");
 }
 
 void dlt_daemon_control_get_log_info_v2(int sock,
@@ -3462,6 +3996,110 @@ void dlt_daemon_send_log_level_v2(int sock,
     }
 }
 
+/**
+ * Contexts matched by a wildcard set log level or trace status request which
+ * wait in a log level batch for being sent to their application.
+ */
+typedef struct
+{
+    DltDaemonLogLevelBatch batch;                             /**< log levels to be sent */
+    uint32_t count;                                           /**< number of collected contexts */
+    DltDaemonContext *contexts[DLT_USER_LOG_LEVEL_BATCH_MAX]; /**< collected contexts */
+    int8_t log_level[DLT_USER_LOG_LEVEL_BATCH_MAX];           /**< log levels restored on failure */
+    int8_t trace_status[DLT_USER_LOG_LEVEL_BATCH_MAX];        /**< trace states restored on failure */
+} DltDaemonWildcardBatch;
+
+/**
+ * Send the collected log levels with one message to the application and
+ * answer the request once per context, like for a single context.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param pending collected contexts, emptied
+ * @param service_id DLT_SERVICE_ID_SET_LOG_LEVEL or DLT_SERVICE_ID_SET_TRACE_STATUS
+ * @param verbose if set to true verbose information is printed out.
+ */
+static void dlt_daemon_wildcard_batch_flush(int sock,
+                                            DltDaemon *daemon,
+                                            DltDaemonLocal *daemon_local,
+                                            DltDaemonWildcardBatch *pending,
+                                            uint32_t service_id,
+                                            int verbose)
+{
+    int8_t status = DLT_SERVICE_RESPONSE_OK;
+    uint32_t i;
+
+    if (pending->count == 0)
+        return;
+
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &pending->batch, verbose) != 0) {
+        dlt_vlog(LOG_ERR, "%s could not be sent to %u contexts!\n",
+                 (service_id == DLT_SERVICE_ID_SET_LOG_LEVEL) ? "Log level" : "Trace status",
+                 pending->count);
+        status = DLT_SERVICE_RESPONSE_ERROR;
+    }
+
+    for (i = 0; i < pending->count; i++) {
+        if (status != DLT_SERVICE_RESPONSE_OK) {
+            pending->contexts[i]->log_level = pending->log_level[i];
+            pending->contexts[i]->trace_status = pending->trace_status[i];
+        }
+
+        dlt_daemon_control_service_response(sock, daemon, daemon_local, service_id, status, verbose);
+    }
+
+    pending->count = 0;
+}
+
+/**
+ * Set the log level or trace status of a context matched by a wildcard and
+ * collect it. The contexts are sorted by application, so the collected ones
+ * are sent whenever the next context belongs to another application.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param pending collected contexts
+ * @param context matched context
+ * @param service_id DLT_SERVICE_ID_SET_LOG_LEVEL or DLT_SERVICE_ID_SET_TRACE_STATUS
+ * @param value new log level or trace status
+ * @param verbose if set to true verbose information is printed out.
+ */
+static void dlt_daemon_wildcard_batch_add(int sock,
+                                          DltDaemon *daemon,
+                                          DltDaemonLocal *daemon_local,
+                                          DltDaemonWildcardBatch *pending,
+                                          DltDaemonContext *context,
+                                          uint32_t service_id,
+                                          int8_t value,
+                                          int verbose)
+{
+    if (context->user_handle < DLT_FD_MINIMUM) {
+        dlt_log(LOG_ERR, (service_id == DLT_SERVICE_ID_SET_LOG_LEVEL) ?
+                "Log level could not be sent!\n" : "Trace status could not be sent!\n");
+        dlt_daemon_control_service_response(sock, daemon, daemon_local, service_id,
+                                            DLT_SERVICE_RESPONSE_ERROR, verbose);
+        return;
+    }
+
+    if ((pending->count > 0) &&
+        ((pending->batch.user_handle != context->user_handle) || (pending->count >= DLT_USER_LOG_LEVEL_BATCH_MAX)))
+        dlt_daemon_wildcard_batch_flush(sock, daemon, daemon_local, pending, service_id, verbose);
+
+    pending->contexts[pending->count] = context;
+    pending->log_level[pending->count] = context->log_level;
+    pending->trace_status[pending->count] = context->trace_status;
+
+    if (service_id == DLT_SERVICE_ID_SET_LOG_LEVEL)
+        context->log_level = value; /* No endianess conversion necessary*/
+    else
+        context->trace_status = value;
+
+    pending->count++;
+
+    /* the batch is empty or belongs to the application of the context, nothing is sent here */
+    (void)dlt_daemon_user_log_level_batch_add(daemon, &pending->batch, context, verbose);
+}
+
 void dlt_daemon_find_multiple_context_and_send_log_level(int sock,
                                                          DltDaemon *daemon,
                                                          DltDaemonLocal *daemon_local,
@@ -3478,6 +4116,7 @@ void dlt_daemon_find_multiple_context_and_send_log_level(int sock,
     char src_str[DLT_ID_SIZE + 1] = { 0 };
     int ret = 0;
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonWildcardBatch pending;
 
     if (daemon == 0) {
         dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
@@ -3489,6 +4128,10 @@ void dlt_daemon_find_multiple_context_and_send_log_level(int sock,
     if (user_list == NULL)
         return;
 
+    /* one message per application instead of one per context */
+    dlt_daemon_user_log_level_batch_init(&pending.batch);
+    pending.count = 0;
+
     for (count = 0; count < user_list->num_contexts; count++) {
         context = &(user_list->contexts[count]);
 
@@ -3501,13 +4144,16 @@ void dlt_daemon_find_multiple_context_and_send_log_level(int sock,
             ret = strncmp(src_str, str, (size_t)len);
 
             if (ret == 0)
-                dlt_daemon_send_log_level(sock, daemon, daemon_local, context, loglevel, verbose);
+                dlt_daemon_wildcard_batch_add(sock, daemon, daemon_local, &pending, context,
+                                              DLT_SERVICE_ID_SET_LOG_LEVEL, loglevel, verbose);
             else if ((ret > 0) && (app_flag == 1))
                 break;
             else
                 continue;
         }
     }
+
+    dlt_daemon_wildcard_batch_flush(sock, daemon, daemon_local, &pending, DLT_SERVICE_ID_SET_LOG_LEVEL, verbose);
 }
 
 void dlt_daemon_find_multiple_context_and_send_log_level_v2(int sock,
@@ -3839,6 +4485,7 @@ void dlt_daemon_find_multiple_context_and_send_trace_status(int sock,
     char src_str[DLT_ID_SIZE + 1] = { 0 };
     int ret = 0;
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonWildcardBatch pending;
 
     if (daemon == 0) {
         dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
@@ -3850,6 +4497,10 @@ void dlt_daemon_find_multiple_context_and_send_trace_status(int sock,
     if (user_list == NULL)
         return;
 
+    /* one message per application instead of one per context */
+    dlt_daemon_user_log_level_batch_init(&pending.batch);
+    pending.count = 0;
+
     for (count = 0; count < user_list->num_contexts; count++) {
         context = &(user_list->contexts[count]);
 
@@ -3862,13 +4513,16 @@ void dlt_daemon_find_multiple_context_and_send_trace_status(int sock,
             ret = strncmp(src_str, str, (size_t)len);
 
             if (ret == 0)
-                dlt_daemon_send_trace_status(sock, daemon, daemon_local, context, tracestatus, verbose);
+                dlt_daemon_wildcard_batch_add(sock, daemon, daemon_local, &pending, context,
+                                              DLT_SERVICE_ID_SET_TRACE_STATUS, tracestatus, verbose);
             else if ((ret > 0) && (app_flag == 1))
                 break;
             else
                 continue;
         }
     }
+
+    dlt_daemon_wildcard_batch_flush(sock, daemon, daemon_local, &pending, DLT_SERVICE_ID_SET_TRACE_STATUS, verbose);
 }
 
 void dlt_daemon_find_multiple_context_and_send_trace_status_v2(int sock,
@@ -4458,6 +5112,145 @@ void dlt_daemon_control_set_timing_packets(int sock,
     }
 }
 
+void dlt_daemon_control_set_client_filter(int sock,
+                                          DltDaemon *daemon,
+                                          DltDaemonLocal *daemon_local,
+                                          DltMessage *msg,
+                                          int verbose)
+{
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    DltServiceSetClientFilter *req;
+    DltServiceClientFilterEntry entry;
+    DltConnection *con;
+    DltFilter *filter = NULL;
+    char apid[DLT_ID_SIZE + 1] = { 0 };
+    char ctid[DLT_ID_SIZE + 1] = { 0 };
+    uint32_t id = DLT_SERVICE_ID_SET_CLIENT_FILTER;
+    int i;
+
+    if ((daemon == NULL) || (daemon_local == NULL) || (msg == NULL) || (msg->databuffer == NULL))
+        return;
+
+    if (dlt_check_rcv_data_size(msg->datasize, sizeof(DltServiceSetClientFilter)) < 0)
+        return;
+
+    req = (DltServiceSetClientFilter *)(msg->databuffer);
+    con = dlt_event_handler_find_connection(&daemon_local->pEvent, sock);
+
+    /* only clients receiving the log stream can filter it */
+    if ((con == NULL) ||
+        ((con->type != DLT_CONNECTION_CLIENT_MSG_TCP) && (con->type != DLT_CONNECTION_CLIENT_MSG_SERIAL)) ||
+        (req->count > DLT_FILTER_MAX) ||
+        (dlt_check_rcv_data_size(msg->datasize,
+                                 (int)(sizeof(DltServiceSetClientFilter) +
+                                       req->count * sizeof(DltServiceClientFilterEntry))) < 0)) {
+        dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_ERROR, verbose);
+        return;
+    }
+
+    if (req->count > 0) {
+        filter = (DltFilter *)calloc(1, sizeof(DltFilter));
+
+        if (filter == NULL) {
+            dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_ERROR,
+                                                verbose);
+            return;
+        }
+
+        dlt_filter_init(filter, verbose);
+
+        for (i = 0; i < req->count; i++) {
+            memcpy(&entry,
+                   msg->databuffer + sizeof(DltServiceSetClientFilter) + (size_t)i * sizeof(DltServiceClientFilterEntry),
+                   sizeof(entry));
+            memcpy(apid, entry.apid, DLT_ID_SIZE);
+            memcpy(ctid, entry.ctid, DLT_ID_SIZE);
+
+            /* duplicates are merged */
+            dlt_filter_add(filter, apid, ctid, entry.log_level, entry.payload_min, entry.payload_max,
+                           verbose);
+        }
+
+        /* evaluated for every message sent to this client */
+        dlt_filter_compile(filter, verbose);
+    }
+
+    if (con->filter != NULL) {
+        dlt_filter_free(con->filter, verbose);
+        free(con->filter);
+        daemon_local->client_filters--;
+    }
+
+    con->filter = filter;
+
+    if (filter != NULL)
+        daemon_local->client_filters++;
+
+    dlt_vlog(LOG_INFO, "Client %d set %d filters\n", sock, req->count);
+    dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_OK, verbose);
+}
+
+/* Arm the timer flushing compressed client connections, 0 stops it */
+void dlt_daemon_control_set_client_compression(int sock,
+                                               DltDaemon *daemon,
+                                               DltDaemonLocal *daemon_local,
+                                               DltMessage *msg,
+                                               int verbose)
+{
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    DltServiceSetClientCompression *req;
+    DltConnection *con;
+    DltConnection *timer;
+    DltCompression *stream = NULL;
+    int interval;
+    uint32_t id = DLT_SERVICE_ID_SET_CLIENT_COMPRESSION;
+
+    if ((daemon == NULL) || (daemon_local == NULL) || (msg == NULL) || (msg->databuffer == NULL))
+        return;
+
+    if (dlt_check_rcv_data_size(msg->datasize, sizeof(DltServiceSetClientCompression)) < 0)
+        return;
+
+    req = (DltServiceSetClientCompression *)(msg->databuffer);
+    con = dlt_event_handler_find_connection(&daemon_local->pEvent, sock);
+
+    if ((con == NULL) || (con->type != DLT_CONNECTION_CLIENT_MSG_TCP) || (con->compression != NULL)) {
+        dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_ERROR, verbose);
+        return;
+    }
+
+    /* without the flush timer the latency would not be bounded */
+    timer = dlt_connection_get_next(daemon_local->pEvent.connections, DLT_CON_MASK_TIMER);
+    interval = daemon_local->flags.clientCompressionFlushInterval;
+
+    if ((timer != NULL) && (interval > 0))
+        stream = dlt_compression_create(req->method, true);
+
+    if (stream == NULL) {
+        dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_NOT_SUPPORTED,
+                                            verbose);
+        return;
+    }
+
+    /* the response is the last uncompressed data */
+    dlt_daemon_control_service_response(sock, daemon, daemon_local, id, DLT_SERVICE_RESPONSE_OK, verbose);
+
+    if (dlt_connection_set_compression(con, stream) != 0) {
+        dlt_vlog(LOG_ERR, "Compression for client %d failed, closing connection\n", sock);
+        dlt_compression_free(stream);
+        dlt_daemon_close_socket(sock, daemon, daemon_local, verbose);
+        return;
+    }
+
+    if (dlt_daemon_timer_schedule(daemon_local, &con->timer, interval, interval,
+                                  dlt_daemon_process_compression_timer, con) != 0)
+        dlt_vlog(LOG_WARNING, "%s: Fail to start flush timer of client %d\n", __func__, sock);
+
+    dlt_vlog(LOG_INFO, "Client %d uses compression method %u\n", sock, req->method);
+}
+
 void dlt_daemon_control_set_timing_packets_v2(int sock,
                                            DltDaemon *daemon,
                                            DltDaemonLocal *daemon_local,
@@ -4561,29 +5354,21 @@ void dlt_daemon_control_message_time(int sock, DltDaemon *daemon, DltDaemonLocal
     dlt_message_free(&msg, 0);
 }
 
-int dlt_daemon_process_one_s_timer(DltDaemon *daemon,
-                                   DltDaemonLocal *daemon_local,
-                                   DltReceiver *receiver,
-                                   int verbose)
+void dlt_daemon_process_one_s_timer(DltDaemonTimer *timer, void *ctx)
 {
-    uint64_t expir = 0;
-    ssize_t res = 0;
-
-    PRINT_FUNCTION_VERBOSE(verbose);
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltDaemon *daemon = NULL;
+    DltDaemonLocal *daemon_local = NULL;
 
-    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+    if ((timer == NULL) || (context == NULL) || (context->daemon == NULL) || (context->daemon_local == NULL)) {
         dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
-        return -1;
+        return;
     }
 
-    res = read(receiver->fd, &expir, sizeof(expir));
+    daemon = context->daemon;
+    daemon_local = context->daemon_local;
 
-    if (res < 0) {
-        dlt_vlog(LOG_WARNING, "%s: Fail to read timer (%s)\n", __func__,
-                 strerror(errno));
-        /* Activity received on timer_wd, but unable to read the fd:
-         * let's go on sending notification */
-    }
+    PRINT_FUNCTION_VERBOSE(context->verbose);
 
     if ((daemon->state == DLT_DAEMON_STATE_SEND_BUFFER) ||
         (daemon->state == DLT_DAEMON_STATE_BUFFER_FULL)) {
@@ -4602,33 +5387,23 @@ int dlt_daemon_process_one_s_timer(DltDaemon *daemon,
                                         daemon_local->flags.vflag);
 
     dlt_log(LOG_DEBUG, "Timer timingpacket\n");
-
-    return 0;
 }
 
-int dlt_daemon_process_sixty_s_timer(DltDaemon *daemon,
-                                     DltDaemonLocal *daemon_local,
-                                     DltReceiver *receiver,
-                                     int verbose)
+void dlt_daemon_process_sixty_s_timer(DltDaemonTimer *timer, void *ctx)
 {
-    uint64_t expir = 0;
-    ssize_t res = 0;
-
-    PRINT_FUNCTION_VERBOSE(verbose);
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltDaemon *daemon = NULL;
+    DltDaemonLocal *daemon_local = NULL;
 
-    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+    if ((timer == NULL) || (context == NULL) || (context->daemon == NULL) || (context->daemon_local == NULL)) {
         dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
-        return -1;
+        return;
     }
 
-    res = read(receiver->fd, &expir, sizeof(expir));
+    daemon = context->daemon;
+    daemon_local = context->daemon_local;
 
-    if (res < 0) {
-        dlt_vlog(LOG_WARNING, "%s: Fail to read timer (%s)\n", __func__,
-                 strerror(errno));
-        /* Activity received on timer_wd, but unable to read the fd:
-         * let's go on sending notification */
-    }
+    PRINT_FUNCTION_VERBOSE(context->verbose);
 
     if (daemon_local->flags.sendECUSoftwareVersion > 0){
         if (daemon->daemon_version == DLTProtocolV2) {
@@ -4643,7 +5418,7 @@ int dlt_daemon_process_sixty_s_timer(DltDaemon *daemon,
                                                     daemon_local->flags.vflag);
         }else {
             dlt_vlog(LOG_ERR, "Unsupported DLT version %u in %s\n", daemon->daemon_version, __func__);
-            return -1;
+            return;
         }
     }
 
@@ -4668,43 +5443,32 @@ int dlt_daemon_process_sixty_s_timer(DltDaemon *daemon,
                                                 daemon_local->flags.vflag);
         }else {
             dlt_vlog(LOG_ERR, "Unsupported DLT version %u in %s\n", daemon->daemon_version, __func__);
-            return -1;
+            return;
         }
     }
 
     dlt_log(LOG_DEBUG, "Timer ecuversion\n");
-
-    return 0;
 }
 
 #ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-int dlt_daemon_process_systemd_timer(DltDaemon *daemon,
-                                     DltDaemonLocal *daemon_local,
-                                     DltReceiver *receiver,
-                                     int verbose)
+void dlt_daemon_process_systemd_timer(DltDaemonTimer *timer, void *ctx)
 {
-    uint64_t expir = 0;
-    ssize_t res = -1;
-
-    PRINT_FUNCTION_VERBOSE(verbose);
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltDaemon *daemon = NULL;
 
-    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+    if ((timer == NULL) || (context == NULL) || (context->daemon == NULL)) {
         dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
-        return res;
+        return;
     }
 
-    res = read(receiver->fd, &expir, sizeof(expir));
+    daemon = context->daemon;
 
-    if (res < 0) {
-        dlt_vlog(LOG_WARNING, "Failed to read timer_wd; %s\n", strerror(errno));
-        /* Activity received on timer_wd, but unable to read the fd:
-         * let's go on sending notification */
-    }
+    PRINT_FUNCTION_VERBOSE(context->verbose);
 
 #ifdef DLT_SYSTEMD_WATCHDOG_ENFORCE_MSG_RX_ENABLE
     if (!daemon->received_message_since_last_watchdog_interval) {
       dlt_log(LOG_WARNING, "No new messages received since last watchdog timer run\n");
-      return 0;
+      return;
     }
     daemon->received_message_since_last_watchdog_interval = 0;
 #endif
@@ -4712,26 +5476,63 @@ int dlt_daemon_process_systemd_timer(DltDaemon *daemon,
     dlt_daemon_trigger_systemd_watchdog_if_necessary(daemon);
 
     dlt_log(LOG_DEBUG, "Timer watchdog\n");
-
-    return 0;
 }
 #else
-int dlt_daemon_process_systemd_timer(DltDaemon *daemon,
-                                     DltDaemonLocal *daemon_local,
-                                     DltReceiver *receiver,
-                                     int verbose)
+void dlt_daemon_process_systemd_timer(DltDaemonTimer *timer, void *ctx)
 {
-    (void)daemon;
-    (void)daemon_local;
-    (void)receiver;
-    (void)verbose;
+    (void)timer;
+    (void)ctx;
 
     dlt_log(LOG_DEBUG, "Timer watchdog not enabled\n");
-
-    return -1;
 }
 #endif
 
+int dlt_daemon_process_storage_writer(DltDaemon *daemon,
+                                      DltDaemonLocal *daemon_local,
+                                      DltReceiver *receiver,
+                                      int verbose)
+{
+    uint64_t completions = 0;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
+        return -1;
+    }
+
+    /* the eventfd only wakes us up, the completions are in the ring */
+    if ((read(receiver->fd, &completions, sizeof(completions)) < 0) && (errno != EAGAIN))
+        dlt_vlog(LOG_WARNING, "%s: Fail to read eventfd (%s)\n", __func__, strerror(errno));
+
+    dlt_storage_writer_handle_completions();
+
+    return 0;
+}
+
+void dlt_daemon_process_compression_timer(DltDaemonTimer *timer, void *ctx)
+{
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltConnection *con = NULL;
+
+    if ((timer == NULL) || (timer->data == NULL) || (context == NULL) ||
+        (context->daemon == NULL) || (context->daemon_local == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: invalid parameters", __func__);
+        return;
+    }
+
+    PRINT_FUNCTION_VERBOSE(context->verbose);
+
+    /* each compressed client has its own flush timer */
+    con = (DltConnection *)timer->data;
+
+    if (dlt_connection_flush(con) != DLT_DAEMON_ERROR_OK) {
+        /* closing the connection cancels the timer */
+        dlt_vlog(LOG_WARNING, "%s: flush failed, closing client %d\n", __func__, con->receiver->fd);
+        dlt_daemon_close_socket(con->receiver->fd, context->daemon, context->daemon_local, context->verbose);
+    }
+}
+
 void dlt_daemon_control_service_logstorage(int sock,
                                            DltDaemon *daemon,
                                            DltDaemonLocal *daemon_local,
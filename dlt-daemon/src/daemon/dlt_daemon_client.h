@@ -116,6 +116,31 @@ int dlt_daemon_client_send_v2(int sock,
                               int size2,
                               int verbose);
 
+/**
+ * Start collecting messages sent to all clients in a buffer of the caller.
+ * Until dlt_daemon_client_batch_flush() is called, messages passed to
+ * dlt_daemon_client_send() for all clients are still written to offline
+ * trace, logstorage and ring buffer as usual, but the client sockets are
+ * written once per full buffer instead of once per message.
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param buf buffer collecting the messages
+ * @param size size of the buffer
+ */
+void dlt_daemon_client_batch_begin(DltDaemonLocal *daemon_local,
+                                   uint8_t *buf,
+                                   int size);
+
+/**
+ * Send the collected messages to all clients and stop collecting.
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param verbose if set to true verbose information is printed out.
+ * @return 1 if the batch was sent to at least one client, 0 otherwise
+ */
+int dlt_daemon_client_batch_flush(DltDaemon *daemon,
+                                  DltDaemonLocal *daemon_local,
+                                  int verbose);
+
 /**
  * Send out message to all client or store message in offline trace.
  * @param daemon pointer to dlt daemon structure
@@ -654,6 +679,38 @@ void dlt_daemon_control_set_timing_packets(int sock,
                                            DltMessage *msg,
                                            int verbose);
 
+/**
+ * Process and generate response to set client filter control message.
+ * The filter replaces the one of the client connection, the daemon then only
+ * sends the messages matching it to this client.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param msg pointer to received control message
+ * @param verbose if set to true verbose information is printed out.
+ */
+void dlt_daemon_control_set_client_filter(int sock,
+                                          DltDaemon *daemon,
+                                          DltDaemonLocal *daemon_local,
+                                          DltMessage *msg,
+                                          int verbose);
+
+/**
+ * Process and generate response to set client compression control message.
+ * After the positive response, all data sent to the client is compressed and
+ * flushed at least every ClientCompressionFlushInterval ms.
+ * @param sock connection handle used for sending response
+ * @param daemon pointer to dlt daemon structure
+ * @param daemon_local pointer to dlt daemon local structure
+ * @param msg pointer to received control message
+ * @param verbose if set to true verbose information is printed out.
+ */
+void dlt_daemon_control_set_client_compression(int sock,
+                                               DltDaemon *daemon,
+                                               DltDaemonLocal *daemon_local,
+                                               DltMessage *msg,
+                                               int verbose);
+
 /**
  * Process and generate response to set timing packets control message
  * for DLT V2
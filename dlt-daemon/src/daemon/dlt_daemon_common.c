@@ -75,6 +75,8 @@
 #include <fcntl.h>
 
 #include <sys/socket.h> /* send() */
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "dlt_types.h"
 #include "dlt_log.h"
@@ -464,6 +466,19 @@ int dlt_daemon_init_runtime_configuration(DltDaemon *daemon, const char *runtime
 
     strcat(daemon->runtime_configuration, DLT_RUNTIME_CONFIGURATION); /* strcat uncritical here, because max length already checked */
 
+    append_length = PATH_MAX - sizeof(DLT_RUNTIME_SNAPSHOT);
+
+    if (runtime_directory[0]) {
+        strncpy(daemon->runtime_snapshot, runtime_directory, append_length);
+        daemon->runtime_snapshot[append_length] = 0;
+    }
+    else {
+        strncpy(daemon->runtime_snapshot, DLT_RUNTIME_DEFAULT_DIRECTORY, append_length);
+        daemon->runtime_snapshot[append_length] = 0;
+    }
+
+    strcat(daemon->runtime_snapshot, DLT_RUNTIME_SNAPSHOT); /* strcat uncritical here, because max length already checked */
+
     return DLT_RETURN_OK;
 }
 
@@ -521,6 +536,10 @@ int dlt_daemon_init(DltDaemon *daemon,
         return -1;
 
     daemon->storage_handle = NULL;
+
+    daemon->loginfo_generation = 0;
+    memset(daemon->loginfo_cache, 0, sizeof(daemon->loginfo_cache));
+    daemon->loginfo_cache_next = 0;
 #ifdef DLT_SYSTEMD_WATCHDOG_ENFORCE_MSG_RX_ENABLE
     daemon->received_message_since_last_watchdog_interval = 0;
 #endif
@@ -534,6 +553,9 @@ int dlt_daemon_free(DltDaemon *daemon, int verbose)
 
     PRINT_FUNCTION_VERBOSE(verbose);
 
+    if (daemon != NULL)
+        dlt_daemon_loginfo_cache_free(daemon);
+
     if ((daemon == NULL) || (daemon->user_list == NULL))
         return -1;
 
@@ -565,6 +587,28 @@ int dlt_daemon_free(DltDaemon *daemon, int verbose)
     return 0;
 }
 
+void dlt_daemon_loginfo_cache_invalidate(DltDaemon *daemon)
+{
+    if (daemon != NULL)
+        daemon->loginfo_generation++;
+}
+
+void dlt_daemon_loginfo_cache_free(DltDaemon *daemon)
+{
+    int i;
+
+    if (daemon == NULL)
+        return;
+
+    for (i = 0; i < DLT_DAEMON_LOGINFO_CACHE_SIZE; i++) {
+        free(daemon->loginfo_cache[i].payload);
+        free(daemon->loginfo_cache[i].app_offsets);
+        memset(&daemon->loginfo_cache[i], 0, sizeof(DltDaemonLogInfoCache));
+    }
+
+    daemon->loginfo_cache_next = 0;
+}
+
 int dlt_daemon_init_user_information(DltDaemon *daemon,
                                      DltGateway *gateway,
                                      int gateway_mode,
@@ -680,6 +724,8 @@ int dlt_daemon_applications_clear(DltDaemon *daemon, char *ecu, int verbose)
     if ((daemon == NULL) || (daemon->user_list == NULL) || (ecu == NULL))
         return DLT_RETURN_WRONG_PARAMETER;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (user_list == NULL)
@@ -724,6 +770,8 @@ int dlt_daemon_applications_clear_v2(DltDaemon *daemon, char *ecu, int verbose)
 
     uint8_t eculen = (uint8_t)strlen(ecu);
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, eculen, ecu, verbose);
 
     if (user_list == NULL)
@@ -781,6 +829,7 @@ static void dlt_daemon_application_reset_user_handle(DltDaemon *daemon,
 
     application->user_handle = DLT_FD_INIT;
     application->owns_user_handle = false;
+    application->log_level_batch = false;
 }
 
 static void dlt_daemon_application_reset_user_handle_v2(DltDaemon *daemon,
@@ -808,6 +857,7 @@ static void dlt_daemon_application_reset_user_handle_v2(DltDaemon *daemon,
 
     application->user_handle = DLT_FD_INIT;
     application->owns_user_handle = false;
+    application->log_level_batch = false;
 }
 
 DltDaemonApplication *dlt_daemon_application_add(DltDaemon *daemon,
@@ -832,6 +882,8 @@ DltDaemonApplication *dlt_daemon_application_add(DltDaemon *daemon,
     if ((daemon == NULL) || (apid == NULL) || (apid[0] == '\0') || (ecu == NULL))
         return (DltDaemonApplication *)NULL;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (user_list == NULL)
@@ -883,6 +935,7 @@ DltDaemonApplication *dlt_daemon_application_add(DltDaemon *daemon,
         application->num_contexts = 0;
         application->user_handle = DLT_FD_INIT;
         application->owns_user_handle = false;
+        application->log_level_batch = false;
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
         application->trace_load_settings = NULL;
         application->trace_load_settings_count = 0;
@@ -966,8 +1019,9 @@ DltDaemonApplication *dlt_daemon_application_add(DltDaemon *daemon,
         application->pid = pid;
     }
 
-    /* Sort */
-    if (new_application) {
+    /* Sort, unless the application was added in order (e.g. loaded from a saved configuration) */
+    if (new_application && (user_list->num_applications > 1) &&
+        (dlt_daemon_cmp_apid(&user_list->applications[user_list->num_applications - 2], application) > 0)) {
         qsort(user_list->applications,
               (size_t) user_list->num_applications,
               sizeof(DltDaemonApplication),
@@ -1064,6 +1118,8 @@ DltDaemonApplication *dlt_daemon_application_add_v2(DltDaemon *daemon,
         (apid == NULL) || (ecu == NULL))
         return (DltDaemonApplication *)NULL;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, eculen, ecu, verbose);
 
     if (user_list == NULL)
@@ -1117,6 +1173,7 @@ DltDaemonApplication *dlt_daemon_application_add_v2(DltDaemon *daemon,
         application->num_contexts = 0;
         application->user_handle = DLT_FD_INIT;
         application->owns_user_handle = false;
+        application->log_level_batch = false;
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
         application->trace_load_settings = NULL;
         application->trace_load_settings_count = 0;
@@ -1286,6 +1343,8 @@ int dlt_daemon_application_del(DltDaemon *daemon,
     if ((daemon == NULL) || (application == NULL) || (ecu == NULL))
         return -1;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (user_list == NULL)
@@ -1339,6 +1398,8 @@ int dlt_daemon_application_del_v2(DltDaemon *daemon,
     if ((daemon == NULL) || (application == NULL) || (ecu == NULL))
         return -1;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, eculen, ecu, verbose);
 
     if (user_list == NULL)
@@ -1672,6 +1733,8 @@ DltDaemonContext *dlt_daemon_context_add(DltDaemon *daemon,
     if ((trace_status < DLT_TRACE_STATUS_DEFAULT) || (trace_status > DLT_TRACE_STATUS_ON))
         return (DltDaemonContext *)NULL;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (user_list == NULL)
@@ -1815,8 +1878,9 @@ DltDaemonContext *dlt_daemon_context_add(DltDaemon *daemon,
     else
         context->predefined = false;
 
-    /* Sort */
-    if (new_context) {
+    /* Sort, unless the context was added in order (e.g. loaded from a saved configuration) */
+    if (new_context && (user_list->num_contexts > 1) &&
+        (dlt_daemon_cmp_apid_ctid(&user_list->contexts[user_list->num_contexts - 2], context) > 0)) {
         qsort(user_list->contexts,
               (size_t) user_list->num_contexts,
               sizeof(DltDaemonContext),
@@ -1861,6 +1925,8 @@ DltDaemonContext *dlt_daemon_context_add_v2(DltDaemon *daemon,
     if ((trace_status < DLT_TRACE_STATUS_DEFAULT) || (trace_status > DLT_TRACE_STATUS_ON))
         return (DltDaemonContext *)NULL;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, eculen, ecu, verbose);
 
     if (user_list == NULL)
@@ -2076,6 +2142,8 @@ int dlt_daemon_context_del(DltDaemon *daemon,
     if ((daemon == NULL) || (context == NULL) || (ecu == NULL))
         return -1;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (user_list == NULL)
@@ -2130,6 +2198,8 @@ int dlt_daemon_context_del_v2(DltDaemon *daemon,
     if ((daemon == NULL) || (context == NULL) || (ecu == NULL))
         return -1;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, eculen, ecu, verbose);
 
     if (user_list == NULL)
@@ -2317,6 +2387,8 @@ int dlt_daemon_contexts_clear(DltDaemon *daemon, char *ecu, int verbose)
     if ((daemon == NULL) || (ecu == NULL))
         return DLT_RETURN_WRONG_PARAMETER;
 
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     users = dlt_daemon_find_users_list(daemon, ecu, verbose);
 
     if (users == NULL)
@@ -2645,6 +2717,391 @@ int dlt_daemon_configuration_load(DltDaemon *daemon, const char *filename, int v
     return 0;
 }
 
+/* Binary snapshot of the runtime application and context configuration.
+ * The records are written in registry order, so that loading them does not
+ * need to sort. Numbers are stored in host byte order. */
+#define DLT_DAEMON_SNAPSHOT_MAGIC   "DLRS"
+#define DLT_DAEMON_SNAPSHOT_VERSION 1
+
+typedef struct
+{
+    int64_t size;                           /**< file size, -1 if the file does not exist */
+    int64_t mtime_sec;                      /**< modification time, seconds */
+    int64_t mtime_nsec;                     /**< modification time, nanoseconds */
+} DLT_PACKED DltDaemonSnapshotSource;
+
+typedef struct
+{
+    char magic[4];                          /**< DLT_DAEMON_SNAPSHOT_MAGIC */
+    uint16_t version;                       /**< DLT_DAEMON_SNAPSHOT_VERSION */
+    uint16_t header_size;                   /**< size of this header */
+    uint32_t num_applications;              /**< number of application records */
+    uint32_t num_contexts;                  /**< number of context records */
+    uint32_t strings_size;                  /**< size of the description strings */
+    uint32_t data_crc;                      /**< CRC-32 of records and strings */
+    DltDaemonSnapshotSource application_cfg; /**< runtime application configuration file */
+    DltDaemonSnapshotSource context_cfg;    /**< runtime context configuration file */
+    uint32_t header_crc;                    /**< CRC-32 of the header up to this field */
+} DLT_PACKED DltDaemonSnapshotHeader;
+
+typedef struct
+{
+    char apid[DLT_ID_SIZE];                 /**< application id */
+    uint32_t description;                   /**< offset of the description in the strings */
+} DLT_PACKED DltDaemonSnapshotApplication;
+
+typedef struct
+{
+    char apid[DLT_ID_SIZE];                 /**< application id */
+    char ctid[DLT_ID_SIZE];                 /**< context id */
+    int8_t log_level;                       /**< log level */
+    int8_t trace_status;                    /**< trace status */
+    uint16_t reserved;                      /**< always 0 */
+    uint32_t description;                   /**< offset of the description in the strings */
+} DLT_PACKED DltDaemonSnapshotContext;
+
+/* CRC-32 (IEEE 802.3), four bits at a time */
+static uint32_t dlt_daemon_snapshot_crc(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+
+    while (size--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+static void dlt_daemon_snapshot_source(const char *filename, DltDaemonSnapshotSource *source)
+{
+    struct stat st;
+
+    memset(source, 0, sizeof(DltDaemonSnapshotSource));
+
+    if (stat(filename, &st) != 0) {
+        source->size = -1;
+        return;
+    }
+
+    source->size = (int64_t)st.st_size;
+    source->mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    source->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+}
+
+/* Add a description to the strings, empty descriptions share offset 0 */
+static uint32_t dlt_daemon_snapshot_string(char *strings, uint32_t *strings_size, const char *description)
+{
+    uint32_t offset = *strings_size;
+    size_t length;
+
+    if ((description == NULL) || (description[0] == '\0'))
+        return 0;
+
+    length = strlen(description) + 1;
+    memcpy(strings + offset, description, length);
+    *strings_size += (uint32_t)length;
+
+    return offset;
+}
+
+int dlt_daemon_runtime_snapshot_save(DltDaemon *daemon, const char *filename, int verbose)
+{
+    DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonSnapshotHeader *header;
+    DltDaemonSnapshotApplication *applications;
+    DltDaemonSnapshotContext *contexts;
+    char tmp_filename[PATH_MAX + 1];
+    char *buffer;
+    char *strings;
+    size_t strings_max = 1;
+    size_t size;
+    uint32_t strings_size = 1;
+    FILE *fd;
+    int ret = 0;
+    int i;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (filename == NULL) || (filename[0] == '\0'))
+        return -1;
+
+    user_list = dlt_daemon_find_users_list(daemon, daemon->ecuid, verbose);
+
+    if (user_list == NULL)
+        return -1;
+
+    /* The configuration files are not written without applications or
+     * contexts, a snapshot would not match them */
+    if ((user_list->num_applications <= 0) || (user_list->num_contexts <= 0)) {
+        if ((unlink(filename) != 0) && (errno != ENOENT))
+            dlt_vlog(LOG_WARNING, "%s: unlink() failed: %s\n", __func__, strerror(errno));
+
+        return 0;
+    }
+
+    for (i = 0; i < user_list->num_applications; i++)
+        if (user_list->applications[i].application_description != NULL)
+            strings_max += strlen(user_list->applications[i].application_description) + 1;
+
+    for (i = 0; i < user_list->num_contexts; i++)
+        if (user_list->contexts[i].context_description != NULL)
+            strings_max += strlen(user_list->contexts[i].context_description) + 1;
+
+    if (strings_max > UINT32_MAX) {
+        dlt_vlog(LOG_ERR, "%s: descriptions too long\n", __func__);
+        return -1;
+    }
+
+    size = sizeof(DltDaemonSnapshotHeader) +
+        (size_t)user_list->num_applications * sizeof(DltDaemonSnapshotApplication) +
+        (size_t)user_list->num_contexts * sizeof(DltDaemonSnapshotContext) + strings_max;
+    buffer = calloc(1, size);
+
+    if (buffer == NULL) {
+        dlt_vlog(LOG_ERR, "%s: cannot allocate %zu bytes\n", __func__, size);
+        return -1;
+    }
+
+    header = (DltDaemonSnapshotHeader *)buffer;
+    applications = (DltDaemonSnapshotApplication *)(buffer + sizeof(DltDaemonSnapshotHeader));
+    contexts = (DltDaemonSnapshotContext *)(applications + user_list->num_applications);
+    strings = (char *)(contexts + user_list->num_contexts);
+
+    for (i = 0; i < user_list->num_applications; i++) {
+        memcpy(applications[i].apid, user_list->applications[i].apid, DLT_ID_SIZE);
+        applications[i].description = dlt_daemon_snapshot_string(strings, &strings_size,
+                                                                  user_list->applications[i].application_description);
+    }
+
+    for (i = 0; i < user_list->num_contexts; i++) {
+        memcpy(contexts[i].apid, user_list->contexts[i].apid, DLT_ID_SIZE);
+        memcpy(contexts[i].ctid, user_list->contexts[i].ctid, DLT_ID_SIZE);
+        contexts[i].log_level = user_list->contexts[i].log_level;
+        contexts[i].trace_status = user_list->contexts[i].trace_status;
+        contexts[i].description = dlt_daemon_snapshot_string(strings, &strings_size,
+                                                             user_list->contexts[i].context_description);
+    }
+
+    size -= strings_max - strings_size;
+
+    memcpy(header->magic, DLT_DAEMON_SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = DLT_DAEMON_SNAPSHOT_VERSION;
+    header->header_size = sizeof(DltDaemonSnapshotHeader);
+    header->num_applications = (uint32_t)user_list->num_applications;
+    header->num_contexts = (uint32_t)user_list->num_contexts;
+    header->strings_size = strings_size;
+    header->data_crc = dlt_daemon_snapshot_crc(0, (uint8_t *)applications, size - sizeof(DltDaemonSnapshotHeader));
+    dlt_daemon_snapshot_source(daemon->runtime_application_cfg, &header->application_cfg);
+    dlt_daemon_snapshot_source(daemon->runtime_context_cfg, &header->context_cfg);
+    header->header_crc = dlt_daemon_snapshot_crc(0, (uint8_t *)header, offsetof(DltDaemonSnapshotHeader, header_crc));
+
+    /* Replace the snapshot atomically, a partly written file is never loaded */
+    if (snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", filename) >= (int)sizeof(tmp_filename)) {
+        free(buffer);
+        return -1;
+    }
+
+    fd = fopen(tmp_filename, "w");
+
+    if (fd == NULL) {
+        dlt_vlog(LOG_ERR, "%s: open %s failed: %s\n", __func__, tmp_filename, strerror(errno));
+        free(buffer);
+        return -1;
+    }
+
+    if (fwrite(buffer, 1, size, fd) != size)
+        ret = -1;
+
+    if (fclose(fd) != 0)
+        ret = -1;
+
+    if ((ret == 0) && (rename(tmp_filename, filename) != 0))
+        ret = -1;
+
+    if (ret != 0) {
+        dlt_vlog(LOG_ERR, "%s: cannot write %s: %s\n", __func__, filename, strerror(errno));
+        unlink(tmp_filename);
+    }
+
+    free(buffer);
+
+    return ret;
+}
+
+/* Check a mapped snapshot, return 0 if it is valid and up to date */
+static int dlt_daemon_snapshot_check(DltDaemon *daemon, const char *filename, char *map, size_t map_size)
+{
+    DltDaemonSnapshotHeader *header = (DltDaemonSnapshotHeader *)map;
+    DltDaemonSnapshotApplication *applications;
+    DltDaemonSnapshotContext *contexts;
+    DltDaemonSnapshotSource source;
+    char *strings;
+    uint64_t size;
+    uint32_t i;
+
+    if ((map_size < sizeof(DltDaemonSnapshotHeader)) ||
+        (memcmp(header->magic, DLT_DAEMON_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != DLT_DAEMON_SNAPSHOT_VERSION) ||
+        (header->header_size != sizeof(DltDaemonSnapshotHeader)) ||
+        (header->header_crc !=
+         dlt_daemon_snapshot_crc(0, (uint8_t *)header, offsetof(DltDaemonSnapshotHeader, header_crc)))) {
+        dlt_vlog(LOG_WARNING, "%s: %s is no valid snapshot\n", __func__, filename);
+        return -1;
+    }
+
+    size = (uint64_t)sizeof(DltDaemonSnapshotHeader) +
+        (uint64_t)header->num_applications * sizeof(DltDaemonSnapshotApplication) +
+        (uint64_t)header->num_contexts * sizeof(DltDaemonSnapshotContext) + header->strings_size;
+
+    if ((size != map_size) ||
+        (header->data_crc != dlt_daemon_snapshot_crc(0, (uint8_t *)map + sizeof(DltDaemonSnapshotHeader),
+                                                      map_size - sizeof(DltDaemonSnapshotHeader)))) {
+        dlt_vlog(LOG_WARNING, "%s: %s is corrupted\n", __func__, filename);
+        return -1;
+    }
+
+    applications = (DltDaemonSnapshotApplication *)(map + sizeof(DltDaemonSnapshotHeader));
+    contexts = (DltDaemonSnapshotContext *)(applications + header->num_applications);
+    strings = (char *)(contexts + header->num_contexts);
+
+    /* all descriptions are terminated within the strings */
+    if ((header->strings_size == 0) || (strings[header->strings_size - 1] != '\0'))
+        return -1;
+
+    for (i = 0; i < header->num_applications; i++)
+        if (applications[i].description >= header->strings_size)
+            return -1;
+
+    for (i = 0; i < header->num_contexts; i++)
+        if (contexts[i].description >= header->strings_size)
+            return -1;
+
+    /* The configuration files have been edited or replaced since */
+    dlt_daemon_snapshot_source(daemon->runtime_application_cfg, &source);
+
+    if (memcmp(&source, &header->application_cfg, sizeof(source)) == 0) {
+        dlt_daemon_snapshot_source(daemon->runtime_context_cfg, &source);
+
+        if (memcmp(&source, &header->context_cfg, sizeof(source)) == 0)
+            return 0;
+    }
+
+    dlt_vlog(LOG_INFO, "%s: %s is outdated, runtime configuration was changed\n", __func__, filename);
+
+    return -1;
+}
+
+int dlt_daemon_runtime_snapshot_load(DltDaemon *daemon, const char *filename, int verbose)
+{
+    DltDaemonSnapshotHeader *header;
+    DltDaemonSnapshotApplication *applications;
+    DltDaemonSnapshotContext *contexts;
+    struct stat st;
+    char *strings;
+    char *map;
+    ID4 apid, ctid;
+    uint32_t i;
+    int ret;
+    int fd;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (filename == NULL) || (filename[0] == '\0'))
+        return -1;
+
+    fd = open(filename, O_RDONLY);
+
+    if (fd < 0) {
+        dlt_vlog(LOG_INFO, "%s: cannot open file %s: %s\n", __func__, filename, strerror(errno));
+        return -1;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        return -1;
+    }
+
+    /* private writable mapping, the descriptions are passed as char * */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        dlt_vlog(LOG_WARNING, "%s: mmap() failed: %s\n", __func__, strerror(errno));
+        return -1;
+    }
+
+    ret = dlt_daemon_snapshot_check(daemon, filename, map, (size_t)st.st_size);
+
+    if (ret != 0) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    header = (DltDaemonSnapshotHeader *)map;
+    applications = (DltDaemonSnapshotApplication *)(map + sizeof(DltDaemonSnapshotHeader));
+    contexts = (DltDaemonSnapshotContext *)(applications + header->num_applications);
+    strings = (char *)(contexts + header->num_contexts);
+
+    /* Applications first, contexts are only added to known applications */
+    for (i = 0; (ret == 0) && (i < header->num_applications); i++) {
+        dlt_set_id(apid, applications[i].apid);
+
+        /* pid is unknown at loading time */
+        if (dlt_daemon_application_add(daemon, apid, 0, strings + applications[i].description,
+                                       -1, daemon->ecuid, verbose) == NULL) {
+            dlt_vlog(LOG_WARNING, "%s: dlt_daemon_application_add failed for %.4s\n", __func__, apid);
+            ret = -1;
+        }
+    }
+
+    for (i = 0; (ret == 0) && (i < header->num_contexts); i++) {
+        dlt_set_id(apid, contexts[i].apid);
+        dlt_set_id(ctid, contexts[i].ctid);
+
+        /* log_level_pos, and user_handle are unknown at loading time */
+        if (dlt_daemon_context_add(daemon, apid, ctid, contexts[i].log_level, contexts[i].trace_status,
+                                   0, 0, strings + contexts[i].description,
+                                   daemon->ecuid, verbose) == NULL) {
+            dlt_vlog(LOG_WARNING, "%s: dlt_daemon_context_add failed for %.4s:%.4s\n", __func__, apid, ctid);
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+        dlt_vlog(LOG_INFO, "Loaded %u applications and %u contexts from %s\n",
+                 header->num_applications, header->num_contexts, filename);
+
+    munmap(map, (size_t)st.st_size);
+
+    return ret;
+}
+
+/* Log level and trace status to be sent to the application of a context */
+static void dlt_daemon_user_log_level_fill(DltDaemon *daemon,
+                                           DltDaemonContext *context,
+                                           DltUserControlMsgLogLevel *usercontext)
+{
+    if ((context->storage_log_level != DLT_LOG_DEFAULT) &&
+        (daemon->maintain_logstorage_loglevel != DLT_MAINTAIN_LOGSTORAGE_LOGLEVEL_OFF))
+            usercontext->log_level = (uint8_t) (context->log_level >
+                context->storage_log_level ? context->log_level : context->storage_log_level);
+    else /* Storage log level is not updated (is DEFAULT) then  no device is yet connected so ignore */
+        usercontext->log_level =
+            (uint8_t) ((context->log_level == DLT_LOG_DEFAULT) ? daemon->default_log_level : context->log_level);
+
+    usercontext->trace_status =
+        (uint8_t) ((context->trace_status == DLT_TRACE_STATUS_DEFAULT) ? daemon->default_trace_status : context->trace_status);
+
+    usercontext->log_level_pos = context->log_level_pos;
+}
+
 int dlt_daemon_user_send_log_level(DltDaemon *daemon, DltDaemonContext *context, int verbose)
 {
     DltUserHeader userheader;
@@ -2659,23 +3116,15 @@ int dlt_daemon_user_send_log_level(DltDaemon *daemon, DltDaemonContext *context,
         return -1;
     }
 
+    /* log level or trace status of the context may have changed */
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     if (dlt_user_set_userheader(&userheader, DLT_USER_MESSAGE_LOG_LEVEL) < DLT_RETURN_OK) {
         dlt_vlog(LOG_ERR, "Failed to set userheader in %s", __func__);
         return -1;
     }
 
-    if ((context->storage_log_level != DLT_LOG_DEFAULT) &&
-        (daemon->maintain_logstorage_loglevel != DLT_MAINTAIN_LOGSTORAGE_LOGLEVEL_OFF))
-            usercontext.log_level = (uint8_t) (context->log_level >
-                context->storage_log_level ? context->log_level : context->storage_log_level);
-    else /* Storage log level is not updated (is DEFAULT) then  no device is yet connected so ignore */
-        usercontext.log_level =
-            (uint8_t) ((context->log_level == DLT_LOG_DEFAULT) ? daemon->default_log_level : context->log_level);
-
-    usercontext.trace_status =
-        (uint8_t) ((context->trace_status == DLT_TRACE_STATUS_DEFAULT) ? daemon->default_trace_status : context->trace_status);
-
-    usercontext.log_level_pos = context->log_level_pos;
+    dlt_daemon_user_log_level_fill(daemon, context, &usercontext);
 
     dlt_vlog(LOG_NOTICE, "Send log-level to context: %.4s:%.4s [%i -> %i] [%i -> %i]\n",
              context->apid,
@@ -2720,6 +3169,9 @@ int dlt_daemon_user_send_log_level_v2(DltDaemon *daemon, DltDaemonContext *conte
         return -1;
     }
 
+    /* log level or trace status of the context may have changed */
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
     if (dlt_user_set_userheader_v2(&userheader, DLT_USER_MESSAGE_LOG_LEVEL) < DLT_RETURN_OK) {
         dlt_vlog(LOG_ERR, "Failed to set userheader in %s", __func__);
         return -1;
@@ -2768,6 +3220,128 @@ int dlt_daemon_user_send_log_level_v2(DltDaemon *daemon, DltDaemonContext *conte
     return (ret == DLT_RETURN_OK) ? DLT_RETURN_OK : DLT_RETURN_ERROR;
 }
 
+void dlt_daemon_user_log_level_batch_init(DltDaemonLogLevelBatch *batch)
+{
+    if (batch == NULL)
+        return;
+
+    batch->user_handle = DLT_FD_INIT;
+    memset(batch->apid, 0, DLT_ID_SIZE);
+    batch->count = 0;
+}
+
+int dlt_daemon_user_log_level_batch_add(DltDaemon *daemon,
+                                        DltDaemonLogLevelBatch *batch,
+                                        DltDaemonContext *context,
+                                        int verbose)
+{
+    int ret = DLT_RETURN_OK;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (batch == NULL) || (context == NULL)) {
+        dlt_vlog(LOG_ERR, "NULL parameter in %s", __func__);
+        return -1;
+    }
+
+    /* contexts are sorted by application, so a batch is sent per application */
+    if ((batch->count > 0) &&
+        ((batch->user_handle != context->user_handle) || (batch->count >= DLT_USER_LOG_LEVEL_BATCH_MAX)))
+        ret = dlt_daemon_user_log_level_batch_flush(daemon, batch, verbose);
+
+    /* the connection of the application may have been reset by the flush */
+    if (context->user_handle < DLT_FD_MINIMUM)
+        return ret;
+
+    if (batch->count == 0) {
+        batch->user_handle = context->user_handle;
+        memcpy(batch->apid, context->apid, DLT_ID_SIZE);
+    }
+
+    dlt_daemon_user_log_level_fill(daemon, context, &batch->entries[batch->count]);
+
+    dlt_vlog(LOG_DEBUG, "Batch log-level for context: %.4s:%.4s [%i -> %i] [%i -> %i]\n",
+             context->apid,
+             context->ctid,
+             context->log_level,
+             batch->entries[batch->count].log_level,
+             context->trace_status,
+             batch->entries[batch->count].trace_status);
+
+    batch->count++;
+
+    return ret;
+}
+
+int dlt_daemon_user_log_level_batch_flush(DltDaemon *daemon, DltDaemonLogLevelBatch *batch, int verbose)
+{
+    DltUserHeader userheader;
+    DltUserControlMsgLogLevelBatch usermsg;
+    DltReturnValue ret = DLT_RETURN_OK;
+    DltDaemonApplication *app;
+    bool batched;
+    uint32_t i;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((daemon == NULL) || (batch == NULL)) {
+        dlt_vlog(LOG_ERR, "NULL parameter in %s", __func__);
+        return -1;
+    }
+
+    if (batch->count == 0)
+        return DLT_RETURN_OK;
+
+    /* log level or trace status of the contexts may have changed */
+    dlt_daemon_loginfo_cache_invalidate(daemon);
+
+    /* older libraries do not know the batch message */
+    app = dlt_daemon_application_find(daemon, batch->apid, daemon->ecuid, verbose);
+    batched = (app != NULL) && app->log_level_batch;
+
+    if (dlt_user_set_userheader(&userheader,
+                                batched ? DLT_USER_MESSAGE_LOG_LEVEL_BATCH : DLT_USER_MESSAGE_LOG_LEVEL) <
+        DLT_RETURN_OK) {
+        dlt_vlog(LOG_ERR, "Failed to set userheader in %s", __func__);
+        dlt_daemon_user_log_level_batch_init(batch);
+        return -1;
+    }
+
+    usermsg.count = batch->count;
+
+    dlt_vlog(LOG_NOTICE, "Send log-level to %u contexts of application %.4s%s\n",
+             batch->count,
+             batch->apid,
+             batched ? "" : " one by one");
+
+    /* log to FIFO */
+    errno = 0;
+
+    if (batched)
+        ret = dlt_user_log_out3_with_timeout(batch->user_handle,
+                                             &(userheader), sizeof(DltUserHeader),
+                                             &(usermsg), sizeof(DltUserControlMsgLogLevelBatch),
+                                             batch->entries, batch->count * sizeof(DltUserControlMsgLogLevel));
+    else
+        for (i = 0; (i < batch->count) && (ret == DLT_RETURN_OK); i++)
+            ret = dlt_user_log_out2_with_timeout(batch->user_handle,
+                                                 &(userheader), sizeof(DltUserHeader),
+                                                 &(batch->entries[i]), sizeof(DltUserControlMsgLogLevel));
+
+    if (ret < DLT_RETURN_OK) {
+        dlt_vlog(LOG_ERR, "Failed to send data to application in %s: %s",
+                 __func__,
+                 errno != 0 ? strerror(errno) : "Unknown error");
+
+        if (((errno == EPIPE) || (errno == EBADF)) && (app != NULL))
+            dlt_daemon_application_reset_user_handle(daemon, app, verbose);
+    }
+
+    dlt_daemon_user_log_level_batch_init(batch);
+
+    return (ret == DLT_RETURN_OK) ? DLT_RETURN_OK : DLT_RETURN_ERROR;
+}
+
 int dlt_daemon_user_send_log_state(DltDaemon *daemon, DltDaemonApplication *app, int verbose)
 {
     DltUserHeader userheader;
@@ -2871,6 +3445,9 @@ void dlt_daemon_control_reset_to_factory_default(DltDaemon *daemon,
         }
     }
 
+    if ((daemon->runtime_snapshot[0] != '\0') && (unlink(daemon->runtime_snapshot) != 0) && (errno != ENOENT))
+        dlt_vlog(LOG_WARNING, "%s: unlink() failed: %s\n", __func__, strerror(errno));
+
     daemon->default_log_level = (int8_t) InitialContextLogLevel;
     daemon->default_trace_status = (int8_t) InitialContextTraceStatus;
     daemon->force_ll_ts = (int8_t) InitialEnforceLlTsStatus;
@@ -2927,6 +3504,9 @@ void dlt_daemon_control_reset_to_factory_default_v2(DltDaemon *daemon,
         }
     }
 
+    if ((daemon->runtime_snapshot[0] != '\0') && (unlink(daemon->runtime_snapshot) != 0) && (errno != ENOENT))
+        dlt_vlog(LOG_WARNING, "%s: unlink() failed: %s\n", __func__, strerror(errno));
+
     daemon->default_log_level = (int8_t) InitialContextLogLevel;
     daemon->default_trace_status = (int8_t) InitialContextTraceStatus;
     daemon->force_ll_ts = (int8_t) InitialEnforceLlTsStatus;
@@ -2943,6 +3523,7 @@ void dlt_daemon_user_send_default_update(DltDaemon *daemon, int verbose)
     int32_t count;
     DltDaemonContext *context;
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonLogLevelBatch batch;
 
     PRINT_FUNCTION_VERBOSE(verbose);
 
@@ -2956,6 +3537,8 @@ void dlt_daemon_user_send_default_update(DltDaemon *daemon, int verbose)
     if (user_list == NULL)
         return;
 
+    dlt_daemon_user_log_level_batch_init(&batch);
+
     for (count = 0; count < user_list->num_contexts; count++) {
         context = &(user_list->contexts[count]);
 
@@ -2963,13 +3546,17 @@ void dlt_daemon_user_send_default_update(DltDaemon *daemon, int verbose)
             if ((context->log_level == DLT_LOG_DEFAULT) ||
                 (context->trace_status == DLT_TRACE_STATUS_DEFAULT)) {
                 if (context->user_handle >= DLT_FD_MINIMUM)
-                    if (dlt_daemon_user_send_log_level(daemon,
-                                                       context,
-                                                       verbose) == -1)
+                    if (dlt_daemon_user_log_level_batch_add(daemon,
+                                                            &batch,
+                                                            context,
+                                                            verbose) == -1)
                         dlt_vlog(LOG_WARNING, "Cannot update default of %.4s:%.4s\n", context->apid, context->ctid);
             }
         }
     }
+
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &batch, verbose) == -1)
+        dlt_log(LOG_WARNING, "Cannot update default\n");
 }
 
 void dlt_daemon_user_send_default_update_v2(DltDaemon *daemon, int verbose)
@@ -3015,6 +3602,7 @@ void dlt_daemon_user_send_all_log_level_update(DltDaemon *daemon,
     int32_t count = 0;
     DltDaemonContext *context = NULL;
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonLogLevelBatch batch;
 
     PRINT_FUNCTION_VERBOSE(verbose);
 
@@ -3026,6 +3614,8 @@ void dlt_daemon_user_send_all_log_level_update(DltDaemon *daemon,
     if (user_list == NULL)
         return;
 
+    dlt_daemon_user_log_level_batch_init(&batch);
+
     for (count = 0; count < user_list->num_contexts; count++) {
         context = &(user_list->contexts[count]);
 
@@ -3049,9 +3639,10 @@ void dlt_daemon_user_send_all_log_level_update(DltDaemon *daemon,
                     }
                 }
 
-                if (dlt_daemon_user_send_log_level(daemon,
-                                                   context,
-                                                   verbose) == -1)
+                if (dlt_daemon_user_log_level_batch_add(daemon,
+                                                        &batch,
+                                                        context,
+                                                        verbose) == -1)
                     dlt_vlog(LOG_WARNING,
                              "Cannot send log level %.4s:%.4s -> %i\n",
                              context->apid,
@@ -3060,6 +3651,9 @@ void dlt_daemon_user_send_all_log_level_update(DltDaemon *daemon,
             }
         }
     }
+
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &batch, verbose) == -1)
+        dlt_vlog(LOG_WARNING, "Cannot send log level -> %i\n", log_level);
 }
 
 void dlt_daemon_user_send_all_log_level_update_v2(DltDaemon *daemon,
@@ -3124,6 +3718,7 @@ void dlt_daemon_user_send_all_trace_status_update(DltDaemon *daemon, int8_t trac
     int32_t count = 0;
     DltDaemonContext *context = NULL;
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonLogLevelBatch batch;
 
     PRINT_FUNCTION_VERBOSE(verbose);
 
@@ -3137,6 +3732,8 @@ void dlt_daemon_user_send_all_trace_status_update(DltDaemon *daemon, int8_t trac
 
     dlt_vlog(LOG_NOTICE, "All trace status is updated -> %i\n", trace_status);
 
+    dlt_daemon_user_log_level_batch_init(&batch);
+
     for (count = 0; count < user_list->num_contexts; count++) {
         context = &(user_list->contexts[count]);
 
@@ -3144,7 +3741,7 @@ void dlt_daemon_user_send_all_trace_status_update(DltDaemon *daemon, int8_t trac
             if (context->user_handle >= DLT_FD_MINIMUM) {
                 context->trace_status = trace_status;
 
-                if (dlt_daemon_user_send_log_level(daemon, context, verbose) == -1)
+                if (dlt_daemon_user_log_level_batch_add(daemon, &batch, context, verbose) == -1)
                     dlt_vlog(LOG_WARNING,
                              "Cannot send trace status %.4s:%.4s -> %i\n",
                              context->apid,
@@ -3153,6 +3750,9 @@ void dlt_daemon_user_send_all_trace_status_update(DltDaemon *daemon, int8_t trac
             }
         }
     }
+
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &batch, verbose) == -1)
+        dlt_vlog(LOG_WARNING, "Cannot send trace status -> %i\n", trace_status);
 }
 
 void dlt_daemon_user_send_all_trace_status_update_v2(DltDaemon *daemon, int8_t trace_status, int verbose)
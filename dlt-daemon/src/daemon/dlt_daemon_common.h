@@ -81,6 +81,8 @@
 #   include "dlt_common.h"
 #   include "dlt_log.h"
 #   include "dlt_user.h"
+#   include "dlt_user_shared.h"
+#   include "dlt_user_shared_cfg.h"
 #   include "dlt_offline_logstorage.h"
 #   include "dlt_gateway_types.h"
 
@@ -95,6 +97,8 @@ extern "C" {
 #define DLT_DAEMON_SEND_TO_ALL     -3   /**< Constant value to identify the command "send to all" */
 #define DLT_DAEMON_SEND_FORCE      -4   /**< Constant value to identify the command "send force to all" */
 
+#   define DLT_DAEMON_LOGINFO_CACHE_SIZE      8 /**< Number of cached get_log_info responses */
+
 /* UDPMulticart Default IP and Port */
 #   ifdef UDP_CONNECTION_SUPPORT
     #      define MULTICASTIPADDRESS "225.0.0.37"
@@ -151,6 +155,7 @@ typedef struct
     pid_t pid;                      /**< process id of user application */
     int user_handle;                /**< connection handle for connection to user application */
     bool owns_user_handle;          /**< user_handle should be closed when reset */
+    bool log_level_batch;           /**< application accepts DLT_USER_MESSAGE_LOG_LEVEL_BATCH */
     char *application_description;  /**< context description */
     int num_contexts;               /**< number of contexts for this application */
 #ifdef DLT_LOG_LEVEL_APP_CONFIG
@@ -200,6 +205,23 @@ typedef struct
     char ecuid2[DLT_V2_ID_SIZE];
 } DltDaemonRegisteredUsers;
 
+/**
+ * A pre-serialized get_log_info response for one request filter.
+ * The entry is valid as long as payload is set and generation matches
+ * the generation counter of the daemon.
+ */
+typedef struct
+{
+    uint32_t generation;   /**< daemon generation the payload was built for */
+    uint8_t options;       /**< requested options (3..7) */
+    char apid[DLT_ID_SIZE]; /**< requested application id or empty */
+    char ctid[DLT_ID_SIZE]; /**< requested context id or empty */
+    uint8_t *payload;      /**< serialized response payload */
+    size_t size;           /**< size of payload in bytes */
+    size_t *app_offsets;   /**< start of each application record, plus end of the last one */
+    uint16_t num_apps;     /**< number of application records in payload */
+} DltDaemonLogInfoCache;
+
 /**
  * The parameters of a daemon.
  */
@@ -221,6 +243,7 @@ typedef struct
     char runtime_application_cfg[PATH_MAX + 1];  /**< Path and filename of persistent application configuration. Set to path max, as it specifies a full path*/
     char runtime_context_cfg[PATH_MAX + 1];      /**< Path and filename of persistent context configuration */
     char runtime_configuration[PATH_MAX + 1];    /**< Path and filename of persistent configuration */
+    char runtime_snapshot[PATH_MAX + 1];         /**< Path and filename of binary snapshot of application and context configuration */
     DltUserLogMode mode;                         /**< Mode used for tracing: off, external, internal, both */
     char connectionState;                        /**< state for tracing: 0 = no client connected, 1 = client connected */
     char *ECUVersionString;                      /**< Version string to send to client. Loaded from a file at startup. May be null. */
@@ -228,6 +251,9 @@ typedef struct
     DltLogStorage *storage_handle;               /**< the storage handler. */
     int maintain_logstorage_loglevel;            /**< Permission to maintain the logstorage loglevel*/
     int daemon_version;
+    uint32_t loginfo_generation;                 /**< bumped on every change visible in get_log_info responses */
+    DltDaemonLogInfoCache loginfo_cache[DLT_DAEMON_LOGINFO_CACHE_SIZE]; /**< cached get_log_info responses */
+    int loginfo_cache_next;                      /**< next cache entry to be replaced */
 #ifdef DLT_SYSTEMD_WATCHDOG_ENFORCE_MSG_RX_ENABLE
     int received_message_since_last_watchdog_interval;
 #endif
@@ -247,6 +273,18 @@ typedef struct
 #endif
 } DltDaemon;
 
+/**
+ * Log level updates collected for the contexts of one application, to be sent
+ * with a single DLT_USER_MESSAGE_LOG_LEVEL_BATCH message.
+ */
+typedef struct
+{
+    int user_handle;                 /**< connection of the application, DLT_FD_INIT while empty */
+    char apid[DLT_ID_SIZE];          /**< application of the collected contexts */
+    uint32_t count;                  /**< number of collected entries */
+    DltUserControlMsgLogLevel entries[DLT_USER_LOG_LEVEL_BATCH_MAX]; /**< collected entries */
+} DltDaemonLogLevelBatch;
+
 /**
  * Initialise the dlt daemon structure
  * This function must be called before using further dlt daemon structure
@@ -277,6 +315,18 @@ int dlt_daemon_init(DltDaemon *daemon,
  * @return negative value if there was an error
  */
 int dlt_daemon_free(DltDaemon *daemon, int verbose);
+/**
+ * Invalidate all cached get_log_info responses.
+ * Must be called whenever applications or contexts are registered,
+ * unregistered or change their log level or trace status.
+ * @param daemon pointer to dlt daemon structure
+ */
+void dlt_daemon_loginfo_cache_invalidate(DltDaemon *daemon);
+/**
+ * Release all cached get_log_info responses.
+ * @param daemon pointer to dlt daemon structure
+ */
+void dlt_daemon_loginfo_cache_free(DltDaemon *daemon);
 /**
  * Initialize data structures to store information about applications running on same
  * or passive node.
@@ -740,6 +790,28 @@ int dlt_daemon_configuration_load(DltDaemon *daemon, const char *filename, int v
  */
 int dlt_daemon_configuration_save(DltDaemon *daemon, const char *filename, int verbose);
 
+/**
+ * Save applications and contexts of the daemon ECU to a binary snapshot.
+ * The snapshot stores size and modification time of the runtime application
+ * and context configuration files, so it must be saved after them. It is
+ * only used as long as these files are unchanged.
+ * @param daemon pointer to dlt daemon structure
+ * @param filename name of file to be used for saving
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error
+ */
+int dlt_daemon_runtime_snapshot_save(DltDaemon *daemon, const char *filename, int verbose);
+
+/**
+ * Load applications and contexts from a binary snapshot, instead of the
+ * runtime application and context configuration files
+ * @param daemon pointer to dlt daemon structure
+ * @param filename name of file to be used for loading
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error or the snapshot is outdated
+ */
+int dlt_daemon_runtime_snapshot_load(DltDaemon *daemon, const char *filename, int verbose);
+
 
 /**
  * Send user message DLT_USER_MESSAGE_LOG_LEVEL to user application
@@ -759,6 +831,38 @@ int dlt_daemon_user_send_log_level(DltDaemon *daemon, DltDaemonContext *context,
  */
 int dlt_daemon_user_send_log_level_v2(DltDaemon *daemon, DltDaemonContext *context, int verbose);
 
+/**
+ * Initialise an empty log level batch
+ * @param batch pointer to log level batch
+ */
+void dlt_daemon_user_log_level_batch_init(DltDaemonLogLevelBatch *batch);
+
+/**
+ * Add the log level and trace status of a context to a log level batch.
+ * The batch is sent first, if it belongs to another application or is full.
+ * @param daemon pointer to dlt daemon structure
+ * @param batch pointer to log level batch
+ * @param context pointer to context to be added
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error
+ */
+int dlt_daemon_user_log_level_batch_add(DltDaemon *daemon,
+                                        DltDaemonLogLevelBatch *batch,
+                                        DltDaemonContext *context,
+                                        int verbose);
+
+/**
+ * Send user message DLT_USER_MESSAGE_LOG_LEVEL_BATCH with the collected
+ * entries to the user application and empty the batch. Applications which
+ * did not announce DLT_USER_APP_FLAG_LOG_LEVEL_BATCH when registering get
+ * one DLT_USER_MESSAGE_LOG_LEVEL message per entry instead.
+ * @param daemon pointer to dlt daemon structure
+ * @param batch pointer to log level batch
+ * @param verbose if set to true verbose information is printed out.
+ * @return negative value if there was an error
+ */
+int dlt_daemon_user_log_level_batch_flush(DltDaemon *daemon, DltDaemonLogLevelBatch *batch, int verbose);
+
 /**
  * Send user message DLT_USER_MESSAGE_LOG_STATE to user application
  * @param daemon pointer to dlt daemon structure
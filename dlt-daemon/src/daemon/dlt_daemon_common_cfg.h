@@ -81,6 +81,8 @@
 #define DLT_RUNTIME_CONTEXT_CFG     "/dlt-runtime-context.cfg"
 /* Path and filename for runtime configuration */
 #define DLT_RUNTIME_CONFIGURATION     "/dlt-runtime.cfg"
+/* Path and filename for binary snapshot of runtime configuration (applications and contexts) */
+#define DLT_RUNTIME_SNAPSHOT        "/dlt-runtime.snapshot"
 
 /* Default Path for control socket */
 #define DLT_DAEMON_DEFAULT_CTRL_SOCK_PATH DLT_RUNTIME_DEFAULT_DIRECTORY \
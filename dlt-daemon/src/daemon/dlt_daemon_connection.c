@@ -48,9 +48,53 @@
 #include "dlt_gateway.h"
 #include "dlt_daemon_socket.h"
 
+/* Size of the buffer for compressed data, it is sent whenever it is full */
+#define DLT_CONNECTION_COMPRESSION_BUFSIZE 4096
+
 static DltConnectionId connectionId;
 extern char *app_recv_buffer;
 
+/** @brief Compress data and send the output to a TCP connection.
+ *
+ * The compressor holds back data until it has enough for a block, or until
+ * it is flushed. Flushing sends everything compressed so far, so that the
+ * client can decompress all messages.
+ *
+ * @param conn The connection structure.
+ * @param msg The data to be sent, NULL to only flush.
+ * @param msg_size The length of the data.
+ * @param flush Whether all data has to be sent.
+ *
+ * @return DLT_DAEMON_ERROR_OK on success, an error code otherwise.
+ */
+static int dlt_connection_send_compressed(DltConnection *conn,
+                                          const void *msg,
+                                          size_t msg_size,
+                                          bool flush)
+{
+    uint8_t out[DLT_CONNECTION_COMPRESSION_BUFSIZE];
+    const uint8_t *in = msg;
+    size_t consumed = 0;
+    size_t produced = 0;
+    int ret = DLT_DAEMON_ERROR_OK;
+
+    do {
+        if (dlt_compression_process(conn->compression, in, msg_size, out, sizeof(out),
+                                    &consumed, &produced, flush) != DLT_RETURN_OK)
+            return DLT_DAEMON_ERROR_UNKNOWN;
+
+        in += consumed;
+        msg_size -= consumed;
+
+        if (produced > 0)
+            ret = dlt_daemon_socket_sendreliable(conn->receiver->fd, out, (int)produced);
+    } while ((ret == DLT_DAEMON_ERROR_OK) && ((msg_size > 0) || (produced == sizeof(out))));
+
+    conn->compression_pending = !flush;
+
+    return ret;
+}
+
 /** @brief Generic sending function.
  *
  * We manage different type of connection which have similar send/write
@@ -88,6 +132,9 @@ DLT_STATIC int dlt_connection_send(DltConnection *conn,
         if (msg_size > INT_MAX) {
             return DLT_DAEMON_ERROR_UNKNOWN;
         }
+        if (conn->compression != NULL)
+            return dlt_connection_send_compressed(conn, msg, msg_size, false);
+
         ret = dlt_daemon_socket_sendreliable(conn->receiver->fd,
                                             msg,
                                             (int)msg_size);
@@ -139,6 +186,42 @@ int dlt_connection_send_multiple(DltConnection *con,
     return ret;
 }
 
+/** @brief Compress the data sent through a connection from now on.
+ *
+ * @param con The client connection.
+ * @param stream Compression stream, owned by the connection on success.
+ *
+ * @return 0 on success, -1 otherwise.
+ */
+int dlt_connection_set_compression(DltConnection *con, DltCompression *stream)
+{
+    if ((con == NULL) || (stream == NULL) || (con->type != DLT_CONNECTION_CLIENT_MSG_TCP) ||
+        (con->compression != NULL))
+        return -1;
+
+    con->compression = stream;
+    con->compression_pending = 0;
+
+    return 0;
+}
+
+/** @brief Send the data held back by the compression of a connection.
+ *
+ * Called periodically, this bounds the time messages wait in the compressor.
+ *
+ * @param con The connection.
+ *
+ * @return DLT_DAEMON_ERROR_OK on success or if nothing is pending,
+ *         an error code otherwise.
+ */
+int dlt_connection_flush(DltConnection *con)
+{
+    if ((con == NULL) || (con->receiver == NULL) || (con->compression == NULL) || !con->compression_pending)
+        return DLT_DAEMON_ERROR_OK;
+
+    return dlt_connection_send_compressed(con, NULL, 0, true);
+}
+
 /** @brief Get the next connection filtered with a type mask.
  *
  * In some cases we need the next connection available of a specific type or
@@ -245,15 +328,9 @@ DLT_STATIC DltReceiver *dlt_connection_get_receiver(DltDaemonLocal *daemon_local
     case DLT_CONNECTION_APP_CONNECT:
     /* FALL THROUGH */
 #endif
-    case DLT_CONNECTION_ONE_S_TIMER:
-    /* FALL THROUGH */
-    case DLT_CONNECTION_SIXTY_S_TIMER:
-#ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    /* FALL THROUGH */
-    case DLT_CONNECTION_SYSTEMD_TIMER:
-#endif
+    case DLT_CONNECTION_TIMER:
     /* FALL THROUGH */
-    case DLT_CONNECTION_GATEWAY_TIMER:
+    case DLT_CONNECTION_STORAGE_WRITER:
         ret = calloc(1, sizeof(DltReceiver));
 
         if (ret)
@@ -308,17 +385,9 @@ void *dlt_connection_get_callback(DltConnection *con)
     case DLT_CONNECTION_APP_MSG:
         ret = (void *)(intptr_t)dlt_daemon_process_user_messages;
         break;
-    case DLT_CONNECTION_ONE_S_TIMER:
-        ret = (void *)(intptr_t)dlt_daemon_process_one_s_timer;
-        break;
-    case DLT_CONNECTION_SIXTY_S_TIMER:
-        ret = (void *)(intptr_t)dlt_daemon_process_sixty_s_timer;
-        break;
-#ifdef DLT_SYSTEMD_WATCHDOG_ENABLE
-    case DLT_CONNECTION_SYSTEMD_TIMER:
-        ret = (void *)(intptr_t)dlt_daemon_process_systemd_timer;
+    case DLT_CONNECTION_TIMER:
+        ret = (void *)(intptr_t)dlt_daemon_process_timers;
         break;
-#endif
     case DLT_CONNECTION_CONTROL_CONNECT:
         ret = (void *)(intptr_t)dlt_daemon_process_control_connect;
         break;
@@ -328,8 +397,8 @@ void *dlt_connection_get_callback(DltConnection *con)
     case DLT_CONNECTION_GATEWAY:
         ret = (void *)(intptr_t)dlt_gateway_process_passive_node_messages;
         break;
-    case DLT_CONNECTION_GATEWAY_TIMER:
-        ret = (void *)(intptr_t)dlt_gateway_process_gateway_timer;
+    case DLT_CONNECTION_STORAGE_WRITER:
+        ret = (void *)(intptr_t)dlt_daemon_process_storage_writer;
         break;
     default:
         ret = NULL;
@@ -350,6 +419,17 @@ void *dlt_connection_get_callback(DltConnection *con)
 void dlt_connection_destroy(DltConnection *to_destroy)
 {
     to_destroy->id = 0;
+
+    if (to_destroy->filter != NULL) {
+        dlt_filter_free(to_destroy->filter, 0);
+        free(to_destroy->filter);
+    }
+
+    dlt_compression_free(to_destroy->compression);
+    dlt_daemon_timer_cancel(&to_destroy->timer);
+    dlt_daemon_timer_cancel(&to_destroy->loginfo_timer);
+    free(to_destroy->loginfo);
+
     close(to_destroy->receiver->fd);
     dlt_connection_destroy_receiver(to_destroy);
     free(to_destroy);
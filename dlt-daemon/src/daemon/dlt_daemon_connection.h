@@ -33,6 +33,8 @@
 #include "dlt-daemon.h"
 
 int dlt_connection_send_multiple(DltConnection *, void *, int, void *, int, int);
+int dlt_connection_set_compression(DltConnection *, DltCompression *);
+int dlt_connection_flush(DltConnection *);
 
 DltConnection *dlt_connection_get_next(DltConnection *, int);
 int dlt_connection_create_remaining(DltDaemonLocal *);
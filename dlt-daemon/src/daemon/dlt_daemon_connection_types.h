@@ -28,6 +28,8 @@
 #ifndef DLT_DAEMON_CONNECTION_TYPES_H
 #define DLT_DAEMON_CONNECTION_TYPES_H
 #include "dlt_common.h"
+#include "dlt_compression.h"
+#include "dlt_daemon_timer.h"
 
 typedef enum {
     UNDEFINED, /* Undefined status */
@@ -44,13 +46,11 @@ typedef enum {
     DLT_CONNECTION_CLIENT_MSG_SERIAL,
     DLT_CONNECTION_APP_CONNECT,
     DLT_CONNECTION_APP_MSG,
-    DLT_CONNECTION_ONE_S_TIMER,
-    DLT_CONNECTION_SIXTY_S_TIMER,
-    DLT_CONNECTION_SYSTEMD_TIMER,
+    DLT_CONNECTION_TIMER,
     DLT_CONNECTION_CONTROL_CONNECT,
     DLT_CONNECTION_CONTROL_MSG,
     DLT_CONNECTION_GATEWAY,
-    DLT_CONNECTION_GATEWAY_TIMER,
+    DLT_CONNECTION_STORAGE_WRITER,
     DLT_CONNECTION_TYPE_MAX
 } DltConnectionType;
 
@@ -59,13 +59,11 @@ typedef enum {
 #define DLT_CON_MASK_CLIENT_MSG_SERIAL  (1 << DLT_CONNECTION_CLIENT_MSG_SERIAL)
 #define DLT_CON_MASK_APP_MSG            (1 << DLT_CONNECTION_APP_MSG)
 #define DLT_CON_MASK_APP_CONNECT        (1 << DLT_CONNECTION_APP_CONNECT)
-#define DLT_CON_MASK_ONE_S_TIMER        (1 << DLT_CONNECTION_ONE_S_TIMER)
-#define DLT_CON_MASK_SIXTY_S_TIMER      (1 << DLT_CONNECTION_SIXTY_S_TIMER)
-#define DLT_CON_MASK_SYSTEMD_TIMER      (1 << DLT_CONNECTION_SYSTEMD_TIMER)
+#define DLT_CON_MASK_TIMER              (1 << DLT_CONNECTION_TIMER)
 #define DLT_CON_MASK_CONTROL_CONNECT    (1 << DLT_CONNECTION_CONTROL_CONNECT)
 #define DLT_CON_MASK_CONTROL_MSG        (1 << DLT_CONNECTION_CONTROL_MSG)
 #define DLT_CON_MASK_GATEWAY            (1 << DLT_CONNECTION_GATEWAY)
-#define DLT_CON_MASK_GATEWAY_TIMER      (1 << DLT_CONNECTION_GATEWAY_TIMER)
+#define DLT_CON_MASK_STORAGE_WRITER     (1 << DLT_CONNECTION_STORAGE_WRITER)
 #define DLT_CON_MASK_ALL                (0xffff)
 
 typedef uintptr_t DltConnectionId;
@@ -80,6 +78,12 @@ typedef struct DltConnection {
     DltConnectionStatus status; /**< Status of connection */
     struct DltConnection *next;   /**< For multiple client connection using linked list */
     int ev_mask; /**< Mask to set when registering the connection for events */
+    DltFilter *filter; /**< Messages requested by the client, NULL for all */
+    DltCompression *compression; /**< Compression of the data sent to the client, NULL if uncompressed */
+    int compression_pending; /**< Data was compressed since the last flush */
+    DltDaemonTimer timer; /**< Timer of the connection, e.g. flushing the compressed data */
+    DltDaemonTimer loginfo_timer; /**< Sends the next part of a streamed get_log_info response */
+    struct DltDaemonLogInfoStream *loginfo; /**< get_log_info response still being sent, NULL if none */
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
     int remaining_size; /**< Remaining data size for sending data. This value will be set to non-zero when data could not be sent fully */
 #endif
@@ -43,6 +43,7 @@
 #include "dlt_daemon_connection_types.h"
 #include "dlt_daemon_event_handler.h"
 #include "dlt_daemon_event_handler_types.h"
+#include "dlt_gateway.h"
 #include "dlt_daemon_common.h"
 
 /**
@@ -230,7 +231,13 @@ int dlt_daemon_handle_event(DltEventHandler *pEvent,
         if (pEvent->pfd[i].revents & DLT_EV_MASK_REJECTED) {
             /* An error occurred, we need to clean-up the concerned event
              */
-            if (type == DLT_CONNECTION_CLIENT_MSG_TCP)
+            if (type == DLT_CONNECTION_GATEWAY)
+                /* Passive node connections keep track of their own state,
+                 * the gateway also removes the connection from the event loop.
+                 */
+                dlt_gateway_process_passive_node_hangup(daemon_local, fd,
+                                                        daemon_local->flags.vflag);
+            else if (type == DLT_CONNECTION_CLIENT_MSG_TCP)
                 /* To transition to BUFFER state if this is final TCP client connection,
                  * call dedicated function. this function also calls
                  * dlt_event_handler_unregister_connection() inside the function.
@@ -448,6 +455,46 @@ int dlt_connection_check_activate(DltEventHandler *evhdl,
     return 0;
 }
 
+/** @brief Change the events watched for an already registered connection.
+ *
+ * The poll entry of an active connection is updated in place, so that the
+ * descriptor list keeps its order while events are being dispatched. This
+ * is used e.g. by passive node connections, which wait for POLLOUT while a
+ * non-blocking connect is in progress and for POLLIN afterwards.
+ *
+ * @param evhdl The event handler structure where the connection list is.
+ * @param con The connection to update.
+ * @param mask The new bit mask of events to be watched.
+ *
+ * @return 0 on success, -1 otherwise.
+ */
+int dlt_event_handler_update_connection_mask(DltEventHandler *evhdl,
+                                             DltConnection *con,
+                                             int mask)
+{
+    nfds_t i = 0;
+
+    if (!evhdl || !con || !con->receiver) {
+        dlt_vlog(LOG_ERR, "%s: wrong parameters.\n", __func__);
+        return -1;
+    }
+
+    con->ev_mask = mask;
+
+    if (con->status != ACTIVE)
+        /* applied on next activation */
+        return 0;
+
+    for (i = 0; i < evhdl->nfds; i++) {
+        if (evhdl->pfd[i].fd == con->receiver->fd) {
+            evhdl->pfd[i].events = (short)mask;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
 /** @brief Registers a connection for event handling and takes its ownership.
  *
  * As we add the connection to the list of connection, we take its ownership.
@@ -530,6 +577,9 @@ int dlt_event_handler_unregister_connection(DltEventHandler *evhdl,
             daemon_local->client_connections = 0;
             dlt_log(LOG_CRIT, "Unregistering more client than registered!\n");
         }
+
+        if ((temp->filter != NULL) && (daemon_local->client_filters > 0))
+            daemon_local->client_filters--;
     }
 
     if (dlt_connection_check_activate(evhdl,
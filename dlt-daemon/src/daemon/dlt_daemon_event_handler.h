@@ -56,6 +56,10 @@ int dlt_event_handler_unregister_connection(DltEventHandler *,
 int dlt_connection_check_activate(DltEventHandler *,
                                   DltConnection *,
                                   int);
+
+int dlt_event_handler_update_connection_mask(DltEventHandler *,
+                                             DltConnection *,
+                                             int);
 #ifdef DLT_UNIT_TESTS
 int dlt_daemon_remove_connection(DltEventHandler *ev,
                                  DltConnection *to_remove);
@@ -431,6 +431,8 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_update_passive_node_context_v2(
  * @param context           DltDaemonContext structure
  * @param ecuid             ECU id
  * @param loglevel          log level to be set to context
+ * @param batch             log level batch to collect the update in, or NULL
+ *                          to send it immediately
  * @param verbose           If set to true verbose information is printed out
  * @return                  0 on success, -1 on error
  */
@@ -439,6 +441,7 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_send_log_level(DltDaemon *daemon
                                                                DltDaemonContext *context,
                                                                char *ecuid,
                                                                int loglevel,
+                                                               DltDaemonLogLevelBatch *batch,
                                                                int verbose)
 {
     int old_log_level = -1;
@@ -457,7 +460,9 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_send_log_level(DltDaemon *daemon
                                                                         context->storage_log_level);
 
         if (context->storage_log_level > old_log_level) {
-            if (dlt_daemon_user_send_log_level(daemon, context, verbose) == -1) {
+            if (((batch != NULL) ?
+                 dlt_daemon_user_log_level_batch_add(daemon, batch, context, verbose) :
+                 dlt_daemon_user_send_log_level(daemon, context, verbose)) == -1) {
                 dlt_log(LOG_ERR, "Unable to update log level\n");
                 return DLT_RETURN_ERROR;
             }
@@ -554,6 +559,8 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_send_log_level_v2(DltDaemon *dae
  * @param context           DltDaemonContext structure
  * @param ecuid             ECU ID
  * @param loglevel          log level to be set to context
+ * @param batch             log level batch to collect the update in, or NULL
+ *                          to send it immediately
  * @param verbose           If set to true verbose information is printed out
  * @return                  0 on success, -1 on error
  */
@@ -562,6 +569,7 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_reset_log_level(DltDaemon *daemo
                                                                 DltDaemonContext *context,
                                                                 char *ecuid,
                                                                 int loglevel,
+                                                                DltDaemonLogLevelBatch *batch,
                                                                 int verbose)
 {
     if ((daemon == NULL) || (daemon_local == NULL) || (ecuid == NULL) ||
@@ -575,9 +583,9 @@ DLT_STATIC DltReturnValue dlt_daemon_logstorage_reset_log_level(DltDaemon *daemo
 
     if (loglevel == DLT_DAEMON_LOGSTORAGE_RESET_SEND_LOGLEVEL) {
         if (strncmp(ecuid, daemon->ecuid, DLT_ID_SIZE) == 0) {
-            if (dlt_daemon_user_send_log_level(daemon,
-                                               context,
-                                               verbose) == DLT_RETURN_ERROR) {
+            if (((batch != NULL) ?
+                 dlt_daemon_user_log_level_batch_add(daemon, batch, context, verbose) :
+                 dlt_daemon_user_send_log_level(daemon, context, verbose)) == DLT_RETURN_ERROR) {
                 dlt_log(LOG_ERR, "Unable to update log level\n");
                 return DLT_RETURN_ERROR;
             }
@@ -680,6 +688,7 @@ DltReturnValue dlt_logstorage_update_all_contexts(DltDaemon *daemon,
                                                   int verbose)
 {
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonLogLevelBatch batch;
     int i = 0;
     char tmp_id[DLT_ID_SIZE + 1] = { '\0' };
 
@@ -690,6 +699,8 @@ DltReturnValue dlt_logstorage_update_all_contexts(DltDaemon *daemon,
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
+    dlt_daemon_user_log_level_batch_init(&batch);
+
     user_list = dlt_daemon_find_users_list(daemon, ecuid, verbose);
 
     if (user_list == NULL)
@@ -711,6 +722,7 @@ DltReturnValue dlt_logstorage_update_all_contexts(DltDaemon *daemon,
                                                      &user_list->contexts[i],
                                                      ecuid,
                                                      curr_log_level,
+                                                     &batch,
                                                      verbose);
             else /* The request is to reset log levels */
                 dlt_daemon_logstorage_reset_log_level(daemon,
@@ -718,10 +730,14 @@ DltReturnValue dlt_logstorage_update_all_contexts(DltDaemon *daemon,
                                                       &user_list->contexts[i],
                                                       ecuid,
                                                       curr_log_level,
+                                                      &batch,
                                                       verbose);
         }
     }
 
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &batch, verbose) == -1)
+        dlt_log(LOG_ERR, "Unable to update log level\n");
+
     return DLT_RETURN_OK;
 }
 
@@ -753,6 +769,7 @@ DltReturnValue dlt_logstorage_update_all_contexts_v2(DltDaemon *daemon,
                                                   int verbose)
 {
     DltDaemonRegisteredUsers *user_list = NULL;
+    DltDaemonLogLevelBatch batch;
     int i = 0;
     uint8_t tmp_id_size = 0;
     char tmp_id[DLT_V2_ID_SIZE];
@@ -765,6 +782,8 @@ DltReturnValue dlt_logstorage_update_all_contexts_v2(DltDaemon *daemon,
     }
 
     /* Check ecuid length is captured using strlen in runtime */
+    dlt_daemon_user_log_level_batch_init(&batch);
+
     user_list = dlt_daemon_find_users_list_v2(daemon, (uint8_t)strlen(ecuid), ecuid, verbose);
 
     if (user_list == NULL)
@@ -794,6 +813,7 @@ DltReturnValue dlt_logstorage_update_all_contexts_v2(DltDaemon *daemon,
                                                      &user_list->contexts[i],
                                                      ecuid,
                                                      curr_log_level,
+                                                     &batch,
                                                      verbose);
             else /* The request is to reset log levels */
                 dlt_daemon_logstorage_reset_log_level(daemon,
@@ -801,10 +821,14 @@ DltReturnValue dlt_logstorage_update_all_contexts_v2(DltDaemon *daemon,
                                                       &user_list->contexts[i],
                                                       ecuid,
                                                       curr_log_level,
+                                                      &batch,
                                                       verbose);
         }
     }
 
+    if (dlt_daemon_user_log_level_batch_flush(daemon, &batch, verbose) == -1)
+        dlt_log(LOG_ERR, "Unable to update log level\n");
+
     return DLT_RETURN_OK;
 }
 
@@ -850,6 +874,7 @@ DltReturnValue dlt_logstorage_update_context(DltDaemon *daemon,
                                                         context,
                                                         ecuid,
                                                         curr_log_level,
+                                                        NULL,
                                                         verbose);
         else /* The request is to reset log levels */
             return dlt_daemon_logstorage_reset_log_level(daemon,
@@ -857,6 +882,7 @@ DltReturnValue dlt_logstorage_update_context(DltDaemon *daemon,
                                                          context,
                                                          ecuid,
                                                          curr_log_level,
+                                                         NULL,
                                                          verbose);
     }
     else {
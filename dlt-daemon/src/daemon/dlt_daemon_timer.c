@@ -0,0 +1,297 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_daemon_timer.c
+ * Hierarchical timer wheel for the daemon timers.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "dlt_daemon_timer.h"
+
+#define DLT_DAEMON_TIMER_MASK   ((uint64_t)DLT_DAEMON_TIMER_SLOTS - 1)
+#define DLT_DAEMON_TIMER_RANGE  ((uint64_t)1 << (DLT_DAEMON_TIMER_SLOT_BITS * DLT_DAEMON_TIMER_LEVELS))
+
+/* timers which are being run are kept in wheel->expired, marked by this level */
+#define DLT_DAEMON_TIMER_EXPIRED DLT_DAEMON_TIMER_LEVELS
+
+static DltDaemonTimer **dlt_daemon_timer_head(DltDaemonTimerWheel *wheel, int level, int slot)
+{
+    if (level == DLT_DAEMON_TIMER_EXPIRED)
+        return &wheel->expired;
+
+    return &wheel->slots[level][slot];
+}
+
+static void dlt_daemon_timer_link(DltDaemonTimerWheel *wheel, DltDaemonTimer *timer, int level, int slot)
+{
+    DltDaemonTimer **head = dlt_daemon_timer_head(wheel, level, slot);
+
+    timer->wheel = wheel;
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = *head;
+
+    if (*head != NULL)
+        (*head)->prev = timer;
+
+    *head = timer;
+
+    if (level != DLT_DAEMON_TIMER_EXPIRED)
+        wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+static void dlt_daemon_timer_unlink(DltDaemonTimer *timer)
+{
+    DltDaemonTimerWheel *wheel = timer->wheel;
+    DltDaemonTimer **head = dlt_daemon_timer_head(wheel, timer->level, timer->slot);
+
+    if (timer->prev != NULL)
+        timer->prev->next = timer->next;
+    else
+        *head = timer->next;
+
+    if (timer->next != NULL)
+        timer->next->prev = timer->prev;
+
+    if ((timer->level != DLT_DAEMON_TIMER_EXPIRED) && (*head == NULL))
+        wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+/* Put a timer into the lowest level covering its expiry */
+static void dlt_daemon_timer_place(DltDaemonTimerWheel *wheel, DltDaemonTimer *timer)
+{
+    uint64_t expires = timer->expires;
+    uint64_t delta = 0;
+    int level = 0;
+
+    if (expires < wheel->now)
+        expires = wheel->now;
+
+    delta = expires - wheel->now;
+
+    /* beyond the top level, the timer is placed again when its slot is reached */
+    if (delta >= DLT_DAEMON_TIMER_RANGE) {
+        delta = DLT_DAEMON_TIMER_RANGE - 1;
+        expires = wheel->now + delta;
+    }
+
+    while ((level < DLT_DAEMON_TIMER_LEVELS - 1) &&
+           ((delta >> (DLT_DAEMON_TIMER_SLOT_BITS * (level + 1))) != 0))
+        level++;
+
+    dlt_daemon_timer_link(wheel, timer,
+                          level,
+                          (int)((expires >> (DLT_DAEMON_TIMER_SLOT_BITS * level)) & DLT_DAEMON_TIMER_MASK));
+}
+
+/**
+ * Find the first non-empty slot of a level, in the order in which the wheel
+ * reaches the slots.
+ *
+ * @param wheel the timer wheel
+ * @param level level to search
+ * @param tick set to the time the slot is reached
+ * @return slot index, -1 if the level is empty
+ */
+static int dlt_daemon_timer_first_slot(DltDaemonTimerWheel *wheel, int level, uint64_t *tick)
+{
+    int shift = DLT_DAEMON_TIMER_SLOT_BITS * level;
+    uint64_t occupied = wheel->occupied[level];
+    uint64_t start = wheel->now >> shift;
+    unsigned int rotate = 0;
+    int offset = 0;
+
+    if (occupied == 0)
+        return -1;
+
+    /* the slot of the current time was already reached, unless it starts now */
+    if ((wheel->now & (((uint64_t)1 << shift) - 1)) != 0)
+        start++;
+
+    rotate = (unsigned int)(start & DLT_DAEMON_TIMER_MASK);
+
+    if (rotate != 0)
+        occupied = (occupied >> rotate) | (occupied << (DLT_DAEMON_TIMER_SLOTS - rotate));
+
+    offset = __builtin_ctzll(occupied);
+    *tick = (start + (uint64_t)offset) << shift;
+
+    return (int)((start + (uint64_t)offset) & DLT_DAEMON_TIMER_MASK);
+}
+
+/* Move the timers of all slots starting at the current time a level down */
+static void dlt_daemon_timer_cascade(DltDaemonTimerWheel *wheel)
+{
+    DltDaemonTimer *timer = NULL;
+    int level = 0;
+    int slot = 0;
+
+    for (level = DLT_DAEMON_TIMER_LEVELS - 1; level > 0; level--) {
+        int shift = DLT_DAEMON_TIMER_SLOT_BITS * level;
+
+        if ((wheel->now & (((uint64_t)1 << shift) - 1)) != 0)
+            continue;
+
+        slot = (int)((wheel->now >> shift) & DLT_DAEMON_TIMER_MASK);
+
+        while ((timer = wheel->slots[level][slot]) != NULL) {
+            dlt_daemon_timer_unlink(timer);
+            dlt_daemon_timer_place(wheel, timer);
+        }
+    }
+}
+
+void dlt_daemon_timer_wheel_init(DltDaemonTimerWheel *wheel, uint64_t now)
+{
+    if (wheel == NULL)
+        return;
+
+    memset(wheel, 0, sizeof(DltDaemonTimerWheel));
+    wheel->now = now;
+}
+
+int dlt_daemon_timer_add(DltDaemonTimerWheel *wheel,
+                         DltDaemonTimer *timer,
+                         uint64_t expires,
+                         uint32_t period,
+                         DltDaemonTimerCallback callback,
+                         void *data)
+{
+    if ((wheel == NULL) || (timer == NULL) || (callback == NULL))
+        return -1;
+
+    dlt_daemon_timer_cancel(timer);
+
+    timer->expires = expires;
+    timer->period = period;
+    timer->callback = callback;
+    timer->data = data;
+
+    dlt_daemon_timer_place(wheel, timer);
+    wheel->count++;
+
+    return 0;
+}
+
+void dlt_daemon_timer_cancel(DltDaemonTimer *timer)
+{
+    if ((timer == NULL) || (timer->wheel == NULL))
+        return;
+
+    timer->wheel->count--;
+    dlt_daemon_timer_unlink(timer);
+    timer->wheel = NULL;
+}
+
+int dlt_daemon_timer_pending(const DltDaemonTimer *timer)
+{
+    return (timer != NULL) && (timer->wheel != NULL);
+}
+
+int dlt_daemon_timer_wheel_advance(DltDaemonTimerWheel *wheel, uint64_t now, void *ctx)
+{
+    DltDaemonTimer *timer = NULL;
+    uint64_t tick = 0;
+    uint64_t next = 0;
+    int expired = 0;
+    int level = 0;
+    int slot = 0;
+
+    if (wheel == NULL)
+        return -1;
+
+    while (wheel->now <= now) {
+        /* skip to the next slot with timers to move or to run */
+        next = UINT64_MAX;
+
+        for (level = 0; level < DLT_DAEMON_TIMER_LEVELS; level++)
+            if ((dlt_daemon_timer_first_slot(wheel, level, &tick) >= 0) && (tick < next))
+                next = tick;
+
+        if (next > now) {
+            wheel->now = now + 1;
+            break;
+        }
+
+        wheel->now = next;
+        dlt_daemon_timer_cascade(wheel);
+
+        /* timers added by the callbacks expire on the next tick at the earliest */
+        slot = (int)(next & DLT_DAEMON_TIMER_MASK);
+        wheel->now = next + 1;
+
+        while ((timer = wheel->slots[0][slot]) != NULL) {
+            dlt_daemon_timer_unlink(timer);
+            dlt_daemon_timer_link(wheel, timer, DLT_DAEMON_TIMER_EXPIRED, 0);
+        }
+
+        while ((timer = wheel->expired) != NULL) {
+            dlt_daemon_timer_cancel(timer);
+
+            if (timer->period > 0) {
+                /* missed periods are dropped */
+                tick = timer->expires + timer->period;
+
+                if (tick <= now)
+                    tick += (now - tick) / timer->period * timer->period + timer->period;
+
+                timer->expires = tick;
+                dlt_daemon_timer_place(wheel, timer);
+                wheel->count++;
+            }
+
+            timer->callback(timer, ctx);
+            expired++;
+        }
+    }
+
+    return expired;
+}
+
+int dlt_daemon_timer_wheel_next(DltDaemonTimerWheel *wheel, uint64_t *expires)
+{
+    DltDaemonTimer *timer = NULL;
+    uint64_t tick = 0;
+    uint64_t next = UINT64_MAX;
+    int level = 0;
+    int slot = 0;
+
+    if ((wheel == NULL) || (expires == NULL) || (wheel->count == 0))
+        return -1;
+
+    /* the first slot reached holds the earliest timers of its level */
+    for (level = 0; level < DLT_DAEMON_TIMER_LEVELS; level++) {
+        slot = dlt_daemon_timer_first_slot(wheel, level, &tick);
+
+        if (slot < 0)
+            continue;
+
+        for (timer = wheel->slots[level][slot]; timer != NULL; timer = timer->next)
+            if (timer->expires < next)
+                next = timer->expires;
+    }
+
+    if (next == UINT64_MAX)
+        return -1;
+
+    *expires = (next < wheel->now) ? wheel->now : next;
+
+    return 0;
+}
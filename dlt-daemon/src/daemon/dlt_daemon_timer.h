@@ -0,0 +1,126 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_daemon_timer.h
+ * Hierarchical timer wheel for the daemon timers.
+ *
+ * Time is counted in milliseconds. Level 0 of the wheel has one slot per
+ * millisecond, every further level has slots 64 times as long. A timer is
+ * put into the lowest level that covers its expiry and moved down a level
+ * whenever the wheel reaches the start of its slot. Adding and cancelling a
+ * timer is O(1), the timer structure is embedded by the owner, so timers need
+ * no allocation.
+ *
+ * The wheel does not read a clock itself. The owner passes the current time
+ * to dlt_daemon_timer_wheel_advance() and waits until the time returned by
+ * dlt_daemon_timer_wheel_next(), e.g. with a single timerfd.
+ */
+
+#ifndef DLT_DAEMON_TIMER_H
+#define DLT_DAEMON_TIMER_H
+
+#include <stdint.h>
+
+#define DLT_DAEMON_TIMER_LEVELS     5
+#define DLT_DAEMON_TIMER_SLOT_BITS  6
+#define DLT_DAEMON_TIMER_SLOTS      (1 << DLT_DAEMON_TIMER_SLOT_BITS)
+
+typedef struct DltDaemonTimer DltDaemonTimer;
+typedef struct DltDaemonTimerWheel DltDaemonTimerWheel;
+
+/**
+ * Called when a timer expires. A periodic timer is already scheduled again,
+ * the callback may cancel or add any timer, including this one.
+ * @param timer the expired timer
+ * @param ctx context passed to dlt_daemon_timer_wheel_advance()
+ */
+typedef void (*DltDaemonTimerCallback)(DltDaemonTimer *timer, void *ctx);
+
+struct DltDaemonTimer {
+    DltDaemonTimer *next;            /**< next timer in the same slot */
+    DltDaemonTimer *prev;            /**< previous timer in the same slot, NULL for the first */
+    DltDaemonTimerWheel *wheel;      /**< wheel the timer is pending in, NULL if not pending */
+    int level;                       /**< level of the slot */
+    int slot;                        /**< slot within the level */
+    uint64_t expires;                /**< expiry time in ms */
+    uint32_t period;                 /**< period in ms, 0 for a one-shot timer */
+    DltDaemonTimerCallback callback; /**< called on expiry */
+    void *data;                      /**< owner data, e.g. the connection */
+};
+
+struct DltDaemonTimerWheel {
+    uint64_t now;                                                        /**< next ms to process */
+    uint64_t occupied[DLT_DAEMON_TIMER_LEVELS];                          /**< non-empty slots per level */
+    DltDaemonTimer *slots[DLT_DAEMON_TIMER_LEVELS][DLT_DAEMON_TIMER_SLOTS];
+    DltDaemonTimer *expired;                                             /**< timers being run */
+    unsigned int count;                                                  /**< number of pending timers */
+};
+
+/**
+ * Initialize an empty timer wheel. A zero initialized wheel is valid as well,
+ * its time starts at 0 then.
+ * @param wheel the timer wheel
+ * @param now current time in ms
+ */
+void dlt_daemon_timer_wheel_init(DltDaemonTimerWheel *wheel, uint64_t now);
+
+/**
+ * Schedule a timer. A timer which is already pending is moved.
+ * @param wheel the timer wheel
+ * @param timer the timer, owned by the caller until it expired or was cancelled
+ * @param expires expiry time in ms, a time in the past expires on the next advance
+ * @param period period in ms for a periodic timer, 0 for a one-shot timer
+ * @param callback called on expiry
+ * @param data owner data stored in the timer
+ * @return negative value if there was an error
+ */
+int dlt_daemon_timer_add(DltDaemonTimerWheel *wheel,
+                         DltDaemonTimer *timer,
+                         uint64_t expires,
+                         uint32_t period,
+                         DltDaemonTimerCallback callback,
+                         void *data);
+
+/**
+ * Cancel a timer. Cancelling a timer which is not pending has no effect.
+ * @param timer the timer
+ */
+void dlt_daemon_timer_cancel(DltDaemonTimer *timer);
+
+/**
+ * Check whether a timer is pending.
+ * @param timer the timer
+ * @return 1 if the timer is pending, 0 otherwise
+ */
+int dlt_daemon_timer_pending(const DltDaemonTimer *timer);
+
+/**
+ * Run the callbacks of all timers expired up to now. A periodic timer which
+ * missed several periods runs once.
+ * @param wheel the timer wheel
+ * @param now current time in ms
+ * @param ctx context passed to the callbacks
+ * @return number of expired timers, negative value if there was an error
+ */
+int dlt_daemon_timer_wheel_advance(DltDaemonTimerWheel *wheel, uint64_t now, void *ctx);
+
+/**
+ * Get the expiry time of the next timer.
+ * @param wheel the timer wheel
+ * @param expires set to the expiry time in ms
+ * @return 0 if a timer is pending, negative value otherwise
+ */
+int dlt_daemon_timer_wheel_next(DltDaemonTimerWheel *wheel, uint64_t *expires);
+
+#endif /* DLT_DAEMON_TIMER_H */
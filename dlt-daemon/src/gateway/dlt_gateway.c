@@ -27,6 +27,8 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <stdio.h>
 #include <string.h>
 #include <syslog.h>
@@ -647,6 +649,86 @@ int dlt_gateway_store_connection(DltGateway *gateway,
     return DLT_RETURN_OK;
 }
 
+/**
+ * Pack an ECU id into an integer key, as used for the ECU index
+ *
+ * @param ecu       ECU id, not necessarily zero terminated
+ * @return packed ECU id
+ */
+static uint32_t dlt_gateway_ecu_key(const char *ecu)
+{
+    char id[DLT_ID_SIZE] = { 0 };
+    uint32_t key = 0;
+
+    strncpy(id, ecu, DLT_ID_SIZE);
+    memcpy(&key, id, sizeof(key));
+
+    return key;
+}
+
+/**
+ * Return the first ECU index slot to probe for a key
+ *
+ * @param gateway   DltGateway
+ * @param key       packed ECU id
+ * @return slot number
+ */
+static int dlt_gateway_ecu_slot(DltGateway *gateway, uint32_t key)
+{
+    /* Fibonacci hashing, the ECU index size is a power of two */
+    return (int)((key * 2654435769U) >> 16) & (gateway->ecu_index_size - 1);
+}
+
+/**
+ * Build the hash index used to look up passive node connections by ECU id
+ *
+ * Lookups fall back to a linear search if the index cannot be allocated.
+ *
+ * @param gateway   DltGateway
+ * @return 0 on success, -1 otherwise
+ */
+DLT_STATIC int dlt_gateway_build_ecu_index(DltGateway *gateway)
+{
+    int size = 4;
+    int i = 0;
+
+    if (gateway == NULL)
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    /* keep the load factor below 0.5 */
+    while (size < 2 * gateway->num_connections)
+        size *= 2;
+
+    gateway->ecu_index = malloc((size_t)size * sizeof(int));
+
+    if (gateway->ecu_index == NULL) {
+        dlt_log(LOG_WARNING, "Cannot allocate gateway ECU index\n");
+        return DLT_RETURN_ERROR;
+    }
+
+    gateway->ecu_index_size = size;
+
+    for (i = 0; i < size; i++)
+        gateway->ecu_index[i] = -1;
+
+    for (i = 0; i < gateway->num_connections; i++) {
+        int slot = 0;
+
+        if (gateway->connections[i].ecuid == NULL)
+            continue;
+
+        slot = dlt_gateway_ecu_slot(gateway,
+                                    dlt_gateway_ecu_key(gateway->connections[i].ecuid));
+
+        while (gateway->ecu_index[slot] != -1)
+            slot = (slot + 1) & (size - 1);
+
+        gateway->ecu_index[slot] = i;
+    }
+
+    return DLT_RETURN_OK;
+}
+
 /**
  * Read configuration file and initialize connection data structures
  *
@@ -702,6 +784,8 @@ int dlt_gateway_configure(DltGateway *gateway, char *config_file, int verbose)
         gateway->num_connections = num_sections - 1;
     }
 
+    gateway->ecu_index = NULL;
+    gateway->ecu_index_size = 0;
     gateway->connections = calloc((size_t)gateway->num_connections,
                                 sizeof(DltGatewayConnection));
 
@@ -826,6 +910,10 @@ int dlt_gateway_configure(DltGateway *gateway, char *config_file, int verbose)
     }
 
     dlt_config_file_release(file);
+
+    /* ignore return value, lookups fall back to linear search */
+    dlt_gateway_build_ecu_index(gateway);
+
     return ret;
 }
 
@@ -877,7 +965,10 @@ void dlt_gateway_deinit(DltGateway *gateway, int verbose)
 
     for (i = 0; i < gateway->num_connections; i++) {
         DltGatewayConnection *c = &gateway->connections[i];
+        dlt_daemon_timer_cancel(&c->connect_timer);
         dlt_client_cleanup(&c->client, verbose);
+        free(c->batch);
+        c->batch = NULL;
         free(c->ip_address);
         c->ip_address = NULL;
         free(c->ecuid);
@@ -892,6 +983,9 @@ void dlt_gateway_deinit(DltGateway *gateway, int verbose)
 
     free(gateway->connections);
     gateway->connections = NULL;
+    free(gateway->ecu_index);
+    gateway->ecu_index = NULL;
+    gateway->ecu_index_size = 0;
 }
 
 /**
@@ -930,6 +1024,13 @@ DLT_STATIC int dlt_gateway_add_to_event_loop(DltDaemonLocal *daemon_local,
         return DLT_RETURN_ERROR;
     }
 
+    /* a pending connect was registered waiting for POLLOUT */
+    dlt_event_handler_update_connection_mask(
+        &daemon_local->pEvent,
+        dlt_event_handler_find_connection(&daemon_local->pEvent,
+                                          con->client.sock),
+        POLLIN);
+
     /* immediately send configured control messages */
     control_msg = con->p_control_msgs;
 
@@ -959,6 +1060,176 @@ DLT_STATIC int dlt_gateway_add_to_event_loop(DltDaemonLocal *daemon_local,
     return DLT_RETURN_OK;
 }
 
+/**
+ * Account for a failed connection attempt to a passive node
+ *
+ * @param con           DltGatewayConnection
+ */
+static void dlt_gateway_connection_failed(DltGatewayConnection *con)
+{
+    dlt_log(LOG_DEBUG, "Passive Node is not up. Connection failed.\n");
+
+    con->status = DLT_GATEWAY_DISCONNECTED;
+    con->timeout_cnt++;
+
+    if (con->timeout > 0) {
+        if (con->timeout_cnt > con->timeout) {
+            con->trigger = DLT_GATEWAY_DISABLED;
+            dlt_log(LOG_WARNING,
+                    "Passive Node connection retry timed out. "
+                    "Give up.\n");
+        }
+    }
+    else if (con->timeout == 0) {
+        dlt_vlog(LOG_DEBUG, "Retried [%d] times\n", con->timeout_cnt);
+    }
+}
+
+/**
+ * Abort a pending connection attempt to a passive node
+ *
+ * The socket is removed from the event loop, which closes it.
+ *
+ * @param daemon_local  DltDaemonLocal
+ * @param con           DltGatewayConnection
+ */
+static void dlt_gateway_abort_connection(DltDaemonLocal *daemon_local,
+                                         DltGatewayConnection *con)
+{
+    dlt_daemon_timer_cancel(&con->connect_timer);
+
+    if (dlt_event_handler_unregister_connection(&daemon_local->pEvent,
+                                                daemon_local,
+                                                con->client.sock) != 0)
+        close(con->client.sock);
+
+    con->client.sock = -1;
+    dlt_gateway_connection_failed(con);
+}
+
+/**
+ * Abort a connection attempt to a passive node which did not complete in time
+ *
+ * @param timer         connect timer of the DltGatewayConnection
+ * @param ctx           DltDaemonTimerContext
+ */
+static void dlt_gateway_connect_timeout(DltDaemonTimer *timer, void *ctx)
+{
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
+    DltGatewayConnection *con = NULL;
+
+    if ((timer == NULL) || (timer->data == NULL) || (context == NULL) || (context->daemon_local == NULL))
+        return;
+
+    con = (DltGatewayConnection *)timer->data;
+
+    if (con->status != DLT_GATEWAY_CONNECTING)
+        return;
+
+    dlt_vlog(LOG_DEBUG, "Connecting to passive node %s timed out\n", con->ecuid);
+    dlt_gateway_abort_connection(context->daemon_local, con);
+}
+
+/**
+ * Start a non-blocking connection to a passive node
+ *
+ * If the connection cannot be established immediately, the socket is added to
+ * the event loop waiting for POLLOUT and the connection is completed in
+ * dlt_gateway_process_passive_node_messages().
+ *
+ * @param daemon_local  DltDaemonLocal
+ * @param con           DltGatewayConnection
+ * @param verbose       verbose flag
+ * @return DLT_RETURN_OK if connected, DLT_RETURN_TRUE if pending,
+ *         DLT_RETURN_ERROR otherwise
+ */
+DLT_STATIC DltReturnValue dlt_gateway_start_connection(DltDaemonLocal *daemon_local,
+                                                       DltGatewayConnection *con,
+                                                       int verbose)
+{
+    DltReturnValue ret = DLT_RETURN_OK;
+    int interval = 0;
+
+    if ((daemon_local == NULL) || (con == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: wrong parameter\n", __func__);
+        return DLT_RETURN_WRONG_PARAMETER;
+    }
+
+    ret = dlt_client_connect_start(&con->client, verbose);
+
+    if (ret == DLT_RETURN_OK) {
+        if (dlt_gateway_add_to_event_loop(daemon_local, con, verbose) != DLT_RETURN_OK)
+            return DLT_RETURN_ERROR;
+
+        return DLT_RETURN_OK;
+    }
+
+    if (ret != DLT_RETURN_TRUE) {
+        dlt_gateway_connection_failed(con);
+        return DLT_RETURN_ERROR;
+    }
+
+    con->status = DLT_GATEWAY_CONNECTING;
+
+    if (dlt_connection_create(daemon_local,
+                              &daemon_local->pEvent,
+                              con->client.sock,
+                              POLLOUT,
+                              DLT_CONNECTION_GATEWAY) != 0) {
+        dlt_log(LOG_ERR, "Gateway connection creation failed\n");
+        close(con->client.sock);
+        con->client.sock = -1;
+        con->status = DLT_GATEWAY_DISCONNECTED;
+        return DLT_RETURN_ERROR;
+    }
+
+    /* the connect has to complete within one gateway interval */
+    interval = daemon_local->pGateway.interval;
+
+    if (interval <= 0)
+        interval = DLT_GATEWAY_TIMER_DEFAULT_INTERVAL;
+
+    if (dlt_daemon_timer_schedule(daemon_local, &con->connect_timer, interval * 1000, 0,
+                                  dlt_gateway_connect_timeout, con) != 0)
+        dlt_vlog(LOG_WARNING, "Connect timeout of passive node %s not set\n", con->ecuid);
+
+    return DLT_RETURN_TRUE;
+}
+
+/**
+ * Complete a pending connection to a passive node once its socket is writable
+ *
+ * @param daemon_local  DltDaemonLocal
+ * @param con           DltGatewayConnection
+ * @param verbose       verbose flag
+ * @return Value from DltReturnValue enum
+ */
+DLT_STATIC DltReturnValue dlt_gateway_finish_connection(DltDaemonLocal *daemon_local,
+                                                        DltGatewayConnection *con,
+                                                        int verbose)
+{
+    if ((daemon_local == NULL) || (con == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: wrong parameter\n", __func__);
+        return DLT_RETURN_WRONG_PARAMETER;
+    }
+
+    dlt_daemon_timer_cancel(&con->connect_timer);
+
+    if (dlt_client_connect_finish(&con->client, verbose) != DLT_RETURN_OK) {
+        dlt_gateway_abort_connection(daemon_local, con);
+        return DLT_RETURN_OK;
+    }
+
+    dlt_vlog(LOG_INFO, "Connected to passive node %s\n", con->ecuid);
+
+    if (dlt_gateway_add_to_event_loop(daemon_local, con, verbose) != DLT_RETURN_OK) {
+        dlt_log(LOG_ERR, "Gateway connection creation failed\n");
+        return DLT_RETURN_ERROR;
+    }
+
+    return DLT_RETURN_OK;
+}
+
 int dlt_gateway_establish_connections(DltGateway *gateway,
                                       DltDaemonLocal *daemon_local,
                                       int verbose)
@@ -977,35 +1248,18 @@ int dlt_gateway_establish_connections(DltGateway *gateway,
         DltGatewayConnection *con = &(gateway->connections[i]);
         DltPassiveControlMessage *control_msg = NULL;
 
+        if (con->status == DLT_GATEWAY_CONNECTING)
+            /* aborted by the connect timer of the node if it does not complete */
+            continue;
+
         if ((con->status != DLT_GATEWAY_CONNECTED) &&
             (con->trigger != DLT_GATEWAY_ON_DEMAND) &&
             (con->trigger != DLT_GATEWAY_DISABLED)) {
-            ret = dlt_client_connect(&con->client, verbose);
+            ret = dlt_gateway_start_connection(daemon_local, con, verbose);
 
-            if (ret == 0) {
-                /* setup dlt connection and add to poll event loop here */
-                if (dlt_gateway_add_to_event_loop(daemon_local, con, verbose) != DLT_RETURN_OK) {
-                    dlt_log(LOG_ERR, "Gateway connection creation failed\n");
-                    return DLT_RETURN_ERROR;
-                }
-            }
-            else {
-                dlt_log(LOG_DEBUG,
-                        "Passive Node is not up. Connection failed.\n");
-
-                con->timeout_cnt++;
-
-                if (con->timeout > 0) {
-                    if (con->timeout_cnt > con->timeout) {
-                        con->trigger = DLT_GATEWAY_DISABLED;
-                        dlt_log(LOG_WARNING,
-                                "Passive Node connection retry timed out. "
-                                "Give up.\n");
-                    }
-                }
-                else if (con->timeout == 0) {
-                    dlt_vlog(LOG_DEBUG, "Retried [%d] times\n", con->timeout_cnt);
-                }
+            if ((ret == DLT_RETURN_ERROR) && (con->status == DLT_GATEWAY_CONNECTED)) {
+                dlt_log(LOG_ERR, "Gateway connection creation failed\n");
+                return DLT_RETURN_ERROR;
             }
         }
         else if ((con->status == DLT_GATEWAY_CONNECTED) &&
@@ -1061,7 +1315,9 @@ DltReceiver *dlt_gateway_get_connection_receiver(DltGateway *gateway, int fd)
     for (i = 0; i < gateway->num_connections; i++) {
         DltGatewayConnection *c = &gateway->connections[i];
 
-        if ((c->status == DLT_GATEWAY_CONNECTED) && (c->client.sock == fd))
+        if (((c->status == DLT_GATEWAY_CONNECTED) ||
+             (c->status == DLT_GATEWAY_CONNECTING)) &&
+            (c->client.sock == fd))
             return &c->client.receiver;
     }
 
@@ -1280,12 +1536,69 @@ DLT_STATIC int dlt_gateway_control_service_logstorage(DltDaemon *daemon,
     return DLT_RETURN_OK;
 }
 
+/**
+ * Find the passive node connection using a socket
+ *
+ * @param gateway       DltGateway
+ * @param fd            file descriptor
+ * @return connection or NULL if not found
+ */
+static DltGatewayConnection *dlt_gateway_get_connection_by_fd(DltGateway *gateway,
+                                                              int fd)
+{
+    DltGatewayConnection *con = NULL;
+    int i = 0;
+
+    for (i = 0; i < gateway->num_connections; i++) {
+        con = &gateway->connections[i];
+
+        if (((con->status == DLT_GATEWAY_CONNECTED) ||
+             (con->status == DLT_GATEWAY_CONNECTING)) &&
+            (con->client.sock == fd))
+            return con;
+    }
+
+    return NULL;
+}
+
+DltReturnValue dlt_gateway_process_passive_node_hangup(DltDaemonLocal *daemon_local,
+                                                       int fd,
+                                                       int verbose)
+{
+    DltGatewayConnection *con = NULL;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if (daemon_local == NULL) {
+        dlt_vlog(LOG_ERR, "%s: wrong parameter\n", __func__);
+        return DLT_RETURN_WRONG_PARAMETER;
+    }
+
+    con = dlt_gateway_get_connection_by_fd(&daemon_local->pGateway, fd);
+
+    if (con == NULL) {
+        /* not a passive node connection (anymore), just drop it */
+        if (dlt_event_handler_unregister_connection(&daemon_local->pEvent,
+                                                    daemon_local,
+                                                    fd) != 0)
+            dlt_log(LOG_ERR, "Remove passive node Connection failed\n");
+
+        return DLT_RETURN_ERROR;
+    }
+
+    if (con->status == DLT_GATEWAY_CONNECTED)
+        dlt_vlog(LOG_WARNING, "Connection to passive node %s lost\n", con->ecuid);
+
+    dlt_gateway_abort_connection(daemon_local, con);
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
                                                          DltDaemonLocal *daemon_local,
                                                          DltReceiver *receiver,
                                                          int verbose)
 {
-    int i = 0;
     DltGateway *gateway = NULL;
     DltGatewayConnection *con = NULL;
     DltMessage msg = { 0 };
@@ -1305,17 +1618,17 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
         return DLT_RETURN_ERROR;
     }
 
-    for (i = 0; i < gateway->num_connections; i++)
-        if ((gateway->connections[i].status == DLT_GATEWAY_CONNECTED) && (gateway->connections[i].client.sock == receiver->fd)) {
-            con = &gateway->connections[i];
-            break;
-        }
+    con = dlt_gateway_get_connection_by_fd(gateway, receiver->fd);
 
     if (con == NULL) {
         dlt_log(LOG_ERR, "Cannot associate fd to passive Node connection\n");
         return DLT_RETURN_ERROR;
     }
 
+    if (con->status == DLT_GATEWAY_CONNECTING)
+        /* socket became writable, non-blocking connect completed */
+        return dlt_gateway_finish_connection(daemon_local, con, verbose);
+
     /* now the corresponding passive node connection is available */
     if (dlt_message_init(&msg, verbose) == -1) {
         dlt_log(LOG_ERR,
@@ -1350,6 +1663,14 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
         return DLT_RETURN_OK;
     }
 
+    /* forward the messages of this receive to the clients at once, in a
+     * buffer sized like the receive buffer of the passive node */
+    if (con->batch == NULL)
+        con->batch = (uint8_t *)malloc((size_t)receiver->buffersize);
+
+    if (con->batch != NULL)
+        dlt_daemon_client_batch_begin(daemon_local, con->batch, receiver->buffersize);
+
     while (dlt_message_read(&msg,
                             (unsigned char *)receiver->buf,
                             (unsigned int)receiver->bytesRcvd,
@@ -1417,6 +1738,7 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
             if (dlt_set_storageheader(msg.storageheader,
                                       msg.headerextra.ecu) == DLT_RETURN_ERROR) {
                 dlt_vlog(LOG_ERR, "%s: Can't set storage header\n", __func__);
+                dlt_daemon_client_batch_flush(daemon, daemon_local, verbose);
                 return DLT_RETURN_ERROR;
             }
 
@@ -1464,6 +1786,7 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
                                     sizeof(DltStorageHeader) +
                                     sizeof(dltSerialHeader))) == -1) {
                 /* Return value ignored */
+                dlt_daemon_client_batch_flush(daemon, daemon_local, verbose);
                 dlt_message_free(&msg, verbose);
                 return DLT_RETURN_ERROR;
             }
@@ -1473,11 +1796,14 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
                                      (size_t)msg.datasize -
                                      sizeof(DltStorageHeader))) == -1) {
             /* Return value ignored */
+            dlt_daemon_client_batch_flush(daemon, daemon_local, verbose);
             dlt_message_free(&msg, verbose);
             return DLT_RETURN_ERROR;
         }
     }
 
+    dlt_daemon_client_batch_flush(daemon, daemon_local, verbose);
+
     if (b_reset_receiver)
         dlt_receiver_remove(receiver, receiver->bytesRcvd);
 
@@ -1493,41 +1819,25 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
     return DLT_RETURN_OK;
 }
 
-int dlt_gateway_process_gateway_timer(DltDaemon *daemon,
-                                      DltDaemonLocal *daemon_local,
-                                      DltReceiver *receiver,
-                                      int verbose)
+void dlt_gateway_process_gateway_timer(DltDaemonTimer *timer, void *ctx)
 {
-    uint64_t expir = 0;
-    ssize_t res = 0;
-
-    PRINT_FUNCTION_VERBOSE(verbose);
+    DltDaemonTimerContext *context = (DltDaemonTimerContext *)ctx;
 
-    if ((daemon_local == NULL) || (daemon == NULL) || (receiver == NULL)) {
+    if ((timer == NULL) || (context == NULL) || (context->daemon_local == NULL)) {
         dlt_vlog(LOG_ERR,
                  "%s: invalid parameters\n",
                  __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
+        return;
     }
 
-    res = read(receiver->fd, &expir, sizeof(expir));
-
-    if (res < 0)
-        dlt_vlog(LOG_WARNING,
-                 "%s: Fail to read timer (%s)\n",
-                 __func__,
-                 strerror(errno));
-        /* Activity received on timer_wd, but unable to read the fd:
-         * let's go on sending notification */
+    PRINT_FUNCTION_VERBOSE(context->verbose);
 
     /* try to connect to passive nodes */
-    dlt_gateway_establish_connections(&daemon_local->pGateway,
-                                      daemon_local,
-                                      verbose);
+    dlt_gateway_establish_connections(&context->daemon_local->pGateway,
+                                      context->daemon_local,
+                                      context->verbose);
 
     dlt_log(LOG_DEBUG, "Gateway Timer\n");
-
-    return DLT_RETURN_OK;
 }
 
 int dlt_gateway_forward_control_message(DltGateway *gateway,
@@ -1697,7 +2007,6 @@ DltReturnValue dlt_gateway_process_on_demand_request(DltGateway *gateway,
                                                      int conn_status,
                                                      int verbose)
 {
-    int i = 0;
     DltGatewayConnection *con = NULL;
 
     PRINT_FUNCTION_VERBOSE(verbose);
@@ -1708,12 +2017,7 @@ DltReturnValue dlt_gateway_process_on_demand_request(DltGateway *gateway,
     }
 
     /* find connection by ECU id */
-    for (i = 0; i < gateway->num_connections; i++) {
-        if (strncmp(node_id, gateway->connections[i].ecuid, DLT_ID_SIZE) == 0) {
-            con = &gateway->connections[i];
-            break;
-        }
-    }
+    con = dlt_gateway_get_connection(gateway, node_id, verbose);
 
     if (con == NULL) {
         dlt_log(LOG_WARNING, "Specified ECUid not found\n");
@@ -1722,15 +2026,12 @@ DltReturnValue dlt_gateway_process_on_demand_request(DltGateway *gateway,
 
     if (conn_status == 1) { /* try to connect */
 
-        if (con->status != DLT_GATEWAY_CONNECTED) {
-            if (dlt_client_connect(&con->client, verbose) == 0) {
-                /* setup dlt connection and add to poll event loop here */
-                if (dlt_gateway_add_to_event_loop(daemon_local, con, verbose) != DLT_RETURN_OK) {
-                    dlt_log(LOG_ERR, "Gateway connection creation failed\n");
-                    return DLT_RETURN_ERROR;
-                }
-            }
-            else {
+        if (con->status == DLT_GATEWAY_CONNECTING) {
+            dlt_log(LOG_INFO, "Passive node connection in progress\n");
+        }
+        else if (con->status != DLT_GATEWAY_CONNECTED) {
+            /* completed asynchronously in the event loop if pending */
+            if (dlt_gateway_start_connection(daemon_local, con, verbose) == DLT_RETURN_ERROR) {
                 dlt_log(LOG_ERR, "Could not connect to passive node\n");
                 return DLT_RETURN_ERROR;
             }
@@ -1931,16 +2232,31 @@ DltGatewayConnection *dlt_gateway_get_connection(DltGateway *gateway,
         return con;
     }
 
-    for (i = 0; i < gateway->num_connections; i++) {
-        con = &gateway->connections[i];
+    if (gateway->ecu_index != NULL) {
+        int slot = dlt_gateway_ecu_slot(gateway, dlt_gateway_ecu_key(ecu));
 
-        if (strncmp(con->ecuid, ecu, DLT_ID_SIZE) == 0)
-            return con;
+        while (gateway->ecu_index[slot] != -1) {
+            con = &gateway->connections[gateway->ecu_index[slot]];
+
+            if (strncmp(con->ecuid, ecu, DLT_ID_SIZE) == 0)
+                return con;
+
+            slot = (slot + 1) & (gateway->ecu_index_size - 1);
+        }
+    }
+    else {
+        for (i = 0; i < gateway->num_connections; i++) {
+            con = &gateway->connections[i];
+
+            if ((con->ecuid != NULL) &&
+                (strncmp(con->ecuid, ecu, DLT_ID_SIZE) == 0))
+                return con;
+        }
     }
 
     dlt_vlog(LOG_ERR, "%s: No connection found\n", ecu);
 
-    return con;
+    return NULL;
 }
 
 DltGatewayConnection *dlt_gateway_get_connection_v2(DltGateway *gateway,
@@ -118,18 +118,27 @@ DltReturnValue dlt_gateway_process_passive_node_messages(DltDaemon *daemon,
                                               int verbose);
 
 /**
- * Process gateway timer
+ * Handle an error or hangup on a passive node connection
+ *
+ * The connection is removed from the event loop and counted as a failed
+ * connection attempt, it is established again by the gateway timer.
  *
- * @param daemon          DltDaemon
  * @param daemon_local    DltDaemonLocal
- * @param rec             DltReceiver
+ * @param fd              file descriptor of the passive node connection
  * @param verbose verbose flag
  * @return 0 on success, -1 otherwise
  */
-int dlt_gateway_process_gateway_timer(DltDaemon *daemon,
-                                      DltDaemonLocal *daemon_local,
-                                      DltReceiver *rec,
-                                      int verbose);
+DltReturnValue dlt_gateway_process_passive_node_hangup(DltDaemonLocal *daemon_local,
+                                                       int fd,
+                                                       int verbose);
+
+/**
+ * Process gateway timer
+ *
+ * @param timer           DltDaemonTimer
+ * @param ctx             DltDaemonTimerContext
+ */
+void dlt_gateway_process_gateway_timer(DltDaemonTimer *timer, void *ctx);
 
 /**
  * Forward control messages to the specified passive node DLT Daemon.
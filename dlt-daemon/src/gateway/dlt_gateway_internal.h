@@ -99,4 +99,14 @@ DLT_STATIC DltReturnValue dlt_gateway_parse_get_log_info(DltDaemon *daemon,
                                                          int req,
                                                          int verbose);
 
+DLT_STATIC int dlt_gateway_build_ecu_index(DltGateway *gateway);
+
+DLT_STATIC DltReturnValue dlt_gateway_start_connection(DltDaemonLocal *daemon_local,
+                                                       DltGatewayConnection *con,
+                                                       int verbose);
+
+DLT_STATIC DltReturnValue dlt_gateway_finish_connection(DltDaemonLocal *daemon_local,
+                                                        DltGatewayConnection *con,
+                                                        int verbose);
+
 #endif
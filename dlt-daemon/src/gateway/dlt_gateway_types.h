@@ -58,6 +58,7 @@
 
 #include "dlt_protocol.h"
 #include "dlt_client.h"
+#include "dlt_daemon_timer.h"
 
 #define DLT_GATEWAY_CONFIG_PATH CONFIGURATION_FILES_DIR "/dlt_gateway.conf"
 #define DLT_GATEWAY_TIMER_DEFAULT_INTERVAL 1
@@ -74,7 +75,8 @@ typedef enum
     DLT_GATEWAY_UNINITIALIZED,
     DLT_GATEWAY_INITIALIZED,
     DLT_GATEWAY_CONNECTED,
-    DLT_GATEWAY_DISCONNECTED
+    DLT_GATEWAY_DISCONNECTED,
+    DLT_GATEWAY_CONNECTING      /* non-blocking connect in progress */
 } connection_status;
 
 typedef enum
@@ -134,6 +136,8 @@ typedef struct {
     int send_serial;            /* Send serial header with control messages */
     DltClient client;           /* DltClient structure */
     int default_log_level;      /* Default Log Level on passive node */
+    DltDaemonTimer connect_timer; /* aborts a pending connection */
+    uint8_t *batch;             /* messages forwarded to the clients at once */
 } DltGatewayConnection;
 
 /* DltGateway structure */
@@ -143,6 +147,8 @@ typedef struct
     DltGatewayConnection *connections; /* pointer to connections */
     int num_connections; /* number of connections */
     int interval;        /* interval of retry connection */
+    int *ecu_index;      /* hash of ECU ids to connection index, or NULL */
+    int ecu_index_size;  /* number of slots in ecu_index (power of two) */
 } DltGateway;
 
 typedef struct {
@@ -24,6 +24,9 @@
 
 #include "dlt-kpi-common.h"
 
+#include <errno.h>
+#include <unistd.h>
+
 static int dlt_kpi_cpu_count = -1;
 
 DltReturnValue dlt_kpi_read_file_compact(char *filename, char **target)
@@ -62,7 +65,7 @@ DltReturnValue dlt_kpi_read_file(char *filename, char *buffer, uint maxLength)
         /* fprintf(stderr, "Could not read file %s\n", filename); */
         return DLT_RETURN_ERROR;
 
-    int buflen = fread(buffer, 1, maxLength - 1, file);
+    size_t buflen = fread(buffer, 1, maxLength - 1, file);
     buffer[buflen] = '\0';
 
     fclose(file);
@@ -70,6 +73,43 @@ DltReturnValue dlt_kpi_read_file(char *filename, char *buffer, uint maxLength)
     return DLT_RETURN_OK;
 }
 
+/* Re-reads a /proc file through an already open descriptor. Reading from
+ * offset 0 makes the kernel regenerate the content. */
+DltReturnValue dlt_kpi_read_fd(int fd, char *buffer, uint maxLength)
+{
+    if ((fd < 0) || (buffer == NULL) || (maxLength == 0)) {
+        fprintf(stderr, "%s: Invalid Parameter\n", __func__);
+        return DLT_RETURN_WRONG_PARAMETER;
+    }
+
+    size_t buflen = 0;
+    ssize_t len;
+
+    /* A short read marks the end of a /proc file, a full one may be followed by more */
+    while (buflen < maxLength - 1) {
+        size_t request = maxLength - 1 - buflen;
+        len = pread(fd, buffer + buflen, request, (off_t)buflen);
+
+        if ((len < 0) && (errno == EINTR))
+            continue;
+
+        if (len <= 0)
+            break;
+
+        buflen += (size_t)len;
+
+        if ((size_t)len < request)
+            break;
+    }
+
+    buffer[buflen] = '\0';
+
+    if (buflen == 0)
+        return DLT_RETURN_ERROR;
+
+    return DLT_RETURN_OK;
+}
+
 int dlt_kpi_read_cpu_count()
 {
     char buffer[BUFFER_SIZE];
@@ -34,6 +34,7 @@
 
 DltReturnValue dlt_kpi_read_file(char *filename, char *buffer, uint maxLength);
 DltReturnValue dlt_kpi_read_file_compact(char *filename, char **target);
+DltReturnValue dlt_kpi_read_fd(int fd, char *buffer, uint maxLength);
 int dlt_kpi_get_cpu_count();
 
 #endif /* SRC_KPI_DLT_KPI_COMMON_H_ */
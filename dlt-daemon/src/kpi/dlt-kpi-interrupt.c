@@ -24,6 +24,28 @@
 
 #include "dlt-kpi-interrupt.h"
 
+#include <fcntl.h>
+#include <stdint.h>
+
+#define DLT_KPI_IRQ_FILE_SIZE 65536
+
+static int dlt_kpi_interrupts_fd = -1;
+static DltKpiIrqTable dlt_kpi_irq_tables[2];
+static int dlt_kpi_irq_current;
+static uint32_t dlt_kpi_irq_sequence;
+
+static DltReturnValue dlt_kpi_open_interrupts()
+{
+    if (dlt_kpi_interrupts_fd < 0) {
+        dlt_kpi_interrupts_fd = open("/proc/interrupts", O_RDONLY | O_CLOEXEC);
+
+        if (dlt_kpi_interrupts_fd < 0)
+            return DLT_RETURN_ERROR;
+    }
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level)
 {
     if (ctx == NULL) {
@@ -39,7 +61,9 @@ DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level
     int head_line = 1, first_row = 1, cpu_count = 0, column = 0, buffer_offset = 0;
     DltReturnValue ret;
 
-    if ((ret = dlt_kpi_read_file("/proc/interrupts", file_buffer, BUFFER_SIZE)) < DLT_RETURN_OK) return ret;
+    if ((ret = dlt_kpi_open_interrupts()) < DLT_RETURN_OK) return ret;
+
+    if ((ret = dlt_kpi_read_fd(dlt_kpi_interrupts_fd, file_buffer, BUFFER_SIZE)) < DLT_RETURN_OK) return ret;
 
     token = strtok(file_buffer, delim);
 
@@ -61,7 +85,7 @@ DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level
             token = strtok(NULL, delim);
         }
         else {
-            int tokenlen = strlen(token);
+            int tokenlen = (int)strlen(token);
 
             if (token[tokenlen - 1] == ':') {
                 column = 0;
@@ -69,12 +93,12 @@ DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level
                 if (first_row)
                     first_row = 0;
                 else
-                    buffer_offset += snprintf(buffer + buffer_offset, BUFFER_SIZE - buffer_offset, "\n");
+                    buffer_offset += snprintf(buffer + buffer_offset, (size_t)(BUFFER_SIZE - buffer_offset), "\n");
             }
 
             if (column == 0) { /* IRQ number */
                 buffer_offset += snprintf(buffer + buffer_offset,
-                                          BUFFER_SIZE - buffer_offset,
+                                          (size_t)(BUFFER_SIZE - buffer_offset),
                                           "%.*s;",
                                           tokenlen - 1,
                                           token);
@@ -89,7 +113,7 @@ DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level
                 }
 
                 buffer_offset += snprintf(buffer + buffer_offset,
-                                          BUFFER_SIZE - buffer_offset,
+                                          (size_t)(BUFFER_SIZE - buffer_offset),
                                           "cpu%d:%ld;",
                                           column - 1,
                                           interrupt_count);
@@ -151,3 +175,260 @@ DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level
 
     return DLT_RETURN_OK;
 }
+
+/* Parses /proc/interrupts into table. Rows with fewer counters than CPUs
+ * (like ERR and MIS) are padded with zeros. */
+DLT_STATIC DltReturnValue dlt_kpi_parse_interrupts(char *buffer, DltKpiIrqTable *table)
+{
+    char *line = buffer, *next, *pos;
+    int row = 0;
+
+    next = strchr(line, '\n');
+
+    if (next == NULL)
+        return DLT_RETURN_ERROR;
+
+    *next = '\0';
+    table->cpu_count = 0;
+
+    for (pos = strstr(line, "CPU"); pos != NULL; pos = strstr(pos + 3, "CPU"))
+        table->cpu_count++;
+
+    if (table->cpu_count <= 0) {
+        fprintf(stderr, "%s: Could not parse CPU count !\n", __func__);
+        return DLT_RETURN_ERROR;
+    }
+
+    for (line = next + 1; *line != '\0'; line = next + 1) {
+        next = strchr(line, '\n');
+
+        if (next == NULL)
+            next = line + strlen(line) - 1;
+        else
+            *next = '\0';
+
+        pos = strchr(line, ':');
+
+        if (pos == NULL)
+            continue;
+
+        if (row >= table->irq_max) {
+            int irq_max = (table->irq_max > 0) ? table->irq_max * 2 : 64;
+            void *names = realloc(table->names, (size_t)irq_max * DLT_KPI_IRQ_NAME_SIZE);
+
+            if (names == NULL) {
+                fprintf(stderr, "%s: Out of memory\n", __func__);
+                return DLT_RETURN_ERROR;
+            }
+
+            table->names = names;
+            table->irq_max = irq_max;
+        }
+
+        while ((*line == ' ') || (*line == '\t'))
+            line++;
+
+        snprintf(table->names[row], DLT_KPI_IRQ_NAME_SIZE, "%.*s", (int)(pos - line), line);
+        row++;
+    }
+
+    table->irq_count = row;
+
+    return DLT_RETURN_OK;
+}
+
+/* Second pass over the rows found by dlt_kpi_parse_interrupts() to read the counters */
+DLT_STATIC DltReturnValue dlt_kpi_parse_interrupt_counts(char *buffer, DltKpiIrqTable *table)
+{
+    uint64_t *counts = realloc(table->counts, (size_t)table->irq_max * (size_t)table->cpu_count * sizeof(uint64_t));
+    char *line, *pos, *check;
+    int row = 0, cpu;
+
+    if (counts == NULL) {
+        fprintf(stderr, "%s: Out of memory\n", __func__);
+        return DLT_RETURN_ERROR;
+    }
+
+    table->counts = counts;
+
+    for (line = buffer + strlen(buffer) + 1; (row < table->irq_count); line += strlen(line) + 1) {
+        pos = strchr(line, ':');
+
+        if (pos == NULL)
+            continue;
+
+        pos++;
+
+        for (cpu = 0; cpu < table->cpu_count; cpu++) {
+            uint64_t value = strtoull(pos, &check, 10);
+
+            if (check == pos)
+                break;
+
+            counts[row * table->cpu_count + cpu] = value;
+            pos = check;
+        }
+
+        for (; cpu < table->cpu_count; cpu++)
+            counts[row * table->cpu_count + cpu] = 0;
+
+        row++;
+    }
+
+    return DLT_RETURN_OK;
+}
+
+DLT_STATIC int dlt_kpi_interrupt_layout_changed(DltKpiIrqTable *current, DltKpiIrqTable *previous)
+{
+    if ((current->cpu_count != previous->cpu_count) || (current->irq_count != previous->irq_count))
+        return 1;
+
+    for (int row = 0; row < current->irq_count; row++)
+        if (strcmp(current->names[row], previous->names[row]) != 0)
+            return 1;
+
+    return 0;
+}
+
+/* Writes the raw block of one IRQ row into entry: the length of the name, the
+ * name and the absolute counters for a keyframe resp. the increments since
+ * previous for a delta record. Returns the length of the block, or 0 if the
+ * row did not change in a delta record. */
+DLT_STATIC size_t dlt_kpi_get_interrupt_entry(DltKpiIrqTable *current, DltKpiIrqTable *previous, int row,
+                                              int keyframe, unsigned char *entry)
+{
+    uint64_t *counts = &current->counts[row * current->cpu_count];
+    size_t name_len = strlen(current->names[row]);
+    size_t length = 1 + name_len;
+    int changed = 0;
+
+    entry[0] = (unsigned char)name_len;
+    memcpy(entry + 1, current->names[row], name_len);
+
+    for (int cpu = 0; cpu < current->cpu_count; cpu++) {
+        if (keyframe) {
+            memcpy(entry + length, &counts[cpu], sizeof(uint64_t));
+            length += sizeof(uint64_t);
+        }
+        else {
+            uint64_t last_count = previous->counts[row * current->cpu_count + cpu];
+            uint64_t dif = (counts[cpu] >= last_count) ? counts[cpu] - last_count : counts[cpu];
+            uint32_t dif32 = (dif > UINT32_MAX) ? UINT32_MAX : (uint32_t)dif;
+
+            changed |= (dif32 != 0);
+            memcpy(entry + length, &dif32, sizeof(uint32_t));
+            length += sizeof(uint32_t);
+        }
+    }
+
+    return (keyframe || changed) ? length : 0;
+}
+
+static DltReturnValue dlt_kpi_start_interrupt_record(DltContext *ctx, DltContextData *data, DltLogLevelType log_level,
+                                                     uint32_t message_id, uint16_t cpu_count)
+{
+    DltReturnValue ret;
+
+    if ((ret = dlt_user_log_write_start_id(ctx, data, log_level, message_id)) < DLT_RETURN_OK) {
+        fprintf(stderr, "%s: dlt_user_log_write_start_id() returned error\n", __func__);
+        return ret;
+    }
+
+    if ((ret = dlt_user_log_write_uint32(data, dlt_kpi_irq_sequence)) < DLT_RETURN_OK)
+        return ret;
+
+    return dlt_user_log_write_uint16(data, cpu_count);
+}
+
+/**
+ * Logs the interrupt counters as non-verbose binary records.
+ *
+ * Each record holds a sequence number (uint32) that is incremented per
+ * interval, the CPU count (uint16) and one raw block per IRQ: the length of
+ * the IRQ name (uint8), the name and one counter per CPU. Keyframes carry the
+ * absolute counters as uint64, delta records only the IRQs that changed since
+ * the previous interval with their increments as uint32. A keyframe is also
+ * logged when the set of IRQs or CPUs changed.
+ */
+DltReturnValue dlt_kpi_log_interrupt_deltas(DltContext *ctx, DltLogLevelType log_level, int keyframe)
+{
+    static char file_buffer[DLT_KPI_IRQ_FILE_SIZE];
+    unsigned char entry[1 + DLT_KPI_IRQ_NAME_SIZE + 256 * sizeof(uint64_t)];
+    DltReturnValue ret;
+
+    if (ctx == NULL) {
+        fprintf(stderr, "%s: Nullpointer parameter (NULL) !\n", __func__);
+        return DLT_RETURN_WRONG_PARAMETER;
+    }
+
+    if ((ret = dlt_kpi_open_interrupts()) < DLT_RETURN_OK)
+        return ret;
+
+    if ((ret = dlt_kpi_read_fd(dlt_kpi_interrupts_fd, file_buffer, sizeof(file_buffer))) < DLT_RETURN_OK)
+        return ret;
+
+    DltKpiIrqTable *previous = &dlt_kpi_irq_tables[dlt_kpi_irq_current];
+    DltKpiIrqTable *current = &dlt_kpi_irq_tables[1 - dlt_kpi_irq_current];
+
+    if ((ret = dlt_kpi_parse_interrupts(file_buffer, current)) < DLT_RETURN_OK)
+        return ret;
+
+    if ((ret = dlt_kpi_parse_interrupt_counts(file_buffer, current)) < DLT_RETURN_OK)
+        return ret;
+
+    if (current->cpu_count > 256) {
+        fprintf(stderr, "%s: Too many CPUs (%d) !\n", __func__, current->cpu_count);
+        return DLT_RETURN_ERROR;
+    }
+
+    dlt_kpi_irq_current = 1 - dlt_kpi_irq_current;
+
+    if (dlt_kpi_interrupt_layout_changed(current, previous))
+        keyframe = 1;
+
+    dlt_kpi_irq_sequence++;
+
+    if (dlt_user_is_logLevel_enabled(ctx, log_level) != DLT_RETURN_TRUE)
+        return DLT_RETURN_OK;
+
+    uint32_t message_id = keyframe ? DLT_KPI_IRQ_KEY_MSGID : DLT_KPI_IRQ_DIF_MSGID;
+    uint16_t cpu_count = (uint16_t)current->cpu_count;
+    DltContextData data;
+    int started = 0;
+
+    for (int row = 0; row < current->irq_count; row++) {
+        size_t length = dlt_kpi_get_interrupt_entry(current, previous, row, keyframe, entry);
+
+        if (length == 0)
+            continue;
+
+        ret = started ? dlt_user_log_write_raw(&data, entry, (uint16_t)length) : DLT_RETURN_USER_BUFFER_FULL;
+
+        if (ret == DLT_RETURN_OK)
+            continue;
+
+        /* no record started yet or message buffer full, start new one */
+        if (started && ((ret = dlt_user_log_write_finish(&data)) < DLT_RETURN_OK)) {
+            fprintf(stderr, "%s: dlt_user_log_write_finish() returned error\n", __func__);
+            return ret;
+        }
+
+        if ((ret = dlt_kpi_start_interrupt_record(ctx, &data, log_level, message_id, cpu_count)) < DLT_RETURN_OK)
+            return ret;
+
+        started = 1;
+
+        if ((ret = dlt_user_log_write_raw(&data, entry, (uint16_t)length)) < DLT_RETURN_OK) {
+            fprintf(stderr, "%s: IRQ %s does not fit into a message\n", __func__, current->names[row]);
+            dlt_user_log_write_finish(&data);
+            return ret;
+        }
+    }
+
+    if (started && ((ret = dlt_user_log_write_finish(&data)) < DLT_RETURN_OK)) {
+        fprintf(stderr, "%s: dlt_user_log_write_finish() returned error\n", __func__);
+        return ret;
+    }
+
+    return DLT_RETURN_OK;
+}
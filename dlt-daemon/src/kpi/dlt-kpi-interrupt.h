@@ -28,6 +28,30 @@
 #include "dlt.h"
 #include "dlt-kpi-common.h"
 
+#include <stdint.h>
+
+/* Message IDs of the non-verbose interrupt records logged in delta mode */
+#define DLT_KPI_IRQ_KEY_MSGID 0x4B504931 /* absolute counters */
+#define DLT_KPI_IRQ_DIF_MSGID 0x4B504932 /* counter increments since the previous record */
+
+#define DLT_KPI_IRQ_NAME_SIZE 16
+
+typedef struct
+{
+    int cpu_count, irq_count, irq_max;
+    char (*names)[DLT_KPI_IRQ_NAME_SIZE];
+    uint64_t *counts; /* irq_count rows of cpu_count counters */
+} DltKpiIrqTable;
+
 DltReturnValue dlt_kpi_log_interrupts(DltContext *ctx, DltLogLevelType log_level);
+DltReturnValue dlt_kpi_log_interrupt_deltas(DltContext *ctx, DltLogLevelType log_level, int keyframe);
+
+#ifdef DLT_UNIT_TESTS
+DltReturnValue dlt_kpi_parse_interrupts(char *buffer, DltKpiIrqTable *table);
+DltReturnValue dlt_kpi_parse_interrupt_counts(char *buffer, DltKpiIrqTable *table);
+int dlt_kpi_interrupt_layout_changed(DltKpiIrqTable *current, DltKpiIrqTable *previous);
+size_t dlt_kpi_get_interrupt_entry(DltKpiIrqTable *current, DltKpiIrqTable *previous, int row,
+                                   int keyframe, unsigned char *entry);
+#endif
 
 #endif /* SRC_KPI_DLT_KPI_INTERRUPT_H_ */
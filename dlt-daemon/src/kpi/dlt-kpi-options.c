@@ -105,6 +105,10 @@ void dlt_kpi_init_configuration(DltKpiConfig *config)
     config->process_log_interval = 1000;
     config->irq_log_interval = 1000;
     config->log_level = DLT_LOG_DEFAULT;
+    config->delta_mode = 0;
+    config->delta_cpu_threshold = 10;
+    config->delta_rss_threshold = 256;
+    config->keyframe_interval = 30;
 }
 
 /**
@@ -170,7 +174,7 @@ DltReturnValue dlt_kpi_read_configuration_file(DltKpiConfig *config, char *file_
 
         if ((token[0] != '\0') && (value[0] != '\0')) {
             if (strcmp(token, "process_interval") == '\0') {
-                tmp = strtol(value, &strchk, 10);
+                tmp = (int)strtol(value, &strchk, 10);
 
                 if ((strchk[0] == '\0') && (tmp > 0))
                     config->process_log_interval = tmp;
@@ -179,7 +183,7 @@ DltReturnValue dlt_kpi_read_configuration_file(DltKpiConfig *config, char *file_
             }
             else if (strcmp(token, "irq_interval") == '\0')
             {
-                tmp = strtol(value, &strchk, 10);
+                tmp = (int)strtol(value, &strchk, 10);
 
                 if ((strchk[0] == '\0') && (tmp > 0))
                     config->irq_log_interval = tmp;
@@ -188,7 +192,7 @@ DltReturnValue dlt_kpi_read_configuration_file(DltKpiConfig *config, char *file_
             }
             else if (strcmp(token, "check_interval") == '\0')
             {
-                tmp = strtol(value, &strchk, 10);
+                tmp = (int)strtol(value, &strchk, 10);
 
                 if ((strchk[0] == '\0') && (tmp > 0))
                     config->check_log_interval = tmp;
@@ -197,13 +201,49 @@ DltReturnValue dlt_kpi_read_configuration_file(DltKpiConfig *config, char *file_
             }
             else if (strcmp(token, "log_level") == '\0')
             {
-                tmp = strtol(value, &strchk, 10);
+                tmp = (int)strtol(value, &strchk, 10);
 
                 if ((strchk[0] == '\0') && (tmp >= -1) && (tmp <= 6))
                     config->log_level = tmp;
                 else
                     fprintf(stderr, "Error reading configuration file: %s is not a valid value for %s\n", value, token);
             }
+            else if (strcmp(token, "delta_mode") == '\0')
+            {
+                tmp = (int)strtol(value, &strchk, 10);
+
+                if ((strchk[0] == '\0') && ((tmp == 0) || (tmp == 1)))
+                    config->delta_mode = tmp;
+                else
+                    fprintf(stderr, "Error reading configuration file: %s is not a valid value for %s\n", value, token);
+            }
+            else if (strcmp(token, "delta_cpu_threshold") == '\0')
+            {
+                tmp = (int)strtol(value, &strchk, 10);
+
+                if ((strchk[0] == '\0') && (tmp >= 0))
+                    config->delta_cpu_threshold = tmp;
+                else
+                    fprintf(stderr, "Error reading configuration file: %s is not a valid value for %s\n", value, token);
+            }
+            else if (strcmp(token, "delta_rss_threshold") == '\0')
+            {
+                tmp = (int)strtol(value, &strchk, 10);
+
+                if ((strchk[0] == '\0') && (tmp >= 0))
+                    config->delta_rss_threshold = tmp;
+                else
+                    fprintf(stderr, "Error reading configuration file: %s is not a valid value for %s\n", value, token);
+            }
+            else if (strcmp(token, "keyframe_interval") == '\0')
+            {
+                tmp = (int)strtol(value, &strchk, 10);
+
+                if ((strchk[0] == '\0') && (tmp > 0))
+                    config->keyframe_interval = tmp;
+                else
+                    fprintf(stderr, "Error reading configuration file: %s is not a valid value for %s\n", value, token);
+            }
         }
     }
 
@@ -35,10 +35,79 @@ DltKpiProcessList *dlt_kpi_create_process_list()
 
     memset(new_list, 0, sizeof(DltKpiProcessList));
     new_list->start = new_list->cursor = NULL;
+    new_list->hash = NULL;
 
     return new_list;
 }
 
+DltKpiProcessList *dlt_kpi_create_hashed_process_list()
+{
+    DltKpiProcessList *new_list = dlt_kpi_create_process_list();
+
+    if (new_list == NULL)
+        return NULL;
+
+    new_list->hash = calloc(DLT_KPI_PROCESS_HASH_SIZE, sizeof(DltKpiProcess *));
+
+    if (new_list->hash == NULL) {
+        fprintf(stderr, "%s: Cannot create process hash, out of memory\n", __func__);
+        free(new_list);
+        return NULL;
+    }
+
+    return new_list;
+}
+
+static DltKpiProcess **dlt_kpi_hash_bucket(DltKpiProcessList *list, pid_t pid)
+{
+    return &list->hash[(unsigned int)pid & (DLT_KPI_PROCESS_HASH_SIZE - 1)];
+}
+
+static void dlt_kpi_hash_insert(DltKpiProcessList *list, DltKpiProcess *process)
+{
+    if (list->hash == NULL)
+        return;
+
+    DltKpiProcess **bucket = dlt_kpi_hash_bucket(list, process->pid);
+
+    process->hash_next = *bucket;
+    *bucket = process;
+}
+
+static void dlt_kpi_hash_remove(DltKpiProcessList *list, DltKpiProcess *process)
+{
+    if (list->hash == NULL)
+        return;
+
+    DltKpiProcess **link = dlt_kpi_hash_bucket(list, process->pid);
+
+    while (*link != NULL) {
+        if (*link == process) {
+            *link = process->hash_next;
+            break;
+        }
+
+        link = &(*link)->hash_next;
+    }
+
+    process->hash_next = NULL;
+}
+
+DltKpiProcess *dlt_kpi_find_process(DltKpiProcessList *list, pid_t pid)
+{
+    if ((list == NULL) || (list->hash == NULL)) {
+        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
+        return NULL;
+    }
+
+    DltKpiProcess *process = *dlt_kpi_hash_bucket(list, pid);
+
+    while ((process != NULL) && (process->pid != pid))
+        process = process->hash_next;
+
+    return process;
+}
+
 DltReturnValue dlt_kpi_free_process_list_soft(DltKpiProcessList *list)
 {
     if (list == NULL) {
@@ -46,6 +115,7 @@ DltReturnValue dlt_kpi_free_process_list_soft(DltKpiProcessList *list)
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
+    free(list->hash);
     free(list);
 
     return DLT_RETURN_OK;
@@ -151,7 +221,9 @@ DltReturnValue dlt_kpi_add_process_at_start(DltKpiProcessList *list, DltKpiProce
         list->start->prev = process;
 
     process->next = list->start;
+    process->prev = NULL;
     list->start = process;
+    dlt_kpi_hash_insert(list, process);
 
     return DLT_RETURN_OK;
 }
@@ -184,6 +256,7 @@ DltReturnValue dlt_kpi_add_process_before_cursor(DltKpiProcessList *list, DltKpi
     process->next = list->cursor;
     process->prev = list->cursor->prev;
     list->cursor->prev = process;
+    dlt_kpi_hash_insert(list, process);
 
     return DLT_RETURN_OK;
 }
@@ -204,10 +277,23 @@ DltReturnValue dlt_kpi_add_process_after_cursor(DltKpiProcessList *list, DltKpiP
     process->next = list->cursor->next;
     process->prev = list->cursor;
     list->cursor->next = process;
+    dlt_kpi_hash_insert(list, process);
 
     return DLT_RETURN_OK;
 }
 
+/* Adds the process after the cursor and moves the cursor onto it, so
+ * consecutive calls keep the insertion order. */
+DltReturnValue dlt_kpi_append_process(DltKpiProcessList *list, DltKpiProcess *process)
+{
+    DltReturnValue ret = dlt_kpi_add_process_after_cursor(list, process);
+
+    if (ret == DLT_RETURN_OK)
+        list->cursor = process;
+
+    return ret;
+}
+
 DltReturnValue dlt_kpi_remove_process_at_cursor_soft(DltKpiProcessList *list)
 {
     if (list == NULL) {
@@ -242,6 +328,7 @@ DltReturnValue dlt_kpi_remove_process_at_cursor_soft(DltKpiProcessList *list)
     }
 
     list->cursor = tmp->next; /* becomes NULL if list is at end */
+    dlt_kpi_hash_remove(list, tmp);
 
     return DLT_RETURN_OK;
 }
@@ -28,12 +28,17 @@
 #include "dlt-kpi-process.h"
 #include "dlt-kpi-common.h"
 
+#define DLT_KPI_PROCESS_HASH_SIZE 1024 /* must be a power of two */
+
 typedef struct
 {
     struct DltKpiProcess *start, *cursor;
+    struct DltKpiProcess **hash; /* pid-keyed buckets, NULL if the list is not hashed */
 } DltKpiProcessList;
 
 DltKpiProcessList *dlt_kpi_create_process_list();
+DltKpiProcessList *dlt_kpi_create_hashed_process_list();
+DltKpiProcess *dlt_kpi_find_process(DltKpiProcessList *list, pid_t pid);
 DltReturnValue dlt_kpi_free_process_list_soft(DltKpiProcessList *list);
 DltReturnValue dlt_kpi_free_process_list(DltKpiProcessList *list);
 DltKpiProcess *dlt_kpi_get_process_at_cursor(DltKpiProcessList *list);
@@ -43,6 +48,7 @@ DltReturnValue dlt_kpi_reset_cursor(DltKpiProcessList *list);
 DltReturnValue dlt_kpi_add_process_at_start(DltKpiProcessList *list, DltKpiProcess *process);
 DltReturnValue dlt_kpi_add_process_before_cursor(DltKpiProcessList *list, DltKpiProcess *process);
 DltReturnValue dlt_kpi_add_process_after_cursor(DltKpiProcessList *list, DltKpiProcess *process);
+DltReturnValue dlt_kpi_append_process(DltKpiProcessList *list, DltKpiProcess *process);
 DltReturnValue dlt_kpi_remove_process_at_cursor_soft(DltKpiProcessList *list);
 DltReturnValue dlt_kpi_remove_process_at_cursor(DltKpiProcessList *list);
 
@@ -24,72 +24,271 @@
 
 #include "dlt-kpi-process.h"
 
+#include <fcntl.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <sys/resource.h>
 
-DltReturnValue dlt_kpi_read_process_file_to_str(pid_t pid, char **target_str, char *subdir);
-unsigned long int dlt_kpi_read_process_stat_to_ulong(pid_t pid, unsigned int index);
-DltReturnValue dlt_kpi_read_process_stat_cmdline(pid_t pid, char **buffer);
+/* Descriptors left for everything else once the per-process caches are full */
+#define DLT_KPI_FD_RESERVE 64
 
-DltReturnValue dlt_kpi_process_update_io_wait(DltKpiProcess *process, unsigned long int time_dif_ms)
+/* Fields of /proc/<pid>/stat, numbered as in proc(5) */
+#define DLT_KPI_STAT_PPID 4
+#define DLT_KPI_STAT_UTIME 14
+#define DLT_KPI_STAT_STIME 15
+#define DLT_KPI_STAT_RSS 24
+#define DLT_KPI_STAT_BLKIO_TICKS 42
+
+static int dlt_kpi_fd_budget = -1;
+
+/* Number of descriptors that may still be kept open between intervals.
+ * The soft limit is raised to the hard limit on first use. */
+static int dlt_kpi_get_fd_budget()
 {
-    if (process == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
+    if (dlt_kpi_fd_budget < 0) {
+        struct rlimit limit;
+        dlt_kpi_fd_budget = 0;
+
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+            if (limit.rlim_cur < limit.rlim_max) {
+                rlim_t soft = limit.rlim_cur;
+                limit.rlim_cur = limit.rlim_max;
+
+                if (setrlimit(RLIMIT_NOFILE, &limit) < 0)
+                    limit.rlim_cur = soft;
+            }
+
+            if ((limit.rlim_cur != RLIM_INFINITY) && (limit.rlim_cur > DLT_KPI_FD_RESERVE))
+                dlt_kpi_fd_budget = (int)(limit.rlim_cur - DLT_KPI_FD_RESERVE);
+            else if (limit.rlim_cur == RLIM_INFINITY)
+                dlt_kpi_fd_budget = 65536;
+        }
     }
 
-    unsigned long int total_io_wait = dlt_kpi_read_process_stat_to_ulong(process->pid, 42);
+    return dlt_kpi_fd_budget;
+}
 
-    int cpu_count = dlt_kpi_get_cpu_count();
+static void dlt_kpi_close_cached_fd(int *fd)
+{
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+        dlt_kpi_fd_budget++;
+    }
+}
 
-    process->io_wait = (total_io_wait - process->last_io_wait) * 1000 / sysconf(_SC_CLK_TCK); /* busy milliseconds since last update */
+static void dlt_kpi_close_process_fds(DltKpiProcess *process)
+{
+    dlt_kpi_close_cached_fd(&process->stat_fd);
+    dlt_kpi_close_cached_fd(&process->status_fd);
+    dlt_kpi_close_cached_fd(&process->io_fd);
+    dlt_kpi_close_cached_fd(&process->dir_fd);
+}
 
-    if ((time_dif_ms > 0) && (cpu_count > 0))
-        process->io_wait = process->io_wait * 1000 / time_dif_ms / cpu_count; /* busy milliseconds per second per CPU */
+/* Opens a file below /proc/<pid>, relative to the cached directory if there is one */
+static int dlt_kpi_open_process_file(DltKpiProcess *process, const char *name)
+{
+    if (process->dir_fd >= 0)
+        return openat(process->dir_fd, name, O_RDONLY | O_CLOEXEC);
 
-    process->last_io_wait = total_io_wait;
+    char filename[64];
+    snprintf(filename, sizeof(filename), "/proc/%d/%s", process->pid, name);
 
-    return DLT_RETURN_OK;
+    return open(filename, O_RDONLY | O_CLOEXEC);
 }
 
-DltReturnValue dlt_kpi_process_update_cpu_time(DltKpiProcess *process, unsigned long int time_dif_ms)
+/* Reads a file below /proc/<pid> into buffer. If fd is given, the descriptor
+ * is kept in it for the next interval while the descriptor budget allows it. */
+static DltReturnValue dlt_kpi_read_process_file(DltKpiProcess *process, int *fd, const char *name,
+                                                char *buffer, uint maxLength)
 {
-    if (process == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
+    int tmp_fd = (fd != NULL) ? *fd : -1;
+
+    if (tmp_fd < 0) {
+        tmp_fd = dlt_kpi_open_process_file(process, name);
+
+        if (tmp_fd < 0) {
+            buffer[0] = '\0';
+            return DLT_RETURN_ERROR;
+        }
     }
 
-    unsigned long int utime = dlt_kpi_read_process_stat_to_ulong(process->pid, 14);
-    unsigned long int stime = dlt_kpi_read_process_stat_to_ulong(process->pid, 15);
+    DltReturnValue ret = dlt_kpi_read_fd(tmp_fd, buffer, maxLength);
 
-    unsigned long total_cpu_time = utime + stime;
+    if ((fd == NULL) || (*fd < 0)) {
+        if ((fd != NULL) && (ret == DLT_RETURN_OK) && (dlt_kpi_get_fd_budget() > 0)) {
+            *fd = tmp_fd;
+            dlt_kpi_fd_budget--;
+        }
+        else {
+            close(tmp_fd);
+        }
+    }
 
-    if ((process->last_cpu_time > 0) && (process->last_cpu_time <= total_cpu_time)) {
-        int cpu_count = dlt_kpi_get_cpu_count();
+    return ret;
+}
 
-        process->cpu_time = (total_cpu_time - process->last_cpu_time) * 1000 / sysconf(_SC_CLK_TCK); /* busy milliseconds since last update */
+static void dlt_kpi_open_process_dir(DltKpiProcess *process)
+{
+    if (dlt_kpi_get_fd_budget() <= 0)
+        return;
 
-        if ((time_dif_ms > 0) && (cpu_count > 0))
-            process->cpu_time = process->cpu_time * 1000 / time_dif_ms / cpu_count; /* busy milliseconds per second per CPU */
+    char dirname[32];
+    snprintf(dirname, sizeof(dirname), "/proc/%d", process->pid);
 
-    }
-    else {
-        process->cpu_time = 0;
+    process->dir_fd = open(dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (process->dir_fd >= 0)
+        dlt_kpi_fd_budget--;
+}
+
+/* Parses the fields of /proc/<pid>/stat needed for the KPIs in one pass.
+ * The command name may contain blanks and parentheses, so numbering starts
+ * behind its last closing parenthesis. */
+DLT_STATIC DltReturnValue dlt_kpi_parse_process_stat(const char *buffer, DltKpiProcessStat *stat)
+{
+    const char *pos = strrchr(buffer, ')');
+    unsigned int field = 3;
+
+    if (pos == NULL)
+        return DLT_RETURN_ERROR;
+
+    memset(stat, 0, sizeof(DltKpiProcessStat));
+    pos++;
+
+    while (field <= DLT_KPI_STAT_BLKIO_TICKS) {
+        while ((*pos == ' ') || (*pos == '\t'))
+            pos++;
+
+        if ((*pos == '\0') || (*pos == '\n'))
+            return DLT_RETURN_ERROR;
+
+        char *end;
+
+        switch (field) {
+        case DLT_KPI_STAT_PPID:
+            stat->ppid = (pid_t)strtol(pos, &end, 10);
+            break;
+        case DLT_KPI_STAT_UTIME:
+            stat->utime = strtoul(pos, &end, 10);
+            break;
+        case DLT_KPI_STAT_STIME:
+            stat->stime = strtoul(pos, &end, 10);
+            break;
+        case DLT_KPI_STAT_RSS:
+            stat->rss = strtol(pos, &end, 10);
+            break;
+        case DLT_KPI_STAT_BLKIO_TICKS:
+            stat->blkio_ticks = strtoul(pos, &end, 10);
+            break;
+        default:
+            end = (char *)strpbrk(pos, " \t\n");
+
+            if (end == NULL)
+                return DLT_RETURN_ERROR;
+
+            break;
+        }
+
+        pos = end;
+        field++;
     }
 
-    process->last_cpu_time = total_cpu_time;
+    return DLT_RETURN_OK;
+}
+
+/* Sums the values of the given keys in a "key: value" file like status or io */
+DLT_STATIC DltReturnValue dlt_kpi_sum_process_keys(const char *buffer, const char *key1, const char *key2,
+                                                   unsigned long int *sum)
+{
+    const char *line = buffer;
+    size_t len1 = strlen(key1), len2 = strlen(key2);
+
+    *sum = 0;
+
+    while (*line != '\0') {
+        const char *value = NULL;
+
+        if ((strncmp(line, key1, len1) == 0) && (line[len1] == ':'))
+            value = line + len1 + 1;
+        else if ((strncmp(line, key2, len2) == 0) && (line[len2] == ':'))
+            value = line + len2 + 1;
+
+        if (value != NULL) {
+            char *chk;
+            *sum += strtoul(value, &chk, 10);
+
+            if ((chk == value) || ((*chk != '\n') && (*chk != '\0')))
+                return DLT_RETURN_ERROR;
+        }
+
+        line = strchr(line, '\n');
+
+        if (line == NULL)
+            break;
+
+        line++;
+    }
 
     return DLT_RETURN_OK;
 }
 
-DltReturnValue dlt_kpi_process_update_rss(DltKpiProcess *process)
+/* Returns a copy of the "(name)" field of a stat buffer */
+DLT_STATIC char *dlt_kpi_get_process_stat_name(const char *buffer)
 {
-    if (process == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
+    const char *begin = strchr(buffer, '(');
+    const char *end = strrchr(buffer, ')');
+
+    if ((begin == NULL) || (end == NULL) || (end < begin)) {
+        fprintf(stderr, "%s: cmdline entry not found\n", __func__);
+        return NULL;
+    }
+
+    return strndup(begin, (size_t)(end - begin + 1));
+}
+
+static DltReturnValue dlt_kpi_process_update_stat(DltKpiProcess *process, unsigned long int time_dif_ms)
+{
+    char buffer[BUFFER_SIZE];
+    DltKpiProcessStat stat;
+    DltReturnValue ret;
+
+    if ((ret = dlt_kpi_read_process_file(process, &process->stat_fd, "stat", buffer, sizeof(buffer))) < DLT_RETURN_OK)
+        return ret;
+
+    if ((ret = dlt_kpi_parse_process_stat(buffer, &stat)) < DLT_RETURN_OK) {
+        fprintf(stderr, "Could not parse /proc/%d/stat\n", process->pid);
+        return ret;
+    }
+
+    int cpu_count = dlt_kpi_get_cpu_count();
+
+    /* io wait */
+    process->io_wait = (stat.blkio_ticks - process->last_io_wait) * 1000 / (unsigned long)sysconf(_SC_CLK_TCK); /* busy milliseconds since last update */
+
+    if ((time_dif_ms > 0) && (cpu_count > 0))
+        process->io_wait = process->io_wait * 1000 / time_dif_ms / (unsigned long)cpu_count; /* busy milliseconds per second per CPU */
+
+    process->last_io_wait = stat.blkio_ticks;
+
+    /* cpu time */
+    unsigned long total_cpu_time = stat.utime + stat.stime;
+
+    if ((process->last_cpu_time > 0) && (process->last_cpu_time <= total_cpu_time)) {
+        process->cpu_time = (total_cpu_time - process->last_cpu_time) * 1000 / (unsigned long)sysconf(_SC_CLK_TCK); /* busy milliseconds since last update */
+
+        if ((time_dif_ms > 0) && (cpu_count > 0))
+            process->cpu_time = process->cpu_time * 1000 / time_dif_ms / (unsigned long)cpu_count; /* busy milliseconds per second per CPU */
+
+    }
+    else {
+        process->cpu_time = 0;
     }
 
-    process->rss = dlt_kpi_read_process_stat_to_ulong(process->pid, 24);
+    process->last_cpu_time = total_cpu_time;
+
+    process->rss = stat.rss;
+    process->ppid = stat.ppid;
 
     return DLT_RETURN_OK;
 }
@@ -101,38 +300,22 @@ DltReturnValue dlt_kpi_process_update_ctx_switches(DltKpiProcess *process)
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    char *buffer, *tok, *last_tok;
-    char *delim = " :\t\n";
-    last_tok = NULL;
-
+    char buffer[BUFFER_SIZE];
+    unsigned long int ctx_switches;
     DltReturnValue ret;
 
-    if ((ret = dlt_kpi_read_process_file_to_str(process->pid, &buffer, "status")) < DLT_RETURN_OK) return ret;
-
     process->ctx_switches = 0;
 
-    tok = strtok(buffer, delim);
-
-    while (tok != NULL) {
-        if (last_tok != NULL) {
-            if ((strcmp(last_tok,
-                        "voluntary_ctxt_switches") == 0) || (strcmp(last_tok, "nonvoluntary_ctxt_switches") == 0)) {
-                char *chk;
-                process->ctx_switches += strtol(tok, &chk, 10);
-
-                if (*chk != '\0') {
-                    fprintf(stderr, "Could not parse ctx_switches info from /proc/%d/status", process->pid);
-                    free(buffer);
-                    return DLT_RETURN_ERROR;
-                }
-            }
-        }
+    if ((ret = dlt_kpi_read_process_file(process, &process->status_fd, "status", buffer, sizeof(buffer))) < DLT_RETURN_OK)
+        return ret;
 
-        last_tok = tok;
-        tok = strtok(NULL, delim);
+    if (dlt_kpi_sum_process_keys(buffer, "voluntary_ctxt_switches", "nonvoluntary_ctxt_switches",
+                                 &ctx_switches) < DLT_RETURN_OK) {
+        fprintf(stderr, "Could not parse ctx_switches info from /proc/%d/status", process->pid);
+        return DLT_RETURN_ERROR;
     }
 
-    free(buffer);
+    process->ctx_switches = (long int)ctx_switches;
 
     return DLT_RETURN_OK;
 }
@@ -144,39 +327,19 @@ DltReturnValue dlt_kpi_process_update_io_bytes(DltKpiProcess *process)
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    char *buffer, *tok, *last_tok;
-    char *delim = " :\t\n";
-    last_tok = NULL;
-
+    char buffer[BUFFER_SIZE];
     DltReturnValue ret;
 
-    if ((ret = dlt_kpi_read_process_file_to_str(process->pid, &buffer, "io")) < DLT_RETURN_OK)
-        return ret;
-
     process->io_bytes = 0;
 
-    tok = strtok(buffer, delim);
-
-    while (tok != NULL) {
-        if (last_tok != NULL) {
-            if ((strcmp(last_tok, "rchar") == 0) || (strcmp(last_tok, "wchar") == 0)) {
-                char *chk;
-                process->io_bytes += strtoul(tok, &chk, 10);
-
-                if (*chk != '\0') {
-                    fprintf(stderr, "Could not parse io_bytes info from /proc/%d/io", process->pid);
-                    free(buffer);
-                    return DLT_RETURN_ERROR;
-                }
-            }
-        }
+    if ((ret = dlt_kpi_read_process_file(process, &process->io_fd, "io", buffer, sizeof(buffer))) < DLT_RETURN_OK)
+        return ret;
 
-        last_tok = tok;
-        tok = strtok(NULL, delim);
+    if (dlt_kpi_sum_process_keys(buffer, "rchar", "wchar", &process->io_bytes) < DLT_RETURN_OK) {
+        fprintf(stderr, "Could not parse io_bytes info from /proc/%d/io", process->pid);
+        return DLT_RETURN_ERROR;
     }
 
-    free(buffer);
-
     return DLT_RETURN_OK;
 }
 
@@ -188,9 +351,13 @@ DltReturnValue dlt_kpi_update_process(DltKpiProcess *process, unsigned long int
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    dlt_kpi_process_update_io_wait(process, time_dif_ms);
-    dlt_kpi_process_update_cpu_time(process, time_dif_ms);
-    dlt_kpi_process_update_rss(process);
+    /* stat can not be read once the process is gone, even if its pid was reused */
+    DltReturnValue ret = dlt_kpi_process_update_stat(process, time_dif_ms);
+
+    if (ret < DLT_RETURN_OK)
+        return ret;
+
+    /* io is not readable for processes of other users, so failures are ignored */
     dlt_kpi_process_update_ctx_switches(process);
     dlt_kpi_process_update_io_bytes(process);
 
@@ -209,15 +376,18 @@ DltKpiProcess *dlt_kpi_create_process(int pid)
     memset(new_process, 0, sizeof(DltKpiProcess));
 
     new_process->pid = pid;
-    new_process->ppid = (pid_t)dlt_kpi_read_process_stat_to_ulong(pid, 4);
+    new_process->dir_fd = new_process->stat_fd = new_process->status_fd = new_process->io_fd = -1;
 
-    dlt_kpi_read_process_file_to_str(pid, &(new_process->command_line), "cmdline");
+    dlt_kpi_open_process_dir(new_process);
 
-    if (new_process->command_line != NULL)
-        if (strlen(new_process->command_line) == 0) {
-            free(new_process->command_line);
-            dlt_kpi_read_process_stat_cmdline(pid, &(new_process->command_line));
-        }
+    char buffer[BUFFER_SIZE];
+
+    /* Only the first argument is used; kernel threads have an empty command line
+     * and are named by the command from stat instead */
+    if (dlt_kpi_read_process_file(new_process, NULL, "cmdline", buffer, sizeof(buffer)) == DLT_RETURN_OK)
+        new_process->command_line = strdup(buffer);
+    else if (dlt_kpi_read_process_file(new_process, &new_process->stat_fd, "stat", buffer, sizeof(buffer)) == DLT_RETURN_OK)
+        new_process->command_line = dlt_kpi_get_process_stat_name(buffer);
 
     dlt_kpi_update_process(new_process, 0);
 
@@ -256,7 +426,8 @@ DltKpiProcess *dlt_kpi_clone_process(DltKpiProcess *original)
         new_process->command_line = NULL;
     }
 
-    new_process->next = new_process->prev = NULL;
+    new_process->next = new_process->prev = new_process->hash_next = NULL;
+    new_process->dir_fd = new_process->stat_fd = new_process->status_fd = new_process->io_fd = -1;
 
     return new_process;
 }
@@ -271,6 +442,7 @@ DltReturnValue dlt_kpi_free_process(DltKpiProcess *process)
     if (process->command_line != NULL)
         free(process->command_line);
 
+    dlt_kpi_close_process_fds(process);
     free(process);
 
     return DLT_RETURN_OK;
@@ -295,129 +467,6 @@ DltReturnValue dlt_kpi_print_process(DltKpiProcess *process)
     return DLT_RETURN_OK;
 }
 
-DltReturnValue dlt_kpi_read_process_file_to_str(pid_t pid, char **target_str, char *subdir)
-{
-    if (target_str == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_ERROR;
-    }
-
-    *target_str = NULL;
-
-    if (pid <= 0) {
-        fprintf(stderr, "%s: Invalid Parameter (PID)\n", __func__);
-        return DLT_RETURN_ERROR;
-    }
-
-    if (subdir == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_ERROR;
-    }
-
-    char filename[BUFFER_SIZE];
-    snprintf(filename, BUFFER_SIZE, "/proc/%d/%s", pid, subdir);
-
-    return dlt_kpi_read_file_compact(filename, target_str);
-}
-
-unsigned long int dlt_kpi_read_process_stat_to_ulong(pid_t pid, unsigned int index)
-{
-    if (pid <= 0) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return 0;
-    }
-
-    char *buffer = NULL;
-
-    if (dlt_kpi_read_process_file_to_str(pid, &buffer, "stat") < DLT_RETURN_OK) {
-        /* fprintf(stderr, "dlt_kpi_read_process_stat_to_ulong(): Error while reading process stat file. Pid: %d. Requested index: %u\n", pid, index); // can happen if process closed shortly before */
-
-        if (buffer != NULL)
-            free(buffer);
-
-        return 0;
-    }
-
-    char *tok = strtok(buffer, " \t\n");
-    unsigned int i = 1, found = 0;
-
-    while (tok != NULL) {
-        if (i == index) {
-            found = 1;
-            break;
-        }
-
-        i++;
-        tok = strtok(NULL, " \t\n");
-    }
-
-    unsigned long int ret = 0;
-
-    if (found) {
-        char *check = NULL;
-        ret = strtoul(tok, &check, 10);
-
-        if (*check != '\0') {
-            fprintf(stderr, "dlt_kpi_read_process_stat_to_ulong(): Could not extract token\n");
-            ret = 0;
-        }
-    }
-    else {
-        fprintf(stderr, "dlt_kpi_read_process_stat_to_ulong(): Index not found\n");
-    }
-
-    free(buffer);
-
-    return ret;
-}
-
-DltReturnValue dlt_kpi_read_process_stat_cmdline(pid_t pid, char **buffer)
-{
-    if (pid <= 0) {
-        fprintf(stderr, "%s: Invalid Parameter (PID)\n", __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
-    }
-
-    if (buffer == NULL) {
-        fprintf(stderr, "%s: Invalid Parameter (NULL)\n", __func__);
-        return DLT_RETURN_WRONG_PARAMETER;
-    }
-
-    char *tmp_buffer = NULL;
-    DltReturnValue tmp = dlt_kpi_read_process_file_to_str(pid, &tmp_buffer, "stat");
-
-    if (tmp < DLT_RETURN_OK) {
-        if (tmp_buffer != NULL)
-            free(tmp_buffer);
-
-        return tmp;
-    }
-
-    char *tok = strtok(tmp_buffer, " \t\n");
-    unsigned int i = 1;
-
-    while (tok != NULL) {
-        if (i == 2)
-            break;
-
-        i++;
-        tok = strtok(NULL, " \t\n");
-    }
-
-    if (i == 2) {
-        (*buffer) = malloc(strlen(tok) + 1);
-        strncpy(*buffer, tok, strlen(tok) + 1);
-    }
-    else {
-        fprintf(stderr, "dlt_kpi_read_process_stat_cmdline(): cmdline entry not found\n");
-        return DLT_RETURN_ERROR;
-    }
-
-    free(tmp_buffer);
-
-    return DLT_RETURN_OK;
-}
-
 DltReturnValue dlt_kpi_get_msg_process_update(DltKpiProcess *process, char *buffer, int maxlen)
 {
     if ((process == NULL) || (buffer == NULL)) {
@@ -426,7 +475,7 @@ DltReturnValue dlt_kpi_get_msg_process_update(DltKpiProcess *process, char *buff
     }
 
     snprintf(buffer,
-             maxlen,
+             (size_t)maxlen,
              "%d;%lu;%ld;%ld;%lu;%lu",
              process->pid,
              process->cpu_time,
@@ -445,7 +494,7 @@ DltReturnValue dlt_kpi_get_msg_process_new(DltKpiProcess *process, char *buffer,
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    snprintf(buffer, maxlen, "%d;%d;%s", process->pid, process->ppid, process->command_line);
+    snprintf(buffer, (size_t)maxlen, "%d;%d;%s", process->pid, process->ppid, process->command_line);
 
     return DLT_RETURN_OK;
 }
@@ -457,7 +506,7 @@ DltReturnValue dlt_kpi_get_msg_process_stop(DltKpiProcess *process, char *buffer
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    snprintf(buffer, maxlen, "%d", process->pid);
+    snprintf(buffer, (size_t)maxlen, "%d", process->pid);
 
     return DLT_RETURN_OK;
 }
@@ -469,7 +518,7 @@ DltReturnValue dlt_kpi_get_msg_process_commandline(DltKpiProcess *process, char
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    snprintf(buffer, maxlen, "%d;%s", process->pid, process->command_line);
+    snprintf(buffer, (size_t)maxlen, "%d;%s", process->pid, process->command_line);
 
     return DLT_RETURN_OK;
 }
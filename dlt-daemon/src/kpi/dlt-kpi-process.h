@@ -31,17 +31,32 @@
 
 typedef struct DltKpiEventWatch DltKpiEventWatch; /* forward declaration */
 
+/* Fields of /proc/<pid>/stat used for the KPIs */
+typedef struct
+{
+    pid_t ppid;
+    unsigned long int utime, stime, blkio_ticks;
+    long int rss;
+} DltKpiProcessStat;
+
 typedef struct DltKpiProcess
 {
     pid_t pid, ppid;
     char *command_line;
     unsigned long int cpu_time, last_cpu_time, io_wait, last_io_wait, io_bytes;
     long int rss, ctx_switches;
+    unsigned long int reported_cpu_time; /* values of the last KEY or DIF dataset */
+    long int reported_rss;
+
+    /* /proc/<pid> directory and files kept open between intervals, -1 if not cached */
+    int dir_fd, stat_fd, status_fd, io_fd;
+    unsigned int generation; /* last /proc scan the process was seen in */
 
     struct DltKpiProcess *next, *prev;
+    struct DltKpiProcess *hash_next;
 } DltKpiProcess;
 
-DltKpiProcess *dlt_kpi_create_process();
+DltKpiProcess *dlt_kpi_create_process(int pid);
 DltKpiProcess *dlt_kpi_clone_process(DltKpiProcess *original);
 DltReturnValue dlt_kpi_free_process(DltKpiProcess *process);
 DltReturnValue dlt_kpi_print_process(DltKpiProcess *process);
@@ -51,4 +66,11 @@ DltReturnValue dlt_kpi_get_msg_process_stop(DltKpiProcess *process, char *buffer
 DltReturnValue dlt_kpi_get_msg_process_update(DltKpiProcess *process, char *buffer, int maxlen);
 DltReturnValue dlt_kpi_get_msg_process_commandline(DltKpiProcess *process, char *buffer, int maxlen);
 
+#ifdef DLT_UNIT_TESTS
+DltReturnValue dlt_kpi_parse_process_stat(const char *buffer, DltKpiProcessStat *stat);
+DltReturnValue dlt_kpi_sum_process_keys(const char *buffer, const char *key1, const char *key2,
+                                        unsigned long int *sum);
+char *dlt_kpi_get_process_stat_name(const char *buffer);
+#endif
+
 #endif /* SRC_KPI_DLT_KPI_PROCESS_H_ */
@@ -35,7 +35,7 @@ DLT_DECLARE_CONTEXT(kpi_ctx)
 DltKpiConfig config;
 
 static volatile sig_atomic_t stop_loop = 0;
-static DltKpiProcessList *list, *new_process_list, *stopped_process_list, *update_process_list;
+static DltKpiProcessList *process_list, *new_process_list, *stopped_process_list, *update_process_list;
 static struct timespec _tmp_time;
 static pthread_mutex_t process_list_mutex;
 
@@ -54,7 +54,7 @@ DltReturnValue dlt_kpi_log_check_commandlines();
 
 unsigned long int timespec_to_millis(struct timespec *time)
 {
-    return (time->tv_sec) * 1000 + (time->tv_nsec / 1000000);
+    return (unsigned long int)(time->tv_sec) * 1000 + (unsigned long int)(time->tv_nsec / 1000000);
 }
 
 unsigned long int get_millis()
@@ -63,6 +63,9 @@ unsigned long int get_millis()
     return timespec_to_millis(&_tmp_time);
 }
 
+/* Defined when unit testing, so the functions of this file can be linked
+ * into the test without a second main */
+#ifndef DLT_KPI_UNIT_TESTS_NO_MAIN
 int main(int argc, char **argv)
 {
     printf("Launching dlt-kpi...\n");
@@ -87,6 +90,10 @@ int main(int argc, char **argv)
     DLT_REGISTER_APP("PROC", "/proc/-filesystem logger application");
     DLT_REGISTER_CONTEXT_LL_TS(kpi_ctx, "PROC", "/proc/-filesystem logger context", config.log_level, 1);
 
+    /* Interrupt records are non-verbose in delta mode, all other messages stay verbose */
+    if (config.delta_mode)
+        DLT_NONVERBOSE_MODE();
+
     pthread_t process_thread;
     pthread_t irq_thread;
     pthread_t check_thread;
@@ -121,6 +128,7 @@ int main(int argc, char **argv)
 
     return 0;
 }
+#endif
 
 void dlt_kpi_init_sigterm_handler()
 {
@@ -143,7 +151,7 @@ void dlt_kpi_stop_loops(int sig)
 
 DltReturnValue dlt_kpi_init_process_lists()
 {
-    if ((list = dlt_kpi_create_process_list()) == NULL) return DLT_RETURN_ERROR;
+    if ((process_list = dlt_kpi_create_hashed_process_list()) == NULL) return DLT_RETURN_ERROR;
 
     if ((new_process_list = dlt_kpi_create_process_list()) == NULL) return DLT_RETURN_ERROR;
 
@@ -158,7 +166,7 @@ DltReturnValue dlt_kpi_free_process_lists()
 {
     DltReturnValue ret = DLT_RETURN_OK;
 
-    if (dlt_kpi_free_process_list(list) < DLT_RETURN_OK)
+    if (dlt_kpi_free_process_list(process_list) < DLT_RETURN_OK)
         ret = DLT_RETURN_ERROR;
 
     if (dlt_kpi_free_process_list(new_process_list) < DLT_RETURN_OK)
@@ -189,7 +197,7 @@ DltReturnValue dlt_kpi_process_loop()
     old_millis = get_millis();
 
     while (!stop_loop) {
-        /*DltReturnValue ret = */ dlt_kpi_update_process_list(list, config.process_log_interval);
+        /*DltReturnValue ret = */ dlt_kpi_update_process_list(process_list, (unsigned long)config.process_log_interval);
         /*if(ret < DLT_RETURN_OK) */
         /*    return ret; */
 
@@ -198,10 +206,10 @@ DltReturnValue dlt_kpi_process_loop()
         if (dif_millis >= (unsigned long)(config.process_log_interval))
             sleep_millis = 0;
         else
-            sleep_millis = config.process_log_interval - dif_millis;
+            sleep_millis = (unsigned long)config.process_log_interval - dif_millis;
 
-        ts.tv_sec = (sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC;
-        ts.tv_nsec = (sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC;
+        ts.tv_sec = (time_t)((sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC);
+        ts.tv_nsec = (long)((sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC);
         nanosleep(&ts, NULL);
 
         old_millis = get_millis();
@@ -286,109 +294,129 @@ DltReturnValue dlt_kpi_log_list(DltKpiProcessList *list,
     return DLT_RETURN_OK;
 }
 
+/* Queues a process for the ACT, KEY or DIF message of this interval */
+DLT_STATIC DltReturnValue dlt_kpi_add_active_process(DltKpiProcess *process, int keyframe)
+{
+    if (!config.delta_mode) {
+        if (process->cpu_time == 0) /* only log active processes */
+            return DLT_RETURN_OK;
+    }
+    else if (!keyframe) {
+        unsigned long int cpu_dif = (process->cpu_time > process->reported_cpu_time) ?
+            process->cpu_time - process->reported_cpu_time : process->reported_cpu_time - process->cpu_time;
+        long int rss_dif = labs(process->rss - process->reported_rss);
+
+        if ((cpu_dif < (unsigned long int)config.delta_cpu_threshold) && (rss_dif < config.delta_rss_threshold))
+            return DLT_RETURN_OK;
+    }
+
+    process->reported_cpu_time = process->cpu_time;
+    process->reported_rss = process->rss;
+
+    return dlt_kpi_append_process(update_process_list, dlt_kpi_clone_process(process));
+}
+
 DltReturnValue dlt_kpi_update_process_list(DltKpiProcessList *list, unsigned long int time_dif_ms)
 {
     static char *strchk;
     static DltReturnValue tmp_ret;
     static struct dirent *current_dir;
     static pid_t current_dir_pid;
+    static DIR *proc_dir;
+    static unsigned int generation;
+    static unsigned int interval;
 
     if (list == NULL) {
         fprintf(stderr, "dlt_kpi_update_process_list(): Nullpointer parameter");
         return DLT_RETURN_WRONG_PARAMETER;
     }
 
-    DIR *proc_dir = opendir("/proc");
-
+    /* /proc stays open, rewinding it is enough to see the current processes */
     if (proc_dir == NULL) {
-        dlt_log(LOG_ERR, "Could not open /proc/ !\n");
-        return DLT_RETURN_ERROR;
+        proc_dir = opendir("/proc");
+
+        if (proc_dir == NULL) {
+            dlt_log(LOG_ERR, "Could not open /proc/ !\n");
+            return DLT_RETURN_ERROR;
+        }
+    }
+    else {
+        rewinddir(proc_dir);
     }
 
-    current_dir = readdir(proc_dir);
-    dlt_kpi_reset_cursor(list);
+    generation++;
 
-    int debug_process_count = 0;
+    int keyframe = config.delta_mode && ((interval++ % (unsigned int)config.keyframe_interval) == 0);
 
     if (pthread_mutex_lock(&process_list_mutex) < 0) {
         fprintf(stderr, "Can't lock mutex\n");
         return DLT_RETURN_ERROR;
     }
 
-    while (1) {
-        if (current_dir == NULL) {
-            /* no more active processes.. delete all remaining processes in the list */
-            if (list->cursor != NULL)
-                while (list->cursor != NULL) {
-                    if ((tmp_ret =
-                             dlt_kpi_add_process_after_cursor(stopped_process_list,
-                                                              dlt_kpi_clone_process(list->cursor))) < DLT_RETURN_OK)
-                        return tmp_ret;
+    tmp_ret = DLT_RETURN_OK;
 
-                    dlt_kpi_remove_process_at_cursor(list);
-                }
+    while ((tmp_ret == DLT_RETURN_OK) && ((current_dir = readdir(proc_dir)) != NULL)) {
+        current_dir_pid = (pid_t)strtol(current_dir->d_name, &strchk, 10);
 
-            break;
-        }
+        if ((*strchk != '\0') || (current_dir_pid <= 0))
+            continue; /* no valid PID */
 
-        current_dir_pid = strtol(current_dir->d_name, &strchk, 10);
+        DltKpiProcess *process = dlt_kpi_find_process(list, current_dir_pid);
 
-        if ((*strchk != '\0') || (current_dir_pid <= 0)) {
-            /* no valid PID */
-            current_dir = readdir(proc_dir); /* next process in proc-fs */
-            continue;
+        if ((process != NULL) && (dlt_kpi_update_process(process, time_dif_ms) < DLT_RETURN_OK)) {
+            /* The process ended since the last interval and its pid was reused */
+            list->cursor = process;
+
+            if ((tmp_ret = dlt_kpi_append_process(stopped_process_list,
+                                                  dlt_kpi_clone_process(process))) < DLT_RETURN_OK)
+                break;
+
+            if ((tmp_ret = dlt_kpi_remove_process_at_cursor(list)) < DLT_RETURN_OK)
+                break;
+
+            process = NULL;
         }
 
-        /* compare the /proc/-filesystem with our process-list */
-        if ((list->cursor == NULL) || (current_dir_pid < list->cursor->pid)) { /* New Process */
+        if (process == NULL) { /* New Process */
             DltKpiProcess *new_process = dlt_kpi_create_process(current_dir_pid);
 
             if (new_process == NULL) {
                 fprintf(stderr, "Error: Could not create process (out of memory?)\n");
-                return DLT_RETURN_ERROR;
+                tmp_ret = DLT_RETURN_ERROR;
+                break;
             }
 
-            if ((tmp_ret = dlt_kpi_add_process_before_cursor(list, new_process)) < DLT_RETURN_OK)
-                return tmp_ret;
+            new_process->generation = generation;
 
-            if ((tmp_ret =
-                     dlt_kpi_add_process_before_cursor(new_process_list,
-                                                       dlt_kpi_clone_process(new_process))) < DLT_RETURN_OK)
-                return tmp_ret;
+            if ((tmp_ret = dlt_kpi_add_process_at_start(list, new_process)) < DLT_RETURN_OK)
+                break;
 
-            current_dir = readdir(proc_dir); /* next process in proc-fs */
-            debug_process_count++;
-        }
-        else if (current_dir_pid > list->cursor->pid) /* Process ended */
-        {
-            if ((tmp_ret =
-                     dlt_kpi_add_process_after_cursor(stopped_process_list,
-                                                      dlt_kpi_clone_process(list->cursor))) < DLT_RETURN_OK)
-                return tmp_ret;
+            if ((tmp_ret = dlt_kpi_append_process(new_process_list, dlt_kpi_clone_process(new_process))) < DLT_RETURN_OK)
+                break;
 
-            if ((tmp_ret = dlt_kpi_remove_process_at_cursor(list)) < DLT_RETURN_OK)
-                return tmp_ret;
+            process = new_process;
         }
-        else if (current_dir_pid == list->cursor->pid) /* Staying process */
-        {
-            /* update data */
-            if ((tmp_ret = dlt_kpi_update_process(list->cursor, time_dif_ms)) < DLT_RETURN_OK)
-                return tmp_ret;
-
-            if (list->cursor->cpu_time > 0) /* only log active processes */
-                if ((tmp_ret =
-                         dlt_kpi_add_process_after_cursor(update_process_list,
-                                                          dlt_kpi_clone_process(list->cursor))) < DLT_RETURN_OK) {
-                    fprintf(stderr, "dlt_kpi_update_process_list: Can't add process to list updateProcessList\n");
-                    return tmp_ret;
-                }
-
-            if ((tmp_ret = dlt_kpi_increment_cursor(list)) < DLT_RETURN_OK) /* next process in list */
-                return tmp_ret;
-
-            current_dir = readdir(proc_dir); /* next process in proc-fs */
-            debug_process_count++;
+        else { /* Staying process */
+            process->generation = generation;
         }
+
+        if ((tmp_ret = dlt_kpi_add_active_process(process, keyframe)) < DLT_RETURN_OK)
+            fprintf(stderr, "dlt_kpi_update_process_list: Can't add process to list updateProcessList\n");
+    }
+
+    /* Processes not seen in this scan have ended */
+    dlt_kpi_reset_cursor(list);
+
+    while ((tmp_ret == DLT_RETURN_OK) && (list->cursor != NULL)) {
+        if (list->cursor->generation == generation) {
+            dlt_kpi_increment_cursor(list);
+            continue;
+        }
+
+        if ((tmp_ret =
+                 dlt_kpi_append_process(stopped_process_list,
+                                        dlt_kpi_clone_process(list->cursor))) == DLT_RETURN_OK)
+            tmp_ret = dlt_kpi_remove_process_at_cursor(list);
     }
 
     if (pthread_mutex_unlock(&process_list_mutex) < 0) {
@@ -396,6 +424,9 @@ DltReturnValue dlt_kpi_update_process_list(DltKpiProcessList *list, unsigned lon
         return DLT_RETURN_ERROR;
     }
 
+    if (tmp_ret < DLT_RETURN_OK)
+        return tmp_ret;
+
     /* Log new processes */
     if ((tmp_ret = dlt_kpi_log_list(new_process_list, &dlt_kpi_get_msg_process_new, "NEW", 1)) < DLT_RETURN_OK)
         return tmp_ret;
@@ -404,13 +435,11 @@ DltReturnValue dlt_kpi_update_process_list(DltKpiProcessList *list, unsigned lon
     if ((tmp_ret = dlt_kpi_log_list(stopped_process_list, &dlt_kpi_get_msg_process_stop, "STP", 1)) < DLT_RETURN_OK)
         return tmp_ret;
 
-    /* Log active processes */
-    if ((tmp_ret = dlt_kpi_log_list(update_process_list, &dlt_kpi_get_msg_process_update, "ACT", 1)) < DLT_RETURN_OK)
+    /* Log active processes, or all processes resp. the changed ones in delta mode */
+    if ((tmp_ret = dlt_kpi_log_list(update_process_list, &dlt_kpi_get_msg_process_update,
+                                    config.delta_mode ? (keyframe ? "KEY" : "DIF") : "ACT", 1)) < DLT_RETURN_OK)
         return tmp_ret;
 
-    if (closedir(proc_dir) < 0)
-        fprintf(stderr, "Could not close /proc/ directory\n");
-
     return DLT_RETURN_OK;
 }
 
@@ -429,8 +458,14 @@ DltReturnValue dlt_kpi_irq_loop()
 
     old_millis = get_millis();
 
+    unsigned int interval = 0;
+
     while (!stop_loop) {
-        /*DltReturnValue ret = */ dlt_kpi_log_interrupts(&kpi_ctx, config.log_level);
+        if (config.delta_mode)
+            dlt_kpi_log_interrupt_deltas(&kpi_ctx, config.log_level,
+                                         (interval++ % (unsigned int)config.keyframe_interval) == 0);
+        else
+            dlt_kpi_log_interrupts(&kpi_ctx, config.log_level);
         /*if(ret < DLT_RETURN_OK) */
         /*    return ret; */
 
@@ -439,10 +474,10 @@ DltReturnValue dlt_kpi_irq_loop()
         if (dif_millis >= (unsigned long)(config.irq_log_interval))
             sleep_millis = 0;
         else
-            sleep_millis = config.irq_log_interval - dif_millis;
+            sleep_millis = (unsigned long)config.irq_log_interval - dif_millis;
 
-        ts.tv_sec = (sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC;
-        ts.tv_nsec = (sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC;
+        ts.tv_sec = (time_t)((sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC);
+        ts.tv_nsec = (long)((sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC);
         nanosleep(&ts, NULL);
 
         old_millis = get_millis();
@@ -476,10 +511,10 @@ DltReturnValue dlt_kpi_check_loop()
         if (dif_millis >= (unsigned long)(config.check_log_interval))
             sleep_millis = 0;
         else
-            sleep_millis = config.check_log_interval - dif_millis;
+            sleep_millis = (unsigned long)config.check_log_interval - dif_millis;
 
-        ts.tv_sec = (sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC;
-        ts.tv_nsec = (sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC;
+        ts.tv_sec = (time_t)((sleep_millis * NANOSEC_PER_MILLISEC) / NANOSEC_PER_SEC);
+        ts.tv_nsec = (long)((sleep_millis * NANOSEC_PER_MILLISEC) % NANOSEC_PER_SEC);
         nanosleep(&ts, NULL);
 
         old_millis = get_millis();
@@ -495,7 +530,7 @@ DltReturnValue dlt_kpi_log_check_commandlines()
         return DLT_RETURN_ERROR;
     }
 
-    DltReturnValue ret = dlt_kpi_log_list(list, dlt_kpi_get_msg_process_commandline, "CHK", 0);
+    DltReturnValue ret = dlt_kpi_log_list(process_list, dlt_kpi_get_msg_process_commandline, "CHK", 0);
 
     if (pthread_mutex_unlock(&process_list_mutex) < 0) {
         fprintf(stderr, "Can't unlock mutex\n");
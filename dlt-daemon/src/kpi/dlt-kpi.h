@@ -52,6 +52,10 @@ typedef struct
 {
     int process_log_interval, irq_log_interval, check_log_interval;
     DltLogLevelType log_level;
+    int delta_mode;          /* log only changes between keyframes */
+    int delta_cpu_threshold; /* minimum CPU time change to log a process in delta mode */
+    int delta_rss_threshold; /* minimum RSS change to log a process in delta mode */
+    int keyframe_interval;   /* number of intervals between two keyframes in delta mode */
 } DltKpiConfig;
 
 /* FUNCTION DECLARATIONS: */
@@ -60,4 +64,10 @@ DltReturnValue dlt_kpi_read_configuration_file(DltKpiConfig *config, char *file_
 void dlt_kpi_free_cli_options(DltKpiOptions *options);
 DltReturnValue dlt_kpi_init(int argc, char **argv, DltKpiConfig *config);
 
+#ifdef DLT_UNIT_TESTS
+DltReturnValue dlt_kpi_init_process_lists();
+DltReturnValue dlt_kpi_free_process_lists();
+DltReturnValue dlt_kpi_add_active_process(DltKpiProcess *process, int keyframe);
+#endif
+
 #endif /* SRC_KPI_DLT_KPI_H_ */
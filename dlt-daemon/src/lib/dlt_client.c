@@ -108,8 +108,28 @@ uint8_t dlt_client_dlt_version = DLTProtocolV1;
 
 static int (*message_callback_function)(DltMessage *message, void *data) = NULL;
 static int (*message_callback_function_v2)(DltMessageV2 *message, void *data) = NULL;
+static int (*message_view_callback_function)(DltMessageView *view, void *data) = NULL;
 static bool (*fetch_next_message_callback_function)(void *data) = NULL;
 
+/* Decompression of the received stream, see dlt_client_set_compression() */
+struct DltClientCompression
+{
+    DltCompression *stream;
+    char *in;               /* received data, not decompressed yet */
+    size_t in_offset;
+    size_t in_size;
+};
+
+static void dlt_client_compression_free(struct DltClientCompression *compression)
+{
+    if (compression == NULL)
+        return;
+
+    dlt_compression_free(compression->stream);
+    free(compression->in);
+    free(compression);
+}
+
 void dlt_client_register_message_callback(int (*registerd_callback)(DltMessage *message, void *data))
 {
     message_callback_function = registerd_callback;
@@ -120,6 +140,11 @@ void dlt_client_register_message_callback_v2(int (*registerd_callback)(DltMessag
     message_callback_function_v2 = registerd_callback;
 }
 
+void dlt_client_register_message_view_callback(int (*registerd_callback)(DltMessageView *view, void *data))
+{
+    message_view_callback_function = registerd_callback;
+}
+
 void dlt_client_register_fetch_next_message_callback(bool (*registerd_callback)(void *data))
 {
     fetch_next_message_callback_function = registerd_callback;
@@ -147,6 +172,7 @@ DltReturnValue dlt_client_init_port(DltClient *client, int port, int verbose)
     client->receiver.buf = NULL;
     client->receiver.backup_buf = NULL;
     client->hostip = NULL;
+    client->compression = NULL;
 
     return DLT_RETURN_OK;
 }
@@ -185,30 +211,34 @@ DltReturnValue dlt_client_init(DltClient *client, int verbose)
     return dlt_client_init_port(client, servPort, verbose);
 }
 
-DltReturnValue dlt_client_connect(DltClient *client, int verbose)
+/* Time to wait for a TCP connection in dlt_client_connect() */
+#define DLT_CLIENT_CONNECT_TIMEOUT 500
+
+/**
+ * Create the socket of a TCP or UNIX mode client and connect it.
+ * @param client pointer to dlt client structure
+ * @param timeout time in ms to wait for a connection in progress, 0 to return
+ *        while it is in progress, -1 to connect in blocking mode
+ * @return DLT_RETURN_OK if connected, DLT_RETURN_TRUE if the connection is
+ *         in progress, negative value if there was an error
+ */
+static DltReturnValue dlt_client_connect_socket(DltClient *client, int timeout)
 {
-    const int yes = 1;
     char portnumbuffer[33] = {0};
     struct addrinfo hints, *servinfo, *p;
     struct sockaddr_un addr;
-    int rv;
-    struct ip_mreq mreq;
-    DltReceiverType receiver_type = DLT_RECEIVE_FD;
-
     struct pollfd pfds[1];
-    int ret;
+    int log_level = (timeout == 0) ? LOG_DEBUG : LOG_ERR;
+    int rv;
     int n;
     socklen_t m = sizeof(n);
     int connect_errno = 0;
-
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_socktype = SOCK_STREAM;
-
-    if (client == 0)
-        return DLT_RETURN_ERROR;
+    DltReturnValue ret = DLT_RETURN_OK;
 
     switch (client->mode) {
     case DLT_CLIENT_MODE_TCP:
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_socktype = SOCK_STREAM;
         snprintf(portnumbuffer, 32, "%d", client->port);
 
         if ((rv = getaddrinfo(client->servIP, portnumbuffer, &hints, &servinfo)) != 0) {
@@ -225,6 +255,7 @@ DltReturnValue dlt_client_connect(DltClient *client, int verbose)
                          "%s: socket() failed! %s\n",
                          __func__,
                          strerror(errno));
+                connect_errno = errno;
                 continue;
             }
 
@@ -234,72 +265,148 @@ DltReturnValue dlt_client_connect(DltClient *client, int verbose)
                 dlt_vlog(LOG_WARNING,
                  "%s: Socket cannot be changed to NON BLOCK: %s\n",
                  __func__, strerror(errno));
+                connect_errno = errno;
                 close(client->sock);
                 continue;
             }
 
-            if (connect(client->sock, p->ai_addr, p->ai_addrlen) < 0) {
-                if (errno == EINPROGRESS) {
-                    pfds[0].fd = client->sock;
-                    pfds[0].events = POLLOUT;
-                    ret = poll(pfds, 1, 500);
-                    if (ret < 0) {
-                        dlt_vlog(LOG_ERR, "%s: Failed to poll with err [%s]\n",
-                        __func__, strerror(errno));
-                        close(client->sock);
-                        continue;
-                    }
-                    else if ((pfds[0].revents & POLLOUT) &&
-                            getsockopt(client->sock, SOL_SOCKET,
-                                    SO_ERROR, (void*)&n, &m) == 0) {
-                        if (n == 0) {
-                            dlt_vlog(LOG_DEBUG, "%s: Already connect\n", __func__);
-                            if(fcntl(client->sock, F_SETFL,
-                                    fcntl(client->sock,F_GETFL,0) & ~O_NONBLOCK) < 0) {
-                                dlt_vlog(LOG_WARNING,
-                                "%s: Socket cannot be changed to BLOCK with err [%s]\n",
-                                __func__, strerror(errno));
-                                close(client->sock);
-                                continue;
-                            }
-                        }
-                        else {
-                            connect_errno = n;
-                            close(client->sock);
-                            continue;
-                        }
-                    }
-                    else {
-                        connect_errno = errno;
-                        close(client->sock);
-                        continue;
-                    }
-                }
-                else {
-                    connect_errno = errno;
-                    close(client->sock);
-                    continue;
-                }
+            if (connect(client->sock, p->ai_addr, p->ai_addrlen) == 0) {
+                ret = DLT_RETURN_OK;
+                break;
+            }
+
+            if (errno != EINPROGRESS) {
+                connect_errno = errno;
+                close(client->sock);
+                continue;
+            }
+
+            if (timeout == 0) {
+                ret = DLT_RETURN_TRUE;
+                break;
+            }
+
+            pfds[0].fd = client->sock;
+            pfds[0].events = POLLOUT;
+
+            if (poll(pfds, 1, timeout) < 0) {
+                dlt_vlog(LOG_ERR, "%s: Failed to poll with err [%s]\n",
+                __func__, strerror(errno));
+                connect_errno = errno;
+                close(client->sock);
+                continue;
             }
 
+            if (!(pfds[0].revents & POLLOUT)) {
+                connect_errno = ETIMEDOUT;
+                close(client->sock);
+                continue;
+            }
+
+            if (getsockopt(client->sock, SOL_SOCKET, SO_ERROR, (void*)&n, &m) != 0)
+                n = errno;
+
+            if (n != 0) {
+                connect_errno = n;
+                close(client->sock);
+                continue;
+            }
+
+            ret = DLT_RETURN_OK;
             break;
         }
 
         freeaddrinfo(servinfo);
 
         if (p == NULL) {
-            dlt_vlog(LOG_ERR,
-                     "%s: ERROR: failed to connect! %s\n",
+            client->sock = -1;
+            dlt_vlog(log_level,
+                     "%s: ERROR: failed to connect to %s! %s\n",
                      __func__,
+                     client->servIP,
                      strerror(connect_errno));
             return DLT_RETURN_ERROR;
         }
 
-        if (verbose) {
-            dlt_vlog(LOG_INFO,
-                     "%s: Connected to DLT daemon (%s)\n",
+        break;
+    case DLT_CLIENT_MODE_UNIX:
+        if ((client->sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+            dlt_vlog(LOG_ERR,
+                     "%s: ERROR: (unix) socket error: %s\n",
                      __func__,
-                     client->servIP);
+                     strerror(errno));
+            return DLT_RETURN_ERROR;
+        }
+
+        if ((timeout >= 0) &&
+            (fcntl(client->sock, F_SETFL, fcntl(client->sock, F_GETFL, 0) | O_NONBLOCK) < 0)) {
+            dlt_vlog(LOG_ERR,
+                     "%s: ERROR: (unix) socket cannot be changed to NON BLOCK: %s\n",
+                     __func__,
+                     strerror(errno));
+            close(client->sock);
+            client->sock = -1;
+            return DLT_RETURN_ERROR;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, client->socketPath, sizeof(addr.sun_path) - 1);
+
+        if (connect(client->sock,
+                    (struct sockaddr *) &addr,
+                    sizeof(addr)) == -1) {
+            if ((errno != EINPROGRESS) || (timeout != 0)) {
+                dlt_vlog(log_level,
+                         "%s: ERROR: (unix) connect error: %s\n",
+                         __func__,
+                         strerror(errno));
+                close(client->sock);
+                client->sock = -1;
+                return DLT_RETURN_ERROR;
+            }
+
+            ret = DLT_RETURN_TRUE;
+        }
+
+        break;
+    default:
+        dlt_vlog(LOG_ERR,
+                 "%s: ERROR: Mode not supported: %d\n",
+                 __func__,
+                 client->mode);
+        return DLT_RETURN_ERROR;
+    }
+
+    return ret;
+}
+
+DltReturnValue dlt_client_connect(DltClient *client, int verbose)
+{
+    const int yes = 1;
+    struct ip_mreq mreq;
+    DltReceiverType receiver_type = DLT_RECEIVE_FD;
+
+    if (client == 0)
+        return DLT_RETURN_ERROR;
+
+    /* a new connection starts uncompressed */
+    dlt_client_compression_free(client->compression);
+    client->compression = NULL;
+
+    switch (client->mode) {
+    case DLT_CLIENT_MODE_TCP:
+    case DLT_CLIENT_MODE_UNIX:
+        /* UNIX mode connects in blocking mode */
+        if (dlt_client_connect_socket(client,
+                                      (client->mode == DLT_CLIENT_MODE_TCP) ?
+                                      DLT_CLIENT_CONNECT_TIMEOUT : -1) != DLT_RETURN_OK)
+            return DLT_RETURN_ERROR;
+
+        if (dlt_client_connect_finish(client, verbose) != DLT_RETURN_OK) {
+            close(client->sock);
+            client->sock = -1;
+            return DLT_RETURN_ERROR;
         }
 
         receiver_type = DLT_RECEIVE_SOCKET;
@@ -352,44 +459,6 @@ DltReturnValue dlt_client_connect(DltClient *client, int verbose)
 
         receiver_type = DLT_RECEIVE_FD;
 
-        break;
-    case DLT_CLIENT_MODE_UNIX:
-
-        if ((client->sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
-            dlt_vlog(LOG_ERR,
-                     "%s: ERROR: (unix) socket error: %s\n",
-                     __func__,
-                     strerror(errno));
-
-            return DLT_RETURN_ERROR;
-        }
-
-        memset(&addr, 0, sizeof(addr));
-        addr.sun_family = AF_UNIX;
-        strncpy(addr.sun_path, client->socketPath, sizeof(addr.sun_path) - 1);
-
-        if (connect(client->sock,
-                    (struct sockaddr *) &addr,
-                    sizeof(addr)) == -1) {
-            dlt_vlog(LOG_ERR,
-                     "%s: ERROR: (unix) connect error: %s\n",
-                     __func__,
-                     strerror(errno));
-
-            return DLT_RETURN_ERROR;
-        }
-
-        if (client->sock < 0) {
-            dlt_vlog(LOG_ERR,
-                     "%s: ERROR: Failed to open device %s\n",
-                     __func__,
-                     client->socketPath);
-
-            return DLT_RETURN_ERROR;
-        }
-
-        receiver_type = DLT_RECEIVE_SOCKET;
-
         break;
     case DLT_CLIENT_MODE_UDP_MULTICAST:
 
@@ -490,6 +559,74 @@ DltReturnValue dlt_client_connect(DltClient *client, int verbose)
     return DLT_RETURN_OK;
 }
 
+DltReturnValue dlt_client_connect_start(DltClient *client, int verbose)
+{
+    DltReturnValue ret = DLT_RETURN_OK;
+
+    if (client == NULL)
+        return DLT_RETURN_ERROR;
+
+    ret = dlt_client_connect_socket(client, 0);
+
+    if (ret < DLT_RETURN_OK)
+        return ret;
+
+    if (dlt_receiver_init(&(client->receiver), client->sock, DLT_RECEIVE_SOCKET, DLT_RECEIVE_BUFSIZE) != DLT_RETURN_OK) {
+        dlt_vlog(LOG_ERR, "%s: ERROR initializing receiver\n", __func__);
+        close(client->sock);
+        client->sock = -1;
+        return DLT_RETURN_ERROR;
+    }
+
+    /* a reused receiver buffer must not carry data of a previous connection */
+    client->receiver.bytesRcvd = 0;
+    client->receiver.lastBytesRcvd = 0;
+
+    if (ret == DLT_RETURN_OK)
+        ret = dlt_client_connect_finish(client, verbose);
+
+    return ret;
+}
+
+DltReturnValue dlt_client_connect_finish(DltClient *client, int verbose)
+{
+    int n = 0;
+    socklen_t m = sizeof(n);
+
+    if ((client == NULL) || (client->sock < 0))
+        return DLT_RETURN_ERROR;
+
+    if (getsockopt(client->sock, SOL_SOCKET, SO_ERROR, (void *)&n, &m) != 0)
+        n = errno;
+
+    if (n != 0) {
+        dlt_vlog(LOG_DEBUG,
+                 "%s: failed to connect: %s\n",
+                 __func__,
+                 strerror(n));
+        return DLT_RETURN_ERROR;
+    }
+
+    /* the connection is used in blocking mode from now on */
+    if (fcntl(client->sock, F_SETFL,
+              fcntl(client->sock, F_GETFL, 0) & ~O_NONBLOCK) < 0) {
+        dlt_vlog(LOG_WARNING,
+                 "%s: Socket cannot be changed to BLOCK with err [%s]\n",
+                 __func__,
+                 strerror(errno));
+        return DLT_RETURN_ERROR;
+    }
+
+    if (verbose)
+        dlt_vlog(LOG_INFO,
+                 "%s: Connected to DLT daemon (%s)\n",
+                 __func__,
+                 (client->mode == DLT_CLIENT_MODE_TCP) ?
+                 client->servIP : client->socketPath);
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_client_cleanup(DltClient *client, int verbose)
 {
     int ret = DLT_RETURN_OK;
@@ -532,24 +669,144 @@ DltReturnValue dlt_client_cleanup(DltClient *client, int verbose)
         free(client->ecuid2);
         client->ecuid2 = NULL;
     }
+
+    dlt_client_compression_free(client->compression);
+    client->compression = NULL;
+
     return ret;
 }
 
+/* Fill the receive buffer with decompressed data, like dlt_receiver_receive().
+ * Returns 0 if the connection is closed and -1 on a corrupted stream or if the
+ * pending message does not fit into the receive buffer. */
+static int dlt_client_receive_compressed(DltClient *client)
+{
+    DltReceiver *receiver = &(client->receiver);
+    struct DltClientCompression *compression = client->compression;
+    size_t consumed = 0;
+    size_t produced = 0;
+    ssize_t bytes;
+
+    receiver->buf = receiver->buffer;
+    receiver->lastBytesRcvd = receiver->bytesRcvd;
+
+    if ((receiver->lastBytesRcvd) && (receiver->backup_buf != NULL)) {
+        memcpy(receiver->buf, receiver->backup_buf, (size_t)receiver->lastBytesRcvd);
+        free(receiver->backup_buf);
+        receiver->backup_buf = NULL;
+    }
+
+    if (receiver->lastBytesRcvd >= receiver->buffersize) {
+        /* nothing can be decompressed, the caller would wait forever */
+        dlt_vlog(LOG_ERR, "%s: Receive buffer is full\n", __func__);
+        return -1;
+    }
+
+    /* a flush point may be split across several TCP segments */
+    while (produced == 0) {
+        if (compression->in_size == 0) {
+            bytes = recv(receiver->fd, compression->in, (size_t)receiver->buffersize, 0);
+
+            if (bytes <= 0)
+                break;
+
+            compression->in_offset = 0;
+            compression->in_size = (size_t)bytes;
+        }
+
+        if (dlt_compression_process(compression->stream,
+                                    compression->in + compression->in_offset,
+                                    compression->in_size,
+                                    receiver->buf + receiver->lastBytesRcvd,
+                                    (size_t)(receiver->buffersize - receiver->lastBytesRcvd),
+                                    &consumed,
+                                    &produced,
+                                    false) != DLT_RETURN_OK) {
+            dlt_vlog(LOG_ERR, "%s: Compressed stream is corrupted\n", __func__);
+            return -1;
+        }
+
+        compression->in_offset += consumed;
+        compression->in_size -= consumed;
+    }
+
+    if (produced == 0) {
+        receiver->bytesRcvd = 0;
+        return receiver->bytesRcvd;
+    }
+
+    receiver->totalBytesRcvd += (int32_t)produced;
+    receiver->bytesRcvd = receiver->lastBytesRcvd + (int32_t)produced;
+
+    return receiver->bytesRcvd;
+}
+
+static int dlt_client_receive(DltClient *client)
+{
+    if (client->compression != NULL)
+        return dlt_client_receive_compressed(client);
+
+    return dlt_receiver_receive(&(client->receiver));
+}
+
+static DltReturnValue dlt_client_main_loop_view(DltClient *client, void *data, int verbose)
+{
+    DltMessageView view;
+    int ret;
+
+    bool fetch_next_message = true;
+    while (fetch_next_message) {
+        /* wait for data from socket or serial connection */
+        ret = dlt_client_receive(client);
+
+        if (ret <= 0)
+            /* No more data to be received */
+            return DLT_RETURN_TRUE;
+
+        /* messages are handed out in place, nothing is copied out of the receiver buffer */
+        while (dlt_message_view_read(&view, (const uint8_t *)(client->receiver.buf),
+                                     (unsigned int)client->receiver.bytesRcvd,
+                                     client->resync_serial_header,
+                                     verbose) == DLT_MESSAGE_ERROR_OK)
+        {
+            /* Call callback function */
+            (*message_view_callback_function)(&view, data);
+
+            if (dlt_receiver_remove(&(client->receiver),
+                                    (int)dlt_message_view_get_consumed_size(&view)) == DLT_RETURN_ERROR)
+                return DLT_RETURN_ERROR;
+        }
+
+        if (dlt_receiver_move_to_begin(&(client->receiver)) == DLT_RETURN_ERROR)
+            return DLT_RETURN_ERROR;
+
+        if (fetch_next_message_callback_function)
+          fetch_next_message = (*fetch_next_message_callback_function)(data);
+    }
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_client_main_loop(DltClient *client, void *data, int verbose)
 {
     DltMessage msg;
+    DltMessageView view;
     int ret;
 
     if (client == 0)
         return DLT_RETURN_ERROR;
 
+    /* without a DltMessage consumer there is no need to copy messages out of the receiver */
+    if (message_view_callback_function && !message_callback_function)
+        return dlt_client_main_loop_view(client, data, verbose);
+
     if (dlt_message_init(&msg, verbose) == DLT_RETURN_ERROR)
         return DLT_RETURN_ERROR;
 
     bool fetch_next_message = true;
     while (fetch_next_message) {
         /* wait for data from socket or serial connection */
-        ret = dlt_receiver_receive(&(client->receiver));
+        ret = dlt_client_receive(client);
 
         if (ret <= 0) {
             /* No more data to be received */
@@ -568,6 +825,13 @@ DltReturnValue dlt_client_main_loop(DltClient *client, void *data, int verbose)
             if (message_callback_function)
                 (*message_callback_function)(&msg, data);
 
+            if (message_view_callback_function &&
+                (dlt_message_view_read(&view, (const uint8_t *)(client->receiver.buf),
+                                       (unsigned int)client->receiver.bytesRcvd,
+                                       client->resync_serial_header,
+                                       verbose) == DLT_MESSAGE_ERROR_OK))
+                (*message_view_callback_function)(&view, data);
+
             int total_size = (int)((size_t)msg.headersize
                             + (size_t)msg.datasize
                             - sizeof(DltStorageHeader));
@@ -612,7 +876,7 @@ DltReturnValue dlt_client_main_loop_v2(DltClient *client, void *data, int verbos
     while (fetch_next_message) {
 
         /* wait for data from socket or serial connection */
-        ret = dlt_receiver_receive(&(client->receiver));
+        ret = dlt_client_receive(client);
 
         if (ret <= 0) {
             /* No more data to be received */
@@ -1796,6 +2060,137 @@ DltReturnValue dlt_client_send_all_trace_status_v2(DltClient *client, uint8_t tr
     return DLT_RETURN_OK;
 }
 
+DltReturnValue dlt_client_send_filter(DltClient *client, DltFilter *filter)
+{
+    DltServiceSetClientFilter *req;
+    DltServiceClientFilterEntry *entry;
+    size_t size;
+    int num;
+
+    if ((client == NULL) || (filter == NULL) || (filter->counter < 0) || (filter->counter > DLT_FILTER_MAX)) {
+        dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
+        return DLT_RETURN_ERROR;
+    }
+
+    size = sizeof(DltServiceSetClientFilter) + (size_t)filter->counter * sizeof(DltServiceClientFilterEntry);
+    req = calloc(1, size);
+
+    if (req == 0) {
+        dlt_vlog(LOG_ERR, "%s: Could not allocate memory %zu\n", __func__, size);
+        return DLT_RETURN_ERROR;
+    }
+
+    req->service_id = DLT_SERVICE_ID_SET_CLIENT_FILTER;
+    req->count = (uint16_t)filter->counter;
+    entry = (DltServiceClientFilterEntry *)(req + 1);
+
+    for (num = 0; num < filter->counter; num++, entry++) {
+        memcpy(entry->apid, filter->apid[num], DLT_ID_SIZE);
+        memcpy(entry->ctid, filter->ctid[num], DLT_ID_SIZE);
+        entry->log_level = (uint8_t)filter->log_level[num];
+        entry->payload_min = filter->payload_min[num];
+        entry->payload_max = filter->payload_max[num];
+    }
+
+    if (dlt_client_send_ctrl_msg(client, "APP", "CON", (uint8_t *)req, (uint32_t)size) == -1) {
+        free(req);
+        return DLT_RETURN_ERROR;
+    }
+
+    free(req);
+
+    return DLT_RETURN_OK;
+}
+
+DltReturnValue dlt_client_set_compression(DltClient *client, uint8_t method)
+{
+    DltServiceSetClientCompression req;
+    struct DltClientCompression *compression;
+    DltMessage msg;
+    struct pollfd pfd;
+    uint32_t id_tmp = 0;
+    int offset = 0;
+    int status = -1;
+
+    if ((client == NULL) || (client->sock < 0) || (client->mode != DLT_CLIENT_MODE_TCP) ||
+        (client->compression != NULL) || (client->receiver.buffer == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: Invalid parameters\n", __func__);
+        return DLT_RETURN_ERROR;
+    }
+
+    compression = calloc(1, sizeof(struct DltClientCompression));
+
+    if (compression != NULL) {
+        compression->stream = dlt_compression_create(method, false);
+        compression->in = malloc((size_t)client->receiver.buffersize);
+    }
+
+    if ((compression == NULL) || (compression->stream == NULL) || (compression->in == NULL)) {
+        dlt_vlog(LOG_ERR, "%s: Compression method %u is not supported\n", __func__, method);
+        dlt_client_compression_free(compression);
+        return DLT_RETURN_ERROR;
+    }
+
+    req.service_id = DLT_SERVICE_ID_SET_CLIENT_COMPRESSION;
+    req.method = method;
+
+    if ((dlt_client_send_ctrl_msg(client, "APP", "CON", (uint8_t *)&req, sizeof(req)) == DLT_RETURN_ERROR) ||
+        (dlt_message_init(&msg, 0) == DLT_RETURN_ERROR)) {
+        dlt_client_compression_free(compression);
+        return DLT_RETURN_ERROR;
+    }
+
+    pfd.fd = client->receiver.fd;
+    pfd.events = POLLIN;
+
+    /* messages before the response are left for the main loop */
+    while (status == -1) {
+        if (dlt_message_read(&msg, (unsigned char *)(client->receiver.buf + offset),
+                             (unsigned int)(client->receiver.bytesRcvd - offset),
+                             client->resync_serial_header, 0) == DLT_MESSAGE_ERROR_OK) {
+            offset += msg.resync_offset + (int)((size_t)msg.headersize + (size_t)msg.datasize -
+                                                sizeof(DltStorageHeader));
+
+            if (msg.found_serialheader)
+                offset += (int)sizeof(dltSerialHeader);
+
+            if (DLT_MSG_IS_CONTROL_RESPONSE(&msg) && (msg.datasize >= (int32_t)sizeof(DltServiceResponse))) {
+                memcpy(&id_tmp, msg.databuffer, sizeof(uint32_t));
+
+                if (DLT_ENDIAN_GET_32(msg.standardheader->htyp, id_tmp) == DLT_SERVICE_ID_SET_CLIENT_COMPRESSION)
+                    status = ((DltServiceResponse *)msg.databuffer)->status;
+            }
+
+            continue;
+        }
+
+        if ((poll(&pfd, 1, DLT_CLIENT_COMPRESSION_TIMEOUT) <= 0) ||
+            (dlt_receiver_move_to_begin(&(client->receiver)) != DLT_RETURN_OK) ||
+            (dlt_receiver_receive(&(client->receiver)) <= 0)) {
+            dlt_vlog(LOG_ERR, "%s: No response from the daemon\n", __func__);
+            break;
+        }
+    }
+
+    dlt_message_free(&msg, 0);
+
+    if (status != DLT_SERVICE_RESPONSE_OK) {
+        if (status != -1)
+            dlt_vlog(LOG_WARNING, "%s: Compression rejected by the daemon (%d)\n", __func__, status);
+
+        dlt_client_compression_free(compression);
+        return DLT_RETURN_ERROR;
+    }
+
+    /* the daemon compresses everything after the response */
+    compression->in_size = (size_t)(client->receiver.bytesRcvd - offset);
+    memcpy(compression->in, client->receiver.buf + offset, compression->in_size);
+    client->receiver.bytesRcvd = offset;
+    client->compression = compression;
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_client_send_timing_pakets(DltClient *client, uint8_t timingPakets)
 {
     DltServiceSetVerboseMode *req;
@@ -90,6 +90,9 @@
 /* Name of environment variable for specifying the daemon port */
 #define DLT_CLIENT_ENV_DAEMON_TCP_PORT "DLT_DAEMON_TCP_PORT"
 
+/* Time in ms to wait for the response to a compression request */
+#define DLT_CLIENT_COMPRESSION_TIMEOUT 5000
+
 /************************/
 /* Don't change please! */
 /************************/
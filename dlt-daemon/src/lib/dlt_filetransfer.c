@@ -53,7 +53,12 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "dlt_filetransfer.h"
 #include "dlt_common.h"
 #include "dlt_user_macros.h"
@@ -67,6 +72,15 @@
 
 #define DLT_FILETRANSFER_TRANSFER_ALL_PACKAGES INT_MAX
 
+/*!Free space of the user buffer (percent) required before a package of a mapped file is logged */
+#define USER_BUFFER_FREE_PERCENT 50
+
+/*!Maximum time in ms to wait for user buffer space before checking for cancellation */
+#define USER_BUFFER_WAIT_MAX 500
+
+/*!Number of USER_BUFFER_WAIT_MAX periods a package may wait for user buffer space before the transfer is given up */
+#define USER_BUFFER_WAIT_RETRIES 20
+
 #define NANOSEC_PER_MILLISEC 1000000
 #define NANOSEC_PER_SEC 1000000000
 
@@ -733,6 +747,294 @@ int dlt_user_log_file_data_cancelable(DltContext *fileContext,
         return DLT_FILETRANSFER_ERROR_FILE_DATA;
     }
 }
+/*!Log one package of file data, straight from the given memory */
+/**
+ * @return DLT_RETURN_OK if the package was logged or the log level is disabled, a value < 0 otherwise
+ */
+static DltReturnValue dlt_user_log_file_package(DltContext *fileContext,
+                                                uint32_t fserial,
+                                                int pkgNumber,
+                                                unsigned char *data,
+                                                uint16_t length)
+{
+    DltContextData log;
+    DltReturnValue ret;
+
+    ret = dlt_user_log_write_start(fileContext, &log, DLT_LOG_INFO);
+
+    if (ret != DLT_RETURN_TRUE)
+        return (ret < DLT_RETURN_OK) ? ret : DLT_RETURN_OK;
+
+    dlt_user_log_write_string(&log, "FLDA");
+    dlt_user_log_write_uint(&log, fserial);
+    dlt_user_log_write_uint(&log, (unsigned int)pkgNumber);
+    dlt_user_log_write_raw(&log, data, length);
+    dlt_user_log_write_string(&log, "FLDA");
+
+    return dlt_user_log_write_finish(&log);
+}
+
+/* Reset the cursor if it belongs to another file or version of the file */
+static void dlt_user_log_file_cursor_check(DltFileTransferCursor *cursor, uint32_t fserial)
+{
+    if (cursor->serial != fserial) {
+        cursor->serial = fserial;
+        cursor->package = 0;
+    }
+}
+
+/*!Transfer the content data of a file from a memory mapping */
+/**See the Mainpages.c for more informations.
+ * The file is mapped once and every package is logged directly from the mapping,
+ * instead of opening and seeking the file for each package. Before each package the
+ * function sleeps until at least half of the user buffer is free, a package which
+ * could not be buffered is retried. The transfer is given up if a package cannot be
+ * buffered within USER_BUFFER_WAIT_RETRIES * USER_BUFFER_WAIT_MAX ms, or if the file
+ * is truncated while it is transferred; the cursor allows to resume it later.
+ * @param fileContext Specific context to log the file to dlt
+ * @param filename Absolute file path
+ * @param cursor Resume cursor, may be NULL. Packages up to cursor->package are skipped if the cursor
+ *        belongs to the same file; it is updated after every package, so an interrupted transfer
+ *        can be continued by calling this function again with the same cursor.
+ * @param timeout Timeout in ms to wait between dlt logs, 0 to rely on the buffer space only.
+ * @param fileCancelTransferFlag is a bool pointer to cancel the filetransfer on demand, may be NULL. It is read atomically.
+ * @return Returns 0 if everything was okey. If there was a failure value < 0 will be returned.
+ */
+int dlt_user_log_file_data_mmap(DltContext *fileContext,
+                                const char *filename,
+                                DltFileTransferCursor *cursor,
+                                int timeout,
+                                bool *const fileCancelTransferFlag)
+{
+    DltFileTransferCursor local_cursor = { 0, 0 };
+    struct stat st;
+    struct stat current;
+    unsigned char *map = NULL;
+    uint32_t fserial;
+    size_t offset;
+    size_t length;
+    int packages;
+    int pkgNumber;
+    int retries;
+    int ok;
+    int fd;
+    int ret = 0;
+
+    if ((fileContext == NULL) || (filename == NULL))
+        return DLT_FILETRANSFER_ERROR_FILE_DATA;
+
+    if (cursor == NULL)
+        cursor = &local_cursor;
+
+    fserial = getFileSerialNumber(filename, &ok);
+
+    if (1 != ok) {
+        dlt_user_log_file_errorMessage(fileContext, filename, DLT_FILETRANSFER_ERROR_FILE_DATA);
+        return DLT_FILETRANSFER_FILE_SERIAL_NUMBER;
+    }
+
+    dlt_user_log_file_cursor_check(cursor, fserial);
+
+    fd = open(filename, O_RDONLY | O_CLOEXEC);
+
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        if (fd >= 0)
+            close(fd);
+
+        dlt_user_log_file_errorMessage(fileContext, filename, DLT_FILETRANSFER_ERROR_FILE_DATA);
+        return DLT_FILETRANSFER_ERROR_FILE_DATA;
+    }
+
+    if (st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map == MAP_FAILED) {
+            close(fd);
+            dlt_user_log_file_errorMessage(fileContext, filename, DLT_FILETRANSFER_ERROR_FILE_DATA);
+            return DLT_FILETRANSFER_ERROR_FILE_DATA;
+        }
+
+        madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    }
+
+    packages = (int)(((size_t)st.st_size + BUFFER_SIZE - 1) / BUFFER_SIZE);
+
+    for (pkgNumber = cursor->package + 1; pkgNumber <= packages; pkgNumber++) {
+        offset = (size_t)(pkgNumber - 1) * BUFFER_SIZE;
+        length = (size_t)st.st_size - offset;
+
+        if (length > BUFFER_SIZE)
+            length = BUFFER_SIZE;
+
+        /* pages beyond the end of a truncated file must not be touched, they raise SIGBUS */
+        if ((fstat(fd, &current) != 0) || ((size_t)current.st_size < offset + length)) {
+            dlt_user_log_file_errorMessage(fileContext, filename, DLT_FILETRANSFER_ERROR_FILE_DATA);
+            ret = DLT_FILETRANSFER_ERROR_FILE_DATA;
+            break;
+        }
+
+        for (retries = 0;; retries++) {
+            if ((fileCancelTransferFlag != NULL) && __atomic_load_n(fileCancelTransferFlag, __ATOMIC_ACQUIRE)) {
+                DLT_LOG(*fileContext, DLT_LOG_ERROR,
+                        DLT_STRING("FLER"),
+                        DLT_INT(DLT_FILETRANSFER_ERROR_FILE_END_USER_CANCELLED)
+                        );
+                ret = DLT_FILETRANSFER_ERROR_FILE_END_USER_CANCELLED;
+                break;
+            }
+
+            if (retries == USER_BUFFER_WAIT_RETRIES) {
+                DLT_LOG(*fileContext, DLT_LOG_ERROR,
+                        DLT_STRING("FLER"),
+                        DLT_INT(DLT_FILETRANSFER_ERROR_FILE_DATA_USER_BUFFER_FAILED)
+                        );
+                ret = DLT_FILETRANSFER_ERROR_FILE_DATA_USER_BUFFER_FAILED;
+                break;
+            }
+
+            /* sleep until the daemon took enough messages out of the buffer */
+            if (dlt_user_wait_buffer_space(USER_BUFFER_FREE_PERCENT, USER_BUFFER_WAIT_MAX) != DLT_RETURN_OK)
+                continue;
+
+            if (dlt_user_log_file_package(fileContext, fserial, pkgNumber, map + offset,
+                                          (uint16_t)length) != DLT_RETURN_BUFFER_FULL)
+                break;
+        }
+
+        if (ret != 0)
+            break;
+
+        cursor->package = pkgNumber;
+
+        if (timeout > 0)
+            doTimeout(timeout);
+    }
+
+    if (map != NULL)
+        munmap(map, (size_t)st.st_size);
+
+    close(fd);
+    return ret;
+}
+
+/* Parameters of a file transfer running in a thread of its own */
+typedef struct {
+    DltContext *fileContext;
+    char *filename;
+    int deleteFlag;
+    int timeout;
+    DltFileTransferCursor *cursor;
+    bool *fileCancelTransferFlag;
+    DltFileTransferCallback callback;
+    void *userData;
+} DltFileTransferAsync;
+
+static void *dlt_user_log_file_async_thread(void *arg)
+{
+    DltFileTransferAsync *transfer = (DltFileTransferAsync *)arg;
+    uint32_t fserial;
+    int ok;
+    int ret = 0;
+
+    /* a resumed transfer of the same file already sent the header */
+    if (transfer->cursor != NULL) {
+        fserial = getFileSerialNumber(transfer->filename, &ok);
+
+        if (ok == 1)
+            dlt_user_log_file_cursor_check(transfer->cursor, fserial);
+    }
+
+    if ((transfer->cursor == NULL) || (transfer->cursor->package == 0))
+        if (dlt_user_log_file_header(transfer->fileContext, transfer->filename) != 0)
+            ret = DLT_FILETRANSFER_ERROR_FILE_COMPLETE1;
+
+    if ((ret == 0) &&
+        (dlt_user_log_file_data_mmap(transfer->fileContext, transfer->filename, transfer->cursor,
+                                     transfer->timeout, transfer->fileCancelTransferFlag) != 0))
+        ret = DLT_FILETRANSFER_ERROR_FILE_COMPLETE2;
+
+    if ((ret == 0) &&
+        (dlt_user_log_file_end(transfer->fileContext, transfer->filename, transfer->deleteFlag) != 0))
+        ret = DLT_FILETRANSFER_ERROR_FILE_COMPLETE3;
+
+    if (transfer->callback != NULL)
+        transfer->callback(transfer->fileContext, transfer->filename, ret, transfer->userData);
+
+    free(transfer->filename);
+    free(transfer);
+    return NULL;
+}
+
+/*!Transfer the complete file in a thread of its own */
+/**Same as dlt_user_log_file_complete, but the file is transferred from a memory mapping by a detached
+ * thread, and the callback is invoked with the result once the transfer finished, so the caller
+ * does not need to wait for it.
+ * @param fileContext Specific context to log the file to dlt, must stay registered until the callback
+ * @param filename Absolute file path
+ * @param deleteFlag Flag if the file will be deleted after transfer. 1->delete, 0->notDelete
+ * @param timeout Timeout in ms to wait between dlt logs, 0 to rely on the buffer space only.
+ * @param cursor Resume cursor (see dlt_user_log_file_data_mmap), may be NULL. Must stay valid until the callback.
+ * @param fileCancelTransferFlag is a bool pointer to cancel the filetransfer on demand, may be NULL.
+ * @param callback Called from the transfer thread with the result (0 or a value < 0), may be NULL.
+ * @param userData Passed to the callback
+ * @return Returns 0 if the transfer was started. If there was a failure a value < 0 will be returned.
+ */
+int dlt_user_log_file_complete_async(DltContext *fileContext,
+                                     const char *filename,
+                                     int deleteFlag,
+                                     int timeout,
+                                     DltFileTransferCursor *cursor,
+                                     bool *const fileCancelTransferFlag,
+                                     DltFileTransferCallback callback,
+                                     void *userData)
+{
+    DltFileTransferAsync *transfer;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int ret;
+
+    if ((fileContext == NULL) || (filename == NULL))
+        return DLT_FILETRANSFER_ERROR_FILE_COMPLETE;
+
+    if (!isFile(filename)) {
+        dlt_user_log_file_errorMessage(fileContext, filename, DLT_FILETRANSFER_ERROR_FILE_COMPLETE);
+        return DLT_FILETRANSFER_ERROR_FILE_COMPLETE;
+    }
+
+    transfer = calloc(1, sizeof(DltFileTransferAsync));
+
+    if (transfer == NULL)
+        return DLT_FILETRANSFER_ERROR_FILE_COMPLETE;
+
+    transfer->filename = strdup(filename);
+
+    if (transfer->filename == NULL) {
+        free(transfer);
+        return DLT_FILETRANSFER_ERROR_FILE_COMPLETE;
+    }
+
+    transfer->fileContext = fileContext;
+    transfer->deleteFlag = deleteFlag;
+    transfer->timeout = timeout;
+    transfer->cursor = cursor;
+    transfer->fileCancelTransferFlag = fileCancelTransferFlag;
+    transfer->callback = callback;
+    transfer->userData = userData;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    ret = pthread_create(&thread, &attr, dlt_user_log_file_async_thread, transfer);
+    pthread_attr_destroy(&attr);
+
+    if (ret != 0) {
+        free(transfer->filename);
+        free(transfer);
+        return DLT_FILETRANSFER_ERROR_FILE_COMPLETE;
+    }
+
+    return 0;
+}
+
 /*!Transfer the end of the file as a dlt logs. */
 /**The end of the file must be logged to dlt because the end contains inforamtion about the file serial number.
  * This informations is needed from the plugin of the dlt viewer.
@@ -51,6 +51,14 @@
 #   include <sys/prctl.h> /* for PR_SET_NAME */
 #endif
 
+/* The housekeeper blocks on eventfd/timerfd where available. Android
+ * stops the thread via a pending SIGUSR1, which requires periodic wakeups. */
+#if defined linux && !defined __ANDROID_API__
+#   define DLT_USER_HOUSEKEEPER_EVENTS
+#   include <sys/eventfd.h>
+#   include <sys/timerfd.h>
+#endif
+
 #include <sys/types.h> /* needed for getpid() */
 #include <unistd.h>
 
@@ -133,6 +141,28 @@ static atomic_bool dlt_user_housekeeper_exit_requested = false;
 pthread_mutex_t dlt_housekeeper_running_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t dlt_housekeeper_running_cond;
 
+/* events the housekeeper thread has been woken up for */
+#define DLT_USER_HOUSEKEEPER_RECEIVE  0x01 /* message from daemon or connection state change */
+#define DLT_USER_HOUSEKEEPER_EVENT    0x02 /* messages were stored in the user buffer */
+#define DLT_USER_HOUSEKEEPER_TIMER    0x04 /* reconnect or resend delay elapsed */
+#define DLT_USER_HOUSEKEEPER_ALL      (DLT_USER_HOUSEKEEPER_RECEIVE | \
+                                       DLT_USER_HOUSEKEEPER_EVENT | \
+                                       DLT_USER_HOUSEKEEPER_TIMER)
+
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+static int dlt_housekeeper_event_fd = DLT_FD_INIT;
+static int dlt_housekeeper_timer_fd = DLT_FD_INIT;
+static atomic_bool dlt_housekeeper_wakeup_pending = false;
+static bool dlt_housekeeper_timer_armed = false;
+static uint32_t dlt_housekeeper_backoff = 0; /* current reconnect delay in msec */
+#endif
+
+/* broadcast whenever messages were taken out of the user buffer */
+static pthread_mutex_t dlt_buffer_space_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dlt_buffer_space_cond;
+static pthread_once_t dlt_buffer_space_once = PTHREAD_ONCE_INIT;
+static unsigned int dlt_buffer_space_seq = 0; /* counts the broadcasts, guarded by the mutex */
+
 /* calling dlt_user_atexit_handler() second time fails with error message */
 static int atexit_registered = 0;
 
@@ -236,6 +266,13 @@ static DltReturnValue dlt_user_log_out_error_handling(void *ptr1,
                                                       void *ptr3,
                                                       size_t len3);
 static void dlt_user_cleanup_handler(void *arg);
+static void dlt_user_housekeeper_open(void);
+static void dlt_user_housekeeper_close(void);
+static void dlt_user_housekeeper_wakeup(void);
+static int dlt_user_housekeeper_wait(void);
+static bool dlt_user_housekeeper_retry_scheduled(void);
+static void dlt_user_housekeeper_schedule(int events, bool pending);
+static void dlt_user_buffer_space_signal(void);
 static int dlt_start_threads(void);
 static void dlt_stop_threads(void);
 static void dlt_fork_child_fork_handler(void);
@@ -256,9 +293,31 @@ static int dlt_get_extendedheadersize_v2(DltUser dlt_user_param, int contextIDSi
 /* For trace load control feature */
 static DltReturnValue dlt_user_output_internal_msg(DltLogLevelType loglevel, const char *text, void* params);
 DltContext trace_load_context = {0};
-DltTraceLoadSettings* trace_load_settings = NULL;
-uint32_t trace_load_settings_count = 0;
+/* Serialises the updates of trace_load_table, log calls never take it */
 pthread_rwlock_t trace_load_rw_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* Trace load settings of the application. A table is never modified once
+ * published, an update publishes a new one with a new generation. */
+typedef struct
+{
+    unsigned int generation;
+    uint32_t count;
+    DltTraceLoadSettings settings[];
+} DltTraceLoadTable;
+
+static _Atomic(DltTraceLoadTable *) trace_load_table = NULL;
+
+/* Log calls accounting a message, counted by the parity of the epoch they
+ * started in. A replaced table is freed once both counters drained, see
+ * dlt_user_trace_load_publish(). */
+static atomic_uint trace_load_epoch = 0;
+static atomic_uint trace_load_readers[2];
+
+static DltReturnValue dlt_user_trace_load_update(const DltUserControlMsgTraceSettingMsg *limits, uint32_t count);
+static void dlt_user_trace_load_publish(DltTraceLoadTable *table);
+static DltTraceLoadSettings *dlt_user_trace_load_enter(int pos, const char *apid, const char *ctid,
+                                                       unsigned int *epoch);
+static void dlt_user_trace_load_leave(unsigned int epoch);
 #endif
 
 #include <stdint.h>
@@ -571,25 +630,20 @@ DltReturnValue dlt_init(void)
 
 #endif
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    pthread_rwlock_wrlock(&trace_load_rw_lock);
-
-    trace_load_settings = malloc(sizeof(DltTraceLoadSettings));
-    if (trace_load_settings == NULL) {
-        dlt_vlog(LOG_ERR, "Failed to allocate memory for trace load settings\n");
-        dlt_user_init_state = INIT_DONE;
-        pthread_rwlock_unlock(&trace_load_rw_lock);
-        dlt_free();
-        return DLT_RETURN_ERROR;
+    {
+        DltUserControlMsgTraceSettingMsg default_limits = {
+            .ctid = { 0 },
+            .soft_limit = DLT_TRACE_LOAD_CLIENT_SOFT_LIMIT_DEFAULT,
+            .hard_limit = DLT_TRACE_LOAD_CLIENT_HARD_LIMIT_DEFAULT
+        };
+
+        if (dlt_user_trace_load_update(&default_limits, 1) < DLT_RETURN_OK) {
+            dlt_vlog(LOG_ERR, "Failed to allocate memory for trace load settings\n");
+            dlt_user_init_state = INIT_DONE;
+            dlt_free();
+            return DLT_RETURN_ERROR;
+        }
     }
-    memset(trace_load_settings, 0, sizeof(DltTraceLoadSettings));
-    trace_load_settings[0].soft_limit = DLT_TRACE_LOAD_CLIENT_SOFT_LIMIT_DEFAULT;
-    trace_load_settings[0].hard_limit = DLT_TRACE_LOAD_CLIENT_HARD_LIMIT_DEFAULT;
-    strncpy(trace_load_settings[0].apid, dlt_user.appID, DLT_ID_SIZE);
-    trace_load_settings[0].apid2len = dlt_user.appID2len;
-    strncpy(trace_load_settings[0].apid2, dlt_user.appID2, (dlt_user.appID2len) + 1);
-    trace_load_settings_count = 1;
-
-    pthread_rwlock_unlock(&trace_load_rw_lock);
 
 #endif
 #ifdef DLT_LIB_USE_UNIX_SOCKET_IPC
@@ -1162,10 +1216,20 @@ DltReturnValue dlt_free(void)
         return DLT_RETURN_ERROR;
     }
 
-    dlt_mutex_lock();
-
+    /* Stop the housekeeper before taking the lock: it may wait for the
+     * lock outside of a cancellation point while flushing the buffer. */
     dlt_stop_threads();
 
+#ifdef DLT_TRACE_LOAD_CTRL_ENABLE
+    /* Not under dlt_mutex: a log call may take it while it accounts a
+     * message, and the settings are freed only once all of them are done */
+    pthread_rwlock_wrlock(&trace_load_rw_lock);
+    dlt_user_trace_load_publish(NULL);
+    pthread_rwlock_unlock(&trace_load_rw_lock);
+#endif
+
+    dlt_mutex_lock();
+
     dlt_user_init_state = INIT_UNITIALIZED;
 
 #ifdef DLT_LIB_USE_FIFO_IPC
@@ -1270,6 +1334,9 @@ DltReturnValue dlt_free(void)
 
     dlt_buffer_free_dynamic(&(dlt_user.startup_buffer));
 
+    /* the buffer is gone, nobody waits for space in it any more */
+    dlt_user_buffer_space_signal();
+
     /* Clear and free local stored application information */
     if (dlt_user.application_description != NULL)
         free(dlt_user.application_description);
@@ -1347,13 +1414,6 @@ DltReturnValue dlt_free(void)
     pthread_cond_destroy(&mq_init_condition);
 #endif /* DLT_NETWORK_TRACE_ENABLE */
 
-#ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    if (trace_load_settings != NULL) {
-        free(trace_load_settings);
-        trace_load_settings = NULL;
-    }
-    trace_load_settings_count = 0;
-#endif
     dlt_mutex_unlock();
     pthread_mutex_destroy(&dlt_mutex);
 
@@ -1440,9 +1500,10 @@ DltReturnValue dlt_register_app(const char *apid, const char *description)
     dlt_mutex_unlock();
 
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    pthread_rwlock_wrlock(&trace_load_rw_lock);
-    strncpy(trace_load_settings[0].apid, dlt_user.appID, DLT_ID_SIZE);
-    pthread_rwlock_unlock(&trace_load_rw_lock);
+    /* the settings are looked up by the new appID */
+    if (dlt_user_trace_load_update(NULL, 0) < DLT_RETURN_OK)
+        dlt_vlog(LOG_ERR, "Failed to allocate memory for trace load settings\n");
+
     if (!trace_load_context.contextID[0])
     {
         // Register Special Context ID for output DLT library internal message
@@ -1518,8 +1579,9 @@ DltReturnValue dlt_register_app_v2(const char *apid, const char *description)
     dlt_mutex_unlock();
 
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    strncpy(trace_load_settings[0].apid2, dlt_user.appID2, dlt_user.appID2len);
-    trace_load_settings[0].apid2len = dlt_user.appID2len;
+    /* the version 2 settings are looked up by appID2, resolve them again */
+    if (dlt_user_trace_load_update(NULL, 0) < DLT_RETURN_OK)
+        dlt_vlog(LOG_ERR, "Failed to allocate memory for trace load settings\n");
 #endif
 
     ret = dlt_user_log_send_register_application_v2();
@@ -1785,29 +1847,14 @@ DltReturnValue dlt_register_context_ll_ts_llccb(DltContext *handle,
     log.log_level = loglevel;
     log.trace_status = tracestatus;
 
-    dlt_user.dlt_ll_ts_num_entries++;
-    dlt_mutex_unlock();
-
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    /* Compute runtime trace-load settings under the rwlock,
-     * then publish the pointer while holding the DLT mutex
-     * to avoid races with other threads that may reallocate
-     * the context array. This avoids holding both locks at
-     * the same time.
-     */
-    pthread_rwlock_rdlock(&trace_load_rw_lock);
-    DltTraceLoadSettings *settings = dlt_find_runtime_trace_load_settings(
-                                                      trace_load_settings,
-                                                      trace_load_settings_count,
-                                                      dlt_user.appID,
-                                                      ctx_entry->contextID);
-    pthread_rwlock_unlock(&trace_load_rw_lock);
+    /* Trace load settings are resolved on the first log call */
+    ctx_entry->trace_load_settings = NULL;
+    ctx_entry->trace_load_generation = 0;
+#endif
 
-    dlt_mutex_lock();
-    /* ctx_entry points into dlt_user.dlt_ll_ts which is protected by dlt_mutex */
-    ctx_entry->trace_load_settings = settings;
+    dlt_user.dlt_ll_ts_num_entries++;
     dlt_mutex_unlock();
-#endif
 
     return dlt_user_log_send_register_context(&log);
 }
@@ -2774,6 +2821,30 @@ DltReturnValue dlt_user_log_write_raw_formatted_attr(DltContextData *log, const
     return dlt_user_log_write_raw_internal(log, data, length, type, name, true);
 }
 
+unsigned char *dlt_user_log_write_reserve(DltContextData *log, size_t size, uint16_t args_num)
+{
+    if ((log == NULL) || (log->buffer == NULL))
+        return NULL;
+
+    if (!DLT_USER_INITIALIZED_NOT_FREEING) {
+        dlt_vlog(LOG_WARNING, "%s dlt_user_init_state=%i (expected INIT_DONE), dlt_user_freeing=%i\n", __func__, dlt_user_init_state, dlt_user_freeing);
+        return NULL;
+    }
+
+    /* the caller writes type info, so the block is only valid in verbose messages */
+    if (!is_verbose_mode(dlt_user.verbose_mode, log))
+        return NULL;
+
+    if ((size_t)log->size + size > dlt_user.log_buf_len)
+        return NULL;
+
+    unsigned char *data = log->buffer + log->size;
+    log->size += (int32_t)size;
+    log->args_num += args_num;
+
+    return data;
+}
+
 // Generic implementation for all "simple" types, possibly with attributes
 static DltReturnValue dlt_user_log_write_generic_attr(DltContextData *log, const void *datap, size_t datalen, uint32_t type_info, const VarInfo *varinfo)
 {
@@ -4813,8 +4884,9 @@ static void dlt_user_cleanup_handler(void *arg)
 
 void *dlt_user_housekeeperthread_function(void *ptr)
 {
-    struct timespec ts;
     bool in_loop = true;
+    volatile int events = DLT_USER_HOUSEKEEPER_ALL;
+    volatile bool pending = false;
     int signal_status = 0;
     atomic_bool* dlt_housekeeper_running = (atomic_bool*)ptr;
 
@@ -4858,17 +4930,27 @@ void *dlt_user_housekeeperthread_function(void *ptr)
 
     while (in_loop) {
         /* Check for new messages from DLT daemon */
-        if (!dlt_user.disable_injection_msg)
+        if (!dlt_user.disable_injection_msg && (events & DLT_USER_HOUSEKEEPER_RECEIVE))
             if (dlt_user_log_check_user_message() < DLT_RETURN_OK)
                 /* Critical error */
                 dlt_log(LOG_CRIT, "Housekeeper thread encountered error condition\n");
 
-        /* Reattach to daemon if neccesary */
-        dlt_user_log_reattach_to_daemon();
+        /* Reattach to daemon if neccesary, but not faster than the reconnect backoff */
+        if (events & (DLT_USER_HOUSEKEEPER_RECEIVE | DLT_USER_HOUSEKEEPER_TIMER))
+            dlt_user_log_reattach_to_daemon();
 
         /* flush buffer to DLT daemon if possible */
-        if (dlt_user.dlt_log_handle != DLT_FD_INIT)
-            dlt_user_log_resend_buffer();
+        pending = false;
+
+        if (dlt_user.dlt_log_handle != DLT_FD_INIT) {
+            /* while a flush retry is scheduled, new buffered messages wait for it */
+            if ((events == DLT_USER_HOUSEKEEPER_EVENT) && dlt_user_housekeeper_retry_scheduled())
+                pending = true;
+            else
+                pending = (dlt_user_log_resend_buffer() != DLT_RETURN_OK);
+        }
+
+        dlt_user_housekeeper_schedule(events, pending);
 
 #ifdef __ANDROID_API__
         if (sigpending(&pset)) {
@@ -4882,16 +4964,203 @@ void *dlt_user_housekeeperthread_function(void *ptr)
         }
 #endif
 
-        /* delay */
-        ts.tv_sec = 0;
-        ts.tv_nsec = DLT_USER_RECEIVE_NDELAY;
-        nanosleep(&ts, NULL);
+        events = dlt_user_housekeeper_wait();
     }
 
     pthread_cleanup_pop(1);
     return NULL;
 }
 
+/* Create the descriptors the housekeeper thread blocks on */
+static void dlt_user_housekeeper_open(void)
+{
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    dlt_housekeeper_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (dlt_housekeeper_event_fd < 0)
+        dlt_vlog(LOG_WARNING, "%s: eventfd failed: %s\n", __func__, strerror(errno));
+
+    dlt_housekeeper_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (dlt_housekeeper_timer_fd < 0)
+        dlt_vlog(LOG_WARNING, "%s: timerfd_create failed: %s\n", __func__, strerror(errno));
+
+    atomic_store(&dlt_housekeeper_wakeup_pending, false);
+    dlt_housekeeper_timer_armed = false;
+    dlt_housekeeper_backoff = 0;
+#endif
+}
+
+static void dlt_user_housekeeper_close(void)
+{
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    if (dlt_housekeeper_event_fd >= 0)
+        close(dlt_housekeeper_event_fd);
+
+    if (dlt_housekeeper_timer_fd >= 0)
+        close(dlt_housekeeper_timer_fd);
+
+    dlt_housekeeper_event_fd = DLT_FD_INIT;
+    dlt_housekeeper_timer_fd = DLT_FD_INIT;
+#endif
+}
+
+/* Wake up the housekeeper thread to flush the user buffer */
+static void dlt_user_housekeeper_wakeup(void)
+{
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    uint64_t value = 1;
+
+    /* while detached the reconnect timer takes care of the buffer */
+    if ((dlt_housekeeper_event_fd < 0) || (dlt_user.dlt_log_handle == DLT_FD_INIT))
+        return;
+
+    /* one pending wakeup is enough, avoid a syscall per buffered message */
+    if (atomic_exchange(&dlt_housekeeper_wakeup_pending, true))
+        return;
+
+    if (write(dlt_housekeeper_event_fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+        atomic_store(&dlt_housekeeper_wakeup_pending, false);
+#endif
+}
+
+/**
+ * Block until the housekeeper has something to do.
+ * Without eventfd/timerfd support the thread falls back to waking up
+ * periodically and handling everything.
+ * @return mask of DLT_USER_HOUSEKEEPER_* events
+ */
+static int dlt_user_housekeeper_wait(void)
+{
+    struct timespec ts;
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    struct pollfd pfd[3];
+    uint64_t value = 0;
+    int events = 0;
+
+    if ((dlt_housekeeper_event_fd >= 0) && (dlt_housekeeper_timer_fd >= 0)) {
+        /* negative descriptors are ignored by poll */
+        pfd[0].fd = DLT_FD_INIT;
+        pfd[0].events = POLLIN;
+
+        if (!dlt_user.disable_injection_msg)
+#if defined DLT_LIB_USE_UNIX_SOCKET_IPC || defined DLT_LIB_USE_VSOCK_IPC
+            pfd[0].fd = dlt_user.dlt_log_handle;
+#else /* DLT_LIB_USE_FIFO_IPC */
+            pfd[0].fd = dlt_user.dlt_user_handle;
+#endif
+
+        pfd[1].fd = dlt_housekeeper_event_fd;
+        pfd[1].events = POLLIN;
+        pfd[2].fd = dlt_housekeeper_timer_fd;
+        pfd[2].events = POLLIN;
+
+        if (poll(pfd, 3, -1) < 0) {
+            if (errno != EINTR)
+                dlt_vlog(LOG_ERR, "%s: poll failed: %s\n", __func__, strerror(errno));
+
+            return DLT_USER_HOUSEKEEPER_TIMER;
+        }
+
+        if (pfd[0].revents)
+            events |= DLT_USER_HOUSEKEEPER_RECEIVE;
+
+        if (pfd[1].revents & POLLIN) {
+            atomic_store(&dlt_housekeeper_wakeup_pending, false);
+
+            if (read(dlt_housekeeper_event_fd, &value, sizeof(value)) < 0)
+                dlt_vlog(LOG_DEBUG, "%s: eventfd read: %s\n", __func__, strerror(errno));
+
+            events |= DLT_USER_HOUSEKEEPER_EVENT;
+        }
+
+        if (pfd[2].revents & POLLIN) {
+            if (read(dlt_housekeeper_timer_fd, &value, sizeof(value)) < 0)
+                dlt_vlog(LOG_DEBUG, "%s: timerfd read: %s\n", __func__, strerror(errno));
+
+            events |= DLT_USER_HOUSEKEEPER_TIMER;
+        }
+
+        return events;
+    }
+#endif
+
+    /* delay */
+    ts.tv_sec = 0;
+    ts.tv_nsec = DLT_USER_RECEIVE_NDELAY;
+    nanosleep(&ts, NULL);
+
+    return DLT_USER_HOUSEKEEPER_ALL;
+}
+
+static bool dlt_user_housekeeper_retry_scheduled(void)
+{
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    return dlt_housekeeper_timer_armed;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Arm the housekeeper timer for the next reconnect attempt or for retrying
+ * to flush the user buffer. Reconnect attempts back off exponentially up to
+ * DLT_USER_RECONNECT_MAX_MDELAY; while attached and idle the timer stays off.
+ * @param events events handled in the current loop iteration
+ * @param pending true if messages are left in the user buffer
+ */
+static void dlt_user_housekeeper_schedule(int events, bool pending)
+{
+#ifdef DLT_USER_HOUSEKEEPER_EVENTS
+    struct itimerspec spec;
+    uint32_t delay = 0;
+
+    if (dlt_housekeeper_timer_fd < 0)
+        return;
+
+    if (events & DLT_USER_HOUSEKEEPER_TIMER)
+        dlt_housekeeper_timer_armed = false;
+
+    if (dlt_user.dlt_log_handle == DLT_FD_INIT) {
+        /* keep a pending reconnect attempt */
+        if (dlt_housekeeper_timer_armed)
+            return;
+
+        if (dlt_housekeeper_backoff == 0)
+            dlt_housekeeper_backoff = DLT_USER_RECONNECT_MIN_MDELAY;
+        else if (dlt_housekeeper_backoff < DLT_USER_RECONNECT_MAX_MDELAY / 2)
+            dlt_housekeeper_backoff *= 2;
+        else
+            dlt_housekeeper_backoff = DLT_USER_RECONNECT_MAX_MDELAY;
+
+        delay = dlt_housekeeper_backoff;
+    }
+    else {
+        dlt_housekeeper_backoff = 0;
+
+        /* retry flushing later, unless a retry is already pending */
+        if (pending && !dlt_housekeeper_timer_armed)
+            delay = DLT_USER_RECEIVE_MDELAY;
+        else if (pending || !dlt_housekeeper_timer_armed)
+            return;
+    }
+
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = delay / 1000;
+    spec.it_value.tv_nsec = (long)(delay % 1000) * 1000000L;
+
+    if (timerfd_settime(dlt_housekeeper_timer_fd, 0, &spec, NULL) < 0) {
+        dlt_vlog(LOG_WARNING, "%s: timerfd_settime failed: %s\n", __func__, strerror(errno));
+        return;
+    }
+
+    dlt_housekeeper_timer_armed = (delay != 0);
+#else
+    (void)events;
+    (void)pending;
+#endif
+}
+
 /* Private functions of user library */
 
 DltReturnValue dlt_user_log_init(DltContext *handle, DltContextData *log)
@@ -5181,7 +5450,7 @@ DltReturnValue dlt_user_log_send_log(DltContextData *log, const int mtype, int *
                 char ctxid[DLT_ID_SIZE];
                 memcpy(ctxid, log->handle->contextID, DLT_ID_SIZE);
 
-                if ((uint32_t)pos > dlt_user.dlt_ll_ts_num_entries) {
+                if ((pos < 0) || ((uint32_t)pos >= dlt_user.dlt_ll_ts_num_entries)) {
                     char msg_buffer[255];
                     sprintf(msg_buffer, "log handle has invalid log level pos %d, current entries: %u, dropping message\n",
                         log->handle->log_level_pos, dlt_user.dlt_ll_ts_num_entries);
@@ -5189,21 +5458,12 @@ DltReturnValue dlt_user_log_send_log(DltContextData *log, const int mtype, int *
                     dlt_user_output_internal_msg(LOG_ERR, msg_buffer, NULL);
                     return DLT_RETURN_ERROR;
                 }
-                dlt_mutex_unlock();
-
-                pthread_rwlock_rdlock(&trace_load_rw_lock);
-                DltTraceLoadSettings *computed_settings = dlt_find_runtime_trace_load_settings(
-                    trace_load_settings, trace_load_settings_count, dlt_user.appID, ctxid);
-                pthread_rwlock_unlock(&trace_load_rw_lock);
 
-                dlt_mutex_lock();
-                if ((uint32_t)pos < dlt_user.dlt_ll_ts_num_entries) {
-                    dlt_ll_ts_type* ll_ts = &dlt_user.dlt_ll_ts[pos];
-                    if (ll_ts->trace_load_settings == NULL) {
-                        ll_ts->trace_load_settings = computed_settings;
-                    }
-                }
+                unsigned int epoch;
+                DltTraceLoadSettings *computed_settings = dlt_user_trace_load_enter(pos, dlt_user.appID, ctxid,
+                                                                                    &epoch);
                 dlt_mutex_unlock();
+
                 size_t trace_load_size = (size_t)sizeof(DltUserHeader)
                                         + (size_t)msg.headersize
                                         - (size_t)sizeof(DltStorageHeader)
@@ -5217,6 +5477,7 @@ DltReturnValue dlt_user_log_send_log(DltContextData *log, const int mtype, int *
                                                     trace_load_size_i32,
                                                     dlt_user_output_internal_msg,
                                                     NULL);
+                dlt_user_trace_load_leave(epoch);
 
                 if (!trace_load_in_limits){
                     return DLT_RETURN_LOAD_EXCEEDED;
@@ -5491,11 +5752,10 @@ DltReturnValue dlt_user_log_send_log_v2(DltContextData *log, const int mtype, Dl
         msg.headerextrav2.msid = log->msid;
     }
 
-/* TODO:
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
-    time_stamp = msg.headerextra.tmsp;
+    /* the version 2 header carries no uptime, account the load in uptime slots like version 1 */
+    time_stamp = dlt_uptime();
 #endif
-*/
 
     if (dlt_message_set_extraparameters_v2(&msg, 0) != DLT_RETURN_OK)
         return DLT_RETURN_ERROR;
@@ -5689,26 +5949,37 @@ DltReturnValue dlt_user_log_send_log_v2(DltContextData *log, const int mtype, Dl
             /* check trace load before output */
             if (!sent_size)
             {
-                pthread_rwlock_wrlock(&trace_load_rw_lock);
+                int pos = log->handle->log_level_pos;
+
+                dlt_mutex_lock();
+                if ((pos < 0) || ((uint32_t)pos >= dlt_user.dlt_ll_ts_num_entries)) {
+                    dlt_mutex_unlock();
+                    dlt_user_output_internal_msg(LOG_ERR, "log handle has invalid log level pos, dropping message\n", NULL);
+                    return DLT_RETURN_ERROR;
+                }
+
+                unsigned int epoch;
                 DltTraceLoadSettings* settings =
-                    dlt_find_runtime_trace_load_settings(
-                        trace_load_settings, trace_load_settings_count, dlt_user.appID2, log->handle->contextID2);
+                    dlt_user_trace_load_enter(pos, dlt_user.appID2, log->handle->contextID2, &epoch);
+                dlt_mutex_unlock();
+
                 const bool trace_load_in_limits = dlt_check_trace_load(
                         settings,
                         log->log_level, time_stamp,
-                        sizeof(DltUserHeader)
-                            + msg.headersizev2 - msg.storageheadersizev2
-                            + log->size,
+                        safe_size_to_int32(sizeof(DltUserHeader)
+                            + (size_t)msg.headersizev2 - (size_t)msg.storageheadersizev2
+                            + (size_t)log->size),
                         dlt_user_output_internal_msg,
                         NULL);
-                pthread_rwlock_unlock(&trace_load_rw_lock);
+                dlt_user_trace_load_leave(epoch);
                 if (!trace_load_in_limits){
                     return DLT_RETURN_LOAD_EXCEEDED;
                 }
             }
             else
             {
-                *sent_size = (sizeof(DltUserHeader) + msg.headersizev2 - msg.storageheadersizev2 + log->size);
+                *sent_size = safe_size_to_int32(sizeof(DltUserHeader) + (size_t)msg.headersizev2
+                                                - (size_t)msg.storageheadersizev2 + (size_t)log->size);
             }
 #endif
 
@@ -5819,6 +6090,9 @@ DltReturnValue dlt_user_log_send_register_application(void)
 {
     DltUserHeader userheader;
     DltUserControlMsgRegisterApplication usercontext;
+    uint32_t flags = DLT_USER_APP_FLAG_LOG_LEVEL_BATCH;
+    size_t desc_len = 0;
+    char *description;
 
     DltReturnValue ret;
 
@@ -5834,28 +6108,43 @@ DltReturnValue dlt_user_log_send_register_application(void)
     usercontext.pid = getpid();
 
     if (dlt_user.application_description != NULL)
-        usercontext.description_length = (uint32_t) strlen(dlt_user.application_description);
-    else
-        usercontext.description_length = 0;
+        desc_len = strlen(dlt_user.application_description);
 
     if (dlt_user.dlt_is_file)
         return DLT_RETURN_OK;
 
+    /* the flags follow the terminated description, older daemons only read the description */
+    usercontext.description_length = (uint32_t) (desc_len + 1 + sizeof(flags));
+    description = malloc(usercontext.description_length);
+
+    if (description == NULL)
+        return DLT_RETURN_ERROR;
+
+    if (desc_len > 0)
+        memcpy(description, dlt_user.application_description, desc_len);
+
+    description[desc_len] = '\0';
+    memcpy(description + desc_len + 1, &flags, sizeof(flags));
+
     ret = dlt_user_log_out3(dlt_user.dlt_log_handle,
                             &(userheader), sizeof(DltUserHeader),
                             &(usercontext), sizeof(DltUserControlMsgRegisterApplication),
-                            dlt_user.application_description, usercontext.description_length);
+                            description, usercontext.description_length);
 
     /* store message in ringbuffer, if an error has occured */
     if (ret < DLT_RETURN_OK)
-        return dlt_user_log_out_error_handling(&(userheader),
-                                               sizeof(DltUserHeader),
-                                               &(usercontext),
-                                               sizeof(DltUserControlMsgRegisterApplication),
-                                               dlt_user.application_description,
-                                               usercontext.description_length);
+        ret = dlt_user_log_out_error_handling(&(userheader),
+                                              sizeof(DltUserHeader),
+                                              &(usercontext),
+                                              sizeof(DltUserControlMsgRegisterApplication),
+                                              description,
+                                              usercontext.description_length);
+    else
+        ret = DLT_RETURN_OK;
 
-    return DLT_RETURN_OK;
+    free(description);
+
+    return ret;
 }
 
 DltReturnValue dlt_user_log_send_register_application_v2(void)
@@ -6561,6 +6850,71 @@ int dlt_get_extendedheadersize_v2(DltUser dlt_user_param, int contextIDSize) {
     return size;
 }
 
+/* Update log level and trace status of a context, the callback is called outside of semaphore */
+static void dlt_user_log_level_update(const DltUserControlMsgLogLevel *usercontextll, int version)
+{
+    DltUserLogLevelChangedCallback delayed_log_level_changed_callback;
+
+    delayed_log_level_changed_callback.log_level_changed_callback = 0;
+    delayed_log_level_changed_callback.log_level_changed_callback_v2 = 0;
+
+    dlt_mutex_lock();
+
+    if ((usercontextll->log_level_pos >= 0) &&
+        (usercontextll->log_level_pos < (int32_t)dlt_user.dlt_ll_ts_num_entries)) {
+        if (dlt_user.dlt_ll_ts) {
+            dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level = (int8_t) usercontextll->log_level;
+            dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status =
+                (int8_t) usercontextll->trace_status;
+
+            if (dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_ptr)
+                *(dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_ptr) =
+                    (int8_t) usercontextll->log_level;
+
+            if (dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status_ptr)
+                *(dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status_ptr) =
+                    (int8_t) usercontextll->trace_status;
+
+            if (version == DLTProtocolV1) {
+                delayed_log_level_changed_callback.log_level_changed_callback =
+                    dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_changed_callback;
+
+                dlt_set_id(delayed_log_level_changed_callback.contextID,
+                           dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID);
+
+                delayed_log_level_changed_callback.log_level = (int8_t) usercontextll->log_level;
+                delayed_log_level_changed_callback.trace_status = (int8_t) usercontextll->trace_status;
+            }else if (version == DLTProtocolV2) {
+                delayed_log_level_changed_callback.log_level_changed_callback_v2 =
+                    dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_changed_callback_v2;
+
+                delayed_log_level_changed_callback.contextID2len = dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2len;
+
+                dlt_set_id_v2(delayed_log_level_changed_callback.contextID2,
+                              dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2,
+                              dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2len);
+
+                delayed_log_level_changed_callback.log_level = (int8_t) usercontextll->log_level;
+                delayed_log_level_changed_callback.trace_status = (int8_t) usercontextll->trace_status;
+            }
+        }
+    }
+
+    dlt_mutex_unlock();
+
+    /* call callback outside of semaphore */
+    if (delayed_log_level_changed_callback.log_level_changed_callback != 0)
+        delayed_log_level_changed_callback.log_level_changed_callback(
+            delayed_log_level_changed_callback.contextID,
+            (uint8_t) delayed_log_level_changed_callback.log_level,
+            (uint8_t) delayed_log_level_changed_callback.trace_status);
+    else if (delayed_log_level_changed_callback.log_level_changed_callback_v2 != 0)
+        delayed_log_level_changed_callback.log_level_changed_callback_v2(
+            delayed_log_level_changed_callback.contextID2,
+            (uint8_t) delayed_log_level_changed_callback.log_level,
+            (uint8_t) delayed_log_level_changed_callback.trace_status);
+}
+
 DltReturnValue dlt_user_log_check_user_message(void)
 {
     int offset = 0;
@@ -6576,6 +6930,7 @@ DltReturnValue dlt_user_log_check_user_message(void)
     DltReceiver *receiver = &(dlt_user.receiver);
 
     DltUserControlMsgLogLevel *usercontextll;
+    DltUserControlMsgLogLevelBatch *userbatch;
     DltUserControlMsgInjection *usercontextinj;
     DltUserControlMsgLogState *userlogstate;
     unsigned char *userbuffer;
@@ -6584,12 +6939,10 @@ DltReturnValue dlt_user_log_check_user_message(void)
     DltUserControlMsgTraceSettingMsg *trace_load_settings_user_messages;
     uint32_t trace_load_settings_user_messages_count = 0;
     uint32_t trace_load_settings_user_message_bytes_required = 0;
-    unsigned long trace_load_settings_alloc_size = 0;
 #endif
 
     /* For delayed calling of injection callback, to avoid deadlock */
     DltUserInjectionCallback delayed_injection_callback;
-    DltUserLogLevelChangedCallback delayed_log_level_changed_callback;
     unsigned char *delayed_inject_buffer = 0;
     uint32_t delayed_inject_data_length = 0;
 
@@ -6597,8 +6950,6 @@ DltReturnValue dlt_user_log_check_user_message(void)
     delayed_injection_callback.injection_callback = 0;
     delayed_injection_callback.injection_callback_with_id = 0;
     delayed_injection_callback.service_id = 0;
-    delayed_log_level_changed_callback.log_level_changed_callback = 0;
-    delayed_log_level_changed_callback.log_level_changed_callback_v2 = 0;
     delayed_injection_callback.data = 0;
 
 #if defined DLT_LIB_USE_UNIX_SOCKET_IPC || defined DLT_LIB_USE_VSOCK_IPC
@@ -6664,78 +7015,54 @@ DltReturnValue dlt_user_log_check_user_message(void)
                     usercontextll = (DltUserControlMsgLogLevel *)(receiver->buf + sizeof(DltUserHeader));
 
                     /* Update log level and trace status */
-                    if (usercontextll != NULL) {
-                        dlt_mutex_lock();
-
-                        if ((usercontextll->log_level_pos >= 0) &&
-                            (usercontextll->log_level_pos < (int32_t)dlt_user.dlt_ll_ts_num_entries)) {
-                            if (dlt_user.dlt_ll_ts) {
-                                dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level = (int8_t) usercontextll->log_level;
-                                dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status =
-                                    (int8_t) usercontextll->trace_status;
-
-                                if (dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_ptr)
-                                    *(dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_ptr) =
-                                        (int8_t) usercontextll->log_level;
+                    dlt_user_log_level_update(usercontextll, version);
 
-                                if (dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status_ptr)
-                                    *(dlt_user.dlt_ll_ts[usercontextll->log_level_pos].trace_status_ptr) =
-                                        (int8_t) usercontextll->trace_status;
-
-                                if (version == DLTProtocolV1) {
-                                    delayed_log_level_changed_callback.log_level_changed_callback =
-                                        dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_changed_callback;
-
-                                    dlt_set_id(delayed_log_level_changed_callback.contextID,
-                                               dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID);
+                    /* keep not read data in buffer */
+                    if (dlt_receiver_remove(receiver,
+                                            sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevel)) ==
+                        DLT_RETURN_ERROR)
+                        return DLT_RETURN_ERROR;
+                }
+                break;
+                case DLT_USER_MESSAGE_LOG_LEVEL_BATCH:
+                {
+                    if (receiver->bytesRcvd <
+                        (int32_t) (sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch))) {
+                        leave_while = 1;
+                        break;
+                    }
 
-                                    delayed_log_level_changed_callback.log_level = (int8_t) usercontextll->log_level;
-                                    delayed_log_level_changed_callback.trace_status = (int8_t) usercontextll->trace_status;
-                                }else if (version == DLTProtocolV2) {
-                                    delayed_log_level_changed_callback.log_level_changed_callback_v2 =
-                                        dlt_user.dlt_ll_ts[usercontextll->log_level_pos].log_level_changed_callback_v2;
+                    userbatch = (DltUserControlMsgLogLevelBatch *)(receiver->buf + sizeof(DltUserHeader));
 
-                                    delayed_log_level_changed_callback.contextID2len = dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2len;
+                    if (userbatch->count > DLT_USER_LOG_LEVEL_BATCH_MAX) {
+                        dlt_vlog(LOG_WARNING, "Invalid log level batch of %u contexts\n", userbatch->count);
 
-                                    dlt_set_id_v2(delayed_log_level_changed_callback.contextID2,
-                                                  dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2,
-                                                  dlt_user.dlt_ll_ts[usercontextll->log_level_pos].contextID2len);
+                        if (dlt_receiver_remove(receiver, sizeof(DltUserHeader)) == DLT_RETURN_ERROR)
+                            return DLT_RETURN_ERROR;
 
-                                    delayed_log_level_changed_callback.log_level = (int8_t) usercontextll->log_level;
-                                    delayed_log_level_changed_callback.trace_status = (int8_t) usercontextll->trace_status;
-                                }
-                            }
-                        }
+                        break;
+                    }
 
-                        dlt_mutex_unlock();
+                    if (receiver->bytesRcvd <
+                        (int32_t) (sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch) +
+                                   userbatch->count * sizeof(DltUserControlMsgLogLevel))) {
+                        leave_while = 1;
+                        break;
                     }
 
-                    /* call callback outside of semaphore */
-                    if (version == DLTProtocolV1) {
-                        if (delayed_log_level_changed_callback.log_level_changed_callback != 0)
-                            delayed_log_level_changed_callback.log_level_changed_callback(
-                                delayed_log_level_changed_callback.contextID,
-                                (uint8_t) delayed_log_level_changed_callback.log_level,
-                                (uint8_t) delayed_log_level_changed_callback.trace_status);
+                    usercontextll = (DltUserControlMsgLogLevel *)(receiver->buf + sizeof(DltUserHeader) +
+                                                                  sizeof(DltUserControlMsgLogLevelBatch));
 
-                        /* keep not read data in buffer */
-                        if (dlt_receiver_remove(receiver,
-                                                sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevel)) ==
-                            DLT_RETURN_ERROR)
-                            return DLT_RETURN_ERROR;
-                    }else if (version == DLTProtocolV2) {
-                        if (delayed_log_level_changed_callback.log_level_changed_callback_v2 != 0)
-                            delayed_log_level_changed_callback.log_level_changed_callback_v2(
-                                delayed_log_level_changed_callback.contextID2,
-                                (uint8_t) delayed_log_level_changed_callback.log_level,
-                                (uint8_t) delayed_log_level_changed_callback.trace_status);
+                    /* Update log level and trace status of all contexts */
+                    for (i = 0; i < userbatch->count; i++)
+                        dlt_user_log_level_update(&usercontextll[i], version);
 
-                        /* keep not read data in buffer */
-                        if (dlt_receiver_remove(receiver,
-                                                sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevel)) ==
-                            DLT_RETURN_ERROR)
-                            return DLT_RETURN_ERROR;
-                    }
+                    /* keep not read data in buffer */
+                    if (dlt_receiver_remove(receiver,
+                                            (int) (sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch) +
+                                                   userbatch->count * sizeof(DltUserControlMsgLogLevel))) ==
+                        DLT_RETURN_ERROR)
+                        return DLT_RETURN_ERROR;
                 }
                 break;
                 case DLT_USER_MESSAGE_INJECTION:
@@ -6878,51 +7205,16 @@ DltReturnValue dlt_user_log_check_user_message(void)
                     trace_load_settings_user_messages =
                         (DltUserControlMsgTraceSettingMsg *)(receiver->buf + sizeof(DltUserHeader) + sizeof(uint32_t));
 
-                    pthread_rwlock_wrlock(&trace_load_rw_lock);
-
-                    // Remove the default created at startup
-                    if (trace_load_settings != NULL) {
-                        free(trace_load_settings);
-                        trace_load_settings_count = 0;
-                        trace_load_settings = NULL;
-                    }
-
-                    trace_load_settings_alloc_size = sizeof(DltTraceLoadSettings) * trace_load_settings_user_messages_count;
-                    trace_load_settings = malloc(trace_load_settings_alloc_size);
-                                       if (trace_load_settings == NULL) {
-                        pthread_rwlock_unlock(&trace_load_rw_lock);
-                        dlt_vlog(LOG_EMERG, "Unable to allocate memory for trace load settings, no logging will be possible\n");
-                   } else {
-                        memset(trace_load_settings, 0, trace_load_settings_alloc_size);
-                        for (i = 0; i < trace_load_settings_user_messages_count; i++) {
-                            memcpy(trace_load_settings[i].apid, dlt_user.appID, DLT_ID_SIZE);
-                            memcpy(trace_load_settings[i].ctid, trace_load_settings_user_messages[i].ctid, DLT_ID_SIZE);
-                            trace_load_settings[i].soft_limit = trace_load_settings_user_messages[i].soft_limit;
-                            trace_load_settings[i].hard_limit = trace_load_settings_user_messages[i].hard_limit;
-                        }
-
-                        /* Publish the newly installed trace_load_settings (protected by rwlock)
-                        * and then update the per-context pointer while holding the DLT mutex to
-                        * avoid races with concurrent context registration/unregistration.
-                        */
-                        trace_load_settings_count = trace_load_settings_user_messages_count;
-                        pthread_rwlock_unlock(&trace_load_rw_lock);
-
-                        dlt_mutex_lock();
-                        for (i = 0; i < dlt_user.dlt_ll_ts_num_entries; ++i) {
-                            dlt_ll_ts_type* ctx_entry = &dlt_user.dlt_ll_ts[i];
-                            ctx_entry->trace_load_settings = dlt_find_runtime_trace_load_settings(
-                                trace_load_settings, trace_load_settings_count, dlt_user.appID, ctx_entry->contextID);
-                        }
-                        dlt_mutex_unlock();
-
-                        char **messages = malloc(trace_load_settings_count * sizeof(char *));
+                    if (dlt_user_trace_load_update(trace_load_settings_user_messages,
+                                                   trace_load_settings_user_messages_count) < DLT_RETURN_OK) {
+                        dlt_vlog(LOG_EMERG, "Unable to allocate memory for trace load settings, keeping the current ones\n");
+                    } else {
+                        char **messages = malloc(trace_load_settings_user_messages_count * sizeof(char *));
                         if (messages == NULL) {
-                            pthread_rwlock_unlock(&trace_load_rw_lock);
                             dlt_vlog(LOG_ERR, "unable to allocate memory for trace load message buffer\n");
                         } else {
                             uint32_t msg_count = 0U;
-                            for (i = 0U; i < trace_load_settings_count; i++) {
+                            for (i = 0U; i < trace_load_settings_user_messages_count; i++) {
                                 messages[i] = malloc(255 * sizeof(char));
                                 if (messages[i] == NULL) {
                                     dlt_vlog(LOG_ERR, "unable to allocate memory for trace load message buffer, index: %u, skipping remaining entries\n", i);
@@ -6930,20 +7222,19 @@ DltReturnValue dlt_user_log_check_user_message(void)
                                 }
                                 ++msg_count;
                                 snprintf(messages[i], 255, "Received trace load settings: apid=%.4s%s%.4s, soft_limit=%u, hard_limit=%u\n",
-                                trace_load_settings[i].apid,
-                                        trace_load_settings[i].ctid[0] == '\0' ? "" : ", ctid=",
-                                        trace_load_settings[i].ctid[0] == '\0' ? "" : trace_load_settings[i].ctid,
-                                trace_load_settings[i].soft_limit,
-                                trace_load_settings[i].hard_limit);
+                                dlt_user.appID,
+                                        trace_load_settings_user_messages[i].ctid[0] == '\0' ? "" : ", ctid=",
+                                        trace_load_settings_user_messages[i].ctid[0] == '\0' ? "" : trace_load_settings_user_messages[i].ctid,
+                                trace_load_settings_user_messages[i].soft_limit,
+                                trace_load_settings_user_messages[i].hard_limit);
                             }
-                            /* Messages are emitted outside of both the rwlock and the DLT mutex */
+                            /* Messages are emitted outside of the DLT mutex */
                             for (i = 0U; i < msg_count; i++) {
                                 dlt_user_output_internal_msg(DLT_LOG_INFO, messages[i], NULL);
                                 free(messages[i]);
                             }
                             free(messages);
                         }
-                        /* continue outer flow, rwlock already unlocked */
                     }
 
                     /* keep not read data in buffer */
@@ -6982,7 +7273,7 @@ DltReturnValue dlt_user_log_check_user_message(void)
 
 DltReturnValue dlt_user_log_resend_buffer(void)
 {
-    int num, count;
+    int num, count, removed = 0;
     int size;
     DltReturnValue ret;
 
@@ -6997,7 +7288,7 @@ DltReturnValue dlt_user_log_resend_buffer(void)
     count = dlt_buffer_get_message_count(&(dlt_user.startup_buffer));
     dlt_mutex_unlock();
 
-    if(dlt_user.appID[0] == '\0') {
+    if (dlt_user.appID[0] != '\0') {
         for (num = 0; num < count; num++) {
             dlt_mutex_lock();
             size = dlt_buffer_copy(&(dlt_user.startup_buffer), dlt_user.resend_buffer, dlt_user.log_buf_len);
@@ -7053,6 +7344,7 @@ DltReturnValue dlt_user_log_resend_buffer(void)
                 /* in case of error, keep message in ringbuffer */
                 if (ret == DLT_RETURN_OK) {
                     dlt_buffer_remove(&(dlt_user.startup_buffer));
+                    removed++;
                 }
                 else {
                     if (ret == DLT_RETURN_PIPE_ERROR) {
@@ -7063,6 +7355,10 @@ DltReturnValue dlt_user_log_resend_buffer(void)
 
                     /* keep message in ringbuffer */
                     dlt_mutex_unlock();
+
+                    if (removed > 0)
+                        dlt_user_buffer_space_signal();
+
                     return ret;
                 }
             }
@@ -7153,6 +7449,7 @@ DltReturnValue dlt_user_log_resend_buffer(void)
                 /* in case of error, keep message in ringbuffer */
                 if (ret == DLT_RETURN_OK) {
                     dlt_buffer_remove(&(dlt_user.startup_buffer));
+                    removed++;
                 }
                 else {
                     if (ret == DLT_RETURN_PIPE_ERROR) {
@@ -7163,6 +7460,10 @@ DltReturnValue dlt_user_log_resend_buffer(void)
 
                     /* keep message in ringbuffer */
                     dlt_mutex_unlock();
+
+                    if (removed > 0)
+                        dlt_user_buffer_space_signal();
+
                     return ret;
                 }
             }
@@ -7171,6 +7472,9 @@ DltReturnValue dlt_user_log_resend_buffer(void)
         }
     }
 
+    if (removed > 0)
+        dlt_user_buffer_space_signal();
+
     return DLT_RETURN_OK;
 }
 
@@ -7336,6 +7640,100 @@ DltReturnValue dlt_user_check_buffer(int *total_size, int *used_size)
     return DLT_RETURN_OK; /* ok */
 }
 
+static void dlt_user_buffer_space_init(void)
+{
+    pthread_condattr_t attr;
+
+    /* deadlines are taken from CLOCK_MONOTONIC, like the housekeeper's */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&dlt_buffer_space_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/* Wake up the threads waiting in dlt_user_wait_buffer_space() */
+static void dlt_user_buffer_space_signal(void)
+{
+    pthread_once(&dlt_buffer_space_once, dlt_user_buffer_space_init);
+
+    pthread_mutex_lock(&dlt_buffer_space_mutex);
+    dlt_buffer_space_seq++;
+    pthread_cond_broadcast(&dlt_buffer_space_cond);
+    pthread_mutex_unlock(&dlt_buffer_space_mutex);
+}
+
+DltReturnValue dlt_user_wait_buffer_space(int free_percent, int timeout_ms)
+{
+    int total_size = 0, used_size = 0;
+    unsigned int seq;
+    int status = 0;
+    struct timespec deadline, wake;
+
+    if ((free_percent < 0) || (free_percent > 100) || (timeout_ms < 0))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    pthread_once(&dlt_buffer_space_once, dlt_user_buffer_space_init);
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    for (;;) {
+        /* taken before checking, so a drain in between is not missed */
+        pthread_mutex_lock(&dlt_buffer_space_mutex);
+        seq = dlt_buffer_space_seq;
+        pthread_mutex_unlock(&dlt_buffer_space_mutex);
+
+        dlt_user_check_buffer(&total_size, &used_size);
+
+        if ((int64_t)(total_size - used_size) * 100 >= (int64_t)total_size * free_percent)
+            return DLT_RETURN_OK;
+
+        if (status == ETIMEDOUT)
+            return DLT_RETURN_BUFFER_FULL;
+
+        /* push buffered messages to the daemon as far as it takes them,
+         * the housekeeper thread retries with its resend delay */
+        if (dlt_user_log_resend_buffer() != DLT_RETURN_OK)
+            dlt_user_housekeeper_wakeup();
+
+        wake = deadline;
+#ifdef DLT_SHM_ENABLE
+        /* the daemon drains the shared memory without notifying the library */
+        clock_gettime(CLOCK_MONOTONIC, &wake);
+        wake.tv_sec += DLT_USER_RECEIVE_MDELAY / 1000;
+        wake.tv_nsec += (DLT_USER_RECEIVE_MDELAY % 1000) * 1000000L;
+
+        if (wake.tv_nsec >= 1000000000L) {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+
+        if ((wake.tv_sec > deadline.tv_sec) ||
+            ((wake.tv_sec == deadline.tv_sec) && (wake.tv_nsec > deadline.tv_nsec)))
+            wake = deadline;
+#endif
+
+        /* sleep until messages were taken out of the buffer */
+        pthread_mutex_lock(&dlt_buffer_space_mutex);
+
+        while ((seq == dlt_buffer_space_seq) && (status != ETIMEDOUT))
+            status = pthread_cond_timedwait(&dlt_buffer_space_cond, &dlt_buffer_space_mutex, &wake);
+
+        pthread_mutex_unlock(&dlt_buffer_space_mutex);
+
+#ifdef DLT_SHM_ENABLE
+        if ((status == ETIMEDOUT) && ((wake.tv_sec != deadline.tv_sec) || (wake.tv_nsec != deadline.tv_nsec)))
+            status = 0;
+#endif
+    }
+}
+
 #ifdef DLT_TEST_ENABLE
 void dlt_user_test_corrupt_user_header(int enable)
 {
@@ -7365,11 +7763,14 @@ int dlt_start_threads()
     pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
     pthread_cond_init(&dlt_housekeeper_running_cond, &attr);
 
+    dlt_user_housekeeper_open();
+
     if (pthread_create(&(dlt_housekeeperthread_handle),
                        0,
                        dlt_user_housekeeperthread_function,
                        &dlt_housekeeper_running) != 0) {
         dlt_log(LOG_CRIT, "Can't create housekeeper thread!\n");
+        dlt_user_housekeeper_close();
         return -1;
     }
 
@@ -7494,6 +7895,7 @@ void dlt_stop_threads()
                      strerror(joined));
 
         dlt_housekeeperthread_handle = 0; /* set to invalid */
+        dlt_user_housekeeper_close();
     }
 
 #ifdef DLT_NETWORK_TRACE_ENABLE
@@ -7514,10 +7916,15 @@ static void dlt_fork_child_fork_handler()
 {
     g_dlt_is_child = 1;
     dlt_user_init_state = INIT_UNITIALIZED;
+    /* the wakeup descriptors belong to the housekeeper of the parent */
+    dlt_user_housekeeper_close();
     dlt_user.dlt_log_handle = -1;
     dlt_user.local_pid = -1;
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
     pthread_rwlock_unlock(&trace_load_rw_lock);
+    /* the log calls of the other threads of the parent never finish here */
+    atomic_store(&trace_load_readers[0], 0);
+    atomic_store(&trace_load_readers[1], 0);
 #endif
 }
 
@@ -7589,6 +7996,119 @@ static DltReturnValue dlt_user_output_internal_msg(
     /* Return number of bytes if message was successfully sent */
     return (ret == DLT_RETURN_OK) ? sent_size : ret;
 }
+
+/* Replace the trace load settings by count entries with the given limits for
+ * dlt_user.appID, or by a copy of the current ones if limits is NULL, e.g.
+ * after the application id changed. The current settings are kept if no
+ * memory is available. */
+static DltReturnValue dlt_user_trace_load_update(const DltUserControlMsgTraceSettingMsg *limits, uint32_t count)
+{
+    static unsigned int generation = 0;
+    DltTraceLoadTable *current;
+    DltTraceLoadTable *table;
+    uint32_t i;
+
+    pthread_rwlock_wrlock(&trace_load_rw_lock);
+
+    current = atomic_load(&trace_load_table);
+
+    if (limits == NULL)
+        count = (current != NULL) ? current->count : 0;
+
+    table = calloc(1, sizeof(DltTraceLoadTable) + count * sizeof(DltTraceLoadSettings));
+
+    if (table == NULL) {
+        pthread_rwlock_unlock(&trace_load_rw_lock);
+        return DLT_RETURN_ERROR;
+    }
+
+    /* never 0, the generation of a context which did not log yet */
+    if (++generation == 0)
+        generation = 1;
+
+    table->generation = generation;
+    table->count = count;
+
+    for (i = 0; i < count; i++) {
+        memcpy(table->settings[i].apid, dlt_user.appID, DLT_ID_SIZE);
+
+        if (limits != NULL) {
+            memcpy(table->settings[i].ctid, limits[i].ctid, DLT_ID_SIZE);
+            table->settings[i].soft_limit = limits[i].soft_limit;
+            table->settings[i].hard_limit = limits[i].hard_limit;
+        }
+        else {
+            memcpy(table->settings[i].ctid, current->settings[i].ctid, DLT_ID_SIZE);
+            table->settings[i].soft_limit = current->settings[i].soft_limit;
+            table->settings[i].hard_limit = current->settings[i].hard_limit;
+        }
+    }
+
+    dlt_user_trace_load_publish(table);
+
+    pthread_rwlock_unlock(&trace_load_rw_lock);
+
+    return DLT_RETURN_OK;
+}
+
+/* Publish table, NULL to remove the settings, and free the replaced one once
+ * no log call uses it anymore. Must be called with trace_load_rw_lock held
+ * for writing and without dlt_mutex held.
+ * Each flip of the epoch lets the log calls of the other parity drain while
+ * new calls are counted in the new one. Both parities are waited for because
+ * a call may have read the epoch just before the previous flip. */
+static void dlt_user_trace_load_publish(DltTraceLoadTable *table)
+{
+    DltTraceLoadTable *replaced = atomic_exchange(&trace_load_table, table);
+    int phase;
+
+    if (replaced == NULL)
+        return;
+
+    for (phase = 0; phase < 2; phase++) {
+        unsigned int parity = atomic_fetch_add(&trace_load_epoch, 1) & 1U;
+
+        while (atomic_load(&trace_load_readers[parity]) != 0)
+            sched_yield();
+    }
+
+    free(replaced);
+}
+
+/* Start accounting a message of the context entry at pos and return its trace
+ * load settings. The settings cached in the entry are used as long as the
+ * generation of the published table is unchanged, so they are only searched
+ * again after an update. Must be called with dlt_mutex held, it takes no other
+ * lock. The settings stay valid until dlt_user_trace_load_leave() is called
+ * with epoch, which must not be done with dlt_mutex held. */
+static DltTraceLoadSettings *dlt_user_trace_load_enter(int pos, const char *apid, const char *ctid,
+                                                       unsigned int *epoch)
+{
+    DltTraceLoadTable *table;
+    DltTraceLoadSettings *settings;
+
+    *epoch = atomic_load(&trace_load_epoch) & 1U;
+    atomic_fetch_add(&trace_load_readers[*epoch], 1);
+
+    table = atomic_load(&trace_load_table);
+
+    if (table == NULL)
+        return NULL;
+
+    if (dlt_user.dlt_ll_ts[pos].trace_load_generation == table->generation)
+        return dlt_user.dlt_ll_ts[pos].trace_load_settings;
+
+    settings = dlt_find_runtime_trace_load_settings(table->settings, table->count, apid, ctid);
+    dlt_user.dlt_ll_ts[pos].trace_load_settings = settings;
+    dlt_user.dlt_ll_ts[pos].trace_load_generation = table->generation;
+
+    return settings;
+}
+
+static void dlt_user_trace_load_leave(unsigned int epoch)
+{
+    atomic_fetch_sub(&trace_load_readers[epoch], 1);
+}
 #endif
 
 DltReturnValue dlt_user_log_out_error_handling(void *ptr1, size_t len1, void *ptr2, size_t len2, void *ptr3,
@@ -7613,6 +8133,9 @@ DltReturnValue dlt_user_log_out_error_handling(void *ptr1, size_t len1, void *pt
 
         ret = DLT_RETURN_BUFFER_FULL;
     }
+    else {
+        dlt_user_housekeeper_wakeup();
+    }
 
     dlt_mutex_unlock();
     return ret;
@@ -144,6 +144,10 @@
 /* delay for housekeeper thread (nsec) while receiving messages*/
 #define DLT_USER_RECEIVE_NDELAY (DLT_USER_RECEIVE_MDELAY * 1000 * 1000)
 
+/* first and maximum delay between attempts to reattach to the daemon (msec) */
+#define DLT_USER_RECONNECT_MIN_MDELAY (DLT_USER_RECEIVE_MDELAY)
+#define DLT_USER_RECONNECT_MAX_MDELAY (4000)
+
 /* Name of environment variable for local print mode */
 #define DLT_USER_ENV_LOCAL_PRINT_MODE "DLT_LOCAL_PRINT_MODE"
 
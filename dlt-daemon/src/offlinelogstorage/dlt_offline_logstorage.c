@@ -33,6 +33,7 @@
 #include "dlt_offline_logstorage_internal.h"
 #include "dlt_offline_logstorage_behavior.h"
 #include "dlt_config_file_parser.h"
+#include "dlt_storage_writer.h"
 
 #define DLT_OFFLINE_LOGSTORAGE_FILTER_ERROR 1
 #define DLT_OFFLINE_LOGSTORAGE_STORE_FILTER_ERROR 2
@@ -2122,6 +2123,9 @@ int dlt_logstorage_device_disconnected(DltLogStorage *handle, int reason)
     if (handle->config_status == DLT_OFFLINE_LOGSTORAGE_CONFIG_DONE)
         dlt_logstorage_free(handle, reason);
 
+    /* the files have to be complete before the device goes away */
+    dlt_storage_writer_wait();
+
     /* Reset all device status */
     memset(handle->device_mount_point, 0, sizeof(char) * (DLT_MOUNT_PATH_MAX + 1));
     handle->connection_type = DLT_OFFLINE_LOGSTORAGE_DEVICE_DISCONNECTED;
@@ -27,9 +27,11 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <libgen.h>
 
 #include "dlt_log.h"
+#include "dlt_storage_writer.h"
 #include "dlt_offline_logstorage.h"
 #include "dlt_offline_logstorage_behavior.h"
 #include "dlt_offline_logstorage_behavior_internal.h"
@@ -1058,6 +1060,54 @@ DLT_STATIC int dlt_logstorage_sync_to_file(DltLogStorageFilterConfig *config,
     return 0;
 }
 
+/**
+ * dlt_logstorage_use_writer
+ *
+ * Check if the messages of a filter are queued to the asynchronous storage
+ * writer instead of being written through the FILE handle. This applies to
+ * uncompressed files of the ON_MSG strategy.
+ *
+ * @param config        DltLogStorageFilterConfig
+ * @return true if the storage writer is used
+ */
+DLT_STATIC bool dlt_logstorage_use_writer(DltLogStorageFilterConfig *config)
+{
+    return (config->gzip_compression != DLT_LOGSTORAGE_GZIP_ON) &&
+           dlt_storage_writer_is_async();
+}
+
+/**
+ * dlt_logstorage_prepare_writer
+ *
+ * Prepare a newly opened log file for the storage writer. The writes go to
+ * explicit offsets as they may complete in any order, so the file must not
+ * append and the offset is tracked in current_write_file_offset.
+ *
+ * @param config        DltLogStorageFilterConfig
+ * @return 0 on success, -1 on error
+ */
+DLT_STATIC int dlt_logstorage_prepare_writer(DltLogStorageFilterConfig *config)
+{
+    struct stat s;
+    int flags;
+
+    if (config->log == NULL)
+        return 0;
+
+    config->fd = fileno(config->log);
+    flags = fcntl(config->fd, F_GETFL);
+
+    if ((flags == -1) || (fcntl(config->fd, F_SETFL, flags & ~O_APPEND) == -1) ||
+        (fstat(config->fd, &s) != 0)) {
+        dlt_vlog(LOG_ERR, "%s: failed to prepare log file: %s\n", __func__, strerror(errno));
+        return -1;
+    }
+
+    config->current_write_file_offset = (unsigned int)s.st_size;
+
+    return 0;
+}
+
 /**
  * dlt_logstorage_prepare_on_msg
  *
@@ -1110,9 +1160,19 @@ int dlt_logstorage_prepare_on_msg(DltLogStorageFilterConfig *config,
                                            log_msg_size,
                                            true,
                                            false);
+
+        if ((ret == 0) && dlt_logstorage_use_writer(config))
+            ret = dlt_logstorage_prepare_writer(config);
     }
     else { /* already open, check size and create a new file if needed */
-        ret = fstat(config->fd, &s);
+        if (dlt_logstorage_use_writer(config)) {
+            /* queued writes are not visible in the file size yet */
+            s.st_size = (off_t)config->current_write_file_offset;
+            ret = 0;
+        }
+        else {
+            ret = fstat(config->fd, &s);
+        }
 
         if (ret == 0) {
             /* Check if adding new data do not exceed max file size
@@ -1128,6 +1188,14 @@ int dlt_logstorage_prepare_on_msg(DltLogStorageFilterConfig *config,
                 /* Sync only if on_msg */
                 if ((config->sync == DLT_LOGSTORAGE_SYNC_ON_MSG) ||
                     (config->sync == DLT_LOGSTORAGE_SYNC_UNSET)) {
+                    if (dlt_logstorage_use_writer(config)) {
+                        /* the writer syncs and closes its own handle once
+                         * the writes queued before are done */
+                        int fd = dup(config->fd);
+
+                        if ((fd == -1) || (dlt_storage_writer_close(fd, true) != DLT_RETURN_OK))
+                            dlt_vlog(LOG_ERR, "%s: failed to sync log file\n", __func__);
+                    } else
 #ifdef DLT_LOGSTORAGE_USE_GZIP
                     if (config->gzip_compression == DLT_LOGSTORAGE_GZIP_ON) {
                         if (fsync(fileno(config->gzlog)) != 0) {
@@ -1164,6 +1232,9 @@ int dlt_logstorage_prepare_on_msg(DltLogStorageFilterConfig *config,
                                                    log_msg_size,
                                                    true,
                                                    false);
+
+                if ((ret == 0) && dlt_logstorage_use_writer(config))
+                    ret = dlt_logstorage_prepare_writer(config);
             }
             else { /*everything is prepared */
                 ret = 0;
@@ -1212,6 +1283,21 @@ int dlt_logstorage_write_on_msg(DltLogStorageFilterConfig *config,
         return -1;
     }
 
+    if (dlt_logstorage_use_writer(config)) {
+        struct iovec iov[3] = {
+            { data1, (size_t)size1 },
+            { data2, (size_t)size2 },
+            { data3, (size_t)size3 }
+        };
+
+        if (dlt_storage_writer_write(config->fd, (off_t)config->current_write_file_offset,
+                                     iov, 3) != DLT_RETURN_OK)
+            return -1;
+
+        config->current_write_file_offset += (unsigned int)(size1 + size2 + size3);
+        return 0;
+    }
+
     ret = dlt_logstorage_write_to_log(data1, 1, (size_t)size1, config);
 
     if (ret != size1)
@@ -31,6 +31,7 @@
 #include <time.h>     /* for localtime_r(), strftime(), clock_gettime() */
 #include <limits.h>   /* for NAME_MAX */
 #include <inttypes.h> /* for PRI formatting macro */
+#include <math.h>     /* for signbit() */
 #include <stdarg.h>   /* va_list, va_start */
 #include <err.h>
 
@@ -128,17 +129,24 @@ static int32_t dlt_output_hard_limit_warning(
     DltLogInternal log_internal,
     void *log_params);
 
-static bool dlt_user_cleanup_window(DltTraceLoadStat *tl_stat);
+static bool dlt_user_cleanup_window(DltTraceLoadStat *tl_stat, uint32_t last_abs_slot, uint32_t curr_abs_slot);
 
 static int32_t dlt_switch_slot_if_needed(
     DltTraceLoadSettings* tl_settings,
     DltLogInternal log_internal,
     void *log_internal_params,
-    uint32_t timestamp);
+    uint32_t curr_abs_slot);
 
-static void dlt_record_trace_load(DltTraceLoadStat *const tl_stat, int32_t size);
-static inline bool dlt_is_over_trace_load_soft_limit(DltTraceLoadSettings* tl_settings);
-static inline bool dlt_is_over_trace_load_hard_limit(DltTraceLoadSettings* tl_settings, int size);
+static uint64_t dlt_record_trace_load(DltTraceLoadStat *const tl_stat, uint32_t slot, int32_t size);
+static inline bool dlt_is_over_trace_load_soft_limit(DltTraceLoadSettings* tl_settings, uint64_t avg_trace_load);
+static inline bool dlt_is_over_trace_load_hard_limit(DltTraceLoadSettings* tl_settings, uint64_t avg_trace_load,
+                                                     uint32_t slot, int size);
+
+/* The window statistics of a settings entry are shared by all threads logging
+ * through it and are updated without a lock, see dlt_check_trace_load().
+ */
+#define DLT_TL_GET(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#define DLT_TL_SET(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
 #endif
 
 void dlt_print_hex(uint8_t *ptr, int size)
@@ -156,10 +164,43 @@ void dlt_print_hex(uint8_t *ptr, int size)
     }
 }
 
-static DltReturnValue dlt_print_hex_string_delim(char *text, int textlength, uint8_t *ptr, int size, char delim)
+/* Two lower case hex digits of each byte value */
+static const char dlt_hex_digits[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/* Two decimal digits of each value below 100 */
+static const char dlt_dec_digits[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* Write size bytes as delimited hex pairs, returns the end of the text */
+static char *dlt_hex_to_chars(char *text, const uint8_t *ptr, int size, char delim)
 {
     int num;
 
+    for (num = 0; num < size; num++) {
+        if (num > 0)
+            *text++ = delim;
+
+        memcpy(text, &dlt_hex_digits[ptr[num] * 2], 2);
+        text += 2;
+    }
+
+    return text;
+}
+
+static DltReturnValue dlt_print_hex_string_delim(char *text, int textlength, uint8_t *ptr, int size, char delim)
+{
     if ((ptr == NULL) || (text == NULL) || (textlength <= 0) || (size < 0) || (delim == '\0'))
         return DLT_RETURN_WRONG_PARAMETER;
 
@@ -171,15 +212,9 @@ static DltReturnValue dlt_print_hex_string_delim(char *text, int textlength, uin
         return DLT_RETURN_ERROR;
     }
 
-    for (num = 0; num < size; num++) {
-        if (num > 0) {
-            snprintf(text, 2, "%c", delim);
-            text++;
-        }
-
-        snprintf(text, 3, "%.2x", ((uint8_t *)ptr)[num]);
-        text += 2; /* 2 chars */
-    }
+    /* an empty input leaves the text untouched */
+    if (size > 0)
+        *dlt_hex_to_chars(text, ptr, size, delim) = '\0';
 
     return DLT_RETURN_OK;
 }
@@ -442,6 +477,59 @@ void dlt_clean_string(char *text, int length)
             text[num] = ' ';
 }
 
+/* Filter index: one hash table on the packed (apid, ctid) pair. Wildcard ids
+ * are stored as 0, so a message is checked with the four probes
+ * (apid, ctid), (apid, *), (*, ctid) and (*, *). */
+#define DLT_FILTER_INDEX_LEVEL_ANY 0xFFFF
+/* below this number of filters the linear check is faster than hashing */
+#define DLT_FILTER_INDEX_MIN_FILTERS 12
+
+#define DLT_FILTER_INDEX_KEY_EXACT   0x01
+#define DLT_FILTER_INDEX_KEY_APID    0x02
+#define DLT_FILTER_INDEX_KEY_CTID    0x04
+#define DLT_FILTER_INDEX_KEY_ANY     0x08
+
+static inline uint32_t dlt_filter_index_pack_id(const char *id)
+{
+    uint32_t packed = 0;
+
+    memcpy(&packed, id, DLT_ID_SIZE);
+
+    return packed;
+}
+
+static inline uint32_t dlt_filter_index_hash(uint32_t apid, uint32_t ctid)
+{
+    uint32_t hash = (apid * 0x9E3779B1u) ^ (ctid * 0x85EBCA77u);
+
+    return hash ^ (hash >> 15);
+}
+
+/* Drop the index after the filter list was modified */
+static inline void dlt_filter_index_reset(DltFilter *filter)
+{
+    filter->index.num_entries = 0;
+}
+
+static bool dlt_filter_index_match(const DltFilterIndex *index, uint32_t apid, uint32_t ctid,
+                                   uint16_t level_bit, int32_t datasize)
+{
+    int i;
+
+    for (i = index->buckets[dlt_filter_index_hash(apid, ctid) & index->bucket_mask]; i >= 0;
+         i = index->entries[i].next) {
+        const DltFilterIndexEntry *entry = &index->entries[i];
+
+        if ((entry->apid == apid) && (entry->ctid == ctid) &&
+            (entry->level_mask & level_bit) &&
+            (entry->payload_min <= datasize) &&
+            (entry->payload_max >= datasize))
+            return true;
+    }
+
+    return false;
+}
+
 DltReturnValue dlt_filter_init(DltFilter *filter, int verbose)
 {
     PRINT_FUNCTION_VERBOSE(verbose);
@@ -449,6 +537,7 @@ DltReturnValue dlt_filter_init(DltFilter *filter, int verbose)
     if (filter == NULL)
         return DLT_RETURN_WRONG_PARAMETER;
 
+    dlt_filter_index_reset(filter);
     filter->counter = 0;
 
     return DLT_RETURN_OK;
@@ -461,6 +550,83 @@ DltReturnValue dlt_filter_free(DltFilter *filter, int verbose)
     if (filter == NULL)
         return DLT_RETURN_WRONG_PARAMETER;
 
+    dlt_filter_index_reset(filter);
+
+    return DLT_RETURN_OK;
+}
+
+DltReturnValue dlt_filter_compile(DltFilter *filter, int verbose)
+{
+    DltFilterIndex *index = NULL;
+    uint32_t num_buckets = 8;
+    int num;
+    int i;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if (filter == NULL)
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    dlt_filter_index_reset(filter);
+
+    if ((filter->counter < DLT_FILTER_INDEX_MIN_FILTERS) || (filter->counter > DLT_FILTER_MAX))
+        return DLT_RETURN_OK;
+
+    while (num_buckets < 2 * (uint32_t)filter->counter)
+        num_buckets <<= 1;
+
+    index = &filter->index;
+    index->bucket_mask = num_buckets - 1;
+    index->key_types = 0;
+
+    for (i = 0; i < (int)num_buckets; i++)
+        index->buckets[i] = -1;
+
+    for (num = 0; num < filter->counter; num++) {
+        uint32_t apid = (filter->apid[num][0] == 0) ? 0 : dlt_filter_index_pack_id(filter->apid[num]);
+        uint32_t ctid = (filter->ctid[num][0] == 0) ? 0 : dlt_filter_index_pack_id(filter->ctid[num]);
+        int32_t payload_min = filter->payload_min[num];
+        int32_t payload_max = (filter->payload_max[num] == 0) ? INT32_MAX : filter->payload_max[num];
+        uint16_t level_mask;
+        uint32_t bucket;
+
+        if (filter->log_level[num] == 0)
+            level_mask = DLT_FILTER_INDEX_LEVEL_ANY;
+        else if ((filter->log_level[num] > 0) && (filter->log_level[num] < 16))
+            level_mask = (uint16_t)(1u << filter->log_level[num]);
+        else
+            /* can never match a message type info */
+            continue;
+
+        index->key_types |= (apid ? (ctid ? DLT_FILTER_INDEX_KEY_EXACT : DLT_FILTER_INDEX_KEY_APID) :
+                                    (ctid ? DLT_FILTER_INDEX_KEY_CTID : DLT_FILTER_INDEX_KEY_ANY));
+        bucket = dlt_filter_index_hash(apid, ctid) & index->bucket_mask;
+
+        /* merge filters which only differ in log level */
+        for (i = index->buckets[bucket]; i >= 0; i = index->entries[i].next)
+            if ((index->entries[i].apid == apid) && (index->entries[i].ctid == ctid) &&
+                (index->entries[i].payload_min == payload_min) &&
+                (index->entries[i].payload_max == payload_max))
+                break;
+
+        if (i >= 0) {
+            index->entries[i].level_mask |= level_mask;
+            continue;
+        }
+
+        i = index->num_entries++;
+        index->entries[i].apid = apid;
+        index->entries[i].ctid = ctid;
+        index->entries[i].level_mask = level_mask;
+        index->entries[i].payload_min = payload_min;
+        index->entries[i].payload_max = payload_max;
+        index->entries[i].next = index->buckets[bucket];
+        index->buckets[bucket] = (int16_t)i;
+    }
+
+    if (verbose)
+        dlt_vlog(LOG_DEBUG, "Compiled %d filters into %d index entries\n", filter->counter, index->num_entries);
+
     return DLT_RETURN_OK;
 }
 
@@ -487,6 +653,7 @@ DltReturnValue dlt_filter_load(DltFilter *filter, const char *filename, int verb
 
     /* Reset filters */
     filter->counter = 0;
+    dlt_filter_index_reset(filter);
 
     while (!feof(handle)) {
         str1[0] = 0;
@@ -529,6 +696,8 @@ DltReturnValue dlt_filter_load(DltFilter *filter, const char *filename, int verb
 
     fclose(handle);
 
+    dlt_filter_compile(filter, verbose);
+
     return DLT_RETURN_OK;
 }
 
@@ -557,6 +726,7 @@ DltReturnValue dlt_filter_load_v2(DltFilter *filter, const char *filename, int v
 
     /* Reset filters */
     filter->counter = 0;
+    dlt_filter_index_reset(filter);
 
     while (!feof(handle)) {
         str1[0] = 0;
@@ -787,6 +957,7 @@ DltReturnValue dlt_filter_add(DltFilter *filter, const char *apid, const char *c
         filter->payload_max[filter->counter] = payload_max;
 
         filter->counter++;
+        dlt_filter_index_reset(filter);
 
         return DLT_RETURN_OK;
     }
@@ -831,6 +1002,7 @@ DltReturnValue dlt_filter_add_v2(DltFilter *filter, const char *apid, const char
         filter->payload_max[filter->counter] = payload_max;
 
         filter->counter++;
+        dlt_filter_index_reset(filter);
 
         return DLT_RETURN_OK;
     }
@@ -881,6 +1053,7 @@ DltReturnValue dlt_filter_delete(DltFilter *filter, const char *apid, const char
             }
 
             filter->counter--;
+            dlt_filter_index_reset(filter);
             return DLT_RETURN_OK;
         }
     }
@@ -944,6 +1117,7 @@ DltReturnValue dlt_filter_delete_v2(DltFilter *filter, const char *apid, const c
             filter->ctid2[filter->counter] = NULL;
 
             filter->counter--;
+            dlt_filter_index_reset(filter);
             return DLT_RETURN_OK;
         }
     }
@@ -1376,6 +1550,316 @@ DltReturnValue dlt_message_header_flags_v2(DltMessageV2 *msg, char *text, size_t
     return DLT_RETURN_OK;
 }
 
+/* Verbose payload text is written to the caller's buffer through a cursor,
+ * one byte before end stays free for the terminating NUL */
+typedef struct
+{
+    char *pos;
+    char *end;
+} DltTextArena;
+
+/* Longest number text: a signed 64 bit decimal, "%g" needs at most 13 */
+#define DLT_TEXT_ARENA_NUMBER_LEN 21
+
+static inline bool dlt_text_arena_fits(const DltTextArena *arena, size_t size)
+{
+    return (size_t)(arena->end - arena->pos) >= size;
+}
+
+static void dlt_text_arena_put_u64(DltTextArena *arena, uint64_t value)
+{
+    char digits[20];
+    char *first = digits + sizeof(digits);
+
+    while (value >= 100) {
+        first -= 2;
+        memcpy(first, &dlt_dec_digits[(value % 100) * 2], 2);
+        value /= 100;
+    }
+
+    if (value >= 10) {
+        first -= 2;
+        memcpy(first, &dlt_dec_digits[value * 2], 2);
+    }
+    else {
+        *--first = (char)('0' + value);
+    }
+
+    memcpy(arena->pos, first, (size_t)(digits + sizeof(digits) - first));
+    arena->pos += digits + sizeof(digits) - first;
+}
+
+static void dlt_text_arena_put_i64(DltTextArena *arena, int64_t value)
+{
+    if (value < 0) {
+        *arena->pos++ = '-';
+        dlt_text_arena_put_u64(arena, (uint64_t)0 - (uint64_t)value);
+    }
+    else {
+        dlt_text_arena_put_u64(arena, (uint64_t)value);
+    }
+}
+
+/* Like "%0*x" */
+static void dlt_text_arena_put_hex(DltTextArena *arena, uint32_t value, int width)
+{
+    int i;
+
+    for (i = width - 1; i >= 0; i--) {
+        arena->pos[i] = dlt_hex_digits[(value & 0xF) * 2 + 1];
+        value >>= 4;
+    }
+
+    arena->pos += width;
+}
+
+/* Like "%g": integral values in its fixed point range are written as
+ * integers, all others are left to snprintf() */
+static void dlt_text_arena_put_double(DltTextArena *arena, double value)
+{
+    if ((value > -1e6) && (value < 1e6) && ((double)(int64_t)value == value) &&
+        !((value == 0) && signbit(value))) {
+        dlt_text_arena_put_i64(arena, (int64_t)value);
+        return;
+    }
+
+    arena->pos += snprintf(arena->pos, (size_t)(arena->end - arena->pos) + 1, "%g", value);
+}
+
+/* Size of a value of type length tyle, 0 if invalid */
+static int32_t dlt_type_length_size(uint32_t tyle)
+{
+    switch (tyle) {
+    case DLT_TYLE_8BIT:
+        return 1;
+    case DLT_TYLE_16BIT:
+        return 2;
+    case DLT_TYLE_32BIT:
+        return 4;
+    case DLT_TYLE_64BIT:
+        return 8;
+    case DLT_TYLE_128BIT:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+/* Read a 16 bit length field, -1 if the payload is too short */
+static int32_t dlt_payload_read_length(uint8_t htyp, uint8_t **ptr, int32_t *datalength)
+{
+    uint16_t value = 0;
+
+    DLT_MSG_READ_VALUE(value, *ptr, *datalength, uint16_t);
+
+    if (*datalength < 0)
+        return -1;
+
+    return (uint16_t)DLT_ENDIAN_GET_16(htyp, value);
+}
+
+static bool dlt_payload_skip(uint8_t **ptr, int32_t *datalength, int32_t size)
+{
+    if ((size < 0) || (*datalength < size))
+        return false;
+
+    *ptr += size;
+    *datalength -= size;
+
+    return true;
+}
+
+/* Print one verbose argument exactly like dlt_message_argument_print()
+ * without attributes. DLT_RETURN_ERROR if the argument type is not covered,
+ * the payload is corrupted or the text might not fit. */
+static DltReturnValue dlt_message_argument_to_chars(uint8_t htyp,
+                                                    uint32_t type_info,
+                                                    uint8_t **ptr,
+                                                    int32_t *datalength,
+                                                    DltTextArena *arena)
+{
+    uint32_t scod = type_info & DLT_TYPE_INFO_SCOD;
+    int32_t size = dlt_type_length_size(type_info & DLT_TYPE_INFO_TYLE);
+    bool vari = (type_info & DLT_TYPE_INFO_VARI) != 0;
+    int32_t length = 0;
+    int32_t name = 0;
+    int32_t unit = 0;
+    uint16_t value16 = 0;
+    uint32_t value32 = 0;
+    uint64_t value64 = 0;
+
+    if ((type_info & DLT_TYPE_INFO_STRG) && ((scod == DLT_SCOD_ASCII) || (scod == DLT_SCOD_UTF8))) {
+        length = dlt_payload_read_length(htyp, ptr, datalength);
+
+        if (vari)
+            name = dlt_payload_read_length(htyp, ptr, datalength);
+
+        if ((length <= 0) || !dlt_payload_skip(ptr, datalength, name) || (*datalength < length) ||
+            !dlt_text_arena_fits(arena, (size_t)length))
+            return DLT_RETURN_ERROR;
+
+        /* the text ends at the first NUL */
+        memcpy(arena->pos, *ptr, (size_t)length);
+        size = (int32_t)strnlen(arena->pos, (size_t)length);
+        dlt_clean_string(arena->pos, size);
+        arena->pos += size;
+        dlt_payload_skip(ptr, datalength, length);
+    }
+    else if (type_info & DLT_TYPE_INFO_BOOL) {
+        if (vari)
+            name = dlt_payload_read_length(htyp, ptr, datalength);
+
+        if (!dlt_payload_skip(ptr, datalength, name) || (*datalength < 1) ||
+            !dlt_text_arena_fits(arena, DLT_TEXT_ARENA_NUMBER_LEN))
+            return DLT_RETURN_ERROR;
+
+        dlt_text_arena_put_u64(arena, **ptr);
+        dlt_payload_skip(ptr, datalength, 1);
+    }
+    else if ((type_info & DLT_TYPE_INFO_UINT) && (scod == DLT_SCOD_BIN)) {
+        return DLT_RETURN_ERROR;
+    }
+    else if ((type_info & DLT_TYPE_INFO_UINT) && (scod == DLT_SCOD_HEX)) {
+        /* printed in host byte order, a 64 bit value as two 32 bit halves */
+        if ((size == 0) || (size > 8) || (*datalength < size) || !dlt_text_arena_fits(arena, 2 + 16))
+            return DLT_RETURN_ERROR;
+
+        *arena->pos++ = '0';
+        *arena->pos++ = 'x';
+
+        if (size == 1) {
+            dlt_text_arena_put_hex(arena, **ptr, 2);
+        }
+        else if (size == 2) {
+            memcpy(&value16, *ptr, sizeof(value16));
+            dlt_text_arena_put_hex(arena, value16, 4);
+        }
+        else if (size == 4) {
+            memcpy(&value32, *ptr, sizeof(value32));
+            dlt_text_arena_put_hex(arena, value32, 8);
+        }
+        else {
+            memcpy(&value32, *ptr + 4, sizeof(value32));
+            dlt_text_arena_put_hex(arena, value32, 8);
+            memcpy(&value32, *ptr, sizeof(value32));
+            dlt_text_arena_put_hex(arena, value32, 8);
+        }
+
+        dlt_payload_skip(ptr, datalength, size);
+    }
+    else if (type_info & (DLT_TYPE_INFO_SINT | DLT_TYPE_INFO_UINT | DLT_TYPE_INFO_FLOA)) {
+        if (vari) {
+            name = dlt_payload_read_length(htyp, ptr, datalength);
+            unit = dlt_payload_read_length(htyp, ptr, datalength);
+        }
+
+        if (!dlt_payload_skip(ptr, datalength, name) || !dlt_payload_skip(ptr, datalength, unit) ||
+            (type_info & DLT_TYPE_INFO_FIXP) || (size == 0) || (size > 8) || (*datalength < size) ||
+            !dlt_text_arena_fits(arena, DLT_TEXT_ARENA_NUMBER_LEN))
+            return DLT_RETURN_ERROR;
+
+        if (size >= 2) {
+            memcpy(&value64, *ptr, (size_t)size);
+            value16 = (uint16_t)value64;
+            value32 = (uint32_t)value64;
+        }
+
+        if (type_info & (DLT_TYPE_INFO_SINT | DLT_TYPE_INFO_UINT)) {
+            if (size == 1)
+                value64 = (type_info & DLT_TYPE_INFO_SINT) ? (uint64_t)(int64_t)(int8_t)**ptr : **ptr;
+            else if (size == 2)
+                value64 = (type_info & DLT_TYPE_INFO_SINT) ?
+                    (uint64_t)(int64_t)(int16_t)DLT_ENDIAN_GET_16(htyp, value16) :
+                    (uint16_t)DLT_ENDIAN_GET_16(htyp, value16);
+            else if (size == 4)
+                value64 = (type_info & DLT_TYPE_INFO_SINT) ?
+                    (uint64_t)(int64_t)(int32_t)DLT_ENDIAN_GET_32(htyp, value32) :
+                    DLT_ENDIAN_GET_32(htyp, value32);
+            else
+                value64 = DLT_ENDIAN_GET_64(htyp, value64);
+
+            if (type_info & DLT_TYPE_INFO_SINT)
+                dlt_text_arena_put_i64(arena, (int64_t)value64);
+            else
+                dlt_text_arena_put_u64(arena, value64);
+        }
+        else if (size == 4) {
+            float32_t value32f = 0;
+
+            value32 = DLT_ENDIAN_GET_32(htyp, value32);
+            memcpy(&value32f, &value32, sizeof(value32f));
+            dlt_text_arena_put_double(arena, value32f);
+        }
+#ifndef __arm__
+        else if (size == 8) {
+            float64_t value64f = 0;
+
+            value64 = DLT_ENDIAN_GET_64(htyp, value64);
+            memcpy(&value64f, &value64, sizeof(value64f));
+            dlt_text_arena_put_double(arena, value64f);
+        }
+#endif
+        else {
+            /* float of 8 or 16 bit is printed as hex */
+            return DLT_RETURN_ERROR;
+        }
+
+        dlt_payload_skip(ptr, datalength, size);
+    }
+    else if (type_info & DLT_TYPE_INFO_RAWD) {
+        length = dlt_payload_read_length(htyp, ptr, datalength);
+
+        if (vari)
+            name = dlt_payload_read_length(htyp, ptr, datalength);
+
+        if ((length < 0) || !dlt_payload_skip(ptr, datalength, name) || (*datalength < length) ||
+            !dlt_text_arena_fits(arena, (size_t)length * 3))
+            return DLT_RETURN_ERROR;
+
+        arena->pos = dlt_hex_to_chars(arena->pos, *ptr, length, '\'');
+        dlt_payload_skip(ptr, datalength, length);
+    }
+    else {
+        /* trace info and invalid types */
+        return DLT_RETURN_ERROR;
+    }
+
+    return DLT_RETURN_OK;
+}
+
+/* Verbose payload as text, each argument written straight behind the
+ * previous one. DLT_RETURN_ERROR if any argument is not covered by
+ * dlt_message_argument_to_chars(), the text is undefined then. */
+static DltReturnValue dlt_message_payload_to_chars(DltMessage *msg, char *text, size_t textlength)
+{
+    DltTextArena arena = { text, text + textlength - 1 };
+    uint8_t htyp = msg->standardheader->htyp;
+    uint8_t *ptr = msg->databuffer;
+    int32_t datalength = (int32_t)msg->datasize;
+    uint32_t type_info = 0;
+    int num;
+
+    for (num = 0; num < (int)(msg->extendedheader->noar); num++) {
+        if (num != 0) {
+            if (!dlt_text_arena_fits(&arena, 1))
+                return DLT_RETURN_ERROR;
+
+            *arena.pos++ = ' ';
+        }
+
+        DLT_MSG_READ_VALUE(type_info, ptr, datalength, uint32_t);
+
+        if ((datalength < 0) ||
+            (dlt_message_argument_to_chars(htyp, DLT_ENDIAN_GET_32(htyp, type_info), &ptr, &datalength,
+                                           &arena) != DLT_RETURN_OK))
+            return DLT_RETURN_ERROR;
+    }
+
+    *arena.pos = '\0';
+
+    return DLT_RETURN_OK;
+}
+
 DltReturnValue dlt_message_payload(DltMessage *msg, char *text, size_t textlength, int type, int verbose)
 {
     uint32_t id = 0, id_tmp = 0;
@@ -1491,6 +1975,10 @@ DltReturnValue dlt_message_payload(DltMessage *msg, char *text, size_t textlengt
     /* At this point, it is ensured that a extended header is available */
 
     /* verbose mode */
+    if (!print_with_attributes && (dlt_message_payload_to_chars(msg, text, textlength) == DLT_RETURN_OK))
+        return DLT_RETURN_OK;
+
+    text[0] = 0;
     type_info = 0;
     type_info_tmp = 0;
 
@@ -1678,6 +2166,7 @@ DltReturnValue dlt_message_filter_check(DltMessage *msg, DltFilter *filter, int
     /* check the filters if message is used */
     int num;
     DltReturnValue found = DLT_RETURN_OK;
+    const DltFilterIndex *index = NULL;
 
     PRINT_FUNCTION_VERBOSE(verbose);
 
@@ -1688,6 +2177,27 @@ DltReturnValue dlt_message_filter_check(DltMessage *msg, DltFilter *filter, int
         /* no filter is set, or no extended header is available, so do as filter is matching */
         return DLT_RETURN_TRUE;
 
+    index = &filter->index;
+
+    if (index->num_entries > 0) {
+        uint32_t apid = dlt_filter_index_pack_id(msg->extendedheader->apid);
+        uint32_t ctid = dlt_filter_index_pack_id(msg->extendedheader->ctid);
+        uint16_t level_bit = (uint16_t)(1u << DLT_GET_MSIN_MTIN(msg->extendedheader->msin));
+        uint8_t key_types = index->key_types;
+
+        if (((key_types & DLT_FILTER_INDEX_KEY_EXACT) &&
+             dlt_filter_index_match(index, apid, ctid, level_bit, msg->datasize)) ||
+            ((key_types & DLT_FILTER_INDEX_KEY_APID) &&
+             dlt_filter_index_match(index, apid, 0, level_bit, msg->datasize)) ||
+            ((key_types & DLT_FILTER_INDEX_KEY_CTID) &&
+             dlt_filter_index_match(index, 0, ctid, level_bit, msg->datasize)) ||
+            ((key_types & DLT_FILTER_INDEX_KEY_ANY) &&
+             dlt_filter_index_match(index, 0, 0, level_bit, msg->datasize)))
+            found = DLT_RETURN_TRUE;
+
+        return found;
+    }
+
     for (num = 0; num < filter->counter; num++)
         /* check each filter if it matches */
         if ((DLT_IS_HTYP_UEH(msg->standardheader->htyp)) &&
@@ -1876,6 +2386,167 @@ int dlt_message_read(DltMessage *msg, uint8_t *buffer, unsigned int length, int
     return DLT_MESSAGE_ERROR_OK;
 }
 
+int dlt_message_view_read(DltMessageView *view, const uint8_t *buffer, unsigned int length, int resync, int verbose)
+{
+    uint32_t extra_size = 0;
+    int32_t temp_datasize = 0;
+
+    PRINT_FUNCTION_VERBOSE(verbose);
+
+    if ((view == NULL) || (buffer == NULL) || (length <= 0))
+        return DLT_MESSAGE_ERROR_UNKNOWN;
+
+    /* initialize resync_offset */
+    view->resync_offset = 0;
+    view->found_serialheader = 0;
+
+    /* check if message contains serial header, smaller than standard header */
+    if (length < sizeof(dltSerialHeader))
+        return DLT_MESSAGE_ERROR_SIZE;
+
+    if (memcmp(buffer, dltSerialHeader, sizeof(dltSerialHeader)) == 0) {
+        /* serial header found */
+        view->found_serialheader = 1;
+        buffer += sizeof(dltSerialHeader);
+        length -= (unsigned int)sizeof(dltSerialHeader);
+    }
+    else if (resync) {
+        /* resync if necessary */
+        do {
+            if (memcmp(buffer + view->resync_offset, dltSerialHeader, sizeof(dltSerialHeader)) == 0) {
+                /* serial header found */
+                view->found_serialheader = 1;
+                buffer += sizeof(dltSerialHeader);
+                length -= (unsigned int)sizeof(dltSerialHeader);
+                break;
+            }
+
+            view->resync_offset++;
+        } while ((sizeof(dltSerialHeader) + (size_t)view->resync_offset) <= length);
+
+        /* Set new start offset */
+        if (view->resync_offset > 0) {
+            buffer += view->resync_offset;
+            length -= (unsigned int)view->resync_offset;
+        }
+    }
+
+    /* check that standard header fits buffer */
+    if (length < sizeof(DltStandardHeader))
+        return DLT_MESSAGE_ERROR_SIZE;
+
+    view->buffer = buffer;
+    view->standardheader = (const DltStandardHeader *)buffer;
+
+    /* calculate complete size of headers, everything behind the standard header is parsed on demand */
+    extra_size = (uint32_t) (DLT_STANDARD_HEADER_EXTRA_SIZE(view->standardheader->htyp) +
+        (DLT_IS_HTYP_UEH(view->standardheader->htyp) ? sizeof(DltExtendedHeader) : 0));
+    view->headersize = (int32_t) (sizeof(DltStandardHeader) + extra_size);
+
+    temp_datasize = DLT_BETOH_16(view->standardheader->len) - view->headersize;
+
+    /* check data size */
+    if (temp_datasize < 0) {
+        dlt_vlog(LOG_WARNING,
+                 "Plausibility check failed. Complete message size too short (%d)!\n",
+                 temp_datasize);
+        return DLT_MESSAGE_ERROR_CONTENT;
+    }
+
+    view->datasize = temp_datasize;
+
+    if (verbose) {
+        dlt_vlog(LOG_DEBUG, "BufferLength=%u, HeaderSize=%d, DataSize=%d\n",
+                 length, view->headersize, view->datasize);
+    }
+
+    /* check if complete message fits length */
+    if (length < (size_t)(view->headersize + view->datasize))
+        return DLT_MESSAGE_ERROR_SIZE;
+
+    return DLT_MESSAGE_ERROR_OK;
+}
+
+uint32_t dlt_message_view_get_consumed_size(const DltMessageView *view)
+{
+    if ((view == NULL) || (view->buffer == NULL))
+        return 0;
+
+    return (uint32_t)view->resync_offset +
+           (view->found_serialheader ? (uint32_t)sizeof(dltSerialHeader) : 0) +
+           (uint32_t)view->headersize + (uint32_t)view->datasize;
+}
+
+const DltExtendedHeader *dlt_message_view_get_extendedheader(const DltMessageView *view)
+{
+    if ((view == NULL) || (view->standardheader == NULL) || !DLT_IS_HTYP_UEH(view->standardheader->htyp))
+        return NULL;
+
+    return (const DltExtendedHeader *)(view->buffer + sizeof(DltStandardHeader) +
+                                       DLT_STANDARD_HEADER_EXTRA_SIZE(view->standardheader->htyp));
+}
+
+const char *dlt_message_view_get_apid(const DltMessageView *view)
+{
+    const DltExtendedHeader *extendedheader = dlt_message_view_get_extendedheader(view);
+
+    return (extendedheader != NULL) ? extendedheader->apid : NULL;
+}
+
+const char *dlt_message_view_get_ctid(const DltMessageView *view)
+{
+    const DltExtendedHeader *extendedheader = dlt_message_view_get_extendedheader(view);
+
+    return (extendedheader != NULL) ? extendedheader->ctid : NULL;
+}
+
+const char *dlt_message_view_get_ecuid(const DltMessageView *view)
+{
+    if ((view == NULL) || (view->standardheader == NULL) || !DLT_IS_HTYP_WEID(view->standardheader->htyp))
+        return NULL;
+
+    return (const char *)(view->buffer + sizeof(DltStandardHeader));
+}
+
+DltReturnValue dlt_message_view_get_extraparameters(const DltMessageView *view, DltStandardHeaderExtra *extra)
+{
+    const uint8_t *ptr = NULL;
+    uint8_t htyp = 0;
+
+    if ((view == NULL) || (view->standardheader == NULL) || (extra == NULL))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    memset(extra, 0, sizeof(DltStandardHeaderExtra));
+    htyp = view->standardheader->htyp;
+    ptr = view->buffer + sizeof(DltStandardHeader);
+
+    if (DLT_IS_HTYP_WEID(htyp)) {
+        memcpy(extra->ecu, ptr, DLT_ID_SIZE);
+        ptr += DLT_SIZE_WEID;
+    }
+
+    if (DLT_IS_HTYP_WSID(htyp)) {
+        memcpy(&(extra->seid), ptr, DLT_SIZE_WSID);
+        extra->seid = DLT_BETOH_32(extra->seid);
+        ptr += DLT_SIZE_WSID;
+    }
+
+    if (DLT_IS_HTYP_WTMS(htyp)) {
+        memcpy(&(extra->tmsp), ptr, DLT_SIZE_WTMS);
+        extra->tmsp = DLT_BETOH_32(extra->tmsp);
+    }
+
+    return DLT_RETURN_OK;
+}
+
+const uint8_t *dlt_message_view_get_payload(const DltMessageView *view)
+{
+    if ((view == NULL) || (view->buffer == NULL))
+        return NULL;
+
+    return view->buffer + view->headersize;
+}
+
 int dlt_message_read_v2(DltMessageV2 *msg, uint8_t *buffer, unsigned int length, int resync, int verbose)
 {
     DltHtyp2ContentType msgcontent = 0x00;
@@ -2718,6 +3389,9 @@ DltReturnValue dlt_file_set_filter(DltFile *file, DltFilter *filter, int verbose
     /* set filter */
     file->filter = filter;
 
+    if ((filter != NULL) && (filter->index.num_entries == 0))
+        dlt_filter_compile(filter, verbose);
+
     return DLT_RETURN_OK;
 }
 
@@ -6501,7 +7175,7 @@ static int32_t dlt_output_soft_limit_over_warning(
 {
     char local_str[255];
 
-    if (!tl_settings || !tl_settings->tl_stat.is_over_soft_limit || tl_settings->tl_stat.slot_left_soft_limit_warn)
+    if (!tl_settings || !DLT_TL_GET(tl_settings->tl_stat.is_over_soft_limit) || tl_settings->tl_stat.slot_left_soft_limit_warn)
     {
         /* No need to output warning message */
         return 0;
@@ -6509,9 +7183,9 @@ static int32_t dlt_output_soft_limit_over_warning(
 
     /* Calculate extra trace load which was over limit */
     const uint64_t dropped_message_load
-        = (tl_settings->tl_stat.hard_limit_over_bytes * DLT_TIMESTAMP_RESOLUTION)
+        = (DLT_TL_GET(tl_settings->tl_stat.hard_limit_over_bytes) * DLT_TIMESTAMP_RESOLUTION)
           / TIMESTAMP_BASED_WINDOW_SIZE;
-    const uint64_t curr_trace_load = tl_settings->tl_stat.avg_trace_load + dropped_message_load;
+    const uint64_t curr_trace_load = DLT_TL_GET(tl_settings->tl_stat.avg_trace_load) + dropped_message_load;
     if (curr_trace_load <= tl_settings->soft_limit) {
         /* No need to output warning message */
         return 0;
@@ -6545,7 +7219,7 @@ static int32_t dlt_output_soft_limit_over_warning(
     }
 
     /* Turn off the flag after sending warning message */
-    tl_settings->tl_stat.is_over_soft_limit = false;
+    DLT_TL_SET(tl_settings->tl_stat.is_over_soft_limit, false);
     tl_settings->tl_stat.slot_left_soft_limit_warn = DLT_SOFT_LIMIT_WARN_FREQUENCY;
 
     return sent_size;
@@ -6557,7 +7231,7 @@ static int32_t dlt_output_hard_limit_warning(
     void *const log_params)
 {
     char local_str[255];
-    if (!tl_settings || !tl_settings->tl_stat.is_over_hard_limit || tl_settings->tl_stat.slot_left_hard_limit_warn)
+    if (!tl_settings || !DLT_TL_GET(tl_settings->tl_stat.is_over_hard_limit) || tl_settings->tl_stat.slot_left_hard_limit_warn)
     {
         /* No need to output warning message */
         return 0;
@@ -6565,9 +7239,9 @@ static int32_t dlt_output_hard_limit_warning(
 
     /* Calculate extra trace load which was over limit */
     const uint64_t dropped_message_load
-        = (tl_settings->tl_stat.hard_limit_over_bytes * DLT_TIMESTAMP_RESOLUTION)
+        = (DLT_TL_GET(tl_settings->tl_stat.hard_limit_over_bytes) * DLT_TIMESTAMP_RESOLUTION)
           / TIMESTAMP_BASED_WINDOW_SIZE;
-    const uint64_t curr_trace_load = tl_settings->tl_stat.avg_trace_load + dropped_message_load;
+    const uint64_t curr_trace_load = DLT_TL_GET(tl_settings->tl_stat.avg_trace_load) + dropped_message_load;
     if (curr_trace_load <= tl_settings->hard_limit) {
         /* No need to output warning message */
         return 0;
@@ -6580,7 +7254,7 @@ static int32_t dlt_output_hard_limit_warning(
                  tl_settings->apid,
                  tl_settings->hard_limit,
                  curr_trace_load,
-                 tl_settings->tl_stat.hard_limit_over_counter);
+                 DLT_TL_GET(tl_settings->tl_stat.hard_limit_over_counter));
     } else {
         snprintf(local_str, sizeof(local_str),
                  "Trace load exceeded trace hard limit on apid %.4s, ctid %.4s."
@@ -6589,7 +7263,7 @@ static int32_t dlt_output_hard_limit_warning(
                  tl_settings->ctid,
                  tl_settings->hard_limit,
                  curr_trace_load,
-                 tl_settings->tl_stat.hard_limit_over_counter);
+                 DLT_TL_GET(tl_settings->tl_stat.hard_limit_over_counter));
     }
 
     // must be signed int for error return
@@ -6602,15 +7276,24 @@ static int32_t dlt_output_hard_limit_warning(
     }
 
     /* Turn off the flag after sending warning message */
-    tl_settings->tl_stat.is_over_hard_limit = false;
-    tl_settings->tl_stat.hard_limit_over_counter = 0;
-    tl_settings->tl_stat.hard_limit_over_bytes = 0;
+    DLT_TL_SET(tl_settings->tl_stat.is_over_hard_limit, false);
+    DLT_TL_SET(tl_settings->tl_stat.hard_limit_over_counter, 0);
+    DLT_TL_SET(tl_settings->tl_stat.hard_limit_over_bytes, 0);
     tl_settings->tl_stat.slot_left_hard_limit_warn = DLT_HARD_LIMIT_WARN_FREQUENCY;
 
     return sent_size;
 }
 
-static bool dlt_user_cleanup_window(DltTraceLoadStat *const tl_stat)
+/* Drop the bytes of a slot which left the window */
+static inline void dlt_clear_trace_load_slot(DltTraceLoadStat *const tl_stat, const uint32_t slot)
+{
+    const uint64_t bytes = __atomic_exchange_n(&tl_stat->window[slot], 0, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&tl_stat->total_bytes_of_window, bytes, __ATOMIC_RELAXED);
+}
+
+static bool dlt_user_cleanup_window(DltTraceLoadStat *const tl_stat,
+                                    const uint32_t last_abs_slot,
+                                    const uint32_t curr_abs_slot)
 {
     if (!tl_stat)
     {
@@ -6619,23 +7302,23 @@ static bool dlt_user_cleanup_window(DltTraceLoadStat *const tl_stat)
 
     uint32_t elapsed_slots  = 0;
     /* check if overflow of timestamp happened, after ~119 hours */
-    if (tl_stat->curr_abs_slot < tl_stat->last_abs_slot) {
+    if (curr_abs_slot < last_abs_slot) {
         /* calculate where the next slot starts according to the last slot
          * This works because the value after the uint32 rollover equals is equal to the remainder that did not fit
          * into uint32 before. Therefore, we always have slots that are DLT_TIMESTAMP_RESOLUTION long
          * */
         const uint32_t next_slot_start =
-            DLT_TIMESTAMP_RESOLUTION + tl_stat->last_abs_slot;
+            DLT_TIMESTAMP_RESOLUTION + last_abs_slot;
 
         /* Check if we are already in the next slot */
-        if (next_slot_start <= tl_stat->curr_abs_slot) {
+        if (next_slot_start <= curr_abs_slot) {
             /* Calculate relative amount of elapsed slots */
-            elapsed_slots = (tl_stat->curr_abs_slot - next_slot_start) / DLT_TIMESTAMP_RESOLUTION + 1;
+            elapsed_slots = (curr_abs_slot - next_slot_start) / DLT_TIMESTAMP_RESOLUTION + 1;
         }
         /* else we are not in the next slot yet */
     } else {
         /* no rollover, get difference between slots to get amount of elapsed slots  */
-        elapsed_slots = (tl_stat->curr_abs_slot - tl_stat->last_abs_slot);
+        elapsed_slots = (curr_abs_slot - last_abs_slot);
     }
 
     if (!elapsed_slots)
@@ -6654,19 +7337,19 @@ static bool dlt_user_cleanup_window(DltTraceLoadStat *const tl_stat)
     /* Clear whole window when time elapsed longer than window size from last message */
     if (elapsed_slots >= DLT_TRACE_LOAD_WINDOW_SIZE)
     {
-        tl_stat->total_bytes_of_window = 0;
-        memset(tl_stat->window, 0, sizeof(tl_stat->window));
+        for (uint32_t slot = 0; slot < DLT_TRACE_LOAD_WINDOW_SIZE; slot++)
+            dlt_clear_trace_load_slot(tl_stat, slot);
         return true;
     }
 
     /* Clear skipped no data slots */
-    uint32_t temp_slot = tl_stat->last_slot;
-    while (temp_slot != tl_stat->curr_slot)
+    uint32_t temp_slot = last_abs_slot % DLT_TRACE_LOAD_WINDOW_SIZE;
+    const uint32_t curr_slot = curr_abs_slot % DLT_TRACE_LOAD_WINDOW_SIZE;
+    while (temp_slot != curr_slot)
     {
         temp_slot++;
         temp_slot %= DLT_TRACE_LOAD_WINDOW_SIZE;
-        tl_stat->total_bytes_of_window -= tl_stat->window[temp_slot];
-        tl_stat->window[temp_slot] = 0;
+        dlt_clear_trace_load_slot(tl_stat, temp_slot);
     }
 
     return true;
@@ -6676,19 +7359,44 @@ static int32_t dlt_switch_slot_if_needed(
     DltTraceLoadSettings* const tl_settings,
     DltLogInternal log_internal,
     void* const log_internal_params,
-    const uint32_t timestamp)
+    const uint32_t curr_abs_slot)
 {
     if (!tl_settings)
     {
         return 0;
     }
 
-    /* Get new window slot No. */
-    tl_settings->tl_stat.curr_abs_slot = timestamp / DLT_TRACE_LOAD_WINDOW_RESOLUTION;
-    tl_settings->tl_stat.curr_slot = tl_settings->tl_stat.curr_abs_slot % DLT_TRACE_LOAD_WINDOW_SIZE;
+    DltTraceLoadStat *const tl_stat = &tl_settings->tl_stat;
+    uint32_t last_abs_slot = __atomic_load_n(&tl_stat->last_abs_slot, __ATOMIC_ACQUIRE);
+
+    if (curr_abs_slot == last_abs_slot)
+    {
+        return 0;
+    }
+
+    /* A message of another thread which was stamped slightly earlier still
+     * belongs into the window, only a timestamp rollover moves it backwards.
+     */
+    if ((curr_abs_slot < last_abs_slot) && (last_abs_slot - curr_abs_slot < DLT_TRACE_LOAD_WINDOW_SIZE))
+    {
+        return 0;
+    }
+
+    /* Only the thread which moves the window forward cleans it up and
+     * outputs the warnings, all others just record their bytes.
+     */
+    if (!__atomic_compare_exchange_n(&tl_stat->last_abs_slot, &last_abs_slot, curr_abs_slot,
+                                     false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+
+    tl_stat->curr_abs_slot = curr_abs_slot;
+    tl_stat->curr_slot = curr_abs_slot % DLT_TRACE_LOAD_WINDOW_SIZE;
+    tl_stat->last_slot = tl_stat->curr_slot;
 
     /* Cleanup window */
-    if (!dlt_user_cleanup_window(&tl_settings->tl_stat))
+    if (!dlt_user_cleanup_window(tl_stat, last_abs_slot, curr_abs_slot))
     {
         /* No need to switch slot because same slot can be still used */
         return 0;
@@ -6704,38 +7412,39 @@ static int32_t dlt_switch_slot_if_needed(
     return sent_warn_msg_bytes;
 }
 
-static void dlt_record_trace_load(DltTraceLoadStat *const tl_stat, const int32_t size)
+static uint64_t dlt_record_trace_load(DltTraceLoadStat *const tl_stat, const uint32_t slot, const int32_t size)
 {
     if (!tl_stat)
     {
-        return;
+        return 0;
     }
 
     /* Record trace load to current slot by message size of
      * original message and warning message if it was sent
      */
-    tl_stat->window[tl_stat->curr_slot] += size;
-    tl_stat->total_bytes_of_window += size;
-
-    /* Keep the latest time information */
-    tl_stat->last_abs_slot = tl_stat->curr_abs_slot;
-    tl_stat->last_slot = tl_stat->curr_slot;
+    __atomic_add_fetch(&tl_stat->window[slot], (uint64_t)size, __ATOMIC_RELAXED);
+    const uint64_t total_bytes_of_window =
+        __atomic_add_fetch(&tl_stat->total_bytes_of_window, (uint64_t)size, __ATOMIC_RELAXED);
 
     /* Calculate average trace load [bytes/sec] in window
      * The division is necessary to normalize the average to bytes per second even if
      * the slot size is not equal to 1s
      * */
-    tl_stat->avg_trace_load
-        = (tl_stat->total_bytes_of_window * DLT_TIMESTAMP_RESOLUTION) / TIMESTAMP_BASED_WINDOW_SIZE;
+    const uint64_t avg_trace_load
+        = (total_bytes_of_window * DLT_TIMESTAMP_RESOLUTION) / TIMESTAMP_BASED_WINDOW_SIZE;
+    DLT_TL_SET(tl_stat->avg_trace_load, avg_trace_load);
+
+    return avg_trace_load;
 }
 
-static inline bool dlt_is_over_trace_load_soft_limit(DltTraceLoadSettings* const tl_settings)
+static inline bool dlt_is_over_trace_load_soft_limit(DltTraceLoadSettings* const tl_settings,
+                                                     const uint64_t avg_trace_load)
 {
     if (tl_settings
-        && (tl_settings->tl_stat.avg_trace_load > tl_settings->soft_limit || tl_settings->soft_limit == 0))
+        && (avg_trace_load > tl_settings->soft_limit || tl_settings->soft_limit == 0))
     {
         /* Mark as soft limit over */
-        tl_settings->tl_stat.is_over_soft_limit = true;
+        DLT_TL_SET(tl_settings->tl_stat.is_over_soft_limit, true);
         return true;
     }
 
@@ -6743,20 +7452,21 @@ static inline bool dlt_is_over_trace_load_soft_limit(DltTraceLoadSettings* const
 }
 
 static inline bool dlt_is_over_trace_load_hard_limit(
-    DltTraceLoadSettings* const tl_settings, const int size)
+    DltTraceLoadSettings* const tl_settings, const uint64_t avg_trace_load,
+    const uint32_t slot, const int size)
 {
     if (tl_settings
-        && (tl_settings->tl_stat.avg_trace_load > tl_settings->hard_limit
+        && (avg_trace_load > tl_settings->hard_limit
             || tl_settings->hard_limit == 0))
     {
         /* Mark as limit over */
-        tl_settings->tl_stat.is_over_hard_limit = true;
-        tl_settings->tl_stat.hard_limit_over_counter++;
-        tl_settings->tl_stat.hard_limit_over_bytes += size;
+        DLT_TL_SET(tl_settings->tl_stat.is_over_hard_limit, true);
+        __atomic_add_fetch(&tl_settings->tl_stat.hard_limit_over_counter, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&tl_settings->tl_stat.hard_limit_over_bytes, (uint32_t)size, __ATOMIC_RELAXED);
 
         /* Delete size of limit over message from window */
-        tl_settings->tl_stat.window[tl_settings->tl_stat.curr_slot] -= size;
-        tl_settings->tl_stat.total_bytes_of_window -= size;
+        __atomic_sub_fetch(&tl_settings->tl_stat.window[slot], (uint64_t)size, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&tl_settings->tl_stat.total_bytes_of_window, (uint64_t)size, __ATOMIC_RELAXED);
         return true;
     }
 
@@ -6789,26 +7499,32 @@ bool dlt_check_trace_load(
         return false;
     }
 
+    /* Get new window slot No. */
+    const uint32_t curr_abs_slot = timestamp / DLT_TRACE_LOAD_WINDOW_RESOLUTION;
+    const uint32_t curr_slot = curr_abs_slot % DLT_TRACE_LOAD_WINDOW_SIZE;
+
     /* Switch window slot according to timestamp
      * If warning messages for hard/soft limit over are sent,
      * the message size will be returned.
      */
     const int32_t sent_warn_msg_bytes = dlt_switch_slot_if_needed(
-        tl_settings, internal_dlt_log, internal_dlt_log_params, timestamp);
+        tl_settings, internal_dlt_log, internal_dlt_log_params, curr_abs_slot);
 
     /* Record trace load */
-    dlt_record_trace_load(&tl_settings->tl_stat, size + sent_warn_msg_bytes);
+    const uint64_t avg_trace_load =
+        dlt_record_trace_load(&tl_settings->tl_stat, curr_slot, size + sent_warn_msg_bytes);
 
     /* Check if trace load is over the soft limit.
      * Even if trace load is over the soft limit, message will not be discarded.
      * Only the warning message will be output
      */
-    dlt_is_over_trace_load_soft_limit(tl_settings);
+    dlt_is_over_trace_load_soft_limit(tl_settings, avg_trace_load);
 
     /* Check if trace load is over hard limit.
      * If trace load is over the limit, message will be discarded.
      */
-    const bool allow_output = !dlt_is_over_trace_load_hard_limit(tl_settings, size);
+    const bool allow_output =
+        !dlt_is_over_trace_load_hard_limit(tl_settings, avg_trace_load, curr_slot, size);
 
     return allow_output;
 }
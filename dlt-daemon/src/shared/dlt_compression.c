@@ -0,0 +1,223 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_compression.c
+ * Stream compression of client connections, negotiated with
+ * DLT_SERVICE_ID_SET_CLIENT_COMPRESSION. The daemon compresses the data sent
+ * to the client, the client decompresses it before parsing messages.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#ifdef DLT_STREAM_COMPRESSION
+#define ZLIB_CONST
+#include <zlib.h>
+#endif
+
+#include "dlt_compression.h"
+#include "dlt_log.h"
+
+#ifdef DLT_STREAM_COMPRESSION
+
+/* Raw deflate: no zlib header, the dictionary is known to both sides */
+#define DLT_COMPRESSION_WINDOW_BITS (-15)
+#define DLT_COMPRESSION_MEM_LEVEL 8
+
+/*
+ * Headers of typical verbose log messages, the most frequent last. Generated
+ * by util/dlt-compression-dict-gen.py from tests/testfile.dlt,
+ * tests/testfile_extended.dlt and a trace of dlt-example-user. It must not
+ * change: daemon and clients have to use the same dictionary.
+ */
+static const uint8_t dlt_compression_dictionary[] = {
+    0x41, 0x00, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x33, 0x41, 0x00,
+    0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x31, 0x41, 0x06, 0x4c, 0x4f,
+    0x47, 0x00, 0x54, 0x45, 0x53, 0x33, 0x23, 0x00, 0x00, 0x00, 0x41, 0x05,
+    0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x33, 0x23, 0x00, 0x00, 0x00,
+    0x41, 0x04, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x33, 0x23, 0x00,
+    0x00, 0x00, 0x41, 0x03, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x33,
+    0x23, 0x00, 0x00, 0x00, 0x41, 0x02, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45,
+    0x53, 0x33, 0x23, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00,
+    0x54, 0x45, 0x53, 0x33, 0x23, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f,
+    0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x84, 0x00, 0x00, 0x00, 0x41, 0x01,
+    0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x83, 0x00, 0x00, 0x00,
+    0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x44, 0x00,
+    0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32,
+    0x42, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45,
+    0x53, 0x32, 0x41, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00,
+    0x54, 0x45, 0x53, 0x32, 0x24, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f,
+    0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x22, 0x00, 0x00, 0x00, 0x41, 0x01,
+    0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x21, 0x00, 0x00, 0x00,
+    0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x10, 0x00,
+    0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32,
+    0x00, 0x04, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45,
+    0x53, 0x31, 0x42, 0x00, 0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00,
+    0x54, 0x45, 0x53, 0x31, 0x00, 0x02, 0x00, 0x00, 0x31, 0x02, 0x41, 0x50,
+    0x50, 0x31, 0x43, 0x4f, 0x4e, 0x31, 0x23, 0x00, 0x00, 0x00, 0x41, 0x01,
+    0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x43, 0x00, 0x00, 0x00,
+    0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32, 0x23, 0x00,
+    0x00, 0x00, 0x41, 0x01, 0x4c, 0x4f, 0x47, 0x00, 0x54, 0x45, 0x53, 0x32,
+    0x00, 0x02, 0x00, 0x00, 0x45, 0x43, 0x55, 0x00, 0x41, 0x01, 0x44, 0x4c,
+    0x54, 0x44, 0x49, 0x4e, 0x54, 0x4d, 0x00, 0x02, 0x00, 0x00, 0x16, 0x01,
+    0x41, 0x50, 0x50, 0x00, 0x43, 0x4f, 0x4e, 0x00, 0x41, 0x02, 0x4c, 0x4f,
+    0x47, 0x00, 0x54, 0x45, 0x53, 0x34, 0x23, 0x00, 0x00, 0x00, 0x31, 0x02,
+    0x4e, 0x41, 0x56, 0x49, 0x54, 0x45, 0x53, 0x54, 0x23, 0x00, 0x00, 0x00,
+    0x31, 0x02, 0x44, 0x49, 0x41, 0x47, 0x43, 0x54, 0x58, 0x31, 0x23, 0x00,
+    0x00, 0x00, 0x31, 0x02, 0x41, 0x50, 0x50, 0x32, 0x54, 0x45, 0x53, 0x54,
+    0x23, 0x00, 0x00, 0x00, 0x31, 0x02, 0x41, 0x50, 0x50, 0x31, 0x54, 0x45,
+    0x53, 0x54, 0x23, 0x00, 0x00, 0x00, 0x45, 0x43, 0x55, 0x31,
+};
+
+struct DltCompression
+{
+    z_stream zstream;
+    bool compress;
+};
+
+DltCompression *dlt_compression_create(uint8_t method, bool compress)
+{
+    DltCompression *stream;
+    int ret;
+
+    if (method != DLT_COMPRESSION_DEFLATE)
+        return NULL;
+
+    stream = calloc(1, sizeof(DltCompression));
+
+    if (stream == NULL)
+        return NULL;
+
+    stream->compress = compress;
+
+    if (compress)
+        ret = deflateInit2(&stream->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                           DLT_COMPRESSION_WINDOW_BITS, DLT_COMPRESSION_MEM_LEVEL,
+                           Z_DEFAULT_STRATEGY);
+    else
+        ret = inflateInit2(&stream->zstream, DLT_COMPRESSION_WINDOW_BITS);
+
+    if (ret != Z_OK) {
+        dlt_vlog(LOG_ERR, "%s: zlib initialization failed: %d\n", __func__, ret);
+        free(stream);
+        return NULL;
+    }
+
+    /* raw streams take the dictionary right away */
+    if (compress)
+        ret = deflateSetDictionary(&stream->zstream, dlt_compression_dictionary,
+                                   sizeof(dlt_compression_dictionary));
+    else
+        ret = inflateSetDictionary(&stream->zstream, dlt_compression_dictionary,
+                                   sizeof(dlt_compression_dictionary));
+
+    if (ret != Z_OK) {
+        dlt_vlog(LOG_ERR, "%s: zlib dictionary not accepted: %d\n", __func__, ret);
+        dlt_compression_free(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+void dlt_compression_free(DltCompression *stream)
+{
+    if (stream == NULL)
+        return;
+
+    if (stream->compress)
+        deflateEnd(&stream->zstream);
+    else
+        inflateEnd(&stream->zstream);
+
+    free(stream);
+}
+
+DltReturnValue dlt_compression_process(DltCompression *stream,
+                                       const void *in,
+                                       size_t in_size,
+                                       void *out,
+                                       size_t out_size,
+                                       size_t *consumed,
+                                       size_t *produced,
+                                       bool flush)
+{
+    uInt avail_in = (in_size > UINT_MAX) ? UINT_MAX : (uInt)in_size;
+    uInt avail_out = (out_size > UINT_MAX) ? UINT_MAX : (uInt)out_size;
+    int ret;
+
+    if ((stream == NULL) || ((in == NULL) && (in_size > 0)) || (out == NULL) || (out_size == 0) ||
+        (consumed == NULL) || (produced == NULL))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    stream->zstream.next_in = in;
+    stream->zstream.avail_in = avail_in;
+    stream->zstream.next_out = out;
+    stream->zstream.avail_out = avail_out;
+
+    if (stream->compress)
+        ret = deflate(&stream->zstream, flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+    else
+        ret = inflate(&stream->zstream, Z_SYNC_FLUSH);
+
+    *consumed = avail_in - stream->zstream.avail_in;
+    *produced = avail_out - stream->zstream.avail_out;
+
+    /* Z_BUF_ERROR only tells that no progress was possible */
+    if ((ret != Z_OK) && (ret != Z_BUF_ERROR)) {
+        dlt_vlog(LOG_ERR, "%s: %s failed: %d\n", __func__, stream->compress ? "deflate" : "inflate", ret);
+        return DLT_RETURN_ERROR;
+    }
+
+    return DLT_RETURN_OK;
+}
+
+#else /* DLT_STREAM_COMPRESSION */
+
+DltCompression *dlt_compression_create(uint8_t method, bool compress)
+{
+    (void)method;
+    (void)compress;
+
+    return NULL;
+}
+
+void dlt_compression_free(DltCompression *stream)
+{
+    (void)stream;
+}
+
+DltReturnValue dlt_compression_process(DltCompression *stream,
+                                       const void *in,
+                                       size_t in_size,
+                                       void *out,
+                                       size_t out_size,
+                                       size_t *consumed,
+                                       size_t *produced,
+                                       bool flush)
+{
+    (void)stream;
+    (void)in;
+    (void)in_size;
+    (void)out;
+    (void)out_size;
+    (void)consumed;
+    (void)produced;
+    (void)flush;
+
+    return DLT_RETURN_ERROR;
+}
+
+#endif /* DLT_STREAM_COMPRESSION */
@@ -36,10 +36,46 @@
 #include <syslog.h>
 #include <errno.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/uio.h>
 
 #include "dlt_multiple_files.h"
 #include "dlt_common.h"
 #include "dlt_log.h"
+#include "dlt_storage_writer.h"
+
+/* Background work of a rotation, done in order by the worker thread */
+typedef enum
+{
+    MULTIPLE_FILES_JOB_PREALLOC = 0, /* prepare the spare file path, size bytes */
+    MULTIPLE_FILES_JOB_RENAME,       /* rename path to target */
+    MULTIPLE_FILES_JOB_UNLINK,       /* remove path */
+    MULTIPLE_FILES_JOB_MANIFEST      /* write data atomically to path */
+} MultipleFilesJobType;
+
+typedef struct MultipleFilesJob
+{
+    struct MultipleFilesJob *next;
+    MultipleFilesJobType type;
+    char path[PATH_MAX + 1];
+    char target[PATH_MAX + 1];
+    char *data;
+    size_t size;
+} MultipleFilesJob;
+
+struct MultipleFilesWorker
+{
+    pthread_t thread;
+    pid_t pid;                  /* process the thread runs in, it does not survive a fork */
+    bool running;
+    bool stop;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    MultipleFilesJob *first;
+    MultipleFilesJob *last;
+    int spare_fd;               /* preallocated next file, -1 if not ready */
+};
 
 unsigned int multiple_files_buffer_storage_dir_info(const char *path, const char *file_name,
                                                     char *newest, char *oldest)
@@ -149,24 +185,314 @@ unsigned int multiple_files_buffer_get_idx_of_log_file(char *file)
     return token != NULL ? (unsigned int)strtol(token, NULL, 10) : 0;
 }
 
-DltReturnValue multiple_files_buffer_create_new_file(MultipleFilesRingBuffer *files_buffer)
+static MultipleFilesSegment *multiple_files_buffer_segment(const MultipleFilesRingBuffer *files_buffer,
+                                                           const unsigned int pos)
 {
-    if (files_buffer == NULL) {
-        fprintf(stderr, "multiple files buffer not set\n");
-        return DLT_RETURN_ERROR;
+    return &files_buffer->segments[(files_buffer->segmentsFirst + pos) % files_buffer->segmentsCapacity];
+}
+
+static MultipleFilesSegment *multiple_files_buffer_newest(const MultipleFilesRingBuffer *files_buffer)
+{
+    if (files_buffer->segmentsCount == 0)
+        return NULL;
+
+    return multiple_files_buffer_segment(files_buffer, files_buffer->segmentsCount - 1);
+}
+
+static DltReturnValue multiple_files_buffer_push_segment(MultipleFilesRingBuffer *files_buffer,
+                                                         const char *name, const unsigned int idx,
+                                                         const time_t created, const ssize_t size)
+{
+    MultipleFilesSegment *segment;
+
+    if (files_buffer->segmentsCount == files_buffer->segmentsCapacity) {
+        unsigned int capacity = files_buffer->segmentsCapacity ? files_buffer->segmentsCapacity * 2 : 8;
+        MultipleFilesSegment *segments = malloc(capacity * sizeof(MultipleFilesSegment));
+        unsigned int i;
+
+        if (segments == NULL) {
+            fprintf(stderr, "multiple files manifest cannot be allocated\n");
+            return DLT_RETURN_ERROR;
+        }
+
+        for (i = 0; i < files_buffer->segmentsCount; i++)
+            segments[i] = *multiple_files_buffer_segment(files_buffer, i);
+
+        free(files_buffer->segments);
+        files_buffer->segments = segments;
+        files_buffer->segmentsFirst = 0;
+        files_buffer->segmentsCapacity = capacity;
     }
 
-    time_t t;
-    struct tm tmp;
-    char file_path[PATH_MAX + 1];
-    unsigned int idx = 0;
+    segment = multiple_files_buffer_segment(files_buffer, files_buffer->segmentsCount);
+    strncpy(segment->name, name, NAME_MAX);
+    segment->name[NAME_MAX] = '\0';
+    segment->idx = idx;
+    segment->created = created;
+    segment->size = size;
+    files_buffer->segmentsCount++;
+    files_buffer->totalSize += size;
+
+    return DLT_RETURN_OK;
+}
+
+static void multiple_files_buffer_pop_segment(MultipleFilesRingBuffer *files_buffer, MultipleFilesSegment *oldest)
+{
+    *oldest = *multiple_files_buffer_segment(files_buffer, 0);
+    files_buffer->segmentsFirst = (files_buffer->segmentsFirst + 1) % files_buffer->segmentsCapacity;
+    files_buffer->segmentsCount--;
+    files_buffer->totalSize -= oldest->size;
+}
+
+static int multiple_files_buffer_path(const MultipleFilesRingBuffer *files_buffer, const char *name,
+                                      const char *ext, char *path, size_t len)
+{
+    int ret = snprintf(path, len, "%s/%s%s", files_buffer->directory, name, ext);
+
+    if ((ret < 0) || ((size_t)ret >= len)) {
+        fprintf(stderr, "file path cannot be concatenated\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Serialize the manifest, the caller has to free the returned buffer */
+static char *multiple_files_buffer_manifest_data(const MultipleFilesRingBuffer *files_buffer, size_t *size)
+{
+    size_t capacity = 64 + (size_t)files_buffer->segmentsCount * (NAME_MAX + 64);
+    char *data = malloc(capacity);
+    size_t len = 0;
+    unsigned int i;
+
+    if (data == NULL)
+        return NULL;
+
+    len += (size_t)snprintf(data, capacity, "# DLT multiple files manifest v1\n");
+
+    for (i = 0; i < files_buffer->segmentsCount; i++) {
+        const MultipleFilesSegment *segment = multiple_files_buffer_segment(files_buffer, i);
+        len += (size_t)snprintf(data + len, capacity - len, "%u %lld %zd %s\n", segment->idx,
+                                (long long)segment->created, segment->size, segment->name);
+    }
+
+    *size = len;
+    return data;
+}
+
+/* Replace the manifest by writing a temporary file and renaming it */
+static int multiple_files_buffer_write_manifest(const char *path, const char *data, size_t size)
+{
+    char tmp_path[PATH_MAX + 1];
+    int fd;
     int ret = 0;
 
-    /* set filename */
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path))
+        return -1;
+
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    if (fd == -1) {
+        fprintf(stderr, "manifest %s cannot be created, error: %s\n", tmp_path, strerror(errno));
+        return -1;
+    }
+
+    if ((write(fd, data, size) != (ssize_t)size) || (fsync(fd) != 0))
+        ret = -1;
+
+    close(fd);
+
+    if ((ret == 0) && (rename(tmp_path, path) != 0))
+        ret = -1;
+
+    if (ret != 0) {
+        fprintf(stderr, "manifest %s cannot be written, error: %s\n", path, strerror(errno));
+        unlink(tmp_path);
+    }
+
+    return ret;
+}
+
+static void multiple_files_worker_run_job(struct MultipleFilesWorker *worker, const MultipleFilesJob *job)
+{
+    int fd;
+
+    switch (job->type) {
+    case MULTIPLE_FILES_JOB_PREALLOC:
+        pthread_mutex_lock(&worker->mutex);
+        fd = worker->spare_fd;
+        pthread_mutex_unlock(&worker->mutex);
+
+        if (fd != -1)
+            break;
+
+        fd = open(job->path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+        if (fd == -1) {
+            fprintf(stderr, "file %s cannot be preallocated, error: %s\n", job->path, strerror(errno));
+            break;
+        }
+
+#ifdef __linux__
+        /* reserve the blocks but keep the file empty for readers; not supported
+         * by every file system, the spare file is still useful without */
+        (void)fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)job->size);
+#endif
+        pthread_mutex_lock(&worker->mutex);
+        worker->spare_fd = fd;
+        pthread_mutex_unlock(&worker->mutex);
+        break;
+    case MULTIPLE_FILES_JOB_RENAME:
+        if (rename(job->path, job->target) != 0)
+            fprintf(stderr, "Rename of file %s to %s failed! error=%s\n", job->path, job->target, strerror(errno));
+        break;
+    case MULTIPLE_FILES_JOB_UNLINK:
+        if ((unlink(job->path) != 0) && (errno != ENOENT))
+            fprintf(stderr, "Remove file %s failed! error=%s\n", job->path, strerror(errno));
+        break;
+    case MULTIPLE_FILES_JOB_MANIFEST:
+        multiple_files_buffer_write_manifest(job->path, job->data, job->size);
+        break;
+    default:
+        break;
+    }
+}
+
+static void *multiple_files_worker_thread(void *arg)
+{
+    struct MultipleFilesWorker *worker = arg;
+    MultipleFilesJob *job;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    while (true) {
+        while ((worker->first == NULL) && !worker->stop)
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+
+        job = worker->first;
+
+        /* pending work is finished before stopping */
+        if (job == NULL)
+            break;
+
+        worker->first = job->next;
+
+        if (worker->first == NULL)
+            worker->last = NULL;
+
+        pthread_mutex_unlock(&worker->mutex);
+        multiple_files_worker_run_job(worker, job);
+        free(job->data);
+        free(job);
+        pthread_mutex_lock(&worker->mutex);
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+    return NULL;
+}
+
+/* Start the worker thread, again in a forked child (e.g. when the daemon
+ * daemonizes after opening its log files) */
+static void multiple_files_worker_ensure(struct MultipleFilesWorker *worker)
+{
+    if (worker->running && (worker->pid == getpid()))
+        return;
+
+    if (worker->running) {
+        /* the thread of the parent is gone, its locks may be left taken */
+        pthread_mutex_init(&worker->mutex, NULL);
+        pthread_cond_init(&worker->cond, NULL);
+    }
+
+    worker->stop = false;
+    worker->pid = getpid();
+    worker->running = (pthread_create(&worker->thread, NULL, multiple_files_worker_thread, worker) == 0);
+
+    if (!worker->running)
+        fprintf(stderr, "multiple files worker cannot be started, rotating synchronously\n");
+}
+
+/* Queue a job, or run it right away if there is no worker thread */
+static void multiple_files_worker_queue(struct MultipleFilesWorker *worker, MultipleFilesJobType type,
+                                        const char *path, const char *target, char *data, size_t size)
+{
+    MultipleFilesJob *job = calloc(1, sizeof(MultipleFilesJob));
+
+    if (job == NULL) {
+        fprintf(stderr, "multiple files job cannot be allocated\n");
+        free(data);
+        return;
+    }
+
+    job->type = type;
+    strncpy(job->path, path, PATH_MAX);
+
+    if (target != NULL)
+        strncpy(job->target, target, PATH_MAX);
+
+    job->data = data;
+    job->size = size;
+
+    multiple_files_worker_ensure(worker);
+
+    if (!worker->running) {
+        multiple_files_worker_run_job(worker, job);
+        free(job->data);
+        free(job);
+        return;
+    }
+
+    pthread_mutex_lock(&worker->mutex);
+
+    if (worker->last != NULL)
+        worker->last->next = job;
+    else
+        worker->first = job;
+
+    worker->last = job;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+}
+
+static void multiple_files_buffer_queue_manifest(MultipleFilesRingBuffer *files_buffer)
+{
+    char path[PATH_MAX + 1];
+    size_t size = 0;
+    char *data;
+
+    if (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_MANIFEST_EXT,
+                                   path, sizeof(path)) != 0)
+        return;
+
+    data = multiple_files_buffer_manifest_data(files_buffer, &size);
+
+    if (data != NULL)
+        multiple_files_worker_queue(files_buffer->worker, MULTIPLE_FILES_JOB_MANIFEST, path, NULL, data, size);
+}
+
+static void multiple_files_buffer_queue_prealloc(MultipleFilesRingBuffer *files_buffer)
+{
+    char path[PATH_MAX + 1];
+
+    if (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_PREALLOC_EXT,
+                                   path, sizeof(path)) == 0)
+        multiple_files_worker_queue(files_buffer->worker, MULTIPLE_FILES_JOB_PREALLOC, path, NULL, NULL,
+                                    (size_t)files_buffer->fileSize);
+}
+
+/* Name of the next file, empty if no new file can be started yet */
+static DltReturnValue multiple_files_buffer_next_name(MultipleFilesRingBuffer *files_buffer, unsigned int *idx)
+{
+    const MultipleFilesSegment *newest = multiple_files_buffer_newest(files_buffer);
+    int ret;
+
+    *idx = 0;
+
     if (files_buffer->filenameTimestampBased) {
         /* timestamp format: "yyyymmdd_hhmmss" */
         char timestamp[16];
-        t = time(NULL);
+        struct tm tmp;
+        time_t t = time(NULL);
         tzset();
         localtime_r(&t, &tmp);
 
@@ -177,46 +503,42 @@ DltReturnValue multiple_files_buffer_create_new_file(MultipleFilesRingBuffer *fi
                        MULTIPLE_FILES_FILENAME_TIMESTAMP_DELIM, timestamp,
                        files_buffer->filenameExt);
 
-        if ((ret < 0) || ((size_t)ret >= (int)sizeof(files_buffer->filename))) {
+        if ((ret < 0) || ((size_t)ret >= sizeof(files_buffer->filename))) {
             fprintf(stderr, "filename cannot be concatenated\n");
             return DLT_RETURN_ERROR;
         }
 
-        ret = snprintf(file_path, sizeof(file_path), "%s/%s",
-                       files_buffer->directory, files_buffer->filename);
-
-        if ((ret < 0) || ((size_t)ret >= (int)sizeof(file_path))) {
-            fprintf(stderr, "file path cannot be concatenated\n");
-            return DLT_RETURN_ERROR;
-        }
+        /* a file per second at most, the name would be taken */
+        if ((newest != NULL) && (strcmp(newest->name, files_buffer->filename) == 0))
+            files_buffer->filename[0] = '\0';
     }
     else {
-        char newest[NAME_MAX + 1] = { 0 };
-        char oldest[NAME_MAX + 1] = { 0 };
-        /* targeting newest file, ignoring number of files in dir returned */
-        if (0 == multiple_files_buffer_storage_dir_info(files_buffer->directory,
-                                                        files_buffer->filenameBase,
-                                                        newest,
-                                                        oldest)) {
-            printf("No multiple files found\n");
-        }
-
-        idx = multiple_files_buffer_get_idx_of_log_file(newest) + 1;
+        *idx = (newest != NULL) ? newest->idx + 1 : 1;
+        multiple_files_buffer_file_name(files_buffer, *idx);
+    }
 
-        multiple_files_buffer_file_name(files_buffer, idx);
-        ret = snprintf(file_path, sizeof(file_path), "%s/%s",
-                       files_buffer->directory, files_buffer->filename);
+    return DLT_RETURN_OK;
+}
 
-        if ((ret < 0) || (ret >= NAME_MAX)) {
-            fprintf(stderr, "filename cannot be concatenated\n");
-            return DLT_RETURN_ERROR;
-        }
+static DltReturnValue multiple_files_buffer_create_new_file(MultipleFilesRingBuffer *files_buffer)
+{
+    if (files_buffer == NULL) {
+        fprintf(stderr, "multiple files buffer not set\n");
+        return DLT_RETURN_ERROR;
     }
 
+    char file_path[PATH_MAX + 1];
+    unsigned int idx = 0;
+
+    if ((multiple_files_buffer_next_name(files_buffer, &idx) != DLT_RETURN_OK) ||
+        (files_buffer->filename[0] == '\0') ||
+        (multiple_files_buffer_path(files_buffer, files_buffer->filename, "", file_path, sizeof(file_path)) != 0))
+        return DLT_RETURN_ERROR;
+
     /* open DLT output file */
     errno = 0;
-    files_buffer->ohandle = open(file_path, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR |
-                                                                S_IRGRP | S_IROTH); /* mode: wb */
+    files_buffer->ohandle = open(file_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR |
+                                                                          S_IRGRP | S_IROTH); /* mode: wb */
 
     if (files_buffer->ohandle == -1) {
         /* file cannot be opened */
@@ -224,7 +546,7 @@ DltReturnValue multiple_files_buffer_create_new_file(MultipleFilesRingBuffer *fi
         return DLT_RETURN_ERROR;
     }
 
-    return DLT_RETURN_OK;
+    return multiple_files_buffer_push_segment(files_buffer, files_buffer->filename, idx, time(NULL), 0);
 }
 
 ssize_t multiple_files_buffer_get_total_size(const MultipleFilesRingBuffer *files_buffer)
@@ -234,121 +556,180 @@ ssize_t multiple_files_buffer_get_total_size(const MultipleFilesRingBuffer *file
         return -1;
     }
 
+    return files_buffer->totalSize;
+}
+
+static int multiple_files_buffer_compare_segments(const void *a, const void *b)
+{
+    const MultipleFilesSegment *sa = a;
+    const MultipleFilesSegment *sb = b;
+
+    if (sa->idx != sb->idx)
+        return (sa->idx > sb->idx) - (sa->idx < sb->idx);
+
+    if (sa->created != sb->created)
+        return (sa->created > sb->created) - (sa->created < sb->created);
+
+    return strcmp(sa->name, sb->name);
+}
+
+/* Take the order recorded in the manifest over the one guessed from the directory.
+ * Files listed in the manifest but gone from the directory are dropped, files not
+ * listed keep the index and time taken from the directory. */
+static void multiple_files_buffer_apply_manifest(MultipleFilesRingBuffer *files_buffer,
+                                                 MultipleFilesSegment *segments, const unsigned int count)
+{
+    char path[PATH_MAX + 1];
+    char line[NAME_MAX + 64];
+    char name[NAME_MAX + 1];
+    char format[32];
+    FILE *handle;
+    unsigned int i;
+
+    if (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_MANIFEST_EXT,
+                                   path, sizeof(path)) != 0)
+        return;
+
+    handle = fopen(path, "r");
+
+    if (handle == NULL)
+        return;
+
+    snprintf(format, sizeof(format), "%%u %%lld %%lld %%%ds", NAME_MAX);
+
+    while (fgets(line, sizeof(line), handle) != NULL) {
+        unsigned int idx = 0;
+        long long created = 0;
+        long long size = 0;
+
+        if ((line[0] == '#') || (sscanf(line, format, &idx, &created, &size, name) != 4))
+            continue;
+
+        for (i = 0; i < count; i++) {
+            if (strcmp(segments[i].name, name) == 0) {
+                segments[i].idx = idx;
+                segments[i].created = (time_t)created;
+                break;
+            }
+        }
+    }
+
+    fclose(handle);
+}
+
+/* Build the list of files from the directory, ordered as recorded in the manifest.
+ * The sizes are taken from the files themselves. */
+static DltReturnValue multiple_files_buffer_scan(MultipleFilesRingBuffer *files_buffer)
+{
     struct dirent *dp;
     char filename[PATH_MAX + 1];
-    ssize_t size = 0;
+    char manifest[NAME_MAX + sizeof(MULTIPLE_FILES_MANIFEST_EXT)];
+    char prealloc[NAME_MAX + sizeof(MULTIPLE_FILES_PREALLOC_EXT)];
     struct stat status;
+    MultipleFilesSegment *segments = NULL;
+    unsigned int count = 0;
+    unsigned int capacity = 0;
+    unsigned int i;
+
+    /* the manifest, its temporary copy and the spare file are no log files */
+    snprintf(manifest, sizeof(manifest), "%s%s", files_buffer->filenameBase, MULTIPLE_FILES_MANIFEST_EXT);
+    snprintf(prealloc, sizeof(prealloc), "%s%s", files_buffer->filenameBase, MULTIPLE_FILES_PREALLOC_EXT);
 
     /* go through all dlt files in directory */
     DIR *dir = opendir(files_buffer->directory);
     if (!dir) {
         fprintf(stderr, "directory %s cannot be opened, error=%s\n", files_buffer->directory, strerror(errno));
-        return -1;
+        return DLT_RETURN_ERROR;
     }
 
     while ((dp = readdir(dir)) != NULL) {
         // consider files matching with a specific base name and a particular extension
-        if (strstr(dp->d_name, files_buffer->filenameBase)  && strstr(dp->d_name, files_buffer->filenameExt)) {
-            int res = snprintf(filename, sizeof(filename), "%s/%s", files_buffer->directory, dp->d_name);
-
-            /* if the total length of the string is greater than the buffer, silently forget it. */
-            /* snprintf: a return value of size  or more means that the output was truncated */
-            /*           if an output error is encountered, a negative value is returned. */
-            if (((unsigned int)res < sizeof(filename)) && (res > 0)) {
-                errno = 0;
-                if (0 == stat(filename, &status))
-                    size += status.st_size;
-                else
-                    fprintf(stderr, "file %s cannot be stat-ed, error=%s\n", filename, strerror(errno));
+        if (!strstr(dp->d_name, files_buffer->filenameBase) || !strstr(dp->d_name, files_buffer->filenameExt))
+            continue;
+
+        if ((strncmp(dp->d_name, manifest, strlen(manifest)) == 0) ||
+            (strncmp(dp->d_name, prealloc, strlen(prealloc)) == 0))
+            continue;
+
+        int res = snprintf(filename, sizeof(filename), "%s/%s", files_buffer->directory, dp->d_name);
+
+        /* if the total length of the string is greater than the buffer, silently forget it. */
+        if (((unsigned int)res >= sizeof(filename)) || (res <= 0) || (strlen(dp->d_name) > NAME_MAX))
+            continue;
+
+        errno = 0;
+        if (0 != stat(filename, &status)) {
+            fprintf(stderr, "file %s cannot be stat-ed, error=%s\n", filename, strerror(errno));
+            continue;
+        }
+
+        if (count == capacity) {
+            MultipleFilesSegment *tmp;
+            capacity = capacity ? capacity * 2 : 16;
+            tmp = realloc(segments, capacity * sizeof(MultipleFilesSegment));
+
+            if (tmp == NULL) {
+                free(segments);
+                closedir(dir);
+                return DLT_RETURN_ERROR;
             }
+
+            segments = tmp;
         }
+
+        strcpy(segments[count].name, dp->d_name);
+        /* the index is parsed from a copy, the name is tokenized */
+        strcpy(filename, dp->d_name);
+        segments[count].idx = files_buffer->filenameTimestampBased ? 0 :
+            multiple_files_buffer_get_idx_of_log_file(filename);
+        segments[count].created = status.st_mtime;
+        segments[count].size = (ssize_t)status.st_size;
+        count++;
     }
 
     closedir(dir);
 
-    /* return size */
-    return size;
-}
+    multiple_files_buffer_apply_manifest(files_buffer, segments, count);
 
-int multiple_files_buffer_delete_oldest_file(MultipleFilesRingBuffer *files_buffer)
-{
-    if (files_buffer == NULL) {
-        fprintf(stderr, "multiple files buffer not set\n");
-        return -1;  /* ERROR */
-    }
+    qsort(segments, count, sizeof(MultipleFilesSegment), multiple_files_buffer_compare_segments);
 
-    struct dirent *dp;
-    char filename[PATH_MAX + 1];
-    char filename_oldest[PATH_MAX + 1];
-    unsigned long size_oldest = 0;
-    struct stat status;
-    time_t time_oldest = 0;
-    int index_oldest = INT_MAX;
+    for (i = 0; i < count; i++)
+        if (multiple_files_buffer_push_segment(files_buffer, segments[i].name, segments[i].idx,
+                                               segments[i].created, segments[i].size) != DLT_RETURN_OK)
+            break;
 
-    filename[0] = 0;
-    filename_oldest[0] = 0;
+    free(segments);
+    return DLT_RETURN_OK;
+}
 
-    /* go through all dlt files in directory */
-    DIR *dir = opendir(files_buffer->directory);
+/* Remove the oldest files until a new file fits, returns the number of files removed */
+static unsigned int multiple_files_buffer_drop_oldest(MultipleFilesRingBuffer *files_buffer, const bool queue)
+{
+    MultipleFilesSegment oldest;
+    char path[PATH_MAX + 1];
+    unsigned int removed = 0;
 
-    if(!dir)
-        return -1;
+    /* remove the oldest files as long as new file will not fit in completely into complete multiple files buffer */
+    while ((files_buffer->segmentsCount > 0) &&
+           (files_buffer->totalSize > (files_buffer->maxSize - files_buffer->fileSize))) {
+        multiple_files_buffer_pop_segment(files_buffer, &oldest);
+        removed++;
 
-    while ((dp = readdir(dir)) != NULL) {
-        if (strstr(dp->d_name, files_buffer->filenameBase) && strstr(dp->d_name, files_buffer->filenameExt)) {
-            int res = snprintf(filename, sizeof(filename), "%s/%s", files_buffer->directory, dp->d_name);
-
-            /* if the total length of the string is greater than the buffer, silently forget it. */
-            /* snprintf: a return value of size  or more means that the output was truncated */
-            /*           if an output error is encountered, a negative value is returned. */
-            if (((unsigned int) res >= sizeof(filename)) || (res <= 0)) {
-                printf("Filename for delete oldest too long. Skip file.\n");
-                continue;
-            }
+        if (multiple_files_buffer_path(files_buffer, oldest.name, "", path, sizeof(path)) != 0)
+            continue;
 
-            if (files_buffer->filenameTimestampBased) {
-                errno = 0;
-                if (0 == stat(filename, &status)) {
-                    if ((time_oldest == 0) || (status.st_mtime < time_oldest)) {
-                        time_oldest = status.st_mtime;
-                        size_oldest = (unsigned long)status.st_size;
-                        strncpy(filename_oldest, filename, PATH_MAX);
-                        filename_oldest[PATH_MAX] = 0;
-                    }
-                } else {
-                    printf("Old file %s cannot be stat-ed, error=%s\n", filename, strerror(errno));
-                }
-            } else {
-                //index based
-                const unsigned int index = multiple_files_buffer_get_idx_of_log_file(filename);
-                if (index < (unsigned int)index_oldest) {
-                    index_oldest = (int)index;
-                    snprintf(filename, sizeof(filename), "%s/%s", files_buffer->directory, dp->d_name);
-                    strncpy(filename_oldest, filename, PATH_MAX);
-                    filename_oldest[PATH_MAX] = 0;
-                }
-            }
+        if (queue) {
+            multiple_files_worker_queue(files_buffer->worker, MULTIPLE_FILES_JOB_UNLINK, path, NULL, NULL, 0);
         }
-    }
-
-    closedir(dir);
-
-    /* delete file */
-    if (filename_oldest[0]) {
-        if (remove(filename_oldest)) {
-            fprintf(stderr, "Remove file %s failed! error=%s\n", filename_oldest, strerror(errno));
-            return -1; /* ERROR */
+        else if ((remove(path) != 0) && (errno != ENOENT)) {
+            fprintf(stderr, "Remove file %s failed! error=%s\n", path, strerror(errno));
         }
-    } else {
-        fprintf(stderr, "No file to be removed!\n");
-        return -1; /* ERROR */
     }
 
-    /* return size of deleted file*/
-    return (int)size_oldest;
+    return removed;
 }
 
-DltReturnValue multiple_files_buffer_check_size(MultipleFilesRingBuffer *files_buffer)
+static DltReturnValue multiple_files_buffer_check_size(MultipleFilesRingBuffer *files_buffer)
 {
     if (files_buffer == NULL) {
         fprintf(stderr, "multiple files buffer not set\n");
@@ -369,46 +750,59 @@ DltReturnValue multiple_files_buffer_check_size(MultipleFilesRingBuffer *files_b
         return DLT_RETURN_ERROR;
     }
 
-    ssize_t total_size = 0;
+    /* files written behind our back are not in the manifest, they are counted as well */
+    if (multiple_files_buffer_scan(files_buffer) != DLT_RETURN_OK)
+        return DLT_RETURN_ERROR;
+
     /* check size of complete buffer file */
-    while ((total_size = multiple_files_buffer_get_total_size(files_buffer)) > (files_buffer->maxSize - files_buffer->fileSize)) {
-        /* remove the oldest files as long as new file will not fit in completely into complete multiple files buffer */
-        if (multiple_files_buffer_delete_oldest_file(files_buffer) < 0) return DLT_RETURN_ERROR;
-    }
+    multiple_files_buffer_drop_oldest(files_buffer, false);
 
-    return total_size == -1 ? DLT_RETURN_ERROR : DLT_RETURN_OK;
+    return DLT_RETURN_OK;
 }
 
-DltReturnValue multiple_files_buffer_open_file_for_append(MultipleFilesRingBuffer *files_buffer) {
+static DltReturnValue multiple_files_buffer_open_file_for_append(MultipleFilesRingBuffer *files_buffer) {
     if (files_buffer == NULL || files_buffer->filenameTimestampBased) return DLT_RETURN_ERROR;
 
-    char newest[NAME_MAX + 1] = {0};
-    char oldest[NAME_MAX + 1] = {0};
-    /* targeting the newest file, ignoring number of files in dir returned */
+    const MultipleFilesSegment *newest = multiple_files_buffer_newest(files_buffer);
 
-    if (0 == multiple_files_buffer_storage_dir_info(files_buffer->directory,
-                                                   files_buffer->filenameBase, newest, oldest) ) {
+    if (newest == NULL) {
         // no file for appending found. Create a new one
         printf("No multiple files for appending found. Create a new one\n");
         return multiple_files_buffer_create_new_file(files_buffer);
     }
 
     char file_path[PATH_MAX + 1];
-    int ret = snprintf(file_path, sizeof(file_path), "%s/%s",
-                         files_buffer->directory, newest);
 
-    if ((ret < 0) || (ret >= NAME_MAX)) {
-        fprintf(stderr, "filename cannot be concatenated\n");
+    if (multiple_files_buffer_path(files_buffer, newest->name, "", file_path, sizeof(file_path)) != 0)
         return DLT_RETURN_ERROR;
-    }
+
+    strncpy(files_buffer->filename, newest->name, NAME_MAX);
+    files_buffer->filename[NAME_MAX] = '\0';
 
     /* open DLT output file */
     errno = 0;
-    files_buffer->ohandle = open(file_path, O_WRONLY | O_APPEND); /* mode: wb */
+    files_buffer->ohandle = open(file_path, O_WRONLY); /* writes at the recorded size */
 
     return files_buffer->ohandle == -1 ? DLT_RETURN_ERROR : DLT_RETURN_OK;
 }
 
+static void multiple_files_buffer_release(MultipleFilesRingBuffer *files_buffer)
+{
+    free(files_buffer->segments);
+    files_buffer->segments = NULL;
+    files_buffer->segmentsFirst = 0;
+    files_buffer->segmentsCount = 0;
+    files_buffer->segmentsCapacity = 0;
+    files_buffer->totalSize = 0;
+
+    if (files_buffer->worker != NULL) {
+        pthread_mutex_destroy(&files_buffer->worker->mutex);
+        pthread_cond_destroy(&files_buffer->worker->cond);
+        free(files_buffer->worker);
+        files_buffer->worker = NULL;
+    }
+}
+
 DltReturnValue multiple_files_buffer_init(MultipleFilesRingBuffer *files_buffer,
                                           const char *directory,
                                           const int file_size,
@@ -433,31 +827,103 @@ DltReturnValue multiple_files_buffer_init(MultipleFilesRingBuffer *files_buffer,
     files_buffer->filenameBase[NAME_MAX] = 0;
     strncpy(files_buffer->filenameExt, filename_ext, NAME_MAX);
     files_buffer->filenameExt[NAME_MAX] = 0;
+    files_buffer->segments = NULL;
+    files_buffer->segmentsFirst = 0;
+    files_buffer->segmentsCount = 0;
+    files_buffer->segmentsCapacity = 0;
+    files_buffer->totalSize = 0;
+
+    files_buffer->worker = calloc(1, sizeof(struct MultipleFilesWorker));
+
+    if (files_buffer->worker == NULL) {
+        fprintf(stderr, "multiple files worker cannot be allocated\n");
+        return DLT_RETURN_ERROR;
+    }
+
+    files_buffer->worker->spare_fd = -1;
+    pthread_mutex_init(&files_buffer->worker->mutex, NULL);
+    pthread_cond_init(&files_buffer->worker->cond, NULL);
+
+    DltReturnValue ret = multiple_files_buffer_check_size(files_buffer);
+
+    if (ret != DLT_RETURN_ERROR)
+        ret = (!files_buffer->filenameTimestampBased && append)
+            ? multiple_files_buffer_open_file_for_append(files_buffer)
+            : multiple_files_buffer_create_new_file(files_buffer);
+
+    if (ret == DLT_RETURN_ERROR) {
+        multiple_files_buffer_release(files_buffer);
+        return DLT_RETURN_ERROR;
+    }
 
-    if (DLT_RETURN_ERROR == multiple_files_buffer_check_size(files_buffer)) return DLT_RETURN_ERROR;
+    /* prepare the first rotation */
+    multiple_files_buffer_queue_manifest(files_buffer);
+    multiple_files_buffer_queue_prealloc(files_buffer);
 
-    return (!files_buffer->filenameTimestampBased && append)
-        ? multiple_files_buffer_open_file_for_append(files_buffer)
-        : multiple_files_buffer_create_new_file(files_buffer);
+    return DLT_RETURN_OK;
 }
 
 void multiple_files_buffer_rotate_file(MultipleFilesRingBuffer *files_buffer, const int size)
 {
+    MultipleFilesSegment *current = multiple_files_buffer_newest(files_buffer);
+    struct MultipleFilesWorker *worker = files_buffer->worker;
+    char spare_path[PATH_MAX + 1];
+    char file_path[PATH_MAX + 1];
+    unsigned int idx = 0;
+    int spare_fd;
+
     /* check file size here */
-    if ((lseek(files_buffer->ohandle, 0, SEEK_CUR) + size) < files_buffer->fileSize) return;
+    if ((current == NULL) || (worker == NULL) || ((current->size + size) < files_buffer->fileSize)) return;
+
+    if ((multiple_files_buffer_next_name(files_buffer, &idx) != DLT_RETURN_OK) ||
+        (files_buffer->filename[0] == '\0')) {
+        /* keep writing the current file until a new name is available */
+        strncpy(files_buffer->filename, current->name, NAME_MAX);
+        return;
+    }
 
     /* close old file */
     close(files_buffer->ohandle);
     files_buffer->ohandle = -1;
 
     /* check complete files size, remove old logs if needed */
-    if (DLT_RETURN_ERROR == multiple_files_buffer_check_size(files_buffer)) return;
+    multiple_files_buffer_drop_oldest(files_buffer, true);
+
+    if (multiple_files_buffer_path(files_buffer, files_buffer->filename, "", file_path, sizeof(file_path)) != 0)
+        return;
+
+    pthread_mutex_lock(&worker->mutex);
+    spare_fd = worker->spare_fd;
+    worker->spare_fd = -1;
+    pthread_mutex_unlock(&worker->mutex);
+
+    if ((spare_fd != -1) &&
+        (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_PREALLOC_EXT,
+                                    spare_path, sizeof(spare_path)) == 0)) {
+        /* the spare file gets its name in the background, writes go to the open handle */
+        files_buffer->ohandle = spare_fd;
+        multiple_files_worker_queue(worker, MULTIPLE_FILES_JOB_RENAME, spare_path, file_path, NULL, 0);
+    }
+    else {
+        if (spare_fd != -1)
+            close(spare_fd);
 
-    /* create new file */
-    multiple_files_buffer_create_new_file(files_buffer);
+        /* the spare file was not ready in time */
+        files_buffer->ohandle = open(file_path, O_WRONLY | O_CREAT | O_TRUNC,
+                                     S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+        if (files_buffer->ohandle == -1) {
+            fprintf(stderr, "file %s cannot be created, error: %s\n", file_path, strerror(errno));
+            return;
+        }
+    }
+
+    multiple_files_buffer_push_segment(files_buffer, files_buffer->filename, idx, time(NULL), 0);
+    multiple_files_buffer_queue_manifest(files_buffer);
+    multiple_files_buffer_queue_prealloc(files_buffer);
 }
 
-DltReturnValue multiple_files_buffer_write_chunk(const MultipleFilesRingBuffer *files_buffer,
+DltReturnValue multiple_files_buffer_write_chunk(MultipleFilesRingBuffer *files_buffer,
                                                  const unsigned char *data,
                                                  const int size)
 {
@@ -466,11 +932,19 @@ DltReturnValue multiple_files_buffer_write_chunk(const MultipleFilesRingBuffer *
         return DLT_RETURN_ERROR;
     }
 
-    if (data && (files_buffer->ohandle >= 0)) {
-        if (write(files_buffer->ohandle, data, (size_t)size) != (ssize_t)size) {
+    MultipleFilesSegment *current = multiple_files_buffer_newest(files_buffer);
+
+    if (data && (size > 0) && (files_buffer->ohandle >= 0) && (current != NULL)) {
+        /* the offset is known from the manifest, the write may be queued */
+        struct iovec iov = { (void *)(uintptr_t)data, (size_t)size };
+
+        if (dlt_storage_writer_write(files_buffer->ohandle, (off_t)current->size, &iov, 1) != DLT_RETURN_OK) {
             fprintf(stderr, "file write failed!\n");
             return DLT_RETURN_ERROR;
         }
+
+        current->size += size;
+        files_buffer->totalSize += size;
     }
     return DLT_RETURN_OK;
 }
@@ -487,7 +961,7 @@ DltReturnValue multiple_files_buffer_write(MultipleFilesRingBuffer *files_buffer
     return multiple_files_buffer_write_chunk(files_buffer, data, size);
 }
 
-DltReturnValue multiple_files_buffer_free(const MultipleFilesRingBuffer *files_buffer)
+DltReturnValue multiple_files_buffer_free(MultipleFilesRingBuffer *files_buffer)
 {
     if (files_buffer == NULL) {
         fprintf(stderr, "multiple files buffer not set\n");
@@ -498,6 +972,45 @@ DltReturnValue multiple_files_buffer_free(const MultipleFilesRingBuffer *files_b
 
     /* close last used log file */
     close(files_buffer->ohandle);
+    files_buffer->ohandle = -1;
+
+    struct MultipleFilesWorker *worker = files_buffer->worker;
+
+    if (worker != NULL) {
+        char path[PATH_MAX + 1];
+        size_t size = 0;
+        char *data;
+
+        /* finish the pending rotations */
+        if (worker->running && (worker->pid == getpid())) {
+            pthread_mutex_lock(&worker->mutex);
+            worker->stop = true;
+            pthread_cond_signal(&worker->cond);
+            pthread_mutex_unlock(&worker->mutex);
+            pthread_join(worker->thread, NULL);
+        }
+
+        worker->running = false;
+
+        if ((worker->spare_fd != -1) &&
+            (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_PREALLOC_EXT,
+                                        path, sizeof(path)) == 0)) {
+            close(worker->spare_fd);
+            unlink(path);
+        }
+
+        /* the final sizes */
+        data = multiple_files_buffer_manifest_data(files_buffer, &size);
+
+        if ((data != NULL) &&
+            (multiple_files_buffer_path(files_buffer, files_buffer->filenameBase, MULTIPLE_FILES_MANIFEST_EXT,
+                                        path, sizeof(path)) == 0))
+            multiple_files_buffer_write_manifest(path, data, size);
+
+        free(data);
+    }
+
+    multiple_files_buffer_release(files_buffer);
 
     return DLT_RETURN_OK;
 }
@@ -65,7 +65,9 @@ const char *const dlt_user_service_names[] = {
     "DLT_SERVICE_ID_RESERVED",
     "DLT_SERVICE_ID_RESERVED",
     "DLT_SERVICE_ID_RESERVED",
-    "DLT_SERVICE_ID_RESERVED"
+    "DLT_SERVICE_ID_RESERVED",
+    "DLT_SERVICE_ID_SET_CLIENT_FILTER",
+    "DLT_SERVICE_ID_SET_CLIENT_COMPRESSION"
 };
 
 const char *dlt_get_service_name(unsigned int id)
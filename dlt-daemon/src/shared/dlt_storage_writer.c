@@ -0,0 +1,640 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file dlt_storage_writer.c
+ * Writer for logstorage and offline trace files. With io_uring the writes
+ * are queued and completed from the daemon event loop, otherwise they are
+ * done synchronously.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#ifdef DLT_STORAGE_WRITER_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "dlt_log.h"
+#include "dlt_storage_writer.h"
+
+static DltReturnValue dlt_storage_writer_write_sync(int fd, off_t offset, const struct iovec *iov, int iovcnt,
+                                                    size_t size)
+{
+    ssize_t ret = pwritev(fd, iov, iovcnt, offset);
+
+    if (ret < 0) {
+        dlt_vlog(LOG_ERR, "%s: failed to write file: %s\n", __func__, strerror(errno));
+        return DLT_RETURN_ERROR;
+    }
+
+    if ((size_t)ret != size) {
+        dlt_vlog(LOG_WARNING, "%s: wrote less data than specified\n", __func__);
+        return DLT_RETURN_ERROR;
+    }
+
+    return DLT_RETURN_OK;
+}
+
+static DltReturnValue dlt_storage_writer_close_sync(int fd, bool sync)
+{
+    /* some filesystem doesn't support fsync() */
+    if (sync && (fsync(fd) != 0) && (errno != ENOSYS) && (errno != EINVAL))
+        dlt_vlog(LOG_ERR, "%s: failed to sync file: %s\n", __func__, strerror(errno));
+
+    return (close(fd) == 0) ? DLT_RETURN_OK : DLT_RETURN_ERROR;
+}
+
+#ifdef DLT_STORAGE_WRITER_IO_URING
+
+/* user_data of requests without a buffer, writes use the slot index + 1 */
+#define DLT_STORAGE_WRITER_OP_FSYNC ((__u64)UINT64_MAX)
+#define DLT_STORAGE_WRITER_OP_CLOSE ((__u64)UINT64_MAX - 1)
+
+/* Failures noticed while the mutex is held. They are logged after it is
+ * released: logging may write dlt.log through this writer. */
+typedef struct
+{
+    unsigned int writes;
+    unsigned int syncs;
+    unsigned int closes;
+    int error;                  /* errno of the last failure */
+} DltStorageWriterErrors;
+
+/* A write in flight, kept to complete short writes */
+typedef struct
+{
+    int fd;                     /* own duplicate, the caller may close its descriptor */
+    off_t offset;
+    size_t size;
+} DltStorageWriterSlot;
+
+typedef struct
+{
+    int ring_fd;
+    int event_fd;
+    void *ring;                 /* SQ and CQ ring, mapped at once */
+    size_t ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int *sq_array;
+    unsigned int sq_mask;
+    unsigned int sq_entries;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int cq_mask;
+    unsigned int cq_entries;
+    struct io_uring_cqe *cqes;
+    bool fixed;                 /* buffers are registered */
+    unsigned char *buffers;
+    size_t slot_size;
+    DltStorageWriterSlot *slots;
+    unsigned int *free_slots;
+    unsigned int num_free;
+    unsigned int in_flight;
+} DltStorageWriterRing;
+
+static pthread_mutex_t dlt_storage_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DltStorageWriterRing *dlt_storage_ring = NULL;
+static DltStorageWriterErrors dlt_storage_writer_errors;
+
+/* Take the failures collected so far, called with the mutex held */
+static DltStorageWriterErrors dlt_storage_writer_take_errors(void)
+{
+    DltStorageWriterErrors errors = dlt_storage_writer_errors;
+
+    memset(&dlt_storage_writer_errors, 0, sizeof(dlt_storage_writer_errors));
+
+    return errors;
+}
+
+static void dlt_storage_writer_report(const DltStorageWriterErrors *errors)
+{
+    if (errors->writes > 0)
+        dlt_vlog(LOG_ERR, "Storage writer: %u writes failed: %s\n", errors->writes, strerror(errors->error));
+
+    if (errors->syncs > 0)
+        dlt_vlog(LOG_ERR, "Storage writer: %u file syncs failed: %s\n", errors->syncs, strerror(errors->error));
+
+    if (errors->closes > 0)
+        dlt_vlog(LOG_ERR, "Storage writer: %u file closes failed: %s\n", errors->closes, strerror(errors->error));
+}
+
+/* Release the mutex and log what went wrong meanwhile */
+static void dlt_storage_writer_unlock(void)
+{
+    DltStorageWriterErrors errors = dlt_storage_writer_take_errors();
+
+    pthread_mutex_unlock(&dlt_storage_writer_mutex);
+    dlt_storage_writer_report(&errors);
+}
+
+static int dlt_storage_writer_enter(int ring_fd, unsigned int to_submit, unsigned int min_complete,
+                                    unsigned int flags)
+{
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int dlt_storage_writer_register(int ring_fd, unsigned int opcode, void *arg, unsigned int nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+static void dlt_storage_writer_complete(DltStorageWriterRing *ring, __u64 user_data, __s32 res)
+{
+    DltStorageWriterSlot *slot;
+    unsigned int idx;
+
+    ring->in_flight--;
+
+    if (user_data == DLT_STORAGE_WRITER_OP_FSYNC) {
+        /* some filesystem doesn't support fsync() */
+        if ((res < 0) && (res != -ENOSYS) && (res != -EINVAL)) {
+            dlt_storage_writer_errors.syncs++;
+            dlt_storage_writer_errors.error = -res;
+        }
+
+        return;
+    }
+
+    if (user_data == DLT_STORAGE_WRITER_OP_CLOSE) {
+        if (res < 0) {
+            dlt_storage_writer_errors.closes++;
+            dlt_storage_writer_errors.error = -res;
+        }
+
+        return;
+    }
+
+    idx = (unsigned int)(user_data - 1);
+    slot = &ring->slots[idx];
+
+    if ((res >= 0) && ((size_t)res < slot->size)) {
+        /* rare for regular files, finish the rest right away */
+        size_t done = (size_t)res;
+        size_t rest = slot->size - done;
+
+        res = (pwrite(slot->fd, ring->buffers + (size_t)idx * ring->slot_size + done, rest,
+                      slot->offset + (off_t)done) == (ssize_t)rest) ? 0 : -EIO;
+    }
+
+    if (res < 0) {
+        dlt_storage_writer_errors.writes++;
+        dlt_storage_writer_errors.error = -res;
+    }
+
+    close(slot->fd);
+    slot->fd = -1;
+    ring->free_slots[ring->num_free++] = idx;
+}
+
+/* Reap completions, waiting for at least one if wait is set */
+static void dlt_storage_writer_reap(DltStorageWriterRing *ring, bool wait)
+{
+    unsigned int head;
+    unsigned int tail;
+
+    if (wait && (ring->in_flight > 0)) {
+        while ((dlt_storage_writer_enter(ring->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0) &&
+               (errno == EINTR))
+            ;
+    }
+
+    head = *ring->cq_head;
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+        dlt_storage_writer_complete(ring, cqe->user_data, cqe->res);
+        head++;
+    }
+
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+/* Get the next free SQE, it is submitted by dlt_storage_writer_submit() */
+static struct io_uring_sqe *dlt_storage_writer_get_sqe(DltStorageWriterRing *ring, unsigned int pending)
+{
+    unsigned int tail = *ring->sq_tail + pending;
+    unsigned int idx = tail & ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[idx] = idx;
+
+    return sqe;
+}
+
+static DltReturnValue dlt_storage_writer_submit(DltStorageWriterRing *ring, unsigned int count)
+{
+    int ret;
+
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + count, __ATOMIC_RELEASE);
+    ring->in_flight += count;
+
+    while (count > 0) {
+        ret = dlt_storage_writer_enter(ring->ring_fd, count, 0, 0);
+
+        if (ret >= 0) {
+            count -= (unsigned int)ret;
+        }
+        else if ((errno == EAGAIN) || (errno == EBUSY)) {
+            /* completion queue is full, make room */
+            dlt_storage_writer_reap(ring, true);
+        }
+        else if (errno != EINTR) {
+            dlt_storage_writer_errors.writes += count;
+            dlt_storage_writer_errors.error = errno;
+            return DLT_RETURN_ERROR;
+        }
+    }
+
+    return DLT_RETURN_OK;
+}
+
+/* Make room for count more requests in the submission and completion queue */
+static void dlt_storage_writer_reserve(DltStorageWriterRing *ring, unsigned int count)
+{
+    while ((ring->in_flight + count > ring->cq_entries) ||
+           (*ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) + count > ring->sq_entries))
+        dlt_storage_writer_reap(ring, true);
+}
+
+static bool dlt_storage_writer_supported(int ring_fd)
+{
+    const __u8 required[] = { IORING_OP_WRITE_FIXED, IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_CLOSE };
+    const unsigned int num_ops = 256;
+    struct io_uring_probe *probe;
+    bool supported = true;
+    size_t i;
+
+    probe = calloc(1, sizeof(*probe) + num_ops * sizeof(struct io_uring_probe_op));
+
+    if (probe == NULL)
+        return false;
+
+    if (dlt_storage_writer_register(ring_fd, IORING_REGISTER_PROBE, probe, num_ops) < 0) {
+        free(probe);
+        return false;
+    }
+
+    for (i = 0; i < sizeof(required); i++)
+        if ((required[i] > probe->last_op) || !(probe->ops[required[i]].flags & IO_URING_OP_SUPPORTED))
+            supported = false;
+
+    free(probe);
+    return supported;
+}
+
+static void dlt_storage_writer_ring_free(DltStorageWriterRing *ring)
+{
+    if (ring->sqes != NULL)
+        munmap(ring->sqes, ring->sqes_size);
+
+    if (ring->ring != NULL)
+        munmap(ring->ring, ring->ring_size);
+
+    if (ring->event_fd >= 0)
+        close(ring->event_fd);
+
+    if (ring->ring_fd >= 0)
+        close(ring->ring_fd);
+
+    free(ring->buffers);
+    free(ring->slots);
+    free(ring->free_slots);
+    free(ring);
+}
+
+static DltStorageWriterRing *dlt_storage_writer_ring_create(unsigned int entries, size_t slot_size)
+{
+    struct io_uring_params params;
+    DltStorageWriterRing *ring;
+    unsigned char *sq;
+    unsigned char *cq;
+    size_t sq_size;
+    size_t cq_size;
+    struct iovec buffers;
+    unsigned int i;
+
+    ring = calloc(1, sizeof(DltStorageWriterRing));
+
+    if (ring == NULL)
+        return NULL;
+
+    ring->event_fd = -1;
+    memset(&params, 0, sizeof(params));
+    ring->ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+
+    if (ring->ring_fd < 0) {
+        dlt_vlog(LOG_INFO, "%s: io_uring not available: %s\n", __func__, strerror(errno));
+        free(ring);
+        return NULL;
+    }
+
+    /* IORING_FEAT_NODROP keeps completions when the queue is full */
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP) ||
+        !dlt_storage_writer_supported(ring->ring_fd)) {
+        dlt_log(LOG_INFO, "io_uring of this kernel is too old for storage writes\n");
+        dlt_storage_writer_ring_free(ring);
+        return NULL;
+    }
+
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->ring_size = (sq_size > cq_size) ? sq_size : cq_size;
+    ring->ring = mmap(NULL, ring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->ring_fd, IORING_OFF_SQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->ring_fd, IORING_OFF_SQES);
+
+    if ((ring->ring == MAP_FAILED) || (ring->sqes == MAP_FAILED)) {
+        dlt_vlog(LOG_ERR, "%s: failed to map io_uring: %s\n", __func__, strerror(errno));
+        ring->ring = (ring->ring == MAP_FAILED) ? NULL : ring->ring;
+        ring->sqes = (ring->sqes == MAP_FAILED) ? NULL : ring->sqes;
+        dlt_storage_writer_ring_free(ring);
+        return NULL;
+    }
+
+    sq = ring->ring;
+    cq = ring->ring;
+    ring->sq_head = (unsigned int *)(void *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned int *)(void *)(sq + params.sq_off.tail);
+    ring->sq_array = (unsigned int *)(void *)(sq + params.sq_off.array);
+    ring->sq_mask = *(unsigned int *)(void *)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->cq_head = (unsigned int *)(void *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned int *)(void *)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned int *)(void *)(cq + params.cq_off.ring_mask);
+    ring->cq_entries = params.cq_entries;
+    ring->cqes = (struct io_uring_cqe *)(void *)(cq + params.cq_off.cqes);
+
+    ring->slot_size = slot_size;
+    ring->slots = calloc(entries, sizeof(DltStorageWriterSlot));
+    ring->free_slots = calloc(entries, sizeof(unsigned int));
+
+    if ((ring->slots == NULL) || (ring->free_slots == NULL) ||
+        (posix_memalign((void **)&ring->buffers, (size_t)sysconf(_SC_PAGESIZE), entries * slot_size) != 0)) {
+        ring->buffers = NULL;
+        dlt_storage_writer_ring_free(ring);
+        return NULL;
+    }
+
+    for (i = 0; i < entries; i++)
+        ring->free_slots[i] = entries - 1 - i;
+
+    ring->num_free = entries;
+
+    /* registered buffers spare the page pinning per write, they count
+     * against RLIMIT_MEMLOCK on older kernels: do without if refused */
+    buffers.iov_base = ring->buffers;
+    buffers.iov_len = entries * slot_size;
+    ring->fixed = (dlt_storage_writer_register(ring->ring_fd, IORING_REGISTER_BUFFERS, &buffers, 1) == 0);
+
+    ring->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if ((ring->event_fd < 0) ||
+        (dlt_storage_writer_register(ring->ring_fd, IORING_REGISTER_EVENTFD, &ring->event_fd, 1) < 0)) {
+        dlt_vlog(LOG_ERR, "%s: failed to register eventfd: %s\n", __func__, strerror(errno));
+        dlt_storage_writer_ring_free(ring);
+        return NULL;
+    }
+
+    return ring;
+}
+
+#endif /* DLT_STORAGE_WRITER_IO_URING */
+
+DltReturnValue dlt_storage_writer_init(unsigned int entries, size_t slot_size)
+{
+    if ((entries == 0) || (slot_size == 0))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    DltStorageWriterRing *ring;
+    bool fixed;
+
+    if (dlt_storage_writer_is_async())
+        return DLT_RETURN_OK;
+
+    ring = dlt_storage_writer_ring_create(entries, slot_size);
+
+    if (ring == NULL)
+        return DLT_RETURN_ERROR;
+
+    fixed = ring->fixed;
+
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+    dlt_storage_ring = ring;
+    pthread_mutex_unlock(&dlt_storage_writer_mutex);
+
+    dlt_vlog(LOG_INFO, "Storage writes through io_uring (%u entries%s)\n", entries,
+             fixed ? ", registered buffers" : "");
+
+    return DLT_RETURN_OK;
+#else
+    return DLT_RETURN_ERROR;
+#endif
+}
+
+void dlt_storage_writer_free(void)
+{
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+
+    if (dlt_storage_ring != NULL) {
+        while (dlt_storage_ring->in_flight > 0)
+            dlt_storage_writer_reap(dlt_storage_ring, true);
+
+        dlt_storage_writer_ring_free(dlt_storage_ring);
+        dlt_storage_ring = NULL;
+    }
+
+    dlt_storage_writer_unlock();
+#endif
+}
+
+bool dlt_storage_writer_is_async(void)
+{
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    bool ret;
+
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+    ret = (dlt_storage_ring != NULL);
+    pthread_mutex_unlock(&dlt_storage_writer_mutex);
+
+    return ret;
+#else
+    return false;
+#endif
+}
+
+int dlt_storage_writer_get_fd(void)
+{
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    int fd;
+
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+    fd = (dlt_storage_ring != NULL) ? dlt_storage_ring->event_fd : -1;
+    pthread_mutex_unlock(&dlt_storage_writer_mutex);
+
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+DltReturnValue dlt_storage_writer_write(int fd, off_t offset, const struct iovec *iov, int iovcnt)
+{
+    size_t size = 0;
+    int i;
+
+    if ((fd < 0) || (offset < 0) || (iov == NULL) || (iovcnt <= 0))
+        return DLT_RETURN_WRONG_PARAMETER;
+
+    for (i = 0; i < iovcnt; i++)
+        size += iov[i].iov_len;
+
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+
+    DltStorageWriterRing *ring = dlt_storage_ring;
+
+    /* the write keeps a duplicate of fd: once the caller closes fd, the
+     * number may be reused for another file before the write is done */
+    int file = ((ring != NULL) && (size <= ring->slot_size)) ? dup(fd) : -1;
+
+    if (file != -1) {
+        struct io_uring_sqe *sqe;
+        unsigned char *buffer;
+        unsigned int idx;
+        size_t pos = 0;
+        DltReturnValue ret;
+
+        dlt_storage_writer_reserve(ring, 1);
+
+        while (ring->num_free == 0)
+            dlt_storage_writer_reap(ring, true);
+
+        idx = ring->free_slots[--ring->num_free];
+        buffer = ring->buffers + (size_t)idx * ring->slot_size;
+
+        for (i = 0; i < iovcnt; i++) {
+            memcpy(buffer + pos, iov[i].iov_base, iov[i].iov_len);
+            pos += iov[i].iov_len;
+        }
+
+        ring->slots[idx].fd = file;
+        ring->slots[idx].offset = offset;
+        ring->slots[idx].size = size;
+
+        sqe = dlt_storage_writer_get_sqe(ring, 0);
+        sqe->opcode = ring->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = file;
+        sqe->addr = (__u64)(uintptr_t)buffer;
+        sqe->len = (__u32)size;
+        sqe->off = (__u64)offset;
+        sqe->buf_index = 0;
+        sqe->user_data = (__u64)idx + 1;
+
+        ret = dlt_storage_writer_submit(ring, 1);
+        dlt_storage_writer_unlock();
+
+        return ret;
+    }
+
+    dlt_storage_writer_unlock();
+#endif
+
+    return dlt_storage_writer_write_sync(fd, offset, iov, iovcnt, size);
+}
+
+DltReturnValue dlt_storage_writer_close(int fd, bool sync)
+{
+    if (fd < 0)
+        return DLT_RETURN_WRONG_PARAMETER;
+
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    /* writes in flight keep their own reference to the file, only a sync
+     * has to wait for them */
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+
+    DltStorageWriterRing *ring = dlt_storage_ring;
+
+    if ((ring != NULL) && sync) {
+        struct io_uring_sqe *sqe;
+        DltReturnValue ret;
+
+        dlt_storage_writer_reserve(ring, 2);
+
+        /* drain: start after all writes queued before; the close is hard
+         * linked, it runs even if the file system refuses fsync */
+        sqe = dlt_storage_writer_get_sqe(ring, 0);
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = fd;
+        sqe->flags = IOSQE_IO_DRAIN | IOSQE_IO_HARDLINK;
+        sqe->user_data = DLT_STORAGE_WRITER_OP_FSYNC;
+
+        sqe = dlt_storage_writer_get_sqe(ring, 1);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = fd;
+        sqe->user_data = DLT_STORAGE_WRITER_OP_CLOSE;
+
+        ret = dlt_storage_writer_submit(ring, 2);
+        dlt_storage_writer_unlock();
+
+        return ret;
+    }
+
+    dlt_storage_writer_unlock();
+#endif
+
+    return dlt_storage_writer_close_sync(fd, sync);
+}
+
+void dlt_storage_writer_handle_completions(void)
+{
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+
+    if (dlt_storage_ring != NULL)
+        dlt_storage_writer_reap(dlt_storage_ring, false);
+
+    dlt_storage_writer_unlock();
+#endif
+}
+
+void dlt_storage_writer_wait(void)
+{
+#ifdef DLT_STORAGE_WRITER_IO_URING
+    pthread_mutex_lock(&dlt_storage_writer_mutex);
+
+    if (dlt_storage_ring != NULL) {
+        while (dlt_storage_ring->in_flight > 0)
+            dlt_storage_writer_reap(dlt_storage_ring, true);
+    }
+
+    dlt_storage_writer_unlock();
+#endif
+}
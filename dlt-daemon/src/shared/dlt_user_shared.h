@@ -89,7 +89,7 @@ typedef struct
 {
     char apid[DLT_ID_SIZE];          /**< application id */
     pid_t pid;                       /**< process id of user application */
-    uint32_t description_length;     /**< length of description */
+    uint32_t description_length;     /**< length of description, including the NUL and flags following it */
 } DLT_PACKED DltUserControlMsgRegisterApplication;
 
 /**
@@ -184,6 +184,15 @@ typedef struct
     int32_t log_level_pos;          /**< offset in management structure on user-application side */
 } DLT_PACKED DltUserControlMsgLogLevel;
 
+/**
+ * This is the internal message content to exchange the log level information of several contexts of one
+ * application at once. It is followed by count DltUserControlMsgLogLevel entries.
+ */
+typedef struct
+{
+    uint32_t count;                 /**< number of DltUserControlMsgLogLevel entries following */
+} DLT_PACKED DltUserControlMsgLogLevelBatch;
+
 /**
  * This is the internal message content to exchange control msg injection information between application and daemon.
  */
@@ -91,10 +91,19 @@
 #define DLT_USER_MESSAGE_LOG_STATE 12
 #define DLT_USER_MESSAGE_MARKER 13
 #define DLT_USER_MESSAGE_TRACE_LOAD 14
+#define DLT_USER_MESSAGE_LOG_LEVEL_BATCH 15
 #define DLT_USER_MESSAGE_NOT_SUPPORTED 16
 
 /* Internal defined values */
 
+/* Maximum number of contexts in one DLT_USER_MESSAGE_LOG_LEVEL_BATCH message,
+ * a complete message must fit into the receive buffer of the user library */
+#define DLT_USER_LOG_LEVEL_BATCH_MAX 1024
+
+/* Flags of an application, sent by DLT_USER_MESSAGE_REGISTER_APPLICATION after
+ * the description and its terminating NUL. Older libraries send no flags. */
+#define DLT_USER_APP_FLAG_LOG_LEVEL_BATCH 0x00000001 /* accepts DLT_USER_MESSAGE_LOG_LEVEL_BATCH */
+
 /* must be different from DltLogLevelType */
 #define DLT_USER_LOG_LEVEL_NOT_SET    -2
 /* must be different from DltTraceStatusType */
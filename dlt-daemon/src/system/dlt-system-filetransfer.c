@@ -61,6 +61,9 @@
 #include <string.h>
 #include <inttypes.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include "dlt-system.h"
 #include "dlt.h"
@@ -71,10 +74,53 @@
 #   define INOTIFY_LEN (INOTIFY_SZ + NAME_MAX + 1)
 #endif
 #define Z_CHUNK_SZ 1024 * 128
+/* files are compressed in blocks of this size, each block into a gzip member of its own */
+#define Z_BLOCK_SZ (Z_CHUNK_SZ * 8)
+/* number of compressed blocks which may wait for being written, per worker */
+#define Z_BLOCKS_PER_WORKER 2
 #define COMPRESS_EXTENSION ".gz"
 #define SUBDIR_COMPRESS ".tocompress"
 #define SUBDIR_TOSEND ".tosend"
 
+/* One block of a file being compressed */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    int state;              /* 0 pending, 1 compressed, -1 failed */
+} ft_compress_block;
+
+/* Compression of one file, shared between the worker threads and the writer */
+typedef struct {
+    int src_fd;
+    int level;
+    off_t src_size;
+    uint64_t block_count;
+    uint64_t next_block;    /* next block to be picked up by a worker */
+    uint64_t written;       /* number of blocks written to the destination */
+    uint64_t slots;
+    ft_compress_block *slot; /* block n is kept in slot n % slots until written */
+    int error;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} ft_compress_job;
+
+/* Files waiting to be sent by the sender thread */
+typedef struct ft_send_entry {
+    char *filename;
+    struct ft_send_entry *next;
+} ft_send_entry;
+
+typedef struct {
+    FiletransferOptions const *opts;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    ft_send_entry *head;
+    ft_send_entry *tail;
+    int running;
+    bool stop; /* accessed atomically, it also cancels a running transfer */
+} ft_sender;
+
 
 /* From dlt_filetransfer */
 extern uint32_t getFileSerialNumber(const char *file, int *ok);
@@ -86,6 +132,11 @@ DLT_DECLARE_CONTEXT(filetransferContext)
 s_ft_inotify ino;
 #endif
 
+static ft_sender sender = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER
+};
+
 
 char *origin_name(char *src)
 {
@@ -130,62 +181,221 @@ char *unique_name(char *src)
 
 /**
  * Function which only calls the relevant part to transfer the payload
+ * Runs in the sender thread. The file stays in place if the transfer is
+ * aborted, it is sent again from the tosend directory on next startup.
  */
-
-void send_dumped_file(FiletransferOptions const *opts, char *dst_tosend)
+static void transfer_dumped_file(FiletransferOptions const *opts, char *dst_tosend)
 {
     /* check if a client is connected to the deamon. If not, try again in a second */
-    while (dlt_get_log_state() != 1)
+    while (dlt_get_log_state() != 1) {
+        if (__atomic_load_n(&sender.stop, __ATOMIC_ACQUIRE))
+            return;
+
         sleep(1);
+    }
 
     char *fn = origin_name(dst_tosend);
     DLT_LOG(dltsystem, DLT_LOG_DEBUG,
             DLT_STRING("dlt-system-filetransfer, sending dumped file:"), DLT_STRING(fn));
 
     if (dlt_user_log_file_header_alias(&filetransferContext, dst_tosend, fn) == 0) {
-        int pkgcount = dlt_user_log_file_packagesCount(&filetransferContext, dst_tosend);
-        int lastpkg = 0;
-        int success = 1;
-
-        while (lastpkg < pkgcount) {
-            int total = 2;
-            int used = 2;
-            dlt_user_check_buffer(&total, &used);
-
-            while ((total - used) < (total / 2)) {
-                struct timespec t;
-                t.tv_sec = 0;
-                t.tv_nsec = 1000000ul * opts->TimeoutBetweenLogs;
-                nanosleep(&t, NULL);
-                dlt_user_log_resend_buffer();
-                dlt_user_check_buffer(&total, &used);
-            }
+        /* packages are logged straight from a mapping of the file, waiting for buffer space in between */
+        if (dlt_user_log_file_data_mmap(&filetransferContext, dst_tosend, NULL, opts->TimeoutBetweenLogs,
+                                        &sender.stop) == 0)
+            dlt_user_log_file_end(&filetransferContext, dst_tosend, 1);
+    }
 
-            lastpkg++;
+    DLT_LOG(dltsystem, DLT_LOG_DEBUG,
+            DLT_STRING("dlt-system-filetransfer, sent dumped file"));
+}
 
-            if (dlt_user_log_file_data(&filetransferContext, dst_tosend, lastpkg, opts->TimeoutBetweenLogs) < 0) {
-                success = 0;
-                break;
-            }
+static void *sender_thread(void *arg)
+{
+    (void)arg;
+    ft_send_entry *entry;
+
+    pthread_mutex_lock(&sender.mutex);
+
+    while (!__atomic_load_n(&sender.stop, __ATOMIC_ACQUIRE)) {
+        if (sender.head == NULL) {
+            pthread_cond_wait(&sender.cond, &sender.mutex);
+            continue;
         }
 
-        if (success)
-            dlt_user_log_file_end(&filetransferContext, dst_tosend, 1);
+        entry = sender.head;
+        sender.head = entry->next;
+
+        if (sender.head == NULL)
+            sender.tail = NULL;
+
+        pthread_mutex_unlock(&sender.mutex);
+
+        transfer_dumped_file(sender.opts, entry->filename);
+        free(entry->filename);
+        free(entry);
+
+        pthread_mutex_lock(&sender.mutex);
     }
 
-    DLT_LOG(dltsystem, DLT_LOG_DEBUG,
-            DLT_STRING("dlt-system-filetransfer, sent dumped file"));
+    pthread_mutex_unlock(&sender.mutex);
+    return NULL;
+}
+
+/**
+ * Queue a file for the sender thread, so that the next file can be compressed
+ * while this one is sent. Sends the file directly if there is no sender thread.
+ */
+void send_dumped_file(FiletransferOptions const *opts, char *dst_tosend)
+{
+    ft_send_entry *entry;
+
+    if (!sender.running) {
+        transfer_dumped_file(opts, dst_tosend);
+        return;
+    }
+
+    entry = malloc(sizeof(ft_send_entry));
+    MALLOC_ASSERT(entry);
+    entry->filename = strdup(dst_tosend);
+    MALLOC_ASSERT(entry->filename);
+    entry->next = NULL;
+
+    pthread_mutex_lock(&sender.mutex);
+
+    if (sender.tail != NULL)
+        sender.tail->next = entry;
+    else
+        sender.head = entry;
+
+    sender.tail = entry;
+    pthread_cond_signal(&sender.cond);
+    pthread_mutex_unlock(&sender.mutex);
+}
+
+static int compress_read_block(ft_compress_job *job, uint64_t n, unsigned char *in, size_t *in_size)
+{
+    off_t offset = (off_t)(n * Z_BLOCK_SZ);
+    size_t len = Z_BLOCK_SZ;
+    size_t done = 0;
+    ssize_t r;
+
+    if (job->src_size - offset < (off_t)len)
+        len = (size_t)(job->src_size - offset);
+
+    while (done < len) {
+        r = pread(job->src_fd, in + done, len - done, offset + (off_t)done);
+
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        if (r == 0)
+            break;
+
+        done += (size_t)r;
+    }
+
+    *in_size = done;
+    return 0;
+}
+
+/* Compress one block into a complete gzip member */
+static int compress_block(ft_compress_job *job, uint64_t n, unsigned char *in, ft_compress_block *out)
+{
+    z_stream strm;
+    size_t in_size = 0;
+    uLong bound;
+
+    if (compress_read_block(job, n, in, &in_size) != 0)
+        return -1;
+
+    memset(&strm, 0, sizeof(strm));
+
+    /* 15 window bits + 16 selects the gzip wrapper */
+    if (deflateInit2(&strm, job->level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return -1;
+
+    bound = deflateBound(&strm, (uLong)in_size);
+    out->data = malloc(bound);
+    MALLOC_ASSERT(out->data);
+
+    strm.next_in = in;
+    strm.avail_in = (uInt)in_size;
+    strm.next_out = out->data;
+    strm.avail_out = (uInt)bound;
+
+    if (deflate(&strm, Z_FINISH) != Z_STREAM_END) {
+        deflateEnd(&strm);
+        free(out->data);
+        out->data = NULL;
+        return -1;
+    }
+
+    out->size = strm.total_out;
+    deflateEnd(&strm);
+    return 0;
+}
+
+static void *compress_worker(void *arg)
+{
+    ft_compress_job *job = (ft_compress_job *)arg;
+    ft_compress_block block;
+    unsigned char *in;
+    uint64_t n;
+    int ret;
+
+    in = malloc(Z_BLOCK_SZ);
+    MALLOC_ASSERT(in);
+
+    pthread_mutex_lock(&job->mutex);
+
+    for (;;) {
+        /* do not run ahead of the writer by more than the available slots */
+        while (!job->error && (job->next_block < job->block_count) &&
+               (job->next_block >= job->written + job->slots))
+            pthread_cond_wait(&job->cond, &job->mutex);
+
+        if (job->error || (job->next_block >= job->block_count))
+            break;
+
+        n = job->next_block++;
+        pthread_mutex_unlock(&job->mutex);
+
+        block.data = NULL;
+        block.size = 0;
+        ret = compress_block(job, n, in, &block);
+
+        pthread_mutex_lock(&job->mutex);
+        block.state = (ret == 0) ? 1 : -1;
+        job->slot[n % job->slots] = block;
+
+        if (ret != 0)
+            job->error = 1;
+
+        pthread_cond_broadcast(&job->cond);
+    }
+
+    pthread_mutex_unlock(&job->mutex);
+    free(in);
+    return NULL;
 }
 
 /**
  * compress file, delete the source file
  * modification: compress into subdirectory
  * File whis is compress will be deleted afterwards
+ * The file is split into blocks which are compressed in parallel by a pool of
+ * worker threads, each into an independent gzip member. The members are written
+ * in order, a concatenation of gzip members is a valid gzip file.
  *  @param src File to be sent
  *  @param dst destination where to compress the file
  * @param level of compression
+ * @param threads number of compression threads
  **/
-int compress_file_to(char *src, char *dst, int level)
+int compress_file_to(char *src, char *dst, int level, int threads)
 {
     DLT_LOG(dltsystem,
             DLT_LOG_DEBUG,
@@ -193,53 +403,118 @@ int compress_file_to(char *src, char *dst, int level)
             DLT_STRING(src),
             DLT_STRING("to:"),
             DLT_STRING(dst));
-    char *buf;
 
+    ft_compress_job job;
+    pthread_t *workers;
+    FILE *dst_file;
+    struct stat st;
+    int started = 0;
+    int write_error;
+    int i;
 
-    char dst_mode[8];
-    snprintf(dst_mode, 8, "wb%d", level);
+    memset(&job, 0, sizeof(job));
+    job.level = level;
 
-    gzFile dst_file;
-    FILE *src_file;
+    job.src_fd = open(src, O_RDONLY);
 
-    dst_file = gzopen(dst, dst_mode);
+    if (job.src_fd < 0)
+        return -1;
 
-    if (dst_file == Z_NULL)
+    if (fstat(job.src_fd, &st) != 0) {
+        close(job.src_fd);
+        return -1;
+    }
+
+    dst_file = fopen(dst, "wb");
 
+    if (dst_file == NULL) {
+        close(job.src_fd);
         return -1;
+    }
 
-    src_file = fopen(src, "r");
+    /* an empty file still needs one (empty) gzip member */
+    job.src_size = st.st_size;
+    job.block_count = ((uint64_t)st.st_size + Z_BLOCK_SZ - 1) / Z_BLOCK_SZ;
 
-    if (src_file == NULL) {
-        gzclose(dst_file);
+    if (job.block_count == 0)
+        job.block_count = 1;
 
-        return -1;
+    if (threads < 1)
+        threads = 1;
+
+    if ((uint64_t)threads > job.block_count)
+        threads = (int)job.block_count;
+
+    job.slots = (uint64_t)threads * Z_BLOCKS_PER_WORKER;
+    job.slot = calloc(job.slots, sizeof(ft_compress_block));
+    MALLOC_ASSERT(job.slot);
+    workers = malloc(sizeof(pthread_t) * (size_t)threads);
+    MALLOC_ASSERT(workers);
+
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.cond, NULL);
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i], NULL, compress_worker, &job) != 0)
+            break;
+
+        started++;
     }
 
-    buf = malloc(Z_CHUNK_SZ);
-    MALLOC_ASSERT(buf);
+    /* write the blocks in order as they get ready */
+    pthread_mutex_lock(&job.mutex);
 
-    while (!feof(src_file)) {
-        int read = fread(buf, 1, Z_CHUNK_SZ, src_file);
+    if (started == 0)
+        job.error = 1;
 
-        if (ferror(src_file)) {
-            free(buf);
+    while (!job.error && (job.written < job.block_count)) {
+        ft_compress_block *block = &job.slot[job.written % job.slots];
 
-            gzclose(dst_file);
-            fclose(src_file);
-            return -1;
+        if (block->state == 0) {
+            pthread_cond_wait(&job.cond, &job.mutex);
+            continue;
         }
 
-        gzwrite(dst_file, buf, read);
+        pthread_mutex_unlock(&job.mutex);
+
+        write_error = (fwrite(block->data, 1, block->size, dst_file) != block->size);
+        free(block->data);
+        block->data = NULL;
+        block->state = 0;
+
+        pthread_mutex_lock(&job.mutex);
+
+        if (write_error)
+            job.error = 1;
+
+        job.written++;
+        pthread_cond_broadcast(&job.cond);
+    }
+
+    pthread_cond_broadcast(&job.cond);
+    pthread_mutex_unlock(&job.mutex);
+
+    for (i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    for (uint64_t n = 0; n < job.slots; n++)
+        free(job.slot[n].data);
+
+    free(job.slot);
+    free(workers);
+    pthread_cond_destroy(&job.cond);
+    pthread_mutex_destroy(&job.mutex);
+    close(job.src_fd);
+
+    if ((fclose(dst_file) != 0) || job.error) {
+        DLT_LOG(dltsystem, DLT_LOG_ERROR,
+                DLT_STRING("dlt-system-filetransfer, failed to compress file:"), DLT_STRING(src));
+        return -1;
     }
 
     if (remove(src) < 0)
         DLT_LOG(dltsystem, DLT_LOG_WARN, DLT_STRING("Could not remove file"), DLT_STRING(src));
 
-    free(buf);
-    fclose(src_file);
-    gzclose(dst_file);
-
     return 0;
 }
 
@@ -313,7 +588,8 @@ int send_one(char *src, FiletransferOptions const *opts, int which)
         MALLOC_ASSERT(dst_tosend);
         snprintf(dst_tosend, len, "%s/%s/%s%s", fdir, SUBDIR_TOSEND, rn, COMPRESS_EXTENSION);
 
-        if (compress_file_to(dst_tocompress, dst_tosend, opts->CompressionLevel[which]) != 0) {
+        if (compress_file_to(dst_tocompress, dst_tosend, opts->CompressionLevel[which],
+                             opts->CompressionThreads) != 0) {
             free(rn);
             free(dst_tosend);
             free(dst_tocompress);
@@ -486,7 +762,8 @@ int flush_dir_compress(FiletransferOptions const *opts, int which, const char *c
             MALLOC_ASSERT(dst_tosend);
             snprintf(dst_tosend, len, "%s/%s%s", send_dir, dp->d_name, COMPRESS_EXTENSION);
 
-            if (compress_file_to(cd_filename, dst_tosend, opts->CompressionLevel[which]) != 0) {
+            if (compress_file_to(cd_filename, dst_tosend, opts->CompressionLevel[which],
+                                 opts->CompressionThreads) != 0) {
                 free(dst_tosend);
                 free(cd_filename);
                 closedir(dir);
@@ -610,6 +887,16 @@ int init_filetransfer_dirs(DltSystemConfiguration *config)
     DLT_LOG(dltsystem, DLT_LOG_DEBUG,
             DLT_STRING("dlt-system-filetransfer, initializing inotify on directories."));
     int i;
+    /* files are sent by a thread of their own, while the next one is compressed */
+    sender.opts = opts;
+    __atomic_store_n(&sender.stop, false, __ATOMIC_RELEASE);
+
+    if (pthread_create(&sender.thread, NULL, sender_thread, NULL) == 0)
+        sender.running = 1;
+    else
+        DLT_LOG(dltsystem, DLT_LOG_WARN,
+                DLT_STRING("dlt-system-filetransfer, failed to start sender thread, sending directly."));
+
 #ifdef linux
     ino.handle = inotify_init();
 
@@ -741,4 +1028,30 @@ int process_files(FiletransferOptions const *opts)
 void filetransfer_fd_handler(DltSystemConfiguration *config)
 {
     process_files(&(config->Filetransfer));
-}
\ No newline at end of file
+}
+
+void filetransfer_cleanup(void)
+{
+    ft_send_entry *entry;
+
+    if (!sender.running)
+        return;
+
+    /* stop a running transfer, pending files are sent on next startup */
+    pthread_mutex_lock(&sender.mutex);
+    __atomic_store_n(&sender.stop, true, __ATOMIC_RELEASE);
+    pthread_cond_signal(&sender.cond);
+    pthread_mutex_unlock(&sender.mutex);
+
+    pthread_join(sender.thread, NULL);
+    sender.running = 0;
+
+    while (sender.head != NULL) {
+        entry = sender.head;
+        sender.head = entry->next;
+        free(entry->filename);
+        free(entry);
+    }
+
+    sender.tail = NULL;
+}
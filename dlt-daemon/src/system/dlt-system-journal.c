@@ -49,6 +49,9 @@
 #include <netinet/in.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
 
 #include "dlt-system.h"
 
@@ -64,92 +67,166 @@
 #define DLT_SYSTEM_JOURNAL_ASCII_FIRST_VISIBLE_CHARACTER 31
 #define DLT_SYSTEM_JOURNAL_BOOT_ID_MAX_LENGTH 9 + 32 + 1
 
+/* maximum length of a journal cursor read from the cursor file */
+#define DLT_SYSTEM_JOURNAL_CURSOR_MAX_LENGTH 512
+
+/* fill level of the libdlt buffer (percent) at which forwarding is throttled,
+ * and the level it has to drain to before forwarding continues */
+#define DLT_SYSTEM_JOURNAL_BUFFER_HIGH_WATERMARK 50
+#define DLT_SYSTEM_JOURNAL_BUFFER_LOW_WATERMARK 25
+
+/* maximum time (ms) spent waiting for the buffer to drain per entry */
+#define DLT_SYSTEM_JOURNAL_BACKOFF_LIMIT 1000
+
 typedef struct
 {
     char real[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
     char monotonic[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
 } MessageTimestamp;
 
+/* fields read from each journal entry */
+typedef enum
+{
+    JOURNAL_FIELD_COMM = 0,
+    JOURNAL_FIELD_PID,
+    JOURNAL_FIELD_PRIORITY,
+    JOURNAL_FIELD_MESSAGE,
+    JOURNAL_FIELD_TRANSPORT,
+    JOURNAL_FIELD_SOURCE_REALTIME,
+    JOURNAL_FIELD_SOURCE_MONOTONIC,
+    JOURNAL_FIELD_COUNT
+} JournalField;
+
+typedef struct
+{
+    char comm[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+    char pid[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+    char priority[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+    char message[DLT_SYSTEM_JOURNAL_BUFFER_SIZE_BIG];
+    char transport[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+    char source_realtime[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+    char source_monotonic[DLT_SYSTEM_JOURNAL_BUFFER_SIZE];
+} JournalEntry;
+
+static const struct
+{
+    const char *name;   /* field name including '=' */
+    size_t length;      /* length of name */
+} journal_fields[JOURNAL_FIELD_COUNT] = {
+    { "_COMM=", 6 },
+    { "_PID=", 5 },
+    { "PRIORITY=", 9 },
+    { "MESSAGE=", 8 },
+    { "_TRANSPORT=", 11 },
+    { "_SOURCE_REALTIME_TIMESTAMP=", 27 },
+    { "_SOURCE_MONOTONIC_TIMESTAMP=", 28 }
+};
+
+/* systemd priorities with their DLT log level and payload text */
+static const struct
+{
+    DltLogLevelType loglevel;
+    const char *text;
+} journal_priorities[] = {
+    { DLT_LOG_FATAL, "Emergency:" },
+    { DLT_LOG_FATAL, "Alert:" },
+    { DLT_LOG_FATAL, "Critical:" },
+    { DLT_LOG_ERROR, "Error:" },
+    { DLT_LOG_WARN, "Warning:" },
+    { DLT_LOG_INFO, "Notice:" },
+    { DLT_LOG_INFO, "Informational:" },
+    { DLT_LOG_DEBUG, "Debug:" }
+};
+
+#define DLT_SYSTEM_JOURNAL_PRIORITY_COUNT (int)(sizeof(journal_priorities) / sizeof(journal_priorities[0]))
+
 DLT_IMPORT_CONTEXT(dltsystem)
 DLT_DECLARE_CONTEXT(journalContext)
 
-int journal_checkUserBufferForFreeSpace()
+/* returns the fill level of the libdlt user buffer in percent */
+static int journal_get_user_buffer_fill(void)
 {
-    int total_size, used_size;
+    int total_size = 0, used_size = 0;
 
-    dlt_user_check_buffer(&total_size, &used_size);
+    if ((dlt_user_check_buffer(&total_size, &used_size) < DLT_RETURN_OK) || (total_size <= 0))
+        return 0;
 
-    if ((total_size - used_size) < (total_size / 2))
-        return -1;
-
-    return 1;
+    return (int)(((int64_t)used_size * 100) / total_size);
 }
 
-int dlt_system_journal_get(sd_journal *j, char *target, const char *field, size_t max_size)
+/*
+ * Throttle forwarding while the libdlt buffer is filling up. Once the high
+ * watermark is reached, wait until the buffer drained to the low watermark.
+ * The wait is bounded, so that forwarding continues (and libdlt discards)
+ * if the daemon does not read at all.
+ */
+static void journal_wait_for_user_buffer(void)
 {
-    char *data;
-    size_t length;
-    int error_code;
-    size_t field_size;
-
-    /* pre check parameters */
-    if ((max_size < 1) || (target == 0) || (field == 0) || (j == 0))
-        return -1;
-
-    /* intialise empty target */
-    target[0] = 0;
-
-    /* get data from journal */
-    error_code = sd_journal_get_data(j, field, (const void **)&data, &length);
-
-    /* check if an error */
-    if (error_code)
-        return error_code;
+    if (journal_get_user_buffer_fill() < DLT_SYSTEM_JOURNAL_BUFFER_HIGH_WATERMARK)
+        return;
 
-    /* calculate field size */
-    field_size = strlen(field) + 1;
+    dlt_user_wait_buffer_space(100 - DLT_SYSTEM_JOURNAL_BUFFER_LOW_WATERMARK, DLT_SYSTEM_JOURNAL_BACKOFF_LIMIT);
+}
 
-    /*check length */
-    if (length < field_size)
-        return -1;
+/* copy the value of a journal field into a null terminated buffer, truncating if needed */
+static void dlt_system_journal_copy(char *target, size_t max_size, const char *data, size_t length)
+{
+    if (length >= max_size)
+        length = max_size - 1;
 
-    /* copy string */
-    if (max_size <= (length - field_size)) {
-        /* truncate */
-        strncpy(target, data + field_size, max_size - 1);
-        target[max_size - 1] = 0;
-    }
-    else {
-        /* full copy */
-        strncpy(target, data + field_size, length - field_size);
-        target[length - field_size] = 0;
+    memcpy(target, data, length);
+    target[length] = 0;
+}
 
+/*
+ * Read all fields needed for forwarding from the current journal entry with
+ * a single pass over its data. Missing fields are left empty.
+ */
+static void dlt_system_journal_read_entry(sd_journal *j, JournalEntry *entry)
+{
+    const void *data;
+    size_t length;
+    int i;
+    char *target[JOURNAL_FIELD_COUNT] = {
+        entry->comm, entry->pid, entry->priority, entry->message,
+        entry->transport, entry->source_realtime, entry->source_monotonic
+    };
+    size_t target_size[JOURNAL_FIELD_COUNT] = {
+        sizeof(entry->comm), sizeof(entry->pid), sizeof(entry->priority), sizeof(entry->message),
+        sizeof(entry->transport), sizeof(entry->source_realtime), sizeof(entry->source_monotonic)
+    };
+
+    for (i = 0; i < JOURNAL_FIELD_COUNT; i++)
+        target[i][0] = 0;
+
+    sd_journal_restart_data(j);
+
+    while (sd_journal_enumerate_data(j, &data, &length) > 0) {
+        for (i = 0; i < JOURNAL_FIELD_COUNT; i++) {
+            if ((length >= journal_fields[i].length) &&
+                (memcmp(data, journal_fields[i].name, journal_fields[i].length) == 0)) {
+                dlt_system_journal_copy(target[i], target_size[i],
+                                        (const char *)data + journal_fields[i].length,
+                                        length - journal_fields[i].length);
+                break;
+            }
+        }
     }
-
-    /* debug messages */
-    /*printf("%s = %s\n",field,target); */
-
-    /* Success */
-    return 0;
 }
 
-void dlt_system_journal_get_timestamp(sd_journal *journal, MessageTimestamp *timestamp)
+void dlt_system_journal_get_timestamp(sd_journal *journal, const JournalEntry *entry, MessageTimestamp *timestamp)
 {
     int ret = 0;
     time_t time_secs = 0;
     uint64_t time_usecs = 0;
     struct tm timeinfo;
 
-    char buffer_realtime[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 };
     char buffer_realtime_formatted[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 };
-    char buffer_monotime[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 };
 
     /* Try to get realtime from message source and if not successful try to get realtime from journal entry */
-    ret = dlt_system_journal_get(journal, buffer_realtime, "_SOURCE_REALTIME_TIMESTAMP", sizeof(buffer_realtime));
-
-    if ((ret == 0) && (strlen(buffer_realtime) > 0)) {
+    if (strlen(entry->source_realtime) > 0) {
         errno = 0;
-        time_usecs = strtoull(buffer_realtime, NULL, 10);
+        time_usecs = strtoull(entry->source_realtime, NULL, 10);
 
         if (errno != 0)
             time_usecs = 0;
@@ -165,7 +242,6 @@ void dlt_system_journal_get_timestamp(sd_journal *journal, MessageTimestamp *tim
     }
 
     time_secs = (time_t)(time_usecs / 1000000);
-    tzset();
     localtime_r(&time_secs, &timeinfo);
     strftime(buffer_realtime_formatted, sizeof(buffer_realtime_formatted), "%Y/%m/%d %H:%M:%S", &timeinfo);
 
@@ -173,11 +249,9 @@ void dlt_system_journal_get_timestamp(sd_journal *journal, MessageTimestamp *tim
              time_usecs % 1000000);
 
     /* Try to get monotonic time from message source and if not successful try to get monotonic time from journal entry */
-    ret = dlt_system_journal_get(journal, buffer_monotime, "_SOURCE_MONOTONIC_TIMESTAMP", sizeof(buffer_monotime));
-
-    if ((ret == 0) && (strlen(buffer_monotime) > 0)) {
+    if (strlen(entry->source_monotonic) > 0) {
         errno = 0;
-        time_usecs = strtoull(buffer_monotime, NULL, 10);
+        time_usecs = strtoull(entry->source_monotonic, NULL, 10);
 
         if (errno != 0)
             time_usecs = 0;
@@ -199,23 +273,113 @@ void dlt_system_journal_get_timestamp(sd_journal *journal, MessageTimestamp *tim
              time_usecs % 1000000);
 }
 
-void get_journal_msg(sd_journal *j, DltSystemConfiguration *config) 
-{   
+/* Store the cursor of the current entry, so that a restart continues behind it. */
+static void dlt_system_journal_save_cursor(sd_journal *j, const char *filename)
+{
+    char tmp_filename[PATH_MAX];
+    char *cursor = NULL;
+    FILE *file;
+    int r;
+
+    if (filename == NULL)
+        return;
+
+    r = sd_journal_get_cursor(j, &cursor);
+
+    if (r < 0)
+        return;
+
+    if (snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", filename) >= (int)sizeof(tmp_filename)) {
+        free(cursor);
+        return;
+    }
+
+    /* write to a temporary file and rename it, so the cursor file is never partially written */
+    file = fopen(tmp_filename, "w");
+
+    if (file == NULL) {
+        DLT_LOG(dltsystem, DLT_LOG_WARN,
+                DLT_STRING("dlt-system-journal cannot write cursor file:"), DLT_STRING(strerror(errno)));
+        free(cursor);
+        return;
+    }
+
+    r = fputs(cursor, file);
+
+    if ((fclose(file) != 0) || (r < 0) || (rename(tmp_filename, filename) != 0)) {
+        DLT_LOG(dltsystem, DLT_LOG_WARN,
+                DLT_STRING("dlt-system-journal cannot store cursor:"), DLT_STRING(strerror(errno)));
+        unlink(tmp_filename);
+    }
+
+    free(cursor);
+}
+
+/*
+ * Position the journal behind the entry stored in the cursor file.
+ * Returns 0 on success, a negative value if no cursor could be restored.
+ */
+static int dlt_system_journal_restore_cursor(sd_journal *j, const char *filename)
+{
+    char cursor[DLT_SYSTEM_JOURNAL_CURSOR_MAX_LENGTH];
+    FILE *file;
+    size_t length;
+    int r;
+
+    if ((j == NULL) || (filename == NULL))
+        return -1;
+
+    file = fopen(filename, "r");
+
+    if (file == NULL)
+        return -1;
+
+    length = fread(cursor, 1, sizeof(cursor) - 1, file);
+    fclose(file);
+
+    while ((length > 0) && ((cursor[length - 1] == '\n') || (cursor[length - 1] == '\r')))
+        length--;
+
+    cursor[length] = 0;
+
+    if (length == 0)
+        return -1;
+
+    r = sd_journal_seek_cursor(j, cursor);
+
+    if (r < 0) {
+        DLT_LOG(dltsystem, DLT_LOG_WARN,
+                DLT_STRING("dlt-system-journal failed to seek to cursor:"), DLT_STRING(strerror(-r)));
+        return r;
+    }
+
+    /* the entry of the cursor was already forwarded, continue behind it. If it
+     * is gone (e.g. rotated) the journal is on the next entry, which was not. */
+    r = sd_journal_next(j);
+
+    if ((r > 0) && (sd_journal_test_cursor(j, cursor) <= 0))
+        sd_journal_previous(j);
+
+    return 0;
+}
+
+void get_journal_msg(sd_journal *j, DltSystemConfiguration *config)
+{
     uint32_t ts;
     int r;
+    int unsaved = 0;
 
-    char buffer_process[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 },
-         buffer_priority[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 },
-         buffer_pid[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 },
-         buffer_comm[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 },
-         buffer_message[DLT_SYSTEM_JOURNAL_BUFFER_SIZE_BIG] = { 0 },
-         buffer_transport[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 };
+    char buffer_process[DLT_SYSTEM_JOURNAL_BUFFER_SIZE] = { 0 };
+    const char *priority_text;
 
+    JournalEntry entry;
     MessageTimestamp timestamp;
 
-    int loglevel, systemd_loglevel;
-    char *systemd_log_levels[] =
-    { "Emergency", "Alert", "Critical", "Error", "Warning", "Notice", "Informational", "Debug" };
+    DltLogLevelType loglevel;
+    int systemd_loglevel;
+
+    /* evaluate timezone once per batch instead of once per entry */
+    tzset();
 
     for(;;)
     {
@@ -227,6 +391,10 @@ void get_journal_msg(sd_journal *j, DltSystemConfiguration *config)
             return;
         }
         else if (r == 0) {
+            /* journal drained, checkpoint the last forwarded entry */
+            if (unsaved > 0)
+                dlt_system_journal_save_cursor(j, config->Journal.CursorFile);
+
             return;
         }
 
@@ -234,65 +402,37 @@ void get_journal_msg(sd_journal *j, DltSystemConfiguration *config)
         config->Journal.MessageReceived = 1;
         #endif
 
-        /* get all data from current journal entry */
-        dlt_system_journal_get_timestamp(j, &timestamp);
-
-        /* get data from journal entry, empty string if invalid fields */
-        dlt_system_journal_get(j, buffer_comm, "_COMM", sizeof(buffer_comm));
-        dlt_system_journal_get(j, buffer_pid, "_PID", sizeof(buffer_pid));
-        dlt_system_journal_get(j, buffer_priority, "PRIORITY", sizeof(buffer_priority));
-        dlt_system_journal_get(j, buffer_message, "MESSAGE", sizeof(buffer_message));
-        dlt_system_journal_get(j, buffer_transport, "_TRANSPORT", sizeof(buffer_transport));
+        /* get all data from current journal entry, empty string if invalid fields */
+        dlt_system_journal_read_entry(j, &entry);
+        dlt_system_journal_get_timestamp(j, &entry, &timestamp);
 
         /* prepare process string */
-        if (strcmp(buffer_transport, "kernel") == 0)
+        if (strcmp(entry.transport, "kernel") == 0)
             snprintf(buffer_process, DLT_SYSTEM_JOURNAL_BUFFER_SIZE, "kernel:");
         else
-            snprintf(buffer_process, DLT_SYSTEM_JOURNAL_BUFFER_SIZE, "%s[%s]:", buffer_comm, buffer_pid);
+            snprintf(buffer_process, DLT_SYSTEM_JOURNAL_BUFFER_SIZE, "%s[%s]:", entry.comm, entry.pid);
 
         /* map log level on demand */
         loglevel = DLT_LOG_INFO;
-        systemd_loglevel = atoi(buffer_priority);
-
-        if (config->Journal.MapLogLevels) {
-            /* Map log levels from journal to DLT */
-            switch (systemd_loglevel) {
-            case 0:     /* Emergency */
-            case 1:     /* Alert */
-            case 2:     /* Critical */
-                loglevel = DLT_LOG_FATAL;
-                break;
-            case 3:     /* Error */
-                loglevel = DLT_LOG_ERROR;
-                break;
-            case 4:     /* Warning */
-                loglevel = DLT_LOG_WARN;
-                break;
-            case 5:     /* Notice */
-            case 6:     /* Informational */
-                loglevel = DLT_LOG_INFO;
-                break;
-            case 7:     /* Debug */
-                loglevel = DLT_LOG_DEBUG;
-                break;
-            default:
-                loglevel = DLT_LOG_INFO;
-                break;
-            }
-        }
+        systemd_loglevel = atoi(entry.priority);
 
-        if ((systemd_loglevel >= 0) && (systemd_loglevel <= 7))
-            snprintf(buffer_priority, DLT_SYSTEM_JOURNAL_BUFFER_SIZE, "%s:", systemd_log_levels[systemd_loglevel]);
-        else
-            snprintf(buffer_priority, DLT_SYSTEM_JOURNAL_BUFFER_SIZE, "prio_unknown:");
+        if ((systemd_loglevel >= 0) && (systemd_loglevel < DLT_SYSTEM_JOURNAL_PRIORITY_COUNT)) {
+            if (config->Journal.MapLogLevels)
+                loglevel = journal_priorities[systemd_loglevel].loglevel;
+
+            priority_text = journal_priorities[systemd_loglevel].text;
+        }
+        else {
+            priority_text = "prio_unknown:";
+        }
 
         if (config->Journal.UseUptimeOnly == 1) {
             /* write log entry (uptime only, no timestamp) */
             DLT_LOG(journalContext, loglevel,
                         DLT_STRING(timestamp.monotonic),
                         DLT_STRING(buffer_process),
-                        DLT_STRING(buffer_priority),
-                        DLT_STRING(buffer_message)
+                        DLT_STRING(priority_text),
+                        DLT_STRING(entry.message)
                         );
         }
         else {
@@ -302,8 +442,8 @@ void get_journal_msg(sd_journal *j, DltSystemConfiguration *config)
                         DLT_STRING(timestamp.real),
                         DLT_STRING(timestamp.monotonic),
                         DLT_STRING(buffer_process),
-                        DLT_STRING(buffer_priority),
-                        DLT_STRING(buffer_message)
+                        DLT_STRING(priority_text),
+                        DLT_STRING(entry.message)
                         );
 
             }
@@ -313,21 +453,19 @@ void get_journal_msg(sd_journal *j, DltSystemConfiguration *config)
                 DLT_LOG_TS(journalContext, loglevel, ts,
                             DLT_STRING(timestamp.real),
                             DLT_STRING(buffer_process),
-                            DLT_STRING(buffer_priority),
-                            DLT_STRING(buffer_message)
+                            DLT_STRING(priority_text),
+                            DLT_STRING(entry.message)
                             );
             }
         }
 
-
-        if (journal_checkUserBufferForFreeSpace() == -1) {
-            /* buffer is nearly full */
-            /* wait 500ms for writing next entry */
-            struct timespec t;
-            t.tv_sec = 0;
-            t.tv_nsec = 1000000ul * 500;
-            nanosleep(&t, NULL);
+        /* checkpoint regularly while working through a large backlog */
+        if (++unsaved >= config->Journal.CursorInterval) {
+            dlt_system_journal_save_cursor(j, config->Journal.CursorFile);
+            unsaved = 0;
         }
+
+        journal_wait_for_user_buffer();
     }
 }
 
@@ -348,6 +486,10 @@ void register_journal_fd(sd_journal **j, struct pollfd *pollfd, int i,  DltSyste
         j_tmp = NULL;
     }
 
+    /* fields are truncated to the message buffer anyway, avoid decompressing more */
+    if (j_tmp != NULL)
+        sd_journal_set_data_threshold(j_tmp, DLT_SYSTEM_JOURNAL_BUFFER_SIZE_BIG);
+
     if (config->Journal.CurrentBoot) {
         /* show only current boot entries */
         r = sd_id128_get_boot(&boot_id);
@@ -368,7 +510,14 @@ void register_journal_fd(sd_journal **j, struct pollfd *pollfd, int i,  DltSyste
         }
     }
 
-    if (config->Journal.Follow) {
+    if ((j_tmp != NULL) && (config->Journal.CursorFile != NULL) &&
+        (dlt_system_journal_restore_cursor(j_tmp, config->Journal.CursorFile) == 0)) {
+        /* continue behind the last entry forwarded before the restart */
+        DLT_LOG(dltsystem, DLT_LOG_INFO,
+                DLT_STRING("dlt-system-journal resuming from cursor file"),
+                DLT_STRING(config->Journal.CursorFile));
+    }
+    else if (config->Journal.Follow) {
         /* show only last 10 entries and follow */
         r = sd_journal_seek_tail(j_tmp);
         if (r < 0) {
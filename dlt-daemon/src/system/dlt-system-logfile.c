@@ -45,18 +45,46 @@
 
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef linux
+#   include <sys/inotify.h>
+#endif
 #include "dlt-system.h"
 
 /* Modes of sending */
 #define SEND_MODE_OFF  0
 #define SEND_MODE_ONCE 1
 #define SEND_MODE_ON   2
+#define SEND_MODE_TAIL 3
+
+#define LOGFILE_LINE_MAX 1024
+
+#ifdef linux
+#   define LOGFILE_INOTIFY_MASK (IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB)
+#   define LOGFILE_INOTIFY_LEN (sizeof(struct inotify_event) + NAME_MAX + 1)
+#endif
+
+/* State of a file forwarded in tail mode */
+typedef struct {
+    int fd;                         /* -1 while the file does not exist (e.g. during rotation) */
+    int wd;                         /* inotify watch descriptor, -1 if not watched */
+    ino_t inode;
+    off_t offset;                   /* position up to which the file was forwarded */
+    char line[LOGFILE_LINE_MAX];    /* incomplete last line, forwarded once terminated */
+    size_t line_len;
+} LogFileTail;
 
 DLT_IMPORT_CONTEXT(dltsystem)
 
 DltContext logfileContext[DLT_SYSTEM_LOG_FILE_MAX];
 int logfile_delays[DLT_SYSTEM_LOG_FILE_MAX];
 
+static LogFileTail logfile_tail[DLT_SYSTEM_LOG_FILE_MAX];
+static int logfile_inotify = -1;
+
 void send_file(LogFileOptions const *fileopt, int n)
 {
     DLT_LOG(dltsystem, DLT_LOG_DEBUG,
@@ -96,6 +124,232 @@ void send_file(LogFileOptions const *fileopt, int n)
     }
 }
 
+static void logfile_tail_send_line(int n, char *line, size_t len)
+{
+    if ((len > 0) && (line[len - 1] == '\r'))
+        len--;
+
+    line[len] = 0;
+    DLT_LOG(logfileContext[n], DLT_LOG_INFO, DLT_STRING(line));
+}
+
+/* Forward everything appended to the file since the last call, line by line. */
+static void logfile_tail_read(int n)
+{
+    LogFileTail *tail = &logfile_tail[n];
+    char buffer[LOGFILE_LINE_MAX];
+    struct stat st;
+    ssize_t bytes;
+    ssize_t i;
+
+    if (tail->fd < 0)
+        return;
+
+    /* truncated in place (copytruncate), start over */
+    if ((fstat(tail->fd, &st) == 0) && (st.st_size < tail->offset)) {
+        tail->offset = lseek(tail->fd, 0, SEEK_SET);
+        tail->line_len = 0;
+    }
+
+    while ((bytes = read(tail->fd, buffer, sizeof(buffer))) > 0) {
+        tail->offset += bytes;
+
+        for (i = 0; i < bytes; i++) {
+            if (buffer[i] == '\n') {
+                logfile_tail_send_line(n, tail->line, tail->line_len);
+                tail->line_len = 0;
+            }
+            else {
+                /* keep room for the terminating zero, split overlong lines */
+                if (tail->line_len == sizeof(tail->line) - 1) {
+                    logfile_tail_send_line(n, tail->line, tail->line_len);
+                    tail->line_len = 0;
+                }
+
+                tail->line[tail->line_len++] = buffer[i];
+            }
+        }
+    }
+
+    if (bytes < 0)
+        DLT_LOG(dltsystem, DLT_LOG_ERROR,
+                DLT_STRING("dlt-system-logfile, failed to read file:"),
+                DLT_STRING(strerror(errno)));
+}
+
+/*
+ * Open the file for tailing. At startup the existing content is skipped,
+ * a file which appears or replaces a rotated one is forwarded from its start.
+ */
+static void logfile_tail_open(LogFileOptions const *fileopt, int n, int at_end)
+{
+    LogFileTail *tail = &logfile_tail[n];
+    struct stat st;
+
+    tail->fd = open(fileopt->Filename[n], O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if (tail->fd < 0)
+        return;
+
+    if (fstat(tail->fd, &st) == 0)
+        tail->inode = st.st_ino;
+
+    tail->offset = at_end ? lseek(tail->fd, 0, SEEK_END) : 0;
+    tail->line_len = 0;
+
+    if (tail->offset < 0)
+        tail->offset = 0;
+
+#ifdef linux
+    if (logfile_inotify >= 0) {
+        tail->wd = inotify_add_watch(logfile_inotify, fileopt->Filename[n], LOGFILE_INOTIFY_MASK);
+
+        if (tail->wd < 0)
+            DLT_LOG(dltsystem, DLT_LOG_WARN,
+                    DLT_STRING("dlt-system-logfile, failed to watch file, polling instead."),
+                    DLT_STRING(fileopt->Filename[n]));
+    }
+#endif
+
+    logfile_tail_read(n);
+}
+
+/* Forward what is left of the old file and release it, e.g. after it was rotated. */
+static void logfile_tail_close(int n)
+{
+    LogFileTail *tail = &logfile_tail[n];
+
+    if (tail->fd < 0)
+        return;
+
+    logfile_tail_read(n);
+
+    if (tail->line_len > 0) {
+        logfile_tail_send_line(n, tail->line, tail->line_len);
+        tail->line_len = 0;
+    }
+
+#ifdef linux
+    if (tail->wd >= 0)
+        inotify_rm_watch(logfile_inotify, tail->wd);
+#endif
+
+    tail->wd = -1;
+    close(tail->fd);
+    tail->fd = -1;
+}
+
+/*
+ * Called every second for each file in tail mode. Reopens files which were
+ * rotated or did not exist yet, and reads files which are not watched.
+ */
+static void logfile_tail_check(LogFileOptions const *fileopt, int n)
+{
+    LogFileTail *tail = &logfile_tail[n];
+    struct stat st;
+
+    if (tail->fd < 0) {
+        logfile_tail_open(fileopt, n, 0);
+        return;
+    }
+
+    /* path refers to a new file: switch over once the old one is drained */
+    if ((stat(fileopt->Filename[n], &st) == 0) && (st.st_ino != tail->inode)) {
+        logfile_tail_close(n);
+        logfile_tail_open(fileopt, n, 0);
+        return;
+    }
+
+    if (tail->wd < 0)
+        logfile_tail_read(n);
+}
+
+int register_logfile_fd(struct pollfd *pollfd, int i, DltSystemConfiguration *config)
+{
+    int n;
+
+    for (n = 0; n < config->LogFile.Count; n++) {
+        logfile_tail[n].fd = -1;
+        logfile_tail[n].wd = -1;
+    }
+
+#ifdef linux
+    for (n = 0; n < config->LogFile.Count; n++)
+        if (config->LogFile.Mode[n] == SEND_MODE_TAIL)
+            break;
+
+    /* inotify is only needed for tail mode */
+    if (n < config->LogFile.Count) {
+        logfile_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (logfile_inotify < 0)
+            DLT_LOG(dltsystem, DLT_LOG_WARN,
+                    DLT_STRING("dlt-system-logfile, failed to initialize inotify, polling files instead."));
+    }
+#endif
+
+    for (n = 0; n < config->LogFile.Count; n++)
+        if (config->LogFile.Mode[n] == SEND_MODE_TAIL)
+            logfile_tail_open(&(config->LogFile), n, 1);
+
+    if (logfile_inotify < 0)
+        return -1;
+
+    pollfd[i].fd = logfile_inotify;
+    pollfd[i].events = POLLIN;
+    return logfile_inotify;
+}
+
+void logfile_inotify_fd_handler(DltSystemConfiguration *config)
+{
+#ifdef linux
+    static char buf[LOGFILE_INOTIFY_LEN] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct inotify_event *ie;
+    ssize_t len;
+    ssize_t i;
+    int n;
+
+    while ((len = read(logfile_inotify, buf, sizeof(buf))) > 0) {
+        for (i = 0; i + (ssize_t)sizeof(struct inotify_event) <= len;
+             i += (ssize_t)(sizeof(struct inotify_event) + ie->len)) {
+            ie = (struct inotify_event *)&buf[i];
+
+            for (n = 0; n < config->LogFile.Count; n++) {
+                if ((logfile_tail[n].fd < 0) || (logfile_tail[n].wd != ie->wd))
+                    continue;
+
+                if (ie->mask & IN_DELETE_SELF) {
+                    logfile_tail_close(n);
+                    logfile_tail_open(&(config->LogFile), n, 0);
+                }
+                else if (ie->mask & IN_MOVE_SELF) {
+                    /* rotated away: the writer may still append to the old
+                     * file, keep following it until the new file appears */
+                    logfile_tail_check(&(config->LogFile), n);
+                }
+                else if (ie->mask & (IN_MODIFY | IN_ATTRIB)) {
+                    logfile_tail_read(n);
+                }
+
+                break;
+            }
+        }
+    }
+#else
+    (void)config;
+#endif
+}
+
+void logfile_cleanup(DltSystemConfiguration *config)
+{
+    for (int n = 0; n < config->LogFile.Count; n++)
+        if (config->LogFile.Mode[n] == SEND_MODE_TAIL)
+            logfile_tail_close(n);
+
+    /* the inotify fd itself is closed with the other poll fds */
+    logfile_inotify = -1;
+}
+
 void register_contexts(LogFileOptions const *fileopts)
 {
     DLT_LOG(dltsystem, DLT_LOG_DEBUG,
@@ -126,6 +380,11 @@ void logfile_fd_handler(void *v_conf)
         if (conf->LogFile.Mode[i] == SEND_MODE_OFF)
             continue;
 
+        if (conf->LogFile.Mode[i] == SEND_MODE_TAIL) {
+            logfile_tail_check(&(conf->LogFile), i);
+            continue;
+        }
+
         if (logfile_delays[i] <= 0) {
             send_file(&(conf->LogFile), i);
             logfile_delays[i] = conf->LogFile.TimeDelay[i];
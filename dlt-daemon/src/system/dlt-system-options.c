@@ -151,12 +151,15 @@ void init_configuration(DltSystemConfiguration *config)
     config->Journal.Follow = 0;
     config->Journal.MapLogLevels = 1;
     config->Journal.UseOriginalTimestamp = 1;
+    config->Journal.CursorFile = NULL;
+    config->Journal.CursorInterval = 64;
 
     /* File transfer */
     config->Filetransfer.Enable = 0;
     strncpy(config->Filetransfer.ContextId, "FILE", DLT_ID_SIZE);
     config->Filetransfer.TimeStartup = 30;
     config->Filetransfer.TimeoutBetweenLogs = 10;
+    config->Filetransfer.CompressionThreads = 2;
     config->Filetransfer.Count = 0;
 
     for (i = 0; i < DLT_SYSTEM_LOG_DIRS_MAX; i++) {
@@ -293,6 +296,20 @@ int read_configuration_file(DltSystemConfiguration *config, char *file_name)
             {
                 config->Journal.UseUptimeOnly = atoi(value);
             }
+            else if (strcmp(token, "JournalCursorFile") == 0)
+            {
+                free(config->Journal.CursorFile);
+                config->Journal.CursorFile = malloc(strlen(value) + 1);
+                MALLOC_ASSERT(config->Journal.CursorFile);
+                strcpy(config->Journal.CursorFile, value); /* strcpy unritical here, because size matches exactly the size to be copied */
+            }
+            else if (strcmp(token, "JournalCursorInterval") == 0)
+            {
+                config->Journal.CursorInterval = atoi(value);
+
+                if (config->Journal.CursorInterval < 1)
+                    config->Journal.CursorInterval = 1;
+            }
 
             /* File transfer */
             else if (strcmp(token, "FiletransferEnable") == 0)
@@ -311,6 +328,10 @@ int read_configuration_file(DltSystemConfiguration *config, char *file_name)
             {
                 config->Filetransfer.TimeoutBetweenLogs = atoi(value);
             }
+            else if (strcmp(token, "FiletransferCompressionThreads") == 0)
+            {
+                config->Filetransfer.CompressionThreads = atoi(value);
+            }
             else if (strcmp(token, "FiletransferDirectory") == 0)
             {
                 config->Filetransfer.Directory[config->Filetransfer.Count] = malloc(strlen(value) + 1);
@@ -431,6 +452,13 @@ void cleanup_config(DltSystemConfiguration *config, DltSystemCliOptions *options
         options->ConfigurationFileName = NULL;
     }
 
+    /* Journal */
+    if (config->Journal.CursorFile != NULL)
+    {
+        free(config->Journal.CursorFile);
+        config->Journal.CursorFile = NULL;
+    }
+
     /* File transfer */
     for(int i = 0 ; i < DLT_SYSTEM_LOG_DIRS_MAX ; i++)
     {
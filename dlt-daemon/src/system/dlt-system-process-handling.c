@@ -145,6 +145,7 @@ void cleanup_processes(struct pollfd *pollfd, struct pollfd *journalPollFd, sd_j
 
     //Logfile cleanup
     if (config->LogFile.Enable) {
+        logfile_cleanup(config);
         for (int i = 0; i < config->LogFile.Count; i++)
             DLT_UNREGISTER_CONTEXT(logfileContext[i]);
     }
@@ -162,6 +163,7 @@ void cleanup_processes(struct pollfd *pollfd, struct pollfd *journalPollFd, sd_j
     //FileTransfer cleanup
 #if defined(DLT_FILETRANSFER_ENABLE)
     if (config->Filetransfer.Enable) {
+        filetransfer_cleanup();
         DLT_UNREGISTER_CONTEXT(filetransferContext);
     }
 #endif
@@ -243,6 +245,13 @@ void start_dlt_system_processes(DltSystemConfiguration *config)
         }
     }
 
+    //init FD for LogFile in tail mode
+    if (config->LogFile.Enable) {
+        fdType[fdcnt] = fdType_logfile;
+        if (register_logfile_fd(pollfd, fdcnt, config) > 0)
+            fdcnt++;
+    }
+
     //init FD for Syslog
     int syslogSock = 0;
     if (config->Syslog.Enable) {
@@ -304,6 +313,9 @@ void start_dlt_system_processes(DltSystemConfiguration *config)
                 else if (fdType[i] == fdType_timer) {
                     timer_fd_handler(pollfd[i].fd, config);
                 }
+                else if (fdType[i] == fdType_logfile) {
+                    logfile_inotify_fd_handler(config);
+                }
                 #if defined(DLT_FILETRANSFER_ENABLE)
                 else if (fdType[i] == fdType_filetransfer) {
                     filetransfer_fd_handler(config);
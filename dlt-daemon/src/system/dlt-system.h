@@ -78,8 +78,9 @@
 *   - Timer file descriptor for processing LogFile and LogProcesses every second
 *   - Inotify file descriptor for FileTransfer
 *   - Timer file descriptor for Watchdog 
+*   - Inotify file descriptor for LogFile in tail mode
 */
-#define MAX_FD_NUMBER   4
+#define MAX_FD_NUMBER   5
 
 /* Macros */
 #define MALLOC_ASSERT(x) if (x == NULL) { \
@@ -92,6 +93,7 @@ enum fdType {
     fdType_filetransfer,
     fdType_timer,
     fdType_watchdog,
+    fdType_logfile,
 };
 
 /**
@@ -127,6 +129,8 @@ typedef struct {
     int MapLogLevels;
     int UseOriginalTimestamp;
     int UseUptimeOnly;
+    char *CursorFile;       /* file to checkpoint the journal cursor in, NULL if disabled */
+    int CursorInterval;     /* number of forwarded entries between two checkpoints */
 #ifdef DLT_SYSTEMD_WATCHDOG_ENFORCE_MSG_RX_ENABLE_DLT_SYSTEM
     int MessageReceived;
 #endif
@@ -143,6 +147,8 @@ typedef struct {
     int Compression[DLT_SYSTEM_LOG_DIRS_MAX];
     int CompressionLevel[DLT_SYSTEM_LOG_DIRS_MAX];
     char *Directory[DLT_SYSTEM_LOG_DIRS_MAX];
+
+    int CompressionThreads;
 } FiletransferOptions;
 
 typedef struct {
@@ -207,11 +213,15 @@ void logfile_init(void *v_conf);
 void logprocess_init(void *v_conf);
 void register_journal_fd(sd_journal **j, struct pollfd *pollfd, int i,  DltSystemConfiguration *config);
 int register_syslog_fd(struct pollfd *pollfd, int i, DltSystemConfiguration *config);
+int register_logfile_fd(struct pollfd *pollfd, int i, DltSystemConfiguration *config);
 
 /* Routines that are called, when a fd event was raised. */
 void logfile_fd_handler(void *v_conf);
+void logfile_inotify_fd_handler(DltSystemConfiguration *config);
+void logfile_cleanup(DltSystemConfiguration *config);
 void logprocess_fd_handler(void *v_conf);
 void filetransfer_fd_handler(DltSystemConfiguration *config);
+void filetransfer_cleanup(void);
 #if defined(DLT_SYSTEMD_WATCHDOG_ENFORCE_MSG_RX_ENABLE_DLT_SYSTEM) && defined(DLT_SYSTEMD_JOURNAL_ENABLE)
 void watchdog_fd_handler(int fd, int* received_message_since_last_watchdog_interval);
 #else
@@ -53,6 +53,7 @@
 *******************************************************************************/
 
 
+#include <pthread.h>
 #include <dlt_filetransfer.h>     /*Needed for transferring files with the dlt protocol*/
 #include <dlt.h>                /*Needed for dlt logging*/
 
@@ -208,6 +209,72 @@ int testFile2Run1(void)
     return transferResult;
 }
 
+/*!Completion state of the asynchronous file transfer */
+static pthread_mutex_t asyncMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t asyncCond = PTHREAD_COND_INITIALIZER;
+static int asyncDone;
+static int asyncResult;
+
+/*!Called when the asynchronous file transfer finished */
+void asyncTransferFinished(DltContext *context, const char *filename, int result, void *userData)
+{
+    (void)context;
+    (void)filename;
+    (void)userData;
+
+    pthread_mutex_lock(&asyncMutex);
+    asyncResult = result;
+    asyncDone = 1;
+    pthread_cond_signal(&asyncCond);
+    pthread_mutex_unlock(&asyncMutex);
+}
+
+/*!Test the file transfer of the bigger file from a memory mapping in a thread of its own, resuming a partial transfer. */
+int testFile2Run3(void)
+{
+    DltFileTransferCursor cursor = { 0, 0 };
+    bool cancel = true;
+
+    /*Just some log to main context */
+    DLT_LOG(mainContext, DLT_LOG_INFO, DLT_STRING("Started testF2P3 - dlt_user_log_file_complete_async"), DLT_STRING(file2));
+
+    /*A cancelled transfer stops before the first package, the cursor stays at the beginning */
+    transferResult = dlt_user_log_file_data_mmap(&fileContext, file2, &cursor, 0, &cancel);
+
+    if ((transferResult != DLT_FILETRANSFER_ERROR_FILE_END_USER_CANCELLED) || (cursor.package != 0)) {
+        printf("Error: dlt_user_log_file_data_mmap\n");
+        printTestResultPositiveExpected(__func__, -1);
+        return -1;
+    }
+
+    /*Transfer the file completely, the callback signals the result */
+    asyncDone = 0;
+    transferResult = dlt_user_log_file_complete_async(&fileContext, file2, 0, 0, &cursor, NULL,
+                                                      asyncTransferFinished, NULL);
+
+    if (transferResult < 0) {
+        printf("Error: dlt_user_log_file_complete_async\n");
+        printTestResultPositiveExpected(__func__, transferResult);
+        return transferResult;
+    }
+
+    pthread_mutex_lock(&asyncMutex);
+
+    while (!asyncDone)
+        pthread_cond_wait(&asyncCond, &asyncMutex);
+
+    transferResult = asyncResult;
+    pthread_mutex_unlock(&asyncMutex);
+
+    if ((transferResult == 0) && (cursor.package != dlt_user_log_file_packagesCount(&fileContext, file2)))
+        transferResult = -1;
+
+    /*Just some log to main context */
+    DLT_LOG(mainContext, DLT_LOG_INFO, DLT_STRING("Finished testF2P3"), DLT_STRING(file2));
+    printTestResultPositiveExpected(__func__, transferResult);
+    return transferResult;
+}
+
 /*!Test the file transfer with the condition that the transferred file is bigger as the file transfer buffer using single package transfer */
 int testFile2Run2(void)
 {
@@ -444,6 +511,7 @@ int main(int argc, char* argv[])
     testFile1Run2();
     testFile2Run1();
     testFile2Run2();
+    testFile2Run3();
     testFile3Run1();
     testFile3Run2();
     testFile3Run3();
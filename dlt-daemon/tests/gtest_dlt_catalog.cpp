@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <string.h>
+#include <gtest/gtest.h>
+
+extern "C"
+{
+    #include "dlt_common.h"
+    #include "dlt-catalog.h"
+}
+
+#define CATALOG_FILE "gtest_dlt_catalog.cat"
+
+static void write_catalog(const char *content)
+{
+    FILE *handle = fopen(CATALOG_FILE, "w");
+    ASSERT_NE((FILE *)NULL, handle);
+    fputs(content, handle);
+    fclose(handle);
+}
+
+/* Prepare a little endian non-verbose message without extended header */
+static void prepare_message(DltMessage *msg, uint8_t *payload, int32_t size)
+{
+    memset(msg, 0, sizeof(DltMessage));
+    msg->standardheader = (DltStandardHeader *)(msg->headerbuffer + sizeof(DltStorageHeader));
+    msg->standardheader->htyp = DLT_HTYP_PROTOCOL_VERSION1;
+    msg->databuffer = payload;
+    msg->datasize = size;
+}
+
+/* Begin Method: dlt_catalog::dlt_catalog_load */
+TEST(t_dlt_catalog_load, normal)
+{
+    DltCatalog catalog;
+    const DltCatalogEntry *entry;
+
+    write_catalog("# DLT non-verbose catalog v1\n"
+                  "0x00000020\tSECOND\tapp.c:2\tuint8\n"
+                  "0x00000010\tFIRST\tapp.c:1\ttext=a\\tb\tstring\n");
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_catalog_load(&catalog, CATALOG_FILE, 0));
+    EXPECT_EQ(2, catalog.num_entries);
+
+    entry = dlt_catalog_find(&catalog, 0x10);
+    ASSERT_NE((const DltCatalogEntry *)NULL, entry);
+    EXPECT_STREQ("FIRST", entry->name);
+    EXPECT_EQ(2, entry->num_args);
+    EXPECT_STREQ("a\tb", entry->args[0].text);
+    EXPECT_EQ((uint32_t)(DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII), entry->args[1].type_info);
+
+    EXPECT_EQ((const DltCatalogEntry *)NULL, dlt_catalog_find(&catalog, 0x30));
+
+    dlt_catalog_free(&catalog);
+    EXPECT_EQ(0, catalog.num_entries);
+    remove(CATALOG_FILE);
+}
+
+TEST(t_dlt_catalog_load, abnormal)
+{
+    DltCatalog catalog;
+
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_catalog_load(NULL, CATALOG_FILE, 0));
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_catalog_load(&catalog, "/nonexistent/catalog", 0));
+
+    /* unknown argument type */
+    write_catalog("0x00000010\tFIRST\tapp.c:1\tpointer\n");
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_catalog_load(&catalog, CATALOG_FILE, 0));
+
+    /* duplicate message id */
+    write_catalog("0x00000010\tFIRST\tapp.c:1\n"
+                  "0x00000010\tSECOND\tapp.c:2\n");
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_catalog_load(&catalog, CATALOG_FILE, 0));
+    EXPECT_EQ(0, catalog.num_entries);
+    remove(CATALOG_FILE);
+}
+/* End Method: dlt_catalog::dlt_catalog_load */
+
+/*##############################################################################################################################*/
+/*##############################################################################################################################*/
+/*##############################################################################################################################*/
+
+/* Begin Method: dlt_catalog::dlt_catalog_message_payload */
+TEST(t_dlt_catalog_message_payload, normal)
+{
+    DltCatalog catalog;
+    DltMessage msg;
+    char text[DLT_CONVERT_TEXTBUFSIZE];
+    /* id 0x10, uint16 120, string "on", int8 -3 */
+    uint8_t payload[] = { 0x10, 0x00, 0x00, 0x00, 0x78, 0x00, 0x03, 0x00, 'o', 'n', 0x00, 0xfd };
+    /* id 0x20, not part of the catalog */
+    uint8_t unknown[] = { 0x20, 0x00, 0x00, 0x00, 0x01 };
+
+    write_catalog("0x00000010\tSPEED\tapp.c:1\ttext=speed\tuint16\ttext=km/h\tstring\tint8\n");
+    ASSERT_EQ(DLT_RETURN_OK, dlt_catalog_load(&catalog, CATALOG_FILE, 0));
+
+    prepare_message(&msg, payload, sizeof(payload));
+    EXPECT_EQ(DLT_RETURN_TRUE, dlt_catalog_message_payload(&catalog, &msg, text, sizeof(text), 0));
+    EXPECT_STREQ("speed 120 km/h on -3", text);
+
+    prepare_message(&msg, unknown, sizeof(unknown));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_catalog_message_payload(&catalog, &msg, text, sizeof(text), 0));
+
+    dlt_catalog_free(&catalog);
+    remove(CATALOG_FILE);
+}
+
+TEST(t_dlt_catalog_message_payload, abnormal)
+{
+    DltCatalog catalog;
+    DltMessage msg;
+    char text[DLT_CONVERT_TEXTBUFSIZE];
+    /* payload is one byte too short for the entry */
+    uint8_t short_payload[] = { 0x10, 0x00, 0x00, 0x00, 0x78 };
+    /* payload has one byte more than the entry describes */
+    uint8_t long_payload[] = { 0x10, 0x00, 0x00, 0x00, 0x78, 0x00, 0x01 };
+
+    write_catalog("0x00000010\tSPEED\tapp.c:1\tuint16\n");
+    ASSERT_EQ(DLT_RETURN_OK, dlt_catalog_load(&catalog, CATALOG_FILE, 0));
+
+    prepare_message(&msg, short_payload, sizeof(short_payload));
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_catalog_message_payload(&catalog, &msg, text, sizeof(text), 0));
+
+    prepare_message(&msg, long_payload, sizeof(long_payload));
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_catalog_message_payload(&catalog, &msg, text, sizeof(text), 0));
+
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_catalog_message_payload(NULL, &msg, text, sizeof(text), 0));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_catalog_message_payload(&catalog, NULL, text, sizeof(text), 0));
+
+    dlt_catalog_free(&catalog);
+    remove(CATALOG_FILE);
+}
+/* End Method: dlt_catalog::dlt_catalog_message_payload */
@@ -2316,6 +2316,182 @@ TEST(t_dlt_message_filter_check, nullpointer)
 
 
 
+/* Begin Method:dlt_common::dlt_filter_compile */
+static void t_dlt_filter_setup_message(DltMessage *msg, const char *apid, const char *ctid, int level, int32_t datasize)
+{
+    memset(msg, 0, sizeof(DltMessage));
+    msg->standardheader = (DltStandardHeader *)(msg->headerbuffer + sizeof(DltStorageHeader));
+    msg->standardheader->htyp = DLT_HTYP_UEH;
+    msg->extendedheader = (DltExtendedHeader *)(msg->headerbuffer + sizeof(DltStorageHeader) +
+                                                sizeof(DltStandardHeader));
+    msg->extendedheader->msin = (uint8_t)((DLT_TYPE_LOG << DLT_MSIN_MSTP_SHIFT) | (level << DLT_MSIN_MTIN_SHIFT));
+    dlt_set_id(msg->extendedheader->apid, apid);
+    dlt_set_id(msg->extendedheader->ctid, ctid);
+    msg->datasize = datasize;
+}
+
+static void t_dlt_filter_setup(DltFilter *filter, int count)
+{
+    char apid[16];
+    char ctid[16];
+
+    dlt_filter_init(filter, 0);
+
+    for (int i = 0; i < count; i++) {
+        snprintf(apid, sizeof(apid), "A%03d", i);
+        snprintf(ctid, sizeof(ctid), "C%03d", i);
+
+        switch (i % 4) {
+        case 0:
+            dlt_filter_add(filter, apid, ctid, 0, 0, INT32_MAX, 0);
+            break;
+        case 1:
+            dlt_filter_add(filter, apid, "", DLT_LOG_WARN, 0, INT32_MAX, 0);
+            break;
+        case 2:
+            dlt_filter_add(filter, "", ctid, 0, 10, 100, 0);
+            break;
+        default:
+            dlt_filter_add(filter, apid, ctid, DLT_LOG_ERROR, 0, 0, 0);
+            break;
+        }
+    }
+}
+
+TEST(t_dlt_filter_compile, normal)
+{
+    DltFilter filter;
+    DltMessage msg;
+    char apid[16];
+    char ctid[16];
+    int checked = 0;
+
+    t_dlt_filter_setup(&filter, 24);
+    /* same ids with other level are merged into one index entry */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_add(&filter, "A001", "", DLT_LOG_INFO, 0, INT32_MAX, 0));
+
+    for (int a = 0; a < 45; a++) {
+        for (int c = 0; c < 45; c += 3) {
+            for (int level = DLT_LOG_FATAL; level <= DLT_LOG_VERBOSE; level++) {
+                for (int32_t datasize = 0; datasize < 200; datasize += 50) {
+                    snprintf(apid, sizeof(apid), "A%03d", a);
+                    snprintf(ctid, sizeof(ctid), "C%03d", c);
+                    t_dlt_filter_setup_message(&msg, apid, ctid, level, datasize);
+
+                    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_free(&filter, 0));
+                    DltReturnValue expected = dlt_message_filter_check(&msg, &filter, 0);
+                    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_compile(&filter, 0));
+                    EXPECT_EQ(expected, dlt_message_filter_check(&msg, &filter, 0));
+                    checked += (expected == DLT_RETURN_TRUE);
+                }
+            }
+        }
+    }
+
+    /* some but not all messages are expected to pass the filters */
+    EXPECT_LT(0, checked);
+    EXPECT_GT(45 * 15 * 6 * 4, checked);
+
+    /* modification drops the index */
+    t_dlt_filter_setup_message(&msg, "A000", "C000", DLT_LOG_INFO, 0);
+    EXPECT_EQ(DLT_RETURN_TRUE, dlt_message_filter_check(&msg, &filter, 0));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_delete(&filter, "A000", "C000", 0, 0, INT32_MAX, 0));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_message_filter_check(&msg, &filter, 0));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_free(&filter, 0));
+}
+TEST(t_dlt_filter_compile, load)
+{
+    DltFilter filter;
+    const char *filename = "gtest_dlt_filter_compile.txt";
+    FILE *handle = fopen(filename, "w");
+
+    ASSERT_NE((FILE *)NULL, handle);
+
+    for (int i = 0; i < 200; i++)
+        fprintf(handle, "A%03d C%03d\n", i, i);
+
+    fclose(handle);
+
+    dlt_filter_init(&filter, 0);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_load(&filter, filename, 0));
+    EXPECT_EQ(200, filter.counter);
+    /* compiled by dlt_filter_load() */
+    EXPECT_EQ(200, filter.index.num_entries);
+
+    DltMessage msg;
+    t_dlt_filter_setup_message(&msg, "A199", "C199", DLT_LOG_INFO, 0);
+    EXPECT_EQ(DLT_RETURN_TRUE, dlt_message_filter_check(&msg, &filter, 0));
+    t_dlt_filter_setup_message(&msg, "A199", "C198", DLT_LOG_INFO, 0);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_message_filter_check(&msg, &filter, 0));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_free(&filter, 0));
+    unlink(filename);
+}
+TEST(t_dlt_filter_compile, benchmark)
+{
+    const int filter_counts[] = { 1, 10, 200 };
+    const int rounds = 20000;
+    DltMessage msg[64];
+    char apid[16];
+    char ctid[16];
+
+    for (int i = 0; i < 64; i++) {
+        snprintf(apid, sizeof(apid), "A%03d", i * 7);
+        snprintf(ctid, sizeof(ctid), "C%03d", i * 5);
+        t_dlt_filter_setup_message(&msg[i], apid, ctid, (i % DLT_LOG_VERBOSE) + 1, i * 3);
+    }
+
+    for (int count : filter_counts) {
+        DltFilter filter;
+        int matches[2] = { 0, 0 };
+        double elapsed[2];
+
+        t_dlt_filter_setup(&filter, count);
+        EXPECT_EQ(count, filter.counter);
+
+        for (int compiled = 0; compiled < 2; compiled++) {
+            struct timespec start, end;
+
+            if (compiled)
+                dlt_filter_compile(&filter, 0);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            for (int r = 0; r < rounds; r++)
+                for (int i = 0; i < 64; i++)
+                    matches[compiled] += (dlt_message_filter_check(&msg[i], &filter, 0) == DLT_RETURN_TRUE);
+
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            elapsed[compiled] = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+        }
+
+        /* only the 200 filters are compiled, shorter lists stay linear */
+        EXPECT_EQ(count == 200, filter.index.num_entries > 0);
+        EXPECT_EQ(matches[0], matches[1]);
+        printf("%3d filters: linear %6.1f ns/msg, compiled %6.1f ns/msg\n", count,
+               elapsed[0] / (rounds * 64), elapsed[1] / (rounds * 64));
+
+        dlt_filter_free(&filter, 0);
+    }
+}
+TEST(t_dlt_filter_compile, uninitialised)
+{
+    DltFilter filter;
+
+    /* a filter list filled without dlt_filter_init() */
+    memset(&filter, 0xA5, sizeof(DltFilter));
+    filter.counter = 0;
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_add(&filter, "APP", "CTX", 0, 0, INT32_MAX, 0));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_filter_delete(&filter, "APP", "CTX", 0, 0, INT32_MAX, 0));
+    EXPECT_EQ(0, filter.counter);
+}
+/* End Method:dlt_common::dlt_filter_compile */
+
+
+
+
 /* Begin Method:dlt_common::dlt_message _get_extraparameters */
 TEST(t_dlt_message_get_extraparamters, normal)
 {
@@ -3107,6 +3283,115 @@ TEST(t_dlt_message_payload, nullpointer)
 /*    EXPECT_GE(DLT_RETURN_ERROR, dlt_message_payload(&file.msg, text, DLT_DAEMON_TEXTSIZE, 0, 0)); */
 /*    EXPECT_GE(DLT_RETURN_ERROR, dlt_message_payload(&file.msg, text, DLT_DAEMON_TEXTSIZE, 0, 1)); */
 }
+
+/* Empty verbose message in host byte order */
+static void verbose_payload_init(DltMessage *msg, uint8_t *data)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->standardheader = (DltStandardHeader *)(msg->headerbuffer + sizeof(DltStorageHeader));
+    msg->extendedheader = (DltExtendedHeader *)(msg->headerbuffer + sizeof(DltStorageHeader) +
+                                                sizeof(DltStandardHeader));
+    msg->standardheader->htyp = DLT_HTYP_UEH | DLT_HTYP_PROTOCOL_VERSION1;
+#if (BYTE_ORDER == BIG_ENDIAN)
+    msg->standardheader->htyp |= DLT_HTYP_MSBF;
+#endif
+    msg->extendedheader->msin = DLT_MSIN_VERB;
+    msg->databuffer = data;
+}
+
+static void verbose_payload_add(DltMessage *msg, uint32_t type_info, const void *value, size_t size)
+{
+    memcpy(msg->databuffer + msg->datasize, &type_info, sizeof(type_info));
+    memcpy(msg->databuffer + msg->datasize + sizeof(type_info), value, size);
+    msg->datasize += (int32_t)(sizeof(type_info) + size);
+    msg->extendedheader->noar++;
+}
+
+/* String or raw data with its 16 bit length */
+static void verbose_payload_add_data(DltMessage *msg, uint32_t type_info, const void *value, uint16_t size)
+{
+    uint8_t arg[256];
+
+    memcpy(arg, &size, sizeof(size));
+    memcpy(arg + sizeof(size), value, size);
+    verbose_payload_add(msg, type_info, arg, sizeof(size) + size);
+}
+
+TEST(t_dlt_message_payload, verbose_types)
+{
+    DltMessage msg;
+    uint8_t data[1024];
+    char text[DLT_DAEMON_TEXTSIZE];
+    uint8_t raw[3] = { 0x00, 0x01, 0xff };
+    int8_t s8 = INT8_MIN;
+    uint8_t u8 = UINT8_MAX;
+    int16_t s16 = INT16_MIN;
+    uint16_t u16 = UINT16_MAX;
+    int32_t s32 = INT32_MIN;
+    uint32_t u32 = UINT32_MAX;
+    int64_t s64 = INT64_MIN;
+    uint64_t u64 = UINT64_MAX;
+    uint8_t hex8 = 0x0f;
+    uint16_t hex16 = 0x0a0b;
+    uint32_t hex32 = 0xdeadbeef;
+    uint8_t flag = 1;
+    float32_t f32[] = { 1.5f, 123456.0f, 0.1f };
+    float64_t f64[] = { -0.0, 1e6, -42.0, 3.25e-10 };
+    uint8_t named[] = { 6, 0, 5, 0, 's', 'p', 'e', 'e', 'd', 0, 'k', 'm', '/', 'h', 0, 42, 0, 0, 0 };
+
+    /* Begin Method:dlt_common::dlt_message_payload */
+    verbose_payload_init(&msg, data);
+    verbose_payload_add_data(&msg, DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII, "Hello\nworld", 12);
+    verbose_payload_add_data(&msg, DLT_TYPE_INFO_STRG | DLT_SCOD_UTF8, "utf8", 5);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_BOOL | DLT_TYLE_8BIT, &flag, 1);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_SINT | DLT_TYLE_8BIT, &s8, 1);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_TYLE_8BIT, &u8, 1);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_SINT | DLT_TYLE_16BIT, &s16, 2);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_TYLE_16BIT, &u16, 2);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_SINT | DLT_TYLE_32BIT, &s32, 4);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT, &u32, 4);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_SINT | DLT_TYLE_64BIT, &s64, 8);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_TYLE_64BIT, &u64, 8);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_8BIT, &hex8, 1);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_16BIT, &hex16, 2);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_SCOD_HEX | DLT_TYLE_32BIT, &hex32, 4);
+
+    for (float32_t value : f32)
+        verbose_payload_add(&msg, DLT_TYPE_INFO_FLOA | DLT_TYLE_32BIT, &value, 4);
+
+    for (float64_t value : f64)
+        verbose_payload_add(&msg, DLT_TYPE_INFO_FLOA | DLT_TYLE_64BIT, &value, 8);
+
+    verbose_payload_add_data(&msg, DLT_TYPE_INFO_RAWD, raw, sizeof(raw));
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT | DLT_TYPE_INFO_VARI, named, sizeof(named));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_message_payload(&msg, text, sizeof(text), DLT_OUTPUT_ASCII, 0));
+    EXPECT_STREQ("Hello world utf8 1 -128 255 -32768 65535 -2147483648 4294967295 -9223372036854775808 "
+                 "18446744073709551615 0x0f 0x0a0b 0xdeadbeef 1.5 123456 0.1 -0 1e+06 -42 3.25e-10 "
+                 "00'01'ff 42", text);
+
+    /* attributes are printed by the generic formatter */
+    dlt_print_with_attributes(true);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_message_payload(&msg, text, sizeof(text), DLT_OUTPUT_ASCII, 0));
+    dlt_print_with_attributes(false);
+    EXPECT_STREQ("Hello world utf8 1 -128 255 -32768 65535 -2147483648 4294967295 -9223372036854775808 "
+                 "18446744073709551615 0x0f 0x0a0b 0xdeadbeef 1.5 123456 0.1 -0 1e+06 -42 3.25e-10 "
+                 "00'01'ff speed:42:km/h", text);
+
+    /* so are binary values */
+    verbose_payload_init(&msg, data);
+    verbose_payload_add(&msg, DLT_TYPE_INFO_UINT | DLT_SCOD_BIN | DLT_TYLE_8BIT, &hex8, 1);
+    verbose_payload_add_data(&msg, DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII, "end", 4);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_message_payload(&msg, text, sizeof(text), DLT_OUTPUT_ASCII, 0));
+    EXPECT_STREQ("0b0000 1111 end", text);
+
+    /* text too short and truncated payload */
+    verbose_payload_init(&msg, data);
+    verbose_payload_add_data(&msg, DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII, "Hello", 6);
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_message_payload(&msg, text, 4, DLT_OUTPUT_ASCII, 0));
+    msg.datasize -= 2;
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_message_payload(&msg, text, sizeof(text), DLT_OUTPUT_ASCII, 0));
+}
 /* End Method:dlt_common::dlt_message_payload */
 
 
@@ -3257,6 +3542,100 @@ TEST(t_dlt_message_read, nullpointer)
 
 
 
+/* Begin Method:dlt_common::dlt_message_view_read */
+TEST(t_dlt_message_view_read, normal)
+{
+    DltFile file;
+    DltMessageView view;
+    /* Get PWD so file can be used */
+    char pwd[MAX_LINE];
+    char openfile[MAX_LINE+sizeof(BINARY_FILE_NAME)];
+    static uint8_t buffer[UINT16_MAX + sizeof(dltSerialHeader) + 3];
+
+    /* ignore returned value from getcwd */
+    if (getcwd(pwd, MAX_LINE) == NULL) {}
+
+    sprintf(openfile, "%s" BINARY_FILE_NAME, pwd);
+    /*---------------------------------------*/
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_file_init(&file, 0));
+    EXPECT_LE(DLT_RETURN_OK, dlt_file_open(&file, openfile, 0));
+
+    while (dlt_file_read(&file, 0) >= 0) {}
+
+    for (int i = 0; i < file.counter; i++) {
+        EXPECT_LE(DLT_RETURN_OK, dlt_file_message(&file, i, 0));
+
+        /* message as received from the daemon, without storage header */
+        size_t headersize = (size_t)file.msg.headersize - sizeof(DltStorageHeader);
+        size_t size = headersize + (size_t)file.msg.datasize;
+        memcpy(buffer, file.msg.headerbuffer + sizeof(DltStorageHeader), headersize);
+        memcpy(buffer + headersize, file.msg.databuffer, (size_t)file.msg.datasize);
+
+        EXPECT_EQ(DLT_MESSAGE_ERROR_OK, dlt_message_view_read(&view, buffer, (unsigned int)size, 0, 0));
+        EXPECT_EQ(buffer, view.buffer);
+        EXPECT_EQ((int32_t)headersize, view.headersize);
+        EXPECT_EQ(file.msg.datasize, view.datasize);
+        EXPECT_EQ(size, dlt_message_view_get_consumed_size(&view));
+        EXPECT_EQ(buffer + headersize, dlt_message_view_get_payload(&view));
+
+        if (DLT_IS_HTYP_UEH(file.msg.standardheader->htyp)) {
+            ASSERT_TRUE(dlt_message_view_get_apid(&view) != NULL);
+            EXPECT_EQ(0, memcmp(file.msg.extendedheader->apid, dlt_message_view_get_apid(&view), DLT_ID_SIZE));
+            EXPECT_EQ(0, memcmp(file.msg.extendedheader->ctid, dlt_message_view_get_ctid(&view), DLT_ID_SIZE));
+        }
+        else {
+            EXPECT_EQ(NULL, dlt_message_view_get_apid(&view));
+            EXPECT_EQ(NULL, dlt_message_view_get_ctid(&view));
+        }
+
+        DltStandardHeaderExtra extra;
+        EXPECT_EQ(DLT_RETURN_OK, dlt_message_view_get_extraparameters(&view, &extra));
+        if (DLT_IS_HTYP_WEID(file.msg.standardheader->htyp)) {
+            EXPECT_EQ(0, memcmp(file.msg.headerextra.ecu, extra.ecu, DLT_ID_SIZE));
+        }
+
+        if (DLT_IS_HTYP_WTMS(file.msg.standardheader->htyp)) {
+            EXPECT_EQ(file.msg.headerextra.tmsp, extra.tmsp);
+        }
+
+        /* truncated message is not handed out */
+        EXPECT_EQ(DLT_MESSAGE_ERROR_SIZE, dlt_message_view_read(&view, buffer, (unsigned int)size - 1, 0, 0));
+
+        /* resync to serial header behind garbage */
+        memmove(buffer + sizeof(dltSerialHeader) + 3, buffer, size);
+        memset(buffer, 0xAA, 3);
+        memcpy(buffer + 3, dltSerialHeader, sizeof(dltSerialHeader));
+        EXPECT_EQ(DLT_MESSAGE_ERROR_OK,
+                  dlt_message_view_read(&view, buffer, (unsigned int)(size + sizeof(dltSerialHeader) + 3), 1, 0));
+        EXPECT_EQ(1, view.found_serialheader);
+        EXPECT_EQ(3, view.resync_offset);
+        EXPECT_EQ(size + sizeof(dltSerialHeader) + 3, dlt_message_view_get_consumed_size(&view));
+    }
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_file_free(&file, 0));
+}
+TEST(t_dlt_message_view_read, nullpointer)
+{
+    DltMessageView view;
+    uint8_t buf[4] = { 0 };
+
+    /* NULL_Pointer, expected error */
+    EXPECT_EQ(DLT_MESSAGE_ERROR_UNKNOWN, dlt_message_view_read(NULL, NULL, 0, 0, 0));
+    EXPECT_EQ(DLT_MESSAGE_ERROR_UNKNOWN, dlt_message_view_read(NULL, buf, sizeof(buf), 0, 0));
+    EXPECT_EQ(DLT_MESSAGE_ERROR_UNKNOWN, dlt_message_view_read(&view, NULL, sizeof(buf), 0, 0));
+    EXPECT_EQ(0u, dlt_message_view_get_consumed_size(NULL));
+    EXPECT_EQ(NULL, dlt_message_view_get_extendedheader(NULL));
+    EXPECT_EQ(NULL, dlt_message_view_get_apid(NULL));
+    EXPECT_EQ(NULL, dlt_message_view_get_ecuid(NULL));
+    EXPECT_EQ(NULL, dlt_message_view_get_payload(NULL));
+    EXPECT_GE(DLT_RETURN_ERROR, dlt_message_view_get_extraparameters(NULL, NULL));
+}
+/* End Method:dlt_common::dlt_message_view_read */
+
+
+
+
 /* Begin Method:dlt_common::dlt_message_argument_print */
 TEST(t_dlt_message_argument_print, normal)
 {
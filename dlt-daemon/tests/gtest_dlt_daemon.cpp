@@ -27,8 +27,13 @@
 #include "dlt_daemon_common_cfg.h"
 #include <gtest/gtest.h>
 #include <limits.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
 #include <syslog.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 
 extern "C"
 {
@@ -38,6 +43,9 @@ extern "C"
 #include "dlt_version.h"
 #include "dlt_client.h"
 #include "dlt_protocol.h"
+#include "dlt_daemon_client.h"
+#include "dlt_daemon_connection.h"
+#include "dlt_daemon_event_handler.h"
 }
 #ifdef DLT_TRACE_LOAD_CTRL_ENABLE
 
@@ -493,10 +501,694 @@ TEST(t_trace_load_keep_message, normal) {
 
 #endif
 
+/* Begin Method: dlt_daemon_client::dlt_daemon_control_get_log_info */
+static void init_loginfo_daemon(DltDaemon *daemon, char *ecu)
+{
+    DltGateway gateway = {};
+
+    EXPECT_EQ(0,
+              dlt_daemon_init(daemon, DLT_DAEMON_RINGBUFFER_MIN_SIZE, DLT_DAEMON_RINGBUFFER_MAX_SIZE,
+                              DLT_DAEMON_RINGBUFFER_STEP_SIZE, DLT_RUNTIME_DEFAULT_DIRECTORY, DLT_LOG_INFO,
+                              DLT_TRACE_STATUS_OFF, 0, 0));
+    dlt_set_id(daemon->ecuid, ecu);
+    EXPECT_EQ(0, dlt_daemon_init_user_information(daemon, &gateway, 0, 0));
+}
+
+static void request_loginfo(int sock, DltDaemon *daemon, DltDaemonLocal *daemon_local,
+                            uint8_t options, const char *apid)
+{
+    DltServiceGetLogInfoRequest req = {};
+    DltMessage msg = {};
+
+    req.service_id = DLT_SERVICE_ID_GET_LOG_INFO;
+    req.options = options;
+    if (apid != NULL)
+        memcpy(req.apid, apid, DLT_ID_SIZE);
+
+    msg.databuffer = (uint8_t *)&req;
+    msg.datasize = sizeof(req);
+    dlt_daemon_control_get_log_info(sock, daemon, daemon_local, &msg, 0);
+}
+
+/* Read all responses from sock; returns number of messages, sums up app ids */
+static int receive_loginfo(int sock, int *status, int *num_apps)
+{
+    static uint8_t buf[512 * 1024];
+    ssize_t total = 0;
+    ssize_t n;
+    int messages = 0;
+    size_t offset = 0;
+
+    while ((n = recv(sock, buf + total, sizeof(buf) - (size_t)total, MSG_DONTWAIT)) > 0)
+        total += n;
+
+    *num_apps = 0;
+
+    while (offset + sizeof(DltStandardHeader) <= (size_t)total) {
+        DltStandardHeader *sh = (DltStandardHeader *)(buf + offset);
+        uint16_t len = DLT_BETOH_16(sh->len);
+        size_t payload = offset + sizeof(DltStandardHeader) +
+            DLT_STANDARD_HEADER_EXTRA_SIZE(sh->htyp) + sizeof(DltExtendedHeader);
+        uint32_t sid = 0;
+        uint16_t count = 0;
+
+        EXPECT_LE(offset + len, (size_t)total);
+        memcpy(&sid, buf + payload, sizeof(sid));
+        EXPECT_EQ((uint32_t)DLT_SERVICE_ID_GET_LOG_INFO, sid);
+        *status = buf[payload + sizeof(uint32_t)];
+
+        if (*status != 8) {
+            memcpy(&count, buf + payload + sizeof(uint32_t) + sizeof(uint8_t), sizeof(count));
+            *num_apps += count;
+            EXPECT_EQ(0, memcmp(buf + offset + len - DLT_ID_SIZE, DLT_DAEMON_REMO_STRING, DLT_ID_SIZE));
+        }
+        else {
+            /* no application count, but the reserved space stays at the end */
+            EXPECT_EQ(0, memcmp(buf + payload + sizeof(uint32_t) + sizeof(uint8_t),
+                                DLT_DAEMON_REMO_STRING, DLT_ID_SIZE));
+        }
+
+        offset += len;
+        messages++;
+    }
+
+    return messages;
+}
+
+TEST(t_dlt_daemon_control_get_log_info, normal)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    char ecu[] = "ECU1";
+    char apid[] = "APP1";
+    char ctid[] = "CT01";
+    char ctid2[] = "CT02";
+    char desc[] = "get log info test";
+    int sv[2];
+    int status = 0;
+    int num_apps = 0;
+    uint8_t *payload = NULL;
+    uint32_t generation = 0;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    init_loginfo_daemon(&daemon, ecu);
+
+    ASSERT_NE((DltDaemonApplication *)NULL,
+              dlt_daemon_application_add(&daemon, apid, 0, desc, -1, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid, DLT_LOG_INFO, DLT_TRACE_STATUS_OFF,
+                                     0, -1, desc, ecu, 0));
+
+    request_loginfo(sv[0], &daemon, &daemon_local, 7, NULL);
+    EXPECT_EQ(1, receive_loginfo(sv[1], &status, &num_apps));
+    EXPECT_EQ(7, status);
+    EXPECT_EQ(1, num_apps);
+
+    /* second request is served from the cache */
+    payload = daemon.loginfo_cache[0].payload;
+    generation = daemon.loginfo_generation;
+    ASSERT_NE((uint8_t *)NULL, payload);
+    request_loginfo(sv[0], &daemon, &daemon_local, 7, NULL);
+    EXPECT_EQ(1, receive_loginfo(sv[1], &status, &num_apps));
+    EXPECT_EQ(payload, daemon.loginfo_cache[0].payload);
+    EXPECT_EQ(generation, daemon.loginfo_cache[0].generation);
+
+    /* registering a context invalidates the cached response */
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid2, DLT_LOG_WARN, DLT_TRACE_STATUS_OFF,
+                                     1, -1, desc, ecu, 0));
+    EXPECT_NE(generation, daemon.loginfo_generation);
+    request_loginfo(sv[0], &daemon, &daemon_local, 6, apid);
+    EXPECT_EQ(1, receive_loginfo(sv[1], &status, &num_apps));
+    EXPECT_EQ(6, status);
+    EXPECT_EQ(2, daemon.user_list[0].num_contexts);
+
+    /* unknown application */
+    request_loginfo(sv[0], &daemon, &daemon_local, 6, "XXXX");
+    EXPECT_EQ(1, receive_loginfo(sv[1], &status, &num_apps));
+    EXPECT_EQ(8, status);
+
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(sv[0]);
+    close(sv[1]);
+}
+
+TEST(t_dlt_daemon_control_get_log_info, stream_large_response)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    char ecu[] = "ECU1";
+    char apid[DLT_ID_SIZE + 1];
+    char ctid[] = "CT01";
+    char desc[101];
+    const int total_apps = 700;
+    int sv[2];
+    int status = 0;
+    int num_apps = 0;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    init_loginfo_daemon(&daemon, ecu);
+    memset(desc, 'd', sizeof(desc) - 1);
+    desc[sizeof(desc) - 1] = '\0';
+
+    for (int i = 0; i < total_apps; i++) {
+        snprintf(apid, sizeof(apid), "A%03d", i);
+        ASSERT_NE((DltDaemonApplication *)NULL,
+                  dlt_daemon_application_add(&daemon, apid, 0, desc, -1, ecu, 0));
+        ASSERT_NE((DltDaemonContext *)NULL,
+                  dlt_daemon_context_add(&daemon, apid, ctid, DLT_LOG_INFO, DLT_TRACE_STATUS_OFF,
+                                         0, -1, desc, ecu, 0));
+    }
+
+    /* the complete response exceeds a single control message */
+    request_loginfo(sv[0], &daemon, &daemon_local, 7, NULL);
+    EXPECT_LT(1, receive_loginfo(sv[1], &status, &num_apps));
+    EXPECT_EQ(7, status);
+    EXPECT_EQ(total_apps, num_apps);
+
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(sv[0]);
+    close(sv[1]);
+}
+
+TEST(t_dlt_daemon_control_get_log_info, nullpointer)
+{
+    DltDaemon daemon = {};
+    DltMessage msg = {};
+
+    dlt_daemon_control_get_log_info(-1, NULL, NULL, NULL, 0);
+    dlt_daemon_control_get_log_info(-1, &daemon, NULL, NULL, 0);
+    dlt_daemon_control_get_log_info(-1, &daemon, NULL, &msg, 0);
+}
+/* End Method: dlt_daemon_client::dlt_daemon_control_get_log_info */
+
 /*##############################################################################################################################*/
 /*##############################################################################################################################*/
 /*##############################################################################################################################*/
 
+/* Begin Method: dlt_daemon_client::dlt_daemon_control_set_client_filter */
+static void request_client_filter(int sock, DltDaemon *daemon, DltDaemonLocal *daemon_local,
+                                  uint16_t count, const char *apid)
+{
+    uint8_t buf[sizeof(DltServiceSetClientFilter) + sizeof(DltServiceClientFilterEntry)] = {};
+    DltServiceSetClientFilter *req = (DltServiceSetClientFilter *)buf;
+    DltServiceClientFilterEntry *entry = (DltServiceClientFilterEntry *)(req + 1);
+    DltMessage msg = {};
+
+    req->service_id = DLT_SERVICE_ID_SET_CLIENT_FILTER;
+    req->count = count;
+
+    if (apid != NULL)
+        memcpy(entry->apid, apid, DLT_ID_SIZE);
+
+    msg.databuffer = buf;
+    msg.datasize = (count == 0) ? (int32_t)sizeof(DltServiceSetClientFilter) : (int32_t)sizeof(buf);
+    dlt_daemon_control_set_client_filter(sock, daemon, daemon_local, &msg, 0);
+}
+
+/* Send an info log message of apid to all clients */
+static void send_log(DltDaemon *daemon, DltDaemonLocal *daemon_local, int sock, const char *apid)
+{
+    uint8_t header[sizeof(DltStandardHeader) + sizeof(DltExtendedHeader)] = {};
+    DltStandardHeader *sh = (DltStandardHeader *)header;
+    DltExtendedHeader *eh = (DltExtendedHeader *)(sh + 1);
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+
+    sh->htyp = DLT_HTYP_UEH | DLT_HTYP_PROTOCOL_VERSION1;
+    sh->len = DLT_HTOBE_16(sizeof(header) + sizeof(payload));
+    eh->msin = (uint8_t)(DLT_MSIN_VERB | (DLT_LOG_INFO << DLT_MSIN_MTIN_SHIFT));
+    memcpy(eh->apid, apid, DLT_ID_SIZE);
+    memcpy(eh->ctid, "CT01", DLT_ID_SIZE);
+
+    EXPECT_EQ(DLT_DAEMON_ERROR_OK,
+              dlt_daemon_client_send(sock, daemon, daemon_local, NULL, 0, header, sizeof(header),
+                                     payload, sizeof(payload), 0));
+}
+
+/* Returns the application ids of all messages in buf one after another */
+static std::string parse_apids(uint8_t *buf, size_t total, int *response)
+{
+    size_t offset = 0;
+    std::string apids;
+
+    while (offset + sizeof(DltStandardHeader) + sizeof(DltExtendedHeader) <= total) {
+        DltStandardHeader *sh = (DltStandardHeader *)(buf + offset);
+        DltExtendedHeader *eh = (DltExtendedHeader *)(buf + offset + sizeof(DltStandardHeader) +
+                                                      DLT_STANDARD_HEADER_EXTRA_SIZE(sh->htyp));
+
+        if (DLT_GET_MSIN_MSTP(eh->msin) == DLT_TYPE_CONTROL)
+            /* status of the service response */
+            *response = *((uint8_t *)(eh + 1) + sizeof(uint32_t));
+        else
+            apids.append(eh->apid, DLT_ID_SIZE);
+
+        offset += DLT_BETOH_16(sh->len);
+    }
+
+    return apids;
+}
+
+/* Read all messages from sock, returns their application ids one after another */
+static std::string receive_apids(int sock, int *response)
+{
+    uint8_t buf[4096];
+    ssize_t total = 0;
+    ssize_t n;
+
+    while ((n = recv(sock, buf + total, sizeof(buf) - (size_t)total, MSG_DONTWAIT)) > 0)
+        total += n;
+
+    return parse_apids(buf, (size_t)total, response);
+}
+
+TEST(t_dlt_daemon_control_set_client_filter, normal)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    char ecu[] = "ECU1";
+    uint8_t batch[4096];
+    int filtered[2];
+    int unfiltered[2];
+    int response = -1;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, filtered));
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, unfiltered));
+    init_loginfo_daemon(&daemon, ecu);
+    daemon.mode = DLT_USER_MODE_EXTERNAL;
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, filtered[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, unfiltered[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+
+    request_client_filter(filtered[0], &daemon, &daemon_local, 1, "APP1");
+    EXPECT_EQ("", receive_apids(filtered[1], &response));
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_OK, response);
+    EXPECT_EQ(1, daemon_local.client_filters);
+
+    /* sent directly */
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_FORCE, "APP1");
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_FORCE, "APP2");
+    EXPECT_EQ("APP1", receive_apids(filtered[1], &response));
+    EXPECT_EQ("APP1APP2", receive_apids(unfiltered[1], &response));
+
+    /* batched for clients without filter */
+    dlt_daemon_change_state(&daemon, DLT_DAEMON_STATE_SEND_DIRECT);
+    dlt_daemon_client_batch_begin(&daemon_local, batch, sizeof(batch));
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_TO_ALL, "APP2");
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_TO_ALL, "APP1");
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_TO_ALL, "APP1");
+    EXPECT_EQ("APP1APP1", receive_apids(filtered[1], &response));
+    dlt_daemon_client_batch_flush(&daemon, &daemon_local, 0);
+    EXPECT_EQ("", receive_apids(filtered[1], &response));
+    EXPECT_EQ("APP2APP1APP1", receive_apids(unfiltered[1], &response));
+
+    /* no entries remove the filter */
+    request_client_filter(filtered[0], &daemon, &daemon_local, 0, NULL);
+    EXPECT_EQ(0, daemon_local.client_filters);
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_TO_ALL, "APP2");
+    EXPECT_EQ("APP2", receive_apids(filtered[1], &response));
+
+    /* the filter is released with the connection */
+    request_client_filter(filtered[0], &daemon, &daemon_local, 1, "APP1");
+    EXPECT_EQ(1, daemon_local.client_filters);
+    EXPECT_EQ(0, dlt_event_handler_unregister_connection(&daemon_local.pEvent, &daemon_local, filtered[0]));
+    EXPECT_EQ(0, daemon_local.client_filters);
+
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(filtered[1]);
+    close(unfiltered[1]);
+}
+
+TEST(t_dlt_daemon_control_set_client_filter, abnormal)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    DltMessage msg = {};
+    char ecu[] = "ECU1";
+    int client[2];
+    int response = -1;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, client));
+    init_loginfo_daemon(&daemon, ecu);
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+
+    /* not a client connection */
+    request_client_filter(client[0], &daemon, &daemon_local, 1, "APP1");
+    receive_apids(client[1], &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_ERROR, response);
+
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, client[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+
+    /* more filters announced than sent */
+    response = -1;
+    request_client_filter(client[0], &daemon, &daemon_local, 2, "APP1");
+    receive_apids(client[1], &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_ERROR, response);
+    EXPECT_EQ(0, daemon_local.client_filters);
+
+    dlt_daemon_control_set_client_filter(client[0], NULL, &daemon_local, &msg, 0);
+    dlt_daemon_control_set_client_filter(client[0], &daemon, NULL, &msg, 0);
+    dlt_daemon_control_set_client_filter(client[0], &daemon, &daemon_local, NULL, 0);
+    dlt_daemon_control_set_client_filter(client[0], &daemon, &daemon_local, &msg, 0);
+
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(client[1]);
+}
+/* End Method: dlt_daemon_client::dlt_daemon_control_set_client_filter */
+
+/* Begin Method: dlt_daemon_client::dlt_daemon_control_set_client_compression */
+static void request_client_compression(int sock, DltDaemon *daemon, DltDaemonLocal *daemon_local, uint8_t method)
+{
+    DltServiceSetClientCompression req = {};
+    DltMessage msg = {};
+
+    req.service_id = DLT_SERVICE_ID_SET_CLIENT_COMPRESSION;
+    req.method = method;
+
+    msg.databuffer = (uint8_t *)&req;
+    msg.datasize = (int32_t)sizeof(req);
+    dlt_daemon_control_set_client_compression(sock, daemon, daemon_local, &msg, 0);
+}
+
+/* Read and decompress all data from sock, returns the application ids */
+static std::string receive_compressed_apids(int sock, DltCompression *stream, int *response)
+{
+    uint8_t in[4096];
+    uint8_t out[16384];
+    ssize_t total = 0;
+    ssize_t n;
+    size_t offset = 0;
+    size_t produced = 0;
+
+    while ((n = recv(sock, in + total, sizeof(in) - (size_t)total, MSG_DONTWAIT)) > 0)
+        total += n;
+
+    while (offset < (size_t)total) {
+        size_t consumed = 0;
+        size_t written = 0;
+
+        if (dlt_compression_process(stream, in + offset, (size_t)total - offset, out + produced,
+                                    sizeof(out) - produced, &consumed, &written, true) != DLT_RETURN_OK)
+            break;
+
+        offset += consumed;
+        produced += written;
+    }
+
+    return parse_apids(out, produced, response);
+}
+
+TEST(t_dlt_daemon_control_set_client_compression, normal)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    DltConnection *con;
+    char ecu[] = "ECU1";
+    int compressed[2];
+    int plain[2];
+    int response = -1;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, compressed));
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, plain));
+    init_loginfo_daemon(&daemon, ecu);
+    daemon.mode = DLT_USER_MODE_EXTERNAL;
+    daemon_local.flags.clientCompressionFlushInterval = DLT_COMPRESSION_FLUSH_INTERVAL;
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, compressed[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, plain[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent,
+                                       timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK), POLLIN,
+                                       DLT_CONNECTION_TIMER));
+    con = dlt_event_handler_find_connection(&daemon_local.pEvent, compressed[0]);
+    ASSERT_NE((DltConnection *)NULL, con);
+
+    request_client_compression(compressed[0], &daemon, &daemon_local, DLT_COMPRESSION_DEFLATE);
+    EXPECT_EQ("", receive_apids(compressed[1], &response));
+
+#ifdef DLT_STREAM_COMPRESSION
+    DltDaemonTimerContext context = { &daemon, &daemon_local, 0 };
+    uint8_t batch[1024];
+    DltCompression *stream = dlt_compression_create(DLT_COMPRESSION_DEFLATE, false);
+    ASSERT_NE((DltCompression *)NULL, stream);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_OK, response);
+
+    /* only the compressed client has a flush timer */
+    DltConnection *plain_con = dlt_event_handler_find_connection(&daemon_local.pEvent, plain[0]);
+    ASSERT_NE((DltConnection *)NULL, plain_con);
+    EXPECT_TRUE(dlt_daemon_timer_pending(&con->timer));
+    EXPECT_FALSE(dlt_daemon_timer_pending(&plain_con->timer));
+
+    /* held back until the timer flushes the connection */
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_FORCE, "APP1");
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_FORCE, "APP2");
+    EXPECT_EQ("APP1APP2", receive_apids(plain[1], &response));
+    dlt_daemon_process_compression_timer(&con->timer, &context);
+    EXPECT_EQ("APP1APP2", receive_compressed_apids(compressed[1], stream, &response));
+
+    /* batched messages and further flushes continue the stream,
+     * the batch buffer is written out several times */
+    dlt_daemon_change_state(&daemon, DLT_DAEMON_STATE_SEND_DIRECT);
+    dlt_daemon_client_batch_begin(&daemon_local, batch, sizeof(batch));
+
+    for (int i = 0; i < 100; i++)
+        send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_TO_ALL, "APP3");
+
+    dlt_daemon_client_batch_flush(&daemon, &daemon_local, 0);
+    dlt_daemon_process_compression_timer(&con->timer, &context);
+    std::string apids = receive_compressed_apids(compressed[1], stream, &response);
+    EXPECT_EQ(400u, apids.size());
+    EXPECT_EQ(std::string::npos, apids.find_first_not_of("APP3"));
+    EXPECT_EQ(apids, receive_apids(plain[1], &response));
+
+    /* compression can only be requested once */
+    request_client_compression(compressed[0], &daemon, &daemon_local, DLT_COMPRESSION_DEFLATE);
+    dlt_daemon_process_compression_timer(&con->timer, &context);
+    receive_compressed_apids(compressed[1], stream, &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_ERROR, response);
+
+    dlt_compression_free(stream);
+#else
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_NOT_SUPPORTED, response);
+
+    send_log(&daemon, &daemon_local, DLT_DAEMON_SEND_FORCE, "APP1");
+    EXPECT_EQ("APP1", receive_apids(compressed[1], &response));
+#endif
+
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(compressed[1]);
+    close(plain[1]);
+}
+
+TEST(t_dlt_daemon_control_set_client_compression, abnormal)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    DltMessage msg = {};
+    char ecu[] = "ECU1";
+    int client[2];
+    int response = -1;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, client));
+    init_loginfo_daemon(&daemon, ecu);
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+
+    /* not a client connection */
+    request_client_compression(client[0], &daemon, &daemon_local, DLT_COMPRESSION_DEFLATE);
+    receive_apids(client[1], &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_ERROR, response);
+
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent, client[0], POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+
+    /* no flush timer */
+    response = -1;
+    request_client_compression(client[0], &daemon, &daemon_local, DLT_COMPRESSION_DEFLATE);
+    receive_apids(client[1], &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_NOT_SUPPORTED, response);
+
+    /* unknown method */
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local, &daemon_local.pEvent,
+                                       timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK), POLLIN,
+                                       DLT_CONNECTION_TIMER));
+    response = -1;
+    request_client_compression(client[0], &daemon, &daemon_local, 0x7f);
+    receive_apids(client[1], &response);
+    EXPECT_EQ(DLT_SERVICE_RESPONSE_NOT_SUPPORTED, response);
+
+    dlt_daemon_control_set_client_compression(client[0], NULL, &daemon_local, &msg, 0);
+    dlt_daemon_control_set_client_compression(client[0], &daemon, NULL, &msg, 0);
+    dlt_daemon_control_set_client_compression(client[0], &daemon, &daemon_local, NULL, 0);
+    dlt_daemon_control_set_client_compression(client[0], &daemon, &daemon_local, &msg, 0);
+
+    EXPECT_EQ((DltCompression *)NULL, dlt_compression_create(0x7f, true));
+
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(client[1]);
+}
+/* End Method: dlt_daemon_client::dlt_daemon_control_set_client_compression */
+
+/* Begin Method: dlt_daemon_client::dlt_daemon_control_set_log_level */
+static void request_log_level(int sock, DltDaemon *daemon, DltDaemonLocal *daemon_local,
+                              const char *apid, const char *ctid, uint8_t log_level)
+{
+    DltServiceSetLogLevel req = {};
+    DltMessage msg = {};
+
+    req.service_id = DLT_SERVICE_ID_SET_LOG_LEVEL;
+    strncpy(req.apid, apid, DLT_ID_SIZE);
+    strncpy(req.ctid, ctid, DLT_ID_SIZE);
+    req.log_level = log_level;
+
+    msg.databuffer = (uint8_t *)&req;
+    msg.datasize = (int32_t)sizeof(req);
+    dlt_daemon_control_set_log_level(sock, daemon, daemon_local, &msg, 0);
+}
+
+/* Read all service responses from sock, returns the number of responses with status ok */
+static int receive_responses(int sock, int *errors)
+{
+    uint8_t buf[4096];
+    ssize_t total = 0;
+    ssize_t n;
+    size_t offset = 0;
+    int ok = 0;
+
+    while ((n = recv(sock, buf + total, sizeof(buf) - (size_t)total, MSG_DONTWAIT)) > 0)
+        total += n;
+
+    *errors = 0;
+
+    while (offset + sizeof(DltStandardHeader) <= (size_t)total) {
+        DltStandardHeader *sh = (DltStandardHeader *)(buf + offset);
+        size_t payload = offset + sizeof(DltStandardHeader) +
+            DLT_STANDARD_HEADER_EXTRA_SIZE(sh->htyp) + sizeof(DltExtendedHeader);
+        DltServiceResponse resp;
+
+        memcpy(&resp, buf + payload, sizeof(resp));
+        EXPECT_EQ((uint32_t)DLT_SERVICE_ID_SET_LOG_LEVEL, resp.service_id);
+
+        if (resp.status == DLT_SERVICE_RESPONSE_OK)
+            ok++;
+        else
+            (*errors)++;
+
+        offset += DLT_BETOH_16(sh->len);
+    }
+
+    return ok;
+}
+
+TEST(t_dlt_daemon_control_set_log_level, wildcard_batch)
+{
+    DltDaemon daemon;
+    DltDaemonLocal daemon_local = {};
+    DltDaemonApplication *app = NULL;
+    char ecu[] = "ECU1";
+    char app1[] = "APP1";
+    char app2[] = "APP2";
+    char app3[] = "APP3";
+    char ct01[] = "CT01";
+    char ct02[] = "CT02";
+    char xx01[] = "XX01";
+    char desc[] = "set log level test";
+    uint8_t buffer[256];
+    DltUserHeader *userheader = (DltUserHeader *)buffer;
+    DltUserControlMsgLogLevelBatch *usermsg =
+        (DltUserControlMsgLogLevelBatch *)(buffer + sizeof(DltUserHeader));
+    DltUserControlMsgLogLevel *entries =
+        (DltUserControlMsgLogLevel *)(buffer + sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch));
+    size_t single = sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevel);
+    int sv[2];
+    int fifo1[2];
+    int fifo2[2];
+    int errors = 0;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    ASSERT_EQ(0, pipe(fifo1));
+    ASSERT_EQ(0, pipe(fifo2));
+    init_loginfo_daemon(&daemon, ecu);
+
+    /* APP1 announced the batch message, APP2 is an older library, APP3 is not connected */
+    app = dlt_daemon_application_add(&daemon, app1, 0, desc, fifo1[1], ecu, 0);
+    ASSERT_NE((DltDaemonApplication *)NULL, app);
+    app->log_level_batch = true;
+    ASSERT_NE((DltDaemonApplication *)NULL,
+              dlt_daemon_application_add(&daemon, app2, 0, desc, fifo2[1], ecu, 0));
+    ASSERT_NE((DltDaemonApplication *)NULL,
+              dlt_daemon_application_add(&daemon, app3, 0, desc, -1, ecu, 0));
+
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app1, ct01, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 0, fifo1[1], desc, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app1, ct02, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 1, fifo1[1], desc, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app1, xx01, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 2, fifo1[1], desc, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app2, ct01, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 0, fifo2[1], desc, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app2, ct02, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 1, fifo2[1], desc, ecu, 0));
+    ASSERT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, app3, ct01, DLT_LOG_INFO,
+                                     DLT_TRACE_STATUS_OFF, 0, -1, desc, ecu, 0));
+
+    request_log_level(sv[0], &daemon, &daemon_local, "", "CT*", DLT_LOG_DEBUG);
+
+    /* one response per matched context, like without batching */
+    EXPECT_EQ(4, receive_responses(sv[1], &errors));
+    EXPECT_EQ(1, errors);
+
+    /* APP1 gets one message for both matched contexts */
+    ASSERT_EQ((ssize_t)(sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch) +
+                        2 * sizeof(DltUserControlMsgLogLevel)),
+              read(fifo1[0], buffer, sizeof(buffer)));
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL_BATCH, userheader->message);
+    EXPECT_EQ(2U, usermsg->count);
+    EXPECT_EQ(DLT_LOG_DEBUG, entries[0].log_level);
+    EXPECT_EQ(0, entries[0].log_level_pos);
+    EXPECT_EQ(DLT_LOG_DEBUG, entries[1].log_level);
+    EXPECT_EQ(1, entries[1].log_level_pos);
+
+    /* APP2 gets one message per context */
+    ASSERT_EQ((ssize_t)(2 * single), read(fifo2[0], buffer, sizeof(buffer)));
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL, userheader->message);
+    EXPECT_EQ(DLT_LOG_DEBUG, ((DltUserControlMsgLogLevel *)(buffer + sizeof(DltUserHeader)))->log_level);
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL, ((DltUserHeader *)(buffer + single))->message);
+
+    EXPECT_EQ(DLT_LOG_DEBUG, dlt_daemon_context_find(&daemon, app1, ct02, ecu, 0)->log_level);
+    EXPECT_EQ(DLT_LOG_INFO, dlt_daemon_context_find(&daemon, app1, xx01, ecu, 0)->log_level);
+    EXPECT_EQ(DLT_LOG_DEBUG, dlt_daemon_context_find(&daemon, app2, ct01, ecu, 0)->log_level);
+    /* not sent, not changed */
+    EXPECT_EQ(DLT_LOG_INFO, dlt_daemon_context_find(&daemon, app3, ct01, ecu, 0)->log_level);
+
+    /* the application reading end is gone: error response and old log level */
+    signal(SIGPIPE, SIG_IGN);
+    close(fifo1[0]);
+    request_log_level(sv[0], &daemon, &daemon_local, "APP1", "", DLT_LOG_WARN);
+    EXPECT_EQ(0, receive_responses(sv[1], &errors));
+    EXPECT_EQ(3, errors);
+    EXPECT_EQ(DLT_LOG_DEBUG, dlt_daemon_context_find(&daemon, app1, ct01, ecu, 0)->log_level);
+    EXPECT_EQ(DLT_LOG_INFO, dlt_daemon_context_find(&daemon, app1, xx01, ecu, 0)->log_level);
+
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(fifo2[0]);
+    close(sv[0]);
+    close(sv[1]);
+}
+/* End Method: dlt_daemon_client::dlt_daemon_control_set_log_level */
+
 
 
 
@@ -1562,6 +1562,150 @@ TEST(t_dlt_daemon_contexts_load, nullpointer)
 
 
 
+/* Begin Method: dlt_daemon_common::dlt_daemon_runtime_snapshot_load */
+/* Save a runtime configuration with text files and snapshot in a new directory */
+static void snapshot_prepare(DltDaemon *daemon, DltGateway *gateway, char *directory)
+{
+    ID4 apid1 = "AP1";
+    ID4 apid2 = "AP2";
+    ID4 ctid1 = "CT1";
+    ID4 ctid2 = "CT2";
+    char desc[255] = "TEST dlt_daemon_runtime_snapshot";
+    char ecu[] = "ECU1";
+
+    ASSERT_NE((char *)NULL, mkdtemp(directory));
+    EXPECT_EQ(0,
+              dlt_daemon_init(daemon, DLT_DAEMON_RINGBUFFER_MIN_SIZE, DLT_DAEMON_RINGBUFFER_MAX_SIZE,
+                              DLT_DAEMON_RINGBUFFER_STEP_SIZE, directory, DLT_LOG_INFO,
+                              DLT_TRACE_STATUS_OFF, 0, 0));
+    dlt_set_id(daemon->ecuid, ecu);
+    EXPECT_EQ(0, dlt_daemon_init_user_information(daemon, gateway, 0, 0));
+    EXPECT_EQ(0, dlt_daemon_init_runtime_configuration(daemon, directory, 0));
+
+    /* added out of order */
+    EXPECT_NE((DltDaemonApplication *)NULL, dlt_daemon_application_add(daemon, apid2, 0, desc, -1, ecu, 0));
+    EXPECT_NE((DltDaemonApplication *)NULL, dlt_daemon_application_add(daemon, apid1, 0, NULL, -1, ecu, 0));
+    EXPECT_NE((DltDaemonContext *)NULL, dlt_daemon_context_add(daemon, apid2, ctid1, DLT_LOG_DEBUG,
+                                                               DLT_TRACE_STATUS_ON, 0, 0, desc, ecu, 0));
+    EXPECT_NE((DltDaemonContext *)NULL, dlt_daemon_context_add(daemon, apid1, ctid2, DLT_LOG_WARN,
+                                                               DLT_TRACE_STATUS_OFF, 0, 0, desc, ecu, 0));
+    EXPECT_NE((DltDaemonContext *)NULL, dlt_daemon_context_add(daemon, apid1, ctid1, DLT_LOG_DEFAULT,
+                                                               DLT_TRACE_STATUS_DEFAULT, 0, 0, NULL, ecu, 0));
+
+    EXPECT_EQ(0, dlt_daemon_applications_save(daemon, daemon->runtime_application_cfg, 0));
+    EXPECT_EQ(0, dlt_daemon_contexts_save(daemon, daemon->runtime_context_cfg, 0));
+    EXPECT_EQ(0, dlt_daemon_runtime_snapshot_save(daemon, daemon->runtime_snapshot, 0));
+
+    EXPECT_LE(0, dlt_daemon_contexts_clear(daemon, ecu, 0));
+    EXPECT_LE(0, dlt_daemon_applications_clear(daemon, ecu, 0));
+}
+
+static void snapshot_cleanup(DltDaemon *daemon, char *directory)
+{
+    EXPECT_LE(0, dlt_daemon_contexts_clear(daemon, daemon->ecuid, 0));
+    EXPECT_LE(0, dlt_daemon_applications_clear(daemon, daemon->ecuid, 0));
+    unlink(daemon->runtime_application_cfg);
+    unlink(daemon->runtime_context_cfg);
+    unlink(daemon->runtime_snapshot);
+    EXPECT_EQ(0, rmdir(directory));
+    EXPECT_EQ(0, dlt_daemon_free(daemon, 0));
+}
+
+TEST(t_dlt_daemon_runtime_snapshot_load, normal)
+{
+    DltDaemon daemon;
+    DltGateway gateway;
+    ID4 apid1 = "AP1";
+    ID4 apid2 = "AP2";
+    ID4 ctid1 = "CT1";
+    ID4 ctid2 = "CT2";
+    char directory[] = "/tmp/gtest_dlt_snapshot_XXXXXX";
+    DltDaemonApplication *app = NULL;
+    DltDaemonContext *context = NULL;
+
+    snapshot_prepare(&daemon, &gateway, directory);
+
+    /* Normal Use-Case, same registry as before */
+    EXPECT_EQ(0, dlt_daemon_runtime_snapshot_load(&daemon, daemon.runtime_snapshot, 0));
+    EXPECT_EQ(2, daemon.user_list[0].num_applications);
+    EXPECT_EQ(3, daemon.user_list[0].num_contexts);
+
+    app = dlt_daemon_application_find(&daemon, apid2, daemon.ecuid, 0);
+    ASSERT_NE((DltDaemonApplication *)NULL, app);
+    EXPECT_STREQ("TEST dlt_daemon_runtime_snapshot", app->application_description);
+    EXPECT_EQ(1, app->num_contexts);
+    app = dlt_daemon_application_find(&daemon, apid1, daemon.ecuid, 0);
+    ASSERT_NE((DltDaemonApplication *)NULL, app);
+    EXPECT_EQ(2, app->num_contexts);
+
+    context = dlt_daemon_context_find(&daemon, apid2, ctid1, daemon.ecuid, 0);
+    ASSERT_NE((DltDaemonContext *)NULL, context);
+    EXPECT_EQ(DLT_LOG_DEBUG, context->log_level);
+    EXPECT_EQ(DLT_TRACE_STATUS_ON, context->trace_status);
+    EXPECT_TRUE(context->predefined);
+    context = dlt_daemon_context_find(&daemon, apid1, ctid2, daemon.ecuid, 0);
+    ASSERT_NE((DltDaemonContext *)NULL, context);
+    EXPECT_EQ(DLT_LOG_WARN, context->log_level);
+    context = dlt_daemon_context_find(&daemon, apid1, ctid1, daemon.ecuid, 0);
+    ASSERT_NE((DltDaemonContext *)NULL, context);
+    EXPECT_EQ(DLT_LOG_DEFAULT, context->log_level);
+
+    snapshot_cleanup(&daemon, directory);
+}
+TEST(t_dlt_daemon_runtime_snapshot_load, abnormal)
+{
+    DltDaemon daemon;
+    DltGateway gateway;
+    char directory[] = "/tmp/gtest_dlt_snapshot_XXXXXX";
+    FILE *file;
+    int byte;
+
+    snapshot_prepare(&daemon, &gateway, directory);
+
+    /* Snapshot does not exist */
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(&daemon, "/tmp/PATH_DONT_EXIST", 0));
+
+    /* Text configuration changed after the snapshot was saved */
+    file = fopen(daemon.runtime_context_cfg, "a");
+    ASSERT_NE((FILE *)NULL, file);
+    fprintf(file, "AP3:CT3:4:0:edited:\n");
+    fclose(file);
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(&daemon, daemon.runtime_snapshot, 0));
+    EXPECT_EQ(0, daemon.user_list[0].num_contexts);
+
+    /* Corrupted snapshot */
+    snapshot_cleanup(&daemon, directory);
+    strcpy(directory, "/tmp/gtest_dlt_snapshot_XXXXXX");
+    snapshot_prepare(&daemon, &gateway, directory);
+    file = fopen(daemon.runtime_snapshot, "r+");
+    ASSERT_NE((FILE *)NULL, file);
+    fseek(file, -2, SEEK_END);
+    byte = fgetc(file);
+    fseek(file, -2, SEEK_END);
+    fputc(byte ^ 0x01, file);
+    fclose(file);
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(&daemon, daemon.runtime_snapshot, 0));
+    EXPECT_EQ(0, daemon.user_list[0].num_applications);
+
+    snapshot_cleanup(&daemon, directory);
+}
+TEST(t_dlt_daemon_runtime_snapshot_load, nullpointer)
+{
+    DltDaemon daemon;
+    const char *filename = "/tmp/dlt-runtime.snapshot";
+
+    /* NULL-Pointer */
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(NULL, NULL, 0));
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(NULL, filename, 0));
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_load(&daemon, NULL, 0));
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_save(NULL, filename, 0));
+    EXPECT_GE(-1, dlt_daemon_runtime_snapshot_save(&daemon, NULL, 0));
+}
+/* End Method: dlt_daemon_common::dlt_daemon_runtime_snapshot_load */
+
+
+
+
 
 /*##############################################################################################################################*/
 /*##############################################################################################################################*/
@@ -1716,6 +1860,144 @@ TEST(t_dlt_daemon_user_send_log_level, nullpointer)
 
 
 
+/* Begin Method: dlt_daemon_common::dlt_daemon_user_log_level_batch_flush */
+TEST(t_dlt_daemon_user_log_level_batch_flush, normal)
+{
+    DltDaemon daemon;
+    DltGateway gateway;
+    ID4 apid = "TES";
+    ID4 ctid1 = "CO1";
+    ID4 ctid2 = "CO2";
+    char desc[255] = "TEST dlt_daemon_user_log_level_batch_flush";
+    DltDaemonApplication *app = NULL;
+    char ecu[] = "ECU1";
+    char buffer[256];
+    DltUserHeader *userheader = (DltUserHeader *)buffer;
+    DltUserControlMsgLogLevelBatch *usermsg =
+        (DltUserControlMsgLogLevelBatch *)(buffer + sizeof(DltUserHeader));
+    DltUserControlMsgLogLevel *entries =
+        (DltUserControlMsgLogLevel *)(buffer + sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch));
+    int fds[2];
+
+    ASSERT_EQ(0, pipe(fds));
+
+    /* Normal Use-Case, one message for all contexts of the application */
+    EXPECT_EQ(0,
+              dlt_daemon_init(&daemon, DLT_DAEMON_RINGBUFFER_MIN_SIZE, DLT_DAEMON_RINGBUFFER_MAX_SIZE,
+                              DLT_DAEMON_RINGBUFFER_STEP_SIZE, DLT_RUNTIME_DEFAULT_DIRECTORY, DLT_LOG_INFO,
+                              DLT_TRACE_STATUS_OFF, 0, 0));
+    dlt_set_id(daemon.ecuid, ecu);
+    EXPECT_EQ(0, dlt_daemon_init_user_information(&daemon, &gateway, 0, 0));
+    app = dlt_daemon_application_add(&daemon, apid, 0, desc, fds[1], ecu, 0);
+    ASSERT_NE((DltDaemonApplication *)NULL, app);
+    /* announced by the library when registering */
+    app->log_level_batch = true;
+    EXPECT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid1, DLT_LOG_DEFAULT,
+                                     DLT_TRACE_STATUS_DEFAULT, 0, fds[1], desc, ecu, 0));
+    EXPECT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid2, DLT_LOG_DEFAULT,
+                                     DLT_TRACE_STATUS_DEFAULT, 1, fds[1], desc, ecu, 0));
+
+    dlt_daemon_user_send_all_log_level_update(&daemon, 0, 0, DLT_LOG_WARN, 0);
+
+    ASSERT_EQ((ssize_t)(sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevelBatch) +
+                        2 * sizeof(DltUserControlMsgLogLevel)),
+              read(fds[0], buffer, sizeof(buffer)));
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL_BATCH, userheader->message);
+    EXPECT_EQ(2U, usermsg->count);
+    EXPECT_EQ(DLT_LOG_WARN, entries[0].log_level);
+    EXPECT_EQ(DLT_TRACE_STATUS_OFF, entries[0].trace_status);
+    EXPECT_EQ(0, entries[0].log_level_pos);
+    EXPECT_EQ(DLT_LOG_WARN, entries[1].log_level);
+    EXPECT_EQ(1, entries[1].log_level_pos);
+
+    EXPECT_LE(0, dlt_daemon_contexts_clear(&daemon, ecu, 0));
+    EXPECT_LE(0, dlt_daemon_applications_clear(&daemon, ecu, 0));
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(fds[0]);
+    close(fds[1]);
+}
+TEST(t_dlt_daemon_user_log_level_batch_flush, fallback)
+{
+    DltDaemon daemon;
+    DltGateway gateway;
+    ID4 apid = "TES";
+    ID4 ctid1 = "CO1";
+    ID4 ctid2 = "CO2";
+    char desc[255] = "TEST dlt_daemon_user_log_level_batch_flush";
+    DltDaemonApplication *app = NULL;
+    char ecu[] = "ECU1";
+    char buffer[256];
+    DltUserHeader *userheader = (DltUserHeader *)buffer;
+    DltUserControlMsgLogLevel *entries = (DltUserControlMsgLogLevel *)(buffer + sizeof(DltUserHeader));
+    size_t size = sizeof(DltUserHeader) + sizeof(DltUserControlMsgLogLevel);
+    int fds[2];
+
+    ASSERT_EQ(0, pipe(fds));
+
+    /* Library without DLT_USER_APP_FLAG_LOG_LEVEL_BATCH, one message per context */
+    EXPECT_EQ(0,
+              dlt_daemon_init(&daemon, DLT_DAEMON_RINGBUFFER_MIN_SIZE, DLT_DAEMON_RINGBUFFER_MAX_SIZE,
+                              DLT_DAEMON_RINGBUFFER_STEP_SIZE, DLT_RUNTIME_DEFAULT_DIRECTORY, DLT_LOG_INFO,
+                              DLT_TRACE_STATUS_OFF, 0, 0));
+    dlt_set_id(daemon.ecuid, ecu);
+    EXPECT_EQ(0, dlt_daemon_init_user_information(&daemon, &gateway, 0, 0));
+    app = dlt_daemon_application_add(&daemon, apid, 0, desc, fds[1], ecu, 0);
+    ASSERT_NE((DltDaemonApplication *)NULL, app);
+    EXPECT_FALSE(app->log_level_batch);
+    EXPECT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid1, DLT_LOG_DEFAULT,
+                                     DLT_TRACE_STATUS_DEFAULT, 0, fds[1], desc, ecu, 0));
+    EXPECT_NE((DltDaemonContext *)NULL,
+              dlt_daemon_context_add(&daemon, apid, ctid2, DLT_LOG_DEFAULT,
+                                     DLT_TRACE_STATUS_DEFAULT, 1, fds[1], desc, ecu, 0));
+
+    dlt_daemon_user_send_all_log_level_update(&daemon, 0, 0, DLT_LOG_WARN, 0);
+
+    ASSERT_EQ((ssize_t)(2 * size), read(fds[0], buffer, sizeof(buffer)));
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL, userheader->message);
+    EXPECT_EQ(DLT_LOG_WARN, entries->log_level);
+    EXPECT_EQ(0, entries->log_level_pos);
+    userheader = (DltUserHeader *)(buffer + size);
+    entries = (DltUserControlMsgLogLevel *)(buffer + size + sizeof(DltUserHeader));
+    EXPECT_EQ((uint32_t)DLT_USER_MESSAGE_LOG_LEVEL, userheader->message);
+    EXPECT_EQ(DLT_LOG_WARN, entries->log_level);
+    EXPECT_EQ(1, entries->log_level_pos);
+
+    EXPECT_LE(0, dlt_daemon_contexts_clear(&daemon, ecu, 0));
+    EXPECT_LE(0, dlt_daemon_applications_clear(&daemon, ecu, 0));
+    EXPECT_EQ(0, dlt_daemon_free(&daemon, 0));
+    close(fds[0]);
+    close(fds[1]);
+}
+TEST(t_dlt_daemon_user_log_level_batch_flush, abnormal)
+{
+    DltDaemon daemon;
+    DltDaemonLogLevelBatch batch;
+
+    /* Empty batch is not sent */
+    dlt_daemon_user_log_level_batch_init(&batch);
+    EXPECT_EQ(0, dlt_daemon_user_log_level_batch_flush(&daemon, &batch, 0));
+}
+TEST(t_dlt_daemon_user_log_level_batch_flush, nullpointer)
+{
+    DltDaemon daemon;
+    DltDaemonLogLevelBatch batch;
+    DltDaemonContext daecontext;
+
+    /* NULL-Pointer */
+    EXPECT_GE(-1, dlt_daemon_user_log_level_batch_flush(NULL, &batch, 0));
+    EXPECT_GE(-1, dlt_daemon_user_log_level_batch_flush(&daemon, NULL, 0));
+    EXPECT_GE(-1, dlt_daemon_user_log_level_batch_add(NULL, &batch, &daecontext, 0));
+    EXPECT_GE(-1, dlt_daemon_user_log_level_batch_add(&daemon, NULL, &daecontext, 0));
+    EXPECT_GE(-1, dlt_daemon_user_log_level_batch_add(&daemon, &batch, NULL, 0));
+}
+/* End Method: dlt_daemon_common::dlt_daemon_user_log_level_batch_flush */
+
+
+
+
 /* Begin Method: dlt_daemon_common::dlt_daemon_user_send_log_state */
 TEST(t_dlt_daemon_user_send_log_state, normal)
 {
@@ -56,18 +56,26 @@
 #include <gtest/gtest.h>
 #include <limits.h>
 #include <syslog.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
 
 extern "C"
 {
 #include "dlt_gateway.h"
 #include "dlt_gateway_internal.h"
+#include "dlt_daemon_connection.h"
+#include "dlt_daemon_event_handler.h"
 }
 
 /* Begin Method: dlt_gateway::t_dlt_gateway_init*/
 TEST(t_dlt_gateway_init, normal)
 {
     DltDaemonLocal daemon_local = {};
-    DltGatewayConnection connections;
+    DltGatewayConnection connections = {};
     daemon_local.pGateway.connections = &connections;
     daemon_local.pGateway.num_connections = 1;
     daemon_local.flags.lflag = 0;
@@ -92,11 +100,27 @@ TEST(t_dlt_gateway_init, nullpointer)
     EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_init(NULL, 0));
 }
 
+/* Complete the connections to passive nodes which dlt_gateway_init() started */
+static void t_dlt_gateway_wait_connected(DltGateway *gateway)
+{
+    for (int i = 0; i < gateway->num_connections; i++) {
+        DltGatewayConnection *con = &gateway->connections[i];
+        struct pollfd pfd = { con->client.sock, POLLOUT, 0 };
+
+        if (con->status != DLT_GATEWAY_CONNECTING)
+            continue;
+
+        EXPECT_EQ(1, poll(&pfd, 1, 1000));
+        EXPECT_EQ(DLT_RETURN_OK, dlt_client_connect_finish(&con->client, 0));
+        con->status = DLT_GATEWAY_CONNECTED;
+    }
+}
+
 /* Begin Method: dlt_gateway::t_dlt_gateway_send_control_message*/
 TEST(t_dlt_gateway_send_control_message, Normal)
 {
-    DltDaemonLocal daemon_local;
-    DltGatewayConnection connections;
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
     DltConnection connections1;
     DltReceiver receiver1;
     DltPassiveControlMessage p_control_msgs;
@@ -118,6 +142,7 @@ TEST(t_dlt_gateway_send_control_message, Normal)
     memset(daemon_local.flags.gatewayConfigFile, 0, DLT_DAEMON_FLAG_MAX);
     strncpy(daemon_local.flags.gatewayConfigFile, "/tmp/dlt_gateway.conf", DLT_DAEMON_FLAG_MAX - 1);
     (void) dlt_gateway_init(&daemon_local, 0);
+    t_dlt_gateway_wait_connected(&daemon_local.pGateway);
 
     daemon_local.pGateway.connections->p_control_msgs->id = DLT_SERVICE_ID_GET_LOG_INFO;
     daemon_local.pGateway.connections->p_control_msgs->type = CONTROL_MESSAGE_ON_DEMAND;
@@ -144,8 +169,8 @@ TEST(t_dlt_gateway_send_control_message, Normal)
 
 TEST(t_dlt_gateway_send_control_message, nullpointer)
 {
-    DltDaemonLocal daemon_local;
-    DltGatewayConnection connections;
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
     DltConnection connections1;
     DltReceiver receiver1;
     DltPassiveControlMessage p_control_msgs;
@@ -173,7 +198,7 @@ TEST(t_dlt_gateway_store_connection, normal)
 {
     char ip_address[DLT_CONFIG_FILE_ENTRY_MAX_LEN] = "10.113.100.100";
     char ecuid[] = "1234";
-    DltGateway gateway;
+    DltGateway gateway = {};
     DltGatewayConnection tmp;
     DltGatewayConnection tmp1;
     gateway.num_connections = 1;
@@ -196,7 +221,7 @@ TEST(t_dlt_gateway_store_connection, normal)
 
 TEST(t_dlt_gateway_store_connection, nullpointer)
 {
-    DltGateway gateway;
+    DltGateway gateway = {};
 
     EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_store_connection(NULL, NULL, 0));
     EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_store_connection(&gateway, NULL, 0));
@@ -384,9 +409,9 @@ TEST(t_dlt_gateway_establish_connections, normal)
 {
     char ip[] = "127.0.0.1";
     int port = 3491;
-    DltDaemonLocal daemon_local;
+    DltDaemonLocal daemon_local = {};
     DltGateway *gateway = &daemon_local.pGateway;
-    DltGatewayConnection connections;
+    DltGatewayConnection connections = {};
     gateway->num_connections = 1;
     gateway->connections = &connections;
     gateway->connections->status = DLT_GATEWAY_INITIALIZED;
@@ -407,8 +432,8 @@ TEST(t_dlt_gateway_establish_connections, nullpointer)
 TEST(t_dlt_gateway_get_connection_receiver, normal)
 {
     DltReceiver *ret = NULL;
-    DltGateway gateway;
-    DltGatewayConnection connections;
+    DltGateway gateway = {};
+    DltGatewayConnection connections = {};
     memset(&gateway, 0, sizeof(DltGateway));
     memset(&connections, 0, sizeof(DltGatewayConnection));
     gateway.connections = &connections;
@@ -425,8 +450,8 @@ TEST(t_dlt_gateway_get_connection_receiver, normal)
 TEST(t_dlt_gateway_get_connection_receiver, abnormal)
 {
     DltReceiver *ret = NULL;
-    DltGateway gateway;
-    DltGatewayConnection connections;
+    DltGateway gateway = {};
+    DltGatewayConnection connections = {};
     memset(&gateway, 0, sizeof(DltGateway));
     memset(&connections, 0, sizeof(DltGatewayConnection));
     gateway.connections = &connections;
@@ -453,7 +478,7 @@ TEST(t_dlt_gateway_parse_get_log_info, normal)
     int32_t len;
     int32_t ret = DLT_RETURN_ERROR;
     DltDaemon daemon;
-    DltGateway gateway;
+    DltGateway gateway = {};
     DltMessage msg;
     char ecuid[] = "ECU2";
     uint32_t sid = DLT_SERVICE_ID_GET_LOG_INFO;
@@ -567,9 +592,9 @@ TEST(t_dlt_gateway_parse_get_log_info, nullpointer)
 TEST(t_dlt_gateway_process_passive_node_messages, normal)
 {
     DltDaemon daemon;
-    DltDaemonLocal daemon_local;
+    DltDaemonLocal daemon_local = {};
     DltReceiver receiver;
-    DltGatewayConnection connections;
+    DltGatewayConnection connections = {};
     memset(&daemon, 0, sizeof(DltDaemon));
     memset(&daemon_local, 0, sizeof(DltDaemonLocal));
     memset(&receiver, 0, sizeof(DltReceiver));
@@ -589,37 +614,81 @@ TEST(t_dlt_gateway_process_passive_node_messages, nullpointer)
 /* Begin Method: dlt_gateway::t_dlt_gateway_process_gateway_timer*/
 TEST(t_dlt_gateway_process_gateway_timer, normal)
 {
-    char ECUVersionString[] = "12.34";
+    char ecu[] = "PN1";
     char ip[] = "127.0.0.1";
-    int port = 3491;
-    DltDaemon daemon;
-    DltDaemonLocal daemon_local;
-    DltReceiver receiver;
-    DltGatewayConnection connections;
-    DltConnection connections1;
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    DltDaemon daemon = {};
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
+    DltDaemonTimer timer = {};
+    DltDaemonTimerContext context = { &daemon, &daemon_local, 0 };
+    struct pollfd pfd = {};
+    int node = socket(AF_INET, SOCK_STREAM, 0);
+
+    /* bound but not listening: the passive node refuses connections */
+    ASSERT_LE(0, node);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(node, (struct sockaddr *)&addr, sizeof(addr)));
+    ASSERT_EQ(0, getsockname(node, (struct sockaddr *)&addr, &len));
+
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+    connections.ecuid = ecu;
+    connections.status = DLT_GATEWAY_INITIALIZED;
+    connections.trigger = DLT_GATEWAY_ON_STARTUP;
+    ASSERT_EQ(DLT_RETURN_OK, dlt_client_init_port(&connections.client, ntohs(addr.sin_port), 0));
+    ASSERT_EQ(DLT_RETURN_OK, dlt_client_set_server_ip(&connections.client, ip));
     daemon_local.pGateway.connections = &connections;
     daemon_local.pGateway.num_connections = 1;
-    DltLogStorage storage_handle;
-    daemon_local.pGateway.connections->status = DLT_GATEWAY_INITIALIZED;
-    daemon_local.pGateway.connections->trigger = DLT_GATEWAY_ON_STARTUP;
-    daemon_local.pGateway.connections->client.mode = DLT_CLIENT_MODE_TCP;
-    daemon_local.pGateway.connections->client.servIP = ip;
-    daemon_local.pGateway.connections->client.port = static_cast<uint16_t>(port);
 
+    /* a non-blocking connect on loopback is pending until the node answers */
+    dlt_gateway_process_gateway_timer(&timer, &context);
+    EXPECT_EQ(DLT_GATEWAY_CONNECTING, connections.status);
+    EXPECT_TRUE(dlt_daemon_timer_pending(&connections.connect_timer));
 
-    daemon_local.pEvent.connections = &connections1;
-    daemon_local.pEvent.connections->receiver = &receiver;
-    daemon.ECUVersionString = ECUVersionString;
-    daemon.storage_handle = &storage_handle;
-    daemon_local.pEvent.connections->receiver->fd = -1;
+    /* the refused connect completes, the node is down */
+    pfd.fd = connections.client.sock;
+    pfd.events = POLLOUT;
+    ASSERT_EQ(1, poll(&pfd, 1, 5000));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_gateway_finish_connection(&daemon_local, &connections, 0));
+    EXPECT_EQ(DLT_GATEWAY_DISCONNECTED, connections.status);
+    EXPECT_EQ(-1, connections.client.sock);
+    EXPECT_EQ(1, connections.timeout_cnt);
+    EXPECT_FALSE(dlt_daemon_timer_pending(&connections.connect_timer));
+
+    /* the next timer tries again */
+    dlt_gateway_process_gateway_timer(&timer, &context);
+    EXPECT_EQ(DLT_GATEWAY_CONNECTING, connections.status);
 
-    EXPECT_EQ(DLT_RETURN_OK,
-              dlt_gateway_process_gateway_timer(&daemon, &daemon_local, daemon_local.pEvent.connections->receiver, 1));
+    dlt_daemon_timer_cancel(&connections.connect_timer);
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+    dlt_receiver_free(&connections.client.receiver);
+    free(connections.client.servIP);
+    close(node);
 }
 
 TEST(t_dlt_gateway_process_gateway_timer, nullpointer)
 {
-    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_process_gateway_timer(NULL, NULL, NULL, 0));
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
+    DltDaemonTimer timer = {};
+    DltDaemonTimerContext context = { NULL, &daemon_local, 0 };
+    DltDaemonTimerContext no_daemon_local = {};
+
+    connections.status = DLT_GATEWAY_INITIALIZED;
+    connections.trigger = DLT_GATEWAY_ON_STARTUP;
+    connections.client.sock = -1;
+    daemon_local.pGateway.connections = &connections;
+    daemon_local.pGateway.num_connections = 1;
+
+    /* no connection is started */
+    dlt_gateway_process_gateway_timer(NULL, &context);
+    dlt_gateway_process_gateway_timer(&timer, NULL);
+    dlt_gateway_process_gateway_timer(&timer, &no_daemon_local);
+    EXPECT_EQ(DLT_GATEWAY_INITIALIZED, connections.status);
+    EXPECT_EQ(-1, connections.client.sock);
+    EXPECT_EQ(0, connections.timeout_cnt);
 }
 
 /* Begin Method: dlt_gateway::t_dlt_gateway_process_on_demand_request*/
@@ -627,8 +696,8 @@ TEST(t_dlt_gateway_process_on_demand_request, normal)
 {
     char node_id[DLT_ID_SIZE] = "123";
     uint32_t conn_status = 1;
-    DltDaemonLocal daemon_local;
-    DltGatewayConnection connections;
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
     daemon_local.pGateway.connections = &connections;
     daemon_local.pGateway.num_connections = 1;
     connections.status = DLT_GATEWAY_CONNECTED;
@@ -646,12 +715,13 @@ TEST(t_dlt_gateway_process_on_demand_request, abnormal)
 {
     char node_id[DLT_ID_SIZE] = "123";
     uint32_t conn_status = 1;
-    DltDaemonLocal daemon_local;
-    DltGatewayConnection connections;
+    DltDaemonLocal daemon_local = {};
+    DltGatewayConnection connections = {};
     daemon_local.pGateway.connections = &connections;
     daemon_local.pGateway.num_connections = 1;
     connections.status = DLT_GATEWAY_INITIALIZED;
     connections.ecuid = node_id;
+    connections.client.mode = DLT_CLIENT_MODE_UNDEFINED;
 
     EXPECT_EQ(DLT_RETURN_ERROR, dlt_gateway_process_on_demand_request(&daemon_local.pGateway,
                                                                       &daemon_local,
@@ -675,7 +745,7 @@ TEST(t_dlt_gateway_check_param, normal)
     char value_1[DLT_CONFIG_FILE_ENTRY_MAX_LEN] = "10.11.22.33";
 #endif
     char value_2[DLT_CONFIG_FILE_ENTRY_MAX_LEN] = "3490";
-    DltGateway gateway;
+    DltGateway gateway = {};
     DltGatewayConnection tmp;
     gateway.connections = &tmp;
 
@@ -697,7 +767,7 @@ TEST(t_dlt_gateway_check_param, abnormal)
 #else
     char value_1[DLT_CONFIG_FILE_ENTRY_MAX_LEN] = "10.11.22.33";
 #endif
-    DltGateway gateway;
+    DltGateway gateway = {};
     DltGatewayConnection tmp;
     gateway.connections = &tmp;
 
@@ -715,7 +785,7 @@ TEST(t_dlt_gateway_check_param, nullpointer)
 /* Begin Method: dlt_gateway::t_dlt_gateway_configure*/
 TEST(t_dlt_gateway_configure, Normal)
 {
-    DltGateway gateway;
+    DltGateway gateway = {};
     DltGatewayConnection tmp;
     gateway.connections = &tmp;
     gateway.num_connections = 1;
@@ -730,8 +800,218 @@ TEST(t_dlt_gateway_configure, nullpointer)
     EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_configure(NULL, NULL, 0));
 }
 
+/* Begin Method: dlt_gateway::t_dlt_gateway_get_connection*/
+TEST(t_dlt_gateway_get_connection, normal)
+{
+    char ecu[4][DLT_ID_SIZE + 1] = { "ECU1", "ECU2", "E3", "ECU4" };
+    DltGatewayConnection connections[4] = {};
+    DltGateway gateway = {};
+    int i = 0;
+
+    for (i = 0; i < 4; i++)
+        connections[i].ecuid = ecu[i];
+
+    gateway.connections = connections;
+    gateway.num_connections = 4;
+
+    /* linear search without index */
+    EXPECT_EQ(&connections[1], dlt_gateway_get_connection(&gateway, ecu[1], 0));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_gateway_build_ecu_index(&gateway));
+
+    for (i = 0; i < 4; i++)
+        EXPECT_EQ(&connections[i], dlt_gateway_get_connection(&gateway, ecu[i], 0));
+
+    free(gateway.ecu_index);
+}
+
+TEST(t_dlt_gateway_get_connection, abnormal)
+{
+    char ecu[DLT_ID_SIZE + 1] = "ECU1";
+    char unknown[DLT_ID_SIZE + 1] = "ECU9";
+    DltGatewayConnection connections = {};
+    DltGateway gateway = {};
+    connections.ecuid = ecu;
+    gateway.connections = &connections;
+    gateway.num_connections = 1;
+
+    EXPECT_EQ(NULL, dlt_gateway_get_connection(&gateway, unknown, 0));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_gateway_build_ecu_index(&gateway));
+    EXPECT_EQ(NULL, dlt_gateway_get_connection(&gateway, unknown, 0));
+
+    free(gateway.ecu_index);
+}
+
+TEST(t_dlt_gateway_get_connection, nullpointer)
+{
+    EXPECT_EQ(NULL, dlt_gateway_get_connection(NULL, NULL, 0));
+}
+
+/* Several passive nodes on loopback: three listening, one refusing */
+#define GTEST_PASSIVE_NODES 4
+#define GTEST_PASSIVE_NODES_UP 3
+
+static int gtest_listen_loopback(uint16_t *port)
+{
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    if ((fd < 0) ||
+        (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (listen(fd, 1) != 0) ||
+        (getsockname(fd, (struct sockaddr *)&addr, &len) != 0))
+        return -1;
+
+    *port = ntohs(addr.sin_port);
+
+    return fd;
+}
+
+static void gtest_passive_node_message(uint8_t *buf, const char *ecu)
+{
+    /* standard header with ECU id, 4 bytes payload */
+    buf[0] = DLT_HTYP_WEID | DLT_HTYP_PROTOCOL_VERSION1;
+    buf[1] = 0;
+    buf[2] = 0;
+    buf[3] = 12;
+    memcpy(buf + 4, ecu, DLT_ID_SIZE);
+    memset(buf + 8, 0, 4);
+}
+
+/* Begin Method: dlt_gateway::t_dlt_gateway_start_connection*/
+TEST(t_dlt_gateway_start_connection, topology)
+{
+    char ecu[GTEST_PASSIVE_NODES][DLT_ID_SIZE + 1] = { "PN1", "PN2", "PN3", "PN4" };
+    char ip[] = "127.0.0.1";
+    int listener[GTEST_PASSIVE_NODES] = { -1, -1, -1, -1 };
+    int peer[GTEST_PASSIVE_NODES] = { -1, -1, -1, -1 };
+    uint16_t port[GTEST_PASSIVE_NODES] = { 0 };
+    DltGatewayConnection connections[GTEST_PASSIVE_NODES] = {};
+    DltDaemon daemon = {};
+    DltDaemonLocal daemon_local = {};
+    DltGateway *gateway = &daemon_local.pGateway;
+    int client[2] = { -1, -1 };
+    uint8_t msg[2 * 12] = { 0 };
+    uint8_t out[64] = { 0 };
+    int connected = 0;
+    int i = 0;
+    int n = 0;
+
+    ASSERT_EQ(0, dlt_daemon_prepare_event_handling(&daemon_local.pEvent));
+
+    for (i = 0; i < GTEST_PASSIVE_NODES; i++) {
+        listener[i] = gtest_listen_loopback(&port[i]);
+        ASSERT_LE(0, listener[i]);
+
+        connections[i].ecuid = ecu[i];
+        connections[i].status = DLT_GATEWAY_INITIALIZED;
+        connections[i].trigger = DLT_GATEWAY_ON_STARTUP;
+        ASSERT_EQ(DLT_RETURN_OK, dlt_client_init_port(&connections[i].client, port[i], 0));
+        ASSERT_EQ(DLT_RETURN_OK, dlt_client_set_server_ip(&connections[i].client, ip));
+    }
+
+    /* last node is down */
+    close(listener[GTEST_PASSIVE_NODES - 1]);
+    listener[GTEST_PASSIVE_NODES - 1] = -1;
+
+    gateway->connections = connections;
+    gateway->num_connections = GTEST_PASSIVE_NODES;
+    ASSERT_EQ(DLT_RETURN_OK, dlt_gateway_build_ecu_index(gateway));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_gateway_establish_connections(gateway, &daemon_local, 0));
+
+    /* connects complete in the event loop */
+    for (n = 0; (n < 100) && (connected < GTEST_PASSIVE_NODES_UP); n++) {
+        EXPECT_LE(0, dlt_daemon_handle_event(&daemon_local.pEvent, &daemon, &daemon_local));
+
+        for (i = 0, connected = 0; i < GTEST_PASSIVE_NODES_UP; i++)
+            if (connections[i].status == DLT_GATEWAY_CONNECTED)
+                connected++;
+    }
+
+    EXPECT_EQ(GTEST_PASSIVE_NODES_UP, connected);
+
+    for (n = 0; (n < 100) && (connections[GTEST_PASSIVE_NODES - 1].status != DLT_GATEWAY_DISCONNECTED); n++)
+        dlt_daemon_handle_event(&daemon_local.pEvent, &daemon, &daemon_local);
+
+    EXPECT_EQ(DLT_GATEWAY_DISCONNECTED, connections[GTEST_PASSIVE_NODES - 1].status);
+    EXPECT_EQ(1, connections[GTEST_PASSIVE_NODES - 1].timeout_cnt);
+
+    for (i = 0; i < GTEST_PASSIVE_NODES_UP; i++) {
+        peer[i] = accept(listener[i], NULL, NULL);
+        ASSERT_LE(0, peer[i]);
+    }
+
+    /* a client receives the messages forwarded from the second node */
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, client));
+    ASSERT_EQ(0, dlt_connection_create(&daemon_local,
+                                       &daemon_local.pEvent,
+                                       client[0],
+                                       POLLIN,
+                                       DLT_CONNECTION_CLIENT_MSG_TCP));
+    daemon.mode = DLT_USER_MODE_EXTERNAL;
+    daemon.state = DLT_DAEMON_STATE_SEND_DIRECT;
+
+    gtest_passive_node_message(msg, ecu[1]);
+    gtest_passive_node_message(msg + 12, ecu[1]);
+    ASSERT_EQ((ssize_t)sizeof(msg), write(peer[1], msg, sizeof(msg)));
+
+    EXPECT_LE(0, dlt_daemon_handle_event(&daemon_local.pEvent, &daemon, &daemon_local));
+    EXPECT_EQ(DLT_GATEWAY_CONNECTED, connections[1].status);
+
+    /* both messages are forwarded in one write */
+    EXPECT_EQ((ssize_t)sizeof(msg), recv(client[1], out, sizeof(out), MSG_DONTWAIT));
+    EXPECT_EQ(0, memcmp(msg, out, sizeof(msg)));
+
+    /* the first node resets its connection, which is removed from the event loop */
+    struct linger reset = { 1, 0 };
+    int fd = connections[0].client.sock;
+
+    ASSERT_EQ(0, setsockopt(peer[0], SOL_SOCKET, SO_LINGER, &reset, sizeof(reset)));
+    close(peer[0]);
+    peer[0] = -1;
+
+    EXPECT_LE(0, dlt_daemon_handle_event(&daemon_local.pEvent, &daemon, &daemon_local));
+    EXPECT_EQ(DLT_GATEWAY_DISCONNECTED, connections[0].status);
+    EXPECT_EQ(-1, connections[0].client.sock);
+    EXPECT_EQ(1, connections[0].timeout_cnt);
+    EXPECT_EQ((DltConnection *)NULL, dlt_event_handler_find_connection(&daemon_local.pEvent, fd));
+    EXPECT_EQ(DLT_GATEWAY_CONNECTED, connections[2].status);
+
+    dlt_event_handler_cleanup_connections(&daemon_local.pEvent);
+
+    for (i = 0; i < GTEST_PASSIVE_NODES; i++) {
+        dlt_receiver_free(&connections[i].client.receiver);
+        free(connections[i].client.servIP);
+        free(connections[i].batch);
+
+        if (peer[i] >= 0)
+            close(peer[i]);
+
+        if (listener[i] >= 0)
+            close(listener[i]);
+    }
+
+    close(client[1]);
+    free(gateway->ecu_index);
+}
+
+TEST(t_dlt_gateway_start_connection, nullpointer)
+{
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_start_connection(NULL, NULL, 0));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_gateway_finish_connection(NULL, NULL, 0));
+}
+
 int main(int argc, char **argv)
 {
+    /* like the daemon, report failed sends instead of terminating */
+    signal(SIGPIPE, SIG_IGN);
     ::testing::InitGoogleTest(&argc, argv);
 /*    ::testing::FLAGS_gtest_break_on_failure = true; */
 /*    ::testing::FLAGS_gtest_filter = "t_dlt_gateway_process_passive_node_messages*"; */
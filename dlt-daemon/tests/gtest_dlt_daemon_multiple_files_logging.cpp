@@ -32,6 +32,7 @@ extern "C"
 {
 #include "dlt_log.h"
 #include "dlt_common.h"
+#include "dlt_multiple_files.h"
 #include <syslog.h>
 #include <dirent.h>
 #include <string.h>
@@ -43,6 +44,7 @@ void write_log_message();
 void verify_multiple_files(const char* path, const char* file_name, int file_size, int max_files_size);
 void verify_single_file(const char* path, const char* file_name);
 void verify_in_one_file(const char* path, const char* file_name, const char* log1, const char* log2);
+void verify_manifest(const char* path, const char* file_name);
 bool file_contains_strings(const char* abs_file_path, const char* str1, const char* str2);
 int get_file_index(char* file_name);
 int compare_int(const void* a, const void* b);
@@ -113,6 +115,46 @@ TEST(t_dlt_logging_multiple_files_append_reinit, normal)
     verify_in_one_file(path, file_name, log1, log2);
 }
 
+/**
+ * Rotation keeps a manifest of the files instead of scanning the directory.
+ * After dlt_log_free the manifest lists the remaining files and the
+ * preallocated spare file is gone.
+ */
+TEST(t_dlt_logging_multiple_files_manifest, normal)
+{
+    const char* path = "/tmp";
+    const char* file_name = "dlt.log";
+    configure(path, file_name, true, 128, 512);
+    write_log_message();
+    EXPECT_NO_THROW(dlt_log_free());
+    verify_manifest(path, file_name);
+}
+
+/**
+ * A file the manifest does not list, e.g. written by the one file logging,
+ * still counts against the limits and is removed first.
+ */
+TEST(t_dlt_logging_multiple_files_manifest, unlisted_file)
+{
+    const char* path = "/tmp";
+    const char* file_name = "dlt.log";
+    configure(path, file_name, true, 128, 512);
+    write_log_message();
+    EXPECT_NO_THROW(dlt_log_free());
+
+    FILE *unlisted = fopen("/tmp/dlt.log", "w");
+    ASSERT_TRUE(unlisted != NULL);
+    for (int i = 0; i < 20; i++)
+        fprintf(unlisted, "%d. Line written without the manifest.\n", i);
+    fclose(unlisted);
+
+    configure(path, file_name, true, 128, 512);
+    write_log_message();
+    EXPECT_NO_THROW(dlt_log_free());
+    verify_multiple_files(path, file_name, 128, 512);
+    verify_manifest(path, file_name);
+}
+
 void configure(const char *path, const char* file_name, const bool enable_limit, const int file_size, const int max_files_size)
 {
     char abs_file_path[PATH_MAX];
@@ -278,3 +320,47 @@ int main(int argc, char **argv)
     /*::testing::FLAGS_gtest_repeat = 10000; */
     return RUN_ALL_TESTS();
 }
+
+void verify_manifest(const char* path, const char* file_name)
+{
+    char manifest[PATH_MAX + 1];
+    char listed[PATH_MAX + 1];
+    char line[PATH_MAX + 1];
+    char name[NAME_MAX + 1];
+    unsigned int idx;
+    long long created;
+    long long size;
+    struct stat status;
+    int num_files = 0;
+
+    char file_name_copy[NAME_MAX + 1];
+    strncpy(file_name_copy, file_name, NAME_MAX - 1);
+    file_name_copy[NAME_MAX - 1] = '\0';
+    char filename_base[NAME_MAX];
+    EXPECT_TRUE(dlt_extract_base_name_without_ext(file_name_copy, filename_base, sizeof(filename_base)));
+    const char *filename_ext = get_filename_ext(file_name);
+
+    snprintf(manifest, sizeof(manifest), "%s/%s%s", path, filename_base, MULTIPLE_FILES_PREALLOC_EXT);
+    EXPECT_NE(0, stat(manifest, &status));
+
+    snprintf(manifest, sizeof(manifest), "%s/%s%s", path, filename_base, MULTIPLE_FILES_MANIFEST_EXT);
+    FILE *handle = fopen(manifest, "r");
+    ASSERT_TRUE(handle != NULL);
+
+    while (fgets(line, sizeof(line), handle) != NULL) {
+        if (line[0] == '#')
+            continue;
+
+        ASSERT_EQ(4, sscanf(line, "%u %lld %lld %255s", &idx, &created, &size, name));
+        EXPECT_TRUE(strstr(name, filename_ext) != NULL);
+
+        /* the recorded size is the size on disk */
+        snprintf(listed, sizeof(listed), "%s/%s", path, name);
+        ASSERT_EQ(0, stat(listed, &status));
+        EXPECT_EQ(size, static_cast<long long>(status.st_size));
+        num_files++;
+    }
+
+    fclose(handle);
+    EXPECT_GT(num_files, 1);
+}
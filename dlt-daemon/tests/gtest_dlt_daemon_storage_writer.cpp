@@ -0,0 +1,268 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file gtest_dlt_daemon_storage_writer.cpp
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+extern "C"
+{
+#include "dlt_storage_writer.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+}
+
+#define RECORD_SIZE 96
+#define NUM_RECORDS 1000
+
+/* Upper bound for the p99 latency of a queued write or close as seen by the
+ * event loop, in us */
+#define LATENCY_P99_BOUND_US 1000.0
+
+/* The tests write to $DLT_STORAGE_WRITER_TEST_DIR, e.g. a mounted
+ * ext4 loop image, or to /tmp */
+static void test_file(char *path, size_t len, const char *name)
+{
+    const char *dir = getenv("DLT_STORAGE_WRITER_TEST_DIR");
+    snprintf(path, len, "%s/%s", (dir != NULL) ? dir : "/tmp", name);
+}
+
+/* Write count records of three parts, the bytes depend on the offset */
+static void write_records(int fd, int count)
+{
+    unsigned char record[RECORD_SIZE];
+
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < RECORD_SIZE; j++)
+            record[j] = (unsigned char)(i + j);
+
+        struct iovec iov[3] = {
+            { record, 16 },
+            { record + 16, 16 },
+            { record + 32, RECORD_SIZE - 32 }
+        };
+        EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_write(fd, (off_t)i * RECORD_SIZE, iov, 3));
+    }
+}
+
+static void verify_records(const char *path, int count)
+{
+    unsigned char record[RECORD_SIZE];
+    struct stat status;
+    int fd = open(path, O_RDONLY);
+
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(0, fstat(fd, &status));
+    EXPECT_EQ((off_t)count * RECORD_SIZE, status.st_size);
+
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(RECORD_SIZE, read(fd, record, RECORD_SIZE));
+
+        for (int j = 0; j < RECORD_SIZE; j++)
+            ASSERT_EQ((unsigned char)(i + j), record[j]);
+    }
+
+    close(fd);
+}
+
+static double elapsed_us(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) * 1e6 + (double)(end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+/* Time each call like the event loop would see it: writes with a synced
+ * file rotation every 100 messages, completions are handled in between */
+static void measure_latency(const char *mode, double *p99)
+{
+    char path[PATH_MAX];
+    char name[64];
+    unsigned char record[RECORD_SIZE] = { 0 };
+    std::vector<double> latency;
+    struct timespec start, end;
+    off_t offset = 0;
+    int fd = -1;
+
+    for (int i = 0; i < NUM_RECORDS * 10; i++) {
+        struct iovec iov = { record, RECORD_SIZE };
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        if ((i % 100) == 0) {
+            if (fd != -1) {
+                EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_close(fd, true));
+            }
+
+            snprintf(name, sizeof(name), "gtest_dlt_storage_writer_latency.%d.dlt", i / 100);
+            test_file(path, sizeof(path), name);
+            fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            ASSERT_NE(-1, fd);
+            offset = 0;
+        }
+
+        EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_write(fd, offset, &iov, 1));
+        offset += RECORD_SIZE;
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        latency.push_back(elapsed_us(&start, &end));
+
+        dlt_storage_writer_handle_completions();
+    }
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_close(fd, true));
+    dlt_storage_writer_wait();
+    dlt_storage_writer_handle_completions();
+
+    for (int i = 0; i < NUM_RECORDS / 10; i++) {
+        snprintf(name, sizeof(name), "gtest_dlt_storage_writer_latency.%d.dlt", i);
+        test_file(path, sizeof(path), name);
+        unlink(path);
+    }
+
+    std::sort(latency.begin(), latency.end());
+    *p99 = latency[latency.size() * 99 / 100];
+    printf("%s: p50 %.1f us, p99 %.1f us, max %.1f us\n", mode,
+           latency[latency.size() / 2], *p99, latency.back());
+}
+
+/* Rotate through ten files of 100 records like the offline trace does. Every
+ * other file is closed right away without waiting for its writes, the next
+ * file then gets the same descriptor number. */
+static void write_rotated(void)
+{
+    char path[PATH_MAX];
+    char name[64];
+
+    for (int i = 0; i < 10; i++) {
+        snprintf(name, sizeof(name), "gtest_dlt_storage_writer_rotate.%d.dlt", i);
+        test_file(path, sizeof(path), name);
+
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_NE(-1, fd);
+        write_records(fd, 100);
+
+        if ((i % 2) == 0)
+            EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_close(fd, true));
+        else
+            close(fd);
+    }
+
+    dlt_storage_writer_wait();
+    dlt_storage_writer_handle_completions();
+
+    /* every file is complete and holds only its own records, in order */
+    for (int i = 0; i < 10; i++) {
+        snprintf(name, sizeof(name), "gtest_dlt_storage_writer_rotate.%d.dlt", i);
+        test_file(path, sizeof(path), name);
+        verify_records(path, 100);
+        unlink(path);
+    }
+}
+
+/* Begin Method: dlt_storage_writer::dlt_storage_writer_write */
+TEST(t_dlt_storage_writer_write, normal)
+{
+    char path[PATH_MAX];
+    int fd;
+
+    test_file(path, sizeof(path), "gtest_dlt_storage_writer.dlt");
+
+    /* synchronous */
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(-1, fd);
+    write_records(fd, NUM_RECORDS);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_storage_writer_close(fd, true));
+    verify_records(path, NUM_RECORDS);
+
+    /* queued, if io_uring is available */
+    if (dlt_storage_writer_init(DLT_STORAGE_WRITER_ENTRIES, DLT_STORAGE_WRITER_SLOT_SIZE) == DLT_RETURN_OK) {
+        EXPECT_TRUE(dlt_storage_writer_is_async());
+        EXPECT_NE(-1, dlt_storage_writer_get_fd());
+    }
+    else {
+        EXPECT_FALSE(dlt_storage_writer_is_async());
+        EXPECT_EQ(-1, dlt_storage_writer_get_fd());
+    }
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(-1, fd);
+    write_records(fd, NUM_RECORDS);
+    /* the writes hold the file, the descriptor can be closed at once */
+    close(fd);
+    dlt_storage_writer_wait();
+    dlt_storage_writer_handle_completions();
+    verify_records(path, NUM_RECORDS);
+
+    dlt_storage_writer_free();
+    EXPECT_FALSE(dlt_storage_writer_is_async());
+    unlink(path);
+}
+
+TEST(t_dlt_storage_writer_write, abnormal)
+{
+    unsigned char data[4] = { 0 };
+    struct iovec iov = { data, sizeof(data) };
+
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_write(-1, 0, &iov, 1));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_write(0, -1, &iov, 1));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_write(0, 0, NULL, 1));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_write(0, 0, &iov, 0));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_close(-1, true));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_storage_writer_init(0, DLT_STORAGE_WRITER_SLOT_SIZE));
+}
+/* End Method: dlt_storage_writer::dlt_storage_writer_write */
+
+/* Begin Method: dlt_storage_writer::dlt_storage_writer_rotate */
+TEST(t_dlt_storage_writer_rotate, normal)
+{
+    write_rotated();
+
+    if (dlt_storage_writer_init(DLT_STORAGE_WRITER_ENTRIES, DLT_STORAGE_WRITER_SLOT_SIZE) == DLT_RETURN_OK) {
+        write_rotated();
+        dlt_storage_writer_free();
+    }
+}
+/* End Method: dlt_storage_writer::dlt_storage_writer_rotate */
+
+/* Begin Method: dlt_storage_writer::dlt_storage_writer_latency */
+TEST(t_dlt_storage_writer_latency, normal)
+{
+    double sync_p99 = 0;
+    double async_p99 = 0;
+
+    measure_latency("synchronous", &sync_p99);
+
+    if (dlt_storage_writer_init(DLT_STORAGE_WRITER_ENTRIES, DLT_STORAGE_WRITER_SLOT_SIZE) == DLT_RETURN_OK) {
+        measure_latency("io_uring", &async_p99);
+        dlt_storage_writer_free();
+
+        /* the event loop does not wait for the disk, not even when a file
+         * is synced on rotation */
+        EXPECT_GT(LATENCY_P99_BOUND_US, async_p99);
+    }
+}
+/* End Method: dlt_storage_writer::dlt_storage_writer_latency */
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,212 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file gtest_dlt_daemon_timer.cpp
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C"
+{
+#include "dlt_daemon_timer.h"
+#include <stdlib.h>
+#include <string.h>
+}
+
+/* Records the expired timers together with the time of the advance */
+struct TimerLog {
+    DltDaemonTimerWheel *wheel;
+    uint64_t now;
+    std::vector<DltDaemonTimer *> expired;
+    std::vector<uint64_t> times;
+};
+
+static void log_timer(DltDaemonTimer *timer, void *ctx)
+{
+    TimerLog *log = (TimerLog *)ctx;
+
+    log->expired.push_back(timer);
+    log->times.push_back(log->now);
+}
+
+static int advance(DltDaemonTimerWheel *wheel, TimerLog *log, uint64_t now)
+{
+    log->now = now;
+    return dlt_daemon_timer_wheel_advance(wheel, now, log);
+}
+
+/* Begin Method: dlt_daemon_timer::dlt_daemon_timer_wheel_advance */
+TEST(t_dlt_daemon_timer_wheel_advance, normal)
+{
+    /* one timer per level and beyond the top level */
+    const uint64_t delays[] = { 0, 1, 63, 64, 65, 4095, 4096, 60000, 262144, 16777217, 1ULL << 31 };
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+    DltDaemonTimer timers[count] = {};
+    DltDaemonTimerWheel wheel;
+    TimerLog log;
+    uint64_t start = 1000003;
+    uint64_t next = 0;
+    size_t i;
+
+    dlt_daemon_timer_wheel_init(&wheel, start);
+
+    for (i = 0; i < count; i++)
+        EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &timers[i], start + delays[i], 0, log_timer, NULL));
+
+    EXPECT_EQ(count, wheel.count);
+
+    for (i = 0; i < count; i++) {
+        uint64_t expires = start + delays[i];
+
+        /* the wheel wakes up exactly at the expiry */
+        ASSERT_EQ(0, dlt_daemon_timer_wheel_next(&wheel, &next));
+        EXPECT_EQ(expires, next);
+
+        if (expires > start) {
+            EXPECT_EQ(0, advance(&wheel, &log, expires - 1));
+        }
+
+        EXPECT_EQ(1, advance(&wheel, &log, expires));
+        ASSERT_EQ(i + 1, log.expired.size());
+        EXPECT_EQ(&timers[i], log.expired[i]);
+        EXPECT_FALSE(dlt_daemon_timer_pending(&timers[i]));
+    }
+
+    EXPECT_EQ(0u, wheel.count);
+    EXPECT_GT(0, dlt_daemon_timer_wheel_next(&wheel, &next));
+}
+
+TEST(t_dlt_daemon_timer_wheel_advance, periodic)
+{
+    DltDaemonTimer timer = {};
+    DltDaemonTimerWheel wheel = {};
+    TimerLog log;
+    uint64_t next = 0;
+
+    EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &timer, 1000, 1000, log_timer, NULL));
+
+    EXPECT_EQ(1, advance(&wheel, &log, 1000));
+    EXPECT_TRUE(dlt_daemon_timer_pending(&timer));
+    ASSERT_EQ(0, dlt_daemon_timer_wheel_next(&wheel, &next));
+    EXPECT_EQ(2000u, next);
+
+    /* missed periods run once */
+    EXPECT_EQ(1, advance(&wheel, &log, 5500));
+    ASSERT_EQ(0, dlt_daemon_timer_wheel_next(&wheel, &next));
+    EXPECT_EQ(6000u, next);
+
+    dlt_daemon_timer_cancel(&timer);
+    EXPECT_FALSE(dlt_daemon_timer_pending(&timer));
+    EXPECT_EQ(0, advance(&wheel, &log, 10000));
+    EXPECT_EQ(2u, log.expired.size());
+}
+
+/* Cancels the timer stored as data, then adds itself again for the current time */
+static void cancel_timer(DltDaemonTimer *timer, void *ctx)
+{
+    TimerLog *log = (TimerLog *)ctx;
+
+    log->expired.push_back(timer);
+    dlt_daemon_timer_cancel((DltDaemonTimer *)timer->data);
+    dlt_daemon_timer_add(log->wheel, timer, log->now, 0, log_timer, NULL);
+}
+
+TEST(t_dlt_daemon_timer_wheel_advance, callback)
+{
+    DltDaemonTimer first = {};
+    DltDaemonTimer second = {};
+    DltDaemonTimerWheel wheel = {};
+    TimerLog log;
+
+    log.wheel = &wheel;
+
+    /* both expire in the same ms, whichever runs first cancels the other */
+    EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &first, 100, 0, cancel_timer, &second));
+    EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &second, 100, 0, cancel_timer, &first));
+    EXPECT_EQ(1, advance(&wheel, &log, 100));
+    EXPECT_EQ(1u, log.expired.size());
+
+    /* the timer added again for the current time expires on the next ms */
+    EXPECT_EQ(1u, wheel.count);
+    EXPECT_EQ(0, advance(&wheel, &log, 100));
+    EXPECT_EQ(1, advance(&wheel, &log, 101));
+
+    /* a time in the past expires on the next advance */
+    EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &first, 50, 0, log_timer, NULL));
+    EXPECT_EQ(1, advance(&wheel, &log, 102));
+    EXPECT_EQ(0u, wheel.count);
+}
+
+TEST(t_dlt_daemon_timer_wheel_advance, random)
+{
+    const int count = 2000;
+    std::vector<DltDaemonTimer> timers(count);
+    std::vector<uint64_t> expires(count);
+    DltDaemonTimerWheel wheel;
+    TimerLog log;
+    uint64_t now = 42;
+    int i;
+
+    srand(1);
+    dlt_daemon_timer_wheel_init(&wheel, now);
+
+    for (i = 0; i < count; i++) {
+        memset(&timers[i], 0, sizeof(DltDaemonTimer));
+        expires[i] = now + ((uint64_t)rand() % (1ULL << (rand() % 28)));
+        EXPECT_EQ(0, dlt_daemon_timer_add(&wheel, &timers[i], expires[i], 0, log_timer, NULL));
+    }
+
+    /* some timers are cancelled */
+    for (i = 0; i < count; i += 7)
+        dlt_daemon_timer_cancel(&timers[i]);
+
+    while (wheel.count > 0)
+        advance(&wheel, &log, now += (uint64_t)(rand() % 100000));
+
+    /* every timer expired once, at the first advance after its expiry */
+    EXPECT_EQ((size_t)(count - (count + 6) / 7), log.expired.size());
+
+    for (size_t j = 0; j < log.expired.size(); j++) {
+        i = (int)(log.expired[j] - &timers[0]);
+        EXPECT_NE(0, i % 7);
+        EXPECT_LE(expires[i], log.times[j]);
+        EXPECT_GT(expires[i] + 100000, log.times[j]);
+        expires[i] = UINT64_MAX;
+    }
+}
+
+TEST(t_dlt_daemon_timer_wheel_advance, nullpointer)
+{
+    DltDaemonTimer timer = {};
+    DltDaemonTimerWheel wheel = {};
+    uint64_t next = 0;
+
+    EXPECT_GT(0, dlt_daemon_timer_wheel_advance(NULL, 0, NULL));
+    EXPECT_GT(0, dlt_daemon_timer_add(NULL, &timer, 0, 0, log_timer, NULL));
+    EXPECT_GT(0, dlt_daemon_timer_add(&wheel, NULL, 0, 0, log_timer, NULL));
+    EXPECT_GT(0, dlt_daemon_timer_add(&wheel, &timer, 0, 0, NULL, NULL));
+    EXPECT_GT(0, dlt_daemon_timer_wheel_next(NULL, &next));
+    EXPECT_GT(0, dlt_daemon_timer_wheel_next(&wheel, NULL));
+    EXPECT_FALSE(dlt_daemon_timer_pending(NULL));
+    dlt_daemon_timer_cancel(NULL);
+    dlt_daemon_timer_cancel(&timer);
+}
+/* End Method: dlt_daemon_timer::dlt_daemon_timer_wheel_advance */
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
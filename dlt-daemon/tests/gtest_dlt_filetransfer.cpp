@@ -0,0 +1,289 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file gtest_dlt_filetransfer.cpp
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+
+extern "C"
+{
+#include "dlt_user.h"
+#include "dlt_filetransfer.h"
+#include <stdio.h>
+#include <string.h>
+}
+
+/* the library logs to this file instead of the daemon */
+#define FT_LOG_FILE "/tmp/gtest_dlt_filetransfer.dlt"
+#define FT_DATA_FILE "/tmp/gtest_dlt_filetransfer.bin"
+
+/* size of a FLDA package, see BUFFER_SIZE in dlt_filetransfer.c */
+#define FT_PACKAGE_SIZE 1024
+
+static DltContext fileContext;
+
+/* Number of logged messages whose first argument is the given tag */
+static int count_messages(const char *tag)
+{
+    DltFile file;
+    char text[DLT_CONVERT_TEXTBUFSIZE];
+    int count = 0;
+
+    if (dlt_file_init(&file, 0) < DLT_RETURN_OK)
+        return -1;
+
+    if (dlt_file_open(&file, FT_LOG_FILE, 0) < DLT_RETURN_OK) {
+        dlt_file_free(&file, 0);
+        return -1;
+    }
+
+    while (dlt_file_read(&file, 0) >= 0) {}
+
+    for (int i = 0; i < file.counter; i++) {
+        if ((dlt_file_message(&file, i, 0) < DLT_RETURN_OK) ||
+            (dlt_message_payload(&file.msg, text, sizeof(text), DLT_OUTPUT_ASCII, 0) < DLT_RETURN_OK))
+            continue;
+
+        if (strncmp(text, tag, strlen(tag)) == 0)
+            count++;
+    }
+
+    dlt_file_free(&file, 0);
+    return count;
+}
+
+static void write_data_file(size_t size)
+{
+    std::string data(size, 'd');
+    FILE *file = fopen(FT_DATA_FILE, "wb");
+
+    ASSERT_TRUE(file != NULL);
+    ASSERT_EQ(size, fwrite(data.data(), 1, size, file));
+    fclose(file);
+}
+
+/* Result of an asynchronous transfer, filled by the callback */
+struct AsyncResult {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool done;
+    int result;
+};
+
+static void async_done(DltContext *context, const char *filename, int result, void *userData)
+{
+    AsyncResult *async = (AsyncResult *)userData;
+
+    (void)context;
+    (void)filename;
+
+    std::lock_guard<std::mutex> lock(async->mutex);
+    async->done = true;
+    async->result = result;
+    async->cond.notify_all();
+}
+
+static bool wait_async(AsyncResult *async)
+{
+    std::unique_lock<std::mutex> lock(async->mutex);
+
+    return async->cond.wait_for(lock, std::chrono::seconds(10), [async] { return async->done; });
+}
+
+/* Begin Method: dlt_filetransfer::dlt_user_log_file_data_mmap */
+TEST(t_dlt_user_log_file_data_mmap, normal)
+{
+    DltFileTransferCursor cursor = { 0, 0 };
+    bool cancel = false;
+    int packages = count_messages("FLDA");
+
+    write_data_file(2 * FT_PACKAGE_SIZE + 100);
+
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, &cancel));
+    EXPECT_EQ(3, cursor.package);
+    EXPECT_NE(0u, cursor.serial);
+    EXPECT_EQ(packages + 3, count_messages("FLDA"));
+
+    /* nothing left to send for the same file */
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, NULL));
+    EXPECT_EQ(3, cursor.package);
+    EXPECT_EQ(packages + 3, count_messages("FLDA"));
+
+    /* without a cursor the whole file is sent */
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, NULL, 0, NULL));
+    EXPECT_EQ(packages + 6, count_messages("FLDA"));
+}
+
+TEST(t_dlt_user_log_file_data_mmap, resume)
+{
+    DltFileTransferCursor cursor = { 0, 0 };
+    int packages = count_messages("FLDA");
+
+    write_data_file(4 * FT_PACKAGE_SIZE);
+
+    /* the first two packages were sent before the transfer was interrupted */
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, NULL));
+    cursor.package = 2;
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, NULL));
+    EXPECT_EQ(4, cursor.package);
+    EXPECT_EQ(packages + 4 + 2, count_messages("FLDA"));
+
+    /* a changed file invalidates the cursor */
+    write_data_file(FT_PACKAGE_SIZE);
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, NULL));
+    EXPECT_EQ(1, cursor.package);
+    EXPECT_EQ(packages + 4 + 2 + 1, count_messages("FLDA"));
+}
+
+TEST(t_dlt_user_log_file_data_mmap, cancel)
+{
+    DltFileTransferCursor cursor = { 0, 0 };
+    bool cancel = true;
+    int packages = count_messages("FLDA");
+
+    write_data_file(2 * FT_PACKAGE_SIZE);
+
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_END_USER_CANCELLED,
+              dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, &cancel));
+    EXPECT_EQ(0, cursor.package);
+    EXPECT_EQ(packages, count_messages("FLDA"));
+}
+
+TEST(t_dlt_user_log_file_data_mmap, empty)
+{
+    DltFileTransferCursor cursor = { 0, 0 };
+    int packages = count_messages("FLDA");
+
+    write_data_file(0);
+
+    EXPECT_EQ(0, dlt_user_log_file_data_mmap(&fileContext, FT_DATA_FILE, &cursor, 0, NULL));
+    EXPECT_EQ(0, cursor.package);
+    EXPECT_EQ(packages, count_messages("FLDA"));
+}
+
+TEST(t_dlt_user_log_file_data_mmap, truncated)
+{
+    AsyncResult async;
+    DltFileTransferCursor cursor = { 0, 0 };
+
+    async.done = false;
+    async.result = 0;
+
+    /* 200 packages with 20 ms in between, the file is truncated in the middle */
+    write_data_file(200 * FT_PACKAGE_SIZE);
+    EXPECT_EQ(0, dlt_user_log_file_complete_async(&fileContext, FT_DATA_FILE, 0, 20, &cursor, NULL,
+                                                  async_done, &async));
+    usleep(200 * 1000);
+    EXPECT_EQ(0, truncate(FT_DATA_FILE, FT_PACKAGE_SIZE));
+
+    ASSERT_TRUE(wait_async(&async));
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_COMPLETE2, async.result);
+    EXPECT_LT(0, cursor.package);
+    EXPECT_GT(200, cursor.package);
+}
+
+TEST(t_dlt_user_log_file_data_mmap, nullpointer)
+{
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_DATA, dlt_user_log_file_data_mmap(NULL, FT_DATA_FILE, NULL, 0, NULL));
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_DATA, dlt_user_log_file_data_mmap(&fileContext, NULL, NULL, 0, NULL));
+    EXPECT_EQ(DLT_FILETRANSFER_FILE_SERIAL_NUMBER,
+              dlt_user_log_file_data_mmap(&fileContext, "/tmp/gtest_dlt_filetransfer.missing", NULL, 0, NULL));
+}
+/* End Method: dlt_filetransfer::dlt_user_log_file_data_mmap */
+
+/* Begin Method: dlt_filetransfer::dlt_user_log_file_complete_async */
+TEST(t_dlt_user_log_file_complete_async, normal)
+{
+    AsyncResult async;
+    DltFileTransferCursor cursor = { 0, 0 };
+    int headers = count_messages("FLST");
+    int packages = count_messages("FLDA");
+    int ends = count_messages("FLFI");
+
+    async.done = false;
+    async.result = -1;
+
+    write_data_file(3 * FT_PACKAGE_SIZE);
+
+    /* an unused cursor is reset: the header is sent */
+    cursor.serial = 1;
+    cursor.package = 2;
+    EXPECT_EQ(0, dlt_user_log_file_complete_async(&fileContext, FT_DATA_FILE, 0, 0, &cursor, NULL,
+                                                  async_done, &async));
+    ASSERT_TRUE(wait_async(&async));
+    EXPECT_EQ(0, async.result);
+    EXPECT_EQ(3, cursor.package);
+    EXPECT_EQ(headers + 1, count_messages("FLST"));
+    EXPECT_EQ(packages + 3, count_messages("FLDA"));
+    EXPECT_EQ(ends + 1, count_messages("FLFI"));
+
+    /* resuming the same file skips the header and the packages already sent */
+    async.done = false;
+    async.result = -1;
+    cursor.package = 1;
+    EXPECT_EQ(0, dlt_user_log_file_complete_async(&fileContext, FT_DATA_FILE, 0, 0, &cursor, NULL,
+                                                  async_done, &async));
+    ASSERT_TRUE(wait_async(&async));
+    EXPECT_EQ(0, async.result);
+    EXPECT_EQ(headers + 1, count_messages("FLST"));
+    EXPECT_EQ(packages + 3 + 2, count_messages("FLDA"));
+    EXPECT_EQ(ends + 2, count_messages("FLFI"));
+}
+
+TEST(t_dlt_user_log_file_complete_async, abnormal)
+{
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_COMPLETE,
+              dlt_user_log_file_complete_async(&fileContext, "/tmp/gtest_dlt_filetransfer.missing", 0, 0, NULL,
+                                               NULL, NULL, NULL));
+}
+
+TEST(t_dlt_user_log_file_complete_async, nullpointer)
+{
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_COMPLETE,
+              dlt_user_log_file_complete_async(NULL, FT_DATA_FILE, 0, 0, NULL, NULL, NULL, NULL));
+    EXPECT_EQ(DLT_FILETRANSFER_ERROR_FILE_COMPLETE,
+              dlt_user_log_file_complete_async(&fileContext, NULL, 0, 0, NULL, NULL, NULL, NULL));
+}
+/* End Method: dlt_filetransfer::dlt_user_log_file_complete_async */
+
+int main(int argc, char **argv)
+{
+    int ret;
+
+    ::testing::InitGoogleTest(&argc, argv);
+
+    unlink(FT_LOG_FILE);
+
+    /* no limit for the size of the log file */
+    if ((dlt_init_file(FT_LOG_FILE) < DLT_RETURN_OK) ||
+        (dlt_set_filesize_max(0) < DLT_RETURN_OK) ||
+        (dlt_register_app("TFTR", "dlt_filetransfer.c tests") < DLT_RETURN_OK) ||
+        (dlt_register_context(&fileContext, "FLTR", "dlt_filetransfer.c tests") < DLT_RETURN_OK))
+        return 1;
+
+    ret = RUN_ALL_TESTS();
+
+    dlt_unregister_context(&fileContext);
+    dlt_unregister_app();
+    dlt_free();
+    unlink(FT_DATA_FILE);
+    unlink(FT_LOG_FILE);
+    return ret;
+}
@@ -0,0 +1,297 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file gtest_dlt_grep.cpp
+ * Runs the dlt-grep tool on generated DLT files.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "dlt_common.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
+#define GREP_FILE "gtest_dlt_grep.dlt"
+#define GREP_OUTPUT "gtest_dlt_grep_output.dlt"
+#define GREP_DIR "gtest_dlt_grep_storage"
+
+/* Append a log message with a storage header to data. A verbose message has
+ * one string argument, a non-verbose one the message id 42 and text as payload. */
+static void append_message(std::string &data, uint32_t seconds, const char *ecu, const char *apid,
+                           const char *ctid, int level, bool verbose, const char *text)
+{
+    DltStorageHeader storage;
+    DltStandardHeader standard;
+    DltExtendedHeader extended;
+    std::string payload;
+    uint32_t value;
+    uint16_t length;
+
+    if (verbose) {
+        value = DLT_TYPE_INFO_STRG | DLT_SCOD_ASCII;
+        length = (uint16_t)(strlen(text) + 1);
+        payload.append((const char *)&value, sizeof(value));
+        payload.append((const char *)&length, sizeof(length));
+        payload.append(text, length);
+    }
+    else {
+        value = 42;
+        payload.append((const char *)&value, sizeof(value));
+        payload.append(text);
+    }
+
+    memset(&storage, 0, sizeof(storage));
+    memcpy(storage.pattern, "DLT\x01", DLT_ID_SIZE);
+    storage.seconds = seconds;
+    dlt_set_id(storage.ecu, ecu);
+
+    standard.htyp = DLT_HTYP_PROTOCOL_VERSION1 | DLT_HTYP_UEH;
+    standard.mcnt = 0;
+    standard.len = DLT_HTOBE_16((uint16_t)(sizeof(standard) + sizeof(extended) + payload.size()));
+
+    extended.msin = (uint8_t)((verbose ? DLT_MSIN_VERB : 0) | (DLT_TYPE_LOG << DLT_MSIN_MSTP_SHIFT) |
+                              (level << DLT_MSIN_MTIN_SHIFT));
+    extended.noar = verbose ? 1 : 0;
+    dlt_set_id(extended.apid, apid);
+    dlt_set_id(extended.ctid, ctid);
+
+    data.append((const char *)&storage, sizeof(storage));
+    data.append((const char *)&standard, sizeof(standard));
+    data.append((const char *)&extended, sizeof(extended));
+    data.append(payload);
+}
+
+static void write_file(const char *filename, const std::string &data)
+{
+    FILE *handle = fopen(filename, "wb");
+
+    ASSERT_NE((FILE *)NULL, handle);
+    ASSERT_EQ(data.size(), fwrite(data.data(), 1, data.size(), handle));
+    fclose(handle);
+}
+
+/* Run dlt-grep with the arguments, return its exit status and the output lines */
+static int run_grep(const std::string &arguments, std::vector<std::string> *lines)
+{
+    std::string command = std::string(DLT_GREP_PATH) + " " + arguments + " 2>/dev/null";
+    char line[4096];
+    FILE *pipe = popen(command.c_str(), "r");
+    int status;
+
+    if (pipe == NULL)
+        return -1;
+
+    while (fgets(line, sizeof(line), pipe) != NULL)
+        if (lines != NULL)
+            lines->push_back(line);
+
+    status = pclose(pipe);
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* Number of matching messages printed with -c */
+static int count_matches(const std::string &arguments)
+{
+    std::vector<std::string> lines;
+    int count = -1;
+
+    if ((run_grep("-c " + arguments, &lines) > 1) || (lines.size() != 1) ||
+        (sscanf(lines[0].c_str(), "Number of matching messages: %d", &count) != 1))
+        return -1;
+
+    return count;
+}
+
+/* Index of the printed message, the number in front of the header */
+static int message_index(const std::string &line, std::string *filename)
+{
+    size_t colon = line.find(':');
+    size_t start = 0;
+
+    if ((filename != NULL) && (colon != std::string::npos)) {
+        *filename = line.substr(0, colon);
+        start = colon + 1;
+    }
+
+    return atoi(line.c_str() + start);
+}
+
+/* Ten messages of two applications, stored one second apart */
+static void write_sample(void)
+{
+    std::string data;
+
+    for (uint32_t i = 0; i < 10; i++)
+        append_message(data, 1700000000 + i, (i < 8) ? "ECU1" : "ECU2", (i % 2) ? "APP1" : "APP2",
+                       (i < 5) ? "CTX1" : "CTX2", (i % 3) ? DLT_LOG_INFO : DLT_LOG_ERROR, true,
+                       (i == 7) ? "connection timeout" : "all fine");
+
+    write_file(GREP_FILE, data);
+}
+
+/* Begin Method: dlt-grep::filters */
+TEST(t_dlt_grep_filters, normal)
+{
+    write_sample();
+
+    EXPECT_EQ(10, count_matches(GREP_FILE));
+    EXPECT_EQ(8, count_matches("-E ECU1 " GREP_FILE));
+    EXPECT_EQ(5, count_matches("-A APP1 " GREP_FILE));
+    EXPECT_EQ(10, count_matches("-A APP1 -A APP2 " GREP_FILE));
+    EXPECT_EQ(3, count_matches("-A APP1 -C CTX2 " GREP_FILE));
+    EXPECT_EQ(4, count_matches("-l error " GREP_FILE));
+    EXPECT_EQ(10, count_matches("-l info " GREP_FILE));
+    EXPECT_EQ(3, count_matches("-b 1700000002 -e 1700000004 " GREP_FILE));
+    EXPECT_EQ(1, count_matches("-s timeout " GREP_FILE));
+    EXPECT_EQ(1, count_matches("-r 'conn[a-z]+ time' " GREP_FILE));
+    EXPECT_EQ(9, count_matches("-r '^all' " GREP_FILE));
+    EXPECT_EQ(0, count_matches("-s timeout -A APP2 " GREP_FILE));
+
+    /* like grep: 1 if nothing matched */
+    EXPECT_EQ(0, run_grep("-s timeout " GREP_FILE, NULL));
+    EXPECT_EQ(1, run_grep("-s missing " GREP_FILE, NULL));
+    unlink(GREP_FILE);
+}
+
+TEST(t_dlt_grep_filters, abnormal)
+{
+    EXPECT_GT(run_grep("-l loud " GREP_FILE, NULL), 1);
+    EXPECT_GT(run_grep("-b yesterday " GREP_FILE, NULL), 1);
+    EXPECT_GT(run_grep("-r '(' " GREP_FILE, NULL), 1);
+    EXPECT_GT(run_grep("gtest_dlt_grep.missing", NULL), 1);
+}
+
+TEST(t_dlt_grep_filters, nonverbose)
+{
+    std::string data;
+
+    append_message(data, 1700000000, "ECU1", "APP1", "CTX1", DLT_LOG_INFO, false, "abc");
+    write_file(GREP_FILE, data);
+
+    /* -s and -r both match the payload as printed */
+    EXPECT_EQ(1, count_matches("-s '42, 61 62 63' " GREP_FILE));
+    EXPECT_EQ(1, count_matches("-r '^42, 61 62 63' " GREP_FILE));
+    EXPECT_EQ(0, count_matches("-s abc " GREP_FILE));
+    EXPECT_EQ(0, count_matches("-r abc " GREP_FILE));
+    unlink(GREP_FILE);
+}
+/* End Method: dlt-grep::filters */
+
+/* Begin Method: dlt-grep::output */
+TEST(t_dlt_grep_output, order)
+{
+    std::vector<std::string> lines;
+    std::string data;
+    char text[64];
+    int i;
+
+    /* about 3 MB: several chunks searched by concurrent workers */
+    for (i = 0; i < 50000; i++) {
+        snprintf(text, sizeof(text), "%s message %d", (i % 7) ? "other" : "match", i);
+        append_message(data, 1700000000, "ECU1", "APP1", "CTX1", DLT_LOG_INFO, true, text);
+    }
+
+    write_file(GREP_FILE, data);
+
+    EXPECT_EQ(0, run_grep("-j 4 -s match " GREP_FILE, &lines));
+    ASSERT_EQ((size_t)((50000 + 6) / 7), lines.size());
+
+    for (i = 0; i < (int)lines.size(); i++) {
+        snprintf(text, sizeof(text), "[match message %d]", i * 7);
+        EXPECT_EQ(i * 7, message_index(lines[(size_t)i], NULL));
+        EXPECT_NE(std::string::npos, lines[(size_t)i].find(text));
+    }
+
+    unlink(GREP_FILE);
+}
+
+TEST(t_dlt_grep_output, dlt_file)
+{
+    DltFile file;
+
+    write_sample();
+    unlink(GREP_OUTPUT);
+
+    EXPECT_EQ(0, run_grep("-A APP1 -o " GREP_OUTPUT " " GREP_FILE, NULL));
+
+    ASSERT_EQ(DLT_RETURN_OK, dlt_file_init(&file, 0));
+    ASSERT_EQ(DLT_RETURN_OK, dlt_file_open(&file, GREP_OUTPUT, 0));
+
+    while (dlt_file_read(&file, 0) >= 0) {}
+
+    EXPECT_EQ(5, file.counter);
+
+    for (int i = 0; i < file.counter; i++) {
+        ASSERT_GE(dlt_file_message(&file, i, 0), DLT_RETURN_OK);
+        EXPECT_EQ(0, memcmp(file.msg.extendedheader->apid, "APP1", DLT_ID_SIZE));
+        /* the messages are stored unchanged, in the order of the file */
+        EXPECT_EQ((uint32_t)(1700000000 + 2 * i + 1), file.msg.storageheader->seconds);
+    }
+
+    dlt_file_free(&file, 0);
+    unlink(GREP_OUTPUT);
+    unlink(GREP_FILE);
+}
+
+TEST(t_dlt_grep_output, logstorage_directory)
+{
+    std::vector<std::string> lines;
+    std::string filename;
+    std::string data;
+
+    mkdir(GREP_DIR, 0755);
+
+    /* the files of a logstorage device are searched in alphabetical order */
+    append_message(data, 1700000000, "ECU1", "APP1", "CTX1", DLT_LOG_INFO, true, "second file");
+    write_file(GREP_DIR "/dlt_000002_19700101_000000.dlt", data);
+    data.clear();
+    append_message(data, 1700000000, "ECU1", "APP1", "CTX1", DLT_LOG_INFO, true, "first file");
+    append_message(data, 1700000000, "ECU1", "APP1", "CTX1", DLT_LOG_INFO, true, "first file again");
+    write_file(GREP_DIR "/dlt_000001_19700101_000000.dlt", data);
+    /* no .dlt file */
+    write_file(GREP_DIR "/dlt_logstorage.conf", data);
+
+    EXPECT_EQ(0, run_grep("-s file " GREP_DIR, &lines));
+    ASSERT_EQ(3u, lines.size());
+
+    EXPECT_EQ(0, message_index(lines[0], &filename));
+    EXPECT_EQ(GREP_DIR "/dlt_000001_19700101_000000.dlt", filename);
+    EXPECT_NE(std::string::npos, lines[0].find("[first file]"));
+    EXPECT_EQ(1, message_index(lines[1], &filename));
+    EXPECT_EQ(GREP_DIR "/dlt_000001_19700101_000000.dlt", filename);
+    EXPECT_EQ(0, message_index(lines[2], &filename));
+    EXPECT_EQ(GREP_DIR "/dlt_000002_19700101_000000.dlt", filename);
+    EXPECT_NE(std::string::npos, lines[2].find("[second file]"));
+
+    unlink(GREP_DIR "/dlt_000001_19700101_000000.dlt");
+    unlink(GREP_DIR "/dlt_000002_19700101_000000.dlt");
+    unlink(GREP_DIR "/dlt_logstorage.conf");
+    rmdir(GREP_DIR);
+}
+/* End Method: dlt-grep::output */
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,615 @@
+/*
+ * SPDX license identifier: MPL-2.0
+ *
+ * This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+ *
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License (MPL), v. 2.0.
+ * If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * For further information see http://www.covesa.org/.
+ */
+
+/*!
+ * \file gtest_dlt_kpi.cpp
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "dlt-kpi.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+extern DltKpiConfig config;
+}
+
+/* Builds a /proc/<pid>/stat line whose field n (counted as in proc(5)) is n * 10 */
+static std::string make_stat(const char *name, int fields)
+{
+    std::string stat = std::string("1234 ") + name + " S";
+
+    for (int field = 4; field <= fields; field++)
+        stat += " " + std::to_string(field * 10);
+
+    return stat + "\n";
+}
+
+/* A process that is not backed by /proc, for the list tests */
+static DltKpiProcess *make_process(pid_t pid)
+{
+    DltKpiProcess process;
+
+    memset(&process, 0, sizeof(process));
+    process.pid = pid;
+
+    return dlt_kpi_clone_process(&process);
+}
+
+static void burn_cpu(long ms)
+{
+    struct timespec start, now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start);
+
+    do
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < ms);
+}
+
+/* Begin Method: dlt_kpi_process::dlt_kpi_parse_process_stat */
+TEST(t_dlt_kpi_parse_process_stat, normal)
+{
+    DltKpiProcessStat stat;
+    std::string line = make_stat("(kworker/0:1)", 52);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_parse_process_stat(line.c_str(), &stat));
+    EXPECT_EQ(40, stat.ppid);
+    EXPECT_EQ(140UL, stat.utime);
+    EXPECT_EQ(150UL, stat.stime);
+    EXPECT_EQ(240L, stat.rss);
+    EXPECT_EQ(420UL, stat.blkio_ticks);
+
+    /* blanks and parentheses in the command name must not shift the fields */
+    line = make_stat("(my (odd) name) S 1)", 44);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_parse_process_stat(line.c_str(), &stat));
+    EXPECT_EQ(40, stat.ppid);
+    EXPECT_EQ(140UL, stat.utime);
+    EXPECT_EQ(150UL, stat.stime);
+    EXPECT_EQ(240L, stat.rss);
+    EXPECT_EQ(420UL, stat.blkio_ticks);
+}
+
+TEST(t_dlt_kpi_parse_process_stat, abnormal)
+{
+    DltKpiProcessStat stat;
+    std::string line = make_stat("(short)", 41);
+
+    /* no command name */
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_parse_process_stat("1234 S 1 2 3\n", &stat));
+    /* ends before the last field needed */
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_parse_process_stat(line.c_str(), &stat));
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_parse_process_stat("", &stat));
+}
+/* End Method: dlt_kpi_process::dlt_kpi_parse_process_stat */
+
+/* Begin Method: dlt_kpi_process::dlt_kpi_sum_process_keys */
+TEST(t_dlt_kpi_sum_process_keys, normal)
+{
+    const char *status = "Name:\tdlt-kpi\n"
+                         "voluntary_ctxt_switches:\t17\n"
+                         "nonvoluntary_ctxt_switches:\t4\n";
+    const char *io = "rchar: 4096\nwchar: 1024\nsyscr: 12\nrchar_other: 1\n";
+    unsigned long int sum = 1;
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_sum_process_keys(status, "voluntary_ctxt_switches",
+                                                      "nonvoluntary_ctxt_switches", &sum));
+    EXPECT_EQ(21UL, sum);
+
+    /* only full keys match, the last line needs no newline */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_sum_process_keys(io, "rchar", "wchar", &sum));
+    EXPECT_EQ(5120UL, sum);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_sum_process_keys("syscw: 2\nwchar: 3", "rchar", "wchar", &sum));
+    EXPECT_EQ(3UL, sum);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_sum_process_keys("syscw: 2\n", "rchar", "wchar", &sum));
+    EXPECT_EQ(0UL, sum);
+}
+
+TEST(t_dlt_kpi_sum_process_keys, abnormal)
+{
+    unsigned long int sum;
+
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_sum_process_keys("rchar: n/a\n", "rchar", "wchar", &sum));
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_sum_process_keys("rchar: 12 kB\n", "rchar", "wchar", &sum));
+}
+/* End Method: dlt_kpi_process::dlt_kpi_sum_process_keys */
+
+/* Begin Method: dlt_kpi_process::dlt_kpi_get_process_stat_name */
+TEST(t_dlt_kpi_get_process_stat_name, normal)
+{
+    char *name = dlt_kpi_get_process_stat_name("12 (a) b) S 2 3\n");
+
+    ASSERT_NE((char *)NULL, name);
+    EXPECT_STREQ("(a) b)", name);
+    free(name);
+
+    EXPECT_EQ((char *)NULL, dlt_kpi_get_process_stat_name("12 a S 2 3\n"));
+    EXPECT_EQ((char *)NULL, dlt_kpi_get_process_stat_name("12 )a( S 2 3\n"));
+}
+/* End Method: dlt_kpi_process::dlt_kpi_get_process_stat_name */
+
+/* Begin Method: dlt_kpi_process::dlt_kpi_update_process */
+TEST(t_dlt_kpi_update_process, normal)
+{
+    burn_cpu(50);
+
+    DltKpiProcess *process = dlt_kpi_create_process(getpid());
+
+    ASSERT_NE((DltKpiProcess *)NULL, process);
+    EXPECT_EQ(getppid(), process->ppid);
+    EXPECT_GT(process->rss, 0);
+    EXPECT_GT(process->ctx_switches, 0);
+    EXPECT_NE((char *)NULL, process->command_line);
+
+    /* the files stay open for the next interval */
+    EXPECT_GE(process->dir_fd, 0);
+    EXPECT_GE(process->stat_fd, 0);
+    EXPECT_GE(process->status_fd, 0);
+    int stat_fd = process->stat_fd;
+
+    burn_cpu(200);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_update_process(process, 0));
+    EXPECT_EQ(stat_fd, process->stat_fd);
+    EXPECT_GT(process->cpu_time, 0UL);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process(process));
+}
+
+TEST(t_dlt_kpi_update_process, ended)
+{
+    int pipefd[2];
+    char c = 0;
+
+    ASSERT_EQ(0, pipe(pipefd));
+
+    pid_t pid = fork();
+
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+        close(pipefd[1]);
+        _exit(read(pipefd[0], &c, 1) < 0);
+    }
+
+    close(pipefd[0]);
+
+    DltKpiProcess *process = dlt_kpi_create_process(pid);
+
+    ASSERT_NE((DltKpiProcess *)NULL, process);
+    EXPECT_EQ(getpid(), process->ppid);
+    EXPECT_GE(process->stat_fd, 0);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_update_process(process, 1000));
+
+    /* the cached stat of a reaped process is not readable anymore,
+     * even if its pid would be reused */
+    close(pipefd[1]);
+    waitpid(pid, NULL, 0);
+    EXPECT_GT(DLT_RETURN_OK, dlt_kpi_update_process(process, 1000));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process(process));
+}
+/* End Method: dlt_kpi_process::dlt_kpi_update_process */
+
+/* Begin Method: dlt_kpi_common::dlt_kpi_read_fd */
+TEST(t_dlt_kpi_read_fd, normal)
+{
+    char filename[] = "/tmp/dlt_kpi_read_fd_XXXXXX";
+    int fd = mkstemp(filename);
+    std::string content;
+    char buffer[3 * BUFFER_SIZE];
+
+    ASSERT_GE(fd, 0);
+    unlink(filename);
+
+    for (int line = 0; content.size() < 2 * BUFFER_SIZE; line++)
+        content += "line " + std::to_string(line) + "\n";
+
+    ASSERT_EQ((ssize_t)content.size(), write(fd, content.c_str(), content.size()));
+
+    /* the offset of the descriptor does not matter, and a full buffer is cut */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_read_fd(fd, buffer, BUFFER_SIZE));
+    EXPECT_EQ(content.substr(0, BUFFER_SIZE - 1), buffer);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_read_fd(fd, buffer, sizeof(buffer)));
+    EXPECT_EQ(content, buffer);
+
+    close(fd);
+
+    /* /proc files are regenerated on each read */
+    fd = open("/proc/self/status", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_read_fd(fd, buffer, sizeof(buffer)));
+    EXPECT_EQ(0, strncmp(buffer, "Name:", 5));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_read_fd(fd, buffer, sizeof(buffer)));
+    EXPECT_EQ(0, strncmp(buffer, "Name:", 5));
+    close(fd);
+}
+
+TEST(t_dlt_kpi_read_fd, abnormal)
+{
+    char filename[] = "/tmp/dlt_kpi_read_fd_XXXXXX";
+    int fd = mkstemp(filename);
+    char buffer[16];
+
+    ASSERT_GE(fd, 0);
+    unlink(filename);
+
+    /* empty file */
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_read_fd(fd, buffer, sizeof(buffer)));
+    EXPECT_STREQ("", buffer);
+    close(fd);
+
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_kpi_read_fd(-1, buffer, sizeof(buffer)));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_kpi_read_fd(0, NULL, sizeof(buffer)));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_kpi_read_fd(0, buffer, 0));
+}
+/* End Method: dlt_kpi_common::dlt_kpi_read_fd */
+
+/* Begin Method: dlt_kpi_process_list::dlt_kpi_find_process */
+TEST(t_dlt_kpi_find_process, normal)
+{
+    /* the pids share one hash bucket */
+    const pid_t pids[] = { 7, 7 + DLT_KPI_PROCESS_HASH_SIZE, 7 + 2 * DLT_KPI_PROCESS_HASH_SIZE, 8 };
+    DltKpiProcess *processes[4];
+    DltKpiProcessList *list = dlt_kpi_create_hashed_process_list();
+
+    ASSERT_NE((DltKpiProcessList *)NULL, list);
+
+    for (int i = 0; i < 4; i++) {
+        processes[i] = make_process(pids[i]);
+        ASSERT_NE((DltKpiProcess *)NULL, processes[i]);
+    }
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_process_at_start(list, processes[0]));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_append_process(list, processes[1]));
+    dlt_kpi_reset_cursor(list);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_process_after_cursor(list, processes[2]));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_process_before_cursor(list, processes[3]));
+
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(processes[i], dlt_kpi_find_process(list, pids[i]));
+
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(list, 7 + 3 * DLT_KPI_PROCESS_HASH_SIZE));
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(list, 9));
+
+    /* removed processes can not be found anymore, the rest of the bucket can */
+    list->cursor = processes[2];
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_remove_process_at_cursor(list));
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(list, pids[2]));
+    EXPECT_EQ(processes[0], dlt_kpi_find_process(list, pids[0]));
+    EXPECT_EQ(processes[1], dlt_kpi_find_process(list, pids[1]));
+
+    list->cursor = processes[0];
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_remove_process_at_cursor_soft(list));
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(list, pids[0]));
+    EXPECT_EQ(processes[1], dlt_kpi_find_process(list, pids[1]));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process(processes[0]));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process_list(list));
+}
+
+TEST(t_dlt_kpi_find_process, abnormal)
+{
+    DltKpiProcessList *list = dlt_kpi_create_process_list();
+
+    ASSERT_NE((DltKpiProcessList *)NULL, list);
+
+    /* lists without hash can not be searched */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_append_process(list, make_process(7)));
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(list, 7));
+    EXPECT_EQ((DltKpiProcess *)NULL, dlt_kpi_find_process(NULL, 7));
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process_list(list));
+}
+/* End Method: dlt_kpi_process_list::dlt_kpi_find_process */
+
+/* /proc/interrupts of a machine with two CPUs */
+static const char *interrupts =
+    "           CPU0       CPU1       \n"
+    "  0:         40          2   IO-APIC   2-edge      timer\n"
+    "  8:          1          0   IO-APIC   8-edge      rtc0\n"
+    "NMI:          5          7   Non-maskable interrupts\n"
+    "ERR:          3\n";
+
+/* Parses text into table like dlt_kpi_log_interrupt_deltas() does */
+static DltReturnValue parse_interrupts(std::string text, DltKpiIrqTable *table)
+{
+    std::vector<char> buffer(text.begin(), text.end());
+    DltReturnValue ret;
+
+    buffer.push_back('\0');
+
+    if ((ret = dlt_kpi_parse_interrupts(buffer.data(), table)) < DLT_RETURN_OK)
+        return ret;
+
+    return dlt_kpi_parse_interrupt_counts(buffer.data(), table);
+}
+
+static void free_interrupts(DltKpiIrqTable *table)
+{
+    free(table->names);
+    free(table->counts);
+    memset(table, 0, sizeof(DltKpiIrqTable));
+}
+
+/* Begin Method: dlt_kpi_interrupt::dlt_kpi_parse_interrupts */
+TEST(t_dlt_kpi_parse_interrupts, normal)
+{
+    DltKpiIrqTable table;
+
+    memset(&table, 0, sizeof(table));
+
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(interrupts, &table));
+    EXPECT_EQ(2, table.cpu_count);
+    ASSERT_EQ(4, table.irq_count);
+    EXPECT_STREQ("0", table.names[0]);
+    EXPECT_STREQ("8", table.names[1]);
+    EXPECT_STREQ("NMI", table.names[2]);
+    EXPECT_STREQ("ERR", table.names[3]);
+    EXPECT_EQ(40U, table.counts[0]);
+    EXPECT_EQ(2U, table.counts[1]);
+    EXPECT_EQ(5U, table.counts[4]);
+    EXPECT_EQ(7U, table.counts[5]);
+    /* missing counters are padded with zeros */
+    EXPECT_EQ(3U, table.counts[6]);
+    EXPECT_EQ(0U, table.counts[7]);
+
+    /* the table grows with the number of rows, long names are cut */
+    std::string text = "      CPU0\n";
+
+    for (int irq = 0; irq < 100; irq++)
+        text += std::to_string(irq) + ": " + std::to_string(irq * 3) + "\n";
+
+    text += "averyveryverylongname: 1\n";
+
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(text, &table));
+    EXPECT_EQ(1, table.cpu_count);
+    ASSERT_EQ(101, table.irq_count);
+    EXPECT_GE(table.irq_max, 101);
+
+    for (int irq = 0; irq < 100; irq++) {
+        EXPECT_STREQ(std::to_string(irq).c_str(), table.names[irq]);
+        EXPECT_EQ((uint64_t)irq * 3, table.counts[irq]);
+    }
+
+    EXPECT_EQ(std::string("averyveryverylongname").substr(0, DLT_KPI_IRQ_NAME_SIZE - 1), table.names[100]);
+    EXPECT_EQ(1U, table.counts[100]);
+
+    free_interrupts(&table);
+}
+
+TEST(t_dlt_kpi_parse_interrupts, abnormal)
+{
+    DltKpiIrqTable table;
+
+    memset(&table, 0, sizeof(table));
+
+    /* no header line */
+    EXPECT_EQ(DLT_RETURN_ERROR, parse_interrupts("           CPU0       CPU1", &table));
+    /* no CPU columns */
+    EXPECT_EQ(DLT_RETURN_ERROR, parse_interrupts("header\n  0: 1 2\n", &table));
+
+    free_interrupts(&table);
+}
+/* End Method: dlt_kpi_interrupt::dlt_kpi_parse_interrupts */
+
+/* Begin Method: dlt_kpi_interrupt::dlt_kpi_interrupt_layout_changed */
+TEST(t_dlt_kpi_interrupt_layout_changed, normal)
+{
+    DltKpiIrqTable previous, current;
+    std::string text = interrupts;
+
+    memset(&previous, 0, sizeof(previous));
+    memset(&current, 0, sizeof(current));
+
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(text, &previous));
+
+    /* other counters only */
+    std::string counts = text;
+    counts.replace(counts.find("40"), 2, "99");
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(counts, &current));
+    EXPECT_EQ(0, dlt_kpi_interrupt_layout_changed(&current, &previous));
+
+    /* renamed IRQ */
+    std::string renamed = text;
+    renamed.replace(renamed.find("  8:"), 4, "  9:");
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(renamed, &current));
+    EXPECT_EQ(1, dlt_kpi_interrupt_layout_changed(&current, &previous));
+
+    /* added IRQ */
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(text + "MIS:          0\n", &current));
+    EXPECT_EQ(1, dlt_kpi_interrupt_layout_changed(&current, &previous));
+
+    /* CPU went offline */
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts("      CPU0\n  0: 40\n  8: 1\nNMI: 5\nERR: 3\n", &current));
+    EXPECT_EQ(1, dlt_kpi_interrupt_layout_changed(&current, &previous));
+
+    free_interrupts(&previous);
+    free_interrupts(&current);
+}
+/* End Method: dlt_kpi_interrupt::dlt_kpi_interrupt_layout_changed */
+
+/* Begin Method: dlt_kpi_interrupt::dlt_kpi_get_interrupt_entry */
+TEST(t_dlt_kpi_get_interrupt_entry, normal)
+{
+    DltKpiIrqTable previous, current;
+    unsigned char entry[1 + DLT_KPI_IRQ_NAME_SIZE + 2 * sizeof(uint64_t)];
+    uint64_t count64;
+    uint32_t count32;
+
+    memset(&previous, 0, sizeof(previous));
+    memset(&current, 0, sizeof(current));
+
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts(interrupts, &previous));
+    ASSERT_EQ(DLT_RETURN_OK, parse_interrupts("           CPU0       CPU1\n"
+                                              "  0:         45          2\n"
+                                              "  8:          1          0\n"
+                                              "NMI:          2 5000000007\n"
+                                              "ERR:          3\n", &current));
+
+    /* keyframes carry the absolute counters of every IRQ */
+    ASSERT_EQ(1 + 3 + 2 * sizeof(uint64_t), dlt_kpi_get_interrupt_entry(&current, &previous, 2, 1, entry));
+    EXPECT_EQ(3, entry[0]);
+    EXPECT_EQ(0, memcmp(entry + 1, "NMI", 3));
+    memcpy(&count64, entry + 4, sizeof(count64));
+    EXPECT_EQ(2U, count64);
+    memcpy(&count64, entry + 4 + sizeof(uint64_t), sizeof(count64));
+    EXPECT_EQ(5000000007U, count64);
+    EXPECT_EQ(1 + 1 + 2 * sizeof(uint64_t), dlt_kpi_get_interrupt_entry(&current, &previous, 1, 1, entry));
+
+    /* delta records carry the increments of the changed IRQs */
+    ASSERT_EQ(1 + 1 + 2 * sizeof(uint32_t), dlt_kpi_get_interrupt_entry(&current, &previous, 0, 0, entry));
+    EXPECT_EQ(1, entry[0]);
+    EXPECT_EQ('0', entry[1]);
+    memcpy(&count32, entry + 2, sizeof(count32));
+    EXPECT_EQ(5U, count32);
+    memcpy(&count32, entry + 2 + sizeof(uint32_t), sizeof(count32));
+    EXPECT_EQ(0U, count32);
+
+    EXPECT_EQ(0U, dlt_kpi_get_interrupt_entry(&current, &previous, 1, 0, entry));
+    EXPECT_EQ(0U, dlt_kpi_get_interrupt_entry(&current, &previous, 3, 0, entry));
+
+    /* a counter that went back was reset, an increment beyond 32 bit saturates */
+    ASSERT_EQ(1 + 3 + 2 * sizeof(uint32_t), dlt_kpi_get_interrupt_entry(&current, &previous, 2, 0, entry));
+    memcpy(&count32, entry + 4, sizeof(count32));
+    EXPECT_EQ(2U, count32);
+    memcpy(&count32, entry + 4 + sizeof(uint32_t), sizeof(count32));
+    EXPECT_EQ(UINT32_MAX, count32);
+
+    free_interrupts(&previous);
+    free_interrupts(&current);
+}
+/* End Method: dlt_kpi_interrupt::dlt_kpi_get_interrupt_entry */
+
+/* Writes content to a temporary configuration file and reads it */
+static DltReturnValue read_configuration(const char *content, DltKpiConfig *kpi_config)
+{
+    char filename[] = "/tmp/dlt_kpi_conf_XXXXXX";
+    int fd = mkstemp(filename);
+    DltReturnValue ret;
+
+    if (fd < 0)
+        return DLT_RETURN_ERROR;
+
+    if (write(fd, content, strlen(content)) != (ssize_t)strlen(content))
+        ret = DLT_RETURN_ERROR;
+    else
+        ret = dlt_kpi_read_configuration_file(kpi_config, filename);
+
+    close(fd);
+    unlink(filename);
+
+    return ret;
+}
+
+/* Begin Method: dlt_kpi_options::dlt_kpi_read_configuration_file */
+TEST(t_dlt_kpi_read_configuration_file, delta_mode)
+{
+    DltKpiConfig kpi_config;
+    char missing[] = "/tmp/dlt_kpi_conf_missing";
+
+    ASSERT_EQ(DLT_RETURN_OK, read_configuration("# delta mode\n"
+                                                "delta_mode = 1\n"
+                                                "delta_cpu_threshold = 0\n"
+                                                "delta_rss_threshold = 1024 # pages\n"
+                                                "keyframe_interval = 4\n", &kpi_config));
+    EXPECT_EQ(1, kpi_config.delta_mode);
+    EXPECT_EQ(0, kpi_config.delta_cpu_threshold);
+    EXPECT_EQ(1024, kpi_config.delta_rss_threshold);
+    EXPECT_EQ(4, kpi_config.keyframe_interval);
+
+    /* invalid values keep the defaults */
+    ASSERT_EQ(DLT_RETURN_OK, read_configuration("delta_mode = 2\n"
+                                                "delta_cpu_threshold = -1\n"
+                                                "delta_rss_threshold = 1k\n"
+                                                "keyframe_interval = 0\n", &kpi_config));
+    EXPECT_EQ(0, kpi_config.delta_mode);
+    EXPECT_EQ(10, kpi_config.delta_cpu_threshold);
+    EXPECT_EQ(256, kpi_config.delta_rss_threshold);
+    EXPECT_EQ(30, kpi_config.keyframe_interval);
+
+    EXPECT_EQ(DLT_RETURN_ERROR, dlt_kpi_read_configuration_file(&kpi_config, missing));
+}
+/* End Method: dlt_kpi_options::dlt_kpi_read_configuration_file */
+
+/* Begin Method: dlt_kpi::dlt_kpi_add_active_process */
+TEST(t_dlt_kpi_add_active_process, normal)
+{
+    DltKpiProcess process;
+
+    memset(&process, 0, sizeof(process));
+    process.pid = 7;
+    process.dir_fd = process.stat_fd = process.status_fd = process.io_fd = -1;
+
+    ASSERT_EQ(DLT_RETURN_OK, dlt_kpi_init_process_lists());
+
+    /* default mode: only processes that used CPU time are logged */
+    config.delta_mode = 0;
+    process.reported_cpu_time = 7;
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 0));
+    EXPECT_EQ(7UL, process.reported_cpu_time);
+    process.cpu_time = 3;
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 0));
+    EXPECT_EQ(3UL, process.reported_cpu_time);
+
+    /* delta mode: changes below both thresholds are not logged */
+    config.delta_mode = 1;
+    config.delta_cpu_threshold = 10;
+    config.delta_rss_threshold = 256;
+    process.reported_cpu_time = 100;
+    process.reported_rss = 1000;
+    process.cpu_time = 109;
+    process.rss = 1255;
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 0));
+    EXPECT_EQ(100UL, process.reported_cpu_time);
+    EXPECT_EQ(1000L, process.reported_rss);
+
+    /* ... but on a keyframe */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 1));
+    EXPECT_EQ(109UL, process.reported_cpu_time);
+    EXPECT_EQ(1255L, process.reported_rss);
+
+    /* decreasing CPU time reaching the threshold */
+    process.cpu_time = 99;
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 0));
+    EXPECT_EQ(99UL, process.reported_cpu_time);
+
+    /* RSS change reaching the threshold */
+    process.rss = 999;
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_add_active_process(&process, 0));
+    EXPECT_EQ(999L, process.reported_rss);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_kpi_free_process_lists());
+    config.delta_mode = 0;
+}
+/* End Method: dlt_kpi::dlt_kpi_add_active_process */
+
+/*##############################################################################################################################*/
+/*##############################################################################################################################*/
+/*##############################################################################################################################*/
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+#include <gtest/gtest.h>
+
+extern "C"
+{
+    #include "dlt_common.h"
+    #include "dlt-parquet.h"
+}
+
+#define PARQUET_FILE "gtest_dlt_parquet.parquet"
+
+/* Prepare a verbose info log message with extended header */
+static void prepare_message(DltMessage *msg, const char *apid, uint8_t counter)
+{
+    memset(msg, 0, sizeof(DltMessage));
+    msg->storageheader = (DltStorageHeader *)msg->headerbuffer;
+    msg->storageheader->seconds = 1700000000;
+    msg->storageheader->microseconds = counter;
+    dlt_set_id(msg->storageheader->ecu, "ECU1");
+    msg->standardheader = (DltStandardHeader *)(msg->headerbuffer + sizeof(DltStorageHeader));
+    msg->standardheader->htyp = DLT_HTYP_PROTOCOL_VERSION1 | DLT_HTYP_UEH;
+    msg->standardheader->mcnt = counter;
+    msg->extendedheader = (DltExtendedHeader *)(msg->headerbuffer + sizeof(DltStorageHeader) +
+                                                sizeof(DltStandardHeader));
+    msg->extendedheader->msin = DLT_MSIN_VERB | (DLT_TYPE_LOG << DLT_MSIN_MSTP_SHIFT) |
+        (DLT_LOG_INFO << DLT_MSIN_MTIN_SHIFT);
+    dlt_set_id(msg->extendedheader->apid, apid);
+    dlt_set_id(msg->extendedheader->ctid, "CTX");
+}
+
+/* Read the file back, return its size */
+static long read_file(char *data, long size)
+{
+    FILE *handle = fopen(PARQUET_FILE, "rb");
+    long length;
+
+    if (handle == NULL)
+        return -1;
+
+    length = (long)fread(data, 1, (size_t)size, handle);
+    fclose(handle);
+
+    return length;
+}
+
+static bool contains(const char *data, long size, const char *text)
+{
+    return memmem(data, (size_t)size, text, strlen(text)) != NULL;
+}
+
+/* Begin Method: dlt_parquet::dlt_parquet_write_message */
+TEST(t_dlt_parquet_write_message, normal)
+{
+    static char data[4 * 1024 * 1024];
+    DltParquet *parquet;
+    DltMessage msg;
+    uint32_t footer;
+    long size;
+    int i;
+
+    parquet = dlt_parquet_open(PARQUET_FILE, 0);
+    ASSERT_NE((DltParquet *)NULL, parquet);
+
+    /* more than one row group */
+    for (i = 0; i < DLT_PARQUET_ROW_GROUP_SIZE + 10; i++) {
+        prepare_message(&msg, (i % 2) ? "APP1" : "APP2", (uint8_t)i);
+        EXPECT_EQ(DLT_RETURN_OK, dlt_parquet_write_message(parquet, &msg, "hello parquet"));
+    }
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_parquet_close(parquet));
+
+    size = read_file(data, sizeof(data));
+    ASSERT_GT(size, 12);
+    ASSERT_LT(size, (long)sizeof(data));
+
+    EXPECT_EQ(0, memcmp(data, "PAR1", 4));
+    EXPECT_EQ(0, memcmp(data + size - 4, "PAR1", 4));
+
+    footer = (uint32_t)(uint8_t)data[size - 8] | ((uint32_t)(uint8_t)data[size - 7] << 8) |
+        ((uint32_t)(uint8_t)data[size - 6] << 16) | ((uint32_t)(uint8_t)data[size - 5] << 24);
+    EXPECT_LT((long)footer, size - 12);
+
+    /* column names in the footer, dictionary entries in the pages */
+    EXPECT_TRUE(contains(data + size - 8 - footer, footer, "apid"));
+    EXPECT_TRUE(contains(data + size - 8 - footer, footer, "payload"));
+#ifndef DLT_PARQUET_USE_GZIP
+    EXPECT_TRUE(contains(data, size, "APP1"));
+    EXPECT_TRUE(contains(data, size, "info"));
+    EXPECT_TRUE(contains(data, size, "hello parquet"));
+#endif
+
+    remove(PARQUET_FILE);
+}
+
+TEST(t_dlt_parquet_write_message, abnormal)
+{
+    DltParquet *parquet;
+    DltMessage msg;
+    char data[1024];
+    long size;
+
+    EXPECT_EQ((DltParquet *)NULL, dlt_parquet_open(NULL, 0));
+    EXPECT_EQ((DltParquet *)NULL, dlt_parquet_open("/nonexistent/file.parquet", 0));
+
+    parquet = dlt_parquet_open(PARQUET_FILE, 0);
+    ASSERT_NE((DltParquet *)NULL, parquet);
+
+    prepare_message(&msg, "APP1", 0);
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_parquet_write_message(NULL, &msg, ""));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_parquet_write_message(parquet, NULL, ""));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_parquet_write_message(parquet, &msg, NULL));
+
+    /* a file without rows is still complete */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_parquet_close(parquet));
+    size = read_file(data, sizeof(data));
+    ASSERT_GT(size, 12);
+    EXPECT_EQ(0, memcmp(data + size - 4, "PAR1", 4));
+
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_parquet_close(NULL));
+    remove(PARQUET_FILE);
+}
+/* End Method: dlt_parquet::dlt_parquet_write_message */
@@ -31,14 +31,23 @@
 #include <stdint.h>
 #include <float.h>
 #include <chrono>
+#include <thread>
+#include <string>
+#include <atomic>
+#include <ctime>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 
 extern "C" {
 #include "dlt_user.h"
 #include "dlt_user_cfg.h"
+#include "dlt_user_shared.h"
+#include "dlt_user_shared_cfg.h"
 }
 
+#include "dlt_cpp_extension.hpp"
+
 /* TEST COMMENTED OUT WITH */
 /* TODO: */
 /* DO FAIL! */
@@ -3950,6 +3959,131 @@ TEST(t_dlt_user_log_write_raw_formatted_attr, normal)
     EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
 }
 
+/*/////////////////////////////////////// */
+/* t_dlt_user_log_write_reserve */
+TEST(t_dlt_user_log_write_reserve, normal)
+{
+    DltContext context;
+    DltContextData contextData;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_dlt_user_log_write_reserve normal"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_start(&context, &contextData, DLT_LOG_DEFAULT));
+
+    uint32_t type_info = DLT_TYPE_INFO_UINT | DLT_TYLE_32BIT;
+    uint32_t value = 42;
+    unsigned char *data = dlt_user_log_write_reserve(&contextData, sizeof(type_info) + sizeof(value), 1);
+    ASSERT_NE((unsigned char *)NULL, data);
+    EXPECT_EQ((int32_t)(sizeof(type_info) + sizeof(value)), contextData.size);
+    EXPECT_EQ(1, contextData.args_num);
+    memcpy(data, &type_info, sizeof(type_info));
+    memcpy(data + sizeof(type_info), &value, sizeof(value));
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_finish(&contextData));
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+}
+
+TEST(t_dlt_user_log_write_reserve, abnormal)
+{
+    DltContext context;
+    DltContextData contextData;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_dlt_user_log_write_reserve abnormal"));
+
+    EXPECT_EQ((unsigned char *)NULL, dlt_user_log_write_reserve(NULL, 4, 1));
+
+    /* does not fit into the message */
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_start(&context, &contextData, DLT_LOG_DEFAULT));
+    EXPECT_EQ((unsigned char *)NULL, dlt_user_log_write_reserve(&contextData, DLT_USER_BUF_MAX_SIZE + 1, 1));
+    EXPECT_EQ(0, contextData.size);
+    EXPECT_EQ(0, contextData.args_num);
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_finish(&contextData));
+
+    /* non-verbose message */
+    dlt_nonverbose_mode();
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_start_id(&context, &contextData, DLT_LOG_DEFAULT, 42));
+    EXPECT_EQ((unsigned char *)NULL, dlt_user_log_write_reserve(&contextData, 4, 1));
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_finish(&contextData));
+    dlt_verbose_mode();
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+}
+
+/*/////////////////////////////////////// */
+/* t_logToDltEncoded */
+template<typename ... Args>
+static void expect_encoded_equals_variadic(DltContext &context, const Args&... values)
+{
+    DltContextData variadic;
+    DltContextData encoded;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_start(&context, &variadic, DLT_LOG_DEFAULT));
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_start(&context, &encoded, DLT_LOG_DEFAULT));
+
+    logToDltVariadic(variadic, values...);
+    logToDltEncoded(encoded, values...);
+
+    EXPECT_EQ(variadic.size, encoded.size);
+    EXPECT_EQ(variadic.args_num, encoded.args_num);
+
+    if (variadic.size == encoded.size) {
+        EXPECT_EQ(0, memcmp(variadic.buffer, encoded.buffer, (size_t)variadic.size));
+    }
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_finish(&variadic));
+    EXPECT_LE(DLT_RETURN_OK, dlt_user_log_write_finish(&encoded));
+}
+
+TEST(t_logToDltEncoded, normal)
+{
+    DltContext context;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_logToDltEncoded normal"));
+
+    char text[] = "char *";
+    std::string aString = "std::string";
+    std::string_view aView = std::string_view("std::string_view and more").substr(0, 16);
+    std::vector<int32_t> intVector = { 1, -2, 3 };
+    std::list<double> doubleList = { 1.5, -2.25 };
+    std::map<int32_t, std::string> testMap = { { 1, "one" }, { 2, "two" } };
+
+    expect_encoded_equals_variadic(context, (int8_t)-8, (int16_t)-16, (int32_t)-32, (int64_t)-64);
+    expect_encoded_equals_variadic(context, (uint8_t)8, (uint16_t)16, (uint32_t)32, (uint64_t)64);
+    expect_encoded_equals_variadic(context, (float32_t)1.5, 2.5, true, false);
+    expect_encoded_equals_variadic(context, "literal", text, (char const *)text, aString, aView, "");
+    expect_encoded_equals_variadic(context, "vector", intVector, "list", doubleList, "map", testMap);
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+}
+
+TEST(t_logToDltEncoded, abnormal)
+{
+    DltContext context;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_logToDltEncoded abnormal"));
+
+    /* arguments that do not fit fall back to the per-argument path */
+    std::vector<uint64_t> bigVector(DLT_USER_BUF_MAX_SIZE, 1);
+    std::string bigString(DLT_USER_BUF_MAX_SIZE, 'x');
+    char *nullString = NULL;
+    std::vector<char const *> nullVector = { "abc", NULL };
+
+    expect_encoded_equals_variadic(context, "vector", bigVector);
+    expect_encoded_equals_variadic(context, (int32_t)1, bigString);
+    expect_encoded_equals_variadic(context, (int32_t)1, nullString, (int32_t)2);
+    /* an invalid element must not be hidden by the size of the others */
+    expect_encoded_equals_variadic(context, (int32_t)1, nullVector);
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+}
+
 /*/////////////////////////////////////// */
 /*
  * Test sending Verbose and Non-Verbose messages in the same session.
@@ -5301,6 +5435,319 @@ TEST(t_dlt_nonverbose_mode, normal)
 
 }
 
+/*/////////////////////////////////////// */
+/* t_dlt_user_wait_buffer_space */
+TEST(t_dlt_user_wait_buffer_space, normal)
+{
+    int total_size = 0, used_size = 0;
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+
+    /* nothing to wait for */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_user_wait_buffer_space(0, 0));
+
+    /* buffered messages are flushed to the daemon while waiting */
+    EXPECT_EQ(DLT_RETURN_OK, dlt_user_wait_buffer_space(50, 1000));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_user_check_buffer(&total_size, &used_size));
+    EXPECT_GE(total_size - used_size, total_size / 2);
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+}
+
+#if defined DLT_LIB_USE_FIFO_IPC && !defined DLT_SHM_ENABLE
+/*
+ * Connect to a FIFO which nobody reads until pipe and user buffer are filled up,
+ * then check that waiting sleeps until the timeout and returns as soon as the
+ * FIFO is drained.
+ */
+TEST(t_dlt_user_wait_buffer_space, buffer_full)
+{
+    DltContext context;
+    const char *pipe_dir = "/tmp/dlt_wait_buffer_space";
+    char fifo[DLT_PATH_MAX];
+    char message[200];
+    int total_size = 0, used_size = 0;
+    int reader;
+    int i;
+    clock_t cpu;
+    std::atomic<bool> draining(true);
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    mkdir(pipe_dir, S_IRWXU);
+    snprintf(fifo, sizeof(fifo), "%s/dlt", pipe_dir);
+    unlink(fifo);
+    ASSERT_EQ(0, mkfifo(fifo, S_IRUSR | S_IWUSR));
+    reader = open(fifo, O_RDONLY | O_NONBLOCK);
+    ASSERT_LE(0, reader);
+
+    setenv("DLT_PIPE_DIR", pipe_dir, 1);
+    setenv(DLT_USER_ENV_BUFFER_MIN_SIZE, "20000", 1);
+    setenv(DLT_USER_ENV_BUFFER_MAX_SIZE, "20000", 1);
+    setenv(DLT_USER_ENV_BUFFER_STEP_SIZE, "20000", 1);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_dlt_user_wait_buffer_space buffer_full"));
+
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    for (i = 0; i < 10000; i++) {
+        dlt_log_string(&context, DLT_LOG_INFO, message);
+        EXPECT_EQ(DLT_RETURN_OK, dlt_user_check_buffer(&total_size, &used_size));
+
+        if (used_size > total_size * 3 / 4)
+            break;
+    }
+
+    ASSERT_GT(used_size, total_size * 3 / 4);
+
+    /* nobody reads: time out without burning the CPU */
+    auto start = std::chrono::steady_clock::now();
+    cpu = clock();
+    EXPECT_EQ(DLT_RETURN_BUFFER_FULL, dlt_user_wait_buffer_space(50, 500));
+    EXPECT_LE(490, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    EXPECT_GT(CLOCKS_PER_SEC / 10, clock() - cpu);
+
+    /* the daemon side reads again: the buffer is flushed into the FIFO */
+    std::thread drain([&]() {
+        char buf[4096];
+
+        while (draining) {
+            if (read(reader, buf, sizeof(buf)) <= 0)
+                usleep(1000);
+        }
+    });
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_user_wait_buffer_space(50, 5000));
+    EXPECT_EQ(DLT_RETURN_OK, dlt_user_check_buffer(&total_size, &used_size));
+    EXPECT_GE(total_size - used_size, total_size / 2);
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    draining = false;
+    drain.join();
+    close(reader);
+    unlink(fifo);
+
+    /* restore the default environment for the other test cases */
+    unsetenv(DLT_USER_ENV_BUFFER_MIN_SIZE);
+    unsetenv(DLT_USER_ENV_BUFFER_MAX_SIZE);
+    unsetenv(DLT_USER_ENV_BUFFER_STEP_SIZE);
+    unsetenv("DLT_PIPE_DIR");
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+}
+#endif
+
+TEST(t_dlt_user_wait_buffer_space, abnormal)
+{
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_user_wait_buffer_space(-1, 0));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_user_wait_buffer_space(101, 0));
+    EXPECT_EQ(DLT_RETURN_WRONG_PARAMETER, dlt_user_wait_buffer_space(50, -1));
+}
+
+#if defined DLT_LIB_USE_FIFO_IPC && !defined DLT_SHM_ENABLE
+/*
+ * Messages of a registered application which did not fit into the FIFO are
+ * kept in the user buffer and sent once the FIFO is read again.
+ */
+TEST(t_dlt_user_log_resend_buffer, normal)
+{
+    DltContext context;
+    const char *pipe_dir = "/tmp/dlt_resend_buffer";
+    char fifo[DLT_PATH_MAX];
+    char message[200];
+    char buf[4096];
+    std::string received;
+    int total_size = 0, used_size = 0;
+    int logged = 0;
+    int reader;
+    int i;
+    size_t pos;
+    ssize_t len;
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    mkdir(pipe_dir, S_IRWXU);
+    snprintf(fifo, sizeof(fifo), "%s/dlt", pipe_dir);
+    unlink(fifo);
+    ASSERT_EQ(0, mkfifo(fifo, S_IRUSR | S_IWUSR));
+    reader = open(fifo, O_RDONLY | O_NONBLOCK);
+    ASSERT_LE(0, reader);
+
+    setenv("DLT_PIPE_DIR", pipe_dir, 1);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_dlt_user_log_resend_buffer normal"));
+
+    /* nobody reads: fill the FIFO until messages are buffered */
+    for (i = 0; (i < 10000) && (used_size == 0); i++) {
+        snprintf(message, sizeof(message), "resend %05d %0150d", i, 0);
+        EXPECT_LE(DLT_RETURN_OK, dlt_log_string(&context, DLT_LOG_INFO, message));
+        EXPECT_EQ(DLT_RETURN_OK, dlt_user_check_buffer(&total_size, &used_size));
+        logged++;
+    }
+
+    ASSERT_GT(used_size, 0);
+
+    /* read the FIFO and resend until the buffer is empty */
+    for (i = 0; (i < 1000) && (used_size > 0); i++) {
+        while ((len = read(reader, buf, sizeof(buf))) > 0)
+            received.append(buf, (size_t)len);
+
+        dlt_user_log_resend_buffer();
+        EXPECT_EQ(DLT_RETURN_OK, dlt_user_check_buffer(&total_size, &used_size));
+    }
+
+    EXPECT_EQ(0, used_size);
+
+    while ((len = read(reader, buf, sizeof(buf))) > 0)
+        received.append(buf, (size_t)len);
+
+    /* every message arrived exactly once and in order */
+    pos = 0;
+
+    for (i = 0; i < logged; i++) {
+        snprintf(message, sizeof(message), "resend %05d ", i);
+        pos = received.find(message, pos);
+        ASSERT_NE(std::string::npos, pos) << "message " << i << " missing";
+        EXPECT_EQ(std::string::npos, received.find(message, pos + 1));
+    }
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context));
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    close(reader);
+    unlink(fifo);
+
+    /* restore the default environment for the other test cases */
+    unsetenv("DLT_PIPE_DIR");
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+}
+#endif
+
+#if defined DLT_LIB_USE_FIFO_IPC && !defined DLT_SHM_ENABLE
+/* Write a log level message, or a batch of count entries if count >= 0, to the application FIFO */
+static void send_log_level(int fifo, int32_t count, const DltUserControlMsgLogLevel *entries, size_t num_entries)
+{
+    std::string data;
+    DltUserHeader userheader;
+    DltUserControlMsgLogLevelBatch batch;
+
+    ASSERT_EQ(DLT_RETURN_OK, dlt_user_set_userheader(&userheader, (count >= 0) ? DLT_USER_MESSAGE_LOG_LEVEL_BATCH :
+                                                     DLT_USER_MESSAGE_LOG_LEVEL));
+    data.append((const char *)&userheader, sizeof(userheader));
+
+    if (count >= 0) {
+        batch.count = (uint32_t)count;
+        data.append((const char *)&batch, sizeof(batch));
+    }
+
+    data.append((const char *)entries, num_entries * sizeof(DltUserControlMsgLogLevel));
+    ASSERT_EQ((ssize_t)data.size(), write(fifo, data.data(), data.size()));
+}
+
+/* Wait until the housekeeper thread applied the log level to the context */
+static bool wait_log_level(DltContext *context, int8_t log_level)
+{
+    for (int i = 0; i < 2000; i++) {
+        if (*context->log_level_ptr == log_level)
+            return true;
+
+        usleep(1000);
+    }
+
+    return false;
+}
+
+/*
+ * The daemon sends the log levels of several contexts in one
+ * DLT_USER_MESSAGE_LOG_LEVEL_BATCH message to the application FIFO.
+ */
+TEST(t_dlt_user_log_level_batch, receive)
+{
+    DltContext context[3];
+    DltUserControlMsgLogLevel entries[3];
+    const char *pipe_dir = "/tmp/dlt_log_level_batch";
+    char fifo[DLT_PATH_MAX];
+    char id[DLT_ID_SIZE + 1];
+    int writer;
+    int i;
+
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    mkdir(pipe_dir, S_IRWXU);
+    setenv("DLT_PIPE_DIR", pipe_dir, 1);
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TUSR", "dlt_user.c tests"));
+
+    for (i = 0; i < 3; i++) {
+        snprintf(id, sizeof(id), "CT%02d", i);
+        EXPECT_LE(DLT_RETURN_OK, dlt_register_context_ll_ts(&context[i], id, "dlt_user.c t_dlt_user_log_level_batch",
+                                                             DLT_LOG_INFO, DLT_TRACE_STATUS_OFF));
+    }
+
+    snprintf(fifo, sizeof(fifo), "%s/dltpipes/dlt%d", pipe_dir, getpid());
+    writer = open(fifo, O_WRONLY | O_NONBLOCK);
+    ASSERT_LE(0, writer);
+
+    /* all contexts of the batch are updated */
+    entries[0] = { DLT_LOG_VERBOSE, DLT_TRACE_STATUS_OFF, context[0].log_level_pos };
+    entries[1] = { DLT_LOG_ERROR, DLT_TRACE_STATUS_ON, context[1].log_level_pos };
+    entries[2] = { DLT_LOG_WARN, DLT_TRACE_STATUS_OFF, context[2].log_level_pos };
+    send_log_level(writer, 3, entries, 3);
+    ASSERT_TRUE(wait_log_level(&context[2], DLT_LOG_WARN));
+    EXPECT_EQ(DLT_LOG_VERBOSE, *context[0].log_level_ptr);
+    EXPECT_EQ(DLT_LOG_ERROR, *context[1].log_level_ptr);
+    EXPECT_EQ(DLT_TRACE_STATUS_ON, *context[1].trace_status_ptr);
+    EXPECT_EQ(DLT_TRACE_STATUS_OFF, *context[2].trace_status_ptr);
+
+    /* positions outside of the context table are skipped */
+    entries[0] = { DLT_LOG_FATAL, DLT_TRACE_STATUS_OFF, -1 };
+    entries[1] = { DLT_LOG_FATAL, DLT_TRACE_STATUS_OFF, 100000 };
+    entries[2] = { DLT_LOG_DEBUG, DLT_TRACE_STATUS_OFF, context[1].log_level_pos };
+    send_log_level(writer, 3, entries, 3);
+    ASSERT_TRUE(wait_log_level(&context[1], DLT_LOG_DEBUG));
+    EXPECT_EQ(DLT_LOG_VERBOSE, *context[0].log_level_ptr);
+    EXPECT_EQ(DLT_LOG_WARN, *context[2].log_level_ptr);
+
+    /* a count above DLT_USER_LOG_LEVEL_BATCH_MAX is dropped, the next message is handled */
+    entries[0] = { DLT_LOG_FATAL, DLT_TRACE_STATUS_OFF, context[1].log_level_pos };
+    entries[1] = { DLT_LOG_FATAL, DLT_TRACE_STATUS_OFF, context[2].log_level_pos };
+    send_log_level(writer, DLT_USER_LOG_LEVEL_BATCH_MAX + 1, entries, 2);
+    entries[0] = { DLT_LOG_ERROR, DLT_TRACE_STATUS_OFF, context[0].log_level_pos };
+    send_log_level(writer, -1, entries, 1);
+    ASSERT_TRUE(wait_log_level(&context[0], DLT_LOG_ERROR));
+    EXPECT_EQ(DLT_LOG_DEBUG, *context[1].log_level_ptr);
+    EXPECT_EQ(DLT_LOG_WARN, *context[2].log_level_ptr);
+
+    /* a batch split by the FIFO is applied once it is complete */
+    entries[0] = { DLT_LOG_INFO, DLT_TRACE_STATUS_OFF, context[0].log_level_pos };
+    entries[1] = { DLT_LOG_INFO, DLT_TRACE_STATUS_OFF, context[2].log_level_pos };
+    send_log_level(writer, 2, entries, 1);
+    usleep(50000);
+    EXPECT_EQ(DLT_LOG_ERROR, *context[0].log_level_ptr);
+    ASSERT_EQ((ssize_t)sizeof(DltUserControlMsgLogLevel), write(writer, &entries[1], sizeof(entries[1])));
+    ASSERT_TRUE(wait_log_level(&context[2], DLT_LOG_INFO));
+    EXPECT_EQ(DLT_LOG_INFO, *context[0].log_level_ptr);
+
+    close(writer);
+
+    for (i = 0; i < 3; i++)
+        EXPECT_LE(DLT_RETURN_OK, dlt_unregister_context(&context[i]));
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_unregister_app());
+    EXPECT_EQ(DLT_RETURN_OK, dlt_free());
+
+    /* restore the default environment for the other test cases */
+    unsetenv("DLT_PIPE_DIR");
+    EXPECT_EQ(DLT_RETURN_OK, dlt_init());
+}
+#endif
+
 /*/////////////////////////////////////// */
 /* free dlt */
 TEST(t_dlt_free, onetime)
@@ -5465,6 +5912,68 @@ TEST(t_dlt_user_run_into_trace_limit, normal)
     dlt_unregister_app();
 }
 
+/*/////////////////////////////////////// */
+/* t_dlt_user_trace_load_update */
+struct trace_load_logger_args
+{
+    DltContext *context;
+    std::atomic<bool> *stop;
+    std::atomic<int> sent;
+};
+
+static void *trace_load_logger(void *arg)
+{
+    struct trace_load_logger_args *args = (struct trace_load_logger_args *)arg;
+    DltContextData contextData;
+
+    while (!args->stop->load()) {
+        if (dlt_user_log_write_start(args->context, &contextData, DLT_LOG_INFO) <= DLT_RETURN_OK)
+            continue;
+
+        dlt_user_log_write_uint(&contextData, 42);
+        dlt_user_log_write_finish(&contextData);
+        args->sent++;
+    }
+
+    return NULL;
+}
+
+TEST(t_dlt_user_trace_load_update, concurrent_log)
+{
+    DltContext context;
+    std::atomic<bool> stop(false);
+    struct trace_load_logger_args args[4];
+    pthread_t threads[4];
+
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_app("TLUA", "dlt_user.c tests"));
+    EXPECT_LE(DLT_RETURN_OK, dlt_register_context(&context, "TEST", "dlt_user.c t_dlt_user_trace_load_update"));
+
+    for (int i = 0; i < 4; i++) {
+        args[i].context = &context;
+        args[i].stop = &stop;
+        args[i].sent = 0;
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, trace_load_logger, &args[i]));
+    }
+
+    for (int i = 0; i < 4; i++)
+        while (args[i].sent == 0)
+            std::this_thread::yield();
+
+    /* every registration publishes new settings while the threads account
+     * their messages in the replaced ones, return values are not checked
+     * because error is returned due to full local buffers */
+    for (int i = 0; i < 200; i++)
+        dlt_register_app((i % 2) ? "TLUA" : "TLUB", "dlt_user.c tests");
+
+    stop = true;
+
+    for (int i = 0; i < 4; i++)
+        pthread_join(threads[i], NULL);
+
+    dlt_unregister_context(&context);
+    dlt_unregister_app();
+}
+
 #endif
 
 /*/////////////////////////////////////// */
@@ -20,6 +20,8 @@
 #file            : dlt_multinode_test.sh
 #
 #Description     : Smoke testing for multinode feature of DLT
+#                  One gateway daemon is connected to several passive daemons
+#                  on loopback, one configured passive node is not reachable.
 #
 #Author Name     : Onkar Palkar
 #                  Jeevan Ramakant Nagvekar
@@ -29,7 +31,12 @@
 #History         : 31/07/2018
 ################################################################################
 
-ipaddr=127.0.0.1
+# use MULTINODE_IPADDR=::1 for daemons built with DLT_USE_IPv6
+ipaddr=${MULTINODE_IPADDR:-127.0.0.1}
+# ECU ids of the passive nodes, node N listens on port 3493+N
+passiveNodes="2 3 4"
+# configured passive node without daemon
+unreachablePort=3499
 
 #
 # Function:    -getOSname()
@@ -196,42 +203,54 @@ setupTest()
         echo "Error in creating dlt_gateway file"
         return 1
     fi
-    echo "[PassiveNode1]" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+    for node in $passiveNodes
+    do
+        echo "[PassiveNode$node]" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "IPaddress=$ipaddr">>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "Port=$((3493 + node))" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "EcuID=ECU$node" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "Connect=OnStartup" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "Timeout=10" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+        echo "NOFiles=1" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+    done
+    echo "[PassiveNodeUnreachable]" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
     echo "IPaddress=$ipaddr">>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
-    echo "Port=3495" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
-    echo "EcuID=ECU2" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+    echo "Port=$unreachablePort" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
+    echo "EcuID=ECU9" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
     echo "Connect=OnStartup" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
     echo "Timeout=10" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
-    echo "NOFiles=1" >>$tmpPath/$tmpFolder/$gatewayFolderName/dlt_gateway.conf
-    mkdir -p $tmpPath/$tmpFolder/$passiveFolderName
+    for node in $passiveNodes
+    do
+        mkdir -p $tmpPath/$tmpFolder/$passiveFolderName$node
         if [ $? -ne '0' ]
         then
-        echo "Error in creating passive folder"
-        return 1
-    fi
-    touch $tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    if [ $? -ne '0' ]
-    then
-        echo "Error in creating dlt.conf file"
-        return 1
-    fi
-    echo "SendContextRegistration = 1" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "ECUId = ECU2" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "SharedMemorySize = 100000" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "LoggingMode = 0" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "LoggingLevel = 6" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "LoggingFilename = /tmp/dlt.log" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "TimeOutOnSend = 4" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "RingbufferMinSize = 500000" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "RingbufferMaxSize = 10000000" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "RingbufferStepSize = 500000" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    echo "ControlSocketPath = /tmp/dlt-ctrl.sock" >>$tmpPath/$tmpFolder/$passiveFolderName/dlt.conf
-    mkdir -p $tmpPath/$tmpFolder/$tmpPassiveDIR
-    if [ $? -ne '0' ]
-    then
-        echo "Error while creating tempPassive folder"
-        return 1
-    fi
+            echo "Error in creating passive folder"
+            return 1
+        fi
+        touch $tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        if [ $? -ne '0' ]
+        then
+            echo "Error in creating dlt.conf file"
+            return 1
+        fi
+        echo "SendContextRegistration = 1" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "ECUId = ECU$node" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "SharedMemorySize = 100000" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "LoggingMode = 0" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "LoggingLevel = 6" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "LoggingFilename = /tmp/dlt.log" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "TimeOutOnSend = 4" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "RingbufferMinSize = 500000" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "RingbufferMaxSize = 10000000" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "RingbufferStepSize = 500000" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        echo "ControlSocketPath = /tmp/dlt-ctrl-passive$node.sock" >>$tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf
+        mkdir -p $tmpPath/$tmpFolder/$tmpPassiveDIR$node
+        if [ $? -ne '0' ]
+        then
+            echo "Error while creating tempPassive folder"
+            return 1
+        fi
+    done
     return 0
 }
 #
@@ -245,22 +264,27 @@ setupTest()
 #
 startDaemons()
 {
-    dlt-daemon -c $tmpPath/$tmpFolder/$passiveFolderName/dlt.conf -p 3495 -t $tmpPath/$tmpFolder/$tmpPassiveDIR -d > /dev/null
+    for node in $passiveNodes
+    do
+        dlt-daemon -c $tmpPath/$tmpFolder/$passiveFolderName$node/dlt.conf -p $((3493 + node)) -t $tmpPath/$tmpFolder/$tmpPassiveDIR$node -d > /dev/null
+    done
     dlt-daemon -c $tmpPath/$tmpFolder/$gatewayFolderName/dlt.conf -p 3490 -d > /dev/null
     return 0
 }
 #
 # Function:     -startExample()
 #
-# Description   -Start dlt-example-user on passive node
+# Description   -Start dlt-example-user on each passive node
 #
 # Return        -Zero on success
 #               -Non zero on failure
 #
 startExample()
 {
-    export DLT_PIPE_DIR=$tmpPath/$tmpFolder/$tmpPassiveDIR
-    dlt-example-user MultiNodeTesting > /dev/null &
+    for node in $passiveNodes
+    do
+        DLT_PIPE_DIR=$tmpPath/$tmpFolder/$tmpPassiveDIR$node dlt-example-user MultiNodeTesting > /dev/null &
+    done
     return 0
 }
 #
@@ -280,7 +304,7 @@ startReceive()
 # Function:     -verifyTest()
 #
 # Description   -Start dlt-convert
-#               -check weather msg sent by passive node are available in logs or not
+#               -check weather msg sent by each passive node are available in logs or not
 #
 # Return        -Zero on success
 #               -Non zero on failure
@@ -288,14 +312,16 @@ startReceive()
 verifyTest()
 {
     dlt-convert -a $tmpPath/$tmpFolder/$tmpLogFile > $tmpPath/$tmpFolder/$tmpLogAsciFile
-    cat $tmpPath/$tmpFolder/$tmpLogAsciFile | grep -F "ECU2" > /dev/null
-
-    if [ $? -eq '0' ]
-    then
-        return 0
-    else
-        return 1
-    fi
+    for node in $passiveNodes
+    do
+        cat $tmpPath/$tmpFolder/$tmpLogAsciFile | grep -F "ECU$node" > /dev/null
+        if [ $? -ne '0' ]
+        then
+            echo "No messages from passive node ECU$node"
+            return 1
+        fi
+    done
+    return 0
 }
 #main function
 ########################################################################################
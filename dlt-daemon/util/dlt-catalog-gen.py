@@ -0,0 +1,353 @@
+#!/usr/bin/python3
+# SPDX license identifier: MPL-2.0
+#
+# This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+#
+# This Source Code Form is subject to the terms of the
+# Mozilla Public License (MPL), v. 2.0.
+# If a copy of the MPL was not distributed with this file,
+# You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+# For further information see http://www.covesa.org/.
+"""Generate a non-verbose message catalog from DLT_LOG_CATALOG() statements.
+
+The sources are scanned for DLT_LOG_CATALOG(CONTEXT, LEVEL, NAME, ...) and
+every NAME gets a stable 32 bit message id (FNV-1a hash of the name). The
+tool writes:
+
+  --header   #define DLT_MSGID_<NAME> for every statement (include it before
+             using DLT_LOG_CATALOG)
+  --catalog  the catalog read by dlt-convert -n / dlt-receive -n
+  --fibex    a FIBEX style XML description for external viewers
+
+Passing the previous catalog with --previous keeps the ids of known names
+even if a hash collision was resolved differently in the meantime.
+"""
+import argparse
+import pathlib
+import re
+import sys
+from xml.sax.saxutils import escape
+
+CATALOG_MAGIC = "# DLT non-verbose catalog v1"
+
+# Argument macros and their catalog type. Attribute variants (_ATTR) carry
+# the same payload in non-verbose mode.
+ARG_TYPES = {
+    "DLT_INT": "int32", "DLT_INT8": "int8", "DLT_INT16": "int16",
+    "DLT_INT32": "int32", "DLT_INT64": "int64",
+    "DLT_UINT": "uint32", "DLT_UINT8": "uint8", "DLT_UINT16": "uint16",
+    "DLT_UINT32": "uint32", "DLT_UINT64": "uint64",
+    "DLT_HEX8": "hex8", "DLT_HEX16": "hex16", "DLT_HEX32": "hex32",
+    "DLT_HEX64": "hex64",
+    "DLT_BIN8": "bin8", "DLT_BIN16": "bin16",
+    "DLT_FLOAT32": "float32", "DLT_FLOAT64": "float64",
+    "DLT_BOOL": "bool",
+    "DLT_STRING": "string", "DLT_SIZED_STRING": "string",
+    "DLT_UTF8": "utf8", "DLT_SIZED_UTF8": "utf8",
+    "DLT_RAW": "raw",
+}
+TEXT_MACROS = ("DLT_CSTRING", "DLT_SIZED_CSTRING")
+
+FIBEX_TYPES = {
+    "int8": ("S_SINT8", 8), "int16": ("S_SINT16", 16),
+    "int32": ("S_SINT32", 32), "int64": ("S_SINT64", 64),
+    "uint8": ("S_UINT8", 8), "uint16": ("S_UINT16", 16),
+    "uint32": ("S_UINT32", 32), "uint64": ("S_UINT64", 64),
+    "hex8": ("S_UINT8", 8), "hex16": ("S_UINT16", 16),
+    "hex32": ("S_UINT32", 32), "hex64": ("S_UINT64", 64),
+    "bin8": ("S_UINT8", 8), "bin16": ("S_UINT16", 16),
+    "float32": ("S_FLOA32", 32), "float64": ("S_FLOA64", 64),
+    "bool": ("S_BOOL", 8), "string": ("S_STRG_ASCII", 0),
+    "utf8": ("S_STRG_UTF8", 0), "raw": ("S_RAWD", 0),
+}
+
+IDENT = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+MACRO_CALL = re.compile(r"^\s*(DLT_[A-Z0-9_]+)\s*\((.*)\)\s*$", re.S)
+STRING_LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"', re.S)
+
+
+class CatalogError(Exception):
+    pass
+
+
+def fnv1a32(text):
+    h = 0x811c9dc5
+    for b in text.encode():
+        h = ((h ^ b) * 0x01000193) & 0xffffffff
+    return h
+
+
+def strip_comments(source):
+    # Blank out comments but keep string literals and line numbers intact.
+    out = []
+    i = 0
+    n = len(source)
+    while i < n:
+        c = source[i]
+        if c == '"' or c == "'":
+            j = i + 1
+            while j < n and source[j] != c:
+                j += 2 if source[j] == "\\" else 1
+            out.append(source[i:j + 1])
+            i = j + 1
+        elif source.startswith("//", i):
+            j = source.find("\n", i)
+            j = n if j < 0 else j
+            i = j
+        elif source.startswith("/*", i):
+            j = source.find("*/", i + 2)
+            j = n if j < 0 else j + 2
+            out.append("\n" * source.count("\n", i, j))
+            i = j
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def split_arguments(source, start):
+    """Split the macro arguments starting after '(' at start.
+
+    Returns the list of top level arguments (separated by ',' or ';') and
+    the index after the closing parenthesis."""
+    args = []
+    depth = 0
+    current = start
+    i = start
+    n = len(source)
+    while i < n:
+        c = source[i]
+        if c == '"' or c == "'":
+            i += 1
+            while i < n and source[i] != c:
+                i += 2 if source[i] == "\\" else 1
+        elif c in "([{":
+            depth += 1
+        elif c in ")]}":
+            if depth == 0:
+                args.append(source[current:i])
+                return args, i + 1
+            depth -= 1
+        elif c in ",;" and depth == 0:
+            args.append(source[current:i])
+            current = i + 1
+        i += 1
+    raise CatalogError("unterminated DLT_LOG_CATALOG")
+
+
+def unescape_c(text):
+    return bytes(text, "utf-8").decode("unicode_escape").encode("latin-1").decode("utf-8")
+
+
+def parse_argument(expr, where):
+    m = MACRO_CALL.match(expr)
+    if not m:
+        raise CatalogError("%s: argument '%s' is not a DLT_* argument macro"
+                           % (where, expr.strip()))
+    macro = m.group(1)
+    if macro in TEXT_MACROS:
+        literals = STRING_LITERAL.findall(m.group(2).split(",")[0])
+        if not literals:
+            raise CatalogError("%s: %s() needs a string literal" % (where, macro))
+        return ("text", "".join(unescape_c(s) for s in literals))
+    if macro.endswith("_ATTR"):
+        macro = macro[:-len("_ATTR")]
+    if macro not in ARG_TYPES:
+        raise CatalogError("%s: %s() can not be described in the catalog"
+                           % (where, macro))
+    return (ARG_TYPES[macro], None)
+
+
+def scan_file(path):
+    source = strip_comments(path.read_text(errors="replace"))
+    for m in re.finditer(r"\bDLT_LOG_CATALOG\s*\(", source):
+        line = source.count("\n", 0, m.start()) + 1
+        # skip the macro definition itself
+        line_start = source.rfind("\n", 0, m.start()) + 1
+        if source[line_start:m.start()].lstrip().startswith("#"):
+            continue
+        where = "%s:%d" % (path, line)
+        args, _ = split_arguments(source, m.end())
+        if len(args) < 3:
+            raise CatalogError("%s: DLT_LOG_CATALOG needs CONTEXT, LEVEL and NAME" % where)
+        name = args[2].strip()
+        if not IDENT.match(name):
+            raise CatalogError("%s: '%s' is not a valid catalog name" % (where, name))
+        params = tuple(parse_argument(a, where) for a in args[3:] if a.strip())
+        yield name, params, where
+
+
+def read_catalog(path):
+    ids = {}
+    with open(path) as f:
+        for line in f:
+            if line.startswith("#") or not line.strip():
+                continue
+            fields = line.rstrip("\n").split("\t")
+            ids[fields[1]] = int(fields[0], 16)
+    return ids
+
+
+def assign_ids(messages, previous):
+    used = {}
+    ids = {}
+    # names known from the previous catalog keep their id
+    for name in sorted(messages):
+        if name in previous and previous[name] not in used:
+            ids[name] = previous[name]
+            used[previous[name]] = name
+    for name in sorted(messages):
+        if name in ids:
+            continue
+        msgid = fnv1a32(name) or 1
+        while msgid in used:
+            print("warning: id 0x%08x of %s collides with %s, probing"
+                  % (msgid, name, used[msgid]), file=sys.stderr)
+            msgid = (msgid + 1) & 0xffffffff or 1
+        ids[name] = msgid
+        used[msgid] = name
+    return ids
+
+
+def escape_text(text):
+    return text.replace("\\", "\\\\").replace("\t", "\\t").replace("\n", "\\n")
+
+
+def write_header(path, messages, ids):
+    guard = re.sub(r"[^A-Z0-9]", "_", pathlib.Path(path).name.upper())
+    with open(path, "w") as f:
+        f.write("/* Generated by dlt-catalog-gen.py, do not edit. */\n")
+        f.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        for name in sorted(messages, key=lambda n: ids[n]):
+            f.write("#define DLT_MSGID_%s 0x%08xU\n" % (name, ids[name]))
+        f.write("\n#endif /* %s */\n" % guard)
+
+
+def write_catalog(path, messages, ids):
+    with open(path, "w") as f:
+        f.write(CATALOG_MAGIC + "\n")
+        f.write("# <id>\t<name>\t<source>\t<argument>...\n")
+        for name in sorted(messages, key=lambda n: ids[n]):
+            params, where = messages[name]
+            fields = ["0x%08x" % ids[name], name, where]
+            for kind, text in params:
+                fields.append("text=" + escape_text(text) if kind == "text" else kind)
+            f.write("\t".join(fields) + "\n")
+
+
+def write_fibex(path, messages, ids, ecu, apid, ctid):
+    out = ['<?xml version="1.0" encoding="UTF-8"?>',
+           '<fx:FIBEX xmlns:fx="http://www.asam.net/xml/fbx" '
+           'xmlns:ho="http://www.asam.net/xml" VERSION="3.1.0">',
+           '  <fx:PROJECT ID="projectDLT">',
+           '    <ho:SHORT-NAME>DLT</ho:SHORT-NAME>',
+           '  </fx:PROJECT>',
+           '  <fx:ELEMENTS>',
+           '    <fx:ECUS>',
+           '      <fx:ECU ID="%s">' % escape(ecu),
+           '        <ho:SHORT-NAME>%s</ho:SHORT-NAME>' % escape(ecu),
+           '      </fx:ECU>',
+           '    </fx:ECUS>',
+           '    <fx:PDUS>']
+    frames = []
+    for name in sorted(messages, key=lambda n: ids[n]):
+        params, where = messages[name]
+        pdu_refs = []
+        for index, (kind, text) in enumerate(params):
+            pdu = "PDU_%u_%u" % (ids[name], index)
+            pdu_refs.append(pdu)
+            out.append('      <fx:PDU ID="%s">' % pdu)
+            out.append('        <ho:SHORT-NAME>%s</ho:SHORT-NAME>' % pdu)
+            if kind == "text":
+                out.append('        <ho:DESC>%s</ho:DESC>' % escape(text))
+                out.append('        <fx:BYTE-LENGTH>0</fx:BYTE-LENGTH>')
+                out.append('        <fx:PDU-TYPE>OTHER</fx:PDU-TYPE>')
+            else:
+                signal, bits = FIBEX_TYPES[kind]
+                out.append('        <fx:BYTE-LENGTH>%u</fx:BYTE-LENGTH>' % (bits // 8))
+                out.append('        <fx:PDU-TYPE>OTHER</fx:PDU-TYPE>')
+                out.append('        <fx:SIGNAL-INSTANCES>')
+                out.append('          <fx:SIGNAL-INSTANCE ID="S_%s">' % pdu)
+                out.append('            <fx:SEQUENCE-NUMBER>0</fx:SEQUENCE-NUMBER>')
+                out.append('            <fx:SIGNAL-REF ID-REF="%s"/>' % signal)
+                out.append('          </fx:SIGNAL-INSTANCE>')
+                out.append('        </fx:SIGNAL-INSTANCES>')
+            out.append('      </fx:PDU>')
+        frames.append((name, where, pdu_refs))
+    out.append('    </fx:PDUS>')
+    out.append('    <fx:FRAMES>')
+    for name, where, pdu_refs in frames:
+        out.append('      <fx:FRAME ID="ID_%u">' % ids[name])
+        out.append('        <ho:SHORT-NAME>%s</ho:SHORT-NAME>' % name)
+        out.append('        <ho:DESC>%s</ho:DESC>' % escape(where))
+        out.append('        <fx:BYTE-LENGTH>0</fx:BYTE-LENGTH>')
+        out.append('        <fx:FRAME-TYPE>OTHER</fx:FRAME-TYPE>')
+        out.append('        <fx:PDU-INSTANCES>')
+        for seq, pdu in enumerate(pdu_refs):
+            out.append('          <fx:PDU-INSTANCE ID="P_%s">' % pdu)
+            out.append('            <fx:PDU-REF ID-REF="%s"/>' % pdu)
+            out.append('            <fx:SEQUENCE-NUMBER>%u</fx:SEQUENCE-NUMBER>' % seq)
+            out.append('          </fx:PDU-INSTANCE>')
+        out.append('        </fx:PDU-INSTANCES>')
+        out.append('        <fx:MANUFACTURER-EXTENSION>')
+        out.append('          <MESSAGE_TYPE>DLT_TYPE_LOG</MESSAGE_TYPE>')
+        out.append('          <MESSAGE_INFO>DLT_LOG_INFO</MESSAGE_INFO>')
+        out.append('          <APPLICATION_ID>%s</APPLICATION_ID>' % escape(apid))
+        out.append('          <CONTEXT_ID>%s</CONTEXT_ID>' % escape(ctid))
+        out.append('        </fx:MANUFACTURER-EXTENSION>')
+        out.append('      </fx:FRAME>')
+    out.append('    </fx:FRAMES>')
+    out.append('  </fx:ELEMENTS>')
+    out.append('</fx:FIBEX>')
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate message ids and a catalog for DLT_LOG_CATALOG() statements.")
+    parser.add_argument("sources", nargs="+", help="source files or directories to scan")
+    parser.add_argument("--header", help="header with the DLT_MSGID_<NAME> defines")
+    parser.add_argument("--catalog", help="catalog file for dlt-convert/dlt-receive -n")
+    parser.add_argument("--fibex", help="FIBEX style XML export")
+    parser.add_argument("--previous", help="previous catalog whose ids are kept")
+    parser.add_argument("--ecu", default="ECU1", help="ECU id written to the FIBEX export")
+    parser.add_argument("--apid", default="", help="application id written to the FIBEX export")
+    parser.add_argument("--ctid", default="", help="context id written to the FIBEX export")
+    args = parser.parse_args()
+
+    files = []
+    for source in args.sources:
+        p = pathlib.Path(source)
+        if p.is_dir():
+            files.extend(sorted(f for f in p.rglob("*")
+                                if f.suffix in (".c", ".cc", ".cpp", ".cxx", ".h", ".hpp")))
+        else:
+            files.append(p)
+
+    messages = {}
+    try:
+        for f in files:
+            for name, params, where in scan_file(f):
+                if name in messages and messages[name][0] != params:
+                    raise CatalogError("%s: %s was already used with other arguments at %s"
+                                       % (where, name, messages[name][1]))
+                messages.setdefault(name, (params, where))
+        previous = read_catalog(args.previous) if args.previous else {}
+    except (CatalogError, OSError, ValueError, IndexError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+
+    ids = assign_ids(messages, previous)
+    if args.header:
+        write_header(args.header, messages, ids)
+    if args.catalog:
+        write_catalog(args.catalog, messages, ids)
+    if args.fibex:
+        write_fibex(args.fibex, messages, ids, args.ecu, args.apid, args.ctid)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
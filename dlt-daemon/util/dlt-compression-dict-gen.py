@@ -0,0 +1,123 @@
+#!/usr/bin/python3
+# SPDX license identifier: MPL-2.0
+#
+# This file is part of COVESA Project DLT - Diagnostic Log and Trace.
+#
+# This Source Code Form is subject to the terms of the
+# Mozilla Public License (MPL), v. 2.0.
+# If a copy of the MPL was not distributed with this file,
+# You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+# For further information see http://www.covesa.org/.
+"""Train the preset dictionary of compressed client connections.
+
+Reads DLT trace files with storage header, as written by dlt-receive -o or
+the offline trace, and collects the header bytes which repeat from message
+to message: the ECU id, and the extended header with the type info of the
+first verbose argument. Counters, lengths, session ids and timestamps are
+left out, they differ between messages or processes.
+
+The sequences saving the most bytes are written as C initializer for
+dlt_compression_dictionary[] in src/shared/dlt_compression.c. The best one
+comes last: deflate encodes short distances cheaper. Daemon and clients must
+use the same dictionary, a new one needs a new DLT_COMPRESSION_* method.
+"""
+import argparse
+import collections
+import struct
+import sys
+
+STORAGE_HEADER = b"DLT\x01"
+STORAGE_HEADER_SIZE = 16
+
+HTYP_UEH = 0x01
+HTYP_WEID = 0x04
+HTYP_WSID = 0x08
+HTYP_WTMS = 0x10
+MSIN_VERB = 0x01
+
+EXTENDED_HEADER_SIZE = 10
+TYPE_INFO_SIZE = 4
+
+
+def header_sequences(data):
+    """Yield the constant header parts of all messages in a trace."""
+    offset = 0
+
+    while offset + STORAGE_HEADER_SIZE + 4 <= len(data):
+        if data[offset:offset + 4] != STORAGE_HEADER:
+            # resync to the next storage header
+            offset = data.find(STORAGE_HEADER, offset + 1)
+            if offset < 0:
+                return
+            continue
+
+        message = offset + STORAGE_HEADER_SIZE
+        htyp = data[message]
+        (length,) = struct.unpack(">H", data[message + 2:message + 4])
+        end = message + length
+        offset = end
+
+        if (length < 4) or (end > len(data)):
+            continue
+
+        position = message + 4
+
+        if htyp & HTYP_WEID:
+            yield data[position:position + 4]
+            position += 4
+        if htyp & HTYP_WSID:
+            position += 4
+        if htyp & HTYP_WTMS:
+            position += 4
+
+        if (htyp & HTYP_UEH) and (position + EXTENDED_HEADER_SIZE <= end):
+            size = EXTENDED_HEADER_SIZE
+            if (data[position] & MSIN_VERB) and \
+               (position + EXTENDED_HEADER_SIZE + TYPE_INFO_SIZE <= end):
+                size += TYPE_INFO_SIZE
+            yield data[position:position + size]
+
+
+def train(traces, size):
+    """Return the dictionary built from the given trace files."""
+    counts = collections.Counter()
+
+    for trace in traces:
+        with open(trace, "rb") as handle:
+            counts.update(header_sequences(handle.read()))
+
+    chosen = []
+    used = 0
+
+    # a sequence saves about its length each time it occurs
+    for sequence, count in sorted(counts.items(),
+                                  key=lambda item: (-item[1] * len(item[0]), item[0])):
+        if count < 2:
+            break
+        if used + len(sequence) > size:
+            continue
+        chosen.append(sequence)
+        used += len(sequence)
+
+    return b"".join(reversed(chosen))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("traces", nargs="+", help="DLT trace files")
+    parser.add_argument("--size", type=int, default=1024,
+                        help="maximum dictionary size in bytes (default: 1024)")
+    args = parser.parse_args()
+
+    dictionary = train(args.traces, args.size)
+
+    if not dictionary:
+        sys.exit("No repeating headers found")
+
+    for start in range(0, len(dictionary), 12):
+        print("    " + " ".join("0x%02x," % byte for byte in dictionary[start:start + 12]))
+
+
+if __name__ == "__main__":
+    main()